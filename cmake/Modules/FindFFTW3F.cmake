@@ -0,0 +1,43 @@
+# Tries to find FFTW3F, the single precision FFTW library used by gnuradio-fft.
+#
+# Usage of this module as follows:
+#
+# find_package(FFTW3F)
+#
+# Variables used by this module, they can change the default behaviour and need
+# to be set before calling find_package:
+#
+# FFTW3F_ROOT_DIR Set this variable to the root installation of
+# FFTW3F if the module has problems finding the proper installation path.
+#
+# Variables defined by this module:
+#
+# FFTW3F_FOUND System has FFTW3F libs/headers
+# FFTW3F_LIBRARIES The FFTW3F library
+# FFTW3F_INCLUDE_DIRS The location of the fftw3.h header
+
+find_package(PkgConfig)
+pkg_check_modules(PC_FFTW3F "fftw3f >= 3.0")
+
+find_path(FFTW3F_INCLUDE_DIRS
+  NAMES fftw3.h
+  HINTS ${PC_FFTW3F_INCLUDEDIR} ${FFTW3F_ROOT_DIR}/include
+  PATHS /usr/include /usr/local/include /opt/local/include)
+
+find_library(FFTW3F_LIBRARIES
+  NAMES fftw3f libfftw3f
+  HINTS ${PC_FFTW3F_LIBDIR} ${FFTW3F_ROOT_DIR}/lib
+  PATHS /usr/lib /usr/lib64 /usr/local/lib /usr/local/lib64 /opt/local/lib)
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(
+  FFTW3F
+  DEFAULT_MSG
+  FFTW3F_LIBRARIES
+  FFTW3F_INCLUDE_DIRS
+)
+
+mark_as_advanced(
+  FFTW3F_ROOT_DIR
+  FFTW3F_LIBRARIES
+  FFTW3F_INCLUDE_DIRS)
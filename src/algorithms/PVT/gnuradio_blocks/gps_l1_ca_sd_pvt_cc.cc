@@ -41,13 +41,15 @@
 #include <gnuradio/io_signature.h>
 #include <glog/logging.h>
 #include "concurrent_map.h"
+#include "concurrent_ring.h"
 #include "sbas_telemetry_data.h"
 #include "sbas_ionospheric_correction.h"
 #include "spoofing_message.h"
 
 using google::LogMessage;
 
-extern concurrent_queue<Spoofing_Message> global_spoofing_queue;
+extern concurrent_ring<Spoofing_Message> global_spoofing_queue;
+extern concurrent_ring<Capture_Subframe> global_capture_subframe_queue;
 extern concurrent_map<std::map<unsigned int, unsigned int>> global_subframe_check;
 extern concurrent_map<Subframe> global_subframe_map;
 
@@ -114,10 +116,12 @@ void gps_l1_ca_sd_pvt_cc::msg_handler_telemetry(pmt::pmt_t msg)
                     if(d_APT)
                         {
                             d_ls_pvt->gps_ephemeris_map[gps_eph->uid] = *gps_eph;
+                            d_capture.write_ephemeris(gps_eph->uid, *gps_eph);
                         }
                     else
                         {
                             d_ls_pvt->gps_ephemeris_map[gps_eph->i_satellite_PRN] = *gps_eph;
+                            d_capture.write_ephemeris(gps_eph->i_satellite_PRN, *gps_eph);
                         }
                 }
             else if (pmt::any_ref(msg).type() == typeid(std::shared_ptr<Gps_Iono>) )
@@ -228,6 +232,8 @@ gps_l1_ca_sd_pvt_cc::gps_l1_ca_sd_pvt_cc(unsigned int nchannels,
     d_dump = dump;
     d_nchannels = nchannels;
     d_dump_filename = dump_filename;
+    d_perf = Gnss_Sdr_Perf::instance().add("pvt", 1.0 / GPS_L1_CA_CODE_PERIOD);
+    d_fixes = 0;
     std::string dump_ls_pvt_filename = dump_filename;
 
     // GPS Ephemeris data message port in
@@ -316,53 +322,103 @@ gps_l1_ca_sd_pvt_cc::gps_l1_ca_sd_pvt_cc(unsigned int nchannels,
     d_spoofing_detector = spoofing_detector;
     d_APT = spoofing_detector.get_APT();
     d_PPE_sampling = spoofing_detector.get_PPE_sampling();
+    if(!spoofing_detector.get_capture_filename().empty())
+        {
+            d_capture.open(spoofing_detector.get_capture_filename(), d_nchannels);
+        }
+    if(!spoofing_detector.get_stats_filename().empty() || !spoofing_detector.get_stats_socket().empty()
+            || spoofing_detector.get_stats_http_port() > 0)
+        {
+            d_stats_server.start(spoofing_detector.get_stats_filename(), spoofing_detector.get_stats_period_ms(),
+                    spoofing_detector.get_stats_socket(), spoofing_detector.get_stats_http_port());
+        }
     bool d_spoofing_report = true;
     if(d_spoofing_report)
         {
-        if (d_spoofing_report_file.is_open() == false)
-            {
-                try
+            // binary event log and text report, both written by the event log thread
+            boost::posix_time::ptime t = boost::posix_time::second_clock::universal_time();
+            std::string stamp = boost::posix_time::to_iso_string(t);
+            std::string events_filename = "spoofing_events-" + stamp + ".dat";
+            std::string report_filename = "spoofing_report-" + stamp + ".txt";
+            if(d_spoofing_event_log.open(FLAGS_log_dir + events_filename, FLAGS_log_dir + report_filename,
+                    spoofing_detector.get_event_min_interval_ms(), spoofing_detector.get_event_flush_period_ms()))
                 {
-                    boost::posix_time::ptime t = boost::posix_time::second_clock::universal_time();
-                    std::stringstream spoofing_report_filename;
-                    std::stringstream spoofing_report_filename_full;
-                    spoofing_report_filename << "spoofing_report-"
-                    << boost::posix_time::to_iso_string(t)
-                    << ".txt";
-                    spoofing_report_filename_full <<  FLAGS_log_dir << spoofing_report_filename.str();
-                    d_spoofing_report_file.exceptions (std::ifstream::failbit | std::ifstream::badbit);
-                    d_spoofing_report_file.open(spoofing_report_filename_full.str(), std::ios::out );
-
-                    
-                    std::stringstream spoofing_report_symlink;
-                    spoofing_report_symlink <<  FLAGS_log_dir
-                    << "spoofing_report"
-                    << ".txt";
-                    int us = unlink(spoofing_report_symlink.str().c_str());
-                    if(us != 0)
+                    const std::string links[2][2] = {{events_filename, "spoofing_events.dat"}, {report_filename, "spoofing_report.txt"}};
+                    for(unsigned int i = 0; i < 2; i++)
                         {
-                            DLOG(INFO)  << "Unable to unlink last spoofing report ", strerror(errno);
-                        }
-                    int s =  symlink(spoofing_report_filename.str().c_str(), spoofing_report_symlink.str().c_str());
-                    if(s != 0)
-                        {
-                            LOG(WARNING)  << "Unable to create symlink for spoofing report ", strerror(errno);
+                            std::string symlink_name = FLAGS_log_dir + links[i][1];
+                            int us = unlink(symlink_name.c_str());
+                            if(us != 0)
+                                {
+                                    DLOG(INFO) << "Unable to unlink last " << links[i][1] << ": " << strerror(errno);
+                                }
+                            int s = symlink(links[i][0].c_str(), symlink_name.c_str());
+                            if(s != 0)
+                                {
+                                    LOG(WARNING) << "Unable to create symlink for " << links[i][1] << ": " << strerror(errno);
+                                }
                         }
-
-                    LOG(INFO) << "Spoofing report enabled, " << " file: " << spoofing_report_filename_full.str() << std::endl;
-                }
-                catch (std::ifstream::failure e)
-                {
-                    LOG(WARNING) << " Exception opening spoofing report file " << e.what() << std::endl;
+                    LOG(INFO) << "Spoofing report enabled, file: " << FLAGS_log_dir << report_filename;
                 }
-            }
         }
 }
 
 
 gps_l1_ca_sd_pvt_cc::~gps_l1_ca_sd_pvt_cc()
 {
-    d_spoofing_report_file.close();
+    d_spoofing_event_log.close();
+    d_capture.close();
+    d_stats_server.stop();
+    LOG(INFO) << "Spoofing message queue: " << global_spoofing_queue.pushed() << " messages, high water "
+              << global_spoofing_queue.high_water() << "/" << global_spoofing_queue.capacity()
+              << ", " << global_spoofing_queue.dropped() << " dropped";
+    LOG(INFO) << "Capture subframe queue: " << global_capture_subframe_queue.pushed() << " subframes, high water "
+              << global_capture_subframe_queue.high_water() << "/" << global_capture_subframe_queue.capacity()
+              << ", " << global_capture_subframe_queue.dropped() << " dropped";
+}
+
+
+/*
+ * Records the subframes decoded since the last call, then the synchro data of
+ * all channels, so that the offline replay sees them in the same order.
+ */
+void gps_l1_ca_sd_pvt_cc::capture_epoch(Gnss_Synchro** in)
+{
+    Capture_Subframe subframe;
+    while(global_capture_subframe_queue.try_pop(subframe))
+        {
+            d_capture.write_subframe(subframe);
+        }
+
+    std::vector<Capture_Synchro> channels(d_nchannels);
+    for(unsigned int i = 0; i < d_nchannels; i++)
+        {
+            Capture_Synchro& c = channels.at(i);
+            c.channel = i;
+            c.PRN = in[i][0].PRN;
+            c.peak = in[i][0].peak;
+            c.uid = d_channels.at(i)->get_uid();
+            c.state = d_channels.at(i)->get_state();
+            c.Flag_valid_pseudorange = in[i][0].Flag_valid_pseudorange;
+            c.CN0_dB_hz = in[i][0].CN0_dB_hz;
+            c.Carrier_Doppler_hz = in[i][0].Carrier_Doppler_hz;
+            c.Prompt_I = in[i][0].Prompt_I;
+            c.Prompt_Q = in[i][0].Prompt_Q;
+            c.Tracking_timestamp_secs = in[i][0].Tracking_timestamp_secs;
+            c.d_TOW_at_current_symbol = in[i][0].d_TOW_at_current_symbol;
+            c.Pseudorange_m = in[i][0].Pseudorange_m;
+            gr_complex zero(0.0, 0.0);
+            gr_complex early = in[i][0].Early ? *in[i][0].Early : zero;
+            gr_complex prompt = in[i][0].Prompt ? *in[i][0].Prompt : zero;
+            gr_complex late = in[i][0].Late ? *in[i][0].Late : zero;
+            c.Early[0] = early.real();
+            c.Early[1] = early.imag();
+            c.Prompt[0] = prompt.real();
+            c.Prompt[1] = prompt.imag();
+            c.Late[0] = late.real();
+            c.Late[1] = late.imag();
+        }
+    d_capture.write_epoch(d_sample_counter, channels);
 }
 
 
@@ -391,9 +447,11 @@ void gps_l1_ca_sd_pvt_cc::set_channels(std::vector<std::shared_ptr<ChannelInterf
 }
 
 
-int gps_l1_ca_sd_pvt_cc::general_work (int noutput_items __attribute__((unused)), gr_vector_int &ninput_items __attribute__((unused)),
+int gps_l1_ca_sd_pvt_cc::general_work (int noutput_items __attribute__((unused)), gr_vector_int &ninput_items,
         gr_vector_const_void_star &input_items, gr_vector_void_star &output_items __attribute__((unused)))
 {
+    Gnss_Sdr_Perf_Scope perf_scope(d_perf.get(), this, ninput_items[0]);
+    d_spoofing_detector.update_parameters(); // thresholds changed at run time
     gnss_pseudoranges_map.clear();
     d_sample_counter++;
     Gnss_Synchro **in = (Gnss_Synchro **)  &input_items[0]; //Get the input pointer
@@ -406,6 +464,11 @@ int gps_l1_ca_sd_pvt_cc::general_work (int noutput_items __attribute__((unused))
             return 0;
         }
 
+    if(d_capture.is_open())
+        {
+            capture_epoch(in);
+        }
+
     std::list<unsigned int> channels_used; 
     std::map<unsigned int, unsigned int> PRN_to_peak;
     for(unsigned int i = 0; i<d_nchannels; ++i)
@@ -469,20 +532,14 @@ int gps_l1_ca_sd_pvt_cc::general_work (int noutput_items __attribute__((unused))
 
 
 
-    Spoofing_Message spm;
-    while( !global_spoofing_queue.empty())
-    {
-        global_spoofing_queue.try_pop(spm);
-        try
-        {
-            d_spoofing_report_file << spm.spoofing_report;
-            d_spoofing_report_file.flush();
-        }
-        catch (std::ifstream::failure e)
+    // repeated alarms are folded and written by the event log thread
+    // at most one ring's worth per epoch, so a storm cannot stall the PVT
+    d_spoofing_messages.clear();
+    global_spoofing_queue.pop_batch(d_spoofing_messages, global_spoofing_queue.capacity());
+    for(std::vector<Spoofing_Message>::const_iterator it = d_spoofing_messages.begin(); it != d_spoofing_messages.end(); ++it)
         {
-            LOG(WARNING) << "Exception writing to spoofing report " << e.what();
+            d_spoofing_event_log.push(*it, d_sample_counter);
         }
-    }
     
 
     // ############ 2 COMPUTE THE PVT ################################
@@ -496,6 +553,8 @@ int gps_l1_ca_sd_pvt_cc::general_work (int noutput_items __attribute__((unused))
                     pvt_result = d_ls_pvt->get_PVT(gnss_pseudoranges_map, d_rx_time, d_flag_averaging);
                     if (pvt_result == true)
                         {
+                            d_fixes++;
+                            d_perf->set_produced(d_fixes); // the fixes are the output of the PVT
                             d_kml_printer->print_position(d_ls_pvt, d_flag_averaging);
                             d_geojson_printer->print_position(d_ls_pvt, d_flag_averaging);
                             d_nmea_printer->Print_Nmea_Line(d_ls_pvt, d_flag_averaging);
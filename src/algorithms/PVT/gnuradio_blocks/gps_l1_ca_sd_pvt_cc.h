@@ -35,6 +35,7 @@
 
 #include <fstream>
 #include <string>
+#include <vector>
 #include <gnuradio/block.h>
 #include "nmea_printer.h"
 #include "kml_printer.h"
@@ -43,6 +44,10 @@
 #include "rtcm_printer.h"
 #include "gps_l1_ca_ls_pvt.h"
 #include "spoofing_detector.h"
+#include "spoofing_capture.h"
+#include "spoofing_stats.h"
+#include "spoofing_event_log.h"
+#include "gnss_sdr_perf.h"
 #include "channel_interface.h"
 
 //class ChannelInterface;
@@ -148,7 +153,13 @@ private:
     Spoofing_Detector d_spoofing_detector;
     bool d_APT;
     int d_PPE_sampling;
-    std::ofstream d_spoofing_report_file;
+    Spoofing_Event_Log d_spoofing_event_log;
+    std::vector<Spoofing_Message> d_spoofing_messages; // drained from global_spoofing_queue each epoch
+    Spoofing_Capture_Writer d_capture;
+    Spoofing_Stats_Server d_stats_server;
+    std::shared_ptr<Gnss_Sdr_Block_Perf> d_perf;
+    unsigned long long d_fixes; // PVT solutions computed, reported as the items produced by the block
+    void capture_epoch(Gnss_Synchro** in);
     bool pseudoranges_pairCompare_min(const std::pair<int,Gnss_Synchro>& a, const std::pair<int,Gnss_Synchro>& b);
     std::vector<std::shared_ptr<ChannelInterface>> d_channels;
 
@@ -35,6 +35,8 @@
  */
 
 #include "gps_l1_ca_pcps_sd_acquisition.h"
+#include <functional>
+#include <sstream>
 #include <boost/math/distributions/exponential.hpp>
 #include <glog/logging.h>
 #include "gps_sdr_signal_processing.h"
@@ -125,10 +127,12 @@ void GpsL1CaPcpsSdAcquisition::set_channel(unsigned int channel)
     channel_ = channel;
     if (item_type_.compare("cshort") == 0)
         {
+            acquisition_sc_->set_role(role_);
             acquisition_sc_->set_channel(channel_);
         }
     else
         {
+            acquisition_cc_->set_role(role_);
             acquisition_cc_->set_channel(channel_);
         }
 
@@ -237,27 +241,33 @@ void GpsL1CaPcpsSdAcquisition::init()
 
 void GpsL1CaPcpsSdAcquisition::set_local_code()
 {
+    // The code spectrum of a PRN is computed once and shared by all the channels
+    std::stringstream key;
+    key << "GPS_L1_CA/" << gnss_synchro_->PRN << "/" << fs_in_ << "/" << sampled_ms_;
+    std::function<std::complex<float>*()> generate = [this]()
+        {
+            std::complex<float>* code = new std::complex<float>[code_length_];
 
-    std::complex<float>* code = new std::complex<float>[code_length_];
+            gps_l1_ca_code_gen_complex_sampled(code, gnss_synchro_->PRN, fs_in_, 0);
 
-    gps_l1_ca_code_gen_complex_sampled(code, gnss_synchro_->PRN, fs_in_, 0);
+            for (unsigned int i = 0; i < sampled_ms_; i++)
+                {
+                    memcpy(&(code_[i*code_length_]), code,
+                            sizeof(gr_complex)*code_length_);
+                }
 
-    for (unsigned int i = 0; i < sampled_ms_; i++)
-        {
-            memcpy(&(code_[i*code_length_]), code,
-                    sizeof(gr_complex)*code_length_);
-        }
+            delete[] code;
+            return code_;
+        };
 
     if (item_type_.compare("cshort") == 0)
         {
-            acquisition_sc_->set_local_code(code_);
+            acquisition_sc_->set_local_code(key.str(), generate);
         }
     else
         {
-            acquisition_cc_->set_local_code(code_);
+            acquisition_cc_->set_local_code(key.str(), generate);
         }
-
-    delete[] code;
 }
 
 
@@ -287,6 +297,20 @@ void GpsL1CaPcpsSdAcquisition::set_state(int state)
 }
 
 
+bool GpsL1CaPcpsSdAcquisition::skip_samples(unsigned long int samples)
+{
+    if (item_type_.compare("cshort") == 0)
+        {
+            acquisition_sc_->skip_samples(samples);
+        }
+    else
+        {
+            acquisition_cc_->skip_samples(samples);
+        }
+    return true;
+}
+
+
 
 float GpsL1CaPcpsSdAcquisition::calculate_threshold(float pfa)
 {
@@ -138,6 +138,11 @@ public:
      */
     void set_state(int state);
 
+    /*!
+     * \brief Advances the sample counter over samples dropped while the channel was parked
+     */
+    bool skip_samples(unsigned long int samples);
+
 private:
     ConfigurationInterface* configuration_;
     pcps_sd_acquisition_cc_sptr acquisition_cc_;
@@ -52,11 +52,16 @@
 #define GNSS_SDR_PCPS_SD_ACQUISITION_CC_H_
 
 #include <fstream>
+#include <functional>
+#include <memory>
 #include <string>
 #include <gnuradio/block.h>
 #include <gnuradio/gr_complex.h>
 #include <gnuradio/fft/fft.h>
 #include "gnss_synchro.h"
+#include "gnss_sdr_perf.h"
+#include "gnss_sdr_shared_tables.h"
+#include "gnss_sdr_runtime_params.h"
 
 class pcps_sd_acquisition_cc;
 
@@ -111,6 +116,7 @@ private:
     unsigned int d_fft_size;
     unsigned long int d_sample_counter;
     gr_complex** d_grid_doppler_wipeoffs;
+    std::shared_ptr<gr_complex> d_wipeoff_table;  // rows of d_grid_doppler_wipeoffs, shared by the channels
     unsigned int d_num_doppler_bins;
     gr_complex* d_fft_codes;
     gr::fft::fft_complex* d_fft_if;
@@ -131,6 +137,8 @@ private:
     unsigned int d_channel;
     std::string d_dump_filename;
     unsigned int d_peak;
+    std::shared_ptr<Gnss_Sdr_Block_Perf> d_perf;
+    Gnss_Sdr_Runtime_Params_Watch d_params; // <role>[channel].threshold changed at run time
 
 public:
     /*!
@@ -167,6 +175,14 @@ public:
       */
      void set_local_code(std::complex<float> * code);
 
+     /*!
+      * \brief Sets the local code from the spectrum shared under \a key,
+      * which \a generate only has to produce the first time.
+      * \param key - Signal, PRN and sampling of the code.
+      * \param generate - Returns a pointer to the PRN code.
+      */
+     void set_local_code(const std::string& key, const std::function<std::complex<float>*()>& generate);
+
      /*!
       * \brief Starts acquisition algorithm, turning from standby mode to
       * active mode
@@ -184,6 +200,15 @@ public:
       */
      void set_state(int state);
 
+     /*!
+      * \brief Advances the sample counter over samples the block never
+      * received because its channel was parked.
+      */
+     void skip_samples(unsigned long int samples)
+     {
+         d_sample_counter += samples;
+     }
+
      /*!
       * \brief Set acquisition channel unique ID
       * \param channel - receiver channel.
@@ -191,6 +216,17 @@ public:
      void set_channel(unsigned int channel)
      {
          d_channel = channel;
+         d_perf->set_channel(channel);
+         d_params.set_channel(channel);
+     }
+
+     /*!
+      * \brief Set the configuration role, used to look up the
+      * parameters changed at run time (see Gnss_Sdr_Runtime_Params).
+      */
+     void set_role(const std::string& role)
+     {
+         d_params.set_role(role);
      }
 
      /*!
@@ -101,6 +101,7 @@ pcps_sd_acquisition_sc::pcps_sd_acquisition_sc(
     d_code_phase = 0;
     d_test_statistics = 0.0;
     d_channel = 0;
+    d_perf = Gnss_Sdr_Perf::instance().add("acquisition", static_cast<double>(d_fs_in) / static_cast<double>(d_fft_size));
     d_doppler_freq = 0.0;
 
     //set_relative_rate( 1.0/d_fft_size );
@@ -143,14 +144,7 @@ pcps_sd_acquisition_sc::pcps_sd_acquisition_sc(
 
 pcps_sd_acquisition_sc::~pcps_sd_acquisition_sc()
 {
-    if (d_num_doppler_bins > 0)
-        {
-            for (unsigned int i = 0; i < d_num_doppler_bins; i++)
-                {
-                    volk_free(d_grid_doppler_wipeoffs[i]);
-                }
-            delete[] d_grid_doppler_wipeoffs;
-        }
+    delete[] d_grid_doppler_wipeoffs;
 
     volk_free(d_fft_codes);
     volk_free(d_magnitude);
@@ -184,6 +178,20 @@ void pcps_sd_acquisition_sc::set_local_code(std::complex<float> * code)
 }
 
 
+void pcps_sd_acquisition_sc::set_local_code(const std::string& key, const std::function<std::complex<float>*()>& generate)
+{
+    std::stringstream spectrum_key;
+    spectrum_key << "pcps_sd_sc_code/" << key << "/" << d_fft_size << "/" << d_bit_transition_flag;
+    std::shared_ptr<gr_complex> spectrum = Gnss_Sdr_Shared_Tables::instance().get(spectrum_key.str(), d_fft_size,
+            [this, &generate](gr_complex* table)
+            {
+                set_local_code(generate());
+                memcpy(table, d_fft_codes, sizeof(gr_complex) * d_fft_size);
+            });
+    memcpy(d_fft_codes, spectrum.get(), sizeof(gr_complex) * d_fft_size);
+}
+
+
 void pcps_sd_acquisition_sc::update_local_carrier(gr_complex* carrier_vector, int correlator_length_samples, float freq)
 {
     float phase_step_rad = GPS_TWO_PI * freq / static_cast<float>(d_fs_in);
@@ -209,14 +217,25 @@ void pcps_sd_acquisition_sc::init()
 
     d_num_doppler_bins = ceil( static_cast<double>(static_cast<int>(d_doppler_max) - static_cast<int>(-d_doppler_max)) / static_cast<double>(d_doppler_step));
 
-    // Create the carrier Doppler wipeoff signals
-    d_grid_doppler_wipeoffs = new gr_complex*[d_num_doppler_bins];
+    // Create the carrier Doppler wipeoff signals. The grid only depends on the
+    // configuration, so every channel with the same one uses the same table.
+    std::stringstream key;
+    key << "pcps_wipeoffs/" << d_fs_in << "/" << d_freq << "/" << d_doppler_max << "/" << d_doppler_step << "/" << d_fft_size;
+    d_wipeoff_table = Gnss_Sdr_Shared_Tables::instance().get(key.str(), static_cast<size_t>(d_num_doppler_bins) * d_fft_size,
+            [this](gr_complex* table)
+            {
+                for (unsigned int doppler_index = 0; doppler_index < d_num_doppler_bins; doppler_index++)
+                    {
+                        int doppler = -static_cast<int>(d_doppler_max) + d_doppler_step * doppler_index;
+                        update_local_carrier(table + doppler_index * d_fft_size, d_fft_size, d_freq + doppler);
+                    }
+            });
 
+    delete[] d_grid_doppler_wipeoffs;
+    d_grid_doppler_wipeoffs = new gr_complex*[d_num_doppler_bins];
     for (unsigned int doppler_index = 0; doppler_index < d_num_doppler_bins; doppler_index++)
         {
-            d_grid_doppler_wipeoffs[doppler_index] = static_cast<gr_complex*>(volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
-            int doppler = -static_cast<int>(d_doppler_max) + d_doppler_step * doppler_index;
-            update_local_carrier(d_grid_doppler_wipeoffs[doppler_index], d_fft_size, d_freq + doppler);
+            d_grid_doppler_wipeoffs[doppler_index] = d_wipeoff_table.get() + doppler_index * d_fft_size;
         }
 }
 
@@ -247,6 +266,13 @@ int pcps_sd_acquisition_sc::general_work(int noutput_items,
         gr_vector_int &ninput_items, gr_vector_const_void_star &input_items,
         gr_vector_void_star &output_items __attribute__((unused)))
 {
+    Gnss_Sdr_Perf_Scope perf_scope(d_perf.get(), this, ninput_items[0]);
+    if (d_params.changed())
+        {
+            double threshold;
+            if (d_params.get("threshold", threshold)) d_threshold = threshold;
+        }
+
     /*
      * By J.Arribas, L.Esteve and M.Molina
      * Acquisition strategy (Kay Borre book + CFAR threshold):
@@ -66,20 +66,24 @@ Channel::Channel(ConfigurationInterface *configuration, unsigned int channel,
 
     // IMPORTANT: Do not change the order between set_doppler_step and set_threshold
 
-    unsigned int doppler_step = configuration->property("Acquisition_" + implementation_ + boost::lexical_cast<std::string>(channel_) + ".doppler_step" ,0);
-    if(doppler_step == 0) doppler_step = configuration->property("Acquisition_" + implementation_+".doppler_step", 500);
+    // property prefixes of this channel and of all the channels of the signal
+    std::string acq_prefix = "Acquisition_" + implementation_;
+    std::string acq_channel_prefix = acq_prefix + boost::lexical_cast<std::string>(channel_);
+
+    unsigned int doppler_step = configuration->property(acq_channel_prefix + ".doppler_step" ,0);
+    if(doppler_step == 0) doppler_step = configuration->property(acq_prefix + ".doppler_step", 500);
     DLOG(INFO) << "Channel "<< channel_ << " Doppler_step = " << doppler_step;
 
     acq_->set_doppler_step(doppler_step);
 
-    float threshold = configuration->property("Acquisition_" + implementation_ + boost::lexical_cast<std::string>(channel_) + ".threshold", 0.0);
-    if(threshold == 0.0) threshold = configuration->property("Acquisition_" + implementation_ + ".threshold", 0.0);
+    float threshold = configuration->property(acq_channel_prefix + ".threshold", 0.0);
+    if(threshold == 0.0) threshold = configuration->property(acq_prefix + ".threshold", 0.0);
 
     acq_->set_threshold(threshold);
 
     acq_->init();
 
-    repeat_ = configuration->property("Acquisition_" + implementation_ + boost::lexical_cast<std::string>(channel_) + ".repeat_satellite", false);
+    repeat_ = configuration->property(acq_channel_prefix + ".repeat_satellite", false);
     DLOG(INFO) << "Channel " << channel_ << " satellite repeat = " << repeat_;
 
     channel_fsm_.set_acquisition(acq_);
@@ -92,6 +96,11 @@ Channel::Channel(ConfigurationInterface *configuration, unsigned int channel,
     gnss_signal_ = Gnss_Signal(implementation_);
 
     channel_msg_rx = channel_msg_receiver_make_cc(&channel_fsm_, repeat_);
+
+    if (configuration->property("Channels.dynamic_pool", false))
+        {
+            gate_ = gnss_sdr_make_channel_gate(pass_through_->item_size(), channel_);
+        }
 }
 
 // Destructor
@@ -107,15 +116,18 @@ void Channel::connect(gr::top_block_sptr top_block)
             LOG(WARNING) << "channel already connected internally";
             return;
         }
-    pass_through_->connect(top_block);
+    if (!gate_)
+        {
+            pass_through_->connect(top_block);
+        }
     acq_->connect(top_block);
     trk_->connect(top_block);
     nav_->connect(top_block);
 
     //Synchronous ports
-    top_block->connect(pass_through_->get_right_block(), 0, acq_->get_left_block(), 0);
+    top_block->connect(get_left_block(), 0, acq_->get_left_block(), 0);
     DLOG(INFO) << "pass_through_ -> acquisition";
-    top_block->connect(pass_through_->get_right_block(), 0, trk_->get_left_block(), 0);
+    top_block->connect(get_left_block(), 0, trk_->get_left_block(), 0);
     DLOG(INFO) << "pass_through_ -> tracking";
     top_block->connect(trk_->get_right_block(), 0, nav_->get_left_block(), 0);
     DLOG(INFO) << "tracking -> telemetry_decoder";
@@ -140,10 +152,13 @@ void Channel::disconnect(gr::top_block_sptr top_block)
             LOG(WARNING) << "Channel already disconnected internally";
             return;
         }
-    top_block->disconnect(pass_through_->get_right_block(), 0, acq_->get_left_block(), 0);
-    top_block->disconnect(pass_through_->get_right_block(), 0, trk_->get_left_block(), 0);
+    top_block->disconnect(get_left_block(), 0, acq_->get_left_block(), 0);
+    top_block->disconnect(get_left_block(), 0, trk_->get_left_block(), 0);
     top_block->disconnect(trk_->get_right_block(), 0, nav_->get_left_block(), 0);
-    pass_through_->disconnect(top_block);
+    if (!gate_)
+        {
+            pass_through_->disconnect(top_block);
+        }
     acq_->disconnect(top_block);
     trk_->disconnect(top_block);
     nav_->disconnect(top_block);
@@ -153,6 +168,10 @@ void Channel::disconnect(gr::top_block_sptr top_block)
 
 gr::basic_block_sptr Channel::get_left_block()
 {
+    if (gate_)
+        {
+            return gate_;
+        }
     return pass_through_->get_left_block();
 }
 
@@ -214,3 +233,43 @@ unsigned int Channel::get_state()
 {
     return state;
 }
+
+
+bool Channel::park()
+{
+    if (!gate_)
+        {
+            return false;
+        }
+    if (!acq_->skip_samples(0) || !trk_->skip_samples(0))
+        {
+            LOG(WARNING) << "Channel " << channel_ << " cannot be parked: " << acq_->implementation()
+                         << " or " << trk_->implementation() << " cannot skip samples";
+            return false;
+        }
+    gate_->park();
+    DLOG(INFO) << "Channel " << channel_ << " parked";
+    return true;
+}
+
+
+void Channel::activate()
+{
+    if (!gate_)
+        {
+            return;
+        }
+    // the blocks are idle while parked, so their counters can be moved safely
+    gate_->resume([this](unsigned long long skipped)
+        {
+            acq_->skip_samples(skipped);
+            trk_->skip_samples(skipped);
+            DLOG(INFO) << "Channel " << channel_ << " activated after skipping " << skipped << " samples";
+        });
+}
+
+
+bool Channel::parked()
+{
+    return gate_ && gate_->parked();
+}
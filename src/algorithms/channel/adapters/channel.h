@@ -43,6 +43,7 @@
 #include "channel_fsm.h"
 #include "gnss_synchro.h"
 #include "channel_msg_receiver_cc.h"
+#include "gnss_sdr_channel_gate.h"
 
 class ConfigurationInterface;
 class AcquisitionInterface;
@@ -91,9 +92,18 @@ public:
     unsigned int get_state(); //!< get the state of the signal 
     unsigned int get_uid();
 
+    /*!
+     * \brief With Channels.dynamic_pool=true, drops the channel input so that
+     * acquisition, tracking and telemetry stay idle until activate()
+     */
+    bool park();
+    void activate();
+    bool parked();
+
 private:
     channel_msg_receiver_cc_sptr channel_msg_rx;
     std::shared_ptr<GNSSBlockInterface> pass_through_;
+    gnss_sdr_channel_gate_sptr gate_;   // replaces pass_through_ in a dynamic channel pool
     std::shared_ptr<AcquisitionInterface> acq_;
     std::shared_ptr<TrackingInterface> trk_;
     std::shared_ptr<TelemetryDecoderInterface> nav_;
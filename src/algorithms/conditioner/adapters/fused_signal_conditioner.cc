@@ -0,0 +1,214 @@
+/*!
+ * \file fused_signal_conditioner.cc
+ * \brief Signal conditioner that runs the data type adapter, input filter and
+ * resampler stages in a single block
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+
+#include "fused_signal_conditioner.h"
+#include <boost/lexical_cast.hpp>
+#include <gnuradio/filter/pm_remez.h>
+#include <glog/logging.h>
+#include "configuration_interface.h"
+
+
+using google::LogMessage;
+
+FusedSignalConditioner::FusedSignalConditioner(ConfigurationInterface* configuration, std::string role,
+        std::string data_type_adapter_role, std::string input_filter_role,
+        std::string resampler_role) : role_(role)
+{
+    std::string default_implementation = "Pass_Through";
+    std::string default_dump_filename = "./data/signal_conditioner.dat";
+
+    std::string data_type_adapter = configuration->property(data_type_adapter_role + ".implementation", default_implementation);
+    std::string input_type = "gr_complex";
+    if (data_type_adapter.compare("Ishort_To_Complex") == 0)
+        {
+            input_type = "ishort";
+        }
+    else if (data_type_adapter.compare("Ibyte_To_Complex") == 0)
+        {
+            input_type = "ibyte";
+        }
+    float scale = configuration->property(data_type_adapter_role + ".scale", 1.0f);
+    bool remove_dc = configuration->property(data_type_adapter_role + ".remove_dc", false);
+    double dc_window_samples = configuration->property(data_type_adapter_role + ".dc_window_samples", 1048576.0);
+
+    std::string input_filter = configuration->property(input_filter_role + ".implementation", default_implementation);
+    std::vector<float> taps;
+    double intermediate_freq = 0.0;
+    double sampling_freq = 4000000.0;
+    unsigned int decimation = 1;
+    if (input_filter.compare("Pass_Through") != 0)
+        {
+            taps = design_taps(configuration, input_filter_role);
+        }
+    if (input_filter.compare("Freq_Xlating_Fir_Filter") == 0)
+        {
+            intermediate_freq = configuration->property(input_filter_role + ".IF", intermediate_freq);
+            sampling_freq = configuration->property(input_filter_role + ".sampling_frequency", sampling_freq);
+            decimation = configuration->property(input_filter_role + ".decimation_factor", 1);
+        }
+
+    std::string resampler = configuration->property(resampler_role + ".implementation", default_implementation);
+    bool resample = (resampler.compare("Direct_Resampler") == 0);
+    double sample_freq_in = configuration->property(resampler_role + ".sample_freq_in", 4000000.0);
+    double sample_freq_out = configuration->property(resampler_role + ".sample_freq_out", 2048000.0);
+
+    conditioner_ = make_fused_conditioner(input_type, scale, remove_dc, dc_window_samples,
+            taps, intermediate_freq, sampling_freq, decimation, resample, sample_freq_in, sample_freq_out);
+    DLOG(INFO) << "fused_conditioner(" << conditioner_->unique_id() << ") input " << input_type
+               << ", " << taps.size() << " taps, decimation " << decimation;
+
+    dump_ = configuration->property(role_ + ".dump", false);
+    dump_filename_ = configuration->property(role_ + ".dump_filename", default_dump_filename);
+    if (dump_)
+        {
+            DLOG(INFO) << "Dumping output into file " << dump_filename_;
+            file_sink_ = gr::blocks::file_sink::make(sizeof(gr_complex), dump_filename_.c_str());
+        }
+}
+
+
+FusedSignalConditioner::~FusedSignalConditioner()
+{}
+
+
+bool FusedSignalConditioner::can_fuse(ConfigurationInterface* configuration, std::string data_type_adapter_role,
+        std::string input_filter_role, std::string resampler_role)
+{
+    std::string default_implementation = "Pass_Through";
+    std::string data_type_adapter = configuration->property(data_type_adapter_role + ".implementation", default_implementation);
+    std::string input_filter = configuration->property(input_filter_role + ".implementation", default_implementation);
+    std::string resampler = configuration->property(resampler_role + ".implementation", default_implementation);
+
+    if ((data_type_adapter.compare("Ishort_To_Complex") != 0) && (data_type_adapter.compare("Ibyte_To_Complex") != 0)
+            && (data_type_adapter.compare("Pass_Through") != 0))
+        {
+            return false;
+        }
+    if (input_filter.compare("Pass_Through") == 0)
+        {
+            std::string input_type = configuration->property(input_filter_role + ".input_item_type", std::string("gr_complex"));
+            if ((data_type_adapter.compare("Pass_Through") == 0)
+                    && (configuration->property(input_filter_role + ".item_type", input_type).compare("gr_complex") != 0))
+                {
+                    return false;
+                }
+        }
+    else if ((input_filter.compare("Fir_Filter") == 0) || (input_filter.compare("Freq_Xlating_Fir_Filter") == 0))
+        {
+            if ((configuration->property(input_filter_role + ".input_item_type", std::string("gr_complex")).compare("gr_complex") != 0)
+                    || (configuration->property(input_filter_role + ".output_item_type", std::string("gr_complex")).compare("gr_complex") != 0)
+                    || (configuration->property(input_filter_role + ".taps_item_type", std::string("float")).compare("float") != 0))
+                {
+                    return false;
+                }
+        }
+    else
+        {
+            return false;
+        }
+    if (resampler.compare("Direct_Resampler") == 0)
+        {
+            return configuration->property(resampler_role + ".item_type", std::string("short")).compare("gr_complex") == 0;
+        }
+    return resampler.compare("Pass_Through") == 0;
+}
+
+
+void FusedSignalConditioner::connect(gr::top_block_sptr top_block)
+{
+    if (dump_)
+        {
+            top_block->connect(conditioner_, 0, file_sink_, 0);
+        }
+}
+
+
+void FusedSignalConditioner::disconnect(gr::top_block_sptr top_block)
+{
+    if (dump_)
+        {
+            top_block->disconnect(conditioner_, 0, file_sink_, 0);
+        }
+}
+
+
+gr::basic_block_sptr FusedSignalConditioner::get_left_block()
+{
+    return conditioner_;
+}
+
+
+gr::basic_block_sptr FusedSignalConditioner::get_right_block()
+{
+    return conditioner_;
+}
+
+
+std::vector<float> FusedSignalConditioner::design_taps(ConfigurationInterface* configuration, std::string input_filter_role)
+{
+    // Same design and defaults as FirFilter and FreqXlatingFirFilter
+    int default_number_of_taps = 6;
+    unsigned int default_number_of_bands = 2;
+    std::vector<double> default_bands = { 0.0, 0.4, 0.6, 1.0 };
+    std::string default_filter_type = "bandpass";
+    int default_grid_density = 16;
+
+    int number_of_taps = configuration->property(input_filter_role + ".number_of_taps", default_number_of_taps);
+    unsigned int number_of_bands = configuration->property(input_filter_role + ".number_of_bands", default_number_of_bands);
+
+    std::vector<double> bands;
+    std::vector<double> ampl;
+    std::vector<double> error_w;
+    std::string option;
+    for (unsigned int i = 0; i < number_of_bands; i++)
+        {
+            option = ".band" + boost::lexical_cast<std::string>(i + 1) + "_begin";
+            bands.push_back(configuration->property(input_filter_role + option, default_bands[i]));
+
+            option = ".band" + boost::lexical_cast<std::string>(i + 1) + "_end";
+            bands.push_back(configuration->property(input_filter_role + option, default_bands[i]));
+
+            option = ".ampl" + boost::lexical_cast<std::string>(i + 1) + "_begin";
+            ampl.push_back(configuration->property(input_filter_role + option, default_bands[i]));
+
+            option = ".ampl" + boost::lexical_cast<std::string>(i + 1) + "_end";
+            ampl.push_back(configuration->property(input_filter_role + option, default_bands[i]));
+
+            option = ".band" + boost::lexical_cast<std::string>(i + 1) + "_error";
+            error_w.push_back(configuration->property(input_filter_role + option, default_bands[i]));
+        }
+
+    std::string filter_type = configuration->property(input_filter_role + ".filter_type", default_filter_type);
+    int grid_density = configuration->property(input_filter_role + ".grid_density", default_grid_density);
+
+    std::vector<double> taps_d = gr::filter::pm_remez(number_of_taps - 1, bands, ampl, error_w, filter_type, grid_density);
+    return std::vector<float>(taps_d.begin(), taps_d.end());
+}
@@ -0,0 +1,87 @@
+/*!
+ * \file fused_signal_conditioner.h
+ * \brief Signal conditioner that runs the data type adapter, input filter and
+ * resampler stages in a single block
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+
+#ifndef GNSS_SDR_FUSED_SIGNAL_CONDITIONER_H_
+#define GNSS_SDR_FUSED_SIGNAL_CONDITIONER_H_
+
+#include <string>
+#include <vector>
+#include <gnuradio/blocks/file_sink.h>
+#include "gnss_block_interface.h"
+#include "fused_conditioner.h"
+
+
+class ConfigurationInterface;
+
+/*!
+ * \brief This class replaces the DataTypeAdapter -> InputFilter -> Resampler
+ * chain of SignalConditioner with a single fused_conditioner block
+ *
+ * It reads the same configuration keys as the blocks it replaces. Supported
+ * stages are Ishort_To_Complex, Ibyte_To_Complex or Pass_Through (gr_complex
+ * input) for the DataTypeAdapter, Fir_Filter, Freq_Xlating_Fir_Filter or
+ * Pass_Through for the InputFilter, and Direct_Resampler or Pass_Through for
+ * the Resampler, with gr_complex output. can_fuse() tells whether a
+ * configuration fits.
+ */
+class FusedSignalConditioner: public GNSSBlockInterface
+{
+public:
+    FusedSignalConditioner(ConfigurationInterface* configuration, std::string role,
+            std::string data_type_adapter_role, std::string input_filter_role,
+            std::string resampler_role);
+
+    virtual ~FusedSignalConditioner();
+
+    static bool can_fuse(ConfigurationInterface* configuration, std::string data_type_adapter_role,
+            std::string input_filter_role, std::string resampler_role);
+
+    void connect(gr::top_block_sptr top_block);
+    void disconnect(gr::top_block_sptr top_block);
+    gr::basic_block_sptr get_left_block();
+    gr::basic_block_sptr get_right_block();
+
+    std::string role(){ return role_; }
+    //! Returns "Fused_Signal_Conditioner"
+    std::string implementation(){ return "Fused_Signal_Conditioner"; }
+    size_t item_size(){ return 0; }
+
+private:
+    std::vector<float> design_taps(ConfigurationInterface* configuration, std::string input_filter_role);
+
+    fused_conditioner_sptr conditioner_;
+    std::string role_;
+    bool dump_;
+    std::string dump_filename_;
+    gr::blocks::file_sink::sptr file_sink_;
+};
+
+#endif /*GNSS_SDR_FUSED_SIGNAL_CONDITIONER_H_*/
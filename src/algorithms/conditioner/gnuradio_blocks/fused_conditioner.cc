@@ -0,0 +1,303 @@
+/*!
+ * \file fused_conditioner.cc
+ * \brief Signal conditioner that converts, mixes, filters, decimates and
+ * resamples the input stream in a single pass
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+
+#include "fused_conditioner.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <glog/logging.h>
+#include <gnuradio/io_signature.h>
+#include <gnuradio/math.h>
+#include <volk_gnsssdr/volk_gnsssdr.h>
+
+using google::LogMessage;
+
+namespace
+{
+size_t input_item_size(const std::string& input_type)
+{
+    if (input_type.compare("ishort") == 0)
+        {
+            return sizeof(int16_t);
+        }
+    if (input_type.compare("ibyte") == 0)
+        {
+            return sizeof(int8_t);
+        }
+    return sizeof(gr_complex);
+}
+}
+
+
+fused_conditioner_sptr make_fused_conditioner(const std::string& input_type,
+        float scale, bool remove_dc, double dc_window_samples,
+        const std::vector<float>& taps, double intermediate_freq, double sampling_freq,
+        unsigned int decimation, bool resample, double sample_freq_in, double sample_freq_out)
+{
+    return fused_conditioner_sptr(new fused_conditioner(input_type, scale, remove_dc, dc_window_samples,
+            taps, intermediate_freq, sampling_freq, decimation, resample, sample_freq_in, sample_freq_out));
+}
+
+
+
+fused_conditioner::fused_conditioner(const std::string& input_type,
+        float scale, bool remove_dc, double dc_window_samples,
+        const std::vector<float>& taps, double intermediate_freq, double sampling_freq,
+        unsigned int decimation, bool resample, double sample_freq_in, double sample_freq_out) :
+            gr::block("fused_conditioner",
+                    gr::io_signature::make(1, 1, input_item_size(input_type)),
+                    gr::io_signature::make(1, 1, sizeof(gr_complex))),
+            d_scale(scale),
+            d_remove_dc(remove_dc),
+            d_dc(dc_window_samples)
+{
+    if (input_type.compare("ishort") == 0)
+        {
+            d_input_format = input_ishort;
+            d_items_per_sample = 2;
+        }
+    else if (input_type.compare("ibyte") == 0)
+        {
+            d_input_format = input_ibyte;
+            d_items_per_sample = 2;
+        }
+    else
+        {
+            if (input_type.compare("gr_complex") != 0)
+                {
+                    LOG(WARNING) << input_type << " unrecognized input type for the fused conditioner, using gr_complex";
+                }
+            d_input_format = input_gr_complex;
+            d_items_per_sample = 1;
+            d_remove_dc = false;
+        }
+    d_sample_size = input_item_size(input_type) * d_items_per_sample;
+
+    // The taps are stored reversed so that each filter output is a plain dot product
+    // with the input window that ends at the newest sample
+    d_taps_reversed.assign(taps.rbegin(), taps.rend());
+    if (d_taps_reversed.empty())
+        {
+            d_taps_reversed.push_back(1.0);
+        }
+    d_identity_filter = (d_taps_reversed.size() == 1) && (d_taps_reversed[0] == 1.0);
+    d_decimation = std::max(decimation, 1u);
+
+    d_mix = (intermediate_freq != 0.0);
+    const double phase_step_rad = -2.0 * GR_M_PI * intermediate_freq / sampling_freq;
+    d_phase_inc = lv_cmake(static_cast<float>(std::cos(phase_step_rad)), static_cast<float>(std::sin(phase_step_rad)));
+    d_nco_phase = lv_cmake(1.0f, 0.0f);
+
+    // Same phase accumulator as direct_resampler_conditioner_cc
+    d_resample = resample && (sample_freq_in != sample_freq_out);
+    d_upsample = d_resample && (sample_freq_in < sample_freq_out);
+    d_resample_ratio = d_resample ? sample_freq_out / sample_freq_in : 1.0;
+    const double two_32 = 4294967296.0;
+    if (d_upsample)
+        {
+            d_phase_step = static_cast<uint32_t>(std::floor(two_32 * sample_freq_in / sample_freq_out));
+            set_output_multiple(static_cast<int>(std::ceil(d_resample_ratio)) + 1);
+        }
+    else
+        {
+            d_phase_step = d_resample ? static_cast<uint32_t>(std::floor(two_32 * sample_freq_out / sample_freq_in)) : 0;
+        }
+    d_resampler.phase = 0;
+    d_resampler.lphase = 0;
+    d_resampler.pending = false;
+
+    d_next_output = 0;
+    d_chunk = 8192;
+    d_work.assign(d_taps_reversed.size() - 1 + d_chunk, gr_complex(0.0, 0.0));
+
+    set_relative_rate(d_resample_ratio / static_cast<double>(d_items_per_sample * d_decimation));
+}
+
+
+
+fused_conditioner::~fused_conditioner()
+{}
+
+
+
+void fused_conditioner::forecast(int noutput_items, gr_vector_int &ninput_items_required)
+{
+    const double samples = std::ceil(static_cast<double>(noutput_items) * d_decimation / d_resample_ratio);
+    const int nreqd = std::max(1, static_cast<int>(samples)) * d_items_per_sample;
+    for (unsigned int i = 0; i < ninput_items_required.size(); i++)
+        {
+            ninput_items_required[i] = nreqd;
+        }
+}
+
+
+
+unsigned int fused_conditioner::outputs_for_next_sample(resampler_state& state) const
+{
+    if (!d_resample)
+        {
+            return 1;
+        }
+    if (!d_upsample)
+        {
+            // The sample is kept when the accumulator wraps around
+            unsigned int outputs = (state.phase <= state.lphase) ? 1 : 0;
+            state.lphase = state.phase;
+            state.phase += d_phase_step;
+            return outputs;
+        }
+    // Upsampling: the sample is repeated until the accumulator wraps around.
+    // The output on which it wraps already belongs to the next sample.
+    unsigned int outputs = state.pending ? 1 : 0;
+    while (true)
+        {
+            state.lphase = state.phase;
+            state.phase += d_phase_step;
+            if (state.phase <= state.lphase)
+                {
+                    state.pending = true;
+                    return outputs;
+                }
+            outputs++;
+        }
+}
+
+
+
+void fused_conditioner::convert(const void* in, gr_complex* out, int num_samples)
+{
+    lv_32fc_t offset = lv_cmake(0.0f, 0.0f);
+    if (d_input_format == input_ishort)
+        {
+            if (d_remove_dc)
+                {
+                    d_dc.update(static_cast<const int16_t*>(in), num_samples);
+                    offset = lv_cmake(static_cast<float>(d_dc.in_phase()), static_cast<float>(d_dc.quadrature()));
+                }
+            volk_gnsssdr_16ic_s32fc_s32f_convert_32fc(out, static_cast<const lv_16sc_t*>(in), offset, d_scale, num_samples);
+        }
+    else if (d_input_format == input_ibyte)
+        {
+            if (d_remove_dc)
+                {
+                    d_dc.update(static_cast<const int8_t*>(in), num_samples);
+                    offset = lv_cmake(static_cast<float>(d_dc.in_phase()), static_cast<float>(d_dc.quadrature()));
+                }
+            volk_gnsssdr_8ic_s32fc_s32f_convert_32fc(out, static_cast<const lv_8sc_t*>(in), offset, d_scale, num_samples);
+        }
+    else if (d_scale == 1.0f)
+        {
+            std::memcpy(out, in, num_samples * sizeof(gr_complex));
+        }
+    else
+        {
+            volk_32fc_s32fc_multiply_32fc(out, static_cast<const gr_complex*>(in), lv_cmake(d_scale, 0.0f), num_samples);
+        }
+}
+
+
+
+int fused_conditioner::general_work(int noutput_items, gr_vector_int &ninput_items,
+        gr_vector_const_void_star &input_items,
+        gr_vector_void_star &output_items)
+{
+    const char *in = static_cast<const char *>(input_items[0]);
+    gr_complex *out = static_cast<gr_complex *>(output_items[0]);
+    const int history = d_taps_reversed.size() - 1;
+    const int available = ninput_items[0] / d_items_per_sample;
+    int consumed = 0;
+    int produced = 0;
+
+    while (consumed < available)
+        {
+            int chunk = std::min(available - consumed, d_chunk);
+
+            // Trim the chunk to the input samples whose outputs fit in the output buffer.
+            // The resampler decisions do not depend on the sample values.
+            resampler_state state = d_resampler;
+            int outputs = 0;
+            for (int pos = d_next_output; pos < chunk; pos += d_decimation)
+                {
+                    int n = outputs_for_next_sample(state);
+                    if (produced + outputs + n > noutput_items)
+                        {
+                            chunk = pos;
+                            break;
+                        }
+                    outputs += n;
+                }
+            if (chunk == 0)
+                {
+                    break;
+                }
+
+            // The new samples go after the last history samples of the previous chunk
+            gr_complex *work = &d_work[history];
+            convert(in + consumed * d_sample_size, work, chunk);
+            if (d_mix)
+                {
+                    volk_32fc_s32fc_x2_rotator_32fc(work, work, d_phase_inc, &d_nco_phase, chunk);
+                }
+
+            int pos = d_next_output;
+            for (; pos < chunk; pos += d_decimation)
+                {
+                    unsigned int n = outputs_for_next_sample(d_resampler);
+                    if (n == 0)
+                        {
+                            continue;
+                        }
+                    gr_complex filtered;
+                    if (d_identity_filter)
+                        {
+                            filtered = work[pos];
+                        }
+                    else
+                        {
+                            volk_32fc_32f_dot_prod_32fc(&filtered, &d_work[pos], d_taps_reversed.data(), d_taps_reversed.size());
+                        }
+                    for (unsigned int k = 0; k < n; k++)
+                        {
+                            out[produced++] = filtered;
+                        }
+                }
+            d_next_output = pos - chunk;
+
+            if (history > 0)
+                {
+                    std::memmove(&d_work[0], &d_work[chunk], history * sizeof(gr_complex));
+                }
+            consumed += chunk;
+        }
+
+    consume_each(consumed * d_items_per_sample);
+    return produced;
+}
@@ -0,0 +1,122 @@
+/*!
+ * \file fused_conditioner.h
+ * \brief Signal conditioner that converts, mixes, filters, decimates and
+ * resamples the input stream in a single pass
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+
+#ifndef GNSS_SDR_FUSED_CONDITIONER_H_
+#define GNSS_SDR_FUSED_CONDITIONER_H_
+
+#include <string>
+#include <vector>
+#include <gnuradio/block.h>
+#include <volk/volk.h>
+#include "dc_offset_estimator.h"
+
+class fused_conditioner;
+
+typedef boost::shared_ptr<fused_conditioner> fused_conditioner_sptr;
+
+fused_conditioner_sptr make_fused_conditioner(const std::string& input_type,
+        float scale, bool remove_dc, double dc_window_samples,
+        const std::vector<float>& taps, double intermediate_freq, double sampling_freq,
+        unsigned int decimation, bool resample, double sample_freq_in, double sample_freq_out);
+
+/*!
+ * \brief This class implements the whole signal conditioner chain in one block
+ *
+ * Each chunk of input samples is converted to gr_complex (interleaved
+ * "ishort" or "ibyte" input, with optional scale and DC removal, or
+ * "gr_complex" input), mixed down by the intermediate frequency, filtered
+ * with the FIR taps and decimated. The direct resampler then picks samples
+ * from the decimated stream. Filter outputs are only computed for the
+ * samples the decimator and the resampler keep, and the chunk is small
+ * enough to stay in cache between the stages, so no full-rate buffer is
+ * written between them.
+ *
+ * The output matches DataTypeAdapter -> Fir_Filter / Freq_Xlating_Fir_Filter
+ * -> Direct_Resampler up to a constant carrier phase.
+ */
+class fused_conditioner : public gr::block
+{
+private:
+    friend fused_conditioner_sptr make_fused_conditioner(const std::string& input_type,
+            float scale, bool remove_dc, double dc_window_samples,
+            const std::vector<float>& taps, double intermediate_freq, double sampling_freq,
+            unsigned int decimation, bool resample, double sample_freq_in, double sample_freq_out);
+
+    fused_conditioner(const std::string& input_type,
+            float scale, bool remove_dc, double dc_window_samples,
+            const std::vector<float>& taps, double intermediate_freq, double sampling_freq,
+            unsigned int decimation, bool resample, double sample_freq_in, double sample_freq_out);
+
+    enum input_format { input_ishort, input_ibyte, input_gr_complex };
+
+    //! Phase accumulator of the direct resampler, advanced once per decimated sample
+    struct resampler_state
+    {
+        uint32_t phase;
+        uint32_t lphase;
+        bool pending;
+    };
+
+    unsigned int outputs_for_next_sample(resampler_state& state) const;
+    void convert(const void* in, gr_complex* out, int num_samples);
+
+    input_format d_input_format;
+    int d_items_per_sample;
+    size_t d_sample_size;
+    float d_scale;
+    bool d_remove_dc;
+    dc_offset_estimator d_dc;
+    std::vector<float> d_taps_reversed;
+    bool d_identity_filter;
+    unsigned int d_decimation;
+    bool d_mix;
+    lv_32fc_t d_phase_inc;
+    lv_32fc_t d_nco_phase;
+    bool d_resample;
+    bool d_upsample;
+    double d_resample_ratio;
+    uint32_t d_phase_step;
+    resampler_state d_resampler;
+    int d_next_output;
+    int d_chunk;
+    std::vector<gr_complex> d_work;
+
+public:
+    ~fused_conditioner();
+
+    void forecast(int noutput_items, gr_vector_int &ninput_items_required);
+
+    int general_work(int noutput_items, gr_vector_int &ninput_items,
+            gr_vector_const_void_star &input_items,
+            gr_vector_void_star &output_items);
+};
+
+#endif
@@ -46,15 +46,18 @@ IbyteToComplex::IbyteToComplex(ConfigurationInterface* configuration, std::strin
     DLOG(INFO) << "role " << role_;
 
     input_item_type_ = config_->property(role_ + ".input_item_type", default_input_item_type);
+    scale_ = config_->property(role_ + ".scale", 1.0f);
+    remove_dc_ = config_->property(role_ + ".remove_dc", false);
+    dc_window_samples_ = config_->property(role_ + ".dc_window_samples", 1048576.0);
 
     dump_ = config_->property(role_ + ".dump", false);
     dump_filename_ = config_->property(role_ + ".dump_filename", default_dump_filename);
 
     size_t item_size = sizeof(gr_complex);
 
-    gr_interleaved_char_to_complex_ = gr::blocks::interleaved_char_to_complex::make();
+    interleaved_byte_to_complex_ = make_interleaved_byte_to_complex(scale_, remove_dc_, dc_window_samples_);
 
-    DLOG(INFO) << "data_type_adapter_(" << gr_interleaved_char_to_complex_->unique_id() << ")";
+    DLOG(INFO) << "data_type_adapter_(" << interleaved_byte_to_complex_->unique_id() << ")";
 
     if (dump_)
         {
@@ -72,7 +75,7 @@ void IbyteToComplex::connect(gr::top_block_sptr top_block)
 {
     if (dump_)
         {
-            top_block->connect(gr_interleaved_char_to_complex_, 0, file_sink_, 0);
+            top_block->connect(interleaved_byte_to_complex_, 0, file_sink_, 0);
         }
 }
 
@@ -81,7 +84,7 @@ void IbyteToComplex::disconnect(gr::top_block_sptr top_block)
 {
     if (dump_)
         {
-            top_block->disconnect(gr_interleaved_char_to_complex_, 0, file_sink_, 0);
+            top_block->disconnect(interleaved_byte_to_complex_, 0, file_sink_, 0);
         }
 }
 
@@ -89,14 +92,14 @@ void IbyteToComplex::disconnect(gr::top_block_sptr top_block)
 
 gr::basic_block_sptr IbyteToComplex::get_left_block()
 {
-    return gr_interleaved_char_to_complex_;
+    return interleaved_byte_to_complex_;
 }
 
 
 
 gr::basic_block_sptr IbyteToComplex::get_right_block()
 {
-    return gr_interleaved_char_to_complex_;
+    return interleaved_byte_to_complex_;
 }
 
 
@@ -32,10 +32,10 @@
 #define GNSS_SDR_IBYTE_TO_COMPLEX_H_
 
 #include <string>
-#include <gnuradio/blocks/interleaved_char_to_complex.h>
 #include <gnuradio/blocks/file_sink.h>
 #include "gnss_synchro.h"
 #include "gnss_block_interface.h"
+#include "interleaved_byte_to_complex.h"
 
 
 class ConfigurationInterface;
@@ -73,8 +73,11 @@ public:
     gr::basic_block_sptr get_right_block();
 
 private:
-    gr::blocks::interleaved_char_to_complex::sptr gr_interleaved_char_to_complex_;
+    interleaved_byte_to_complex_sptr interleaved_byte_to_complex_;
     ConfigurationInterface* config_;
+    float scale_;
+    bool remove_dc_;
+    double dc_window_samples_;
     bool dump_;
     std::string dump_filename_;
     std::string input_item_type_;
@@ -48,13 +48,15 @@ IbyteToCshort::IbyteToCshort(ConfigurationInterface* configuration, std::string
     DLOG(INFO) << "role " << role_;
 
     input_item_type_ = config_->property(role_ + ".input_item_type", default_input_item_type);
+    remove_dc_ = config_->property(role_ + ".remove_dc", false);
+    dc_window_samples_ = config_->property(role_ + ".dc_window_samples", 1048576.0);
 
     dump_ = config_->property(role_ + ".dump", false);
     dump_filename_ = config_->property(role_ + ".dump_filename", default_dump_filename);
 
     size_t item_size = sizeof(lv_16sc_t);
 
-    interleaved_byte_to_complex_short_ = make_interleaved_byte_to_complex_short();
+    interleaved_byte_to_complex_short_ = make_interleaved_byte_to_complex_short(remove_dc_, dc_window_samples_);
 
     DLOG(INFO) << "data_type_adapter_(" << interleaved_byte_to_complex_short_->unique_id()<<")";
 
@@ -75,6 +75,8 @@ public:
 private:
     interleaved_byte_to_complex_short_sptr interleaved_byte_to_complex_short_;
     ConfigurationInterface* config_;
+    bool remove_dc_;
+    double dc_window_samples_;
     bool dump_;
     std::string dump_filename_;
     std::string input_item_type_;
@@ -46,15 +46,18 @@ IshortToComplex::IshortToComplex(ConfigurationInterface* configuration, std::str
     DLOG(INFO) << "role " << role_;
 
     input_item_type_ = config_->property(role_ + ".input_item_type", default_input_item_type);
+    scale_ = config_->property(role_ + ".scale", 1.0f);
+    remove_dc_ = config_->property(role_ + ".remove_dc", false);
+    dc_window_samples_ = config_->property(role_ + ".dc_window_samples", 1048576.0);
 
     dump_ = config_->property(role_ + ".dump", false);
     dump_filename_ = config_->property(role_ + ".dump_filename", default_dump_filename);
 
     size_t item_size = sizeof(gr_complex);
 
-    gr_interleaved_short_to_complex_ = gr::blocks::interleaved_short_to_complex::make();
+    interleaved_short_to_complex_ = make_interleaved_short_to_complex(scale_, remove_dc_, dc_window_samples_);
 
-    DLOG(INFO) << "data_type_adapter_(" << gr_interleaved_short_to_complex_->unique_id() << ")";
+    DLOG(INFO) << "data_type_adapter_(" << interleaved_short_to_complex_->unique_id() << ")";
 
     if (dump_)
         {
@@ -72,7 +75,7 @@ void IshortToComplex::connect(gr::top_block_sptr top_block)
 {
     if (dump_)
         {
-            top_block->connect(gr_interleaved_short_to_complex_, 0, file_sink_, 0);
+            top_block->connect(interleaved_short_to_complex_, 0, file_sink_, 0);
         }
     else
         {
@@ -85,7 +88,7 @@ void IshortToComplex::disconnect(gr::top_block_sptr top_block)
 {
     if (dump_)
         {
-            top_block->disconnect(gr_interleaved_short_to_complex_, 0, file_sink_, 0);
+            top_block->disconnect(interleaved_short_to_complex_, 0, file_sink_, 0);
         }
 }
 
@@ -93,14 +96,14 @@ void IshortToComplex::disconnect(gr::top_block_sptr top_block)
 
 gr::basic_block_sptr IshortToComplex::get_left_block()
 {
-    return gr_interleaved_short_to_complex_;
+    return interleaved_short_to_complex_;
 }
 
 
 
 gr::basic_block_sptr IshortToComplex::get_right_block()
 {
-    return gr_interleaved_short_to_complex_;
+    return interleaved_short_to_complex_;
 }
 
 
@@ -0,0 +1,108 @@
+/*!
+ * \file dc_offset_estimator.cc
+ * \brief Running estimate of the DC offset of an interleaved I/Q integer stream
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+
+#include "dc_offset_estimator.h"
+#include <algorithm>
+#include <cmath>
+
+
+dc_offset_estimator::dc_offset_estimator(double window_samples) :
+    window_samples_(std::max(window_samples, 1.0)),
+    in_phase_(0.0),
+    quadrature_(0.0),
+    initialized_(false)
+{}
+
+
+void dc_offset_estimator::update(const int8_t* in, int num_samples)
+{
+    // 32-bit sums cannot overflow for buffers of up to 2^24 samples
+    int64_t sum_i = 0;
+    int64_t sum_q = 0;
+    const int chunk = 1 << 24;
+    for (int start = 0; start < num_samples; start += chunk)
+        {
+            const int end = std::min(num_samples, start + chunk);
+            int32_t part_i = 0;
+            int32_t part_q = 0;
+            for (int n = start; n < end; n++)
+                {
+                    part_i += in[2 * n];
+                    part_q += in[2 * n + 1];
+                }
+            sum_i += part_i;
+            sum_q += part_q;
+        }
+    fold(sum_i, sum_q, num_samples);
+}
+
+
+void dc_offset_estimator::update(const int16_t* in, int num_samples)
+{
+    // 32-bit sums cannot overflow for buffers of up to 2^16 samples
+    int64_t sum_i = 0;
+    int64_t sum_q = 0;
+    const int chunk = 1 << 16;
+    for (int start = 0; start < num_samples; start += chunk)
+        {
+            const int end = std::min(num_samples, start + chunk);
+            int32_t part_i = 0;
+            int32_t part_q = 0;
+            for (int n = start; n < end; n++)
+                {
+                    part_i += in[2 * n];
+                    part_q += in[2 * n + 1];
+                }
+            sum_i += part_i;
+            sum_q += part_q;
+        }
+    fold(sum_i, sum_q, num_samples);
+}
+
+
+void dc_offset_estimator::fold(int64_t sum_i, int64_t sum_q, int num_samples)
+{
+    if (num_samples <= 0)
+        {
+            return;
+        }
+    const double mean_i = static_cast<double>(sum_i) / static_cast<double>(num_samples);
+    const double mean_q = static_cast<double>(sum_q) / static_cast<double>(num_samples);
+    if (!initialized_)
+        {
+            in_phase_ = mean_i;
+            quadrature_ = mean_q;
+            initialized_ = true;
+            return;
+        }
+    const double alpha = 1.0 - std::exp(-static_cast<double>(num_samples) / window_samples_);
+    in_phase_ += alpha * (mean_i - in_phase_);
+    quadrature_ += alpha * (mean_q - quadrature_);
+}
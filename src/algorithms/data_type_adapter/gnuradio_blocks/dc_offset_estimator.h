@@ -0,0 +1,65 @@
+/*!
+ * \file dc_offset_estimator.h
+ * \brief Running estimate of the DC offset of an interleaved I/Q integer stream
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+
+#ifndef GNSS_SDR_DC_OFFSET_ESTIMATOR_H_
+#define GNSS_SDR_DC_OFFSET_ESTIMATOR_H_
+
+#include <cstdint>
+
+/*!
+ * \brief Tracks the mean of the I and Q components of an interleaved
+ * integer sample stream with an exponential window.
+ *
+ * Each update folds in the mean of one buffer with a weight that depends
+ * on the buffer length, so the time constant (in samples) does not depend
+ * on how the scheduler splits the stream. The first update takes the
+ * buffer mean as the initial estimate.
+ */
+class dc_offset_estimator
+{
+public:
+    explicit dc_offset_estimator(double window_samples);
+
+    void update(const int8_t* in, int num_samples);
+    void update(const int16_t* in, int num_samples);
+
+    double in_phase() const { return in_phase_; }
+    double quadrature() const { return quadrature_; }
+
+private:
+    void fold(int64_t sum_i, int64_t sum_q, int num_samples);
+
+    double window_samples_;
+    double in_phase_;
+    double quadrature_;
+    bool initialized_;
+};
+
+#endif
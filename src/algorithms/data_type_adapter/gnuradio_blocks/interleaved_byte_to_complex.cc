@@ -0,0 +1,71 @@
+/*!
+ * \file interleaved_byte_to_complex.cc
+ * \brief Adapts a byte (8-bits) interleaved sample stream into a gr_complex stream
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+
+
+#include "interleaved_byte_to_complex.h"
+#include <gnuradio/io_signature.h>
+#include <volk_gnsssdr/volk_gnsssdr.h>
+
+
+interleaved_byte_to_complex_sptr make_interleaved_byte_to_complex(float scale, bool remove_dc, double dc_window_samples)
+{
+    return interleaved_byte_to_complex_sptr(new interleaved_byte_to_complex(scale, remove_dc, dc_window_samples));
+}
+
+
+
+interleaved_byte_to_complex::interleaved_byte_to_complex(float scale, bool remove_dc, double dc_window_samples) : sync_decimator("interleaved_byte_to_complex",
+                        gr::io_signature::make (1, 1, sizeof(int8_t)),
+                        gr::io_signature::make (1, 1, sizeof(gr_complex)),
+                        2),
+                        d_scale(scale),
+                        d_remove_dc(remove_dc),
+                        d_dc(dc_window_samples)
+{
+    const int alignment_multiple = volk_gnsssdr_get_alignment() / sizeof(gr_complex);
+    set_alignment(std::max(1, alignment_multiple));
+}
+
+
+int interleaved_byte_to_complex::work(int noutput_items,
+        gr_vector_const_void_star &input_items,
+        gr_vector_void_star &output_items)
+{
+    const int8_t *in = (const int8_t *) input_items[0];
+    gr_complex *out = (gr_complex *) output_items[0];
+    lv_32fc_t offset = lv_cmake(0.0f, 0.0f);
+    if (d_remove_dc)
+        {
+            d_dc.update(in, noutput_items);
+            offset = lv_cmake((float)d_dc.in_phase(), (float)d_dc.quadrature());
+        }
+    volk_gnsssdr_8ic_s32fc_s32f_convert_32fc(out, (const lv_8sc_t *) in, offset, d_scale, noutput_items);
+    return noutput_items;
+}
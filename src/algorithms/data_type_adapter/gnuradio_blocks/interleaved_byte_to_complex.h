@@ -0,0 +1,63 @@
+/*!
+ * \file interleaved_byte_to_complex.h
+ * \brief Adapts a byte (8-bits) interleaved sample stream into a gr_complex stream
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+
+#ifndef GNSS_SDR_INTERLEAVED_BYTE_TO_COMPLEX_H_
+#define GNSS_SDR_INTERLEAVED_BYTE_TO_COMPLEX_H_
+
+#include <boost/shared_ptr.hpp>
+#include <gnuradio/sync_decimator.h>
+#include "dc_offset_estimator.h"
+
+class interleaved_byte_to_complex;
+
+typedef boost::shared_ptr<interleaved_byte_to_complex> interleaved_byte_to_complex_sptr;
+
+interleaved_byte_to_complex_sptr make_interleaved_byte_to_complex(float scale = 1.0, bool remove_dc = false, double dc_window_samples = 1048576.0);
+
+/*!
+ * \brief This class adapts a byte (8-bits) interleaved sample stream
+ * into a gr_complex stream. The DC offset of each component can be removed
+ * and a scale factor applied in the same pass.
+ */
+class interleaved_byte_to_complex : public gr::sync_decimator
+{
+private:
+    friend interleaved_byte_to_complex_sptr make_interleaved_byte_to_complex(float scale, bool remove_dc, double dc_window_samples);
+    interleaved_byte_to_complex(float scale, bool remove_dc, double dc_window_samples);
+    float d_scale;
+    bool d_remove_dc;
+    dc_offset_estimator d_dc;
+public:
+    int work(int noutput_items,
+            gr_vector_const_void_star &input_items,
+            gr_vector_void_star &output_items);
+};
+
+#endif
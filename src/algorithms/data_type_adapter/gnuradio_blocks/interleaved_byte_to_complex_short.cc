@@ -30,23 +30,26 @@
 
 
 #include "interleaved_byte_to_complex_short.h"
+#include <cmath>
 #include <gnuradio/io_signature.h>
-#include <volk/volk.h>
+#include <volk_gnsssdr/volk_gnsssdr.h>
 
 
-interleaved_byte_to_complex_short_sptr make_interleaved_byte_to_complex_short()
+interleaved_byte_to_complex_short_sptr make_interleaved_byte_to_complex_short(bool remove_dc, double dc_window_samples)
 {
-    return interleaved_byte_to_complex_short_sptr(new interleaved_byte_to_complex_short());
+    return interleaved_byte_to_complex_short_sptr(new interleaved_byte_to_complex_short(remove_dc, dc_window_samples));
 }
 
 
 
-interleaved_byte_to_complex_short::interleaved_byte_to_complex_short() : sync_decimator("interleaved_byte_to_complex_short",
+interleaved_byte_to_complex_short::interleaved_byte_to_complex_short(bool remove_dc, double dc_window_samples) : sync_decimator("interleaved_byte_to_complex_short",
                         gr::io_signature::make (1, 1, sizeof(int8_t)),
                         gr::io_signature::make (1, 1, sizeof(lv_16sc_t)), // lv_16sc_t is a Volk's typedef for std::complex<short int>
-                        2)
+                        2),
+                        d_remove_dc(remove_dc),
+                        d_dc(dc_window_samples)
 {
-    const int alignment_multiple = volk_get_alignment() / sizeof(lv_16sc_t);
+    const int alignment_multiple = volk_gnsssdr_get_alignment() / sizeof(lv_16sc_t);
     set_alignment(std::max(1, alignment_multiple));
 }
 
@@ -57,15 +60,12 @@ int interleaved_byte_to_complex_short::work(int noutput_items,
 {
     const int8_t *in = (const int8_t *) input_items[0];
     lv_16sc_t *out = (lv_16sc_t *) output_items[0];
-    // This could be put into a Volk kernel
-    int8_t real_part;
-    int8_t imag_part;
-    for(int number = 0; number < noutput_items; number++)
+    lv_16sc_t offset = lv_cmake((short)0, (short)0);
+    if (d_remove_dc)
         {
-            // lv_cmake(r, i) defined at volk/volk_complex.h
-            real_part = *in++;
-            imag_part = *in++;
-            *out++ = lv_cmake((int16_t)real_part, (int16_t)imag_part);
+            d_dc.update(in, noutput_items);
+            offset = lv_cmake((short)std::round(d_dc.in_phase()), (short)std::round(d_dc.quadrature()));
         }
+    volk_gnsssdr_8ic_s16ic_convert_16ic(out, (const lv_8sc_t *) in, offset, noutput_items);
     return noutput_items;
 }
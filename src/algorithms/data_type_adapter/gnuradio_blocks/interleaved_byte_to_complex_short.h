@@ -33,24 +33,27 @@
 
 #include <boost/shared_ptr.hpp>
 #include <gnuradio/sync_decimator.h>
+#include "dc_offset_estimator.h"
 
 class interleaved_byte_to_complex_short;
 
 typedef boost::shared_ptr<interleaved_byte_to_complex_short> interleaved_byte_to_complex_short_sptr;
 
-interleaved_byte_to_complex_short_sptr make_interleaved_byte_to_complex_short();
+interleaved_byte_to_complex_short_sptr make_interleaved_byte_to_complex_short(bool remove_dc = false, double dc_window_samples = 1048576.0);
 
 /*!
- * \brief This class adapts a short (16-bits) interleaved sample stream
- * into a std::complex<short> stream
+ * \brief This class adapts a byte (8-bits) interleaved sample stream
+ * into a std::complex<short> stream, optionally removing the DC offset
+ * of each component in the same pass
  */
 class interleaved_byte_to_complex_short : public gr::sync_decimator
 {
 private:
-    friend interleaved_byte_to_complex_short_sptr make_interleaved_byte_to_complex_short();
+    friend interleaved_byte_to_complex_short_sptr make_interleaved_byte_to_complex_short(bool remove_dc, double dc_window_samples);
+    interleaved_byte_to_complex_short(bool remove_dc, double dc_window_samples);
+    bool d_remove_dc;
+    dc_offset_estimator d_dc;
 public:
-    interleaved_byte_to_complex_short();
-
     int work(int noutput_items,
             gr_vector_const_void_star &input_items,
             gr_vector_void_star &output_items);
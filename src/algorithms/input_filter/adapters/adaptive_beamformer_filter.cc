@@ -0,0 +1,129 @@
+/*!
+ * \file adaptive_beamformer_filter.cc
+ * \brief Interface of an adapter of an adaptive beamformer block
+ * to a GNSSBlockInterface
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+
+#include "adaptive_beamformer_filter.h"
+#include <vector>
+#include <boost/lexical_cast.hpp>
+#include <glog/logging.h>
+#include <gnuradio/blocks/file_sink.h>
+#include "adaptive_beamformer.h"
+#include "configuration_interface.h"
+
+
+using google::LogMessage;
+
+AdaptiveBeamformerFilter::AdaptiveBeamformerFilter(
+        ConfigurationInterface* configuration, std::string role,
+        unsigned int in_stream, unsigned int out_stream) :
+        role_(role), in_stream_(in_stream), out_stream_(out_stream)
+{
+    std::string default_item_type = "gr_complex";
+    std::string default_dump_file = "./data/input_filter.dat";
+    std::string default_mode = "power_inversion";
+    item_type_ = configuration->property(role + ".item_type", default_item_type);
+    elements_ = configuration->property(role + ".elements", 8);
+    std::string mode = configuration->property(role + ".mode", default_mode);
+    unsigned int snapshot_decimation = configuration->property(role + ".snapshot_decimation", 16);
+    unsigned int snapshots = configuration->property(role + ".snapshots", 4096);
+    double diagonal_loading = configuration->property(role + ".diagonal_loading", 1e-3);
+    unsigned int reference_element = configuration->property(role + ".reference_element", 0);
+    std::vector<gr_complex> steering_vector;
+    for (unsigned int i = 0; i < elements_; i++)
+        {
+            float re = configuration->property(role + ".steering" + boost::lexical_cast<std::string>(i) + "_re", 1.0);
+            float im = configuration->property(role + ".steering" + boost::lexical_cast<std::string>(i) + "_im", 0.0);
+            steering_vector.push_back(gr_complex(re, im));
+        }
+    dump_ = configuration->property(role + ".dump", false);
+    DLOG(INFO) << "dump_ is " << dump_;
+    dump_filename_ = configuration->property(role + ".dump_filename", default_dump_file);
+
+    if (item_type_.compare("gr_complex") == 0)
+        {
+            item_size_ = sizeof(gr_complex);
+            beamformer_ = make_adaptive_beamformer(elements_, mode, snapshot_decimation,
+                    snapshots, diagonal_loading, reference_element, steering_vector);
+            DLOG(INFO) << "Item size " << item_size_;
+            DLOG(INFO) << "adaptive_beamformer(" << beamformer_->unique_id() << ") with "
+                       << elements_ << " elements, mode " << mode;
+        }
+    else
+        {
+            LOG(WARNING) << item_type_
+                         << " unrecognized item type for beamformer";
+            item_size_ = sizeof(gr_complex);
+        }
+    if (dump_)
+        {
+            DLOG(INFO) << "Dumping output into file " << dump_filename_;
+            file_sink_ = gr::blocks::file_sink::make(item_size_, dump_filename_.c_str());
+            DLOG(INFO) << "file_sink(" << file_sink_->unique_id() << ")";
+        }
+}
+
+
+AdaptiveBeamformerFilter::~AdaptiveBeamformerFilter() {}
+
+
+
+void AdaptiveBeamformerFilter::connect(gr::top_block_sptr top_block)
+{
+    if (dump_)
+        {
+            top_block->connect(beamformer_, 0, file_sink_, 0);
+            DLOG(INFO) << "connected beamformer output to file sink";
+        }
+    else
+        {
+            DLOG(INFO) << "nothing to connect internally";
+        }
+}
+
+
+void AdaptiveBeamformerFilter::disconnect(gr::top_block_sptr top_block)
+{
+    if (dump_)
+        {
+            top_block->disconnect(beamformer_, 0, file_sink_, 0);
+        }
+}
+
+
+gr::basic_block_sptr AdaptiveBeamformerFilter::get_left_block()
+{
+    return beamformer_;
+}
+
+
+gr::basic_block_sptr AdaptiveBeamformerFilter::get_right_block()
+{
+    return beamformer_;
+}
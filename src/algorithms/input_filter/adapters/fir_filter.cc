@@ -49,7 +49,14 @@ FirFilter::FirFilter(ConfigurationInterface* configuration, std::string role,
             && (output_item_type_.compare("gr_complex") == 0))
         {
             item_size = sizeof(gr_complex);
-            fir_filter_ccf_ = gr::filter::fir_filter_ccf::make(1, taps_);
+            if (use_fft_)
+                {
+                    fir_filter_ccf_ = gr::filter::fft_filter_ccf::make(1, taps_);
+                }
+            else
+                {
+                    fir_filter_ccf_ = gr::filter::fir_filter_ccf::make(1, taps_);
+                }
             DLOG(INFO) << "input_filter(" << fir_filter_ccf_->unique_id() << ")";
             if (dump_)
                 {
@@ -62,8 +69,7 @@ FirFilter::FirFilter(ConfigurationInterface* configuration, std::string role,
         {
             item_size = sizeof(lv_16sc_t);
             cshort_to_float_x2_ = make_cshort_to_float_x2();
-            fir_filter_fff_1_ = gr::filter::fir_filter_fff::make(1, taps_);
-            fir_filter_fff_2_ = gr::filter::fir_filter_fff::make(1, taps_);
+            make_fff_filters();
             DLOG(INFO) << "I input_filter(" << fir_filter_fff_1_->unique_id() << ")";
             DLOG(INFO) << "Q input_filter(" << fir_filter_fff_2_->unique_id() << ")";
             float_to_short_1_ = gr::blocks::float_to_short::make();
@@ -80,8 +86,7 @@ FirFilter::FirFilter(ConfigurationInterface* configuration, std::string role,
         {
             item_size = sizeof(gr_complex);
             cshort_to_float_x2_ = make_cshort_to_float_x2();
-            fir_filter_fff_1_ = gr::filter::fir_filter_fff::make(1, taps_);
-            fir_filter_fff_2_ = gr::filter::fir_filter_fff::make(1, taps_);
+            make_fff_filters();
             DLOG(INFO) << "I input_filter(" << fir_filter_fff_1_->unique_id() << ")";
             DLOG(INFO) << "Q input_filter(" << fir_filter_fff_2_->unique_id() << ")";
             float_to_complex_ = gr::blocks::float_to_complex::make();
@@ -98,8 +103,7 @@ FirFilter::FirFilter(ConfigurationInterface* configuration, std::string role,
             item_size = sizeof(gr_complex);
             cbyte_to_float_x2_ = make_complex_byte_to_float_x2();
 
-            fir_filter_fff_1_ = gr::filter::fir_filter_fff::make(1, taps_);
-            fir_filter_fff_2_ = gr::filter::fir_filter_fff::make(1, taps_);
+            make_fff_filters();
             DLOG(INFO) << "I input_filter(" << fir_filter_fff_1_->unique_id() << ")";
             DLOG(INFO) << "Q input_filter(" << fir_filter_fff_2_->unique_id() << ")";
 
@@ -117,8 +121,7 @@ FirFilter::FirFilter(ConfigurationInterface* configuration, std::string role,
             item_size = sizeof(lv_8sc_t);
             cbyte_to_float_x2_ = make_complex_byte_to_float_x2();
 
-            fir_filter_fff_1_ = gr::filter::fir_filter_fff::make(1, taps_);
-            fir_filter_fff_2_ = gr::filter::fir_filter_fff::make(1, taps_);
+            make_fff_filters();
             DLOG(INFO) << "I input_filter(" << fir_filter_fff_1_->unique_id() << ")";
             DLOG(INFO) << "Q input_filter(" << fir_filter_fff_2_->unique_id() << ")";
 
@@ -146,6 +149,22 @@ FirFilter::~FirFilter()
 
 
 
+void FirFilter::make_fff_filters()
+{
+    if (use_fft_)
+        {
+            fir_filter_fff_1_ = gr::filter::fft_filter_fff::make(1, taps_);
+            fir_filter_fff_2_ = gr::filter::fft_filter_fff::make(1, taps_);
+        }
+    else
+        {
+            fir_filter_fff_1_ = gr::filter::fir_filter_fff::make(1, taps_);
+            fir_filter_fff_2_ = gr::filter::fir_filter_fff::make(1, taps_);
+        }
+}
+
+
+
 void FirFilter::connect(gr::top_block_sptr top_block)
 {
     if ((taps_item_type_.compare("float") == 0) && (input_item_type_.compare("gr_complex") == 0)
@@ -375,6 +394,7 @@ void FirFilter::init()
     std::vector<double> default_error_w = { 1.0, 1.0 };
     std::string default_filter_type = "bandpass";
     int default_grid_density = 16;
+    int default_fft_crossover_taps = 64;
 
     DLOG(INFO) << "role " << role_;
 
@@ -427,4 +447,12 @@ void FirFilter::init()
         {
             taps_.push_back(float(*it));
         }
+
+    // Above the crossover, FFT fast convolution is cheaper than the direct form
+    int crossover = config_->property(role_ + ".fft_crossover_taps", default_fft_crossover_taps);
+    use_fft_ = (crossover > 0) && (taps_.size() >= static_cast<unsigned int>(crossover));
+    if (use_fft_)
+        {
+            DLOG(INFO) << role_ << " uses FFT convolution for " << taps_.size() << " taps";
+        }
 }
@@ -41,6 +41,8 @@
 #include <gnuradio/blocks/float_to_char.h>
 #include <gnuradio/blocks/float_to_complex.h>
 #include <gnuradio/blocks/float_to_short.h>
+#include <gnuradio/filter/fft_filter_ccf.h>
+#include <gnuradio/filter/fft_filter_fff.h>
 #include <gnuradio/filter/fir_filter_ccf.h>
 #include <gnuradio/filter/fir_filter_fff.h>
 #include "gnss_block_interface.h"
@@ -58,6 +60,9 @@ class ConfigurationInterface;
  * Calculates the optimal (in the Chebyshev/minimax sense) FIR filter impulse response
  * given a set of band edges, the desired response on those bands, and the weight given
  * to the error in those bands.
+ *
+ * Filters with fft_crossover_taps taps or more (default 64, 0 disables it)
+ * use GNU Radio's FFT fast convolution filters instead of the direct form.
  */
 class FirFilter: public GNSSBlockInterface
 {
@@ -90,7 +95,7 @@ public:
     gr::basic_block_sptr get_right_block();
 
 private:
-    gr::filter::fir_filter_ccf::sptr fir_filter_ccf_;
+    gr::block_sptr fir_filter_ccf_;   // direct-form or FFT filter
     ConfigurationInterface* config_;
     bool dump_;
     std::string dump_filename_;
@@ -102,10 +107,12 @@ private:
     unsigned int in_streams_;
     unsigned int out_streams_;
     gr::blocks::file_sink::sptr file_sink_;
+    bool use_fft_;
     void init();
+    void make_fff_filters();
     complex_byte_to_float_x2_sptr cbyte_to_float_x2_;
-    gr::filter::fir_filter_fff::sptr fir_filter_fff_1_;
-    gr::filter::fir_filter_fff::sptr fir_filter_fff_2_;
+    gr::block_sptr fir_filter_fff_1_;
+    gr::block_sptr fir_filter_fff_2_;
     gr::blocks::float_to_char::sptr float_to_char_1_;
     gr::blocks::float_to_char::sptr float_to_char_2_;
     byte_x2_to_complex_byte_sptr char_x2_cbyte_;
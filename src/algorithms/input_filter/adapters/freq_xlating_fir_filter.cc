@@ -54,7 +54,14 @@ FreqXlatingFirFilter::FreqXlatingFirFilter(ConfigurationInterface* configuration
         {
             item_size = sizeof(gr_complex); //output
             input_size_ = sizeof(gr_complex); //input
-            freq_xlating_fir_filter_ccf_ = gr::filter::freq_xlating_fir_filter_ccf::make(decimation_factor, taps_, intermediate_freq_, sampling_freq_);
+            if (use_fft_)
+                {
+                    freq_xlating_fir_filter_ccf_ = make_fft_freq_xlating_fir_filter_ccf(decimation_factor, taps_, intermediate_freq_, sampling_freq_);
+                }
+            else
+                {
+                    freq_xlating_fir_filter_ccf_ = gr::filter::freq_xlating_fir_filter_ccf::make(decimation_factor, taps_, intermediate_freq_, sampling_freq_);
+                }
             DLOG(INFO) << "input_filter(" << freq_xlating_fir_filter_ccf_->unique_id() << ")";
         }
     else if((taps_item_type_.compare("float") == 0) && (input_item_type_.compare("float") == 0)
@@ -352,6 +359,7 @@ void FreqXlatingFirFilter::init()
     std::vector<double> default_error_w = { 1.0, 1.0 };
     std::string default_filter_type = "bandpass";
     int default_grid_density = 16;
+    int default_fft_crossover_taps = 64;
 
     DLOG(INFO) << "role " << role_;
 
@@ -406,4 +414,13 @@ void FreqXlatingFirFilter::init()
             taps_.push_back(float(*it));
             //std::cout<<"TAP="<<float(*it)<<std::endl;
         }
+
+    // Above the crossover, FFT fast convolution is cheaper than the direct form.
+    // Only the gr_complex input path has an FFT version.
+    int crossover = config_->property(role_ + ".fft_crossover_taps", default_fft_crossover_taps);
+    use_fft_ = (crossover > 0) && (taps_.size() >= static_cast<unsigned int>(crossover));
+    if (use_fft_)
+        {
+            DLOG(INFO) << role_ << " uses FFT convolution for " << taps_.size() << " taps";
+        }
 }
@@ -45,6 +45,7 @@
 #include "gnss_block_interface.h"
 #include "short_x2_to_cshort.h"
 #include "complex_float_to_complex_byte.h"
+#include "fft_freq_xlating_fir_filter_ccf.h"
 
 class ConfigurationInterface;
 
@@ -59,6 +60,10 @@ class ConfigurationInterface;
  * Calculates the optimal (in the Chebyshev/minimax sense) FIR filter impulse response
  * given a set of band edges, the desired response on those bands, and the weight given
  * to the error in those bands.
+ *
+ * With gr_complex input, filters with fft_crossover_taps taps or more
+ * (default 64, 0 disables it) run the translation and the filter in a
+ * single FFT fast convolution block.
  */
 class FreqXlatingFirFilter: public GNSSBlockInterface
 {
@@ -88,7 +93,7 @@ public:
     gr::basic_block_sptr get_right_block();
 
 private:
-    gr::filter::freq_xlating_fir_filter_ccf::sptr freq_xlating_fir_filter_ccf_;
+    gr::block_sptr freq_xlating_fir_filter_ccf_;   // direct-form or FFT filter
     gr::filter::freq_xlating_fir_filter_fcf::sptr freq_xlating_fir_filter_fcf_;
     gr::filter::freq_xlating_fir_filter_scf::sptr freq_xlating_fir_filter_scf_;
     ConfigurationInterface* config_;
@@ -111,6 +116,7 @@ private:
     gr::blocks::float_to_short::sptr float_to_short_2_;
     short_x2_to_cshort_sptr short_x2_to_cshort_;
     complex_float_to_complex_byte_sptr complex_to_complex_byte_;
+    bool use_fft_;
     void init();
 };
 
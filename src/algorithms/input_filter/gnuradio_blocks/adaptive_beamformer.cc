@@ -0,0 +1,363 @@
+/*!
+ * \file adaptive_beamformer.cc
+ * \brief Adaptive spatial filter (MVDR / power inversion) for antenna array input
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+
+#include "adaptive_beamformer.h"
+#include <algorithm>
+#include <cmath>
+#include <gnuradio/io_signature.h>
+#include <volk/volk.h>
+#include <glog/logging.h>
+
+// samples per volk call when applying the weights; keeps the accumulator in cache
+#define GNSS_SDR_ADAPTIVE_BEAMFORMER_CHUNK 4096
+
+
+adaptive_beamformer_sptr make_adaptive_beamformer(unsigned int elements,
+        const std::string& mode, unsigned int snapshot_decimation, unsigned int snapshots,
+        double diagonal_loading, unsigned int reference_element,
+        const std::vector<gr_complex>& steering_vector)
+{
+    return adaptive_beamformer_sptr(new adaptive_beamformer(elements, mode,
+            snapshot_decimation, snapshots, diagonal_loading, reference_element, steering_vector));
+}
+
+
+
+adaptive_beamformer::adaptive_beamformer(unsigned int elements, const std::string& mode,
+        unsigned int snapshot_decimation, unsigned int snapshots,
+        double diagonal_loading, unsigned int reference_element,
+        const std::vector<gr_complex>& steering_vector)
+: gr::sync_block("adaptive_beamformer",
+        gr::io_signature::make(elements, elements, sizeof(gr_complex)),
+        gr::io_signature::make(1, 1, sizeof(gr_complex)))
+{
+    d_elements = elements;
+    d_snapshot_decimation = std::max(snapshot_decimation, 1u);
+    d_snapshots = std::max(snapshots, elements);
+    d_diagonal_loading = diagonal_loading;
+    if (reference_element >= elements)
+        {
+            LOG(WARNING) << "Beamformer reference element " << reference_element
+                         << " out of range, using element 0";
+            reference_element = 0;
+        }
+
+    d_constraint.assign(d_elements, std::complex<double>(0.0, 0.0));
+    if (mode.compare("mvdr") == 0)
+        {
+            for (unsigned int i = 0; i < d_elements; i++)
+                {
+                    d_constraint[i] = (i < steering_vector.size()) ? std::complex<double>(steering_vector[i]) : std::complex<double>(1.0, 0.0);
+                }
+        }
+    else
+        {
+            if (mode.compare("power_inversion") != 0)
+                {
+                    LOG(WARNING) << "Unknown beamformer mode " << mode << ", using power_inversion";
+                }
+            d_constraint[reference_element] = std::complex<double>(1.0, 0.0);
+        }
+
+    // Until the first covariance estimate is ready the output is the
+    // constraint direction: the reference element, or the steered sum
+    d_weights_conj.resize(d_elements);
+    double norm = 0.0;
+    for (unsigned int i = 0; i < d_elements; i++)
+        {
+            norm += std::norm(d_constraint[i]);
+        }
+    for (unsigned int i = 0; i < d_elements; i++)
+        {
+            d_weights_conj[i] = gr_complex(std::conj(d_constraint[i]) / norm);
+        }
+    d_tmp.resize(GNSS_SDR_ADAPTIVE_BEAMFORMER_CHUNK);
+
+    d_covariance.assign(d_elements * d_elements, std::complex<double>(0.0, 0.0));
+    d_snapshot_count = 0;
+    d_next_snapshot = 0;
+
+    d_covariance_ready = false;
+    d_weights_ready = false;
+    d_updates = 0;
+    d_stop = true;
+}
+
+
+
+adaptive_beamformer::~adaptive_beamformer()
+{
+    stop();
+}
+
+
+
+bool adaptive_beamformer::start()
+{
+    if (!d_thread.joinable())
+        {
+            {
+                boost::lock_guard<boost::mutex> lock(d_mutex);
+                d_stop = false;
+            }
+            d_thread = boost::thread(&adaptive_beamformer::run, this);
+        }
+    return true;
+}
+
+
+
+bool adaptive_beamformer::stop()
+{
+    if (d_thread.joinable())
+        {
+            {
+                boost::lock_guard<boost::mutex> lock(d_mutex);
+                d_stop = true;
+            }
+            d_cond.notify_one();
+            d_thread.join();
+        }
+    return true;
+}
+
+
+
+std::vector<gr_complex> adaptive_beamformer::weights() const
+{
+    std::vector<gr_complex> w(d_elements);
+    for (unsigned int i = 0; i < d_elements; i++)
+        {
+            w[i] = std::conj(d_weights_conj[i]);
+        }
+    return w;
+}
+
+
+
+unsigned long int adaptive_beamformer::updates()
+{
+    boost::lock_guard<boost::mutex> lock(d_mutex);
+    return d_updates;
+}
+
+
+
+void adaptive_beamformer::accumulate_snapshots(gr_vector_const_void_star &input_items, int noutput_items)
+{
+    const unsigned int n_elements = d_elements;
+    while (d_next_snapshot < static_cast<unsigned int>(noutput_items))
+        {
+            const unsigned int n = d_next_snapshot;
+            for (unsigned int i = 0; i < n_elements; i++)
+                {
+                    const std::complex<double> xi(((const gr_complex*)input_items[i])[n]);
+                    std::complex<double>* row = &d_covariance[i * n_elements];
+                    for (unsigned int j = i; j < n_elements; j++)
+                        {
+                            row[j] += xi * std::conj(std::complex<double>(((const gr_complex*)input_items[j])[n]));
+                        }
+                }
+            d_next_snapshot += d_snapshot_decimation;
+
+            if (++d_snapshot_count == d_snapshots)
+                {
+                    const double scale = 1.0 / static_cast<double>(d_snapshot_count);
+                    for (unsigned int k = 0; k < d_covariance.size(); k++)
+                        {
+                            d_covariance[k] *= scale;
+                        }
+                    {
+                        // if the solver is still busy with the previous estimate, this one replaces it
+                        boost::lock_guard<boost::mutex> lock(d_mutex);
+                        d_pending_covariance.swap(d_covariance);
+                        d_covariance_ready = true;
+                    }
+                    d_cond.notify_one();
+                    d_covariance.assign(n_elements * n_elements, std::complex<double>(0.0, 0.0));
+                    d_snapshot_count = 0;
+                }
+        }
+    d_next_snapshot -= noutput_items;
+}
+
+
+
+void adaptive_beamformer::run()
+{
+    std::vector<std::complex<double> > covariance;
+    std::vector<std::complex<double> > w;
+    while (true)
+        {
+            {
+                boost::unique_lock<boost::mutex> lock(d_mutex);
+                while (!d_stop && !d_covariance_ready)
+                    {
+                        d_cond.wait(lock);
+                    }
+                if (d_stop)
+                    {
+                        break;
+                    }
+                covariance.swap(d_pending_covariance);
+                d_covariance_ready = false;
+            }
+
+            double trace = 0.0;
+            for (unsigned int i = 0; i < d_elements; i++)
+                {
+                    trace += covariance[i * d_elements + i].real();
+                }
+            const double loading = d_diagonal_loading * trace / static_cast<double>(d_elements);
+            if (!adaptive_beamformer_weights(covariance, d_constraint, loading, w))
+                {
+                    DLOG(INFO) << "Beamformer covariance estimate is not positive definite, keeping the previous weights";
+                    continue;
+                }
+
+            boost::lock_guard<boost::mutex> lock(d_mutex);
+            d_new_weights.resize(d_elements);
+            for (unsigned int i = 0; i < d_elements; i++)
+                {
+                    d_new_weights[i] = gr_complex(std::conj(w[i]));
+                }
+            d_weights_ready = true;
+            d_updates++;
+        }
+}
+
+
+
+int adaptive_beamformer::work(int noutput_items, gr_vector_const_void_star &input_items,
+        gr_vector_void_star &output_items)
+{
+    {
+        boost::lock_guard<boost::mutex> lock(d_mutex);
+        if (d_weights_ready)
+            {
+                d_weights_conj.swap(d_new_weights);
+                d_weights_ready = false;
+            }
+    }
+
+    accumulate_snapshots(input_items, noutput_items);
+
+    // y = w^H x, one element at a time over chunks of the output buffer
+    gr_complex *out = (gr_complex *) output_items[0];
+    gr_complex *tmp = &d_tmp[0];
+    for (int offset = 0; offset < noutput_items; offset += GNSS_SDR_ADAPTIVE_BEAMFORMER_CHUNK)
+        {
+            const unsigned int len = std::min(noutput_items - offset, GNSS_SDR_ADAPTIVE_BEAMFORMER_CHUNK);
+            volk_32fc_s32fc_multiply_32fc(out + offset, (const gr_complex*)input_items[0] + offset, d_weights_conj[0], len);
+            for (unsigned int i = 1; i < d_elements; i++)
+                {
+                    volk_32fc_s32fc_multiply_32fc(tmp, (const gr_complex*)input_items[i] + offset, d_weights_conj[i], len);
+                    volk_32f_x2_add_32f((float*)(out + offset), (const float*)(out + offset), (const float*)tmp, 2 * len);
+                }
+        }
+
+    return noutput_items;
+}
+
+
+
+bool adaptive_beamformer_weights(const std::vector<std::complex<double> >& covariance,
+        const std::vector<std::complex<double> >& constraint, double loading,
+        std::vector<std::complex<double> >& weights)
+{
+    const unsigned int n = constraint.size();
+
+    // Cholesky factorization R + loading I = L L^H, L lower triangular, row major
+    std::vector<std::complex<double> > L(n * n, std::complex<double>(0.0, 0.0));
+    for (unsigned int j = 0; j < n; j++)
+        {
+            double diag = covariance[j * n + j].real() + loading;
+            for (unsigned int k = 0; k < j; k++)
+                {
+                    diag -= std::norm(L[j * n + k]);
+                }
+            if (!(diag > 0.0))
+                {
+                    return false;
+                }
+            const double ljj = std::sqrt(diag);
+            L[j * n + j] = ljj;
+            for (unsigned int i = j + 1; i < n; i++)
+                {
+                    // R(i,j) for i > j comes from the stored upper triangle
+                    std::complex<double> acc = std::conj(covariance[j * n + i]);
+                    for (unsigned int k = 0; k < j; k++)
+                        {
+                            acc -= L[i * n + k] * std::conj(L[j * n + k]);
+                        }
+                    L[i * n + j] = acc / ljj;
+                }
+        }
+
+    // forward substitution L z = a
+    std::vector<std::complex<double> > z(n);
+    for (unsigned int i = 0; i < n; i++)
+        {
+            std::complex<double> acc = constraint[i];
+            for (unsigned int k = 0; k < i; k++)
+                {
+                    acc -= L[i * n + k] * z[k];
+                }
+            z[i] = acc / L[i * n + i].real();
+        }
+
+    // back substitution L^H v = z
+    weights.resize(n);
+    for (int i = n - 1; i >= 0; i--)
+        {
+            std::complex<double> acc = z[i];
+            for (unsigned int k = i + 1; k < n; k++)
+                {
+                    acc -= std::conj(L[k * n + i]) * weights[k];
+                }
+            weights[i] = acc / L[i * n + i].real();
+        }
+
+    // distortionless normalization w = v / (a^H v)
+    std::complex<double> gain(0.0, 0.0);
+    for (unsigned int i = 0; i < n; i++)
+        {
+            gain += std::conj(constraint[i]) * weights[i];
+        }
+    if (!(std::abs(gain) > 0.0))
+        {
+            return false;
+        }
+    for (unsigned int i = 0; i < n; i++)
+        {
+            weights[i] /= gain;
+        }
+    return true;
+}
@@ -0,0 +1,137 @@
+/*!
+ * \file adaptive_beamformer.h
+ * \brief Adaptive spatial filter (MVDR / power inversion) for antenna array input
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+
+#ifndef GNSS_SDR_ADAPTIVE_BEAMFORMER_H
+#define GNSS_SDR_ADAPTIVE_BEAMFORMER_H
+
+#include <complex>
+#include <string>
+#include <vector>
+#include <boost/thread.hpp>
+#include <gnuradio/sync_block.h>
+
+class adaptive_beamformer;
+typedef boost::shared_ptr<adaptive_beamformer> adaptive_beamformer_sptr;
+
+/*!
+ * \brief Makes an adaptive beamformer
+ *
+ * \param elements            number of antenna elements (input streams)
+ * \param mode                "power_inversion" or "mvdr"
+ * \param snapshot_decimation one covariance snapshot every snapshot_decimation samples
+ * \param snapshots           snapshots per covariance estimate (one weight update each)
+ * \param diagonal_loading    loading added to the covariance diagonal, relative to its mean power
+ * \param reference_element   element kept with unit gain in power inversion mode
+ * \param steering_vector     look direction in mvdr mode, one entry per element
+ */
+adaptive_beamformer_sptr make_adaptive_beamformer(unsigned int elements,
+        const std::string& mode, unsigned int snapshot_decimation, unsigned int snapshots,
+        double diagonal_loading, unsigned int reference_element,
+        const std::vector<gr_complex>& steering_vector);
+
+/*!
+ * \brief This class implements an adaptive spatial filter for any number of
+ * antenna elements
+ *
+ * The output is y = w^H x. The spatial covariance R is estimated from one
+ * snapshot every snapshot_decimation samples, and each estimate is handed to
+ * a background thread that computes w = R^-1 a / (a^H R^-1 a). In mvdr mode
+ * a is the steering vector of the look direction. In power inversion mode a
+ * selects the reference element, so every other element is used to cancel
+ * the strongest sources, such as a jammer or a single-direction spoofer,
+ * while GNSS signals below the noise floor go through. The signal path never
+ * waits for the solver: new weights are picked up at the start of the next
+ * work() call. They are applied with volk multiply and add kernels, one
+ * element at a time over cache-sized chunks.
+ */
+class adaptive_beamformer: public gr::sync_block
+{
+private:
+    friend adaptive_beamformer_sptr make_adaptive_beamformer(unsigned int elements,
+            const std::string& mode, unsigned int snapshot_decimation, unsigned int snapshots,
+            double diagonal_loading, unsigned int reference_element,
+            const std::vector<gr_complex>& steering_vector);
+
+    adaptive_beamformer(unsigned int elements, const std::string& mode,
+            unsigned int snapshot_decimation, unsigned int snapshots,
+            double diagonal_loading, unsigned int reference_element,
+            const std::vector<gr_complex>& steering_vector);
+
+    void accumulate_snapshots(gr_vector_const_void_star &input_items, int noutput_items);
+    void run();
+
+    unsigned int d_elements;
+    unsigned int d_snapshot_decimation;
+    unsigned int d_snapshots;
+    double d_diagonal_loading;
+    std::vector<std::complex<double> > d_constraint;    // a
+    std::vector<gr_complex> d_weights_conj;             // conj(w), used by work()
+    std::vector<gr_complex> d_tmp;
+
+    // covariance estimate, upper triangle, row major; only used by work()
+    std::vector<std::complex<double> > d_covariance;
+    unsigned int d_snapshot_count;
+    unsigned int d_next_snapshot;                       // samples until the next snapshot
+
+    boost::mutex d_mutex;
+    boost::condition_variable d_cond;
+    std::vector<std::complex<double> > d_pending_covariance;  // guarded by d_mutex
+    bool d_covariance_ready;                                  // guarded by d_mutex
+    std::vector<gr_complex> d_new_weights;                    // guarded by d_mutex
+    bool d_weights_ready;                                     // guarded by d_mutex
+    unsigned long int d_updates;                              // guarded by d_mutex
+    bool d_stop;                                              // guarded by d_mutex
+    boost::thread d_thread;
+
+public:
+    ~adaptive_beamformer();
+
+    bool start();
+    bool stop();
+
+    //! Current weights w (not conjugated)
+    std::vector<gr_complex> weights() const;
+    //! Number of weight updates computed so far
+    unsigned long int updates();
+
+    int work(int noutput_items, gr_vector_const_void_star &input_items,
+            gr_vector_void_star &output_items);
+};
+
+/*!
+ * \brief Solves w = R^-1 a / (a^H R^-1 a) for the n x n Hermitian covariance R
+ * given as its upper triangle, row major. Returns false if R + loading I is
+ * not positive definite.
+ */
+bool adaptive_beamformer_weights(const std::vector<std::complex<double> >& covariance,
+        const std::vector<std::complex<double> >& constraint, double loading,
+        std::vector<std::complex<double> >& weights);
+
+#endif
@@ -0,0 +1,92 @@
+/*!
+ * \file fft_freq_xlating_fir_filter_ccf.cc
+ * \brief FFT fast convolution FIR filter with a composite frequency translation
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+
+#include "fft_freq_xlating_fir_filter_ccf.h"
+#include <cmath>
+#include <gnuradio/io_signature.h>
+#include <gnuradio/math.h>
+
+
+fft_freq_xlating_fir_filter_ccf_sptr make_fft_freq_xlating_fir_filter_ccf(unsigned int decimation,
+        const std::vector<float>& taps, double center_freq, double sampling_freq, int nthreads)
+{
+    return fft_freq_xlating_fir_filter_ccf_sptr(new fft_freq_xlating_fir_filter_ccf(decimation,
+            taps, center_freq, sampling_freq, nthreads));
+}
+
+
+
+fft_freq_xlating_fir_filter_ccf::fft_freq_xlating_fir_filter_ccf(unsigned int decimation,
+        const std::vector<float>& taps, double center_freq, double sampling_freq, int nthreads) :
+            gr::sync_decimator("fft_freq_xlating_fir_filter_ccf",
+                    gr::io_signature::make(1, 1, sizeof(gr_complex)),
+                    gr::io_signature::make(1, 1, sizeof(gr_complex)),
+                    decimation)
+{
+    // Composite bandpass taps, as built by gr::filter::freq_xlating_fir_filter_ccf
+    const double fwT0 = 2.0 * GR_M_PI * center_freq / sampling_freq;
+    std::vector<gr_complex> ctaps(taps.size());
+    for (unsigned int i = 0; i < taps.size(); i++)
+        {
+            ctaps[i] = taps[i] * std::exp(gr_complex(0.0, static_cast<float>(i * fwT0)));
+        }
+    d_filter = new gr::filter::kernel::fft_filter_ccc(decimation, ctaps, nthreads);
+    set_output_multiple(d_filter->set_taps(ctaps));
+
+    // The decimated output is rotated back by the carrier advance of each output sample
+    d_rotate = (center_freq != 0.0);
+    const double phase_step = -fwT0 * decimation;
+    d_phase_inc = lv_cmake(static_cast<float>(std::cos(phase_step)), static_cast<float>(std::sin(phase_step)));
+    d_phase = lv_cmake(1.0f, 0.0f);
+}
+
+
+
+fft_freq_xlating_fir_filter_ccf::~fft_freq_xlating_fir_filter_ccf()
+{
+    delete d_filter;
+}
+
+
+
+int fft_freq_xlating_fir_filter_ccf::work(int noutput_items,
+        gr_vector_const_void_star &input_items,
+        gr_vector_void_star &output_items)
+{
+    const gr_complex *in = static_cast<const gr_complex *>(input_items[0]);
+    gr_complex *out = static_cast<gr_complex *>(output_items[0]);
+
+    d_filter->filter(noutput_items, in, out);
+    if (d_rotate)
+        {
+            volk_32fc_s32fc_x2_rotator_32fc(out, out, d_phase_inc, &d_phase, noutput_items);
+        }
+    return noutput_items;
+}
@@ -0,0 +1,77 @@
+/*!
+ * \file fft_freq_xlating_fir_filter_ccf.h
+ * \brief FFT fast convolution FIR filter with a composite frequency translation
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+
+#ifndef GNSS_SDR_FFT_FREQ_XLATING_FIR_FILTER_CCF_H_
+#define GNSS_SDR_FFT_FREQ_XLATING_FIR_FILTER_CCF_H_
+
+#include <vector>
+#include <gnuradio/sync_decimator.h>
+#include <gnuradio/filter/fft_filter.h>
+#include <volk/volk.h>
+
+class fft_freq_xlating_fir_filter_ccf;
+
+typedef boost::shared_ptr<fft_freq_xlating_fir_filter_ccf> fft_freq_xlating_fir_filter_ccf_sptr;
+
+fft_freq_xlating_fir_filter_ccf_sptr make_fft_freq_xlating_fir_filter_ccf(unsigned int decimation,
+        const std::vector<float>& taps, double center_freq, double sampling_freq, int nthreads = 1);
+
+/*!
+ * \brief This class implements the frequency translating FIR filter of
+ * gr::filter::freq_xlating_fir_filter_ccf with FFT fast convolution
+ *
+ * As in GNU Radio, the real taps are turned into a bandpass filter centered
+ * at center_freq, the input is filtered and decimated with the FFT filter
+ * kernel, and the decimated output is rotated down to zero Hz. The cost per
+ * sample grows with the logarithm of the number of taps instead of linearly,
+ * so this block is preferred for long filters.
+ */
+class fft_freq_xlating_fir_filter_ccf : public gr::sync_decimator
+{
+private:
+    friend fft_freq_xlating_fir_filter_ccf_sptr make_fft_freq_xlating_fir_filter_ccf(unsigned int decimation,
+            const std::vector<float>& taps, double center_freq, double sampling_freq, int nthreads);
+
+    fft_freq_xlating_fir_filter_ccf(unsigned int decimation, const std::vector<float>& taps,
+            double center_freq, double sampling_freq, int nthreads);
+
+    gr::filter::kernel::fft_filter_ccc* d_filter;
+    bool d_rotate;
+    lv_32fc_t d_phase_inc;
+    lv_32fc_t d_phase;
+
+public:
+    ~fft_freq_xlating_fir_filter_ccf();
+
+    int work(int noutput_items, gr_vector_const_void_star &input_items,
+            gr_vector_void_star &output_items);
+};
+
+#endif
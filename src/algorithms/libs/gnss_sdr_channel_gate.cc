@@ -0,0 +1,123 @@
+/*!
+ * \file gnss_sdr_channel_gate.cc
+ * \brief Implementation of a GNU Radio block that feeds a receiver channel
+ * and can park it.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gnss_sdr_channel_gate.h"
+#include <algorithm>
+#include <cstring>
+#include <gnuradio/io_signature.h>
+
+
+gnss_sdr_channel_gate_sptr gnss_sdr_make_channel_gate(size_t sizeof_stream_item, unsigned int channel)
+{
+    return gnss_sdr_channel_gate_sptr(new gnss_sdr_channel_gate(sizeof_stream_item, channel));
+}
+
+
+gnss_sdr_channel_gate::gnss_sdr_channel_gate(size_t sizeof_stream_item, unsigned int channel) :
+        gr::block("channel_gate",
+                gr::io_signature::make(1, 1, sizeof_stream_item),
+                gr::io_signature::make(1, 1, sizeof_stream_item))
+{
+    d_item_size = sizeof_stream_item;
+    d_channel = channel;
+    d_parked = false;
+    d_skipped = 0;
+    d_output_parked = false;
+}
+
+
+gnss_sdr_channel_gate::~gnss_sdr_channel_gate()
+{}
+
+
+void gnss_sdr_channel_gate::park()
+{
+    {
+        boost::mutex::scoped_lock lock(d_mutex);
+        if (d_parked) return;
+        d_parked = true;
+        d_skipped = 0;
+    }
+    d_output_parked = true;
+}
+
+
+void gnss_sdr_channel_gate::resume(const std::function<void(unsigned long long)>& account)
+{
+    // waiting for the channel's outputs again before the samples flow
+    d_output_parked = false;
+    boost::mutex::scoped_lock lock(d_mutex);
+    if (!d_parked) return;
+    if (account) account(d_skipped);
+    d_parked = false;
+}
+
+
+bool gnss_sdr_channel_gate::parked() const
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    return d_parked;
+}
+
+
+unsigned long long gnss_sdr_channel_gate::skipped() const
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    return d_skipped;
+}
+
+
+bool gnss_sdr_channel_gate::output_parked() const
+{
+    return d_output_parked;
+}
+
+
+void gnss_sdr_channel_gate::forecast(int noutput_items, gr_vector_int &ninput_items_required)
+{
+    ninput_items_required[0] = noutput_items;
+}
+
+
+int gnss_sdr_channel_gate::general_work(int noutput_items, gr_vector_int &ninput_items,
+        gr_vector_const_void_star &input_items, gr_vector_void_star &output_items)
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    if (d_parked)
+        {
+            d_skipped += ninput_items[0];
+            consume_each(ninput_items[0]);
+            return 0;
+        }
+    int n = std::min(noutput_items, ninput_items[0]);
+    std::memcpy(output_items[0], input_items[0], n * d_item_size);
+    consume_each(n);
+    return n;
+}
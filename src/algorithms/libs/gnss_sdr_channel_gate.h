@@ -0,0 +1,93 @@
+/*!
+ * \file gnss_sdr_channel_gate.h
+ * \brief Interface of a GNU Radio block that feeds a receiver channel and
+ * can park it: while parked the input samples are dropped without being
+ * copied, so nothing downstream in the channel is scheduled.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_GNSS_SDR_CHANNEL_GATE_H_
+#define GNSS_SDR_GNSS_SDR_CHANNEL_GATE_H_
+
+#include <atomic>
+#include <functional>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <gnuradio/block.h>
+
+class gnss_sdr_channel_gate;
+
+typedef boost::shared_ptr<gnss_sdr_channel_gate> gnss_sdr_channel_gate_sptr;
+
+gnss_sdr_channel_gate_sptr gnss_sdr_make_channel_gate(size_t sizeof_stream_item, unsigned int channel);
+
+/*!
+ * \brief Implementation of a GNU Radio block that passes samples to a channel
+ * or, while the channel is parked, consumes and counts them.
+ *
+ * The observables block of the same flowgraph holds the gates of its channels
+ * so that it can stop waiting for the outputs of parked channels.
+ */
+class gnss_sdr_channel_gate : public gr::block
+{
+public:
+    ~gnss_sdr_channel_gate();
+
+    //! Stops feeding the channel
+    void park();
+
+    /*!
+     * \brief Feeds the channel again. The number of samples dropped while
+     * parked is passed to account() before the first new sample goes out.
+     */
+    void resume(const std::function<void(unsigned long long)>& account);
+
+    bool parked() const;
+    unsigned long long skipped() const; //!< Samples dropped since the last park()
+
+    /*!
+     * \brief True while the channel's outputs are not to be waited for. Does
+     * not lock, so that it can be polled from the downstream block's forecast().
+     */
+    bool output_parked() const;
+
+    void forecast(int noutput_items, gr_vector_int &ninput_items_required);
+    int general_work(int noutput_items, gr_vector_int &ninput_items,
+            gr_vector_const_void_star &input_items, gr_vector_void_star &output_items);
+
+private:
+    friend gnss_sdr_channel_gate_sptr gnss_sdr_make_channel_gate(size_t sizeof_stream_item, unsigned int channel);
+    gnss_sdr_channel_gate(size_t sizeof_stream_item, unsigned int channel);
+
+    size_t d_item_size;
+    unsigned int d_channel;
+    bool d_parked;
+    unsigned long long d_skipped;
+    mutable boost::mutex d_mutex;
+    std::atomic<bool> d_output_parked;  // set after d_parked on park(), cleared before it on resume()
+};
+
+#endif /*GNSS_SDR_GNSS_SDR_CHANNEL_GATE_H_*/
@@ -0,0 +1,408 @@
+/*!
+ * \file gnss_sdr_perf.cc
+ * \brief Per-block performance counters of the receiver blocks: duration of
+ * the work calls, items processed, input backlog and real-time load.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gnss_sdr_perf.h"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <gnuradio/block_detail.h>
+#include <glog/logging.h>
+
+using google::LogMessage;
+
+
+// ######## BLOCK COUNTERS #########
+
+Gnss_Sdr_Block_Perf::Gnss_Sdr_Block_Perf(const std::string& name, double items_per_second, int channel)
+{
+    d_name = name;
+    d_rate = items_per_second > 0.0 ? items_per_second : 0.0;
+    d_channel = channel;
+    clear();
+}
+
+
+void Gnss_Sdr_Block_Perf::clear()
+{
+    d_consumed = 0;
+    d_produced = 0;
+    d_backlog = 0;
+    d_work_ns.clear();
+    d_backlog_items.clear();
+}
+
+
+void Gnss_Sdr_Block_Perf::add_work(unsigned long long work_ns, unsigned long long consumed, unsigned long long backlog)
+{
+    d_work_ns.add(work_ns);
+    d_backlog_items.add(backlog);
+    d_consumed.fetch_add(consumed, std::memory_order_relaxed);
+    d_backlog.store(backlog, std::memory_order_relaxed);
+}
+
+
+void Gnss_Sdr_Block_Perf::set_produced(unsigned long long produced)
+{
+    d_produced.store(produced, std::memory_order_relaxed);
+}
+
+
+void Gnss_Sdr_Block_Perf::set_channel(int channel)
+{
+    d_channel.store(channel, std::memory_order_relaxed);
+}
+
+
+const std::string& Gnss_Sdr_Block_Perf::get_name() const
+{
+    return d_name;
+}
+
+
+int Gnss_Sdr_Block_Perf::get_channel() const
+{
+    return d_channel.load(std::memory_order_relaxed);
+}
+
+
+double Gnss_Sdr_Block_Perf::get_rate() const
+{
+    return d_rate;
+}
+
+
+std::string Gnss_Sdr_Block_Perf::label() const
+{
+    std::stringstream s;
+    s << d_name;
+    if (get_channel() >= 0)
+        {
+            s << "[" << get_channel() << "]";
+        }
+    return s.str();
+}
+
+
+unsigned long long Gnss_Sdr_Block_Perf::get_calls() const
+{
+    return d_work_ns.count();
+}
+
+
+unsigned long long Gnss_Sdr_Block_Perf::get_consumed() const
+{
+    return d_consumed.load(std::memory_order_relaxed);
+}
+
+
+unsigned long long Gnss_Sdr_Block_Perf::get_produced() const
+{
+    return d_produced.load(std::memory_order_relaxed);
+}
+
+
+unsigned long long Gnss_Sdr_Block_Perf::get_busy_ns() const
+{
+    return d_work_ns.sum();
+}
+
+
+unsigned long long Gnss_Sdr_Block_Perf::get_backlog() const
+{
+    return d_backlog.load(std::memory_order_relaxed);
+}
+
+
+const Spoofing_Histogram& Gnss_Sdr_Block_Perf::get_work_ns() const
+{
+    return d_work_ns;
+}
+
+
+const Spoofing_Histogram& Gnss_Sdr_Block_Perf::get_backlog_items() const
+{
+    return d_backlog_items;
+}
+
+
+double Gnss_Sdr_Block_Perf::stream_s() const
+{
+    if (d_rate <= 0.0) return 0.0;
+    return static_cast<double>(get_consumed()) / d_rate;
+}
+
+
+double Gnss_Sdr_Block_Perf::rt_load() const
+{
+    double stream = stream_s();
+    if (stream <= 0.0) return 0.0;
+    return static_cast<double>(get_busy_ns()) * 1e-9 / stream;
+}
+
+
+double Gnss_Sdr_Block_Perf::backlog_s() const
+{
+    if (d_rate <= 0.0) return 0.0;
+    return static_cast<double>(get_backlog()) / d_rate;
+}
+
+
+// ######## REGISTRY #########
+
+Gnss_Sdr_Perf& Gnss_Sdr_Perf::instance()
+{
+    static Gnss_Sdr_Perf perf;
+    return perf;
+}
+
+
+Gnss_Sdr_Perf::Gnss_Sdr_Perf()
+{
+    d_enabled = false;
+    d_period_ms = 1000;
+    d_max_backlog_ms = 0.0;
+    d_start = std::chrono::steady_clock::now();
+    d_last = d_start;
+}
+
+
+std::shared_ptr<Gnss_Sdr_Block_Perf> Gnss_Sdr_Perf::add(const std::string& name, double items_per_second, int channel)
+{
+    Interval interval;
+    interval.block = std::make_shared<Gnss_Sdr_Block_Perf>(name, items_per_second, channel);
+    interval.calls = 0;
+    interval.consumed = 0;
+    interval.busy_ns = 0;
+    interval.cpu = 0.0;
+    interval.rt_load = 0.0;
+    interval.overruns = 0;
+    boost::mutex::scoped_lock lock(d_mutex);
+    d_blocks.push_back(interval);
+    return interval.block;
+}
+
+
+std::vector<std::shared_ptr<Gnss_Sdr_Block_Perf>> Gnss_Sdr_Perf::blocks() const
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    std::vector<std::shared_ptr<Gnss_Sdr_Block_Perf>> blocks;
+    for (std::vector<Interval>::const_iterator it = d_blocks.begin(); it != d_blocks.end(); ++it)
+        {
+            blocks.push_back(it->block);
+        }
+    return blocks;
+}
+
+
+void Gnss_Sdr_Perf::clear()
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    d_blocks.clear();
+    d_start = std::chrono::steady_clock::now();
+    d_last = d_start;
+}
+
+
+void Gnss_Sdr_Perf::set_enabled(bool enabled)
+{
+    d_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+
+void Gnss_Sdr_Perf::set_period_ms(int period_ms)
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    d_period_ms = period_ms > 0 ? period_ms : 1000;
+}
+
+
+void Gnss_Sdr_Perf::set_max_backlog_ms(double max_backlog_ms)
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    d_max_backlog_ms = max_backlog_ms;
+}
+
+
+unsigned long long Gnss_Sdr_Perf::get_overruns(const Gnss_Sdr_Block_Perf* block) const
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    for (std::vector<Interval>::const_iterator it = d_blocks.begin(); it != d_blocks.end(); ++it)
+        {
+            if (it->block.get() == block) return it->overruns;
+        }
+    return 0;
+}
+
+
+/*
+ * Closes the current interval of every block. Called with d_mutex held.
+ */
+void Gnss_Sdr_Perf::roll(double interval_s)
+{
+    for (std::vector<Interval>::iterator it = d_blocks.begin(); it != d_blocks.end(); ++it)
+        {
+            const Gnss_Sdr_Block_Perf& block = *it->block;
+            unsigned long long calls = block.get_calls();
+            unsigned long long consumed = block.get_consumed();
+            unsigned long long busy_ns = block.get_busy_ns();
+            double busy_s = static_cast<double>(busy_ns - it->busy_ns) * 1e-9;
+            double stream_s = 0.0;
+            if (block.get_rate() > 0.0)
+                {
+                    stream_s = static_cast<double>(consumed - it->consumed) / block.get_rate();
+                }
+            it->cpu = busy_s / interval_s;
+            it->rt_load = stream_s > 0.0 ? busy_s / stream_s : 0.0;
+
+            bool behind = calls != it->calls && it->rt_load > 1.0;
+            if (d_max_backlog_ms > 0.0 && block.backlog_s() * 1e3 > d_max_backlog_ms)
+                {
+                    behind = true;
+                }
+            if (behind)
+                {
+                    it->overruns++;
+                    LOG(WARNING) << "Perf: " << block.label() << " is falling behind: real-time load "
+                                 << it->rt_load << ", backlog " << block.backlog_s() * 1e3 << " ms";
+                }
+            it->calls = calls;
+            it->consumed = consumed;
+            it->busy_ns = busy_ns;
+        }
+}
+
+
+std::string Gnss_Sdr_Perf::to_json()
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    double interval_s = std::chrono::duration<double>(now - d_last).count();
+    if (interval_s * 1e3 >= d_period_ms / 2.0)
+        {
+            roll(interval_s);
+            d_last = now;
+        }
+    double uptime_s = std::chrono::duration<double>(now - d_start).count();
+
+    std::stringstream s;
+    s << "{\"uptime_s\":" << uptime_s << ",\"blocks\":[";
+    for (std::vector<Interval>::const_iterator it = d_blocks.begin(); it != d_blocks.end(); ++it)
+        {
+            const Gnss_Sdr_Block_Perf& block = *it->block;
+            s << (it == d_blocks.begin() ? "" : ",")
+              << "{\"name\":\"" << block.get_name() << "\""
+              << ",\"channel\":" << block.get_channel()
+              << ",\"rate\":" << block.get_rate()
+              << ",\"calls\":" << block.get_calls()
+              << ",\"consumed\":" << block.get_consumed()
+              << ",\"produced\":" << block.get_produced()
+              << ",\"busy_ns\":" << block.get_busy_ns()
+              << ",\"rt_load\":" << block.rt_load()
+              << ",\"backlog\":" << block.get_backlog()
+              << ",\"backlog_ms\":" << block.backlog_s() * 1e3
+              << ",\"overruns\":" << it->overruns
+              << ",\"interval\":{\"cpu\":" << it->cpu << ",\"rt_load\":" << it->rt_load << "}"
+              << ",\"work_ns\":" << block.get_work_ns().to_json()
+              << ",\"backlog_items\":" << block.get_backlog_items().to_json() << "}";
+        }
+    s << "]}\n";
+    return s.str();
+}
+
+
+std::string Gnss_Sdr_Perf::summary() const
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    double uptime_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - d_start).count();
+    std::stringstream s;
+    s << "Block performance over " << std::fixed << std::setprecision(1) << uptime_s << " s"
+      << " (real-time load: work time over stream time of the consumed input)" << std::endl;
+    s << std::left << std::setw(24) << "block" << std::right
+      << std::setw(10) << "calls"
+      << std::setw(14) << "items"
+      << std::setw(11) << "mean [us]"
+      << std::setw(11) << "p99 [us]"
+      << std::setw(11) << "busy [s]"
+      << std::setw(9) << "rt load"
+      << std::setw(14) << "backlog [ms]"
+      << std::setw(10) << "overruns" << std::endl;
+    for (std::vector<Interval>::const_iterator it = d_blocks.begin(); it != d_blocks.end(); ++it)
+        {
+            const Gnss_Sdr_Block_Perf& block = *it->block;
+            if (block.get_calls() == 0) continue;
+            double max_backlog_ms = 0.0;
+            if (block.get_rate() > 0.0)
+                {
+                    max_backlog_ms = static_cast<double>(block.get_backlog_items().max()) / block.get_rate() * 1e3;
+                }
+            s << std::left << std::setw(24) << block.label() << std::right
+              << std::setw(10) << block.get_calls()
+              << std::setw(14) << block.get_consumed()
+              << std::setw(11) << std::setprecision(1) << block.get_work_ns().mean() * 1e-3
+              << std::setw(11) << static_cast<double>(block.get_work_ns().quantile(0.99)) * 1e-3
+              << std::setw(11) << std::setprecision(3) << static_cast<double>(block.get_busy_ns()) * 1e-9
+              << std::setw(9) << block.rt_load()
+              << std::setw(14) << std::setprecision(1) << max_backlog_ms
+              << std::setw(10) << it->overruns << std::endl;
+        }
+    return s.str();
+}
+
+
+// ######## WORK CALL SCOPES #########
+
+Gnss_Sdr_Perf_Scope::Gnss_Sdr_Perf_Scope(Gnss_Sdr_Block_Perf* perf, gr::block* block, int backlog)
+{
+    d_perf = nullptr;
+    if (perf == nullptr || !Gnss_Sdr_Perf::instance().enabled())
+        {
+            return;
+        }
+    d_perf = perf;
+    d_block = block;
+    d_backlog = backlog > 0 ? backlog : 0;
+    d_read = d_block->nitems_read(0);
+    if (d_block->detail()->noutputs() > 0)
+        {
+            d_perf->set_produced(d_block->nitems_written(0));
+        }
+    d_start = std::chrono::steady_clock::now();
+}
+
+
+Gnss_Sdr_Perf_Scope::~Gnss_Sdr_Perf_Scope()
+{
+    if (d_perf == nullptr)
+        {
+            return;
+        }
+    unsigned long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - d_start).count();
+    d_perf->add_work(ns, d_block->nitems_read(0) - d_read, d_backlog);
+}
@@ -0,0 +1,194 @@
+/*!
+ * \file gnss_sdr_perf.h
+ * \brief Per-block performance counters of the receiver blocks: duration of
+ * the work calls, items processed, input backlog and real-time load.
+ *
+ * The counters are updated by the block thread with relaxed atomics and read
+ * by the publishing thread, so sampling a work call costs two clock reads and
+ * a few uncontended increments. Nothing is measured unless enabled.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_GNSS_SDR_PERF_H_
+#define GNSS_SDR_GNSS_SDR_PERF_H_
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include <boost/thread/mutex.hpp>
+#include <gnuradio/block.h>
+#include "spoofing_stats.h"
+
+
+/*!
+ * \brief Counters of one block instance.
+ *
+ * The stream time of the consumed input is consumed / rate, where the rate is
+ * the nominal number of input items per second of the block (e.g. the sampling
+ * frequency for tracking, sampling frequency / FFT size for acquisition).
+ * The real-time load is the time spent in the work calls over that stream
+ * time: above 1 the block cannot keep up with the signal source.
+ */
+class Gnss_Sdr_Block_Perf
+{
+public:
+    void add_work(unsigned long long work_ns, unsigned long long consumed, unsigned long long backlog);
+    void set_produced(unsigned long long produced);  //!< Items produced since the block started (fixes for the PVT)
+    void set_channel(int channel);
+    void clear();
+
+    const std::string& get_name() const;
+    int get_channel() const;           //!< -1 for blocks that do not belong to a channel
+    double get_rate() const;           //!< Nominal input items per second, 0 if unknown
+    std::string label() const;         //!< Name and channel, e.g. "tracking[3]"
+
+    unsigned long long get_calls() const;
+    unsigned long long get_consumed() const;
+    unsigned long long get_produced() const;
+    unsigned long long get_busy_ns() const;
+    unsigned long long get_backlog() const;  //!< Input items waiting at the last work call
+    const Spoofing_Histogram& get_work_ns() const;
+    const Spoofing_Histogram& get_backlog_items() const;
+
+    double stream_s() const;   //!< Stream time of the consumed input [s], 0 if the rate is unknown
+    double rt_load() const;    //!< Busy time over stream time since construction or clear()
+    double backlog_s() const;  //!< Stream time waiting at the input at the last work call [s]
+
+    Gnss_Sdr_Block_Perf(const std::string& name, double items_per_second, int channel = -1);
+
+private:
+    std::string d_name;
+    double d_rate;
+    std::atomic<int> d_channel;
+    std::atomic<unsigned long long> d_consumed;
+    std::atomic<unsigned long long> d_produced;
+    std::atomic<unsigned long long> d_backlog;
+    Spoofing_Histogram d_work_ns;
+    Spoofing_Histogram d_backlog_items;
+
+    Gnss_Sdr_Block_Perf(const Gnss_Sdr_Block_Perf&);
+    Gnss_Sdr_Block_Perf& operator=(const Gnss_Sdr_Block_Perf&);
+};
+
+
+/*!
+ * \brief Process-wide registry of the block counters.
+ *
+ * Besides the totals, to_json() reports for every block the values of the
+ * last publishing interval: CPU share, real-time load and backlog. A block
+ * whose interval real-time load exceeds 1, or whose backlog exceeds the
+ * configured limit, is counted as an overrun and logged as falling behind.
+ */
+class Gnss_Sdr_Perf
+{
+public:
+    static Gnss_Sdr_Perf& instance();
+
+    /*!
+     * \brief Registers the counters of a block of \a items_per_second nominal
+     * input rate (0 if unknown). The registry keeps them until clear().
+     */
+    std::shared_ptr<Gnss_Sdr_Block_Perf> add(const std::string& name, double items_per_second, int channel = -1);
+    std::vector<std::shared_ptr<Gnss_Sdr_Block_Perf>> blocks() const;
+    void clear();
+
+    void set_enabled(bool enabled);
+    bool enabled() const
+    {
+        return d_enabled.load(std::memory_order_relaxed);
+    }
+
+    /*!
+     * \brief Intervals shorter than \a period_ms / 2 are not rolled by to_json(),
+     * so that clients of the socket do not shorten the periodic ones.
+     */
+    void set_period_ms(int period_ms);
+    void set_max_backlog_ms(double max_backlog_ms);
+    unsigned long long get_overruns(const Gnss_Sdr_Block_Perf* block) const;
+
+    std::string to_json();
+
+    /*!
+     * \brief Table of the totals of every block that did any work, printed by gnss-sdr --perf
+     */
+    std::string summary() const;
+
+private:
+    struct Interval
+    {
+        std::shared_ptr<Gnss_Sdr_Block_Perf> block;
+        unsigned long long calls;
+        unsigned long long consumed;
+        unsigned long long busy_ns;
+        double cpu;        // busy time over wall time of the last interval
+        double rt_load;    // busy time over stream time of the last interval
+        unsigned long long overruns;
+    };
+
+    mutable boost::mutex d_mutex;
+    std::vector<Interval> d_blocks;  // guarded by d_mutex
+    std::chrono::steady_clock::time_point d_start;
+    std::chrono::steady_clock::time_point d_last;
+    std::atomic<bool> d_enabled;
+    int d_period_ms;
+    double d_max_backlog_ms;
+
+    void roll(double interval_s);
+
+    Gnss_Sdr_Perf();
+    Gnss_Sdr_Perf(const Gnss_Sdr_Perf&);
+    Gnss_Sdr_Perf& operator=(const Gnss_Sdr_Perf&);
+};
+
+
+/*!
+ * \brief Samples one work call of \a block from construction to destruction.
+ *
+ * Declared first in general_work(), it takes the items consumed from the
+ * difference of nitems_read(0) on exit, since consume() is applied at once,
+ * and the items produced by the previous call from nitems_written(0).
+ * \a backlog is the number of input items available to the call.
+ */
+class Gnss_Sdr_Perf_Scope
+{
+public:
+    Gnss_Sdr_Perf_Scope(Gnss_Sdr_Block_Perf* perf, gr::block* block, int backlog);
+    ~Gnss_Sdr_Perf_Scope();
+
+private:
+    Gnss_Sdr_Block_Perf* d_perf;
+    gr::block* d_block;
+    unsigned long long d_backlog;
+    unsigned long long d_read;
+    std::chrono::steady_clock::time_point d_start;
+
+    Gnss_Sdr_Perf_Scope(const Gnss_Sdr_Perf_Scope&);
+    Gnss_Sdr_Perf_Scope& operator=(const Gnss_Sdr_Perf_Scope&);
+};
+
+#endif
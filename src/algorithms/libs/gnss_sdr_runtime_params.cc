@@ -0,0 +1,510 @@
+/*!
+ * \file gnss_sdr_runtime_params.cc
+ * \brief Receiver parameters that can be changed while the flowgraph runs.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gnss_sdr_runtime_params.h"
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <glog/logging.h>
+
+using google::LogMessage;
+
+namespace
+{
+enum Runtime_Param_Kind
+{
+    RUNTIME_PARAM_NONE,
+    RUNTIME_PARAM_NUMBER,    // non-negative number
+    RUNTIME_PARAM_BOOL,
+    RUNTIME_PARAM_BANDWIDTH  // loop bandwidth, (0, 250] Hz
+};
+
+const double max_loop_bw_hz = 250.0; // a loop filter updated every 1 ms is unstable above this
+
+
+Runtime_Param_Kind runtime_param_kind(const std::string& key)
+{
+    static const std::set<std::string> spoofing_numbers = { "CN0_threshold", "RT_threshold", "Delta_threshold",
+            "APT_max_rx_discrepancy", "NAVI_TOW_max_discrepancy", "NAVI_max_alt" };
+    static const std::set<std::string> spoofing_bools = { "PPE", "NAVI_TOW", "NAVI_inter_satellite", "NAVI_alt" };
+
+    size_t dot = key.rfind('.');
+    if (dot == std::string::npos || dot == 0)
+        {
+            return RUNTIME_PARAM_NONE;
+        }
+    std::string role = key.substr(0, dot);
+    std::string name = key.substr(dot + 1);
+    if (role == "Spoofing")
+        {
+            if (spoofing_numbers.count(name)) return RUNTIME_PARAM_NUMBER;
+            if (spoofing_bools.count(name)) return RUNTIME_PARAM_BOOL;
+        }
+    else if (role.compare(0, 12, "Acquisition_") == 0 && role.size() > 12)
+        {
+            if (name == "threshold") return RUNTIME_PARAM_NUMBER;
+        }
+    else if (role.compare(0, 9, "Tracking_") == 0 && role.size() > 9)
+        {
+            if (name == "pll_bw_hz" || name == "dll_bw_hz") return RUNTIME_PARAM_BANDWIDTH;
+        }
+    return RUNTIME_PARAM_NONE;
+}
+
+
+bool parse_number(const std::string& text, double& value)
+{
+    if (text.empty()) return false;
+    char* end = nullptr;
+    errno = 0;
+    value = std::strtod(text.c_str(), &end);
+    return errno == 0 && end == text.c_str() + text.size() && std::isfinite(value);
+}
+
+
+bool parse_bool(const std::string& text, bool& value)
+{
+    if (text == "true" || text == "1")
+        {
+            value = true;
+            return true;
+        }
+    if (text == "false" || text == "0")
+        {
+            value = false;
+            return true;
+        }
+    return false;
+}
+
+
+std::string trim(const std::string& s)
+{
+    size_t begin = s.find_first_not_of(" \t\r\n");
+    if (begin == std::string::npos) return "";
+    size_t end = s.find_last_not_of(" \t\r\n");
+    return s.substr(begin, end - begin + 1);
+}
+}
+
+
+Gnss_Sdr_Runtime_Params& Gnss_Sdr_Runtime_Params::instance()
+{
+    static Gnss_Sdr_Runtime_Params params;
+    return params;
+}
+
+
+Gnss_Sdr_Runtime_Params::Gnss_Sdr_Runtime_Params()
+{
+    d_version = 0;
+}
+
+
+bool Gnss_Sdr_Runtime_Params::validate(const std::string& key, const std::string& value, std::string& error)
+{
+    double number;
+    bool flag;
+    switch (runtime_param_kind(key))
+    {
+    case RUNTIME_PARAM_NUMBER:
+        if (parse_number(value, number) && number >= 0.0) return true;
+        error = key + ": expected a non-negative number, got '" + value + "'";
+        return false;
+    case RUNTIME_PARAM_BOOL:
+        if (parse_bool(value, flag)) return true;
+        error = key + ": expected true or false, got '" + value + "'";
+        return false;
+    case RUNTIME_PARAM_BANDWIDTH:
+        if (parse_number(value, number) && number > 0.0 && number <= max_loop_bw_hz) return true;
+        error = key + ": expected a bandwidth in (0, 250] Hz, got '" + value + "'";
+        return false;
+    default:
+        error = key + ": cannot be changed at run time";
+        return false;
+    }
+}
+
+
+bool Gnss_Sdr_Runtime_Params::update(const std::map<std::string, std::string>& values, std::string& error)
+{
+    for (std::map<std::string, std::string>::const_iterator it = values.begin(); it != values.end(); ++it)
+        {
+            if (!validate(it->first, it->second, error))
+                {
+                    return false;
+                }
+        }
+    if (values.empty())
+        {
+            return true;
+        }
+    boost::mutex::scoped_lock lock(d_mutex);
+    for (std::map<std::string, std::string>::const_iterator it = values.begin(); it != values.end(); ++it)
+        {
+            d_values[it->first] = it->second;
+        }
+    d_version++;
+    return true;
+}
+
+
+unsigned long int Gnss_Sdr_Runtime_Params::version() const
+{
+    return d_version.load();
+}
+
+
+std::map<std::string, std::string> Gnss_Sdr_Runtime_Params::values(unsigned long int& version)
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    version = d_version.load();
+    return d_values;
+}
+
+
+void Gnss_Sdr_Runtime_Params::clear()
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    d_values.clear();
+    d_version++;
+}
+
+
+
+Gnss_Sdr_Runtime_Params_Watch::Gnss_Sdr_Runtime_Params_Watch()
+{
+    d_version = 0;
+}
+
+
+Gnss_Sdr_Runtime_Params_Watch::Gnss_Sdr_Runtime_Params_Watch(const std::string& role)
+{
+    d_version = 0;
+    set_role(role);
+}
+
+
+void Gnss_Sdr_Runtime_Params_Watch::set_role(const std::string& role)
+{
+    d_role = role;
+    d_channel_role.clear();
+    d_version = 0; // re-read the published values under the new role
+}
+
+
+void Gnss_Sdr_Runtime_Params_Watch::set_channel(unsigned int channel)
+{
+    std::stringstream s;
+    s << d_role << channel;
+    d_channel_role = s.str();
+    d_version = 0;
+}
+
+
+bool Gnss_Sdr_Runtime_Params_Watch::changed()
+{
+    Gnss_Sdr_Runtime_Params& params = Gnss_Sdr_Runtime_Params::instance();
+    if (params.version() == d_version)
+        {
+            return false;
+        }
+    d_values = params.values(d_version);
+    return true;
+}
+
+
+bool Gnss_Sdr_Runtime_Params_Watch::find(const std::string& name, std::string& value) const
+{
+    std::map<std::string, std::string>::const_iterator it = d_values.end();
+    if (!d_channel_role.empty())
+        {
+            it = d_values.find(d_channel_role + "." + name);
+        }
+    if (it == d_values.end())
+        {
+            it = d_values.find(d_role + "." + name);
+        }
+    if (it == d_values.end())
+        {
+            return false;
+        }
+    value = it->second;
+    return true;
+}
+
+
+bool Gnss_Sdr_Runtime_Params_Watch::get(const std::string& name, double& value) const
+{
+    std::string text;
+    return find(name, text) && parse_number(text, value);
+}
+
+
+bool Gnss_Sdr_Runtime_Params_Watch::get(const std::string& name, bool& value) const
+{
+    std::string text;
+    return find(name, text) && parse_bool(text, value);
+}
+
+
+
+Gnss_Sdr_Reconfigure_Listener::Gnss_Sdr_Reconfigure_Listener()
+{
+    d_period_ms = 1000;
+    d_fd = -1;
+    d_mtime = 0;
+    d_size = 0;
+    d_stop = true;
+}
+
+
+Gnss_Sdr_Reconfigure_Listener::~Gnss_Sdr_Reconfigure_Listener()
+{
+    stop();
+}
+
+
+bool Gnss_Sdr_Reconfigure_Listener::parse(const std::string& text, std::map<std::string, std::string>& values, std::string& error)
+{
+    bool ok = true;
+    std::istringstream lines(text);
+    std::string line;
+    while (std::getline(lines, line))
+        {
+            // values end at the first ';', as in the configuration files
+            line = trim(line.substr(0, line.find(';')));
+            if (line.empty() || line[0] == '#' || line[0] == '[')
+                {
+                    continue;
+                }
+            size_t eq = line.find('=');
+            if (eq == std::string::npos || eq == 0)
+                {
+                    if (ok) error = "malformed line '" + line + "'";
+                    ok = false;
+                    continue;
+                }
+            values[trim(line.substr(0, eq))] = trim(line.substr(eq + 1));
+        }
+    return ok;
+}
+
+
+bool Gnss_Sdr_Reconfigure_Listener::start(const std::string& filename, int period_ms, const std::string& socket_path, Callback callback)
+{
+    stop();
+    d_filename = filename;
+    d_socket_path = socket_path;
+    d_period_ms = period_ms > 0 ? period_ms : 1000;
+    d_callback = callback;
+    d_mtime = 0;
+    d_size = 0;
+    d_file_values.clear();
+
+    if (!d_filename.empty())
+        {
+            // the first read is the baseline, only later changes are passed on
+            check_file();
+        }
+    if (!d_socket_path.empty())
+        {
+            struct sockaddr_un addr;
+            std::memset(&addr, 0, sizeof(addr));
+            addr.sun_family = AF_UNIX;
+            std::strncpy(addr.sun_path, d_socket_path.c_str(), sizeof(addr.sun_path) - 1);
+            ::unlink(d_socket_path.c_str());
+            d_fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+            if (d_fd < 0
+                || ::bind(d_fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) != 0
+                || ::listen(d_fd, 4) != 0)
+                {
+                    LOG(WARNING) << "Reconfigure: unable to listen on " << d_socket_path << ": " << std::strerror(errno);
+                    if (d_fd >= 0) ::close(d_fd);
+                    d_fd = -1;
+                }
+        }
+    if (d_filename.empty() && d_fd < 0)
+        {
+            return false;
+        }
+    d_stop = false;
+    d_thread = boost::thread(&Gnss_Sdr_Reconfigure_Listener::run, this);
+    return true;
+}
+
+
+void Gnss_Sdr_Reconfigure_Listener::stop()
+{
+    if (d_stop) return;
+    d_stop = true;
+    d_thread.join();
+    if (d_fd >= 0)
+        {
+            ::close(d_fd);
+            ::unlink(d_socket_path.c_str());
+            d_fd = -1;
+        }
+}
+
+
+void Gnss_Sdr_Reconfigure_Listener::run()
+{
+    std::chrono::steady_clock::time_point next_check = std::chrono::steady_clock::now() + std::chrono::milliseconds(d_period_ms);
+    while (!d_stop)
+        {
+            // wake up at least every 100 ms to notice stop()
+            if (d_fd >= 0)
+                {
+                    struct pollfd pfd;
+                    pfd.fd = d_fd;
+                    pfd.events = POLLIN;
+                    if (::poll(&pfd, 1, 100) > 0 && (pfd.revents & POLLIN))
+                        {
+                            serve();
+                        }
+                }
+            else
+                {
+                    boost::this_thread::sleep_for(boost::chrono::milliseconds(100));
+                }
+            if (!d_filename.empty() && std::chrono::steady_clock::now() >= next_check)
+                {
+                    check_file();
+                    next_check = std::chrono::steady_clock::now() + std::chrono::milliseconds(d_period_ms);
+                }
+        }
+}
+
+
+void Gnss_Sdr_Reconfigure_Listener::check_file()
+{
+    struct stat st;
+    if (::stat(d_filename.c_str(), &st) != 0 || (st.st_mtime == d_mtime && st.st_size == d_size))
+        {
+            return;
+        }
+    bool baseline = (d_mtime == 0);
+    d_mtime = st.st_mtime;
+    d_size = st.st_size;
+
+    std::ifstream f(d_filename.c_str());
+    std::stringstream text;
+    text << f.rdbuf();
+    std::map<std::string, std::string> values;
+    std::string error;
+    parse(text.str(), values, error); // the other lines of a configuration file are not ours to judge
+
+    std::map<std::string, std::string> changes;
+    for (std::map<std::string, std::string>::const_iterator it = values.begin(); it != values.end(); ++it)
+        {
+            if (runtime_param_kind(it->first) == RUNTIME_PARAM_NONE) continue;
+            std::map<std::string, std::string>::const_iterator old = d_file_values.find(it->first);
+            if (old == d_file_values.end() || old->second != it->second)
+                {
+                    changes[it->first] = it->second;
+                }
+            d_file_values[it->first] = it->second;
+        }
+    if (baseline || changes.empty())
+        {
+            return;
+        }
+    for (std::map<std::string, std::string>::const_iterator it = changes.begin(); it != changes.end(); ++it)
+        {
+            if (!Gnss_Sdr_Runtime_Params::validate(it->first, it->second, error))
+                {
+                    LOG(WARNING) << "Reconfigure: " << d_filename << " ignored, " << error;
+                    return;
+                }
+        }
+    d_callback(changes);
+}
+
+
+void Gnss_Sdr_Reconfigure_Listener::serve()
+{
+    int fd = ::accept(d_fd, nullptr, nullptr);
+    if (fd < 0) return;
+
+    // read until the client closes its side or sends an empty line, at most 1 s
+    std::string request;
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    while (std::chrono::steady_clock::now() < deadline && request.find("\n\n") == std::string::npos)
+        {
+            struct pollfd pfd;
+            pfd.fd = fd;
+            pfd.events = POLLIN;
+            if (::poll(&pfd, 1, 100) <= 0) continue;
+            char buffer[1024];
+            ssize_t r = ::recv(fd, buffer, sizeof(buffer), 0);
+            if (r <= 0) break;
+            request.append(buffer, r);
+        }
+
+    std::map<std::string, std::string> values;
+    std::string error;
+    bool ok = parse(request, values, error);
+    for (std::map<std::string, std::string>::const_iterator it = values.begin(); ok && it != values.end(); ++it)
+        {
+            ok = Gnss_Sdr_Runtime_Params::validate(it->first, it->second, error);
+        }
+    std::string reply;
+    if (!ok)
+        {
+            reply = "ERROR " + error + "\n";
+        }
+    else if (values.empty())
+        {
+            reply = "ERROR no values\n";
+        }
+    else
+        {
+            d_callback(values);
+            reply = "OK\n";
+        }
+    size_t sent = 0;
+    while (sent < reply.size())
+        {
+            ssize_t w = ::send(fd, reply.data() + sent, reply.size() - sent, MSG_NOSIGNAL);
+            if (w <= 0) break;
+            sent += w;
+        }
+    ::close(fd);
+}
@@ -0,0 +1,173 @@
+/*!
+ * \file gnss_sdr_runtime_params.h
+ * \brief Receiver parameters that can be changed while the flowgraph runs.
+ *
+ * A new set of values is validated as a whole and published as one version.
+ * The blocks that use them poll the version from their own work thread and
+ * take a consistent snapshot when it changes, so values are never written
+ * under a running work() call. The keys that can be changed are:
+ *
+ * Spoofing.CN0_threshold, Spoofing.RT_threshold, Spoofing.Delta_threshold,
+ * Spoofing.APT_max_rx_discrepancy, Spoofing.NAVI_TOW_max_discrepancy,
+ * Spoofing.NAVI_max_alt                      non-negative numbers
+ * Spoofing.PPE, Spoofing.NAVI_TOW, Spoofing.NAVI_inter_satellite,
+ * Spoofing.NAVI_alt                          true or false
+ * Acquisition_<signal>[<channel>].threshold  non-negative number
+ * Tracking_<signal>[<channel>].pll_bw_hz,
+ * Tracking_<signal>[<channel>].dll_bw_hz     in (0, 250] Hz
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_GNSS_SDR_RUNTIME_PARAMS_H_
+#define GNSS_SDR_GNSS_SDR_RUNTIME_PARAMS_H_
+
+#include <atomic>
+#include <ctime>
+#include <functional>
+#include <map>
+#include <string>
+#include <sys/types.h>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+
+/*!
+ * \brief Process-wide store of the parameters changed at run time.
+ */
+class Gnss_Sdr_Runtime_Params
+{
+public:
+    static Gnss_Sdr_Runtime_Params& instance();
+
+    /*!
+     * \brief Checks that \a key can be changed at run time and that \a value
+     * is valid for it. Otherwise returns false and describes why in \a error.
+     */
+    static bool validate(const std::string& key, const std::string& value, std::string& error);
+
+    /*!
+     * \brief Publishes all the \a values as a new version if every one of them
+     * is valid; otherwise nothing changes and \a error describes the first
+     * invalid value.
+     */
+    bool update(const std::map<std::string, std::string>& values, std::string& error);
+
+    unsigned long int version() const; //!< 0 until the first update
+
+    //! Values published so far and the version they belong to
+    std::map<std::string, std::string> values(unsigned long int& version);
+
+    void clear();
+
+private:
+    boost::mutex d_mutex;
+    std::map<std::string, std::string> d_values;
+    std::atomic<unsigned long int> d_version;
+
+    Gnss_Sdr_Runtime_Params();
+    Gnss_Sdr_Runtime_Params(const Gnss_Sdr_Runtime_Params&);
+    Gnss_Sdr_Runtime_Params& operator=(const Gnss_Sdr_Runtime_Params&);
+};
+
+
+/*!
+ * \brief View of the runtime parameters of one block.
+ *
+ * changed() costs one atomic load when nothing was published. get() looks
+ * up <role><channel>.<name> first and then <role>.<name> in the snapshot
+ * taken by the last changed() that returned true.
+ */
+class Gnss_Sdr_Runtime_Params_Watch
+{
+public:
+    void set_role(const std::string& role);
+    void set_channel(unsigned int channel);
+
+    bool changed();
+    bool get(const std::string& name, double& value) const;
+    bool get(const std::string& name, bool& value) const;
+
+    Gnss_Sdr_Runtime_Params_Watch();
+    Gnss_Sdr_Runtime_Params_Watch(const std::string& role);
+
+private:
+    std::string d_role;
+    std::string d_channel_role;
+    unsigned long int d_version;
+    std::map<std::string, std::string> d_values;
+
+    bool find(const std::string& name, std::string& value) const;
+};
+
+
+/*!
+ * \brief Receives parameter changes and hands them, validated, to a
+ * callback.
+ *
+ * Two feeds, either of which can be disabled:
+ * - a watched file of key=value lines (';' and '#' start comments), for
+ *   example the receiver configuration itself: when its modification time
+ *   changes, the updatable keys whose value differs from the previous read
+ *   are passed on;
+ * - a local UNIX socket: a client writes key=value lines and closes its
+ *   side or sends an empty line, and reads back "OK" or "ERROR <reason>".
+ *   A batch with any invalid line is rejected as a whole.
+ */
+class Gnss_Sdr_Reconfigure_Listener
+{
+public:
+    typedef std::function<void(const std::map<std::string, std::string>&)> Callback;
+
+    bool start(const std::string& filename, int period_ms, const std::string& socket_path, Callback callback);
+    void stop();
+
+    //! Parses key=value lines; false and \a error on the first malformed line
+    static bool parse(const std::string& text, std::map<std::string, std::string>& values, std::string& error);
+
+    Gnss_Sdr_Reconfigure_Listener();
+    ~Gnss_Sdr_Reconfigure_Listener();
+
+private:
+    std::string d_filename;
+    std::string d_socket_path;
+    int d_period_ms;
+    int d_fd;
+    Callback d_callback;
+    time_t d_mtime;
+    off_t d_size; // with d_mtime (1 s resolution), to notice quick successive edits
+    std::map<std::string, std::string> d_file_values;
+    std::atomic<bool> d_stop;
+    boost::thread d_thread;
+
+    void run();
+    void check_file();
+    void serve();
+
+    Gnss_Sdr_Reconfigure_Listener(const Gnss_Sdr_Reconfigure_Listener&);
+    Gnss_Sdr_Reconfigure_Listener& operator=(const Gnss_Sdr_Reconfigure_Listener&);
+};
+
+#endif
@@ -0,0 +1,150 @@
+/*!
+ * \file gnss_sdr_shared_tables.cc
+ * \brief Tables that only depend on the configuration (Doppler wipeoff grids,
+ * local code spectra) shared by all the channels, and the FFTW wisdom cache
+ * that makes the FFT plans of the acquisition blocks cheap to create.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gnss_sdr_shared_tables.h"
+#include <cstdio>
+#include <gnuradio/fft/fft.h>
+#include <glog/logging.h>
+#include <volk/volk.h>
+#if FFTW3F_WISDOM
+#include <fftw3.h>
+#endif
+
+using google::LogMessage;
+
+
+Gnss_Sdr_Shared_Tables& Gnss_Sdr_Shared_Tables::instance()
+{
+    static Gnss_Sdr_Shared_Tables tables;
+    return tables;
+}
+
+
+Gnss_Sdr_Shared_Tables::Gnss_Sdr_Shared_Tables()
+{
+    d_builds = 0;
+    d_hits = 0;
+}
+
+
+std::shared_ptr<gr_complex> Gnss_Sdr_Shared_Tables::get(const std::string& key, size_t size, const std::function<void(gr_complex*)>& build)
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    std::map<std::string, std::shared_ptr<gr_complex>>::iterator it = d_tables.find(key);
+    if (it != d_tables.end())
+        {
+            d_hits++;
+            return it->second;
+        }
+    std::shared_ptr<gr_complex> table(static_cast<gr_complex*>(volk_malloc(size * sizeof(gr_complex), volk_get_alignment())), volk_free);
+    build(table.get());
+    d_tables[key] = table;
+    d_builds++;
+    DLOG(INFO) << "Shared table " << key << " built (" << size << " samples)";
+    return table;
+}
+
+
+bool Gnss_Sdr_Shared_Tables::contains(const std::string& key)
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    return d_tables.count(key) != 0;
+}
+
+
+void Gnss_Sdr_Shared_Tables::clear()
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    d_tables.clear();
+    d_builds = 0;
+    d_hits = 0;
+}
+
+
+unsigned int Gnss_Sdr_Shared_Tables::tables()
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    return d_tables.size();
+}
+
+
+unsigned long int Gnss_Sdr_Shared_Tables::builds()
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    return d_builds;
+}
+
+
+unsigned long int Gnss_Sdr_Shared_Tables::hits()
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    return d_hits;
+}
+
+
+bool Gnss_Sdr_Fft_Wisdom::load(const std::string& filename)
+{
+#if FFTW3F_WISDOM
+    if (filename.empty()) return false;
+    gr::fft::planner::scoped_lock lock(gr::fft::planner::mutex());
+    if (fftwf_import_wisdom_from_filename(filename.c_str()) == 0)
+        {
+            LOG(INFO) << "No usable FFTW wisdom in " << filename;
+            return false;
+        }
+    LOG(INFO) << "FFTW wisdom loaded from " << filename;
+    return true;
+#else
+    (void)filename;
+    return false;
+#endif
+}
+
+
+bool Gnss_Sdr_Fft_Wisdom::save(const std::string& filename)
+{
+#if FFTW3F_WISDOM
+    if (filename.empty()) return false;
+    gr::fft::planner::scoped_lock lock(gr::fft::planner::mutex());
+    std::string tmp = filename + ".tmp";
+    if (fftwf_export_wisdom_to_filename(tmp.c_str()) == 0
+            || std::rename(tmp.c_str(), filename.c_str()) != 0)
+        {
+            LOG(WARNING) << "Unable to save the FFTW wisdom to " << filename;
+            std::remove(tmp.c_str());
+            return false;
+        }
+    return true;
+#else
+    (void)filename;
+    return false;
+#endif
+}
@@ -0,0 +1,99 @@
+/*!
+ * \file gnss_sdr_shared_tables.h
+ * \brief Tables that only depend on the configuration (Doppler wipeoff grids,
+ * local code spectra) shared by all the channels, and the FFTW wisdom cache
+ * that makes the FFT plans of the acquisition blocks cheap to create.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_GNSS_SDR_SHARED_TABLES_H_
+#define GNSS_SDR_GNSS_SDR_SHARED_TABLES_H_
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <boost/thread/mutex.hpp>
+#include <gnuradio/gr_complex.h>
+
+
+/*!
+ * \brief Process-wide store of read-only sample tables, built once per key.
+ *
+ * The key must describe everything the table depends on. A table is built
+ * by the first caller under the store lock, so channels constructed at the
+ * same time never build it twice, and is kept until clear(). Tables are
+ * aligned for VOLK and must not be written after they are built.
+ */
+class Gnss_Sdr_Shared_Tables
+{
+public:
+    static Gnss_Sdr_Shared_Tables& instance();
+
+    /*!
+     * \brief Returns the table of \a size samples stored under \a key, calling
+     * \a build to fill it if it does not exist yet.
+     */
+    std::shared_ptr<gr_complex> get(const std::string& key, size_t size, const std::function<void(gr_complex*)>& build);
+
+    bool contains(const std::string& key);
+    void clear();
+
+    unsigned int tables();          //!< Tables stored
+    unsigned long int builds();     //!< Tables built
+    unsigned long int hits();       //!< Requests served without building
+
+private:
+    boost::mutex d_mutex;
+    std::map<std::string, std::shared_ptr<gr_complex>> d_tables;
+    unsigned long int d_builds;
+    unsigned long int d_hits;
+
+    Gnss_Sdr_Shared_Tables();
+    Gnss_Sdr_Shared_Tables(const Gnss_Sdr_Shared_Tables&);
+    Gnss_Sdr_Shared_Tables& operator=(const Gnss_Sdr_Shared_Tables&);
+};
+
+
+/*!
+ * \brief FFTW wisdom kept in a receiver-owned file.
+ *
+ * gr::fft plans are created with FFTW_MEASURE, which takes tens of
+ * milliseconds per plan unless FFTW already has wisdom for that size.
+ * Loading the cache before the blocks are built turns every plan creation
+ * into a lookup; saving it afterwards adds the sizes that were measured.
+ * Both hold the gr::fft planner lock. Without FFTW3F at build time they
+ * return false and gr::fft falls back to its own wisdom file.
+ */
+class Gnss_Sdr_Fft_Wisdom
+{
+public:
+    static bool load(const std::string& filename);
+    static bool save(const std::string& filename);
+};
+
+#endif
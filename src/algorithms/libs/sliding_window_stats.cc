@@ -0,0 +1,312 @@
+/*!
+ * \file sliding_window_stats.cc
+ * \brief Streaming mean, variance, covariance and correlation over one or
+ * several sliding windows.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "sliding_window_stats.h"
+#include <algorithm>
+#include <cmath>
+
+
+Sliding_Window_Accumulator::Sliding_Window_Accumulator(unsigned int length)
+{
+    d_length = length;
+    reset();
+}
+
+
+Sliding_Window_Accumulator::~Sliding_Window_Accumulator()
+{}
+
+
+void Sliding_Window_Accumulator::reset()
+{
+    d_n = 0;
+    d_mean_x = 0.0;
+    d_mean_y = 0.0;
+    d_m2_x = 0.0;
+    d_m2_y = 0.0;
+    d_c_xy = 0.0;
+}
+
+
+void Sliding_Window_Accumulator::add(double x, double y)
+{
+    d_n++;
+    double dx = x - d_mean_x;
+    double dy = y - d_mean_y;
+    d_mean_x += dx / d_n;
+    d_mean_y += dy / d_n;
+    d_m2_x += dx * (x - d_mean_x);
+    d_m2_y += dy * (y - d_mean_y);
+    d_c_xy += dx * (y - d_mean_y);
+}
+
+
+void Sliding_Window_Accumulator::remove(double x, double y)
+{
+    if (d_n <= 1)
+        {
+            reset();
+            return;
+        }
+    // Inverse of add(): the moments of the window without (x, y)
+    d_n--;
+    double dx = x - d_mean_x;
+    double dy = y - d_mean_y;
+    d_mean_x -= dx / d_n;
+    d_mean_y -= dy / d_n;
+    d_m2_x -= dx * (x - d_mean_x);
+    d_m2_y -= dy * (y - d_mean_y);
+    d_c_xy -= dx * (y - d_mean_y);
+}
+
+
+unsigned int Sliding_Window_Accumulator::get_length() const
+{
+    return d_length;
+}
+
+
+unsigned int Sliding_Window_Accumulator::size() const
+{
+    return d_n;
+}
+
+
+bool Sliding_Window_Accumulator::full() const
+{
+    return d_n >= d_length;
+}
+
+
+double Sliding_Window_Accumulator::mean_x() const
+{
+    return d_mean_x;
+}
+
+
+double Sliding_Window_Accumulator::mean_y() const
+{
+    return d_mean_y;
+}
+
+
+double Sliding_Window_Accumulator::var_x() const
+{
+    if (d_n == 0) return 0.0;
+    return std::max(d_m2_x, 0.0) / d_n;
+}
+
+
+double Sliding_Window_Accumulator::var_y() const
+{
+    if (d_n == 0) return 0.0;
+    return std::max(d_m2_y, 0.0) / d_n;
+}
+
+
+double Sliding_Window_Accumulator::cov() const
+{
+    if (d_n == 0) return 0.0;
+    return d_c_xy / d_n;
+}
+
+
+double Sliding_Window_Accumulator::corr() const
+{
+    double den = std::sqrt(var_x() * var_y());
+    if (den <= 0.0) return 0.0;
+    return cov() / den;
+}
+
+
+
+Sliding_Window_Stats::Sliding_Window_Stats()
+{
+    d_count = 0;
+    d_since_resync = 0;
+}
+
+
+Sliding_Window_Stats::Sliding_Window_Stats(unsigned int window_length)
+{
+    d_windows.push_back(Sliding_Window_Accumulator(window_length));
+    d_history = boost::circular_buffer<std::pair<double, double>>(window_length);
+    d_count = 0;
+    d_since_resync = 0;
+}
+
+
+Sliding_Window_Stats::Sliding_Window_Stats(const std::vector<unsigned int>& window_lengths)
+{
+    unsigned int longest = 0;
+    for (unsigned int i = 0; i < window_lengths.size(); i++)
+        {
+            d_windows.push_back(Sliding_Window_Accumulator(window_lengths.at(i)));
+            longest = std::max(longest, window_lengths.at(i));
+        }
+    d_history = boost::circular_buffer<std::pair<double, double>>(longest);
+    d_count = 0;
+    d_since_resync = 0;
+}
+
+
+Sliding_Window_Stats::~Sliding_Window_Stats()
+{}
+
+
+void Sliding_Window_Stats::push_back(double x)
+{
+    push_back(x, x);
+}
+
+
+void Sliding_Window_Stats::push_back(double x, double y)
+{
+    if (d_history.capacity() == 0)
+        {
+            return;
+        }
+    unsigned int n = d_history.size();
+    for (std::vector<Sliding_Window_Accumulator>::iterator it = d_windows.begin(); it != d_windows.end(); ++it)
+        {
+            unsigned int length = it->get_length();
+            if (length == 0)
+                {
+                    continue;
+                }
+            if (n >= length)
+                {
+                    // the sample that falls out of this window
+                    const std::pair<double, double>& old = d_history[n - length];
+                    it->remove(old.first, old.second);
+                }
+            it->add(x, y);
+        }
+    d_history.push_back(std::make_pair(x, y));
+    d_count++;
+
+    if (++d_since_resync >= d_history.capacity())
+        {
+            resync();
+        }
+}
+
+
+/*
+ * Recompute the moments of every window from the stored samples, so that the
+ * rounding error of the incremental removals does not accumulate over time.
+ * Done once per longest window length, i.e. amortized O(1) per sample.
+ */
+void Sliding_Window_Stats::resync()
+{
+    d_since_resync = 0;
+    unsigned int n = d_history.size();
+    for (std::vector<Sliding_Window_Accumulator>::iterator it = d_windows.begin(); it != d_windows.end(); ++it)
+        {
+            it->reset();
+            unsigned int length = std::min(it->get_length(), n);
+            for (unsigned int k = n - length; k < n; k++)
+                {
+                    it->add(d_history[k].first, d_history[k].second);
+                }
+        }
+}
+
+
+void Sliding_Window_Stats::clear()
+{
+    d_history.clear();
+    for (std::vector<Sliding_Window_Accumulator>::iterator it = d_windows.begin(); it != d_windows.end(); ++it)
+        {
+            it->reset();
+        }
+    d_count = 0;
+    d_since_resync = 0;
+}
+
+
+unsigned int Sliding_Window_Stats::windows() const
+{
+    return d_windows.size();
+}
+
+
+const Sliding_Window_Accumulator& Sliding_Window_Stats::window(unsigned int i) const
+{
+    return d_windows.at(i);
+}
+
+
+unsigned long int Sliding_Window_Stats::count() const
+{
+    return d_count;
+}
+
+
+unsigned int Sliding_Window_Stats::size(unsigned int i) const
+{
+    return d_windows.at(i).size();
+}
+
+
+bool Sliding_Window_Stats::full(unsigned int i) const
+{
+    return d_windows.at(i).full();
+}
+
+
+double Sliding_Window_Stats::mean(unsigned int i) const
+{
+    return d_windows.at(i).mean_x();
+}
+
+
+double Sliding_Window_Stats::var(unsigned int i) const
+{
+    return d_windows.at(i).var_x();
+}
+
+
+double Sliding_Window_Stats::stddev(unsigned int i) const
+{
+    return std::sqrt(d_windows.at(i).var_x());
+}
+
+
+double Sliding_Window_Stats::cov(unsigned int i) const
+{
+    return d_windows.at(i).cov();
+}
+
+
+double Sliding_Window_Stats::corr(unsigned int i) const
+{
+    return d_windows.at(i).corr();
+}
@@ -0,0 +1,122 @@
+/*!
+ * \file sliding_window_stats.h
+ * \brief Streaming mean, variance, covariance and correlation over one or
+ * several sliding windows.
+ *
+ * Each window keeps Welford-style running moments that are updated when a
+ * sample enters and when it leaves the window, so every statistic costs O(1)
+ * per sample instead of a full pass over the window. The moments are
+ * recomputed exactly from the stored samples once per longest window length
+ * to bound the rounding drift of the add/remove updates.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_SLIDING_WINDOW_STATS_H_
+#define GNSS_SDR_SLIDING_WINDOW_STATS_H_
+
+#include <utility>
+#include <vector>
+#include <boost/circular_buffer.hpp>
+
+
+/*!
+ * \brief Running first and second order moments of a pair of series (x, y)
+ * over the samples currently inside one window.
+ */
+class Sliding_Window_Accumulator
+{
+private:
+    unsigned int d_length;
+    unsigned int d_n;
+    double d_mean_x;
+    double d_mean_y;
+    double d_m2_x;
+    double d_m2_y;
+    double d_c_xy;
+
+public:
+    void add(double x, double y);    //!< A sample enters the window
+    void remove(double x, double y); //!< A sample leaves the window
+    void reset();
+
+    unsigned int get_length() const; //!< Window length [samples]
+    unsigned int size() const;       //!< Samples currently in the window
+    bool full() const;
+
+    double mean_x() const;
+    double mean_y() const;
+    double var_x() const;  //!< Population variance of x
+    double var_y() const;  //!< Population variance of y
+    double cov() const;    //!< Population covariance of x and y
+    double corr() const;   //!< Pearson correlation of x and y, 0 if undefined
+
+    Sliding_Window_Accumulator(unsigned int length = 0);
+    ~Sliding_Window_Accumulator();
+};
+
+
+/*!
+ * \brief Sliding-window statistics of a scalar or paired series, evaluated
+ * simultaneously over several window lengths that share one sample history.
+ *
+ * Window i is addressed by its position in the vector of lengths given at
+ * construction. Univariate users push_back(x) and read mean(), var() and
+ * stddev(); paired series use push_back(x, y) and additionally cov() and corr().
+ */
+class Sliding_Window_Stats
+{
+private:
+    boost::circular_buffer<std::pair<double, double>> d_history;
+    std::vector<Sliding_Window_Accumulator> d_windows;
+    unsigned long int d_count;
+    unsigned int d_since_resync;
+
+    void resync();
+
+public:
+    void push_back(double x);
+    void push_back(double x, double y);
+    void clear();
+
+    unsigned int windows() const;
+    const Sliding_Window_Accumulator& window(unsigned int i) const;
+    unsigned long int count() const; //!< Samples pushed since construction or clear()
+
+    unsigned int size(unsigned int i = 0) const;
+    bool full(unsigned int i = 0) const;
+    double mean(unsigned int i = 0) const;
+    double var(unsigned int i = 0) const;
+    double stddev(unsigned int i = 0) const;
+    double cov(unsigned int i = 0) const;
+    double corr(unsigned int i = 0) const;
+
+    Sliding_Window_Stats();
+    Sliding_Window_Stats(unsigned int window_length);
+    Sliding_Window_Stats(const std::vector<unsigned int>& window_lengths);
+    ~Sliding_Window_Stats();
+};
+
+#endif
@@ -0,0 +1,331 @@
+/*!
+ * \file spoofing_capture.cc
+ * \brief Binary capture of the post-tracking receiver stream for offline
+ * replay of the spoofing detector and the PVT.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "spoofing_capture.h"
+#include <cstring>
+#include <glog/logging.h>
+
+namespace
+{
+const char SPOOFING_CAPTURE_MAGIC[8] = {'S', 'P', 'R', 'E', 'E', 'C', 'A', 'P'};
+const unsigned int SPOOFING_CAPTURE_BUFFER_SIZE = 1 << 20;
+
+template<typename T>
+void write_value(std::ofstream& file, const T& value)
+{
+    file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<typename T>
+bool read_value(std::ifstream& file, T& value)
+{
+    file.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return file.good();
+}
+
+/*
+ * Ephemeris fields in capture order. Everything the PVT and the spoofing
+ * detector read from an ephemeris record.
+ */
+template<typename Archive>
+bool ephemeris_fields(Archive& io, Gps_Ephemeris& eph)
+{
+    return io(eph.i_satellite_PRN) && io(eph.i_peak) && io(eph.uid)
+        && io(eph.d_TOW) && io(eph.d_IODE_SF2) && io(eph.d_IODE_SF3)
+        && io(eph.d_Crs) && io(eph.d_Delta_n) && io(eph.d_M_0) && io(eph.d_Cuc)
+        && io(eph.d_e_eccentricity) && io(eph.d_Cus) && io(eph.d_sqrt_A)
+        && io(eph.d_Toe) && io(eph.d_Toc) && io(eph.d_Cic) && io(eph.d_OMEGA0)
+        && io(eph.d_Cis) && io(eph.d_i_0) && io(eph.d_Crc) && io(eph.d_OMEGA)
+        && io(eph.d_OMEGA_DOT) && io(eph.d_IDOT) && io(eph.i_code_on_L2)
+        && io(eph.i_GPS_week) && io(eph.b_L2_P_data_flag) && io(eph.i_SV_accuracy)
+        && io(eph.i_SV_health) && io(eph.d_TGD) && io(eph.d_IODC) && io(eph.i_AODO)
+        && io(eph.b_fit_interval_flag) && io(eph.d_spare1) && io(eph.d_spare2)
+        && io(eph.d_A_f0) && io(eph.d_A_f1) && io(eph.d_A_f2)
+        && io(eph.b_integrity_status_flag) && io(eph.b_alert_flag) && io(eph.b_antispoofing_flag);
+}
+
+struct Field_Writer
+{
+    std::ofstream& file;
+    template<typename T> bool operator()(const T& value) { write_value(file, value); return true; }
+};
+
+struct Field_Reader
+{
+    std::ifstream& file;
+    template<typename T> bool operator()(T& value) { return read_value(file, value); }
+};
+}
+
+
+Spoofing_Capture_Writer::Spoofing_Capture_Writer()
+{
+    d_records = 0;
+}
+
+
+Spoofing_Capture_Writer::~Spoofing_Capture_Writer()
+{
+    close();
+}
+
+
+bool Spoofing_Capture_Writer::open(const std::string& filename, unsigned int nchannels)
+{
+    // large stream buffer: one epoch record is written per millisecond
+    d_buffer.resize(SPOOFING_CAPTURE_BUFFER_SIZE);
+    d_file.rdbuf()->pubsetbuf(d_buffer.data(), d_buffer.size());
+    d_file.open(filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!d_file.is_open())
+        {
+            LOG(WARNING) << "Unable to open spoofing capture file " << filename;
+            return false;
+        }
+    d_file.write(SPOOFING_CAPTURE_MAGIC, sizeof(SPOOFING_CAPTURE_MAGIC));
+    write_value(d_file, SPOOFING_CAPTURE_VERSION);
+    write_value(d_file, nchannels);
+    d_records = 0;
+    LOG(INFO) << "Spoofing capture enabled, file: " << filename;
+    return true;
+}
+
+
+bool Spoofing_Capture_Writer::is_open() const
+{
+    return d_file.is_open();
+}
+
+
+void Spoofing_Capture_Writer::write_epoch(unsigned long int sample_counter, const std::vector<Capture_Synchro>& channels)
+{
+    if (!d_file.is_open()) return;
+    write_value(d_file, static_cast<unsigned char>(CAPTURE_EPOCH));
+    write_value(d_file, sample_counter);
+    write_value(d_file, static_cast<unsigned int>(channels.size()));
+    for (std::vector<Capture_Synchro>::const_iterator it = channels.begin(); it != channels.end(); ++it)
+        {
+            write_value(d_file, it->channel);
+            write_value(d_file, it->PRN);
+            write_value(d_file, it->peak);
+            write_value(d_file, it->uid);
+            write_value(d_file, it->state);
+            write_value(d_file, it->Flag_valid_pseudorange);
+            write_value(d_file, it->CN0_dB_hz);
+            write_value(d_file, it->Carrier_Doppler_hz);
+            write_value(d_file, it->Prompt_I);
+            write_value(d_file, it->Prompt_Q);
+            write_value(d_file, it->Tracking_timestamp_secs);
+            write_value(d_file, it->d_TOW_at_current_symbol);
+            write_value(d_file, it->Pseudorange_m);
+            d_file.write(reinterpret_cast<const char*>(it->Early), sizeof(it->Early));
+            d_file.write(reinterpret_cast<const char*>(it->Prompt), sizeof(it->Prompt));
+            d_file.write(reinterpret_cast<const char*>(it->Late), sizeof(it->Late));
+        }
+    d_records++;
+}
+
+
+void Spoofing_Capture_Writer::write_subframe(const Capture_Subframe& subframe)
+{
+    if (!d_file.is_open()) return;
+    write_value(d_file, static_cast<unsigned char>(CAPTURE_SUBFRAME));
+    write_value(d_file, subframe.channel);
+    write_value(d_file, subframe.PRN);
+    write_value(d_file, subframe.peak);
+    write_value(d_file, subframe.uid);
+    write_value(d_file, subframe.timestamp_ms);
+    write_value(d_file, subframe.receiver_time_ms);
+    d_file.write(subframe.subframe, GPS_SUBFRAME_LENGTH);
+    d_records++;
+}
+
+
+void Spoofing_Capture_Writer::write_ephemeris(unsigned int key, const Gps_Ephemeris& ephemeris)
+{
+    if (!d_file.is_open()) return;
+    write_value(d_file, static_cast<unsigned char>(CAPTURE_EPHEMERIS));
+    write_value(d_file, key);
+    Gps_Ephemeris eph = ephemeris;
+    Field_Writer writer = {d_file};
+    ephemeris_fields(writer, eph);
+    d_records++;
+}
+
+
+unsigned long int Spoofing_Capture_Writer::get_records() const
+{
+    return d_records;
+}
+
+
+void Spoofing_Capture_Writer::close()
+{
+    if (d_file.is_open())
+        {
+            d_file.close();
+            LOG(INFO) << "Spoofing capture closed after " << d_records << " records";
+        }
+}
+
+
+
+Spoofing_Capture_Reader::Spoofing_Capture_Reader()
+{
+    d_nchannels = 0;
+    d_version = 0;
+    d_sample_counter = 0;
+    d_ephemeris_key = 0;
+    std::memset(&d_subframe, 0, sizeof(d_subframe));
+}
+
+
+Spoofing_Capture_Reader::~Spoofing_Capture_Reader()
+{
+    if (d_file.is_open()) d_file.close();
+}
+
+
+bool Spoofing_Capture_Reader::open(const std::string& filename)
+{
+    d_buffer.resize(SPOOFING_CAPTURE_BUFFER_SIZE);
+    d_file.rdbuf()->pubsetbuf(d_buffer.data(), d_buffer.size());
+    d_file.open(filename.c_str(), std::ios::in | std::ios::binary);
+    if (!d_file.is_open())
+        {
+            LOG(WARNING) << "Unable to open spoofing capture file " << filename;
+            return false;
+        }
+    char magic[sizeof(SPOOFING_CAPTURE_MAGIC)];
+    d_file.read(magic, sizeof(magic));
+    if (!d_file.good() || std::memcmp(magic, SPOOFING_CAPTURE_MAGIC, sizeof(magic)) != 0)
+        {
+            LOG(WARNING) << filename << " is not a spoofing capture file";
+            d_file.close();
+            return false;
+        }
+    if (!read_value(d_file, d_version) || !read_value(d_file, d_nchannels) || d_version < 1 || d_version > SPOOFING_CAPTURE_VERSION)
+        {
+            LOG(WARNING) << "Unsupported spoofing capture version " << d_version << " in " << filename;
+            d_file.close();
+            return false;
+        }
+    return true;
+}
+
+
+unsigned int Spoofing_Capture_Reader::get_nchannels() const
+{
+    return d_nchannels;
+}
+
+
+Capture_Record_Type Spoofing_Capture_Reader::next()
+{
+    unsigned char type;
+    if (!d_file.is_open() || !read_value(d_file, type))
+        {
+            return CAPTURE_END;
+        }
+    bool ok = true;
+    switch (type)
+    {
+    case CAPTURE_EPOCH:
+        {
+            unsigned int n = 0;
+            ok = read_value(d_file, d_sample_counter) && read_value(d_file, n);
+            if (ok) d_epoch.resize(n);
+            for (unsigned int i = 0; ok && i < n; i++)
+                {
+                    Capture_Synchro& s = d_epoch.at(i);
+                    ok = read_value(d_file, s.channel) && read_value(d_file, s.PRN)
+                        && read_value(d_file, s.peak) && read_value(d_file, s.uid)
+                        && read_value(d_file, s.state) && read_value(d_file, s.Flag_valid_pseudorange)
+                        && read_value(d_file, s.CN0_dB_hz) && read_value(d_file, s.Carrier_Doppler_hz)
+                        && read_value(d_file, s.Prompt_I) && read_value(d_file, s.Prompt_Q)
+                        && read_value(d_file, s.Tracking_timestamp_secs) && read_value(d_file, s.d_TOW_at_current_symbol)
+                        && read_value(d_file, s.Pseudorange_m)
+                        && read_value(d_file, s.Early) && read_value(d_file, s.Prompt) && read_value(d_file, s.Late);
+                }
+            break;
+        }
+    case CAPTURE_SUBFRAME:
+        ok = read_value(d_file, d_subframe.channel) && read_value(d_file, d_subframe.PRN)
+            && read_value(d_file, d_subframe.peak) && read_value(d_file, d_subframe.uid)
+            && read_value(d_file, d_subframe.timestamp_ms);
+        d_subframe.receiver_time_ms = -1.0;
+        if (ok && d_version >= 2) ok = read_value(d_file, d_subframe.receiver_time_ms);
+        ok = ok && read_value(d_file, d_subframe.subframe);
+        break;
+    case CAPTURE_EPHEMERIS:
+        {
+            Field_Reader reader = {d_file};
+            ok = read_value(d_file, d_ephemeris_key) && ephemeris_fields(reader, d_ephemeris);
+            break;
+        }
+    default:
+        LOG(WARNING) << "Unknown record type " << static_cast<int>(type) << " in spoofing capture";
+        ok = false;
+    }
+    if (!ok)
+        {
+            return CAPTURE_END;
+        }
+    return static_cast<Capture_Record_Type>(type);
+}
+
+
+unsigned long int Spoofing_Capture_Reader::get_sample_counter() const
+{
+    return d_sample_counter;
+}
+
+
+const std::vector<Capture_Synchro>& Spoofing_Capture_Reader::get_epoch() const
+{
+    return d_epoch;
+}
+
+
+const Capture_Subframe& Spoofing_Capture_Reader::get_subframe() const
+{
+    return d_subframe;
+}
+
+
+unsigned int Spoofing_Capture_Reader::get_ephemeris_key() const
+{
+    return d_ephemeris_key;
+}
+
+
+const Gps_Ephemeris& Spoofing_Capture_Reader::get_ephemeris() const
+{
+    return d_ephemeris;
+}
@@ -0,0 +1,154 @@
+/*!
+ * \file spoofing_capture.h
+ * \brief Binary capture of the post-tracking receiver stream (per-epoch
+ * synchro records, raw navigation subframes and ephemerides) so that the
+ * spoofing detector and the PVT can be replayed offline.
+ *
+ * File layout: an 8-byte magic "SPREECAP", a format version and the number
+ * of channels, followed by records. Each record starts with a one-byte
+ * record type (Capture_Record_Type) and its fields are written one by one in
+ * host byte order, without padding.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_SPOOFING_CAPTURE_H_
+#define GNSS_SDR_SPOOFING_CAPTURE_H_
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include "GPS_L1_CA.h"
+#include "gps_ephemeris.h"
+
+const unsigned int SPOOFING_CAPTURE_VERSION = 2;  //!< Version 1 files lack the subframe receiver time
+
+enum Capture_Record_Type
+{
+    CAPTURE_END = 0,
+    CAPTURE_EPOCH = 1,     //!< Gnss_Synchro of every channel at one PVT input sample
+    CAPTURE_SUBFRAME = 2,  //!< Raw subframe as delivered to the subframe decoder
+    CAPTURE_EPHEMERIS = 3  //!< Ephemeris as received by the PVT
+};
+
+/*!
+ * \brief The part of a channel's Gnss_Synchro that is used by the PVT and the
+ * spoofing detector
+ */
+struct Capture_Synchro
+{
+    unsigned int channel;
+    unsigned int PRN;
+    unsigned int peak;
+    unsigned int uid;
+    int state;                      //!< Channel state as reported by ChannelInterface::get_state()
+    bool Flag_valid_pseudorange;
+    double CN0_dB_hz;
+    double Carrier_Doppler_hz;
+    double Prompt_I;
+    double Prompt_Q;
+    double Tracking_timestamp_secs;
+    double d_TOW_at_current_symbol;
+    double Pseudorange_m;
+    float Early[2];                 //!< Early correlator output (real, imaginary)
+    float Prompt[2];                //!< Prompt correlator output (real, imaginary)
+    float Late[2];                  //!< Late correlator output (real, imaginary)
+};
+
+struct Capture_Subframe
+{
+    unsigned int channel;
+    unsigned int PRN;
+    unsigned int peak;
+    unsigned int uid;
+    double timestamp_ms;            //!< Preamble time of the subframe [ms]
+    double receiver_time_ms;        //!< Receiver time at which the subframe was completed [ms], -1 if unknown
+    char subframe[GPS_SUBFRAME_LENGTH];
+};
+
+
+/*!
+ * \brief Writes a spoofing capture file. Not thread safe: all records are
+ * written from the PVT block.
+ */
+class Spoofing_Capture_Writer
+{
+private:
+    std::ofstream d_file;
+    std::vector<char> d_buffer;
+    unsigned long int d_records;
+
+public:
+    bool open(const std::string& filename, unsigned int nchannels);
+    bool is_open() const;
+    void write_epoch(unsigned long int sample_counter, const std::vector<Capture_Synchro>& channels);
+    void write_subframe(const Capture_Subframe& subframe);
+    void write_ephemeris(unsigned int key, const Gps_Ephemeris& ephemeris);
+    unsigned long int get_records() const;
+    void close();
+
+    Spoofing_Capture_Writer();
+    ~Spoofing_Capture_Writer();
+};
+
+
+/*!
+ * \brief Reads a spoofing capture file record by record
+ */
+class Spoofing_Capture_Reader
+{
+private:
+    std::ifstream d_file;
+    std::vector<char> d_buffer;
+    unsigned int d_nchannels;
+    unsigned int d_version;
+
+    unsigned long int d_sample_counter;
+    std::vector<Capture_Synchro> d_epoch;
+    Capture_Subframe d_subframe;
+    unsigned int d_ephemeris_key;
+    Gps_Ephemeris d_ephemeris;
+
+public:
+    bool open(const std::string& filename);
+    unsigned int get_nchannels() const;
+
+    /*!
+     * \brief Reads the next record and returns its type, or CAPTURE_END at the
+     * end of the file or on a truncated record
+     */
+    Capture_Record_Type next();
+
+    unsigned long int get_sample_counter() const;            //!< Valid after a CAPTURE_EPOCH record
+    const std::vector<Capture_Synchro>& get_epoch() const;   //!< Valid after a CAPTURE_EPOCH record
+    const Capture_Subframe& get_subframe() const;            //!< Valid after a CAPTURE_SUBFRAME record
+    unsigned int get_ephemeris_key() const;                  //!< PRN, or uid if the capture was done with APT
+    const Gps_Ephemeris& get_ephemeris() const;              //!< Valid after a CAPTURE_EPHEMERIS record
+
+    Spoofing_Capture_Reader();
+    ~Spoofing_Capture_Reader();
+};
+
+#endif
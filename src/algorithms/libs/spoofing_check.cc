@@ -0,0 +1,311 @@
+/*!
+ * \file spoofing_check.cc
+ * \brief Interface of the spoofing checks, registry of check factories and
+ * the scheduler that runs the checks of one Spoofing_Detector.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "spoofing_check.h"
+#include <algorithm>
+#include <chrono>
+#include <glog/logging.h>
+
+using google::LogMessage;
+
+
+Spoofing_Input::Spoofing_Input(Spoofing_Input_Type input_type, double time)
+{
+    type = input_type;
+    time_ms = time;
+    detector = nullptr;
+    subframe_ID = 0;
+    PRN = 0;
+    uid = 0;
+    nav = nullptr;
+    channels = nullptr;
+    in = nullptr;
+    sample_counter = 0;
+    lat = 0.0;
+    lng = 0.0;
+    alt = 0.0;
+    x = 0.0;
+    y = 0.0;
+    z = 0.0;
+    iono = nullptr;
+    utc_model = nullptr;
+}
+
+
+Spoofing_Input_Type Spoofing_Input::subframe(int subframe_ID)
+{
+    return static_cast<Spoofing_Input_Type>(SPOOFING_INPUT_SUBFRAME_1 << (subframe_ID - 1));
+}
+
+
+Spoofing_Function_Check::Spoofing_Function_Check(const std::string& name, unsigned int inputs, double period_ms, double budget_us,
+        Spoofing_Check_Priority priority, Function function)
+{
+    d_name = name;
+    d_inputs = inputs;
+    d_period_ms = period_ms;
+    d_budget_us = budget_us;
+    d_priority = priority;
+    d_function = function;
+}
+
+
+std::string Spoofing_Function_Check::name() const
+{
+    return d_name;
+}
+
+
+unsigned int Spoofing_Function_Check::inputs() const
+{
+    return d_inputs;
+}
+
+
+double Spoofing_Function_Check::period_ms() const
+{
+    return d_period_ms;
+}
+
+
+double Spoofing_Function_Check::budget_us() const
+{
+    return d_budget_us;
+}
+
+
+Spoofing_Check_Priority Spoofing_Function_Check::priority() const
+{
+    return d_priority;
+}
+
+
+void Spoofing_Function_Check::run(const Spoofing_Input& input)
+{
+    d_function(input);
+}
+
+
+Spoofing_Check_Registry& Spoofing_Check_Registry::instance()
+{
+    static Spoofing_Check_Registry registry;
+    return registry;
+}
+
+
+void Spoofing_Check_Registry::add(const std::string& name, Factory factory)
+{
+    d_factories[name] = factory;
+}
+
+
+std::shared_ptr<Spoofing_Check_Interface> Spoofing_Check_Registry::create(const std::string& name, ConfigurationInterface* configuration) const
+{
+    std::map<std::string, Factory>::const_iterator it = d_factories.find(name);
+    if (it == d_factories.end())
+        {
+            return std::shared_ptr<Spoofing_Check_Interface>();
+        }
+    return it->second(configuration);
+}
+
+
+std::vector<std::string> Spoofing_Check_Registry::names() const
+{
+    std::vector<std::string> names;
+    for (std::map<std::string, Factory>::const_iterator it = d_factories.begin(); it != d_factories.end(); ++it)
+        {
+            names.push_back(it->first);
+        }
+    return names;
+}
+
+
+Spoofing_Check_Scheduler::Spoofing_Check_Scheduler()
+{
+    d_cpu_share = 0.05;
+    d_shed_period_ms = 6000.0;
+    d_max_backoff = 64;
+    d_window_ms = 1000.0;
+    d_window_start_ms = -1.0;
+    d_window_cpu_us = 0.0;
+    d_overloaded = false;
+}
+
+
+void Spoofing_Check_Scheduler::configure(double cpu_share, double shed_period_ms, unsigned int max_backoff, double window_ms)
+{
+    d_cpu_share = cpu_share;
+    d_shed_period_ms = shed_period_ms;
+    d_max_backoff = std::max(max_backoff, 1u);
+    d_window_ms = window_ms > 0.0 ? window_ms : 1000.0;
+}
+
+
+void Spoofing_Check_Scheduler::add(std::shared_ptr<Spoofing_Check_Interface> check)
+{
+    if (!check) return;
+    Entry entry;
+    entry.check = check;
+    entry.last_run_ms = 0.0;
+    entry.has_run = false;
+    entry.cost_us = 0.0;
+    entry.backoff = 1;
+    entry.runs = 0;
+    entry.skipped = 0;
+    d_entries.push_back(entry);
+}
+
+
+bool Spoofing_Check_Scheduler::is_due(const Entry& entry, double time_ms) const
+{
+    if (entry.check->priority() == SPOOFING_CHECK_ESSENTIAL || !entry.has_run)
+        {
+            return true;
+        }
+    double period = entry.check->period_ms();
+    if (entry.backoff > 1)
+        {
+            period = std::max(period, d_shed_period_ms) * entry.backoff;
+        }
+    // a receiver time going backwards (new run, replay) restarts the schedule
+    return time_ms < entry.last_run_ms || time_ms - entry.last_run_ms >= period;
+}
+
+
+unsigned int Spoofing_Check_Scheduler::dispatch(const Spoofing_Input& input)
+{
+    if (d_window_start_ms < 0.0 || input.time_ms < d_window_start_ms)
+        {
+            d_window_start_ms = input.time_ms;
+            d_window_cpu_us = 0.0;
+        }
+    else if (input.time_ms - d_window_start_ms >= d_window_ms)
+        {
+            end_window(input.time_ms);
+        }
+
+    unsigned int ran = 0;
+    for (std::vector<Entry>::iterator it = d_entries.begin(); it != d_entries.end(); ++it)
+        {
+            if ((it->check->inputs() & input.type) == 0)
+                {
+                    continue;
+                }
+            if (!is_due(*it, input.time_ms))
+                {
+                    it->skipped++;
+                    continue;
+                }
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            it->check->run(input);
+            double cost_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+            // exponential average over about 8 runs
+            it->cost_us = it->runs == 0 ? cost_us : it->cost_us + (cost_us - it->cost_us) / 8.0;
+            it->runs++;
+            it->has_run = true;
+            it->last_run_ms = input.time_ms;
+            d_window_cpu_us += cost_us;
+            ran++;
+
+            if (it->check->priority() == SPOOFING_CHECK_SHEDDABLE)
+                {
+                    if (it->cost_us > it->check->budget_us() && it->backoff < d_max_backoff)
+                        {
+                            it->backoff *= 2;
+                            DLOG(INFO) << "Spoofing check " << it->check->name() << " over budget (" << it->cost_us
+                                       << " us), period x" << it->backoff;
+                        }
+                    else if (it->cost_us <= it->check->budget_us() / 2.0 && it->backoff > 1 && !d_overloaded)
+                        {
+                            it->backoff /= 2;
+                        }
+                }
+        }
+    return ran;
+}
+
+
+void Spoofing_Check_Scheduler::end_window(double time_ms)
+{
+    double elapsed_us = (time_ms - d_window_start_ms) * 1e3;
+    double share = elapsed_us > 0.0 ? d_window_cpu_us / elapsed_us : 0.0;
+    bool overloaded = share > d_cpu_share;
+    if (overloaded != d_overloaded)
+        {
+            LOG(INFO) << "Spoofing checks " << (overloaded ? "above" : "back under") << " their CPU share: "
+                      << share * 100.0 << " % of receiver time";
+        }
+    for (std::vector<Entry>::iterator it = d_entries.begin(); it != d_entries.end(); ++it)
+        {
+            if (it->check->priority() != SPOOFING_CHECK_SHEDDABLE) continue;
+            if (overloaded && it->backoff < d_max_backoff)
+                {
+                    it->backoff *= 2;
+                }
+            else if (share < d_cpu_share / 2.0 && it->backoff > 1 && it->cost_us <= it->check->budget_us())
+                {
+                    it->backoff /= 2;
+                }
+        }
+    d_overloaded = overloaded;
+    d_window_start_ms = time_ms;
+    d_window_cpu_us = 0.0;
+}
+
+
+std::vector<Spoofing_Check_Scheduler::Status> Spoofing_Check_Scheduler::get_status() const
+{
+    std::vector<Status> status;
+    for (std::vector<Entry>::const_iterator it = d_entries.begin(); it != d_entries.end(); ++it)
+        {
+            Status s;
+            s.name = it->check->name();
+            s.runs = it->runs;
+            s.skipped = it->skipped;
+            s.cost_us = it->cost_us;
+            s.backoff = it->backoff;
+            status.push_back(s);
+        }
+    return status;
+}
+
+
+bool Spoofing_Check_Scheduler::is_overloaded() const
+{
+    return d_overloaded;
+}
+
+
+size_t Spoofing_Check_Scheduler::size() const
+{
+    return d_entries.size();
+}
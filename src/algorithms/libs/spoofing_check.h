@@ -0,0 +1,250 @@
+/*!
+ * \file spoofing_check.h
+ * \brief Interface of the spoofing checks, registry of check factories and
+ * the scheduler that runs the checks of one Spoofing_Detector.
+ *
+ * A check declares the inputs it consumes (subframes by ID, tracking epochs,
+ * positions, satellite positions, ionospheric and UTC data), the minimum
+ * receiver time between two runs, a CPU budget per run and whether it may be
+ * shed under load. The scheduler measures the cost of every run and slows
+ * sheddable checks down, by doubling their period, when they exceed their
+ * budget or when all checks together exceed the CPU share of the detector.
+ *
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_SPOOFING_CHECK_H_
+#define GNSS_SDR_SPOOFING_CHECK_H_
+
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+class ConfigurationInterface;
+class Gnss_Synchro;
+class Gps_Iono;
+class Gps_Navigation_Message;
+class Gps_Utc_Model;
+class Spoofing_Detector;
+
+/*!
+ * \brief Inputs of the spoofing checks, as bits of Spoofing_Check_Interface::inputs()
+ */
+enum Spoofing_Input_Type
+{
+    SPOOFING_INPUT_SUBFRAME_1 = 1 << 0,
+    SPOOFING_INPUT_SUBFRAME_2 = 1 << 1,
+    SPOOFING_INPUT_SUBFRAME_3 = 1 << 2,
+    SPOOFING_INPUT_SUBFRAME_4 = 1 << 3,
+    SPOOFING_INPUT_SUBFRAME_5 = 1 << 4,
+    SPOOFING_INPUT_SUBFRAMES = 0x1F,    //!< Any subframe
+    SPOOFING_INPUT_EPOCH = 1 << 5,      //!< Tracking outputs of the channels used by the PVT
+    SPOOFING_INPUT_POSITION = 1 << 6,   //!< Receiver position
+    SPOOFING_INPUT_SATPOS = 1 << 7,     //!< Satellite position
+    SPOOFING_INPUT_IONO = 1 << 8,       //!< Decoded ionospheric model
+    SPOOFING_INPUT_UTC = 1 << 9         //!< Decoded UTC model
+};
+
+/*!
+ * \brief One input handed to the checks. Only the fields of \a type are set.
+ */
+struct Spoofing_Input
+{
+    Spoofing_Input_Type type;
+    double time_ms;                        //!< Receiver time of the input [ms]
+    Spoofing_Detector* detector;           //!< Detector that dispatches the input
+
+    // subframes
+    int subframe_ID;
+    int PRN;
+    unsigned int uid;
+    Gps_Navigation_Message* nav;
+
+    // epochs
+    const std::list<unsigned int>* channels;
+    Gnss_Synchro** in;
+    int sample_counter;
+
+    // positions
+    double lat;
+    double lng;
+    double alt;
+    double x;
+    double y;
+    double z;
+
+    // ionospheric and UTC models
+    const Gps_Iono* iono;
+    const Gps_Utc_Model* utc_model;
+
+    Spoofing_Input(Spoofing_Input_Type input_type, double time);
+    static Spoofing_Input_Type subframe(int subframe_ID);  //!< Input type of a subframe ID (1 to 5)
+};
+
+
+/*!
+ * \brief Whether the scheduler may slow a check down under load
+ */
+enum Spoofing_Check_Priority
+{
+    SPOOFING_CHECK_ESSENTIAL,  //!< Runs on every input it consumes
+    SPOOFING_CHECK_SHEDDABLE   //!< Runs at a reduced rate when over budget
+};
+
+
+/*!
+ * \brief A spoofing check. Checks are shared by all the copies of a detector,
+ * so they keep their state in the detector, not in the check.
+ */
+class Spoofing_Check_Interface
+{
+public:
+    virtual ~Spoofing_Check_Interface() {}
+    virtual std::string name() const = 0;
+    virtual unsigned int inputs() const = 0;        //!< OR of Spoofing_Input_Type
+    virtual double period_ms() const = 0;           //!< Minimum receiver time between runs [ms], 0 for every input
+    virtual double budget_us() const = 0;           //!< CPU budget per run [us]
+    virtual Spoofing_Check_Priority priority() const = 0;
+    virtual void run(const Spoofing_Input& input) = 0;
+};
+
+
+/*!
+ * \brief Check defined by a function, used for the built-in checks of Spoofing_Detector
+ */
+class Spoofing_Function_Check : public Spoofing_Check_Interface
+{
+public:
+    typedef std::function<void(const Spoofing_Input&)> Function;
+
+    Spoofing_Function_Check(const std::string& name, unsigned int inputs, double period_ms, double budget_us,
+            Spoofing_Check_Priority priority, Function function);
+
+    std::string name() const;
+    unsigned int inputs() const;
+    double period_ms() const;
+    double budget_us() const;
+    Spoofing_Check_Priority priority() const;
+    void run(const Spoofing_Input& input);
+
+private:
+    std::string d_name;
+    unsigned int d_inputs;
+    double d_period_ms;
+    double d_budget_us;
+    Spoofing_Check_Priority d_priority;
+    Function d_function;
+};
+
+
+/*!
+ * \brief Factories of additional checks by name. A check is added with an
+ * explicit call to add() in code that runs before the Spoofing_Detector is
+ * built (as Spoofing_Detector::register_checks registers the built-in
+ * ones), and is enabled by listing its name in Spoofing.checks. Static
+ * self-registration is not used: the linker drops such objects from the
+ * static libraries of the receiver when nothing else refers to them.
+ */
+class Spoofing_Check_Registry
+{
+public:
+    typedef std::function<std::shared_ptr<Spoofing_Check_Interface>(ConfigurationInterface*)> Factory;
+
+    static Spoofing_Check_Registry& instance();
+    void add(const std::string& name, Factory factory);
+    std::shared_ptr<Spoofing_Check_Interface> create(const std::string& name, ConfigurationInterface* configuration) const;
+    std::vector<std::string> names() const;
+
+private:
+    std::map<std::string, Factory> d_factories;
+    Spoofing_Check_Registry() {}
+};
+
+/*!
+ * \brief Runs the registered checks on each input, within their rates and budgets.
+ *
+ * Cost is measured per run and averaged. A sheddable check whose average cost
+ * exceeds its budget has its period doubled (up to max_backoff times, with
+ * shed_period_ms as the base period of checks that run on every input), and
+ * halved again once it is back under budget. Every window of receiver time
+ * the total CPU time of the checks is compared to cpu_share of that window:
+ * above it all sheddable checks back off, below half of it they speed up.
+ */
+class Spoofing_Check_Scheduler
+{
+public:
+    struct Status
+    {
+        std::string name;
+        unsigned long int runs;
+        unsigned long int skipped;
+        double cost_us;          //!< Average cost per run [us]
+        unsigned int backoff;    //!< Current period multiplier
+    };
+
+    void add(std::shared_ptr<Spoofing_Check_Interface> check);
+    void configure(double cpu_share, double shed_period_ms, unsigned int max_backoff, double window_ms);
+
+    /*!
+     * \brief Runs the checks that consume \a input and are due. Returns the number of checks run.
+     */
+    unsigned int dispatch(const Spoofing_Input& input);
+
+    std::vector<Status> get_status() const;
+    bool is_overloaded() const;
+    size_t size() const;
+
+    Spoofing_Check_Scheduler();
+
+private:
+    struct Entry
+    {
+        std::shared_ptr<Spoofing_Check_Interface> check;
+        double last_run_ms;
+        bool has_run;
+        double cost_us;
+        unsigned int backoff;
+        unsigned long int runs;
+        unsigned long int skipped;
+    };
+
+    std::vector<Entry> d_entries;
+    double d_cpu_share;
+    double d_shed_period_ms;
+    unsigned int d_max_backoff;
+    double d_window_ms;
+    double d_window_start_ms;
+    double d_window_cpu_us;
+    bool d_overloaded;
+
+    bool is_due(const Entry& entry, double time_ms) const;
+    void end_window(double time_ms);
+};
+
+#endif
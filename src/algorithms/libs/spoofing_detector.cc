@@ -37,11 +37,12 @@
 #include "control_message_factory.h"
 #include "concurrent_map.h"
 #include "concurrent_map_str.h"
-#include "concurrent_queue.h"
+#include "concurrent_ring.h"
+#include "spoofing_stats.h"
 #include <cmath>
 #include <numeric>
+#include <algorithm>
 #include <iomanip>
-#include "gnss_sdr_supl_client.h"
 #include <chrono>
 #include <iomanip>
 
@@ -62,7 +63,7 @@ const int seconds_per_week = 604800;
 /*!
  *  Contains all spoofing alarms.
  */
-extern concurrent_queue<Spoofing_Message> global_spoofing_queue;
+extern concurrent_ring<Spoofing_Message> global_spoofing_queue;
 
 /*!
  *   Contains the last received GPS time
@@ -90,6 +91,19 @@ struct GPS_time_t{
  *   Contains the latest received GPS time of all currently tracked channels. 
  */
 extern concurrent_map<GPS_time_t> global_gps_time;
+
+/*!
+ *  Receiver time of the first of the last \a length samples in \a epochs, -1 if
+ *  fewer have been collected.
+ */
+static double window_start(const boost::circular_buffer<double>& epochs, unsigned int length)
+{
+    if(length == 0 || epochs.size() < length)
+        {
+            return -1.0;
+        }
+    return epochs[epochs.size() - length];
+}
 /*!
  *  For each unique peak that is being tracked this maps it to all other peaks
  *  that it has been compared to i.e., has been tested for spoofing against. 
@@ -99,7 +113,11 @@ extern concurrent_map<GPS_time_t> global_gps_time;
 using google::LogMessage;
 Spoofing_Detector::Spoofing_Detector()
 {
-
+    d_stats_period_ms = 1000;
+    d_stats_http_port = 0;
+    d_event_min_interval_ms = 1000.0;
+    d_event_flush_period_ms = 500;
+    d_params.set_role("Spoofing");
 }
 
 Spoofing_Detector::Spoofing_Detector(ConfigurationInterface* configuration)
@@ -117,7 +135,17 @@ Spoofing_Detector::Spoofing_Detector(ConfigurationInterface* configuration)
     d_PPE = PPE;
     int PPE_window_size = configuration->property("Spoofing.PPE_window_size", 50);
     d_PPE_window_size = PPE_window_size;
-    ppe_cb = boost::circular_buffer<double> (d_PPE_window_size);
+    ppe_cb = Sliding_Window_Stats(d_PPE_window_size);
+    d_SNR_epochs.set_capacity(d_PPE_window_size);
+    //optional second, longer window watched together with PPE_window_size, 0 disables it
+    int PPE_long_window_size = configuration->property("Spoofing.PPE_long_window_size", 0);
+    d_PPE_long_window_size = PPE_long_window_size;
+    d_PPE_windows.push_back(d_PPE_window_size);
+    if(d_PPE_long_window_size > d_PPE_window_size)
+        {
+            d_PPE_windows.push_back(d_PPE_long_window_size);
+        }
+    d_PPE_epochs.set_capacity(d_PPE_windows.back());
 
     double  PPE_sampling = configuration->property("Spoofing.PPE_sampling", 1e3);
     d_PPE_sampling = PPE_sampling;
@@ -143,6 +171,7 @@ Spoofing_Detector::Spoofing_Detector(ConfigurationInterface* configuration)
     d_NAVI_max_alt = NAVI_max_alt;
 
     d_NAVI_exp_eph = configuration->property("Spoofing.NAVI_exp_eph", false);
+    d_params.set_role("Spoofing");
     //Ephemeris thresholds
     //Subframe 1
     d_A_f0 = configuration->property("Spoofing.A_f0", 0.0011874);
@@ -171,7 +200,34 @@ Spoofing_Detector::Spoofing_Detector(ConfigurationInterface* configuration)
     //sampling freq, to get timestamp from sample counter
     double fs_in = configuration->property("GNSS-SDR.internal_fs_hz", 2048000);
     d_fs_in = fs_in;
-    
+
+    //capture of synchro records, subframes and ephemerides for offline replay
+    d_capture_filename = configuration->property("Spoofing.capture_filename", std::string(""));
+
+    //statistics of the checks: JSON dump every stats_period_ms, UNIX socket and HTTP port on 127.0.0.1
+    d_stats_filename = configuration->property("Spoofing.stats_filename", std::string(""));
+    d_stats_period_ms = configuration->property("Spoofing.stats_period_ms", 1000);
+    d_stats_socket = configuration->property("Spoofing.stats_socket", std::string(""));
+    d_stats_http_port = configuration->property("Spoofing.stats_http_port", 0);
+
+    //spoofing event log: fold identical alarms raised less than event_min_interval_ms apart
+    d_event_min_interval_ms = configuration->property("Spoofing.event_min_interval_ms", 1000.0);
+    d_event_flush_period_ms = configuration->property("Spoofing.event_flush_period_ms", 500);
+
+    //reference data for the external checks, fetched in the background and shared by all detectors
+    if( d_NAVI_external )
+        {
+            std::shared_ptr<Spoofing_External_Source> source = Spoofing_External_Source::create(configuration);
+            double refresh_s = configuration->property("Spoofing.external_refresh_s", 900.0);
+            double max_age_s = configuration->property("Spoofing.external_max_age_s", 7200.0);
+            double retry_s = configuration->property("Spoofing.external_retry_s", 30.0);
+            if (Spoofing_External_Nav::instance().start(source, refresh_s, max_age_s, retry_s))
+                {
+                    d_external = Spoofing_External_Requests(&Spoofing_External_Nav::instance());
+                }
+        }
+
+    register_checks(configuration);
 }
 
 Spoofing_Detector::~Spoofing_Detector()
@@ -196,13 +252,196 @@ void Spoofing_Detector::spoofing_detected(Spoofing_Message msg)
     std::cout << s.str();
     DLOG(INFO) << sp << " " << description;
 
-    global_spoofing_queue.push(msg);
+    Spoofing_Check_Scope::alarm(msg);
+
+    if (!global_spoofing_queue.push(msg))
+        {
+            // alarm storm: the PVT drains the queue once per epoch, never block the caller
+            LOG_EVERY_N(WARNING, 100) << "Spoofing message queue full, " << global_spoofing_queue.dropped() << " alarms dropped";
+        }
     for(std::set<unsigned int>::iterator it = msg.satellites.begin(); it != msg.satellites.end(); it++)
         {
             global_spoofing_status.add(*it, 1);
         }
 }
 
+
+void Spoofing_Detector::raise_alarm(const Spoofing_Message& msg)
+{
+    spoofing_detected(msg);
+}
+
+
+/*!
+ *  Applies the Spoofing.* values published with Gnss_Sdr_Runtime_Params since
+ *  the last call. Called by the owning block from its own work thread, so the
+ *  thresholds never change in the middle of a check.
+ */
+bool Spoofing_Detector::update_parameters()
+{
+    if (!d_params.changed())
+        {
+            return false;
+        }
+    double value;
+    bool flag;
+    if (d_params.get("CN0_threshold", value)) d_CN0_threshold = value;
+    if (d_params.get("RT_threshold", value)) d_RT_threshold = value;
+    if (d_params.get("Delta_threshold", value)) d_Delta_threshold = value;
+    if (d_params.get("APT_max_rx_discrepancy", value)) d_APT_max_rx_discrepancy = value / 1e6; //in [ms]
+    if (d_params.get("NAVI_TOW_max_discrepancy", value)) d_NAVI_TOW_max_discrepancy = value;
+    if (d_params.get("NAVI_max_alt", value)) d_NAVI_max_alt = value;
+    if (d_params.get("PPE", flag)) d_PPE = flag;
+    if (d_params.get("NAVI_TOW", flag)) d_NAVI_TOW = flag;
+    if (d_params.get("NAVI_inter_satellite", flag)) d_NAVI_inter_satellite = flag;
+    if (d_params.get("NAVI_alt", flag)) d_NAVI_alt = flag;
+    return true;
+}
+
+
+/*!
+ *  Adds a built-in check to the scheduler. Spoofing.<name>.period_ms and
+ *  Spoofing.<name>.budget_us override its default rate and CPU budget.
+ */
+void Spoofing_Detector::add_check(ConfigurationInterface* configuration, const std::string& name, unsigned int inputs,
+        double period_ms, double budget_us, Spoofing_Check_Priority priority, Spoofing_Function_Check::Function function)
+{
+    period_ms = configuration->property("Spoofing." + name + ".period_ms", period_ms);
+    budget_us = configuration->property("Spoofing." + name + ".budget_us", budget_us);
+    d_scheduler.add(std::make_shared<Spoofing_Function_Check>(name, inputs, period_ms, budget_us, priority, function));
+}
+
+
+/*!
+ *  Registers the built-in checks and those listed in the configuration. The
+ *  checks are shared by the copies of the detector and reach its state through
+ *  Spoofing_Input::detector. Every built-in check is registered and tests its
+ *  switch on each run, so that the switches changed with update_parameters()
+ *  take effect. Cheap consistency checks are essential, checks that compare
+ *  with external sources or whole almanacs may be run less often under load.
+ */
+void Spoofing_Detector::register_checks(ConfigurationInterface* configuration)
+{
+    d_scheduler.configure(configuration->property("Spoofing.check_cpu_share", 0.05),
+            configuration->property("Spoofing.check_shed_period_ms", 6000.0),
+            configuration->property("Spoofing.check_max_backoff", 64),
+            1000.0);
+
+    add_check(configuration, "apt", SPOOFING_INPUT_SUBFRAMES, 0, 500, SPOOFING_CHECK_ESSENTIAL,
+            [](const Spoofing_Input& input)
+            {
+                if (!input.detector->d_APT) return;
+                input.detector->check_RX_time(input.PRN);
+                input.detector->check_APT_subframe(input.uid, input.subframe_ID);
+            });
+    add_check(configuration, "gps_time", SPOOFING_INPUT_SUBFRAMES, 0, 200, SPOOFING_CHECK_ESSENTIAL,
+            [](const Spoofing_Input& input)
+            {
+                if (!input.detector->d_NAVI_inter_satellite) return;
+                input.detector->check_GPS_time();
+            });
+    add_check(configuration, "tow", SPOOFING_INPUT_SUBFRAMES, 0, 100, SPOOFING_CHECK_ESSENTIAL,
+            [](const Spoofing_Input& input)
+            {
+                if (!input.detector->d_NAVI_TOW) return;
+                input.detector->check_new_TOW(input.time_ms, input.nav->get_week(), static_cast<int>(input.nav->get_TOW()));
+            });
+    add_check(configuration, "external_gps_time", SPOOFING_INPUT_SUBFRAME_1, 0, 2000, SPOOFING_CHECK_SHEDDABLE,
+            [](const Spoofing_Input& input)
+            {
+                if (!input.detector->d_NAVI_external) return;
+                input.detector->check_external_gps_time(input.nav->get_week(), static_cast<int>(input.nav->get_TOW()), input.time_ms);
+            });
+    add_check(configuration, "middle_earth", SPOOFING_INPUT_SUBFRAME_2, 0, 50, SPOOFING_CHECK_ESSENTIAL,
+            [](const Spoofing_Input& input)
+            {
+                if (!input.detector->d_PPE) return;
+                input.detector->check_middle_earth(input.PRN, input.nav->get_sqrtA(), input.time_ms);
+            });
+    add_check(configuration, "expected_ephemeris", SPOOFING_INPUT_SUBFRAME_3, 0, 500, SPOOFING_CHECK_ESSENTIAL,
+            [](const Spoofing_Input& input)
+            {
+                if (!input.detector->d_NAVI_exp_eph) return;
+                if (input.nav->satellite_validation())
+                    {
+                        input.detector->check_and_update_ephemeris(input.PRN, input.nav->get_ephemeris(), input.time_ms);
+                    }
+            });
+    add_check(configuration, "external_ephemeris", SPOOFING_INPUT_SUBFRAME_3, 0, 2000, SPOOFING_CHECK_SHEDDABLE,
+            [](const Spoofing_Input& input)
+            {
+                if (!input.detector->d_NAVI_external) return;
+                if (input.nav->satellite_validation())
+                    {
+                        input.detector->check_external_ephemeris(input.nav->get_ephemeris(), input.PRN, input.time_ms);
+                    }
+            });
+    add_check(configuration, "inter_satellite_subframe", SPOOFING_INPUT_SUBFRAME_4 | SPOOFING_INPUT_SUBFRAME_5, 0, 500,
+            SPOOFING_CHECK_ESSENTIAL,
+            [](const Spoofing_Input& input)
+            {
+                if (!input.detector->d_NAVI_inter_satellite) return;
+                input.detector->check_inter_satellite_subframe(input.uid, input.subframe_ID);
+            });
+    add_check(configuration, "external_almanac", SPOOFING_INPUT_SUBFRAME_4 | SPOOFING_INPUT_SUBFRAME_5, 0, 2000,
+            SPOOFING_CHECK_SHEDDABLE,
+            [](const Spoofing_Input& input)
+            {
+                if (!input.detector->d_NAVI_external) return;
+                input.detector->check_external_almanac(input.nav->get_almanac(), input.time_ms);
+            });
+    add_check(configuration, "ppe", SPOOFING_INPUT_EPOCH, 0, 1000, SPOOFING_CHECK_ESSENTIAL,
+            [](const Spoofing_Input& input)
+            {
+                if (!input.detector->d_PPE) return;
+                input.detector->do_PPE_moving_var(*input.channels, input.in, input.sample_counter);
+            });
+    // do_check_position(), do_check_external_iono() and do_check_external_utc() test their own switches
+    add_check(configuration, "position", SPOOFING_INPUT_POSITION, 0, 50, SPOOFING_CHECK_ESSENTIAL,
+            [](const Spoofing_Input& input) { input.detector->do_check_position(input.alt, input.time_ms); });
+    add_check(configuration, "satpos", SPOOFING_INPUT_SATPOS, 0, 50, SPOOFING_CHECK_ESSENTIAL,
+            [](const Spoofing_Input& input)
+            {
+                input.detector->do_check_satpos(input.PRN, input.time_ms, input.x, input.y, input.z);
+            });
+    add_check(configuration, "external_iono", SPOOFING_INPUT_IONO, 0, 2000, SPOOFING_CHECK_SHEDDABLE,
+            [](const Spoofing_Input& input) { input.detector->do_check_external_iono(*input.iono, input.time_ms); });
+    add_check(configuration, "external_utc", SPOOFING_INPUT_UTC, 0, 2000, SPOOFING_CHECK_SHEDDABLE,
+            [](const Spoofing_Input& input) { input.detector->do_check_external_utc(*input.utc_model, input.time_ms); });
+
+    //additional checks added to Spoofing_Check_Registry, by name
+    std::stringstream names(configuration->property("Spoofing.checks", std::string("")));
+    std::string name;
+    while (std::getline(names, name, ','))
+        {
+            name.erase(0, name.find_first_not_of(" \t"));
+            name.erase(name.find_last_not_of(" \t") + 1);
+            if (name.empty()) continue;
+            std::shared_ptr<Spoofing_Check_Interface> check = Spoofing_Check_Registry::instance().create(name, configuration);
+            if (check)
+                {
+                    d_scheduler.add(check);
+                }
+            else
+                {
+                    LOG(WARNING) << "Unknown spoofing check " << name;
+                }
+        }
+    LOG(INFO) << "Spoofing detector runs " << d_scheduler.size() << " checks";
+}
+
+
+void Spoofing_Detector::register_check(std::shared_ptr<Spoofing_Check_Interface> check)
+{
+    d_scheduler.add(check);
+}
+
+
+std::vector<Spoofing_Check_Scheduler::Status> Spoofing_Detector::get_check_status() const
+{
+    return d_scheduler.get_status();
+}
+
 int Spoofing_Detector::get_APT()
 {
     return d_APT;
@@ -213,19 +452,67 @@ double Spoofing_Detector::get_PPE_sampling()
     return d_PPE_sampling;
 }
 
+std::string Spoofing_Detector::get_capture_filename()
+{
+    return d_capture_filename;
+}
+
+std::string Spoofing_Detector::get_stats_filename()
+{
+    return d_stats_filename;
+}
+
+int Spoofing_Detector::get_stats_period_ms()
+{
+    return d_stats_period_ms;
+}
+
+std::string Spoofing_Detector::get_stats_socket()
+{
+    return d_stats_socket;
+}
+
+int Spoofing_Detector::get_stats_http_port()
+{
+    return d_stats_http_port;
+}
+
+double Spoofing_Detector::get_event_min_interval_ms()
+{
+    return d_event_min_interval_ms;
+}
+
+int Spoofing_Detector::get_event_flush_period_ms()
+{
+    return d_event_flush_period_ms;
+}
+
 /*! 
  *  Check that the estimated receiver position has normal values, that is is non negative and 
  *  below the configurable value alt 
  */
 void Spoofing_Detector::check_position(double lat, double lng, double alt, double sample_counter) 
 {
-    if(~d_NAVI_alt)
+    Spoofing_Check_Scope scope(SPOOFING_CHECK_POSITION, sample_counter);
+    Spoofing_Input input(SPOOFING_INPUT_POSITION, sample_counter);
+    input.detector = this;
+    input.lat = lat;
+    input.lng = lng;
+    input.alt = alt;
+    d_scheduler.dispatch(input);
+}
+
+
+void Spoofing_Detector::do_check_position(double alt, double sample_counter)
+{
+    if(!d_NAVI_alt)
         return;
 
     Spoofing_Message msg;
     msg.spoofing_case = 4;
     std::set<unsigned int> sats = {};
     msg.satellites = sats;
+    msg.evidence_time_ms = sample_counter; // the fix of this epoch
     if(alt < 0)
         {
             std::stringstream s;
@@ -234,6 +521,9 @@ void Spoofing_Detector::check_position(double lat, double lng, double alt, doubl
             sr << "At " << sample_counter/(d_fs_in*1e3) << " the height of the calculated position was negative. The height was " << alt << " km.\n";
             msg.description = s.str();
             msg.spoofing_report = sr.str();
+            msg.metric = "height";
+            msg.value = alt;
+            msg.threshold = 0;
             spoofing_detected(msg);
         }
     else if(alt > d_NAVI_max_alt)
@@ -245,6 +535,9 @@ void Spoofing_Detector::check_position(double lat, double lng, double alt, doubl
                << " km. SPREE is configured to raise an alarm if the altitude goes above " << d_NAVI_max_alt << ".\n";
             msg.description = s.str();
             msg.spoofing_report = sr.str();
+            msg.metric = "height";
+            msg.value = alt;
+            msg.threshold = d_NAVI_max_alt;
             spoofing_detected(msg);
         }
 }
@@ -256,6 +549,7 @@ void Spoofing_Detector::check_position(double lat, double lng, double alt, doubl
  */
 void Spoofing_Detector::check_new_TOW(double current_timestamp_ms, int new_week, double new_TOW)
 {
+    Spoofing_Check_Scope scope(SPOOFING_CHECK_NEW_TOW);
     if( new_TOW == 0 )
         return;
 
@@ -298,6 +592,10 @@ void Spoofing_Detector::check_new_TOW(double current_timestamp_ms, int new_week,
                 msg.satellites = sats;
                 msg.description = s.str();
                 msg.spoofing_report = sr.str();
+                msg.evidence_time_ms = current_timestamp_ms;
+                msg.metric = "TOW_discrepancy";
+                msg.value = std::abs(std::abs(new_gps_time-old_gps_time)-duration);
+                msg.threshold = d_NAVI_TOW_max_discrepancy;
                 spoofing_detected(msg);
             }
     }
@@ -313,16 +611,20 @@ void Spoofing_Detector::check_new_TOW(double current_timestamp_ms, int new_week,
  */
 void Spoofing_Detector::check_and_update_ephemeris(unsigned int PRN, Gps_Ephemeris eph, double time)
 { 
+    Spoofing_Check_Scope scope(SPOOFING_CHECK_EXPECTED_EPHEMERIS);
     std::map<int, sEph> sat_eph = global_sEph_map.get_map_copy();
     sEph new_eph;
     new_eph.time = time;
     new_eph.ephemeris = eph;
+    new_eph.digest = gps_ephemeris_digest(eph, true);
+    new_eph.changed = false;
 
     if(sat_eph.count(PRN))
     {
 
         sEph old_ephemeris  = sat_eph.at(PRN); 
-        bool the_same = compare_ephemeris_dTOW(eph, old_ephemeris.ephemeris);
+        // the field-level comparison only runs when the digests differ, to log what changed
+        bool the_same = (new_eph.digest == old_ephemeris.digest) || compare_ephemeris_dTOW(eph, old_ephemeris.ephemeris);
         if(the_same)
             return;
 
@@ -330,6 +632,7 @@ void Spoofing_Detector::check_and_update_ephemeris(unsigned int PRN, Gps_Ephemer
         msg.spoofing_case = 5;
         std::set<unsigned int> sats = {PRN};
         msg.satellites = sats;
+        msg.evidence_time_ms = time; // the subframe that completed the new ephemeris
         
         double TWO_HOURS_MS = 2*60*60*1000; //2 hours in ms 
         double TEN_MIN_MS= 10*60*1000; //10 min in ms 
@@ -576,6 +879,7 @@ void Spoofing_Detector::check_and_update_ephemeris(unsigned int PRN, Gps_Ephemer
  */
 void Spoofing_Detector::check_middle_earth(unsigned int PRN, double sqrtA, double timestamp)
 { 
+    Spoofing_Check_Scope scope(SPOOFING_CHECK_MIDDLE_EARTH);
     if(sqrtA == 0)
     {
         std::stringstream s;
@@ -586,6 +890,7 @@ void Spoofing_Detector::check_middle_earth(unsigned int PRN, double sqrtA, doubl
         msg.spoofing_case = 5;
         std::set<unsigned int> sats = {PRN};
         msg.satellites = sats;
+        msg.evidence_time_ms = timestamp;
         msg.description = s.str();
         msg.spoofing_report = sr.str();
         spoofing_detected(msg);
@@ -598,6 +903,20 @@ void Spoofing_Detector::check_middle_earth(unsigned int PRN, double sqrtA, doubl
  *  possible given the satellites speed given that the receiver is moving at a "normal" speed.
  */
 void Spoofing_Detector::check_satpos(unsigned int PRN, double time, double x, double y, double z) 
+{
+    // time is the reception time of the ephemeris, not the current receiver time
+    Spoofing_Check_Scope scope(SPOOFING_CHECK_SATPOS);
+    Spoofing_Input input(SPOOFING_INPUT_SATPOS, time);
+    input.detector = this;
+    input.PRN = PRN;
+    input.x = x;
+    input.y = y;
+    input.z = z;
+    d_scheduler.dispatch(input);
+}
+
+
+void Spoofing_Detector::do_check_satpos(unsigned int PRN, double time, double x, double y, double z)
 {
     Satpos p;
     if(Satpos_map.count(PRN))
@@ -622,6 +941,7 @@ void Spoofing_Detector::check_satpos(unsigned int PRN, double time, double x, do
                     msg.spoofing_case = 5;
                     std::set<unsigned int> sats = {PRN};
                     msg.satellites = sats;
+                    msg.evidence_time_ms = time;
                     msg.description = s.str();
                     msg.spoofing_report = sr.str();
                     spoofing_detected(msg);
@@ -641,6 +961,7 @@ void Spoofing_Detector::check_satpos(unsigned int PRN, double time, double x, do
  */
 void Spoofing_Detector::check_GPS_time()
 {
+    Spoofing_Check_Scope scope(SPOOFING_CHECK_GPS_TIME);
     std::map<int, GPS_time_t> gps_times = global_gps_time.get_map_copy();
     std::set<int> GPS_TOW;
     int GPS_week, TOW;
@@ -678,6 +999,7 @@ void Spoofing_Detector::check_GPS_time()
         msg.spoofing_case = 4;
         std::set<unsigned int> sats = {};
         msg.satellites = sats;
+        msg.evidence_time_ms = largest; // the latest subframe, which broke the sync
         msg.description = s;
         msg.spoofing_report = sr.str();
         spoofing_detected(msg);
@@ -711,10 +1033,22 @@ float get_RT(gr_complex early_s1, gr_complex late_s1, gr_complex prompt_s1)
  */
 //TODO: find better name
 void Spoofing_Detector::PPE_moving_var(std::list<unsigned int> channels, Gnss_Synchro **in, int sample_counter)
+{
+    Spoofing_Check_Scope scope(SPOOFING_CHECK_PPE, sample_counter);
+    Spoofing_Input input(SPOOFING_INPUT_EPOCH, sample_counter);
+    input.detector = this;
+    input.channels = &channels;
+    input.in = in;
+    input.sample_counter = sample_counter;
+    d_scheduler.dispatch(input);
+}
+
+
+void Spoofing_Detector::do_PPE_moving_var(const std::list<unsigned int>& channels, Gnss_Synchro **in, int sample_counter)
 {
     std::vector<unsigned int> PRNs;
     unsigned int PRN, i;
-    for(std::list<unsigned int>::iterator it = channels.begin(); it != channels.end(); ++it)
+    for(std::list<unsigned int>::const_iterator it = channels.begin(); it != channels.end(); ++it)
     {
         i = *it;
         PRN  = in[i][0].PRN;
@@ -728,12 +1062,13 @@ void Spoofing_Detector::PPE_moving_var(std::list<unsigned int> channels, Gnss_Sy
         if(!sat_buffs.count(PRN)) 
             {
                 SatBuff satbuff;
-                satbuff.init(d_PPE_window_size);
+                satbuff.init(d_PPE_windows);
                 satbuff.PRN = PRN;
                 sat_buffs[PRN] = satbuff; 
             }
         sat_buffs.at(PRN).add(CN0, RT, Delta);
     }
+    d_PPE_epochs.push_back(sample_counter);
 
     //remove satellites from the buffers if they are no longer being tracked
     std::list<unsigned int> sats_to_be_removed;
@@ -757,129 +1092,93 @@ void Spoofing_Detector::PPE_moving_var(std::list<unsigned int> channels, Gnss_Sy
     
 }
 
-double get_mean(boost::circular_buffer<double> v)
-{
-    double sum = 0;
-
-    for(boost::circular_buffer<double>::iterator it = v.begin(); it != v.end(); it++)
-        {
-            sum += *it;
-        }
-
-    return (sum / v.size());
-}
-
-
-
-double get_var(boost::circular_buffer<double> a)
-{
-    double mean_a = get_mean(a);
-    
-    double sum = 0;
-    if( a.size() == 0)
-        {
-            DLOG(INFO) << "vectors are empty, can't calculate convariance";
-            return 0;
-        }
-
-    for(unsigned int i = 0; i < a.size(); i++)
-        {
-            sum += ( a[i]-mean_a ) * ( a[i]-mean_a ); 
-        }
-    return sum / a.size();
-}
-
+/*!
+ *  Raise an alarm if the largest variance of CN0, delta or RT amongst the tracked satellites is
+ *  above its threshold, for each configured PPE window length.
+ */
 void Spoofing_Detector::calc_max_var(int sample_counter)
 {
-    double max_snr_var = 0;
-    double max_delta_var = 0;
-    double max_rt_var = 0;
-    
-    for(std::map<int, SatBuff>::iterator it = sat_buffs.begin(); it != sat_buffs.end(); it++)
-        {
-            SatBuff sb = it->second;
-            if( sb.count < d_PPE_window_size )
-                continue;
-
-            if(max_snr_var < get_var(sb.SNR_cb))
-                max_snr_var = get_var(sb.SNR_cb);
-            if(max_delta_var < get_var(sb.delta_cb))
-                max_delta_var = get_var(sb.delta_cb);
-            if(max_rt_var < get_var(sb.RT_cb))
-                max_rt_var = get_var(sb.RT_cb);
-        }
-
-    Spoofing_Message msg;
-    msg.spoofing_case = 10;
-    std::set<unsigned int> sats = {};
-    msg.satellites = sats;
-    if( max_snr_var >= d_CN0_threshold )
-        {
-            std::stringstream s;
-            s << " The CN0 indicates a spoofing attack"; 
-            s << " CN0: " << max_snr_var;
-            s << ", " << sample_counter; 
-            msg.description = s.str();
-            std::stringstream sr;
-            sr << "At " << sample_counter/(d_fs_in*1e3) << " s the moving standard variantion of CN0 was above the expected value." 
-              << " CN0: " << max_snr_var << ". SPREE is configured to raise an alarm if it is above " << d_CN0_threshold << ".\n";
-            msg.spoofing_report = sr.str();
-            spoofing_detected(msg);
-        }
-    if( max_rt_var >= d_RT_threshold )
-        {
-            std::stringstream s;
-            s << " The RT indicates a spoofing attack"; 
-            s << " RT: " << max_rt_var;
-            s << ", " << sample_counter; 
-            msg.description = s.str();
-            std::stringstream sr;
-            sr << "At " << sample_counter/(d_fs_in*1e3) << " s the moving standard variantion of RT was above the expected value." 
-              << " RT: " << max_rt_var << ". SPREE is configured to raise an alarm if it is above " << d_RT_threshold << ".\n";
-            msg.spoofing_report = sr.str();
-            spoofing_detected(msg);
-        }
-    if( max_delta_var >= d_Delta_threshold )
+    Spoofing_Check_Scope scope(SPOOFING_CHECK_PPE_MAX_VAR, sample_counter);
+    for(unsigned int w = 0; w < d_PPE_windows.size(); w++)
         {
-            std::stringstream s;
-            s << " The Delta indicates a spoofing attack"; 
-            s << " Delta: " << max_delta_var;
-            s << ", " << sample_counter; 
-            msg.description = s.str();
-            std::stringstream sr;
-            sr << "At " << sample_counter/(d_fs_in*1e3) << " s the moving standard variantion of delta was above the expected value." 
-              << " Delta: " << max_delta_var << ". SPREE is configured to raise an alarm if it is above " << d_Delta_threshold << ".\n";
-            msg.spoofing_report = sr.str();
-            spoofing_detected(msg);
-        }
-}
+            double max_snr_var = 0;
+            double max_delta_var = 0;
+            double max_rt_var = 0;
+            int window_size = d_PPE_windows.at(w);
 
+            for(std::map<int, SatBuff>::iterator it = sat_buffs.begin(); it != sat_buffs.end(); it++)
+                {
+                    const SatBuff& sb = it->second;
+                    if( sb.count < window_size )
+                        continue;
 
-double get_cov(boost::circular_buffer<double> a, boost::circular_buffer<double> b)
-{
-    double mean_a = get_mean(a);
-    double mean_b = get_mean(b);
-    
-    double sum = 0;
-    if(a.size() != b.size())
-        {
-            DLOG(ERROR) << "vectors are not same length, can't calculate convariance";
-            return 0;
-        }
-    if( a.size() == 0)
-        {
-            DLOG(INFO) << "vectors are empty, can't calculate convariance";
-            return 0;
-        }
+                    max_snr_var = std::max(max_snr_var, sb.SNR_cb.var(w));
+                    max_delta_var = std::max(max_delta_var, sb.delta_cb.var(w));
+                    max_rt_var = std::max(max_rt_var, sb.RT_cb.var(w));
+                }
 
-    for(unsigned int i = 0; i < a.size(); i++)
-        {
-            sum += ( a[i]-mean_a ) * ( b[i]-mean_b ); 
+            Spoofing_Message msg;
+            msg.spoofing_case = 10;
+            std::set<unsigned int> sats = {};
+            msg.satellites = sats;
+            // first sample of the window the variances were computed over
+            msg.evidence_time_ms = window_start(d_PPE_epochs, window_size);
+            if( max_snr_var >= d_CN0_threshold )
+                {
+                    std::stringstream s;
+                    s << " The CN0 indicates a spoofing attack"; 
+                    s << " CN0: " << max_snr_var;
+                    s << ", " << sample_counter; 
+                    msg.description = s.str();
+                    std::stringstream sr;
+                    sr << "At " << sample_counter/(d_fs_in*1e3) << " s the moving standard variantion of CN0 over " << window_size
+                      << " samples was above the expected value." 
+                      << " CN0: " << max_snr_var << ". SPREE is configured to raise an alarm if it is above " << d_CN0_threshold << ".\n";
+                    msg.spoofing_report = sr.str();
+                    msg.metric = "CN0_var";
+                    msg.value = max_snr_var;
+                    msg.threshold = d_CN0_threshold;
+                    spoofing_detected(msg);
+                }
+            if( max_rt_var >= d_RT_threshold )
+                {
+                    std::stringstream s;
+                    s << " The RT indicates a spoofing attack"; 
+                    s << " RT: " << max_rt_var;
+                    s << ", " << sample_counter; 
+                    msg.description = s.str();
+                    std::stringstream sr;
+                    sr << "At " << sample_counter/(d_fs_in*1e3) << " s the moving standard variantion of RT over " << window_size
+                      << " samples was above the expected value." 
+                      << " RT: " << max_rt_var << ". SPREE is configured to raise an alarm if it is above " << d_RT_threshold << ".\n";
+                    msg.spoofing_report = sr.str();
+                    msg.metric = "RT_var";
+                    msg.value = max_rt_var;
+                    msg.threshold = d_RT_threshold;
+                    spoofing_detected(msg);
+                }
+            if( max_delta_var >= d_Delta_threshold )
+                {
+                    std::stringstream s;
+                    s << " The Delta indicates a spoofing attack"; 
+                    s << " Delta: " << max_delta_var;
+                    s << ", " << sample_counter; 
+                    msg.description = s.str();
+                    std::stringstream sr;
+                    sr << "At " << sample_counter/(d_fs_in*1e3) << " s the moving standard variantion of delta over " << window_size
+                      << " samples was above the expected value." 
+                      << " Delta: " << max_delta_var << ". SPREE is configured to raise an alarm if it is above " << d_Delta_threshold << ".\n";
+                    msg.spoofing_report = sr.str();
+                    msg.metric = "Delta_var";
+                    msg.value = max_delta_var;
+                    msg.threshold = d_Delta_threshold;
+                    spoofing_detected(msg);
+                }
         }
-    return sum / a.size();
 }
 
-double Spoofing_Detector::StdDeviation(std::vector<double> v)
+
+double Spoofing_Detector::StdDeviation(const std::vector<double>& v)
 {
     double sum = std::accumulate(v.begin(), v.end(), 0.0);
     double mean = sum / v.size();
@@ -909,55 +1208,55 @@ double get_stdDev(std::vector<double> v, double mean)
 
 double Spoofing_Detector::get_SNR_corr(std::list<unsigned int> channels, Gnss_Synchro **in, int sample_counter)
 {
-    int window_size = 1e3;
-    std::vector<unsigned int> PRNs;
-    unsigned int PRN, i;
+    Spoofing_Check_Scope scope(SPOOFING_CHECK_SNR_CORR, sample_counter);
+    unsigned int window_size = 1e3;
+    std::map<int, double> SNRs;
+    unsigned int i;
     for(std::list<unsigned int>::iterator it = channels.begin(); it != channels.end(); ++it)
     {
         i = *it;
-        PRN  = in[i][0].PRN;
-        PRNs.push_back(PRN);
-        //we have a buffer with previous SNR samples
-        if(!satellite_SNR.count(PRN)) 
-            {
-                satellite_SNR[PRN] =  boost::circular_buffer<double> (window_size); 
-            }
-        satellite_SNR.at(PRN).push_back(in[i][0].CN0_dB_hz);
+        SNRs[in[i][0].PRN] = in[i][0].CN0_dB_hz;
     }
 
-    std::list<unsigned int> sats_to_be_removed;
-    //remove satellites from the buffers if they are no longer being tracked
-    for(std::map<int, boost::circular_buffer<double>>::iterator it = satellite_SNR.begin(); it != satellite_SNR.end(); it++)
+    //update the running CN0 moments of every pair of tracked satellites
+    for(std::map<int, double>::iterator a = SNRs.begin(); a != SNRs.end(); ++a)
         {
-            if( std::find(PRNs.begin(), PRNs.end(), it->first) == PRNs.end())
+            for(std::map<int, double>::iterator b = std::next(a); b != SNRs.end(); ++b)
                 {
-                    sats_to_be_removed.push_back(it->first);
+                    std::pair<int, int> key = std::make_pair(a->first, b->first);
+                    if(!satellite_SNR.count(key))
+                        {
+                            satellite_SNR[key] = Sliding_Window_Stats(window_size);
+                        }
+                    satellite_SNR.at(key).push_back(a->second, b->second);
                 }
         }
+    if(d_SNR_corr_epochs.capacity() != window_size)
+        {
+            d_SNR_corr_epochs.set_capacity(window_size);
+        }
+    d_SNR_corr_epochs.push_back(sample_counter);
 
-    for(std::list<unsigned int>::iterator it = sats_to_be_removed.begin(); it != sats_to_be_removed.end(); ++it)
-    {
-        satellite_SNR.erase(*it); 
-    }
-
-    double p_corr;
-    int PRN_a, PRN_b;
+    //remove satellites from the buffers if they are no longer being tracked
     double corr_sum = 0;
-    for(unsigned int i = 0; i < PRNs.size(); i++) 
-    {
-        PRN_a  = PRNs.at(i); 
-        for(unsigned int j = i+1; j < PRNs.size(); j++) 
+    for(std::map<std::pair<int, int>, Sliding_Window_Stats>::iterator it = satellite_SNR.begin(); it != satellite_SNR.end(); )
         {
-            PRN_b = PRNs.at(j);
-            p_corr = get_corr(satellite_SNR.at(PRN_a), satellite_SNR.at(PRN_b));
-            corr_sum += p_corr;
-        } 
-    }
+            if( !SNRs.count(it->first.first) || !SNRs.count(it->first.second))
+                {
+                    satellite_SNR.erase(it++);
+                }
+            else
+                {
+                    corr_sum += get_corr(it->second);
+                    ++it;
+                }
+        }
 
     Spoofing_Message msg;
     msg.spoofing_case = 10;
     std::set<unsigned int> sats = {};
     msg.satellites = sats;
+    msg.evidence_time_ms = window_start(d_SNR_corr_epochs, window_size);
 
     if(corr_sum > 3)
     {
@@ -976,22 +1275,30 @@ double Spoofing_Detector::get_SNR_corr(std::list<unsigned int> channels, Gnss_Sy
 
 }
 
-double Spoofing_Detector::get_corr(boost::circular_buffer<double> a, boost::circular_buffer<double> b)
+double Spoofing_Detector::get_corr(const Sliding_Window_Stats& pair)
 {
-    unsigned int window_size = 1e3;
-    if(a.size() < window_size || b.size() < window_size)
+    //the pair window only fills while both satellites are tracked, like the
+    //two per-satellite buffers of window_size samples it replaces
+    if(!pair.full())
         {
             //DLOG(INFO) << "don't have enough SNR values to calculate correlation";
             return 0; 
         }
-    
-    double corr = get_cov(a, b) / (get_cov(a, a) * get_cov(b, b)); 
-    return corr;
 
+    //cov/(var_a*var_b), not the Pearson coefficient: the alarm threshold in
+    //get_SNR_corr is set on this scale
+    const Sliding_Window_Accumulator& w = pair.window(0);
+    double var_product = w.var_x() * w.var_y();
+    if(var_product == 0)
+        {
+            return 0;
+        }
+    return w.cov() / var_product;
 }
 
 double Spoofing_Detector::check_SNR(std::list<unsigned int> channels, Gnss_Synchro **in, int sample_counter)
 {
+    Spoofing_Check_Scope scope(SPOOFING_CHECK_SNR, sample_counter);
     unsigned int d_cno_count =4;
     double d_cno_min = 1;
     if(channels.size() < d_cno_count)
@@ -1015,10 +1322,11 @@ double Spoofing_Detector::check_SNR(std::list<unsigned int> channels, Gnss_Synch
     std::set<unsigned int> sats = {};
     msg.satellites = sats;
     ppe_cb.push_back(stdev);
+    d_SNR_epochs.push_back(sample_counter);
     if(ppe_cb.size() >= 1000)
         {
-            double sum = std::accumulate(ppe_cb.begin(), ppe_cb.end(), 0);
-            mv_avg = sum/ppe_cb.size();
+            mv_avg = ppe_cb.mean();
+            msg.evidence_time_ms = window_start(d_SNR_epochs, ppe_cb.size());
             if(mv_avg < d_cno_min)
                 {
                     std::stringstream s;
@@ -1054,6 +1362,7 @@ double Spoofing_Detector::check_SNR(std::list<unsigned int> channels, Gnss_Synch
  */
 bool Spoofing_Detector::stop_tracking(unsigned int PRN, unsigned int uid)
 {
+    Spoofing_Check_Scope scope(SPOOFING_CHECK_STOP_TRACKING);
     std::map<int, Subframe> subframes = global_subframe_map.get_map_copy();
     Subframe subframe;
     
@@ -1101,6 +1410,7 @@ bool Spoofing_Detector::stop_tracking(unsigned int PRN, unsigned int uid)
  */
 void Spoofing_Detector::check_RX_time(unsigned int PRN)
 {
+    Spoofing_Check_Scope scope(SPOOFING_CHECK_RX_TIME);
     DLOG(INFO) << "check rx time";
 
     std::map<int, Subframe> subframes = global_subframe_map.get_map_copy();
@@ -1175,6 +1485,10 @@ void Spoofing_Detector::check_RX_time(unsigned int PRN)
             std::set<unsigned int> sats = {PRN};
             msg.satellites = sats;
             msg.description = s.str();
+            msg.evidence_time_ms = largest_t; // the later peak
+            msg.metric = "peak_separation_ms";
+            msg.value = std::abs(largest_t-smallest_t);
+            msg.threshold = d_APT_max_rx_discrepancy;
 
             sr << "At " << largest_t/1e3 << " s an auxiliary peak was detected for satellite " << PRN
                << " with peak seperation of " << std::setprecision(16) << std::abs(largest_t-smallest_t)*1e6 << " [ns] which translates to a" 
@@ -1222,8 +1536,23 @@ bool Spoofing_Detector::compare_subframes(Subframe subframeA, Subframe subframeB
                 return 0;
             }
   */          
-        if(subframeA.subframe != subframeB.subframe && subframeA.subframe != "" && subframeB.subframe != "")
+        // The digests cover the same fields as the subframe strings, without the TOW and HOW
+        // flags that are compared separately. Decoders that did not fill in a digest fall
+        // back to the string comparison.
+        bool the_same;
+        if(!subframeA.digest.empty() && !subframeB.digest.empty())
+            {
+                the_same = subframeA.digest == subframeB.digest && subframeA.HOW == subframeB.HOW;
+            }
+        else
+            {
+                the_same = subframeA.subframe == subframeB.subframe;
+            }
+
+        if(!the_same && subframeA.subframe != "" && subframeB.subframe != "")
             {
+                DLOG(INFO) << "subframe digests: " << subframeA.digest.to_string() << " " << subframeA.HOW
+                           << " " << subframeB.digest.to_string() << " " << subframeB.HOW;
                 std::stringstream s;
                 std::stringstream sr;
                 s << "Navigational message manipulation detected\n";
@@ -1242,6 +1571,8 @@ bool Spoofing_Detector::compare_subframes(Subframe subframeA, Subframe subframeB
                 msg.spoofing_case = 2;
                 std::set<unsigned int> sats = {subframeA.PRN, subframeB.PRN};
                 msg.satellites = sats;
+                // the later of the two subframes is the first one that disagrees
+                msg.evidence_time_ms = std::max(subframeA.timestamp, subframeB.timestamp);
                 msg.description = s.str();
                 msg.spoofing_report = sr.str();
                 spoofing_detected(msg);
@@ -1261,6 +1592,7 @@ bool Spoofing_Detector::compare_subframes(Subframe subframeA, Subframe subframeB
  */
 void Spoofing_Detector::check_APT_subframe(unsigned int uid, unsigned int subframe_id)
 {
+    Spoofing_Check_Scope scope(SPOOFING_CHECK_APT_SUBFRAME);
     Subframe subframeA, subframeB;
     unsigned int idA, idB;
     std::map<int, Subframe> subframes = global_subframe_map.get_map_copy();
@@ -1296,6 +1628,7 @@ void Spoofing_Detector::check_APT_subframe(unsigned int uid, unsigned int subfra
  */
 void Spoofing_Detector::check_inter_satellite_subframe(unsigned int uid, unsigned int subframe_id)
 {
+    Spoofing_Check_Scope scope(SPOOFING_CHECK_INTER_SATELLITE_SUBFRAME);
  //   std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();                                                                                                          
 //    DLOG(INFO) << "check subframe " << subframe_id << " for " << uid;
 
@@ -1337,15 +1670,23 @@ void Spoofing_Detector::check_inter_satellite_subframe(unsigned int uid, unsigne
  */
 void Spoofing_Detector::check_external_ephemeris(Gps_Ephemeris eph_internal, unsigned int PRN, double timestamp)
 {
-    lookup_external_nav_data(1,1);
-    std::map<int,Gps_Ephemeris> external;
-    external = supl_client_.gps_ephemeris_map;    
-        
+    d_external.request(SPOOFING_EXTERNAL_EPHEMERIS, [this, eph_internal, PRN, timestamp](const Spoofing_External_Nav_Data& data)
+        {
+            compare_external_ephemeris(eph_internal, PRN, timestamp, data.ephemeris);
+        });
+}
+
+
+void Spoofing_Detector::compare_external_ephemeris(const Gps_Ephemeris& eph_internal, unsigned int PRN, double timestamp,
+        const std::map<int, Gps_Ephemeris>& external)
+{
+    Spoofing_Check_Scope scope(SPOOFING_CHECK_EXTERNAL_EPHEMERIS);
     if(external.count( PRN) )
         {
             //create strings from the the ephemeris object for easy comparison
             Gps_Ephemeris eph_external = external.at( PRN );  
-            bool the_same = compare_ephemeris(eph_internal, eph_external);
+            bool the_same = (gps_ephemeris_digest(eph_internal, false) == gps_ephemeris_digest(eph_external, false))
+                    || compare_ephemeris(eph_internal, eph_external);
 
             if( !the_same )
                 {
@@ -1360,6 +1701,7 @@ void Spoofing_Detector::check_external_ephemeris(Gps_Ephemeris eph_internal, uns
                     msg.spoofing_case = 0;
                     std::set<unsigned int> sats = {PRN};
                     msg.satellites = sats;
+                    msg.evidence_time_ms = timestamp;
                     msg.description = s.str();
                     msg.spoofing_report = sr.str();
                     spoofing_detected(msg);
@@ -1380,18 +1722,34 @@ void Spoofing_Detector::check_external_ephemeris(Gps_Ephemeris eph_internal, uns
  *  check whether the UTC Model data received from the satellites is consistent with
  *  UTC model data received from an external source
  */
-void Spoofing_Detector::check_external_utc(Gps_Utc_Model internal, double timestamp)
+void Spoofing_Detector::check_external_utc(Gps_Utc_Model internal, double timestamp, double receiver_time_ms)
+{
+    Spoofing_Check_Scope scope(SPOOFING_CHECK_EXTERNAL_UTC, receiver_time_ms);
+    d_external.deliver();
+    Spoofing_Input input(SPOOFING_INPUT_UTC, timestamp);
+    input.detector = this;
+    input.utc_model = &internal;
+    d_scheduler.dispatch(input);
+}
+
+
+void Spoofing_Detector::do_check_external_utc(const Gps_Utc_Model& internal, double timestamp)
 {
-    if(~d_NAVI_external)
+    if(!d_NAVI_external)
         return;
-    lookup_external_nav_data(1,0);
-    Gps_Utc_Model external;
-    external = supl_client_.gps_utc;
-        
+    d_external.request(SPOOFING_EXTERNAL_UTC, [this, internal, timestamp](const Spoofing_External_Nav_Data& data)
+        {
+            compare_external_utc(internal, timestamp, data.utc);
+        });
+}
+
+
+void Spoofing_Detector::compare_external_utc(const Gps_Utc_Model& internal, double timestamp, const Gps_Utc_Model& external)
+{
     if( external.valid && internal.valid )
         {
             //create strings from the the ephemeris object for easy comparison
-            bool the_same = compare_utc(internal, external);
+            bool the_same = (gps_utc_model_digest(internal) == gps_utc_model_digest(external)) || compare_utc(internal, external);
 
             if( !the_same )
                 {
@@ -1406,6 +1764,7 @@ void Spoofing_Detector::check_external_utc(Gps_Utc_Model internal, double timest
                     msg.spoofing_case = 6;
                     std::set<unsigned int> sats = {};
                     msg.satellites = sats;
+                    msg.evidence_time_ms = timestamp;
                     msg.description = s.str();
                     msg.spoofing_report = sr.str();
                     spoofing_detected(msg);
@@ -1425,19 +1784,34 @@ void Spoofing_Detector::check_external_utc(Gps_Utc_Model internal, double timest
  *  Check whether the Iono Model data received from the satellites is consistent with
  *  Iono model data received from an external source.
  */
-void Spoofing_Detector::check_external_iono(Gps_Iono internal, double timestamp)
+void Spoofing_Detector::check_external_iono(Gps_Iono internal, double timestamp, double receiver_time_ms)
+{
+    Spoofing_Check_Scope scope(SPOOFING_CHECK_EXTERNAL_IONO, receiver_time_ms);
+    d_external.deliver();
+    Spoofing_Input input(SPOOFING_INPUT_IONO, timestamp);
+    input.detector = this;
+    input.iono = &internal;
+    d_scheduler.dispatch(input);
+}
+
+
+void Spoofing_Detector::do_check_external_iono(const Gps_Iono& internal, double timestamp)
 {
-    if(~d_NAVI_external)
+    if(!d_NAVI_external)
         return;
+    d_external.request(SPOOFING_EXTERNAL_IONO, [this, internal, timestamp](const Spoofing_External_Nav_Data& data)
+        {
+            compare_external_iono(internal, timestamp, data.iono);
+        });
+}
 
-    lookup_external_nav_data(1,0);
-    Gps_Iono external;
-    external = supl_client_.gps_iono;
-        
+
+void Spoofing_Detector::compare_external_iono(const Gps_Iono& internal, double timestamp, const Gps_Iono& external)
+{
     if( external.valid && internal.valid )
         {
             //create strings from the the ephemeris object for easy comparison
-            bool the_same = compare_iono(internal, external);
+            bool the_same = (gps_iono_digest(internal) == gps_iono_digest(external)) || compare_iono(internal, external);
 
             if( !the_same )
                 {
@@ -1451,6 +1825,7 @@ void Spoofing_Detector::check_external_iono(Gps_Iono internal, double timestamp)
                     msg.spoofing_case = 6;
                     std::set<unsigned int> sats = {};
                     msg.satellites = sats;
+                    msg.evidence_time_ms = timestamp;
                     msg.description = s.str();
                     msg.spoofing_report = sr.str();
                     spoofing_detected(msg);
@@ -1472,9 +1847,16 @@ void Spoofing_Detector::check_external_iono(Gps_Iono internal, double timestamp)
  */
 void Spoofing_Detector::check_external_gps_time(int internal_week, int internal_TOW, double timestamp)
 {
-    lookup_external_nav_data(1,0);
-    Gps_Ref_Time external;
-    external = supl_client_.gps_time;
+    d_external.request(SPOOFING_EXTERNAL_GPS_TIME, [this, internal_week, internal_TOW, timestamp](const Spoofing_External_Nav_Data& data)
+        {
+            compare_external_gps_time(internal_week, internal_TOW, timestamp, data.gps_time);
+        });
+}
+
+
+void Spoofing_Detector::compare_external_gps_time(int internal_week, int internal_TOW, double timestamp, const Gps_Ref_Time& external)
+{
+    Spoofing_Check_Scope scope(SPOOFING_CHECK_EXTERNAL_GPS_TIME);
 
     int internal_time = internal_week*seconds_per_week+internal_TOW;
     
@@ -1496,6 +1878,7 @@ void Spoofing_Detector::check_external_gps_time(int internal_week, int internal_
                     msg.spoofing_case = 6;
                     std::set<unsigned int> sats = {};
                     msg.satellites = sats;
+                    msg.evidence_time_ms = timestamp;
                     msg.description = s.str();
                     msg.spoofing_report = sr.str();
                     spoofing_detected(msg);
@@ -1517,13 +1900,20 @@ void Spoofing_Detector::check_external_gps_time(int internal_week, int internal_
  */
 void Spoofing_Detector::check_external_almanac(std::map<int, Gps_Almanac> internal_map, double timestamp)
 {
-    lookup_external_nav_data(1,0);
-    std::map< int, Gps_Almanac> external_map;
-    external_map = supl_client_.gps_almanac_map;
-    
+    d_external.request(SPOOFING_EXTERNAL_ALMANAC, [this, internal_map, timestamp](const Spoofing_External_Nav_Data& data)
+        {
+            compare_external_almanac(internal_map, timestamp, data.almanac);
+        });
+}
+
+
+void Spoofing_Detector::compare_external_almanac(const std::map<int, Gps_Almanac>& internal_map, double timestamp,
+        const std::map<int, Gps_Almanac>& external_map)
+{
+    Spoofing_Check_Scope scope(SPOOFING_CHECK_EXTERNAL_ALMANAC);
     unsigned int PRN;
     Gps_Almanac internal;
-    for(std::map<int, Gps_Almanac>::iterator it = internal_map.begin(); it != internal_map.end(); it++)
+    for(std::map<int, Gps_Almanac>::const_iterator it = internal_map.begin(); it != internal_map.end(); it++)
         { 
             PRN = it->first;
             internal = it->second; 
@@ -1531,7 +1921,7 @@ void Spoofing_Detector::check_external_almanac(std::map<int, Gps_Almanac> intern
                 {
                     //create strings from the the ephemeris object for easy comparison
                     Gps_Almanac external= external_map.at( PRN );  
-                    bool the_same = compare_almanac(internal, external);
+                    bool the_same = (gps_almanac_digest(internal) == gps_almanac_digest(external)) || compare_almanac(internal, external);
 
                     if( !the_same )
                         {
@@ -1546,6 +1936,7 @@ void Spoofing_Detector::check_external_almanac(std::map<int, Gps_Almanac> intern
                             msg.spoofing_case = 0;
                             std::set<unsigned int> sats = {PRN};
                             msg.satellites = sats;
+                            msg.evidence_time_ms = timestamp;
                             msg.description = s.str();
                             msg.spoofing_report = sr.str();
                             spoofing_detected(msg);
@@ -1562,134 +1953,6 @@ void Spoofing_Detector::check_external_almanac(std::map<int, Gps_Almanac> intern
         }
 }
 
-/*!
- *  Loopup external ephemeris, ionospheric, almanac data or utc model
- *  source states from where this information is retrieved (e.g. 1:supl server, 2:file)
- *  type specifies the type of data that is asked for (1: ephemeris, 0: iono, alma, utc)
- */
-void Spoofing_Detector::lookup_external_nav_data(int source, int type)
-{
-    //std::string d_default_eph_server = "supl.google.com";
-    std::string d_default_eph_server = "supl.nokia.com";
-    supl_client_.server_name = d_default_eph_server;
-    supl_client_.server_port = 7275;
-    int supl_mcc = 244;
-    int supl_mns = 5; 
-    int supl_lac = 0x59e2;
-    int supl_ci = 0x31b0;
-
-    std::map<int,Gps_Ephemeris> result;
-    switch( source )
-    {
-    case 1:
-        // Request ephemeris from SUPL server
-        int error;
-        supl_client_.request = type;
-        error = supl_client_.get_assistance(supl_mcc, supl_mns, supl_lac, supl_ci);
-        if (error == 0)
-        {
-            if( type == 1 )
-                {
-                    std::cout << "SUPL: Try to read GPS ephemeris from SUPL server.." << std::endl;
-                    //Save ephemeris to XML file
-                    std::string eph_xml_filename = "../data/ephemeris.xml"; 
-                    if (supl_client_.save_ephemeris_map_xml(eph_xml_filename, supl_client_.gps_ephemeris_map) == true)
-                    {
-                        std::cout << "SUPL: XML Ephemeris file created" << std::endl;
-                    }
-                    else
-                    {
-                        std::cout << "SUPL: Failed to create XML Ephemeris file" << std::endl;
-                    }
-                }
-            else if( type == 0)
-                {
-                    std::cout << "SUPL: Try to iono, alamanc and utc model from SUPL server.." << std::endl;
-                    //Save iono, utc model and almanac to XML file
-                    std::string utc_xml_filename = "../data/utc.xml"; 
-                    std::map<int, Gps_Utc_Model> utc_map;
-                    utc_map[0] = supl_client_.gps_utc;
-                    if (supl_client_.save_utc_map_xml(utc_xml_filename, utc_map) == true)
-                    {
-                        std::cout << "SUPL: XML Utc model file created" << std::endl;
-                    }
-                    else
-                    {
-                        std::cout << "SUPL: Failed to create XML Utc model file" << std::endl;
-                    }
-
-                    std::string iono_xml_filename = "../data/iono.xml"; 
-                    std::map<int, Gps_Iono> iono_map;
-                    iono_map[0] = supl_client_.gps_iono;
-                    if (supl_client_.save_iono_map_xml(iono_xml_filename, iono_map) == true)
-                    {
-                        std::cout << "SUPL: XML iono model file created" << std::endl;
-                    }
-                    else
-                    {
-                        std::cout << "SUPL: Failed to create XML iono model file" << std::endl;
-                    }
-
-                    std::string ref_time_xml_filename = "../data/ref_time.xml"; 
-                    std::map<int, Gps_Ref_Time> ref_time_map;
-                    ref_time_map[0] = supl_client_.gps_time;
-                    if (supl_client_.save_ref_time_map_xml(ref_time_xml_filename, ref_time_map) == true)
-                        {
-                            LOG(INFO) << "SUPL: Successfully saved Ref Time XML file";
-                        }
-                    else
-                        {
-                            LOG(INFO) << "SUPL: Error while trying to save ref time XML file";
-                        }
-                }
-        }
-        else
-        {
-            std::cout << "ERROR: SUPL client returned " << error << std::endl;
-            std::cout << "Please check internet connection and SUPL server configuration" << error << std::endl;
-        }
-        break;
-            
-    case 2:
-        std::string eph_xml_filename = "gps_ephemeris.xml"; 
-        std::string utc_xml_filename = "gps_utc.xml"; 
-        std::string iono_xml_filename = "gps_iono.xml"; 
-
-        // Try to read ephemeris from XML
-        if (supl_client_.load_ephemeris_xml(eph_xml_filename) == true)
-            {
-                LOG(INFO) << "SUPL: Read XML Ephemeris data";
-            }
-        else
-            {
-                LOG(INFO) << "SUPL: couldn't read Ephemeris data XML";
-            }
-
-        // Try to read utc model from XML
-        if (supl_client_.load_utc_xml(utc_xml_filename) == true)
-            {
-                LOG(INFO) << "SUPL: Read XML UTC model";
-            }
-        else
-            {
-                LOG(INFO) << "SUPL: couldn't read UTC model XML";
-            }
-
-        // Try to read Iono model from XML
-        if (supl_client_.load_iono_xml(iono_xml_filename) == true)
-            {
-                LOG(INFO) << "SUPL: Read XML IONO model";
-            }
-        else
-            {
-                LOG(INFO) << "SUPL: couldn't read IONO model XML";
-            }
-
-        break;
-    }
-
-}
-
 /*!
  * Compare two sets of ephemeris data for the same TOW.
  */
@@ -2210,13 +2473,11 @@ bool Spoofing_Detector::compare_almanac(Gps_Almanac a, Gps_Almanac b)
             the_same = false;
             DLOG(INFO) << "d_OMEGA_DOT not the same: " << a.d_OMEGA_DOT << " " << b.d_OMEGA_DOT;
         }
-    /*
     if( a.i_SV_health != b.i_SV_health )
         {
             the_same = false;
             DLOG(INFO) << "i_SV_health not the same: " << a.i_SV_health << " " << b.i_SV_health;
         }
-    */
     if( a.d_A_f0 != b.d_A_f0 )
         {
             the_same = false;
@@ -2340,10 +2601,10 @@ bool Spoofing_Detector::compare_utc(Gps_Utc_Model a, Gps_Utc_Model b)
 }
 
 
-void Spoofing_Detector::New_subframe(int subframe_ID, int PRN, Gps_Navigation_Message nav, double time)
+void Spoofing_Detector::New_subframe(int subframe_ID, int PRN, Gps_Navigation_Message nav, double time, double receiver_time_ms)
 {
+    Spoofing_Check_Scope scope(SPOOFING_CHECK_NEW_SUBFRAME, receiver_time_ms);
     unsigned int uid = nav.get_uid();
-    int GPS_week = nav.get_week();
     int TOW = nav.get_TOW();
     Subframe subframe;
     subframe.timestamp = time; 
@@ -2352,6 +2613,8 @@ void Spoofing_Detector::New_subframe(int subframe_ID, int PRN, Gps_Navigation_Me
     subframe.subframe = nav.get_subframe(subframe_ID); 
     subframe.toa = nav.d_Toa;
     subframe.uid = uid;
+    subframe.digest = nav.get_subframe_digest(subframe_ID);
+    subframe.HOW = nav.get_subframe_HOW(subframe_ID);
     global_subframe_map.add((int)uid, subframe);
 
     std::map<int, Subframe> subframes = global_subframe_map.get_map_copy();
@@ -2362,13 +2625,6 @@ void Spoofing_Detector::New_subframe(int subframe_ID, int PRN, Gps_Navigation_Me
         DLOG(INFO) << "uid: " << it->first << " sub: " << subframe.subframe_id ;
     }
 
-    if( d_APT )
-        {
-            DLOG(INFO) << "check APT";
-            check_RX_time(PRN);
-            check_APT_subframe(uid, subframe_ID);
-        }
-
     GPS_time_t gps_time;
     std::map<int, GPS_time_t> gps_times = global_gps_time.get_map_copy();
     if(gps_times.count(uid))
@@ -2387,68 +2643,17 @@ void Spoofing_Detector::New_subframe(int subframe_ID, int PRN, Gps_Navigation_Me
     if( d_NAVI_inter_satellite )
         {
             global_gps_time.add((int)uid, gps_time);
-            check_GPS_time();
         }
 
-    if( d_NAVI_TOW )
-        {
-            DLOG(INFO) << "Check new TOW";
-            check_new_TOW(time, GPS_week, TOW);
-        }
+    // external checks answered since the last subframe
+    d_external.deliver();
 
-    switch (subframe_ID)
-    {
-    case 1:
-        //check when a new GPS week has arrived
-        if( d_NAVI_external )
-            {
-                check_external_gps_time(GPS_week, TOW, time);
-            }
-        break;
-    case 2:
-        if(d_PPE)
-        {
-            check_middle_earth(PRN, nav.get_sqrtA(), time);
-        }
-        break;
-    case 3: //we have a new set of ephemeris data for the current SV
-        if (nav.satellite_validation() )
-            {
-                Gps_Ephemeris ephemeris = nav.get_ephemeris();
-                if( d_NAVI_exp_eph )
-                    check_and_update_ephemeris(PRN, ephemeris, time);
-                if (d_NAVI_external)
-                    check_external_ephemeris(ephemeris, PRN, time); 
-            }
-        break;
-    case 4: // Possible IONOSPHERE and UTC model update (page 18)
-        {
-        if( d_NAVI_inter_satellite )
-            {
-                check_inter_satellite_subframe(uid, subframe_ID);
-            }
-        if( d_NAVI_external )
-            {
-                check_external_almanac(nav.get_almanac(), time); 
-            }
-        }
-        break;
-    case 5:
-        // check get almanac 
-        {
-            if( d_NAVI_inter_satellite)
-                {
-                    check_inter_satellite_subframe(uid, subframe_ID);
-                }
-
-            if( d_NAVI_external )
-                {
-                    check_external_almanac(nav.get_almanac(), time); 
-                }
-        }
-        break;
-    default:
-        break;
-    }
+    Spoofing_Input input(Spoofing_Input::subframe(subframe_ID), time);
+    input.detector = this;
+    input.subframe_ID = subframe_ID;
+    input.PRN = PRN;
+    input.uid = uid;
+    input.nav = &nav;
+    d_scheduler.dispatch(input);
 }
 
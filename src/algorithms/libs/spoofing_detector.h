@@ -40,23 +40,28 @@
 #include <map>
 #include <vector>
 #include <set>
+#include <boost/circular_buffer.hpp>
 #include "concurrent_map.h"
 #include "gps_ephemeris.h"
 #include <string>
 #include "gnss_synchro.h"
-#include <boost/circular_buffer.hpp>
+#include "sliding_window_stats.h"
 #include "gps_iono.h"
 #include "gps_almanac.h"
 #include "gps_utc_model.h"
 #include "gps_ref_time.h"
-#include "gnss_sdr_supl_client.h"
 #include "configuration_interface.h"
 #include "gps_navigation_message.h"
+#include "gps_nav_digest.h"
 #include "gps_ephemeris.h"
 #include "spoofing_message.h"
+#include "spoofing_check.h"
+#include "spoofing_external_nav.h"
+#include "gnss_sdr_runtime_params.h"
 
 struct sEph{
     Gps_Ephemeris ephemeris;
+    Gps_Nav_Digest digest; // ephemeris digest without TOW
     double time;
     bool changed;
 };
@@ -76,22 +81,24 @@ struct Subframe{
     double timestamp;
     unsigned int toa;
     unsigned int uid;
+    Gps_Nav_Digest digest; // subframe digest without TOW and HOW flags
+    unsigned int HOW;
 };
 
 struct SatBuff{
     int PRN;
-    boost::circular_buffer<double> SNR_cb; 
-    boost::circular_buffer<double> delta_cb; 
-    boost::circular_buffer<double> RT_cb;
-    double last_snr;
-    double last_rt;
-    double last_delta;
+    Sliding_Window_Stats SNR_cb;
+    Sliding_Window_Stats delta_cb;
+    Sliding_Window_Stats RT_cb;
+    double last_snr = 0;
+    double last_rt = 0;
+    double last_delta = 0;
     int count = 0;
 
-    void init(int cb_window){
-        SNR_cb = boost::circular_buffer<double> (cb_window); 
-        delta_cb = boost::circular_buffer<double> (cb_window); 
-        RT_cb = boost::circular_buffer<double> (cb_window); 
+    void init(std::vector<unsigned int> cb_windows){
+        SNR_cb = Sliding_Window_Stats(cb_windows);
+        delta_cb = Sliding_Window_Stats(cb_windows);
+        RT_cb = Sliding_Window_Stats(cb_windows);
     };
 
     void add(float CN0, float RT, float Delta){
@@ -139,13 +146,17 @@ public:
     Spoofing_Detector();
     Spoofing_Detector(ConfigurationInterface* configuration);
 
-    void New_subframe(int subframe_ID, int PRN, Gps_Navigation_Message nav, double time);
+    /*!
+     * \brief Checks a subframe whose preamble was received at \a time [ms]. \a receiver_time_ms
+     * is the receiver time at which the subframe was completed, -1 if unknown.
+     */
+    void New_subframe(int subframe_ID, int PRN, Gps_Navigation_Message nav, double time, double receiver_time_ms = -1.0);
     std::map<unsigned int, Satpos> Satpos_map;
     void check_position(double lat, double lng, double alt, double sample_counter);
     void check_satpos(unsigned int sat, double time, double x, double y, double z); 
     double check_SNR(std::list<unsigned int> channels, Gnss_Synchro **in, int sample_counter);
-    void check_external_utc(Gps_Utc_Model time_internal, double timestamp);
-    void check_external_iono(Gps_Iono internal, double timestamp);
+    void check_external_utc(Gps_Utc_Model time_internal, double timestamp, double receiver_time_ms = -1.0);
+    void check_external_iono(Gps_Iono internal, double timestamp, double receiver_time_ms = -1.0);
     bool stop_tracking(unsigned int PRN, unsigned int uid);
     void PPE_moving_var(std::list<unsigned int> channels, Gnss_Synchro **in, int sample_counter);
 
@@ -156,6 +167,27 @@ public:
     //PPE 
     double get_PPE_sampling();
 
+    //capture of the post-tracking stream for offline replay, empty if disabled
+    std::string get_capture_filename();
+
+    //check cost and alarm latency statistics (see Spoofing_Stats_Server)
+    std::string get_stats_filename();
+    int get_stats_period_ms();
+    std::string get_stats_socket();
+    int get_stats_http_port();
+
+    //spoofing event log: identical alarms closer than this are folded, flush period of the writer thread
+    double get_event_min_interval_ms();
+    int get_event_flush_period_ms();
+
+    //checks run by the detector (see Spoofing_Check_Scheduler)
+    void register_check(std::shared_ptr<Spoofing_Check_Interface> check);
+    std::vector<Spoofing_Check_Scheduler::Status> get_check_status() const;
+    void raise_alarm(const Spoofing_Message& msg);
+
+    //re-reads the thresholds changed at run time (see Gnss_Sdr_Runtime_Params), true if any was applied
+    bool update_parameters();
+
     /*!
      * \brief Default destructor.
      */
@@ -170,7 +202,11 @@ private:
     //PPE 
     bool d_PPE;
     int d_PPE_window_size;
-    boost::circular_buffer<double> ppe_cb;
+    int d_PPE_long_window_size;
+    std::vector<unsigned int> d_PPE_windows; // window lengths watched by PPE, shortest first
+    Sliding_Window_Stats ppe_cb;
+    boost::circular_buffer<double> d_SNR_epochs; // receiver times of the samples in ppe_cb
+    boost::circular_buffer<double> d_PPE_epochs; // receiver times of the samples in the PPE windows
 
     double  d_CN0_threshold;
     double d_RT_threshold;
@@ -187,6 +223,8 @@ private:
 
     bool d_NAVI_exp_eph;
 
+    Gnss_Sdr_Runtime_Params_Watch d_params;
+
     //Subframe 1
     double d_A_f0;
     double d_A_f1;
@@ -213,9 +251,20 @@ private:
 
     double d_fs_in;
 
-    std::map<int, boost::circular_buffer<double>> satellite_SNR;
+    std::string d_capture_filename;
+
+    std::string d_stats_filename;
+    int d_stats_period_ms;
+    std::string d_stats_socket;
+    int d_stats_http_port;
+
+    double d_event_min_interval_ms;
+    int d_event_flush_period_ms;
+
+    std::map<std::pair<int, int>, Sliding_Window_Stats> satellite_SNR; // CN0 of each pair of tracked satellites
+    boost::circular_buffer<double> d_SNR_corr_epochs; // receiver times of the samples in the pair windows
     double get_SNR_corr(std::list<unsigned int> channels, Gnss_Synchro **in, int sample_counter);
-    double get_corr(boost::circular_buffer<double> a, boost::circular_buffer<double> b);
+    double get_corr(const Sliding_Window_Stats& pair);
 
     std::map<int, SatBuff> sat_buffs;
     void calc_mean_var(int sample_counter);
@@ -225,19 +274,27 @@ private:
     int rt_sum = 0; 
     int count = 0;
     
-    //supl
-    gnss_sdr_supl_client supl_client_;
+    //reference data of the external checks, see Spoofing_External_Nav
+    Spoofing_External_Requests d_external;
+
+    Spoofing_Check_Scheduler d_scheduler;
+    void register_checks(ConfigurationInterface* configuration);
+    void add_check(ConfigurationInterface* configuration, const std::string& name, unsigned int inputs,
+            double period_ms, double budget_us, Spoofing_Check_Priority priority, Spoofing_Function_Check::Function function);
+    void do_check_position(double alt, double sample_counter);
+    void do_check_satpos(unsigned int PRN, double time, double x, double y, double z);
+    void do_check_external_utc(const Gps_Utc_Model& internal, double timestamp);
+    void do_check_external_iono(const Gps_Iono& internal, double timestamp);
+    void do_PPE_moving_var(const std::list<unsigned int>& channels, Gnss_Synchro **in, int sample_counter);
 
     void spoofing_detected(Spoofing_Message msg); 
-    double StdDeviation(std::vector<double> v);
+    double StdDeviation(const std::vector<double>& v);
     bool compare_ephemeris(Gps_Ephemeris a, Gps_Ephemeris b);
     bool compare_ephemeris_dTOW(Gps_Ephemeris a, Gps_Ephemeris b);
     bool compare_utc(Gps_Utc_Model a, Gps_Utc_Model b);
     bool compare_iono(Gps_Iono a, Gps_Iono b);
     bool compare_subframes(Subframe subframeA, Subframe subframeB);
     bool compare_almanac(Gps_Almanac a, Gps_Almanac b);
-    void lookup_external_nav_data(int source, int type);
-    void set_supl_client();
     void check_new_TOW(double current_time_ms, int new_week, double new_TOW);
     void check_middle_earth(unsigned int PRN, double sqrtA, double timestamp);
     void check_GPS_time();
@@ -247,6 +304,13 @@ private:
     void check_external_almanac(std::map<int,Gps_Almanac> internal, double timestamp);
     void check_external_gps_time(int internal_week, int internal_TOW, double timestamp);
     void check_external_ephemeris(Gps_Ephemeris internal, unsigned int PRN, double timestamp);
+    void compare_external_ephemeris(const Gps_Ephemeris& internal, unsigned int PRN, double timestamp,
+            const std::map<int, Gps_Ephemeris>& external);
+    void compare_external_almanac(const std::map<int, Gps_Almanac>& internal, double timestamp,
+            const std::map<int, Gps_Almanac>& external);
+    void compare_external_gps_time(int internal_week, int internal_TOW, double timestamp, const Gps_Ref_Time& external);
+    void compare_external_utc(const Gps_Utc_Model& internal, double timestamp, const Gps_Utc_Model& external);
+    void compare_external_iono(const Gps_Iono& internal, double timestamp, const Gps_Iono& external);
     void check_and_update_ephemeris(unsigned int PRN, Gps_Ephemeris eph, double time);
 };
 
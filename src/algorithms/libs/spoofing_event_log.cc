@@ -0,0 +1,440 @@
+/*!
+ * \file spoofing_event_log.cc
+ * \brief Binary log of spoofing alarms, written by a background thread, with
+ * repeated alarms folded into one record.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "spoofing_event_log.h"
+#include <cstring>
+#include <sstream>
+#include <glog/logging.h>
+
+using google::LogMessage;
+
+namespace
+{
+const char SPOOFING_EVENT_LOG_MAGIC[8] = {'S', 'P', 'R', 'E', 'E', 'E', 'V', 'T'};
+const unsigned char SPOOFING_EVENT_RECORD = 1;
+const unsigned int SPOOFING_EVENT_MAX_STRING = 1 << 20;
+
+template<typename T>
+void write_value(std::ofstream& file, const T& value)
+{
+    file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<typename T>
+bool read_value(std::ifstream& file, T& value)
+{
+    file.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return file.good();
+}
+
+void write_string(std::ofstream& file, const std::string& value)
+{
+    write_value(file, static_cast<unsigned int>(value.size()));
+    file.write(value.data(), value.size());
+}
+
+bool read_string(std::ifstream& file, std::string& value)
+{
+    unsigned int length;
+    if (!read_value(file, length) || length > SPOOFING_EVENT_MAX_STRING) return false;
+    value.resize(length);
+    if (length == 0) return true;
+    file.read(&value[0], length);
+    return file.good();
+}
+
+/*
+ * Alarms with the same key are folded
+ */
+std::string fold_key(const Spoofing_Message& msg)
+{
+    std::stringstream key;
+    key << msg.spoofing_case << '|';
+    for (std::set<unsigned int>::const_iterator it = msg.satellites.begin(); it != msg.satellites.end(); ++it)
+        {
+            key << *it << ',';
+        }
+    key << '|' << msg.metric;
+    return key.str();
+}
+}
+
+
+Spoofing_Event::Spoofing_Event()
+{
+    spoofing_case = 0;
+    sample_counter = 0;
+    evidence_time_ms = -1.0;
+    alarm_time_ms = -1.0;
+    first_alarm_time_ms = -1.0;
+    repeats = 1;
+    value = 0.0;
+    threshold = 0.0;
+}
+
+
+std::string spoofing_event_report(const Spoofing_Event& event)
+{
+    std::stringstream s;
+    s << event.report;
+    if (event.repeats > 1)
+        {
+            s << "The same alarm was raised " << event.repeats << " times";
+            if (event.first_alarm_time_ms >= 0.0 && event.alarm_time_ms >= 0.0)
+                {
+                    s << " between " << event.first_alarm_time_ms / 1e3 << " s and " << event.alarm_time_ms / 1e3 << " s";
+                }
+            s << ".\n";
+        }
+    return s.str();
+}
+
+
+Spoofing_Event_Log::Spoofing_Event_Log()
+{
+    d_min_interval_ms = 0.0;
+    d_flush_period_ms = 500;
+    d_alarms = 0;
+    d_records = 0;
+    d_suppressed = 0;
+    d_stop = true;
+}
+
+
+Spoofing_Event_Log::~Spoofing_Event_Log()
+{
+    close();
+}
+
+
+bool Spoofing_Event_Log::open(const std::string& filename, const std::string& report_filename, double min_interval_ms, int flush_period_ms)
+{
+    close();
+    d_file.open(filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!d_file.is_open())
+        {
+            LOG(WARNING) << "Unable to open spoofing event log " << filename;
+            return false;
+        }
+    d_file.write(SPOOFING_EVENT_LOG_MAGIC, sizeof(SPOOFING_EVENT_LOG_MAGIC));
+    write_value(d_file, SPOOFING_EVENT_LOG_VERSION);
+    if (!report_filename.empty())
+        {
+            d_report_file.open(report_filename.c_str(), std::ios::out);
+            if (!d_report_file.is_open())
+                {
+                    LOG(WARNING) << "Unable to open spoofing report " << report_filename;
+                }
+        }
+    d_min_interval_ms = min_interval_ms;
+    d_flush_period_ms = flush_period_ms > 0 ? flush_period_ms : 500;
+    d_alarms = 0;
+    d_suppressed = 0;
+    {
+        boost::lock_guard<boost::mutex> lock(d_mutex);
+        d_folds.clear();
+        d_records = 0;
+        d_stop = false;
+    }
+    d_thread = boost::thread(&Spoofing_Event_Log::run, this);
+    LOG(INFO) << "Spoofing event log enabled, file: " << filename;
+    return true;
+}
+
+
+bool Spoofing_Event_Log::is_open() const
+{
+    return d_file.is_open();
+}
+
+
+void Spoofing_Event_Log::push(const Spoofing_Message& msg, unsigned long int sample_counter)
+{
+    if (!d_file.is_open()) return;
+    d_alarms++;
+
+    Spoofing_Event event;
+    event.spoofing_case = msg.spoofing_case;
+    event.satellites.assign(msg.satellites.begin(), msg.satellites.end());
+    event.sample_counter = sample_counter;
+    event.evidence_time_ms = msg.evidence_time_ms;
+    event.alarm_time_ms = msg.alarm_time_ms;
+    event.metric = msg.metric;
+    event.value = msg.value;
+    event.threshold = msg.threshold;
+    event.description = msg.description;
+    event.report = msg.spoofing_report;
+
+    // receiver time of the alarm; the PVT sample counter runs at 1 ms
+    double t = msg.alarm_time_ms >= 0.0 ? msg.alarm_time_ms : static_cast<double>(sample_counter);
+    event.first_alarm_time_ms = t;
+
+    std::string key = fold_key(msg);
+    boost::lock_guard<boost::mutex> lock(d_mutex);
+    std::map<std::string, Fold>::iterator it = d_folds.find(key);
+    if (it == d_folds.end())
+        {
+            Fold fold;
+            fold.folded = 0;
+            fold.first_folded_ms = t;
+            fold.last_logged_ms = t;
+            fold.last_logged_wall = boost::chrono::steady_clock::now();
+            d_folds.insert(std::make_pair(key, fold));
+            enqueue(event);
+            return;
+        }
+
+    Fold& fold = it->second;
+    if (t - fold.last_logged_ms >= d_min_interval_ms || t < fold.last_logged_ms)
+        {
+            // this record also stands for the alarms folded since the last one
+            if (fold.folded > 0)
+                {
+                    event.repeats += fold.folded;
+                    event.first_alarm_time_ms = fold.first_folded_ms;
+                }
+            fold.folded = 0;
+            fold.last_logged_ms = t;
+            fold.last_logged_wall = boost::chrono::steady_clock::now();
+            enqueue(event);
+            return;
+        }
+
+    if (fold.folded == 0)
+        {
+            fold.first_folded_ms = t;
+        }
+    fold.folded++;
+    fold.last = event;
+    d_suppressed++;
+}
+
+
+void Spoofing_Event_Log::enqueue(const Spoofing_Event& event)
+{
+    d_records++;
+    d_pending.push_back(event);
+}
+
+
+/*
+ * Logs the alarms folded since the last record of \a fold as one record
+ */
+void Spoofing_Event_Log::log_folded(Fold& fold)
+{
+    Spoofing_Event event = fold.last;
+    event.repeats = fold.folded;
+    event.first_alarm_time_ms = fold.first_folded_ms;
+    enqueue(event);
+    fold.folded = 0;
+    fold.last_logged_ms = fold.last.first_alarm_time_ms;  // receiver time of the last folded alarm
+    fold.last_logged_wall = boost::chrono::steady_clock::now();
+}
+
+
+/*
+ * Alarms that stopped repeating would otherwise stay folded until the next
+ * identical alarm or close()
+ */
+void Spoofing_Event_Log::log_stale_folds()
+{
+    boost::chrono::steady_clock::time_point now = boost::chrono::steady_clock::now();
+    for (std::map<std::string, Fold>::iterator it = d_folds.begin(); it != d_folds.end(); ++it)
+        {
+            Fold& fold = it->second;
+            double since_logged_ms = boost::chrono::duration<double, boost::milli>(now - fold.last_logged_wall).count();
+            if (fold.folded > 0 && since_logged_ms >= d_min_interval_ms)
+                {
+                    log_folded(fold);
+                }
+        }
+}
+
+
+void Spoofing_Event_Log::close()
+{
+    if (!d_file.is_open()) return;
+
+    {
+        boost::lock_guard<boost::mutex> lock(d_mutex);
+        for (std::map<std::string, Fold>::iterator it = d_folds.begin(); it != d_folds.end(); ++it)
+            {
+                if (it->second.folded > 0)
+                    {
+                        log_folded(it->second);
+                    }
+            }
+        d_folds.clear();
+        d_stop = true;
+    }
+    d_cond.notify_one();
+    d_thread.join();
+
+    d_file.close();
+    if (d_report_file.is_open())
+        {
+            d_report_file.close();
+        }
+}
+
+
+void Spoofing_Event_Log::run()
+{
+    std::vector<Spoofing_Event> batch;
+    bool stop = false;
+    while (!stop)
+        {
+            {
+                boost::unique_lock<boost::mutex> lock(d_mutex);
+                if (!d_stop)
+                    {
+                        d_cond.wait_for(lock, boost::chrono::milliseconds(d_flush_period_ms));
+                    }
+                stop = d_stop;
+                log_stale_folds();
+                batch.swap(d_pending);
+            }
+            if (!batch.empty())
+                {
+                    write(batch);
+                    batch.clear();
+                }
+        }
+}
+
+
+void Spoofing_Event_Log::write(const std::vector<Spoofing_Event>& events)
+{
+    for (std::vector<Spoofing_Event>::const_iterator it = events.begin(); it != events.end(); ++it)
+        {
+            write_value(d_file, SPOOFING_EVENT_RECORD);
+            write_value(d_file, it->spoofing_case);
+            write_value(d_file, static_cast<unsigned int>(it->satellites.size()));
+            for (unsigned int i = 0; i < it->satellites.size(); i++)
+                {
+                    write_value(d_file, it->satellites.at(i));
+                }
+            write_value(d_file, it->sample_counter);
+            write_value(d_file, it->evidence_time_ms);
+            write_value(d_file, it->alarm_time_ms);
+            write_value(d_file, it->first_alarm_time_ms);
+            write_value(d_file, it->repeats);
+            write_string(d_file, it->metric);
+            write_value(d_file, it->value);
+            write_value(d_file, it->threshold);
+            write_string(d_file, it->description);
+            write_string(d_file, it->report);
+            if (d_report_file.is_open())
+                {
+                    d_report_file << spoofing_event_report(*it);
+                }
+        }
+    // one flush per batch
+    d_file.flush();
+    if (d_report_file.is_open())
+        {
+            d_report_file.flush();
+        }
+}
+
+
+unsigned long int Spoofing_Event_Log::get_alarms() const
+{
+    return d_alarms;
+}
+
+
+unsigned long int Spoofing_Event_Log::get_records() const
+{
+    boost::lock_guard<boost::mutex> lock(d_mutex);
+    return d_records;
+}
+
+
+unsigned long int Spoofing_Event_Log::get_suppressed() const
+{
+    return d_suppressed;
+}
+
+
+bool Spoofing_Event_Reader::open(const std::string& filename)
+{
+    d_file.open(filename.c_str(), std::ios::in | std::ios::binary);
+    if (!d_file.is_open())
+        {
+            LOG(WARNING) << "Unable to open spoofing event log " << filename;
+            return false;
+        }
+    char magic[sizeof(SPOOFING_EVENT_LOG_MAGIC)];
+    unsigned int version;
+    d_file.read(magic, sizeof(magic));
+    if (!d_file.good() || std::memcmp(magic, SPOOFING_EVENT_LOG_MAGIC, sizeof(magic)) != 0
+        || !read_value(d_file, version) || version != SPOOFING_EVENT_LOG_VERSION)
+        {
+            LOG(WARNING) << filename << " is not a spoofing event log of version " << SPOOFING_EVENT_LOG_VERSION;
+            d_file.close();
+            return false;
+        }
+    return true;
+}
+
+
+bool Spoofing_Event_Reader::next(Spoofing_Event& event)
+{
+    if (!d_file.is_open()) return false;
+    unsigned char type;
+    if (!read_value(d_file, type) || type != SPOOFING_EVENT_RECORD) return false;
+    unsigned int nsats;
+    if (!read_value(d_file, event.spoofing_case) || !read_value(d_file, nsats) || nsats > 64) return false;
+    event.satellites.resize(nsats);
+    for (unsigned int i = 0; i < nsats; i++)
+        {
+            if (!read_value(d_file, event.satellites.at(i))) return false;
+        }
+    return read_value(d_file, event.sample_counter)
+        && read_value(d_file, event.evidence_time_ms)
+        && read_value(d_file, event.alarm_time_ms)
+        && read_value(d_file, event.first_alarm_time_ms)
+        && read_value(d_file, event.repeats)
+        && read_string(d_file, event.metric)
+        && read_value(d_file, event.value)
+        && read_value(d_file, event.threshold)
+        && read_string(d_file, event.description)
+        && read_string(d_file, event.report);
+}
+
+
+void Spoofing_Event_Reader::close()
+{
+    if (d_file.is_open())
+        {
+            d_file.close();
+        }
+}
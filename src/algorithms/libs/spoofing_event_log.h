@@ -0,0 +1,159 @@
+/*!
+ * \file spoofing_event_log.h
+ * \brief Binary log of spoofing alarms, written by a background thread, with
+ * repeated alarms folded into one record.
+ *
+ * A spoofing attack raises the same alarm at every epoch. Alarms with the
+ * same case, satellites and metric are folded: at most one record per
+ * minimum interval of receiver time is written for them, carrying the number
+ * of alarms it stands for and the receiver time of the first one. The
+ * records are handed to a writer thread and written in batches, so the
+ * block that raises the alarms never waits for the disk.
+ *
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_SPOOFING_EVENT_LOG_H_
+#define GNSS_SDR_SPOOFING_EVENT_LOG_H_
+
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+#include <boost/thread.hpp>
+#include "spoofing_message.h"
+
+const unsigned int SPOOFING_EVENT_LOG_VERSION = 1;
+
+/*!
+ * \brief One record of the event log: an alarm and the identical alarms folded into it
+ */
+struct Spoofing_Event
+{
+    int spoofing_case;
+    std::vector<unsigned int> satellites;
+    unsigned long int sample_counter;  //!< PVT sample counter when the alarm was logged
+    double evidence_time_ms;           //!< Receiver time of the evidence [ms], -1 if unknown
+    double alarm_time_ms;              //!< Receiver time of the (last) alarm [ms], -1 if unknown
+    double first_alarm_time_ms;        //!< Receiver time of the first alarm folded into this record [ms]
+    unsigned int repeats;              //!< Number of alarms this record stands for
+    std::string metric;
+    double value;
+    double threshold;
+    std::string description;
+    std::string report;
+
+    Spoofing_Event();
+};
+
+/*!
+ * \brief Human-readable report of an event, as written to the spoofing report
+ */
+std::string spoofing_event_report(const Spoofing_Event& event);
+
+
+/*!
+ * \brief Writes the event log and, optionally, the text spoofing report.
+ * push() is called from a single thread; the files are written by an internal one.
+ */
+class Spoofing_Event_Log
+{
+public:
+    /*!
+     * \brief Opens the binary log \a filename and, if not empty, the text report
+     * \a report_filename. Identical alarms less than \a min_interval_ms apart are
+     * folded; the writer thread flushes every \a flush_period_ms, and logs the
+     * alarms folded into a record once \a min_interval_ms have passed since the
+     * record was logged, without waiting for the next identical alarm.
+     */
+    bool open(const std::string& filename, const std::string& report_filename, double min_interval_ms, int flush_period_ms);
+    bool is_open() const;
+
+    void push(const Spoofing_Message& msg, unsigned long int sample_counter);
+
+    /*!
+     * \brief Logs the alarms still folded, writes everything and stops the thread.
+     */
+    void close();
+
+    unsigned long int get_alarms() const;     //!< Alarms pushed
+    unsigned long int get_records() const;    //!< Records queued for writing
+    unsigned long int get_suppressed() const; //!< Alarms folded into another record
+
+    Spoofing_Event_Log();
+    ~Spoofing_Event_Log();
+
+private:
+    struct Fold
+    {
+        Spoofing_Event last;        // last alarm folded, not logged yet
+        unsigned int folded;
+        double first_folded_ms;
+        double last_logged_ms;
+        boost::chrono::steady_clock::time_point last_logged_wall;
+    };
+
+    std::ofstream d_file;
+    std::ofstream d_report_file;
+    double d_min_interval_ms;
+    int d_flush_period_ms;
+    unsigned long int d_alarms;
+    unsigned long int d_suppressed;
+
+    mutable boost::mutex d_mutex;
+    boost::condition_variable d_cond;
+    std::map<std::string, Fold> d_folds;    // guarded by d_mutex
+    std::vector<Spoofing_Event> d_pending;  // guarded by d_mutex
+    unsigned long int d_records;            // guarded by d_mutex
+    bool d_stop;                            // guarded by d_mutex
+    boost::thread d_thread;
+
+    void enqueue(const Spoofing_Event& event);  // with d_mutex held
+    void log_folded(Fold& fold);                // with d_mutex held
+    void log_stale_folds();                     // with d_mutex held
+    void run();
+    void write(const std::vector<Spoofing_Event>& events);
+
+    Spoofing_Event_Log(const Spoofing_Event_Log&);
+    Spoofing_Event_Log& operator=(const Spoofing_Event_Log&);
+};
+
+
+/*!
+ * \brief Reads an event log record by record
+ */
+class Spoofing_Event_Reader
+{
+public:
+    bool open(const std::string& filename);
+    bool next(Spoofing_Event& event);  //!< False at the end of the log or on a truncated record
+    void close();
+
+private:
+    std::ifstream d_file;
+};
+
+#endif
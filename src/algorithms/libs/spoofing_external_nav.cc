@@ -0,0 +1,884 @@
+/*!
+ * \file spoofing_external_nav.cc
+ * \brief Asynchronous, cached reference navigation data for the external
+ * spoofing checks.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "spoofing_external_nav.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <glog/logging.h>
+#include "configuration_interface.h"
+#include "gnss_sdr_supl_client.h"
+
+using google::LogMessage;
+
+
+const char* spoofing_external_kind_name(Spoofing_External_Kind kind)
+{
+    switch (kind)
+    {
+    case SPOOFING_EXTERNAL_EPHEMERIS: return "ephemeris";
+    case SPOOFING_EXTERNAL_ALMANAC: return "almanac";
+    case SPOOFING_EXTERNAL_IONO: return "iono";
+    case SPOOFING_EXTERNAL_UTC: return "utc";
+    case SPOOFING_EXTERNAL_GPS_TIME: return "gps_time";
+    default: return "unknown";
+    }
+}
+
+
+Spoofing_External_Nav_Data::Spoofing_External_Nav_Data()
+{
+    for (unsigned int k = 0; k < SPOOFING_EXTERNAL_KINDS; k++)
+        {
+            valid[k] = false;
+        }
+}
+
+
+void Spoofing_External_Nav_Data::set(Spoofing_External_Kind kind)
+{
+    valid[kind] = true;
+    fetched[kind] = std::chrono::steady_clock::now();
+}
+
+
+double Spoofing_External_Nav_Data::age_s(Spoofing_External_Kind kind) const
+{
+    if (!valid[kind]) return -1.0;
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - fetched[kind]).count();
+}
+
+
+// ######## SOURCES #########
+
+std::shared_ptr<Spoofing_External_Source> Spoofing_External_Source::create(ConfigurationInterface* configuration)
+{
+    std::string source = configuration->property("Spoofing.external_source", std::string("supl"));
+    if (source == "supl")
+        {
+            std::string server = configuration->property("Spoofing.external_supl_server", std::string("supl.nokia.com"));
+            int port = configuration->property("Spoofing.external_supl_port", 7275);
+            int mcc = configuration->property("GNSS-SDR.SUPL_MCC", 244);
+            int mns = configuration->property("GNSS-SDR.SUPL_MNS", 5);
+            // LAC and CI are usually written in hexadecimal
+            int lac = std::strtol(configuration->property("GNSS-SDR.SUPL_LAC", std::string("0x59e2")).c_str(), nullptr, 0);
+            int ci = std::strtol(configuration->property("GNSS-SDR.SUPL_CI", std::string("0x31b0")).c_str(), nullptr, 0);
+            return std::make_shared<Spoofing_Supl_Source>(server, port, mcc, mns, lac, ci);
+        }
+    if (source == "xml")
+        {
+            return std::make_shared<Spoofing_Xml_Source>(
+                    configuration->property("GNSS-SDR.SUPL_gps_ephemeris_xml", std::string("./gps_ephemeris.xml")),
+                    configuration->property("GNSS-SDR.SUPL_gps_utc_model.xml", std::string("./gps_utc_model.xml")),
+                    configuration->property("GNSS-SDR.SUPL_gps_iono_xml", std::string("./gps_iono.xml")),
+                    configuration->property("GNSS-SDR.SUPL_gps_ref_time_xml", std::string("./gps_ref_time.xml")));
+        }
+    if (source == "rinex")
+        {
+            std::string filename = configuration->property("Spoofing.external_rinex_nav", std::string(""));
+            if (filename.empty())
+                {
+                    LOG(WARNING) << "Spoofing.external_source=rinex needs Spoofing.external_rinex_nav";
+                    return std::shared_ptr<Spoofing_External_Source>();
+                }
+            return std::make_shared<Spoofing_Rinex_Source>(filename);
+        }
+    LOG(WARNING) << "Unknown Spoofing.external_source " << source;
+    return std::shared_ptr<Spoofing_External_Source>();
+}
+
+
+Spoofing_Supl_Source::Spoofing_Supl_Source(const std::string& server, int port, int mcc, int mns, int lac, int ci)
+{
+    d_server = server;
+    d_port = port;
+    d_mcc = mcc;
+    d_mns = mns;
+    d_lac = lac;
+    d_ci = ci;
+}
+
+
+std::string Spoofing_Supl_Source::name() const
+{
+    return "supl";
+}
+
+
+bool Spoofing_Supl_Source::fetch(Spoofing_External_Kind kind, Spoofing_External_Nav_Data& data)
+{
+    gnss_sdr_supl_client supl_client;
+    supl_client.server_name = d_server;
+    supl_client.server_port = d_port;
+    // request 1 returns the ephemerides, request 0 the almanac, iono, utc and time
+    supl_client.request = (kind == SPOOFING_EXTERNAL_EPHEMERIS) ? 1 : 0;
+    int error = supl_client.get_assistance(d_mcc, d_mns, d_lac, d_ci);
+    if (error != 0)
+        {
+            LOG(WARNING) << "SUPL client returned " << error << " requesting " << spoofing_external_kind_name(kind)
+                         << " from " << d_server << ":" << d_port;
+            return false;
+        }
+    if (supl_client.request == 1)
+        {
+            if (!supl_client.gps_ephemeris_map.empty())
+                {
+                    data.ephemeris = supl_client.gps_ephemeris_map;
+                    data.set(SPOOFING_EXTERNAL_EPHEMERIS);
+                }
+        }
+    else
+        {
+            if (!supl_client.gps_almanac_map.empty())
+                {
+                    data.almanac = supl_client.gps_almanac_map;
+                    data.set(SPOOFING_EXTERNAL_ALMANAC);
+                }
+            if (supl_client.gps_iono.valid)
+                {
+                    data.iono = supl_client.gps_iono;
+                    data.set(SPOOFING_EXTERNAL_IONO);
+                }
+            if (supl_client.gps_utc.valid)
+                {
+                    data.utc = supl_client.gps_utc;
+                    data.set(SPOOFING_EXTERNAL_UTC);
+                }
+            if (supl_client.gps_time.valid)
+                {
+                    data.gps_time = supl_client.gps_time;
+                    data.set(SPOOFING_EXTERNAL_GPS_TIME);
+                }
+        }
+    return data.valid[kind];
+}
+
+
+Spoofing_Xml_Source::Spoofing_Xml_Source(const std::string& ephemeris_xml, const std::string& utc_xml,
+        const std::string& iono_xml, const std::string& ref_time_xml)
+{
+    d_ephemeris_xml = ephemeris_xml;
+    d_utc_xml = utc_xml;
+    d_iono_xml = iono_xml;
+    d_ref_time_xml = ref_time_xml;
+}
+
+
+std::string Spoofing_Xml_Source::name() const
+{
+    return "xml";
+}
+
+
+bool Spoofing_Xml_Source::fetch(Spoofing_External_Kind kind, Spoofing_External_Nav_Data& data)
+{
+    gnss_sdr_supl_client supl_client;
+    switch (kind)
+    {
+    case SPOOFING_EXTERNAL_EPHEMERIS:
+        if (supl_client.load_ephemeris_xml(d_ephemeris_xml))
+            {
+                data.ephemeris = supl_client.gps_ephemeris_map;
+                data.set(kind);
+            }
+        break;
+    case SPOOFING_EXTERNAL_IONO:
+        if (supl_client.load_iono_xml(d_iono_xml))
+            {
+                data.iono = supl_client.gps_iono;
+                data.set(kind);
+            }
+        break;
+    case SPOOFING_EXTERNAL_UTC:
+        if (supl_client.load_utc_xml(d_utc_xml))
+            {
+                data.utc = supl_client.gps_utc;
+                data.set(kind);
+            }
+        break;
+    case SPOOFING_EXTERNAL_GPS_TIME:
+        if (supl_client.load_ref_time_xml(d_ref_time_xml))
+            {
+                data.gps_time = supl_client.gps_time;
+                data.set(kind);
+            }
+        break;
+    default:
+        // the assistance XML files carry no almanac
+        break;
+    }
+    return data.valid[kind];
+}
+
+
+Spoofing_Rinex_Source::Spoofing_Rinex_Source(const std::string& filename)
+{
+    d_filename = filename;
+}
+
+
+std::string Spoofing_Rinex_Source::name() const
+{
+    return "rinex";
+}
+
+
+bool Spoofing_Rinex_Source::fetch(Spoofing_External_Kind kind, Spoofing_External_Nav_Data& data)
+{
+    Spoofing_External_Nav_Data file;
+    if (!read(d_filename, file))
+        {
+            return false;
+        }
+    if (file.valid[SPOOFING_EXTERNAL_EPHEMERIS])
+        {
+            data.ephemeris = file.ephemeris;
+            data.set(SPOOFING_EXTERNAL_EPHEMERIS);
+        }
+    if (file.valid[SPOOFING_EXTERNAL_IONO])
+        {
+            data.iono = file.iono;
+            data.set(SPOOFING_EXTERNAL_IONO);
+        }
+    if (file.valid[SPOOFING_EXTERNAL_UTC])
+        {
+            data.utc = file.utc;
+            data.set(SPOOFING_EXTERNAL_UTC);
+        }
+    return data.valid[kind];
+}
+
+
+namespace
+{
+// RINEX writes the exponent of its floating point fields with a D
+double rinex_double(const std::string& line, size_t pos, size_t len)
+{
+    if (pos >= line.size()) return 0.0;
+    std::string field = line.substr(pos, len);
+    std::replace(field.begin(), field.end(), 'D', 'E');
+    std::replace(field.begin(), field.end(), 'd', 'E');
+    return std::strtod(field.c_str(), nullptr);
+}
+
+int rinex_int(const std::string& line, size_t pos, size_t len)
+{
+    if (pos >= line.size()) return 0;
+    return std::atoi(line.substr(pos, len).c_str());
+}
+
+// Days from 1980-01-06, the GPS epoch, to the given civil date
+long gps_days(int year, int month, int day)
+{
+    // days_from_civil of H. Hinnant
+    year -= month <= 2;
+    long era = (year >= 0 ? year : year - 399) / 400;
+    long yoe = year - era * 400;
+    long doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468 - 3657;
+}
+
+// User range accuracy index of an accuracy in meters (IS-GPS-200 20.3.3.3.1.3)
+int ura_index(double meters)
+{
+    const double ura[] = { 2.4, 3.4, 4.85, 6.85, 9.65, 13.65, 24.0, 48.0, 96.0, 192.0, 384.0, 768.0, 1536.0, 3072.0, 6144.0 };
+    for (int i = 0; i < 15; i++)
+        {
+            if (meters <= ura[i]) return i;
+        }
+    return 15;
+}
+}
+
+
+bool Spoofing_Rinex_Source::read(const std::string& filename, Spoofing_External_Nav_Data& data)
+{
+    std::ifstream file(filename.c_str());
+    if (!file.is_open())
+        {
+            LOG(WARNING) << "Unable to open RINEX navigation file " << filename;
+            return false;
+        }
+
+    std::string line;
+    double version = 0.0;
+    bool header = true;
+    bool iono_alpha = false;
+    bool iono_beta = false;
+    bool utc = false;
+    std::vector<std::string> record;
+    size_t first_field = 0;   // column of the first field of the orbit lines
+
+    while (std::getline(file, line))
+        {
+            if (!line.empty() && line[line.size() - 1] == '\r') line.erase(line.size() - 1);
+            if (header)
+                {
+                    std::string label = line.size() > 60 ? line.substr(60) : "";
+                    if (label.find("RINEX VERSION / TYPE") == 0)
+                        {
+                            version = std::atof(line.substr(0, 9).c_str());
+                            char type = line.size() > 20 ? line[20] : ' ';
+                            char system = line.size() > 40 ? line[40] : ' ';
+                            if (type != 'N' || (version >= 3.0 && system != 'G' && system != 'M'))
+                                {
+                                    LOG(WARNING) << filename << " is not a GPS RINEX navigation file";
+                                    return false;
+                                }
+                            first_field = version >= 3.0 ? 4 : 3;
+                        }
+                    else if (label.find("ION ALPHA") == 0)
+                        {
+                            data.iono.d_alpha0 = rinex_double(line, 2, 12);
+                            data.iono.d_alpha1 = rinex_double(line, 14, 12);
+                            data.iono.d_alpha2 = rinex_double(line, 26, 12);
+                            data.iono.d_alpha3 = rinex_double(line, 38, 12);
+                            iono_alpha = true;
+                        }
+                    else if (label.find("ION BETA") == 0)
+                        {
+                            data.iono.d_beta0 = rinex_double(line, 2, 12);
+                            data.iono.d_beta1 = rinex_double(line, 14, 12);
+                            data.iono.d_beta2 = rinex_double(line, 26, 12);
+                            data.iono.d_beta3 = rinex_double(line, 38, 12);
+                            iono_beta = true;
+                        }
+                    else if (label.find("IONOSPHERIC CORR") == 0 && line.compare(0, 4, "GPSA") == 0)
+                        {
+                            data.iono.d_alpha0 = rinex_double(line, 5, 12);
+                            data.iono.d_alpha1 = rinex_double(line, 17, 12);
+                            data.iono.d_alpha2 = rinex_double(line, 29, 12);
+                            data.iono.d_alpha3 = rinex_double(line, 41, 12);
+                            iono_alpha = true;
+                        }
+                    else if (label.find("IONOSPHERIC CORR") == 0 && line.compare(0, 4, "GPSB") == 0)
+                        {
+                            data.iono.d_beta0 = rinex_double(line, 5, 12);
+                            data.iono.d_beta1 = rinex_double(line, 17, 12);
+                            data.iono.d_beta2 = rinex_double(line, 29, 12);
+                            data.iono.d_beta3 = rinex_double(line, 41, 12);
+                            iono_beta = true;
+                        }
+                    else if (label.find("DELTA-UTC: A0,A1,T,W") == 0)
+                        {
+                            data.utc.d_A0 = rinex_double(line, 3, 19);
+                            data.utc.d_A1 = rinex_double(line, 22, 19);
+                            data.utc.d_t_OT = rinex_int(line, 41, 9);
+                            data.utc.i_WN_T = rinex_int(line, 50, 9);
+                            utc = true;
+                        }
+                    else if (label.find("TIME SYSTEM CORR") == 0 && line.compare(0, 4, "GPUT") == 0)
+                        {
+                            data.utc.d_A0 = rinex_double(line, 5, 17);
+                            data.utc.d_A1 = rinex_double(line, 22, 16);
+                            data.utc.d_t_OT = rinex_int(line, 38, 7);
+                            data.utc.i_WN_T = rinex_int(line, 45, 5);
+                            utc = true;
+                        }
+                    else if (label.find("LEAP SECONDS") == 0)
+                        {
+                            data.utc.d_DeltaT_LS = rinex_int(line, 0, 6);
+                            data.utc.d_DeltaT_LSF = data.utc.d_DeltaT_LS;
+                        }
+                    else if (label.find("END OF HEADER") == 0)
+                        {
+                            header = false;
+                            if (first_field == 0)
+                                {
+                                    LOG(WARNING) << filename << " has no RINEX VERSION / TYPE line";
+                                    return false;
+                                }
+                        }
+                    continue;
+                }
+
+            if (line.find_first_not_of(' ') == std::string::npos) continue;
+            record.push_back(line);
+            if (record.size() < 8) continue;
+
+            // a satellite record: epoch and clock line and seven broadcast orbit lines
+            const std::string& l0 = record.at(0);
+            int year, month, day, hour, minute;
+            double second;
+            size_t clock_field;
+            Gps_Ephemeris eph;
+            bool gps = true;
+            if (version >= 3.0)
+                {
+                    gps = l0[0] == 'G';
+                    eph.i_satellite_PRN = rinex_int(l0, 1, 2);
+                    year = rinex_int(l0, 4, 4);
+                    month = rinex_int(l0, 9, 2);
+                    day = rinex_int(l0, 12, 2);
+                    hour = rinex_int(l0, 15, 2);
+                    minute = rinex_int(l0, 18, 2);
+                    second = rinex_double(l0, 21, 2);
+                    clock_field = 23;
+                }
+            else
+                {
+                    eph.i_satellite_PRN = rinex_int(l0, 0, 2);
+                    year = rinex_int(l0, 3, 2);
+                    year += year < 80 ? 2000 : 1900;
+                    month = rinex_int(l0, 6, 2);
+                    day = rinex_int(l0, 9, 2);
+                    hour = rinex_int(l0, 12, 2);
+                    minute = rinex_int(l0, 15, 2);
+                    second = rinex_double(l0, 17, 5);
+                    clock_field = 22;
+                }
+            double f[3 + 7 * 4];
+            for (int i = 0; i < 3; i++)
+                {
+                    f[i] = rinex_double(l0, clock_field + 19 * i, 19);
+                }
+            for (int l = 1; l < 8; l++)
+                {
+                    for (int i = 0; i < 4; i++)
+                        {
+                            f[3 + 4 * (l - 1) + i] = rinex_double(record.at(l), first_field + 19 * i, 19);
+                        }
+                }
+            record.clear();
+            if (!gps) continue;
+
+            double seconds = (gps_days(year, month, day) % 7) * 86400.0 + hour * 3600.0 + minute * 60.0 + second;
+            eph.d_Toc = std::fmod(seconds, 604800.0);
+            eph.d_A_f0 = f[0];
+            eph.d_A_f1 = f[1];
+            eph.d_A_f2 = f[2];
+            eph.d_IODE_SF2 = f[3];
+            eph.d_IODE_SF3 = f[3];
+            eph.d_Crs = f[4];
+            eph.d_Delta_n = f[5];
+            eph.d_M_0 = f[6];
+            eph.d_Cuc = f[7];
+            eph.d_e_eccentricity = f[8];
+            eph.d_Cus = f[9];
+            eph.d_sqrt_A = f[10];
+            eph.d_Toe = f[11];
+            eph.d_Cic = f[12];
+            eph.d_OMEGA0 = f[13];
+            eph.d_Cis = f[14];
+            eph.d_i_0 = f[15];
+            eph.d_Crc = f[16];
+            eph.d_OMEGA = f[17];
+            eph.d_OMEGA_DOT = f[18];
+            eph.d_IDOT = f[19];
+            eph.i_code_on_L2 = static_cast<int>(f[20]);
+            eph.i_GPS_week = static_cast<int>(f[21]);
+            eph.b_L2_P_data_flag = f[22] != 0.0;
+            eph.i_SV_accuracy = ura_index(f[23]);
+            eph.i_SV_health = static_cast<int>(f[24]);
+            eph.d_TGD = f[25];
+            eph.d_IODC = f[26];
+            eph.d_TOW = f[27];
+            eph.b_fit_interval_flag = f[28] > 4.0;
+
+            // keep the latest ephemeris of each satellite
+            std::map<int, Gps_Ephemeris>::iterator it = data.ephemeris.find(eph.i_satellite_PRN);
+            if (it == data.ephemeris.end()
+                    || it->second.i_GPS_week * 604800.0 + it->second.d_Toe <= eph.i_GPS_week * 604800.0 + eph.d_Toe)
+                {
+                    data.ephemeris[eph.i_satellite_PRN] = eph;
+                }
+        }
+
+    if (!data.ephemeris.empty()) data.set(SPOOFING_EXTERNAL_EPHEMERIS);
+    if (iono_alpha && iono_beta)
+        {
+            data.iono.valid = true;
+            data.set(SPOOFING_EXTERNAL_IONO);
+        }
+    if (utc)
+        {
+            data.utc.valid = true;
+            data.set(SPOOFING_EXTERNAL_UTC);
+        }
+    LOG(INFO) << "Read " << data.ephemeris.size() << " ephemerides from RINEX navigation file " << filename;
+    return !header;
+}
+
+
+// ######## SERVICE #########
+
+Spoofing_External_Nav& Spoofing_External_Nav::instance()
+{
+    static Spoofing_External_Nav service;
+    return service;
+}
+
+
+Spoofing_External_Nav::Spoofing_External_Nav()
+{
+    d_refresh_s = 900.0;
+    d_max_age_s = 7200.0;
+    d_retry_s = 30.0;
+    d_data = std::make_shared<const Spoofing_External_Nav_Data>();
+    d_wanted = 0;
+    d_stop = false;
+    d_running = false;
+    for (unsigned int k = 0; k < SPOOFING_EXTERNAL_KINDS; k++)
+        {
+            d_hits[k] = 0;
+            d_misses[k] = 0;
+            d_stale[k] = 0;
+        }
+    d_fetches = 0;
+    d_fetch_failures = 0;
+}
+
+
+Spoofing_External_Nav::~Spoofing_External_Nav()
+{
+    stop();
+}
+
+
+bool Spoofing_External_Nav::start(std::shared_ptr<Spoofing_External_Source> source, double refresh_s, double max_age_s, double retry_s)
+{
+    boost::unique_lock<boost::mutex> lock(d_mutex);
+    if (d_running) return true;
+    if (!source) return false;
+    d_source = source;
+    d_refresh_s = refresh_s > 0.0 ? refresh_s : 900.0;
+    d_max_age_s = std::max(max_age_s, d_refresh_s);
+    d_retry_s = retry_s > 0.0 ? retry_s : 30.0;
+    d_data = std::make_shared<const Spoofing_External_Nav_Data>();
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    for (unsigned int k = 0; k < SPOOFING_EXTERNAL_KINDS; k++)
+        {
+            d_next_attempt[k] = now;
+        }
+    // prefetch everything, so that the first checks already hit the cache
+    d_wanted = (1u << SPOOFING_EXTERNAL_KINDS) - 1;
+    d_stop = false;
+    d_running = true;
+    d_thread = boost::thread(&Spoofing_External_Nav::run, this);
+    LOG(INFO) << "External navigation data from " << d_source->name() << ", refreshed every " << d_refresh_s << " s";
+    return true;
+}
+
+
+void Spoofing_External_Nav::stop()
+{
+    {
+        boost::unique_lock<boost::mutex> lock(d_mutex);
+        if (!d_running) return;
+        d_stop = true;
+    }
+    d_cond.notify_all();
+    // a fetch may be stuck on the network, do not hold the receiver back for it
+    if (!d_thread.try_join_for(boost::chrono::seconds(2)))
+        {
+            LOG(WARNING) << "External navigation data fetch still running at exit";
+            d_thread.detach();
+        }
+    boost::unique_lock<boost::mutex> lock(d_mutex);
+    d_running = false;
+}
+
+
+bool Spoofing_External_Nav::is_running() const
+{
+    boost::unique_lock<boost::mutex> lock(d_mutex);
+    return d_running;
+}
+
+
+void Spoofing_External_Nav::request(Spoofing_External_Kind kind)
+{
+    // called with d_mutex held
+    if (d_wanted & (1u << kind)) return;
+    d_wanted |= 1u << kind;
+    d_cond.notify_all();
+}
+
+
+std::shared_ptr<const Spoofing_External_Nav_Data> Spoofing_External_Nav::lookup(Spoofing_External_Kind kind)
+{
+    boost::unique_lock<boost::mutex> lock(d_mutex);
+    std::shared_ptr<const Spoofing_External_Nav_Data> data = d_data;
+    if (!data->valid[kind])
+        {
+            d_misses[kind]++;
+            if (d_running) request(kind);
+            return std::shared_ptr<const Spoofing_External_Nav_Data>();
+        }
+    double age = data->age_s(kind);
+    if (age >= d_refresh_s && d_running) request(kind);
+    if (age > d_max_age_s) d_stale[kind]++;
+    d_hits[kind]++;
+    return data;
+}
+
+
+std::shared_ptr<const Spoofing_External_Nav_Data> Spoofing_External_Nav::current() const
+{
+    boost::unique_lock<boost::mutex> lock(d_mutex);
+    return d_data;
+}
+
+
+bool Spoofing_External_Nav::wait_for(Spoofing_External_Kind kind, int timeout_ms)
+{
+    boost::unique_lock<boost::mutex> lock(d_mutex);
+    if (!d_data->valid[kind] && d_running) request(kind);
+    boost::chrono::steady_clock::time_point deadline = boost::chrono::steady_clock::now() + boost::chrono::milliseconds(timeout_ms);
+    while (!d_data->valid[kind])
+        {
+            if (d_cond.wait_until(lock, deadline) == boost::cv_status::timeout)
+                {
+                    return d_data->valid[kind];
+                }
+        }
+    return true;
+}
+
+
+void Spoofing_External_Nav::run()
+{
+    boost::unique_lock<boost::mutex> lock(d_mutex);
+    while (!d_stop)
+        {
+            std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+            std::chrono::steady_clock::time_point wake = now + std::chrono::hours(24);
+            int due = -1;
+            for (unsigned int k = 0; k < SPOOFING_EXTERNAL_KINDS; k++)
+                {
+                    std::chrono::steady_clock::time_point next = std::chrono::steady_clock::time_point::max();
+                    if (d_wanted & (1u << k))
+                        {
+                            next = d_next_attempt[k];
+                        }
+                    else if (d_data->valid[k])
+                        {
+                            std::chrono::steady_clock::time_point refresh = d_data->fetched[k]
+                                    + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(d_refresh_s));
+                            next = std::max(refresh, d_next_attempt[k]);
+                        }
+                    if (next <= now)
+                        {
+                            due = k;
+                            break;
+                        }
+                    wake = std::min(wake, next);
+                }
+            if (due < 0)
+                {
+                    double wait_ms = std::chrono::duration<double, std::milli>(wake - now).count();
+                    d_cond.wait_for(lock, boost::chrono::milliseconds(static_cast<long>(wait_ms) + 1));
+                    continue;
+                }
+
+            Spoofing_External_Kind kind = static_cast<Spoofing_External_Kind>(due);
+            Spoofing_External_Nav_Data next(*d_data);
+            lock.unlock();
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            bool ok;
+            {
+                Spoofing_Check_Scope scope(SPOOFING_CHECK_EXTERNAL_LOOKUP);
+                ok = d_source->fetch(kind, next);
+            }
+            std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+            lock.lock();
+
+            d_fetches++;
+            d_fetch_ms.add(static_cast<unsigned long long>(std::chrono::duration<double, std::milli>(end - start).count()));
+            if (ok)
+                {
+                    // the worker is the only writer, so next only adds to the published snapshot
+                    for (unsigned int k = 0; k < SPOOFING_EXTERNAL_KINDS; k++)
+                        {
+                            if (next.valid[k] && (!d_data->valid[k] || next.fetched[k] != d_data->fetched[k]))
+                                {
+                                    d_wanted &= ~(1u << k);
+                                    d_next_attempt[k] = end;
+                                }
+                        }
+                    d_data = std::make_shared<const Spoofing_External_Nav_Data>(next);
+                    DLOG(INFO) << "Fetched external " << spoofing_external_kind_name(kind) << " from " << d_source->name();
+                }
+            else
+                {
+                    d_fetch_failures++;
+                    d_wanted &= ~(1u << kind);
+                    d_next_attempt[kind] = end + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(d_retry_s));
+                    // a kind that was never fetched is asked for again after the retry period
+                    if (!d_data->valid[kind]) d_wanted |= 1u << kind;
+                }
+            d_cond.notify_all();
+        }
+}
+
+
+unsigned long long Spoofing_External_Nav::get_hits(Spoofing_External_Kind kind) const
+{
+    return d_hits[kind];
+}
+
+
+unsigned long long Spoofing_External_Nav::get_misses(Spoofing_External_Kind kind) const
+{
+    return d_misses[kind];
+}
+
+
+unsigned long long Spoofing_External_Nav::get_stale(Spoofing_External_Kind kind) const
+{
+    return d_stale[kind];
+}
+
+
+unsigned long long Spoofing_External_Nav::get_fetches() const
+{
+    return d_fetches;
+}
+
+
+unsigned long long Spoofing_External_Nav::get_fetch_failures() const
+{
+    return d_fetch_failures;
+}
+
+
+const Spoofing_Histogram& Spoofing_External_Nav::get_fetch_ms() const
+{
+    return d_fetch_ms;
+}
+
+
+std::string Spoofing_External_Nav::to_json() const
+{
+    std::shared_ptr<const Spoofing_External_Nav_Data> data = current();
+    std::stringstream s;
+    s << "{\"fetches\":" << get_fetches()
+      << ",\"fetch_failures\":" << get_fetch_failures()
+      << ",\"fetch_ms\":" << d_fetch_ms.to_json() << ",\"kinds\":{";
+    for (unsigned int k = 0; k < SPOOFING_EXTERNAL_KINDS; k++)
+        {
+            Spoofing_External_Kind kind = static_cast<Spoofing_External_Kind>(k);
+            s << (k ? "," : "") << "\"" << spoofing_external_kind_name(kind) << "\":{"
+              << "\"hits\":" << get_hits(kind)
+              << ",\"misses\":" << get_misses(kind)
+              << ",\"stale\":" << get_stale(kind)
+              << ",\"age_s\":" << data->age_s(kind) << "}";
+        }
+    s << "}}";
+    return s.str();
+}
+
+
+// ######## REQUESTS #########
+
+Spoofing_External_Requests::Spoofing_External_Requests(Spoofing_External_Nav* service, size_t max_pending)
+{
+    d_service = service;
+    d_max_pending = max_pending;
+    d_dropped = 0;
+}
+
+
+Spoofing_External_Requests::Spoofing_External_Requests(const Spoofing_External_Requests& other)
+{
+    d_service = other.d_service;
+    d_max_pending = other.d_max_pending;
+    d_dropped = 0;
+}
+
+
+Spoofing_External_Requests& Spoofing_External_Requests::operator=(const Spoofing_External_Requests& other)
+{
+    d_service = other.d_service;
+    d_max_pending = other.d_max_pending;
+    d_pending.clear();
+    d_dropped = 0;
+    return *this;
+}
+
+
+void Spoofing_External_Requests::request(Spoofing_External_Kind kind, Callback callback)
+{
+    if (!d_service) return;
+    std::shared_ptr<const Spoofing_External_Nav_Data> data = d_service->lookup(kind);
+    if (data)
+        {
+            callback(*data);
+            return;
+        }
+    d_pending.push_back(std::make_pair(kind, callback));
+    if (d_pending.size() > d_max_pending)
+        {
+            d_pending.pop_front();
+            d_dropped++;
+        }
+}
+
+
+unsigned int Spoofing_External_Requests::deliver()
+{
+    if (d_pending.empty() || !d_service) return 0;
+    std::shared_ptr<const Spoofing_External_Nav_Data> data = d_service->current();
+    // take the answerable callbacks out first, they may queue new requests
+    std::vector<Callback> ready;
+    for (std::deque<std::pair<Spoofing_External_Kind, Callback>>::iterator it = d_pending.begin(); it != d_pending.end();)
+        {
+            if (data->valid[it->first])
+                {
+                    ready.push_back(it->second);
+                    it = d_pending.erase(it);
+                }
+            else
+                {
+                    ++it;
+                }
+        }
+    for (std::vector<Callback>::iterator it = ready.begin(); it != ready.end(); ++it)
+        {
+            (*it)(*data);
+        }
+    return ready.size();
+}
+
+
+size_t Spoofing_External_Requests::pending() const
+{
+    return d_pending.size();
+}
+
+
+unsigned long long Spoofing_External_Requests::get_dropped() const
+{
+    return d_dropped;
+}
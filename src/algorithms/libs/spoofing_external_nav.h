@@ -0,0 +1,276 @@
+/*!
+ * \file spoofing_external_nav.h
+ * \brief Asynchronous, cached reference navigation data (ephemeris, almanac,
+ * ionospheric and UTC models, GPS time) for the external spoofing checks.
+ *
+ * A worker thread prefetches the data from a Spoofing_External_Source (SUPL
+ * server, assistance XML files or a RINEX navigation file) and publishes it
+ * as an immutable snapshot, so a check costs a lock, a pointer copy and a map
+ * lookup instead of a network round trip on the receiver path. Data older
+ * than the refresh period is fetched again in the background; data older
+ * than the maximum age is still served but counted as stale.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_SPOOFING_EXTERNAL_NAV_H_
+#define GNSS_SDR_SPOOFING_EXTERNAL_NAV_H_
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <boost/thread.hpp>
+#include "gps_almanac.h"
+#include "gps_ephemeris.h"
+#include "gps_iono.h"
+#include "gps_ref_time.h"
+#include "gps_utc_model.h"
+#include "spoofing_stats.h"
+
+class ConfigurationInterface;
+
+enum Spoofing_External_Kind
+{
+    SPOOFING_EXTERNAL_EPHEMERIS = 0,
+    SPOOFING_EXTERNAL_ALMANAC,
+    SPOOFING_EXTERNAL_IONO,
+    SPOOFING_EXTERNAL_UTC,
+    SPOOFING_EXTERNAL_GPS_TIME,
+    SPOOFING_EXTERNAL_KINDS  //!< Number of kinds, not a kind
+};
+
+const char* spoofing_external_kind_name(Spoofing_External_Kind kind);
+
+
+/*!
+ * \brief One snapshot of the reference data. Only the kinds marked valid are set.
+ */
+struct Spoofing_External_Nav_Data
+{
+    std::map<int, Gps_Ephemeris> ephemeris;
+    std::map<int, Gps_Almanac> almanac;
+    Gps_Iono iono;
+    Gps_Utc_Model utc;
+    Gps_Ref_Time gps_time;
+
+    bool valid[SPOOFING_EXTERNAL_KINDS];
+    std::chrono::steady_clock::time_point fetched[SPOOFING_EXTERNAL_KINDS];
+
+    void set(Spoofing_External_Kind kind);                  //!< Marks \a kind as just fetched
+    double age_s(Spoofing_External_Kind kind) const;        //!< Seconds since \a kind was fetched
+
+    Spoofing_External_Nav_Data();
+};
+
+
+/*!
+ * \brief A provider of reference data. fetch() is only called from the worker
+ * thread and may block; it fills the kinds it obtained and marks them with
+ * Spoofing_External_Nav_Data::set(), possibly more than the one requested.
+ */
+class Spoofing_External_Source
+{
+public:
+    virtual ~Spoofing_External_Source() {}
+    virtual std::string name() const = 0;
+    virtual bool fetch(Spoofing_External_Kind kind, Spoofing_External_Nav_Data& data) = 0;
+
+    /*!
+     * \brief Source selected by Spoofing.external_source (supl, xml or rinex),
+     * null if the name is unknown
+     */
+    static std::shared_ptr<Spoofing_External_Source> create(ConfigurationInterface* configuration);
+};
+
+
+/*!
+ * \brief Assistance data from a SUPL server, one request per group: ephemeris,
+ * or almanac together with the ionospheric and UTC models and the GPS time.
+ */
+class Spoofing_Supl_Source : public Spoofing_External_Source
+{
+public:
+    Spoofing_Supl_Source(const std::string& server, int port, int mcc, int mns, int lac, int ci);
+    std::string name() const;
+    bool fetch(Spoofing_External_Kind kind, Spoofing_External_Nav_Data& data);
+
+private:
+    std::string d_server;
+    int d_port;
+    int d_mcc;
+    int d_mns;
+    int d_lac;
+    int d_ci;
+};
+
+
+/*!
+ * \brief Assistance data from the XML files written by the SUPL client
+ */
+class Spoofing_Xml_Source : public Spoofing_External_Source
+{
+public:
+    Spoofing_Xml_Source(const std::string& ephemeris_xml, const std::string& utc_xml,
+            const std::string& iono_xml, const std::string& ref_time_xml);
+    std::string name() const;
+    bool fetch(Spoofing_External_Kind kind, Spoofing_External_Nav_Data& data);
+
+private:
+    std::string d_ephemeris_xml;
+    std::string d_utc_xml;
+    std::string d_iono_xml;
+    std::string d_ref_time_xml;
+};
+
+
+/*!
+ * \brief Ephemerides and ionospheric and UTC models from a GPS RINEX
+ * navigation file (versions 2.x and 3.x). The latest ephemeris of each
+ * satellite is kept. RINEX carries no almanac and no GPS time.
+ */
+class Spoofing_Rinex_Source : public Spoofing_External_Source
+{
+public:
+    explicit Spoofing_Rinex_Source(const std::string& filename);
+    std::string name() const;
+    bool fetch(Spoofing_External_Kind kind, Spoofing_External_Nav_Data& data);
+
+    static bool read(const std::string& filename, Spoofing_External_Nav_Data& data);
+
+private:
+    std::string d_filename;
+};
+
+
+/*!
+ * \brief Cache of reference data refreshed by a worker thread
+ */
+class Spoofing_External_Nav
+{
+public:
+    /*!
+     * \brief Service shared by all the detectors of the receiver
+     */
+    static Spoofing_External_Nav& instance();
+
+    /*!
+     * \brief Starts the worker thread and prefetches every kind. Does nothing
+     * and returns true if already running.
+     */
+    bool start(std::shared_ptr<Spoofing_External_Source> source, double refresh_s, double max_age_s, double retry_s);
+    void stop();
+    bool is_running() const;
+
+    /*!
+     * \brief Current snapshot if it holds \a kind, null otherwise. Never blocks
+     * on a fetch: a missing or old \a kind is requested from the worker.
+     */
+    std::shared_ptr<const Spoofing_External_Nav_Data> lookup(Spoofing_External_Kind kind);
+
+    /*!
+     * \brief Current snapshot, without counting a lookup or requesting anything
+     */
+    std::shared_ptr<const Spoofing_External_Nav_Data> current() const;
+
+    /*!
+     * \brief Waits until \a kind is available or \a timeout_ms passes
+     */
+    bool wait_for(Spoofing_External_Kind kind, int timeout_ms);
+
+    unsigned long long get_hits(Spoofing_External_Kind kind) const;
+    unsigned long long get_misses(Spoofing_External_Kind kind) const;
+    unsigned long long get_stale(Spoofing_External_Kind kind) const;   //!< Hits on data older than max_age_s
+    unsigned long long get_fetches() const;
+    unsigned long long get_fetch_failures() const;
+    const Spoofing_Histogram& get_fetch_ms() const;
+    std::string to_json() const;
+
+    Spoofing_External_Nav();
+    ~Spoofing_External_Nav();
+
+private:
+    std::shared_ptr<Spoofing_External_Source> d_source;
+    double d_refresh_s;
+    double d_max_age_s;
+    double d_retry_s;
+
+    mutable boost::mutex d_mutex;
+    boost::condition_variable d_cond;
+    std::shared_ptr<const Spoofing_External_Nav_Data> d_data;
+    unsigned int d_wanted;   // kinds requested from the worker, bit per kind
+    std::chrono::steady_clock::time_point d_next_attempt[SPOOFING_EXTERNAL_KINDS];
+    bool d_stop;
+    bool d_running;
+    boost::thread d_thread;
+
+    std::atomic<unsigned long long> d_hits[SPOOFING_EXTERNAL_KINDS];
+    std::atomic<unsigned long long> d_misses[SPOOFING_EXTERNAL_KINDS];
+    std::atomic<unsigned long long> d_stale[SPOOFING_EXTERNAL_KINDS];
+    std::atomic<unsigned long long> d_fetches;
+    std::atomic<unsigned long long> d_fetch_failures;
+    Spoofing_Histogram d_fetch_ms;
+
+    void run();
+    void request(Spoofing_External_Kind kind);
+
+    Spoofing_External_Nav(const Spoofing_External_Nav&);
+    Spoofing_External_Nav& operator=(const Spoofing_External_Nav&);
+};
+
+
+/*!
+ * \brief Callbacks of one detector waiting for reference data.
+ *
+ * request() runs the callback at once on a cache hit. On a miss the callback
+ * is queued and run by a later deliver() on the same thread, once the worker
+ * has fetched the data, so checks never run concurrently with their detector.
+ * Copies share the service but not the queued callbacks.
+ */
+class Spoofing_External_Requests
+{
+public:
+    typedef std::function<void(const Spoofing_External_Nav_Data&)> Callback;
+
+    void request(Spoofing_External_Kind kind, Callback callback);
+    unsigned int deliver();       //!< Runs the queued callbacks that can be answered, returns how many
+    size_t pending() const;
+    unsigned long long get_dropped() const;
+
+    explicit Spoofing_External_Requests(Spoofing_External_Nav* service = nullptr, size_t max_pending = 64);
+    Spoofing_External_Requests(const Spoofing_External_Requests& other);
+    Spoofing_External_Requests& operator=(const Spoofing_External_Requests& other);
+
+private:
+    Spoofing_External_Nav* d_service;
+    size_t d_max_pending;
+    std::deque<std::pair<Spoofing_External_Kind, Callback>> d_pending;
+    unsigned long long d_dropped;
+};
+
+#endif
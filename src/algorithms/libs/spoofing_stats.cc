@@ -0,0 +1,629 @@
+/*!
+ * \file spoofing_stats.cc
+ * \brief Cost and detection-latency instrumentation of the spoofing detector.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "spoofing_stats.h"
+#include "spoofing_external_nav.h"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <glog/logging.h>
+
+using google::LogMessage;
+
+
+const char* spoofing_check_name(Spoofing_Check check)
+{
+    switch (check)
+    {
+    case SPOOFING_CHECK_NEW_SUBFRAME: return "new_subframe";
+    case SPOOFING_CHECK_POSITION: return "position";
+    case SPOOFING_CHECK_SATPOS: return "satpos";
+    case SPOOFING_CHECK_SNR: return "snr";
+    case SPOOFING_CHECK_SNR_CORR: return "snr_corr";
+    case SPOOFING_CHECK_PPE: return "ppe";
+    case SPOOFING_CHECK_PPE_MAX_VAR: return "ppe_max_var";
+    case SPOOFING_CHECK_STOP_TRACKING: return "stop_tracking";
+    case SPOOFING_CHECK_NEW_TOW: return "new_tow";
+    case SPOOFING_CHECK_MIDDLE_EARTH: return "middle_earth";
+    case SPOOFING_CHECK_GPS_TIME: return "gps_time";
+    case SPOOFING_CHECK_INTER_SATELLITE_SUBFRAME: return "inter_satellite_subframe";
+    case SPOOFING_CHECK_APT_SUBFRAME: return "apt_subframe";
+    case SPOOFING_CHECK_RX_TIME: return "rx_time";
+    case SPOOFING_CHECK_EXPECTED_EPHEMERIS: return "expected_ephemeris";
+    case SPOOFING_CHECK_EXTERNAL_EPHEMERIS: return "external_ephemeris";
+    case SPOOFING_CHECK_EXTERNAL_UTC: return "external_utc";
+    case SPOOFING_CHECK_EXTERNAL_IONO: return "external_iono";
+    case SPOOFING_CHECK_EXTERNAL_GPS_TIME: return "external_gps_time";
+    case SPOOFING_CHECK_EXTERNAL_ALMANAC: return "external_almanac";
+    case SPOOFING_CHECK_EXTERNAL_LOOKUP: return "external_lookup";
+    case SPOOFING_CHECK_UNSCOPED: return "unscoped";
+    default: return "unknown";
+    }
+}
+
+
+// ######## HISTOGRAM #########
+
+Spoofing_Histogram::Spoofing_Histogram()
+{
+    clear();
+}
+
+
+void Spoofing_Histogram::clear()
+{
+    for (unsigned int i = 0; i < BUCKETS; i++)
+        {
+            d_buckets[i] = 0;
+        }
+    d_count = 0;
+    d_sum = 0;
+    d_max = 0;
+}
+
+
+unsigned int Spoofing_Histogram::bucket_of(unsigned long long value)
+{
+    unsigned int i = 0;
+    while (value != 0 && i < BUCKETS - 1)
+        {
+            value >>= 1;
+            i++;
+        }
+    return i;
+}
+
+
+unsigned long long Spoofing_Histogram::upper_bound(unsigned int i)
+{
+    if (i == 0) return 0;
+    if (i >= 64) return ~0ULL;
+    return (1ULL << i) - 1;
+}
+
+
+void Spoofing_Histogram::add(unsigned long long value)
+{
+    d_buckets[bucket_of(value)].fetch_add(1, std::memory_order_relaxed);
+    d_count.fetch_add(1, std::memory_order_relaxed);
+    d_sum.fetch_add(value, std::memory_order_relaxed);
+    unsigned long long max = d_max.load(std::memory_order_relaxed);
+    while (value > max && !d_max.compare_exchange_weak(max, value, std::memory_order_relaxed))
+        {}
+}
+
+
+unsigned long long Spoofing_Histogram::count() const
+{
+    return d_count.load(std::memory_order_relaxed);
+}
+
+
+unsigned long long Spoofing_Histogram::sum() const
+{
+    return d_sum.load(std::memory_order_relaxed);
+}
+
+
+unsigned long long Spoofing_Histogram::max() const
+{
+    return d_max.load(std::memory_order_relaxed);
+}
+
+
+unsigned long long Spoofing_Histogram::bucket(unsigned int i) const
+{
+    return d_buckets[i].load(std::memory_order_relaxed);
+}
+
+
+double Spoofing_Histogram::mean() const
+{
+    unsigned long long n = count();
+    if (n == 0) return 0.0;
+    return static_cast<double>(sum()) / static_cast<double>(n);
+}
+
+
+unsigned long long Spoofing_Histogram::quantile(double q) const
+{
+    unsigned long long total = 0;
+    unsigned long long counts[BUCKETS];
+    for (unsigned int i = 0; i < BUCKETS; i++)
+        {
+            counts[i] = bucket(i);
+            total += counts[i];
+        }
+    if (total == 0) return 0;
+    unsigned long long rank = static_cast<unsigned long long>(std::ceil(q * static_cast<double>(total)));
+    if (rank < 1) rank = 1;
+    unsigned long long seen = 0;
+    for (unsigned int i = 0; i < BUCKETS; i++)
+        {
+            seen += counts[i];
+            if (seen >= rank)
+                {
+                    // the largest recorded value is a tighter bound for the top bucket
+                    return std::min(upper_bound(i), max());
+                }
+        }
+    return max();
+}
+
+
+std::string Spoofing_Histogram::to_json() const
+{
+    std::stringstream s;
+    s << "{\"count\":" << count()
+      << ",\"sum\":" << sum()
+      << ",\"mean\":" << mean()
+      << ",\"max\":" << max()
+      << ",\"p50\":" << quantile(0.5)
+      << ",\"p90\":" << quantile(0.9)
+      << ",\"p99\":" << quantile(0.99)
+      << ",\"buckets\":[";
+    // trailing empty buckets are omitted
+    unsigned int last = 0;
+    for (unsigned int i = 0; i < BUCKETS; i++)
+        {
+            if (bucket(i) != 0) last = i + 1;
+        }
+    for (unsigned int i = 0; i < last; i++)
+        {
+            s << (i ? "," : "") << bucket(i);
+        }
+    s << "]}";
+    return s.str();
+}
+
+
+// ######## PROCESS-WIDE STATISTICS #########
+
+Spoofing_Stats& Spoofing_Stats::instance()
+{
+    static Spoofing_Stats stats;
+    return stats;
+}
+
+
+Spoofing_Stats::Spoofing_Stats()
+{
+    reset();
+}
+
+
+void Spoofing_Stats::reset()
+{
+    for (unsigned int i = 0; i < SPOOFING_CHECKS; i++)
+        {
+            d_time_ns[i].clear();
+            d_self_ns[i] = 0;
+            d_alarms[i] = 0;
+        }
+    for (unsigned int i = 0; i < MAX_CASES; i++)
+        {
+            d_latency_ms[i].clear();
+            d_processing_ns[i].clear();
+        }
+    d_start = std::chrono::steady_clock::now();
+}
+
+
+unsigned int Spoofing_Stats::case_index(int spoofing_case)
+{
+    if (spoofing_case < 0) return 0;
+    if (spoofing_case >= static_cast<int>(MAX_CASES)) return MAX_CASES - 1;
+    return spoofing_case;
+}
+
+
+void Spoofing_Stats::add_call(Spoofing_Check check, unsigned long long time_ns, unsigned long long self_ns)
+{
+    d_time_ns[check].add(time_ns);
+    d_self_ns[check].fetch_add(self_ns, std::memory_order_relaxed);
+}
+
+
+void Spoofing_Stats::add_alarm(Spoofing_Check check, int spoofing_case, double latency_ms, unsigned long long processing_ns)
+{
+    unsigned int c = case_index(spoofing_case);
+    d_alarms[check].fetch_add(1, std::memory_order_relaxed);
+    if (check != SPOOFING_CHECK_UNSCOPED)
+        {
+            // no check was timed, so there is no processing time to record
+            d_processing_ns[c].add(processing_ns);
+        }
+    if (latency_ms >= 0.0)
+        {
+            d_latency_ms[c].add(static_cast<unsigned long long>(std::round(latency_ms)));
+        }
+}
+
+
+unsigned long long Spoofing_Stats::get_calls(Spoofing_Check check) const
+{
+    return d_time_ns[check].count();
+}
+
+
+unsigned long long Spoofing_Stats::get_alarms(Spoofing_Check check) const
+{
+    return d_alarms[check].load(std::memory_order_relaxed);
+}
+
+
+unsigned long long Spoofing_Stats::get_self_ns(Spoofing_Check check) const
+{
+    return d_self_ns[check].load(std::memory_order_relaxed);
+}
+
+
+const Spoofing_Histogram& Spoofing_Stats::get_time_ns(Spoofing_Check check) const
+{
+    return d_time_ns[check];
+}
+
+
+const Spoofing_Histogram& Spoofing_Stats::get_latency_ms(int spoofing_case) const
+{
+    return d_latency_ms[case_index(spoofing_case)];
+}
+
+
+const Spoofing_Histogram& Spoofing_Stats::get_processing_ns(int spoofing_case) const
+{
+    return d_processing_ns[case_index(spoofing_case)];
+}
+
+
+std::string Spoofing_Stats::to_json() const
+{
+    double uptime_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - d_start).count();
+    std::stringstream s;
+    s << "{\"uptime_s\":" << uptime_s << ",\"checks\":{";
+    bool first = true;
+    for (unsigned int i = 0; i < SPOOFING_CHECKS; i++)
+        {
+            Spoofing_Check check = static_cast<Spoofing_Check>(i);
+            if (get_calls(check) == 0 && get_alarms(check) == 0) continue;
+            s << (first ? "" : ",") << "\"" << spoofing_check_name(check) << "\":{"
+              << "\"calls\":" << get_calls(check)
+              << ",\"alarms\":" << get_alarms(check)
+              << ",\"self_ns\":" << get_self_ns(check)
+              << ",\"time_ns\":" << d_time_ns[i].to_json() << "}";
+            first = false;
+        }
+    s << "},\"alarms\":{";
+    first = true;
+    for (unsigned int i = 0; i < MAX_CASES; i++)
+        {
+            if (d_processing_ns[i].count() == 0) continue;
+            s << (first ? "" : ",") << "\"" << i << "\":{"
+              << "\"count\":" << d_processing_ns[i].count()
+              << ",\"latency_ms\":" << d_latency_ms[i].to_json()
+              << ",\"processing_ns\":" << d_processing_ns[i].to_json() << "}";
+            first = false;
+        }
+    s << "}";
+    if (Spoofing_External_Nav::instance().is_running())
+        {
+            s << ",\"external_nav\":" << Spoofing_External_Nav::instance().to_json();
+        }
+    s << "}\n";
+    return s.str();
+}
+
+
+// ######## CHECK SCOPES #########
+
+thread_local Spoofing_Check_Scope* Spoofing_Check_Scope::d_current = nullptr;
+
+
+Spoofing_Check_Scope::Spoofing_Check_Scope(Spoofing_Check check)
+{
+    d_check = check;
+    d_children_ns = 0;
+    d_parent = d_current;
+    d_now_ms = d_parent ? d_parent->d_now_ms : -1.0;
+    d_current = this;
+    d_start = std::chrono::steady_clock::now();
+}
+
+
+Spoofing_Check_Scope::Spoofing_Check_Scope(Spoofing_Check check, double now_ms)
+{
+    d_check = check;
+    d_children_ns = 0;
+    d_parent = d_current;
+    d_now_ms = now_ms;
+    d_current = this;
+    d_start = std::chrono::steady_clock::now();
+}
+
+
+Spoofing_Check_Scope::~Spoofing_Check_Scope()
+{
+    unsigned long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - d_start).count();
+    unsigned long long self_ns = ns > d_children_ns ? ns - d_children_ns : 0;
+    Spoofing_Stats::instance().add_call(d_check, ns, self_ns);
+    if (d_parent)
+        {
+            d_parent->d_children_ns += ns;
+        }
+    d_current = d_parent;
+}
+
+
+void Spoofing_Check_Scope::alarm(Spoofing_Message& msg)
+{
+    Spoofing_Check_Scope* scope = d_current;
+    Spoofing_Check check = SPOOFING_CHECK_UNSCOPED;
+    unsigned long long processing_ns = 0;
+    if (scope != nullptr)
+        {
+            if (msg.alarm_time_ms < 0.0) msg.alarm_time_ms = scope->d_now_ms;
+            Spoofing_Check_Scope* root = scope;
+            while (root->d_parent) root = root->d_parent;
+            processing_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - root->d_start).count();
+            check = scope->d_check;
+        }
+
+    double latency_ms = -1.0;
+    if (msg.evidence_time_ms >= 0.0 && msg.alarm_time_ms >= 0.0)
+        {
+            latency_ms = std::max(msg.alarm_time_ms - msg.evidence_time_ms, 0.0);
+        }
+    Spoofing_Stats::instance().add_alarm(check, msg.spoofing_case, latency_ms, processing_ns);
+}
+
+
+// ######## STATISTICS SERVER #########
+
+Spoofing_Stats_Server::Spoofing_Stats_Server()
+{
+    d_json = []() { return Spoofing_Stats::instance().to_json(); };
+    d_what = "Spoofing stats";
+    d_period_ms = 1000;
+    d_unix_fd = -1;
+    d_http_fd = -1;
+    d_stop = true;
+}
+
+
+Spoofing_Stats_Server::Spoofing_Stats_Server(std::function<std::string()> json, const std::string& what)
+{
+    d_json = json;
+    d_what = what;
+    d_period_ms = 1000;
+    d_unix_fd = -1;
+    d_http_fd = -1;
+    d_stop = true;
+}
+
+
+Spoofing_Stats_Server::~Spoofing_Stats_Server()
+{
+    stop();
+}
+
+
+bool Spoofing_Stats_Server::dump(const std::string& filename)
+{
+    Spoofing_Stats_Server server;
+    return server.write(filename);
+}
+
+
+bool Spoofing_Stats_Server::write(const std::string& filename)
+{
+    std::string tmp = filename + ".tmp";
+    std::ofstream f(tmp.c_str(), std::ios::out | std::ios::trunc);
+    if (!f.is_open())
+        {
+            return false;
+        }
+    f << d_json();
+    f.close();
+    return std::rename(tmp.c_str(), filename.c_str()) == 0;
+}
+
+
+bool Spoofing_Stats_Server::start(const std::string& filename, int period_ms, const std::string& socket_path, int http_port)
+{
+    stop();
+    d_filename = filename;
+    d_socket_path = socket_path;
+    d_period_ms = period_ms > 0 ? period_ms : 1000;
+
+    if (!d_socket_path.empty())
+        {
+            struct sockaddr_un addr;
+            std::memset(&addr, 0, sizeof(addr));
+            addr.sun_family = AF_UNIX;
+            std::strncpy(addr.sun_path, d_socket_path.c_str(), sizeof(addr.sun_path) - 1);
+            ::unlink(d_socket_path.c_str());
+            d_unix_fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+            if (d_unix_fd < 0
+                || ::bind(d_unix_fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) != 0
+                || ::listen(d_unix_fd, 4) != 0)
+                {
+                    LOG(WARNING) << d_what << ": unable to listen on " << d_socket_path << ": " << std::strerror(errno);
+                    if (d_unix_fd >= 0) ::close(d_unix_fd);
+                    d_unix_fd = -1;
+                }
+        }
+    if (http_port > 0)
+        {
+            struct sockaddr_in addr;
+            std::memset(&addr, 0, sizeof(addr));
+            addr.sin_family = AF_INET;
+            addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            addr.sin_port = htons(http_port);
+            int one = 1;
+            d_http_fd = ::socket(AF_INET, SOCK_STREAM, 0);
+            if (d_http_fd >= 0) ::setsockopt(d_http_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+            if (d_http_fd < 0
+                || ::bind(d_http_fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) != 0
+                || ::listen(d_http_fd, 4) != 0)
+                {
+                    LOG(WARNING) << d_what << ": unable to listen on 127.0.0.1:" << http_port << ": " << std::strerror(errno);
+                    if (d_http_fd >= 0) ::close(d_http_fd);
+                    d_http_fd = -1;
+                }
+        }
+    if (d_filename.empty() && d_unix_fd < 0 && d_http_fd < 0)
+        {
+            return false;
+        }
+    d_stop = false;
+    d_thread = boost::thread(&Spoofing_Stats_Server::run, this);
+    return true;
+}
+
+
+bool Spoofing_Stats_Server::is_running() const
+{
+    return !d_stop;
+}
+
+
+void Spoofing_Stats_Server::stop()
+{
+    if (d_stop) return;
+    d_stop = true;
+    d_thread.join();
+    close_sockets();
+    if (!d_filename.empty())
+        {
+            write(d_filename);
+        }
+}
+
+
+void Spoofing_Stats_Server::close_sockets()
+{
+    if (d_unix_fd >= 0)
+        {
+            ::close(d_unix_fd);
+            ::unlink(d_socket_path.c_str());
+            d_unix_fd = -1;
+        }
+    if (d_http_fd >= 0)
+        {
+            ::close(d_http_fd);
+            d_http_fd = -1;
+        }
+}
+
+
+void Spoofing_Stats_Server::run()
+{
+    std::chrono::steady_clock::time_point next_dump = std::chrono::steady_clock::now() + std::chrono::milliseconds(d_period_ms);
+    while (!d_stop)
+        {
+            struct pollfd fds[2];
+            nfds_t n = 0;
+            if (d_unix_fd >= 0) { fds[n].fd = d_unix_fd; fds[n].events = POLLIN; n++; }
+            if (d_http_fd >= 0) { fds[n].fd = d_http_fd; fds[n].events = POLLIN; n++; }
+
+            // wake up at least every 100 ms to notice stop()
+            long int wait_ms = std::chrono::duration_cast<std::chrono::milliseconds>(next_dump - std::chrono::steady_clock::now()).count();
+            wait_ms = std::max(0L, std::min(wait_ms, 100L));
+            int ready = 0;
+            if (n > 0)
+                {
+                    ready = ::poll(fds, n, wait_ms);
+                }
+            else
+                {
+                    boost::this_thread::sleep_for(boost::chrono::milliseconds(wait_ms));
+                }
+            for (nfds_t i = 0; ready > 0 && i < n; i++)
+                {
+                    if (fds[i].revents & POLLIN)
+                        {
+                            serve(fds[i].fd, fds[i].fd == d_http_fd);
+                        }
+                }
+
+            if (!d_filename.empty() && std::chrono::steady_clock::now() >= next_dump)
+                {
+                    if (!write(d_filename))
+                        {
+                            LOG(WARNING) << d_what << ": unable to write " << d_filename;
+                        }
+                    next_dump += std::chrono::milliseconds(d_period_ms);
+                }
+        }
+}
+
+
+void Spoofing_Stats_Server::serve(int listen_fd, bool http)
+{
+    int fd = ::accept(listen_fd, nullptr, nullptr);
+    if (fd < 0) return;
+    std::string body = d_json();
+    std::string reply = body;
+    if (http)
+        {
+            // the request itself is not interpreted: every path returns the statistics
+            struct pollfd pfd;
+            pfd.fd = fd;
+            pfd.events = POLLIN;
+            char request[1024];
+            if (::poll(&pfd, 1, 100) > 0)
+                {
+                    ssize_t r = ::recv(fd, request, sizeof(request), 0);
+                    (void)r;
+                }
+            std::stringstream s;
+            s << "HTTP/1.0 200 OK\r\nContent-Type: application/json\r\nContent-Length: " << body.size()
+              << "\r\nConnection: close\r\n\r\n" << body;
+            reply = s.str();
+        }
+    size_t sent = 0;
+    while (sent < reply.size())
+        {
+            ssize_t w = ::send(fd, reply.data() + sent, reply.size() - sent, MSG_NOSIGNAL);
+            if (w <= 0) break;
+            sent += w;
+        }
+    ::close(fd);
+}
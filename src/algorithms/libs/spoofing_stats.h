@@ -0,0 +1,263 @@
+/*!
+ * \file spoofing_stats.h
+ * \brief Cost and detection-latency instrumentation of the spoofing detector:
+ * per-check timing histograms, call and alarm counters, and alarm latencies,
+ * dumped periodically as JSON and optionally served on a local socket.
+ *
+ * Histograms have logarithmic (power of two) buckets held in atomics, so
+ * several detector instances running in different blocks can record into
+ * the same process-wide Spoofing_Stats without locking.
+ *
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_SPOOFING_STATS_H_
+#define GNSS_SDR_SPOOFING_STATS_H_
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <boost/thread.hpp>
+#include "spoofing_message.h"
+
+
+/*!
+ * \brief Checks of Spoofing_Detector whose cost and alarms are accounted for.
+ */
+enum Spoofing_Check
+{
+    SPOOFING_CHECK_NEW_SUBFRAME = 0,
+    SPOOFING_CHECK_POSITION,
+    SPOOFING_CHECK_SATPOS,
+    SPOOFING_CHECK_SNR,
+    SPOOFING_CHECK_SNR_CORR,
+    SPOOFING_CHECK_PPE,
+    SPOOFING_CHECK_PPE_MAX_VAR,
+    SPOOFING_CHECK_STOP_TRACKING,
+    SPOOFING_CHECK_NEW_TOW,
+    SPOOFING_CHECK_MIDDLE_EARTH,
+    SPOOFING_CHECK_GPS_TIME,
+    SPOOFING_CHECK_INTER_SATELLITE_SUBFRAME,
+    SPOOFING_CHECK_APT_SUBFRAME,
+    SPOOFING_CHECK_RX_TIME,
+    SPOOFING_CHECK_EXPECTED_EPHEMERIS,
+    SPOOFING_CHECK_EXTERNAL_EPHEMERIS,
+    SPOOFING_CHECK_EXTERNAL_UTC,
+    SPOOFING_CHECK_EXTERNAL_IONO,
+    SPOOFING_CHECK_EXTERNAL_GPS_TIME,
+    SPOOFING_CHECK_EXTERNAL_ALMANAC,
+    SPOOFING_CHECK_EXTERNAL_LOOKUP,
+    SPOOFING_CHECK_UNSCOPED, //!< Alarms raised outside any instrumented check
+    SPOOFING_CHECKS //!< Number of checks, not a check
+};
+
+const char* spoofing_check_name(Spoofing_Check check);
+
+
+/*!
+ * \brief Histogram of non-negative integer values with power of two buckets:
+ * bucket 0 holds 0 and bucket i > 0 holds [2^(i-1), 2^i - 1].
+ */
+class Spoofing_Histogram
+{
+public:
+    static const unsigned int BUCKETS = 48;
+
+    void add(unsigned long long value);
+    void clear();
+
+    unsigned long long count() const;
+    unsigned long long sum() const;
+    unsigned long long max() const;
+    unsigned long long bucket(unsigned int i) const;
+    double mean() const;
+
+    /*!
+     * \brief Upper bound of the bucket that holds quantile q (0 < q <= 1),
+     * i.e. a value that at least a fraction q of the samples do not exceed.
+     */
+    unsigned long long quantile(double q) const;
+
+    static unsigned int bucket_of(unsigned long long value);
+    static unsigned long long upper_bound(unsigned int i);
+
+    std::string to_json() const;
+
+    Spoofing_Histogram();
+
+private:
+    std::atomic<unsigned long long> d_buckets[BUCKETS];
+    std::atomic<unsigned long long> d_count;
+    std::atomic<unsigned long long> d_sum;
+    std::atomic<unsigned long long> d_max;
+
+    Spoofing_Histogram(const Spoofing_Histogram&);
+    Spoofing_Histogram& operator=(const Spoofing_Histogram&);
+};
+
+
+/*!
+ * \brief Process-wide statistics of every Spoofing_Detector instance.
+ *
+ * For each check: number of calls, wall-clock time per call (including the
+ * checks it calls) and self time (excluding them), and alarms raised. For each
+ * spoofing case: the alarm latency in receiver time, that is the receiver time
+ * at which the alarm is raised minus the receiver time of the evidence that
+ * triggered it, and the processing time from the detector entry to the alarm.
+ */
+class Spoofing_Stats
+{
+public:
+    static const unsigned int MAX_CASES = 32; //!< Spoofing cases >= MAX_CASES are counted as MAX_CASES - 1
+
+    static Spoofing_Stats& instance();
+
+    void add_call(Spoofing_Check check, unsigned long long time_ns, unsigned long long self_ns);
+    void add_alarm(Spoofing_Check check, int spoofing_case, double latency_ms, unsigned long long processing_ns);
+    void reset();
+
+    unsigned long long get_calls(Spoofing_Check check) const;
+    unsigned long long get_alarms(Spoofing_Check check) const;
+    unsigned long long get_self_ns(Spoofing_Check check) const;
+    const Spoofing_Histogram& get_time_ns(Spoofing_Check check) const;
+    const Spoofing_Histogram& get_latency_ms(int spoofing_case) const;
+    const Spoofing_Histogram& get_processing_ns(int spoofing_case) const;
+
+    std::string to_json() const;
+
+private:
+    Spoofing_Histogram d_time_ns[SPOOFING_CHECKS];
+    std::atomic<unsigned long long> d_self_ns[SPOOFING_CHECKS];
+    std::atomic<unsigned long long> d_alarms[SPOOFING_CHECKS];
+    Spoofing_Histogram d_latency_ms[MAX_CASES];
+    Spoofing_Histogram d_processing_ns[MAX_CASES];
+    std::chrono::steady_clock::time_point d_start;
+
+    static unsigned int case_index(int spoofing_case);
+
+    Spoofing_Stats();
+    Spoofing_Stats(const Spoofing_Stats&);
+    Spoofing_Stats& operator=(const Spoofing_Stats&);
+};
+
+
+/*!
+ * \brief Times one check from construction to destruction and records it in
+ * Spoofing_Stats::instance(). Scopes nest per thread: alarms are accounted to
+ * the innermost open check, and a nested scope takes the receiver times of
+ * the detector entry point that opened the outermost one.
+ */
+class Spoofing_Check_Scope
+{
+public:
+    explicit Spoofing_Check_Scope(Spoofing_Check check);
+
+    /*!
+     * \brief Scope of a detector entry point that runs at receiver time \a now_ms [ms].
+     */
+    Spoofing_Check_Scope(Spoofing_Check check, double now_ms);
+    ~Spoofing_Check_Scope();
+
+    /*!
+     * \brief Stamps the alarm receiver time of \a msg (unless the check already
+     * set it) and records the alarm against the open check. The evidence time is
+     * only set by the check that raised the alarm; the latency of alarms without
+     * one is unknown and not recorded.
+     */
+    static void alarm(Spoofing_Message& msg);
+
+private:
+    Spoofing_Check d_check;
+    std::chrono::steady_clock::time_point d_start;
+    unsigned long long d_children_ns;
+    double d_now_ms;
+    Spoofing_Check_Scope* d_parent;
+
+    static thread_local Spoofing_Check_Scope* d_current;
+
+    Spoofing_Check_Scope(const Spoofing_Check_Scope&);
+    Spoofing_Check_Scope& operator=(const Spoofing_Check_Scope&);
+};
+
+
+/*!
+ * \brief Publishes Spoofing_Stats::instance() as JSON: written to a file every
+ * period, and returned to every client of an optional UNIX socket and of an
+ * optional HTTP endpoint on 127.0.0.1. Other statistics are published the same
+ * way by giving their JSON source to the constructor.
+ */
+class Spoofing_Stats_Server
+{
+public:
+    /*!
+     * \brief Starts the publishing thread. Empty \a filename, empty \a socket_path
+     * and \a http_port 0 disable the corresponding output. Returns false if
+     * nothing is enabled or no requested output could be set up.
+     */
+    bool start(const std::string& filename, int period_ms, const std::string& socket_path, int http_port);
+
+    /*!
+     * \brief Stops the thread and writes a last dump.
+     */
+    void stop();
+    bool is_running() const;
+
+    /*!
+     * \brief Writes the current statistics to \a filename, atomically replacing it.
+     */
+    static bool dump(const std::string& filename);
+
+    Spoofing_Stats_Server();
+
+    /*!
+     * \brief Publishes the documents returned by \a json instead; \a what
+     * names them in the log messages.
+     */
+    Spoofing_Stats_Server(std::function<std::string()> json, const std::string& what);
+    ~Spoofing_Stats_Server();
+
+private:
+    std::function<std::string()> d_json;
+    std::string d_what;
+    std::string d_filename;
+    std::string d_socket_path;
+    int d_period_ms;
+    int d_unix_fd;
+    int d_http_fd;
+    std::atomic<bool> d_stop;
+    boost::thread d_thread;
+
+    void run();
+    bool write(const std::string& filename);
+    void serve(int listen_fd, bool http);
+    void close_sockets();
+
+    Spoofing_Stats_Server(const Spoofing_Stats_Server&);
+    Spoofing_Stats_Server& operator=(const Spoofing_Stats_Server&);
+};
+
+#endif
@@ -0,0 +1,139 @@
+/*!
+ * \file volk_gnsssdr_16ic_s32fc_s32f_convert_32fc.h
+ * \brief VOLK_GNSSSDR kernel: converts 16-bit complex integers to floats with DC offset removal and scaling.
+ *
+ * VOLK_GNSSSDR kernel that widens complex 16-bit integer samples to complex floats,
+ * subtracting a DC offset and applying a scale factor in the same pass
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+/*!
+ * \page volk_gnsssdr_16ic_s32fc_s32f_convert_32fc
+ *
+ * \b Overview
+ *
+ * Widens complex 16-bit integer samples to complex floats, subtracting a DC
+ * offset and applying a scale factor in the same pass:
+ * result[i] = (in[i] - offset) * scale.
+ *
+ * <b>Dispatcher Prototype</b>
+ * \code
+ * void volk_gnsssdr_16ic_s32fc_s32f_convert_32fc(lv_32fc_t* result, const lv_16sc_t* in, const lv_32fc_t offset, const float scale, unsigned int num_points)
+ * \endcode
+ *
+ * \b Inputs
+ * \li in: Complex 16-bit integer samples (interleaved I/Q shorts).
+ * \li offset: DC offset to subtract, in input units.
+ * \li scale: Factor applied after subtracting the offset.
+ * \li num_points: Number of complex samples.
+ *
+ * \b Outputs
+ * \li result: Converted complex samples.
+ *
+ */
+
+#ifndef INCLUDED_volk_gnsssdr_16ic_s32fc_s32f_convert_32fc_H
+#define INCLUDED_volk_gnsssdr_16ic_s32fc_s32f_convert_32fc_H
+
+#include <volk_gnsssdr/volk_gnsssdr_complex.h>
+
+
+#ifdef LV_HAVE_GENERIC
+
+static inline void volk_gnsssdr_16ic_s32fc_s32f_convert_32fc_generic(lv_32fc_t* result, const lv_16sc_t* in, const lv_32fc_t offset, const float scale, unsigned int num_points)
+{
+    const short* inPtr = (const short*)in;
+    float* outPtr = (float*)result;
+    const float offset_i = lv_creal(offset);
+    const float offset_q = lv_cimag(offset);
+    unsigned int number;
+    for(number = 0; number < num_points; number++)
+        {
+            *outPtr++ = ((float)(*inPtr++) - offset_i) * scale;
+            *outPtr++ = ((float)(*inPtr++) - offset_q) * scale;
+        }
+}
+
+#endif /* LV_HAVE_GENERIC */
+
+
+#ifdef LV_HAVE_SSE2
+#include <emmintrin.h>
+
+static inline void volk_gnsssdr_16ic_s32fc_s32f_convert_32fc_u_sse2(lv_32fc_t* result, const lv_16sc_t* in, const lv_32fc_t offset, const float scale, unsigned int num_points)
+{
+    const unsigned int sse_iters = num_points / 4;
+    const short* inPtr = (const short*)in;
+    float* outPtr = (float*)result;
+    const __m128 off = _mm_setr_ps(lv_creal(offset), lv_cimag(offset), lv_creal(offset), lv_cimag(offset));
+    const __m128 sc = _mm_set1_ps(scale);
+    __m128i x;
+    unsigned int number;
+
+    for(number = 0; number < sse_iters; number++)
+        {
+            x = _mm_loadu_si128((__m128i*)inPtr);
+            // sign-extend to 32 bits by unpacking each value with itself and shifting back
+            _mm_storeu_ps(outPtr, _mm_mul_ps(_mm_sub_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16)), off), sc));
+            _mm_storeu_ps(outPtr + 4, _mm_mul_ps(_mm_sub_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16)), off), sc));
+            inPtr += 8;
+            outPtr += 8;
+        }
+
+    volk_gnsssdr_16ic_s32fc_s32f_convert_32fc_generic((lv_32fc_t*)outPtr, (const lv_16sc_t*)inPtr, offset, scale, num_points - sse_iters * 4);
+}
+
+#endif /* LV_HAVE_SSE2 */
+
+
+#ifdef LV_HAVE_AVX2
+#include <immintrin.h>
+
+static inline void volk_gnsssdr_16ic_s32fc_s32f_convert_32fc_u_avx2(lv_32fc_t* result, const lv_16sc_t* in, const lv_32fc_t offset, const float scale, unsigned int num_points)
+{
+    const unsigned int avx2_iters = num_points / 8;
+    const short* inPtr = (const short*)in;
+    float* outPtr = (float*)result;
+    const __m256 off = _mm256_setr_ps(lv_creal(offset), lv_cimag(offset), lv_creal(offset), lv_cimag(offset),
+            lv_creal(offset), lv_cimag(offset), lv_creal(offset), lv_cimag(offset));
+    const __m256 sc = _mm256_set1_ps(scale);
+    unsigned int number;
+
+    for(number = 0; number < avx2_iters; number++)
+        {
+            _mm256_storeu_ps(outPtr, _mm256_mul_ps(_mm256_sub_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128((__m128i*)inPtr))), off), sc));
+            _mm256_storeu_ps(outPtr + 8, _mm256_mul_ps(_mm256_sub_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128((__m128i*)(inPtr + 8)))), off), sc));
+            inPtr += 16;
+            outPtr += 16;
+        }
+    _mm256_zeroupper();
+
+    volk_gnsssdr_16ic_s32fc_s32f_convert_32fc_generic((lv_32fc_t*)outPtr, (const lv_16sc_t*)inPtr, offset, scale, num_points - avx2_iters * 8);
+}
+
+#endif /* LV_HAVE_AVX2 */
+
+#endif /* INCLUDED_volk_gnsssdr_16ic_s32fc_s32f_convert_32fc_H */
@@ -0,0 +1,148 @@
+/*!
+ * \file volk_gnsssdr_32u_unpack1bit_8ic.h
+ * \brief VOLK_GNSSSDR kernel: unpacks 1-bit I/Q samples to 8-bit complex integers.
+ *
+ * VOLK_GNSSSDR kernel that extracts one 1-bit I/Q pair from each 32-bit word,
+ * as in the SPIR front-end format, and expands it to +1/-1 complex samples
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+/*!
+ * \page volk_gnsssdr_32u_unpack1bit_8ic
+ *
+ * \b Overview
+ *
+ * For each input word, bit \p bit_offset is the I sample and bit
+ * \p bit_offset + 1 the Q sample: a set bit gives +1, a clear one -1.
+ *
+ * <b>Dispatcher Prototype</b>
+ * \code
+ * void volk_gnsssdr_32u_unpack1bit_8ic(lv_8sc_t* result, const unsigned int* in, unsigned int bit_offset, unsigned int num_points)
+ * \endcode
+ *
+ * \b Inputs
+ * \li in: Input words, one per complex sample.
+ * \li bit_offset: Position of the I bit, at most 30.
+ * \li num_points: Number of complex samples.
+ *
+ * \b Outputs
+ * \li result: Unpacked complex samples.
+ *
+ */
+
+#ifndef INCLUDED_volk_gnsssdr_32u_unpack1bit_8ic_H
+#define INCLUDED_volk_gnsssdr_32u_unpack1bit_8ic_H
+
+#include <volk_gnsssdr/volk_gnsssdr_complex.h>
+
+
+#ifdef LV_HAVE_GENERIC
+
+static inline void volk_gnsssdr_32u_unpack1bit_8ic_generic(lv_8sc_t* result, const unsigned int* in, unsigned int bit_offset, unsigned int num_points)
+{
+    char* outPtr = (char*)result;
+    unsigned int number;
+    for(number = 0; number < num_points; number++)
+        {
+            *outPtr++ = ((in[number] >> bit_offset) & 1) ? 1 : -1;
+            *outPtr++ = ((in[number] >> (bit_offset + 1)) & 1) ? 1 : -1;
+        }
+}
+
+#endif /* LV_HAVE_GENERIC */
+
+
+#ifdef LV_HAVE_SSE2
+#include <emmintrin.h>
+
+static inline void volk_gnsssdr_32u_unpack1bit_8ic_u_sse2(lv_8sc_t* result, const unsigned int* in, unsigned int bit_offset, unsigned int num_points)
+{
+    const unsigned int sse_iters = num_points / 8;
+    const unsigned int* inPtr = in;
+    char* outPtr = (char*)result;
+    const __m128i shift = _mm_cvtsi32_si128(bit_offset);
+    const __m128i i_bit = _mm_set1_epi32(1);
+    const __m128i q_bit = _mm_set1_epi32(2);
+    const __m128i ones = _mm_set1_epi8(1);
+    __m128i w0, w1, p;
+    unsigned int number;
+
+    for(number = 0; number < sse_iters; number++)
+        {
+            w0 = _mm_srl_epi32(_mm_loadu_si128((__m128i*)inPtr), shift);
+            w1 = _mm_srl_epi32(_mm_loadu_si128((__m128i*)(inPtr + 4)), shift);
+            // I bit to byte 0 and Q bit to byte 1 of each word, then keep the low 16 bits
+            w0 = _mm_or_si128(_mm_and_si128(w0, i_bit), _mm_slli_epi32(_mm_and_si128(w0, q_bit), 7));
+            w1 = _mm_or_si128(_mm_and_si128(w1, i_bit), _mm_slli_epi32(_mm_and_si128(w1, q_bit), 7));
+            p = _mm_packs_epi32(w0, w1);
+            // 0/1 to -1/+1
+            p = _mm_sub_epi8(_mm_add_epi8(p, p), ones);
+            _mm_storeu_si128((__m128i*)outPtr, p);
+            inPtr += 8;
+            outPtr += 16;
+        }
+
+    volk_gnsssdr_32u_unpack1bit_8ic_generic((lv_8sc_t*)outPtr, inPtr, bit_offset, num_points - sse_iters * 8);
+}
+
+#endif /* LV_HAVE_SSE2 */
+
+
+#ifdef LV_HAVE_AVX2
+#include <immintrin.h>
+
+static inline void volk_gnsssdr_32u_unpack1bit_8ic_u_avx2(lv_8sc_t* result, const unsigned int* in, unsigned int bit_offset, unsigned int num_points)
+{
+    const unsigned int avx2_iters = num_points / 16;
+    const unsigned int* inPtr = in;
+    char* outPtr = (char*)result;
+    const __m128i shift = _mm_cvtsi32_si128(bit_offset);
+    const __m256i i_bit = _mm256_set1_epi32(1);
+    const __m256i q_bit = _mm256_set1_epi32(2);
+    const __m256i ones = _mm256_set1_epi8(1);
+    __m256i w0, w1, p;
+    unsigned int number;
+
+    for(number = 0; number < avx2_iters; number++)
+        {
+            w0 = _mm256_srl_epi32(_mm256_loadu_si256((__m256i*)inPtr), shift);
+            w1 = _mm256_srl_epi32(_mm256_loadu_si256((__m256i*)(inPtr + 8)), shift);
+            w0 = _mm256_or_si256(_mm256_and_si256(w0, i_bit), _mm256_slli_epi32(_mm256_and_si256(w0, q_bit), 7));
+            w1 = _mm256_or_si256(_mm256_and_si256(w1, i_bit), _mm256_slli_epi32(_mm256_and_si256(w1, q_bit), 7));
+            // the pack works within 128-bit lanes: put the four quarters back in order
+            p = _mm256_permute4x64_epi64(_mm256_packs_epi32(w0, w1), 0xD8);
+            p = _mm256_sub_epi8(_mm256_add_epi8(p, p), ones);
+            _mm256_storeu_si256((__m256i*)outPtr, p);
+            inPtr += 16;
+            outPtr += 32;
+        }
+
+    volk_gnsssdr_32u_unpack1bit_8ic_generic((lv_8sc_t*)outPtr, inPtr, bit_offset, num_points - avx2_iters * 16);
+}
+
+#endif /* LV_HAVE_AVX2 */
+
+#endif /* INCLUDED_volk_gnsssdr_32u_unpack1bit_8ic_H */
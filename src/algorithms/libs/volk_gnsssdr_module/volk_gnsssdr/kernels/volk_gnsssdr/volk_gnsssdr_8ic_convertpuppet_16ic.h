@@ -0,0 +1,66 @@
+/*!
+ * \file volk_gnsssdr_8ic_convertpuppet_16ic.h
+ * \brief VOLK_GNSSSDR puppet for the 8-bit to 16-bit complex conversion kernel.
+ *
+ * VOLK_GNSSSDR puppet for integrating the 8-bit to 16-bit conversion into the test system
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef INCLUDED_volk_gnsssdr_8ic_convertpuppet_16ic_H
+#define INCLUDED_volk_gnsssdr_8ic_convertpuppet_16ic_H
+
+#include <volk_gnsssdr/volk_gnsssdr_complex.h>
+#include "volk_gnsssdr/volk_gnsssdr_8ic_s16ic_convert_16ic.h"
+
+
+#ifdef LV_HAVE_GENERIC
+static inline void volk_gnsssdr_8ic_convertpuppet_16ic_generic(lv_16sc_t* result, const lv_8sc_t* in, unsigned int num_points)
+{
+    volk_gnsssdr_8ic_s16ic_convert_16ic_generic(result, in, lv_cmake((short)3, (short)-2), num_points);
+}
+
+#endif /* LV_HAVE_GENERIC */
+
+
+#ifdef LV_HAVE_SSE2
+static inline void volk_gnsssdr_8ic_convertpuppet_16ic_u_sse2(lv_16sc_t* result, const lv_8sc_t* in, unsigned int num_points)
+{
+    volk_gnsssdr_8ic_s16ic_convert_16ic_u_sse2(result, in, lv_cmake((short)3, (short)-2), num_points);
+}
+
+#endif /* LV_HAVE_SSE2 */
+
+
+#ifdef LV_HAVE_AVX2
+static inline void volk_gnsssdr_8ic_convertpuppet_16ic_u_avx2(lv_16sc_t* result, const lv_8sc_t* in, unsigned int num_points)
+{
+    volk_gnsssdr_8ic_s16ic_convert_16ic_u_avx2(result, in, lv_cmake((short)3, (short)-2), num_points);
+}
+
+#endif /* LV_HAVE_AVX2 */
+
+
+#endif /* INCLUDED_volk_gnsssdr_8ic_convertpuppet_16ic_H */
@@ -0,0 +1,136 @@
+/*!
+ * \file volk_gnsssdr_8ic_s16ic_convert_16ic.h
+ * \brief VOLK_GNSSSDR kernel: converts 8-bit complex integers to 16-bit complex integers with DC offset removal.
+ *
+ * VOLK_GNSSSDR kernel that widens complex 8-bit integer samples to complex 16-bit
+ * integers, subtracting a DC offset in the same pass
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+/*!
+ * \page volk_gnsssdr_8ic_s16ic_convert_16ic
+ *
+ * \b Overview
+ *
+ * Widens complex 8-bit integer samples to complex 16-bit integers,
+ * subtracting an integer DC offset in the same pass:
+ * result[i] = in[i] - offset. The subtraction wraps around in 16 bits.
+ *
+ * <b>Dispatcher Prototype</b>
+ * \code
+ * void volk_gnsssdr_8ic_s16ic_convert_16ic(lv_16sc_t* result, const lv_8sc_t* in, const lv_16sc_t offset, unsigned int num_points)
+ * \endcode
+ *
+ * \b Inputs
+ * \li in: Complex 8-bit integer samples (interleaved I/Q bytes).
+ * \li offset: DC offset to subtract.
+ * \li num_points: Number of complex samples.
+ *
+ * \b Outputs
+ * \li result: Converted complex samples.
+ *
+ */
+
+#ifndef INCLUDED_volk_gnsssdr_8ic_s16ic_convert_16ic_H
+#define INCLUDED_volk_gnsssdr_8ic_s16ic_convert_16ic_H
+
+#include <volk_gnsssdr/volk_gnsssdr_complex.h>
+
+
+#ifdef LV_HAVE_GENERIC
+
+static inline void volk_gnsssdr_8ic_s16ic_convert_16ic_generic(lv_16sc_t* result, const lv_8sc_t* in, const lv_16sc_t offset, unsigned int num_points)
+{
+    const char* inPtr = (const char*)in;
+    short* outPtr = (short*)result;
+    const short offset_i = lv_creal(offset);
+    const short offset_q = lv_cimag(offset);
+    unsigned int number;
+    for(number = 0; number < num_points; number++)
+        {
+            *outPtr++ = (short)(*inPtr++ - offset_i);
+            *outPtr++ = (short)(*inPtr++ - offset_q);
+        }
+}
+
+#endif /* LV_HAVE_GENERIC */
+
+
+#ifdef LV_HAVE_SSE2
+#include <emmintrin.h>
+
+static inline void volk_gnsssdr_8ic_s16ic_convert_16ic_u_sse2(lv_16sc_t* result, const lv_8sc_t* in, const lv_16sc_t offset, unsigned int num_points)
+{
+    const unsigned int sse_iters = num_points / 8;
+    const char* inPtr = (const char*)in;
+    short* outPtr = (short*)result;
+    const __m128i off = _mm_setr_epi16(lv_creal(offset), lv_cimag(offset), lv_creal(offset), lv_cimag(offset),
+            lv_creal(offset), lv_cimag(offset), lv_creal(offset), lv_cimag(offset));
+    __m128i x;
+    unsigned int number;
+
+    for(number = 0; number < sse_iters; number++)
+        {
+            x = _mm_loadu_si128((__m128i*)inPtr);
+            // sign-extend by unpacking each byte with itself and shifting back
+            _mm_storeu_si128((__m128i*)outPtr, _mm_sub_epi16(_mm_srai_epi16(_mm_unpacklo_epi8(x, x), 8), off));
+            _mm_storeu_si128((__m128i*)(outPtr + 8), _mm_sub_epi16(_mm_srai_epi16(_mm_unpackhi_epi8(x, x), 8), off));
+            inPtr += 16;
+            outPtr += 16;
+        }
+
+    volk_gnsssdr_8ic_s16ic_convert_16ic_generic((lv_16sc_t*)outPtr, (const lv_8sc_t*)inPtr, offset, num_points - sse_iters * 8);
+}
+
+#endif /* LV_HAVE_SSE2 */
+
+
+#ifdef LV_HAVE_AVX2
+#include <immintrin.h>
+
+static inline void volk_gnsssdr_8ic_s16ic_convert_16ic_u_avx2(lv_16sc_t* result, const lv_8sc_t* in, const lv_16sc_t offset, unsigned int num_points)
+{
+    const unsigned int avx2_iters = num_points / 16;
+    const char* inPtr = (const char*)in;
+    short* outPtr = (short*)result;
+    const __m256i off = _mm256_set1_epi32((int)(((unsigned int)(unsigned short)lv_cimag(offset) << 16) | (unsigned short)lv_creal(offset)));
+    unsigned int number;
+
+    for(number = 0; number < avx2_iters; number++)
+        {
+            _mm256_storeu_si256((__m256i*)outPtr, _mm256_sub_epi16(_mm256_cvtepi8_epi16(_mm_loadu_si128((__m128i*)inPtr)), off));
+            _mm256_storeu_si256((__m256i*)(outPtr + 16), _mm256_sub_epi16(_mm256_cvtepi8_epi16(_mm_loadu_si128((__m128i*)(inPtr + 16))), off));
+            inPtr += 32;
+            outPtr += 32;
+        }
+    _mm256_zeroupper();
+
+    volk_gnsssdr_8ic_s16ic_convert_16ic_generic((lv_16sc_t*)outPtr, (const lv_8sc_t*)inPtr, offset, num_points - avx2_iters * 16);
+}
+
+#endif /* LV_HAVE_AVX2 */
+
+#endif /* INCLUDED_volk_gnsssdr_8ic_s16ic_convert_16ic_H */
@@ -0,0 +1,246 @@
+/*!
+ * \file volk_gnsssdr_8u_unpack2bit_8i.h
+ * \brief VOLK_GNSSSDR kernel: unpacks 2-bit samples to 8-bit integers.
+ *
+ * VOLK_GNSSSDR kernel that unpacks four 2-bit samples per byte through a
+ * table of levels, in a configurable order within the byte and with the
+ * byte swap of multi-byte items done on the fly
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+/*!
+ * \page volk_gnsssdr_8u_unpack2bit_8i
+ *
+ * \b Overview
+ *
+ * Unpacks the four 2-bit fields of each input byte. The field at bits
+ * 2*order[j] and 2*order[j]+1 of byte i gives result[4*i+j] = levels[field].
+ * If \p swap_bytes is larger than 1, the input is read as items of
+ * \p swap_bytes bytes whose byte order is reversed first (a trailing partial
+ * item is read as it is).
+ *
+ * <b>Dispatcher Prototype</b>
+ * \code
+ * void volk_gnsssdr_8u_unpack2bit_8i(char* result, const unsigned char* in, const char* levels, const unsigned char* order, unsigned int swap_bytes, unsigned int num_points)
+ * \endcode
+ *
+ * \b Inputs
+ * \li in: Packed samples, (num_points + 3) / 4 bytes.
+ * \li levels: Output value of each of the four 2-bit codes.
+ * \li order: Bit pair (0 for bits 0-1, ..., 3 for bits 6-7) of each of the four outputs of a byte.
+ * \li swap_bytes: Item size for the byte swap, 1 for none.
+ * \li num_points: Number of unpacked samples.
+ *
+ * \b Outputs
+ * \li result: Unpacked samples.
+ *
+ */
+
+#ifndef INCLUDED_volk_gnsssdr_8u_unpack2bit_8i_H
+#define INCLUDED_volk_gnsssdr_8u_unpack2bit_8i_H
+
+
+/* Unpacks from byte first_byte on, without SIMD. Shared by all the protokernels for the tail. */
+static inline void volk_gnsssdr_unpack2bit_bytes(char* result, const unsigned char* in, const char* levels, const unsigned char* order, unsigned int swap_bytes, unsigned int first_byte, unsigned int num_points)
+{
+    const unsigned int swap = swap_bytes > 1 ? swap_bytes : 1;
+    const unsigned int num_bytes = (num_points + 3) / 4;
+    const unsigned int swapped_bytes = (num_points / 4 / swap) * swap;
+    unsigned int byte, j;
+    for(byte = first_byte; byte < num_bytes; byte++)
+        {
+            unsigned char c = (byte < swapped_bytes) ? in[byte - byte % swap + swap - 1 - byte % swap] : in[byte];
+            for(j = 0; j < 4 && 4 * byte + j < num_points; j++)
+                {
+                    result[4 * byte + j] = levels[(c >> (2 * order[j])) & 3];
+                }
+        }
+}
+
+
+/* Byte shuffle that reverses items of swap_bytes bytes within 16 bytes; 0 if not possible */
+static inline int volk_gnsssdr_unpack2bit_swap_mask(char* mask, unsigned int swap_bytes)
+{
+    unsigned int i;
+    if(swap_bytes != 1 && swap_bytes != 2 && swap_bytes != 4 && swap_bytes != 8 && swap_bytes != 16) return 0;
+    for(i = 0; i < 16; i++)
+        {
+            mask[i] = (char)(i - i % swap_bytes + swap_bytes - 1 - i % swap_bytes);
+        }
+    return 1;
+}
+
+
+/* Nibble tables of the four outputs: table j maps the nibble that holds bit pair order[j] to its level */
+static inline void volk_gnsssdr_unpack2bit_tables(char tables[4][16], const char* levels, const unsigned char* order)
+{
+    unsigned int j, n;
+    for(j = 0; j < 4; j++)
+        {
+            for(n = 0; n < 16; n++)
+                {
+                    tables[j][n] = levels[(n >> (2 * (order[j] & 1))) & 3];
+                }
+        }
+}
+
+
+#ifdef LV_HAVE_GENERIC
+
+static inline void volk_gnsssdr_8u_unpack2bit_8i_generic(char* result, const unsigned char* in, const char* levels, const unsigned char* order, unsigned int swap_bytes, unsigned int num_points)
+{
+    volk_gnsssdr_unpack2bit_bytes(result, in, levels, order, swap_bytes, 0, num_points);
+}
+
+#endif /* LV_HAVE_GENERIC */
+
+
+#ifdef LV_HAVE_SSSE3
+#include <tmmintrin.h>
+
+static inline void volk_gnsssdr_8u_unpack2bit_8i_u_ssse3(char* result, const unsigned char* in, const char* levels, const unsigned char* order, unsigned int swap_bytes, unsigned int num_points)
+{
+    char swap_mask[16];
+    char tables[4][16];
+    unsigned int number;
+    const unsigned int sse_iters = num_points / 64;
+    const unsigned char* inPtr = in;
+    char* outPtr = result;
+    __m128i mask, nibbles, v, lo, hi, x0, x1, x2, x3, ab, cd;
+    __m128i t[4];
+    unsigned int j;
+
+    if(!volk_gnsssdr_unpack2bit_swap_mask(swap_mask, swap_bytes))
+        {
+            volk_gnsssdr_unpack2bit_bytes(result, in, levels, order, swap_bytes, 0, num_points);
+            return;
+        }
+    volk_gnsssdr_unpack2bit_tables(tables, levels, order);
+    for(j = 0; j < 4; j++)
+        {
+            t[j] = _mm_loadu_si128((__m128i*)tables[j]);
+        }
+    mask = _mm_loadu_si128((__m128i*)swap_mask);
+    nibbles = _mm_set1_epi8(0x0F);
+
+    for(number = 0; number < sse_iters; number++)
+        {
+            v = _mm_loadu_si128((__m128i*)inPtr);
+            v = _mm_shuffle_epi8(v, mask); // item byte swap, identity if swap_bytes is 1
+            lo = _mm_and_si128(v, nibbles);
+            hi = _mm_and_si128(_mm_srli_epi16(v, 4), nibbles);
+
+            // one output of each byte per register
+            x0 = _mm_shuffle_epi8(t[0], order[0] < 2 ? lo : hi);
+            x1 = _mm_shuffle_epi8(t[1], order[1] < 2 ? lo : hi);
+            x2 = _mm_shuffle_epi8(t[2], order[2] < 2 ? lo : hi);
+            x3 = _mm_shuffle_epi8(t[3], order[3] < 2 ? lo : hi);
+
+            // interleave them back: x0 x1 x2 x3 of byte 0, of byte 1, ...
+            ab = _mm_unpacklo_epi8(x0, x1);
+            cd = _mm_unpacklo_epi8(x2, x3);
+            _mm_storeu_si128((__m128i*)outPtr, _mm_unpacklo_epi16(ab, cd));
+            _mm_storeu_si128((__m128i*)(outPtr + 16), _mm_unpackhi_epi16(ab, cd));
+            ab = _mm_unpackhi_epi8(x0, x1);
+            cd = _mm_unpackhi_epi8(x2, x3);
+            _mm_storeu_si128((__m128i*)(outPtr + 32), _mm_unpacklo_epi16(ab, cd));
+            _mm_storeu_si128((__m128i*)(outPtr + 48), _mm_unpackhi_epi16(ab, cd));
+
+            inPtr += 16;
+            outPtr += 64;
+        }
+
+    volk_gnsssdr_unpack2bit_bytes(result, in, levels, order, swap_bytes, sse_iters * 16, num_points);
+}
+
+#endif /* LV_HAVE_SSSE3 */
+
+
+#ifdef LV_HAVE_AVX2
+#include <immintrin.h>
+
+static inline void volk_gnsssdr_8u_unpack2bit_8i_u_avx2(char* result, const unsigned char* in, const char* levels, const unsigned char* order, unsigned int swap_bytes, unsigned int num_points)
+{
+    char swap_mask[16];
+    char tables[4][16];
+    unsigned int number;
+    const unsigned int avx2_iters = num_points / 128;
+    const unsigned char* inPtr = in;
+    char* outPtr = result;
+    __m256i mask, nibbles, v, lo, hi, x0, x1, x2, x3, ab, cd, out0, out1, out2, out3;
+    __m256i t[4];
+    unsigned int j;
+
+    if(!volk_gnsssdr_unpack2bit_swap_mask(swap_mask, swap_bytes))
+        {
+            volk_gnsssdr_unpack2bit_bytes(result, in, levels, order, swap_bytes, 0, num_points);
+            return;
+        }
+    volk_gnsssdr_unpack2bit_tables(tables, levels, order);
+    for(j = 0; j < 4; j++)
+        {
+            t[j] = _mm256_broadcastsi128_si256(_mm_loadu_si128((__m128i*)tables[j]));
+        }
+    mask = _mm256_broadcastsi128_si256(_mm_loadu_si128((__m128i*)swap_mask));
+    nibbles = _mm256_set1_epi8(0x0F);
+
+    for(number = 0; number < avx2_iters; number++)
+        {
+            v = _mm256_loadu_si256((__m256i*)inPtr);
+            v = _mm256_shuffle_epi8(v, mask);
+            lo = _mm256_and_si256(v, nibbles);
+            hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), nibbles);
+
+            x0 = _mm256_shuffle_epi8(t[0], order[0] < 2 ? lo : hi);
+            x1 = _mm256_shuffle_epi8(t[1], order[1] < 2 ? lo : hi);
+            x2 = _mm256_shuffle_epi8(t[2], order[2] < 2 ? lo : hi);
+            x3 = _mm256_shuffle_epi8(t[3], order[3] < 2 ? lo : hi);
+
+            // the unpacks work within 128-bit lanes: bytes 0-15 in the low lanes, 16-31 in the high ones
+            ab = _mm256_unpacklo_epi8(x0, x1);
+            cd = _mm256_unpacklo_epi8(x2, x3);
+            out0 = _mm256_unpacklo_epi16(ab, cd); // bytes 0-3 | 16-19
+            out1 = _mm256_unpackhi_epi16(ab, cd); // bytes 4-7 | 20-23
+            ab = _mm256_unpackhi_epi8(x0, x1);
+            cd = _mm256_unpackhi_epi8(x2, x3);
+            out2 = _mm256_unpacklo_epi16(ab, cd); // bytes 8-11 | 24-27
+            out3 = _mm256_unpackhi_epi16(ab, cd); // bytes 12-15 | 28-31
+
+            _mm256_storeu_si256((__m256i*)outPtr, _mm256_permute2x128_si256(out0, out1, 0x20));
+            _mm256_storeu_si256((__m256i*)(outPtr + 32), _mm256_permute2x128_si256(out2, out3, 0x20));
+            _mm256_storeu_si256((__m256i*)(outPtr + 64), _mm256_permute2x128_si256(out0, out1, 0x31));
+            _mm256_storeu_si256((__m256i*)(outPtr + 96), _mm256_permute2x128_si256(out2, out3, 0x31));
+
+            inPtr += 32;
+            outPtr += 128;
+        }
+
+    volk_gnsssdr_unpack2bit_bytes(result, in, levels, order, swap_bytes, avx2_iters * 32, num_points);
+}
+
+#endif /* LV_HAVE_AVX2 */
+
+#endif /* INCLUDED_volk_gnsssdr_8u_unpack2bit_8i_H */
@@ -0,0 +1,72 @@
+/*!
+ * \file volk_gnsssdr_8u_unpack2bitpuppet_8i.h
+ * \brief VOLK_GNSSSDR puppet for the 2-bit unpacking kernel.
+ *
+ * VOLK_GNSSSDR puppet for integrating the 2-bit unpacker into the test system:
+ * byte-swapped 32-bit items and pairwise reversed samples
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef INCLUDED_volk_gnsssdr_8u_unpack2bitpuppet_8i_H
+#define INCLUDED_volk_gnsssdr_8u_unpack2bitpuppet_8i_H
+
+#include "volk_gnsssdr/volk_gnsssdr_8u_unpack2bit_8i.h"
+
+
+#ifdef LV_HAVE_GENERIC
+static inline void volk_gnsssdr_8u_unpack2bitpuppet_8i_generic(char* result, const unsigned char* in, unsigned int num_points)
+{
+    const char levels[4] = {1, 3, -3, -1};
+    const unsigned char order[4] = {1, 0, 3, 2};
+    volk_gnsssdr_8u_unpack2bit_8i_generic(result, in, levels, order, 4, num_points);
+}
+
+#endif /* LV_HAVE_GENERIC */
+
+
+#ifdef LV_HAVE_SSSE3
+static inline void volk_gnsssdr_8u_unpack2bitpuppet_8i_u_ssse3(char* result, const unsigned char* in, unsigned int num_points)
+{
+    const char levels[4] = {1, 3, -3, -1};
+    const unsigned char order[4] = {1, 0, 3, 2};
+    volk_gnsssdr_8u_unpack2bit_8i_u_ssse3(result, in, levels, order, 4, num_points);
+}
+
+#endif /* LV_HAVE_SSSE3 */
+
+
+#ifdef LV_HAVE_AVX2
+static inline void volk_gnsssdr_8u_unpack2bitpuppet_8i_u_avx2(char* result, const unsigned char* in, unsigned int num_points)
+{
+    const char levels[4] = {1, 3, -3, -1};
+    const unsigned char order[4] = {1, 0, 3, 2};
+    volk_gnsssdr_8u_unpack2bit_8i_u_avx2(result, in, levels, order, 4, num_points);
+}
+
+#endif /* LV_HAVE_AVX2 */
+
+
+#endif /* INCLUDED_volk_gnsssdr_8u_unpack2bitpuppet_8i_H */
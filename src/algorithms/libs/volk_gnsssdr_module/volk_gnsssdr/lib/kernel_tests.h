@@ -92,6 +92,11 @@ std::vector<volk_gnsssdr_test_case_t> init_test_list(volk_gnsssdr_test_params_t
         (VOLK_INIT_PUPP(volk_gnsssdr_16ic_x2_dotprodxnpuppet_16ic, volk_gnsssdr_16ic_x2_dot_prod_16ic_xn, test_params))
         (VOLK_INIT_PUPP(volk_gnsssdr_16ic_x2_rotator_dotprodxnpuppet_16ic, volk_gnsssdr_16ic_x2_rotator_dot_prod_16ic_xn, test_params_int16))
         (VOLK_INIT_PUPP(volk_gnsssdr_32fc_x2_rotator_dotprodxnpuppet_32fc, volk_gnsssdr_32fc_x2_rotator_dot_prod_32fc_xn, test_params_int1))
+        (VOLK_INIT_PUPP(volk_gnsssdr_8u_unpack2bitpuppet_8i, volk_gnsssdr_8u_unpack2bit_8i, test_params))
+        (VOLK_INIT_PUPP(volk_gnsssdr_32u_unpack1bitpuppet_8ic, volk_gnsssdr_32u_unpack1bit_8ic, test_params))
+        (VOLK_INIT_PUPP(volk_gnsssdr_8ic_convertpuppet_32fc, volk_gnsssdr_8ic_s32fc_s32f_convert_32fc, test_params))
+        (VOLK_INIT_PUPP(volk_gnsssdr_16ic_convertpuppet_32fc, volk_gnsssdr_16ic_s32fc_s32f_convert_32fc, test_params))
+        (VOLK_INIT_PUPP(volk_gnsssdr_8ic_convertpuppet_16ic, volk_gnsssdr_8ic_s16ic_convert_16ic, test_params))
         ;
 
     return test_cases;
@@ -63,6 +63,7 @@ gps_l1_ca_observables_cc::gps_l1_ca_observables_cc(unsigned int nchannels, bool
     d_output_rate_ms = output_rate_ms;
     d_dump_filename = dump_filename;
     d_flag_averaging = flag_averaging;
+    d_perf = Gnss_Sdr_Perf::instance().add("observables", 1.0 / GPS_L1_CA_CODE_PERIOD);
 
     for (unsigned int i = 0; i < d_nchannels; i++)
         {
@@ -110,9 +111,27 @@ bool pairCompare_gnss_synchro_d_TOW_at_current_symbol(const std::pair<int,Gnss_S
 }
 
 
+void gps_l1_ca_observables_cc::forecast (int noutput_items __attribute__((unused)), gr_vector_int &ninput_items_required)
+{
+    for (unsigned int i = 0; i < ninput_items_required.size(); i++)
+        {
+            bool parked = i < d_gates.size() && d_gates[i] && d_gates[i]->output_parked();
+            ninput_items_required[i] = parked ? 0 : 1;
+        }
+}
+
+
+void gps_l1_ca_observables_cc::set_channel_gates(const std::vector<gnss_sdr_channel_gate_sptr>& gates)
+{
+    d_gates = gates;
+}
+
+
 int gps_l1_ca_observables_cc::general_work (int noutput_items, gr_vector_int &ninput_items,
         gr_vector_const_void_star &input_items,    gr_vector_void_star &output_items)
 {
+    Gnss_Sdr_Perf_Scope perf_scope(d_perf.get(), this, ninput_items[0]);
+
     Gnss_Synchro **in = (Gnss_Synchro **)  &input_items[0];   // Get the input pointer
     Gnss_Synchro **out = (Gnss_Synchro **)  &output_items[0]; // Get the output pointer
 
@@ -131,7 +150,16 @@ int gps_l1_ca_observables_cc::general_work (int noutput_items, gr_vector_int &ni
     for (unsigned int i = 0; i < d_nchannels; i++)
         {
             //Copy the telemetry decoder data to local copy
-            current_gnss_synchro[i] = in[i][0];
+            if (ninput_items[i] > 0)
+                {
+                    current_gnss_synchro[i] = in[i][0];
+                }
+            else
+                {
+                    // parked channel: nothing to read, report it as not tracking
+                    current_gnss_synchro[i] = Gnss_Synchro();
+                    current_gnss_synchro[i].Channel_ID = i;
+                }
             /*
              * 1.2 Assume no valid pseudoranges
              */
@@ -275,9 +303,12 @@ int gps_l1_ca_observables_cc::general_work (int noutput_items, gr_vector_int &ni
             }
         }
 
-    consume_each(1); //one by one
     for (unsigned int i = 0; i < d_nchannels; i++)
         {
+            if (ninput_items[i] > 0)
+                {
+                    consume(i, 1); //one by one
+                }
             *out[i] = current_gnss_synchro[i];
         }
     if (noutput_items == 0)
@@ -33,10 +33,13 @@
 
 #include <deque>
 #include <fstream>
+#include <memory>
 #include <string>
 #include <vector>
 #include <boost/shared_ptr.hpp>
 #include <gnuradio/block.h>
+#include "gnss_sdr_channel_gate.h"
+#include "gnss_sdr_perf.h"
 
 
 class gps_l1_ca_observables_cc;
@@ -57,6 +60,12 @@ public:
     int general_work (int noutput_items, gr_vector_int &ninput_items,
             gr_vector_const_void_star &input_items, gr_vector_void_star &output_items);
 
+    //! Does not wait for the outputs of parked channels (Channels.dynamic_pool)
+    void forecast (int noutput_items, gr_vector_int &ninput_items_required);
+
+    //! Gates of the channels connected to each input, set before the flowgraph starts
+    void set_channel_gates(const std::vector<gnss_sdr_channel_gate_sptr>& gates);
+
 private:
     friend gps_l1_ca_observables_cc_sptr
     gps_l1_ca_make_observables_cc(unsigned int nchannels, bool dump, std::string dump_filename, int output_rate_ms, bool flag_averaging);
@@ -75,6 +84,8 @@ private:
     int d_output_rate_ms;
     std::string d_dump_filename;
     std::ofstream d_dump_file;
+    std::shared_ptr<Gnss_Sdr_Block_Perf> d_perf;
+    std::vector<gnss_sdr_channel_gate_sptr> d_gates;
 };
 
 #endif
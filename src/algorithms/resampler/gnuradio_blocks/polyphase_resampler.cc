@@ -0,0 +1,253 @@
+/*!
+ * \file polyphase_resampler.cc
+ * \brief Polyphase filter fractional resampler for gr_complex, std::complex<short>
+ * and std::complex<signed char> samples
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+
+
+#include "polyphase_resampler.h"
+#include <algorithm>
+#include <cmath>
+#include <gnuradio/io_signature.h>
+#include <gnuradio/math.h>
+#include <glog/logging.h>
+#include <volk_gnsssdr/volk_gnsssdr.h>
+
+using google::LogMessage;
+
+namespace
+{
+size_t sample_size(const std::string& item_type)
+{
+    if (item_type.compare("cshort") == 0)
+        {
+            return sizeof(lv_16sc_t);
+        }
+    if (item_type.compare("cbyte") == 0)
+        {
+            return sizeof(lv_8sc_t);
+        }
+    return sizeof(gr_complex);
+}
+}
+
+
+polyphase_resampler_sptr make_polyphase_resampler(
+        const std::string& item_type, double sample_freq_in, double sample_freq_out,
+        unsigned int phases, unsigned int taps_per_phase, double cutoff)
+{
+    return polyphase_resampler_sptr(
+            new polyphase_resampler(item_type, sample_freq_in,
+                    sample_freq_out, phases, taps_per_phase, cutoff));
+}
+
+
+
+polyphase_resampler::polyphase_resampler(
+        const std::string& item_type, double sample_freq_in, double sample_freq_out,
+        unsigned int phases, unsigned int taps_per_phase, double cutoff) :
+    gr::block("polyphase_resampler",
+            gr::io_signature::make(1, 1, sample_size(item_type)),
+            gr::io_signature::make(1, 1, sample_size(item_type))),
+            d_sample_freq_in(sample_freq_in), d_sample_freq_out(sample_freq_out),
+            d_position(0)
+{
+    if (item_type.compare("cshort") == 0)
+        {
+            d_format = format_cshort;
+        }
+    else if (item_type.compare("cbyte") == 0)
+        {
+            d_format = format_cbyte;
+        }
+    else
+        {
+            if (item_type.compare("gr_complex") != 0)
+                {
+                    LOG(WARNING) << item_type << " unrecognized item type for the polyphase resampler, using gr_complex";
+                }
+            d_format = format_gr_complex;
+        }
+
+    const double ratio = sample_freq_in / sample_freq_out;
+    const double two_32 = 4294967296.0;
+    d_step = static_cast<uint64_t>(std::llround(ratio * two_32));
+
+    // Integer decimation: every output falls on an input sample, so one phase is enough
+    d_integer_ratio = (ratio >= 1.0) && (std::fabs(ratio - std::round(ratio)) < 1e-9);
+    d_phases = d_integer_ratio ? 1 : std::max(phases, 1u);
+    d_taps_per_phase = taps_per_phase;
+    if (d_taps_per_phase == 0)
+        {
+            d_taps_per_phase = 16 * static_cast<unsigned int>(std::ceil(std::max(ratio, 1.0)));
+        }
+    design_filter(cutoff);
+
+    set_history(d_taps_per_phase);
+    set_relative_rate(1.0 / ratio);
+    DLOG(INFO) << "polyphase resampler " << sample_freq_in << " -> " << sample_freq_out << " Hz, "
+               << d_phases << " phases of " << d_taps_per_phase << " taps";
+}
+
+
+
+polyphase_resampler::~polyphase_resampler()
+{}
+
+
+
+void polyphase_resampler::design_filter(double cutoff)
+{
+    // Cutoff in cycles per input sample, below the Nyquist frequency of the slower side
+    const double fc = 0.5 * cutoff * std::min(1.0, d_sample_freq_out / d_sample_freq_in);
+    const unsigned int ntaps = d_taps_per_phase;
+    const double center = (ntaps - 1) / 2.0;
+
+    d_taps.assign(d_phases * ntaps, 0.0);
+    std::vector<double> h(ntaps);
+    for (unsigned int p = 0; p < d_phases; p++)
+        {
+            // Output instant p / d_phases after the newest sample in the window
+            const double mu = static_cast<double>(p) / static_cast<double>(d_phases);
+            double sum = 0.0;
+            for (unsigned int j = 0; j < ntaps; j++)
+                {
+                    const double tau = j + mu - center;
+                    const double x = tau / ntaps + 0.5;
+                    const double window = 0.42 - 0.5 * std::cos(2.0 * GR_M_PI * x) + 0.08 * std::cos(4.0 * GR_M_PI * x);
+                    const double arg = 2.0 * GR_M_PI * fc * tau;
+                    const double sinc = (std::fabs(arg) < 1e-12) ? 1.0 : std::sin(arg) / arg;
+                    h[j] = 2.0 * fc * sinc * window;
+                    sum += h[j];
+                }
+            // Unit gain at DC for every phase, stored reversed for the dot product
+            for (unsigned int j = 0; j < ntaps; j++)
+                {
+                    d_taps[p * ntaps + (ntaps - 1 - j)] = static_cast<float>(h[j] / sum);
+                }
+        }
+}
+
+
+
+void polyphase_resampler::forecast(int noutput_items,
+        gr_vector_int &ninput_items_required)
+{
+    int nreqd = std::max(1, static_cast<int>(static_cast<double>(noutput_items + 1)
+            * sample_freq_in() / sample_freq_out()) + static_cast<int>(history()) - 1);
+    unsigned ninputs = ninput_items_required.size();
+
+    for (unsigned i = 0; i < ninputs; i++)
+        {
+            ninput_items_required[i] = nreqd;
+        }
+}
+
+
+
+int polyphase_resampler::general_work(int noutput_items,
+        gr_vector_int &ninput_items, gr_vector_const_void_star &input_items,
+        gr_vector_void_star &output_items)
+{
+    const unsigned int ntaps = d_taps_per_phase;
+    const int available = ninput_items[0];
+
+    // Samples are filtered as gr_complex. The input starts with the ntaps - 1 items of
+    // history, which ninput_items counts, so the window of the output at n is in[n] to
+    // in[n + ntaps - 1] and needs n + ntaps <= available.
+    const gr_complex *in;
+    gr_complex *out;
+    if (d_format == format_gr_complex)
+        {
+            in = static_cast<const gr_complex *>(input_items[0]);
+            out = static_cast<gr_complex *>(output_items[0]);
+        }
+    else
+        {
+            if (d_in_buffer.size() < static_cast<size_t>(available))
+                {
+                    d_in_buffer.resize(available);
+                }
+            if (d_out_buffer.size() < static_cast<size_t>(noutput_items))
+                {
+                    d_out_buffer.resize(noutput_items);
+                }
+            if (d_format == format_cshort)
+                {
+                    volk_gnsssdr_16ic_convert_32fc(d_in_buffer.data(), static_cast<const lv_16sc_t *>(input_items[0]), available);
+                }
+            else
+                {
+                    volk_gnsssdr_8ic_s32fc_s32f_convert_32fc(d_in_buffer.data(), static_cast<const lv_8sc_t *>(input_items[0]),
+                            lv_cmake(0.0f, 0.0f), 1.0f, available);
+                }
+            in = d_in_buffer.data();
+            out = d_out_buffer.data();
+        }
+
+    int produced = 0;
+    while (produced < noutput_items)
+        {
+            uint64_t n = d_position >> 32;
+            unsigned int phase = 0;
+            if (!d_integer_ratio)
+                {
+                    // Nearest filter phase to the fractional part of the output instant
+                    const uint64_t fraction = d_position & 0xFFFFFFFFULL;
+                    phase = static_cast<unsigned int>((fraction * d_phases + 0x80000000ULL) >> 32);
+                    if (phase == d_phases)
+                        {
+                            n++;
+                            phase = 0;
+                        }
+                }
+            if (n + ntaps > static_cast<uint64_t>(available))
+                {
+                    break;
+                }
+            volk_32fc_32f_dot_prod_32fc(&out[produced], &in[n], &d_taps[phase * ntaps], ntaps);
+            produced++;
+            d_position += d_step;
+        }
+
+    if (d_format == format_cshort)
+        {
+            volk_gnsssdr_32fc_convert_16ic(static_cast<lv_16sc_t *>(output_items[0]), out, produced);
+        }
+    else if (d_format == format_cbyte)
+        {
+            volk_gnsssdr_32fc_convert_8ic(static_cast<lv_8sc_t *>(output_items[0]), out, produced);
+        }
+
+    // only the items after the history are new
+    const uint64_t fresh = static_cast<uint64_t>(std::max(available - static_cast<int>(ntaps) + 1, 0));
+    const uint64_t consumed = std::min(d_position >> 32, fresh);
+    d_position -= consumed << 32;
+    consume_each(static_cast<int>(consumed));
+    return produced;
+}
@@ -0,0 +1,128 @@
+/*!
+ * \file polyphase_resampler.h
+ * \brief Polyphase filter fractional resampler for gr_complex, std::complex<short>
+ * and std::complex<signed char> samples
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+
+#ifndef GNSS_SDR_POLYPHASE_RESAMPLER_H
+#define GNSS_SDR_POLYPHASE_RESAMPLER_H
+
+#include <string>
+#include <vector>
+#include <gnuradio/block.h>
+#include <volk/volk.h>
+
+class polyphase_resampler;
+typedef boost::shared_ptr<polyphase_resampler>
+        polyphase_resampler_sptr;
+
+/*!
+ * \brief Makes a polyphase resampler
+ *
+ * \param item_type        "gr_complex", "cshort" or "cbyte"
+ * \param sample_freq_in   input sampling frequency [Hz]
+ * \param sample_freq_out  output sampling frequency [Hz]
+ * \param phases           number of filter phases (interpolation steps per input sample)
+ * \param taps_per_phase   filter length in input samples, 0 picks it from the resampling ratio
+ * \param cutoff           filter cutoff, relative to the Nyquist frequency of the slower side
+ */
+polyphase_resampler_sptr
+make_polyphase_resampler(const std::string& item_type,
+        double sample_freq_in, double sample_freq_out,
+        unsigned int phases = 32, unsigned int taps_per_phase = 0, double cutoff = 0.8);
+
+/*!
+ * \brief This class implements a polyphase filter fractional resampler
+ *
+ * Each output sample is the dot product of the newest taps_per_phase input
+ * samples with the filter phase nearest to the fractional output instant.
+ * The filter is a Blackman windowed sinc that removes the band that would
+ * alias into the output, so unlike the direct resampler the out-of-band
+ * noise does not fold onto the signal. When the input rate is an integer
+ * multiple of the output rate, a single phase is used and the resampler is
+ * a plain decimating FIR filter.
+ *
+ * The output is delayed by (taps_per_phase - 1) / 2 input samples.
+ * std::complex<short> and std::complex<signed char> samples are filtered
+ * as gr_complex and rounded back with saturation.
+ */
+class polyphase_resampler: public gr::block
+{
+private:
+    friend polyphase_resampler_sptr
+    make_polyphase_resampler(const std::string& item_type,
+            double sample_freq_in, double sample_freq_out,
+            unsigned int phases, unsigned int taps_per_phase, double cutoff);
+
+    polyphase_resampler(const std::string& item_type,
+            double sample_freq_in, double sample_freq_out,
+            unsigned int phases, unsigned int taps_per_phase, double cutoff);
+
+    enum sample_format { format_gr_complex, format_cshort, format_cbyte };
+
+    void design_filter(double cutoff);
+
+    sample_format d_format;
+    double d_sample_freq_in;
+    double d_sample_freq_out;
+    unsigned int d_phases;
+    unsigned int d_taps_per_phase;
+    std::vector<float> d_taps;   // d_phases filters of d_taps_per_phase taps, each reversed
+    uint64_t d_position;         // next output instant in input samples, 32.32 fixed point
+    uint64_t d_step;             // input samples per output sample, 32.32 fixed point
+    bool d_integer_ratio;
+    std::vector<gr_complex> d_in_buffer;
+    std::vector<gr_complex> d_out_buffer;
+
+public:
+
+    ~polyphase_resampler();
+
+    double sample_freq_in() const
+    {
+        return d_sample_freq_in;
+    }
+    double sample_freq_out() const
+    {
+        return d_sample_freq_out;
+    }
+    unsigned int phases() const
+    {
+        return d_phases;
+    }
+    unsigned int taps_per_phase() const
+    {
+        return d_taps_per_phase;
+    }
+    void forecast(int noutput_items, gr_vector_int &ninput_items_required);
+    int general_work(int noutput_items, gr_vector_int &ninput_items,
+            gr_vector_const_void_star &input_items,
+            gr_vector_void_star &output_items);
+};
+
+#endif /* GNSS_SDR_POLYPHASE_RESAMPLER_H */
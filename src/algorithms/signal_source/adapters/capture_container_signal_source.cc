@@ -0,0 +1,242 @@
+/*!
+ * \file capture_container_signal_source.cc
+ * \brief Signal source that plays a compressed capture container (2, 4 or
+ * 8-bit I/Q with per-block scale factors) as gr_complex or cshort samples.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "capture_container_signal_source.h"
+#include <cmath>
+#include <complex>
+#include <exception>
+#include <iostream>
+#include <map>
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include "gnss_sdr_valve.h"
+#include "configuration_interface.h"
+
+using google::LogMessage;
+
+
+DEFINE_string(capture_container, "-",
+        "If defined, path to the compressed capture container (overrides the configuration file)");
+
+
+CaptureContainerSignalSource::CaptureContainerSignalSource(ConfigurationInterface* configuration,
+        std::string role, unsigned int in_streams, unsigned int out_streams,
+        boost::shared_ptr<gr::msg_queue> queue) :
+                        role_(role), in_streams_(in_streams), out_streams_(out_streams), queue_(queue)
+{
+    std::string default_filename = "./example_capture.gcap";
+    std::string default_item_type = "gr_complex";
+    std::string default_dump_filename = "./my_capture.dat";
+
+    samples_ = configuration->property(role + ".samples", 0);
+    sampling_frequency_ = configuration->property(role + ".sampling_frequency", 0);
+    filename_ = configuration->property(role + ".filename", default_filename);
+
+    // override value with commandline flag, if present
+    if (FLAGS_capture_container.compare("-") != 0) filename_= FLAGS_capture_container;
+
+    item_type_ = configuration->property(role + ".item_type", default_item_type);
+    repeat_ = configuration->property(role + ".repeat", false);
+    dump_ = configuration->property(role + ".dump", false);
+    dump_filename_ = configuration->property(role + ".dump_filename", default_dump_filename);
+    enable_throttle_control_ = configuration->property(role + ".enable_throttle_control", false);
+    double seconds_to_skip = configuration->property(role + ".seconds_to_skip", 0.0);
+
+    bool cshort = false;
+    if (item_type_.compare("cshort") == 0)
+        {
+            item_size_ = sizeof(std::complex<int16_t>);
+            cshort = true;
+        }
+    else
+        {
+            if (item_type_.compare("gr_complex") != 0)
+                {
+                    LOG(WARNING) << item_type_ << " unrecognized item type. Using gr_complex.";
+                    item_type_ = "gr_complex";
+                }
+            item_size_ = sizeof(gr_complex);
+        }
+
+    try
+    {
+            // the container knows its sampling frequency: read it before skipping
+            capture_container_reader reader(filename_);
+            double container_fs = reader.header().sampling_frequency;
+            if (sampling_frequency_ == 0)
+                {
+                    sampling_frequency_ = static_cast<long>(container_fs);
+                }
+            else if (container_fs > 0.0 and std::fabs(container_fs - sampling_frequency_) > 0.5)
+                {
+                    LOG(WARNING) << filename_ << " was recorded at " << container_fs << " Hz, but "
+                                 << role << ".sampling_frequency is " << sampling_frequency_ << " Hz";
+                    std::cout << "Warning: " << filename_ << " was recorded at " << container_fs
+                              << " Hz, not at " << sampling_frequency_ << " Hz" << std::endl;
+                }
+            unsigned long long samples_to_skip = 0;
+            if (seconds_to_skip > 0)
+                {
+                    samples_to_skip = static_cast<unsigned long long>(seconds_to_skip * sampling_frequency_);
+                    LOG(INFO) << "Skipping " << samples_to_skip << " samples of the capture container";
+                }
+            if (samples_to_skip >= reader.samples())
+                {
+                    std::cout << filename_ << " holds " << reader.samples() << " samples, all of them skipped" << std::endl;
+                    samples_to_skip = reader.samples();
+                }
+            source_ = make_capture_container_source(filename_, cshort, samples_to_skip, repeat_);
+            if (samples_ == 0)
+                {
+                    // the number of recorded samples is exact: no margin is needed
+                    samples_ = reader.samples() - samples_to_skip;
+                }
+            std::cout << "Processing " << filename_ << ", " << reader.header().bits << "-bit I/Q, "
+                      << reader.samples() << " samples";
+            if (reader.header().intermediate_frequency != 0.0)
+                {
+                    std::cout << ", IF " << reader.header().intermediate_frequency << " Hz";
+                }
+            std::cout << std::endl;
+            for (std::map<std::string, std::string>::const_iterator it = reader.tags().begin(); it != reader.tags().end(); ++it)
+                {
+                    std::cout << "  " << it->first << ": " << it->second << std::endl;
+                    LOG(INFO) << "Capture tag " << it->first << "=" << it->second;
+                }
+    }
+    catch (const std::exception &e)
+    {
+            std::cerr << "The receiver was configured to play the capture container " << filename_ << std::endl
+                      << "but it could not be read: " << e.what() << std::endl
+                      << "Please point " << role << ".filename to a valid container." << std::endl;
+            LOG(INFO) << "capture_container_signal_source: Unable to open " << filename_ << ", exiting the program: " << e.what();
+            throw;
+    }
+
+    DLOG(INFO) << "capture_container_source(" << source_->unique_id() << ")";
+
+    CHECK(samples_ > 0) << "File does not contain enough samples to process.";
+    CHECK(sampling_frequency_ > 0) << "Unknown sampling frequency: set " << role << ".sampling_frequency";
+    double signal_duration_s = static_cast<double>(samples_) / static_cast<double>(sampling_frequency_);
+    DLOG(INFO) << "Total number samples to be processed= " << samples_ << " GNSS signal duration= " << signal_duration_s << " [s]";
+    std::cout << "GNSS signal recorded time to be processed: " << signal_duration_s << " [s]" << std::endl;
+
+    valve_ = gnss_sdr_make_valve(item_size_, samples_, queue_);
+    DLOG(INFO) << "valve(" << valve_->unique_id() << ")";
+
+    if (dump_)
+        {
+            sink_ = gr::blocks::file_sink::make(item_size_, dump_filename_.c_str());
+            DLOG(INFO) << "file_sink(" << sink_->unique_id() << ")";
+        }
+
+    if (enable_throttle_control_)
+        {
+            throttle_ = gr::blocks::throttle::make(item_size_, sampling_frequency_);
+        }
+    DLOG(INFO) << "Capture container " << filename_;
+    DLOG(INFO) << "Samples " << samples_;
+    DLOG(INFO) << "Sampling frequency " << sampling_frequency_;
+    DLOG(INFO) << "Item type " << item_type_;
+    DLOG(INFO) << "Repeat " << repeat_;
+    DLOG(INFO) << "Dump " << dump_;
+    DLOG(INFO) << "Dump filename " << dump_filename_;
+}
+
+
+
+
+CaptureContainerSignalSource::~CaptureContainerSignalSource()
+{}
+
+
+
+
+void CaptureContainerSignalSource::connect(gr::top_block_sptr top_block)
+{
+    if (enable_throttle_control_)
+        {
+            top_block->connect(source_, 0, throttle_, 0);
+            DLOG(INFO) << "connected capture container source to throttle";
+            top_block->connect(throttle_, 0, valve_, 0);
+            DLOG(INFO) << "connected throttle to valve";
+        }
+    else
+        {
+            top_block->connect(source_, 0, valve_, 0);
+            DLOG(INFO) << "connected capture container source to valve";
+        }
+    if (dump_)
+        {
+            top_block->connect(valve_, 0, sink_, 0);
+            DLOG(INFO) << "connected valve to file sink";
+        }
+}
+
+
+
+
+void CaptureContainerSignalSource::disconnect(gr::top_block_sptr top_block)
+{
+    if (enable_throttle_control_)
+        {
+            top_block->disconnect(source_, 0, throttle_, 0);
+            DLOG(INFO) << "disconnected capture container source to throttle";
+            top_block->disconnect(throttle_, 0, valve_, 0);
+            DLOG(INFO) << "disconnected throttle to valve";
+        }
+    else
+        {
+            top_block->disconnect(source_, 0, valve_, 0);
+            DLOG(INFO) << "disconnected capture container source to valve";
+        }
+    if (dump_)
+        {
+            top_block->disconnect(valve_, 0, sink_, 0);
+            DLOG(INFO) << "disconnected valve to file sink";
+        }
+}
+
+
+
+
+gr::basic_block_sptr CaptureContainerSignalSource::get_left_block()
+{
+    LOG(WARNING) << "Left block of a signal source should not be retrieved";
+    return gr::block_sptr();
+}
+
+
+
+
+gr::basic_block_sptr CaptureContainerSignalSource::get_right_block()
+{
+    return valve_;
+}
@@ -0,0 +1,121 @@
+/*!
+ * \file capture_container_signal_source.h
+ * \brief Signal source that plays a compressed capture container (2, 4 or
+ * 8-bit I/Q with per-block scale factors) as gr_complex or cshort samples.
+ *
+ * The sampling frequency, IF and scenario tags are read from the container.
+ * Captures in this format are recorded by the File_Signal_Source with
+ * dump_format=container.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_CAPTURE_CONTAINER_SIGNAL_SOURCE_H_
+#define GNSS_SDR_CAPTURE_CONTAINER_SIGNAL_SOURCE_H_
+
+#include <string>
+#include <gnuradio/blocks/file_sink.h>
+#include <gnuradio/blocks/throttle.h>
+#include <gnuradio/msg_queue.h>
+#include "gnss_block_interface.h"
+#include "capture_container_source.h"
+
+
+class ConfigurationInterface;
+
+/*!
+ * \brief Class that reads signal samples from a compressed capture
+ * container and adapts it to a SignalSourceInterface
+ */
+class CaptureContainerSignalSource: public GNSSBlockInterface
+{
+public:
+    CaptureContainerSignalSource(ConfigurationInterface* configuration, std::string role,
+            unsigned int in_streams, unsigned int out_streams,
+            boost::shared_ptr<gr::msg_queue> queue);
+
+    virtual ~CaptureContainerSignalSource();
+    std::string role()
+    {
+        return role_;
+    }
+
+    /*!
+     * \brief Returns "Capture_Container_Signal_Source".
+     */
+    std::string implementation()
+    {
+        return "Capture_Container_Signal_Source";
+    }
+    size_t item_size()
+    {
+        return item_size_;
+    }
+    void connect(gr::top_block_sptr top_block);
+    void disconnect(gr::top_block_sptr top_block);
+    gr::basic_block_sptr get_left_block();
+    gr::basic_block_sptr get_right_block();
+    std::string filename()
+    {
+        return filename_;
+    }
+    std::string item_type()
+    {
+        return item_type_;
+    }
+    bool repeat()
+    {
+        return repeat_;
+    }
+    long sampling_frequency()
+    {
+        return sampling_frequency_;
+    }
+    long samples()
+    {
+        return samples_;
+    }
+
+private:
+    unsigned long long samples_;
+    long sampling_frequency_;
+    std::string filename_;
+    std::string item_type_;
+    bool repeat_;
+    bool dump_;
+    std::string dump_filename_;
+    std::string role_;
+    unsigned int in_streams_;
+    unsigned int out_streams_;
+    capture_container_source_sptr source_;
+    boost::shared_ptr<gr::block> valve_;
+    gr::blocks::file_sink::sptr sink_;
+    gr::blocks::throttle::sptr throttle_;
+    boost::shared_ptr<gr::msg_queue> queue_;
+    size_t item_size_;
+    bool enable_throttle_control_;
+};
+
+#endif /*GNSS_SDR_CAPTURE_CONTAINER_SIGNAL_SOURCE_H_*/
@@ -36,10 +36,14 @@
 #include <fstream>
 #include <iomanip>
 #include <exception>
+#include <map>
+#include <sstream>
 #include <gflags/gflags.h>
 #include <glog/logging.h>
 #include <volk/volk.h>
 #include "gnss_sdr_valve.h"
+#include "mmap_file_source.h"
+#include "capture_container_sink.h"
 #include "configuration_interface.h"
 
 using google::LogMessage;
@@ -49,6 +53,32 @@ DEFINE_string(signal_source, "-",
         "If defined, path to the file containing the signal samples (overrides the configuration file)");
 
 
+namespace
+{
+// "key=value;key=value", as given in <role>.dump_tags
+std::map<std::string, std::string> parse_tags(const std::string& list)
+{
+    std::map<std::string, std::string> tags;
+    std::istringstream items(list);
+    std::string item;
+    while (std::getline(items, item, ';'))
+        {
+            size_t eq = item.find('=');
+            if (eq == std::string::npos or eq == 0)
+                {
+                    if (item.find_first_not_of(" ") != std::string::npos)
+                        {
+                            LOG(WARNING) << "Ignoring the capture tag '" << item << "': expected key=value";
+                        }
+                    continue;
+                }
+            tags[item.substr(0, eq)] = item.substr(eq + 1);
+        }
+    return tags;
+}
+}
+
+
 FileSignalSource::FileSignalSource(ConfigurationInterface* configuration,
         std::string role, unsigned int in_streams, unsigned int out_streams,
         boost::shared_ptr<gr::msg_queue> queue) :
@@ -71,9 +101,14 @@ FileSignalSource::FileSignalSource(ConfigurationInterface* configuration,
     repeat_ = configuration->property(role + ".repeat", false);
     dump_ = configuration->property(role + ".dump", false);
     dump_filename_ = configuration->property(role + ".dump_filename", default_dump_filename);
+    dump_format_ = configuration->property(role + ".dump_format", std::string("raw"));
     enable_throttle_control_ = configuration->property(role + ".enable_throttle_control", false);
+    playlist_ = configuration->property(role + ".playlist", std::string(""));
+    mmap_ = configuration->property(role + ".mmap", false) or !playlist_.empty();
+    size_t read_ahead_mb = configuration->property(role + ".read_ahead_mb", 32);
+    unsigned long long mmap_items = 0;
     std::string s = "InputFilter";
-    //double IF = configuration->property(s + ".IF", 0.0);
+    double IF = configuration->property(s + ".IF", 0.0);
     double seconds_to_skip = configuration->property(role + ".seconds_to_skip", default_seconds_to_skip );
     header_size = configuration->property( role + ".header_size", 0 );
     long samples_to_skip = 0;
@@ -114,8 +149,6 @@ FileSignalSource::FileSignalSource(ConfigurationInterface* configuration,
         }
     try
     {
-            file_source_ = gr::blocks::file_source::make(item_size_, filename_.c_str(), repeat_);
-
             if( seconds_to_skip > 0 )
             {
                 samples_to_skip = static_cast< long >(
@@ -131,14 +164,27 @@ FileSignalSource::FileSignalSource(ConfigurationInterface* configuration,
                 samples_to_skip += header_size;
             }
 
-            if( samples_to_skip > 0 )
-            {
-                LOG(INFO) << "Skipping " << samples_to_skip << " samples of the input file";
-                if( not file_source_->seek( samples_to_skip, SEEK_SET ) )
+            if (mmap_)
                 {
-                    LOG(INFO) << "Error skipping bytes!";
+                    // the skipped items are left out of the mapped segment, a playlist gives its own
+                    mmap_file_source_sptr mmap_source = make_mmap_file_source(item_size_,
+                            mmap_playlist::load(playlist_, filename_, samples_to_skip), repeat_, read_ahead_mb << 20);
+                    mmap_items = mmap_source->items();
+                    file_source_ = mmap_source;
+                }
+            else
+                {
+                    gr::blocks::file_source::sptr file_source = gr::blocks::file_source::make(item_size_, filename_.c_str(), repeat_);
+                    if( samples_to_skip > 0 )
+                    {
+                        LOG(INFO) << "Skipping " << samples_to_skip << " samples of the input file";
+                        if( not file_source->seek( samples_to_skip, SEEK_SET ) )
+                        {
+                            LOG(INFO) << "Error skipping bytes!";
+                        }
+                    }
+                    file_source_ = file_source;
                 }
-            }
 
     }
     catch (const std::exception &e)
@@ -176,13 +222,20 @@ FileSignalSource::FileSignalSource(ConfigurationInterface* configuration,
                 }
 
             LOG(INFO) << "file_signal_source: Unable to open the samples file "
-                      << filename_.c_str() << ", exiting the program.";
+                      << filename_.c_str() << ", exiting the program: " << e.what();
             throw(e);
     }
 
     DLOG(INFO) << "file_source(" << file_source_->unique_id() << ")";
 
-    if (samples_ == 0) // read all file
+    if (samples_ == 0 && mmap_)
+        {
+            // the end of the mapped segments is exact: no margin is needed
+            samples_ = mmap_items;
+            std::cout << "Processing " << (playlist_.empty() ? filename_ : playlist_) << ", which contains "
+                      << mmap_items << " items" << std::endl;
+        }
+    else if (samples_ == 0) // read all file
         {
             /*!
              * BUG workaround: The GNU Radio file source does not stop the receiver after reaching the End of File.
@@ -228,7 +281,39 @@ FileSignalSource::FileSignalSource(ConfigurationInterface* configuration,
     valve_ = gnss_sdr_make_valve(item_size_, samples_, queue_);
     DLOG(INFO) << "valve(" << valve_->unique_id() << ")";
 
-    if (dump_)
+    if (dump_ and dump_format_.compare("container") == 0 and item_type_.compare("gr_complex") != 0)
+        {
+            LOG(WARNING) << "Only gr_complex samples can be recorded in a capture container. Dumping raw " << item_type_ << " samples.";
+            dump_format_ = "raw";
+        }
+    if (dump_ and dump_format_.compare("container") == 0)
+        {
+            // compressed recording, tagged with the scenario and the capture it comes from
+            std::map<std::string, std::string> tags = parse_tags(configuration->property(role + ".dump_tags", std::string("")));
+            tags["source"] = filename_;
+            double freq = configuration->property(role + ".freq", 0.0);
+            if (freq > 0.0)
+                {
+                    std::ostringstream freq_text;
+                    freq_text << std::setprecision(12) << freq;
+                    tags["freq"] = freq_text.str();
+                }
+            unsigned int bits = configuration->property(role + ".dump_bits", 4);
+            unsigned int block_samples = configuration->property(role + ".dump_block_samples", 4096);
+            try
+            {
+                    sink_ = make_capture_container_sink(dump_filename_, item_size_, bits, block_samples,
+                            sampling_frequency_, IF, tags);
+            }
+            catch (const std::exception &e)
+            {
+                    std::cerr << "Unable to record " << dump_filename_ << ": " << e.what() << std::endl;
+                    LOG(ERROR) << "file_signal_source: Unable to record " << dump_filename_ << ": " << e.what();
+                    throw;
+            }
+            DLOG(INFO) << "capture_container_sink(" << sink_->unique_id() << ")";
+        }
+    else if (dump_)
         {
             sink_ = gr::blocks::file_sink::make(item_size_, dump_filename_.c_str());
             DLOG(INFO) << "file_sink(" << sink_->unique_id() << ")";
@@ -245,8 +330,10 @@ FileSignalSource::FileSignalSource(ConfigurationInterface* configuration,
     DLOG(INFO) << "Item type " << item_type_;
     DLOG(INFO) << "Item size " << item_size_;
     DLOG(INFO) << "Repeat " << repeat_;
+    DLOG(INFO) << "Memory-mapped " << mmap_;
     DLOG(INFO) << "Dump " << dump_;
     DLOG(INFO) << "Dump filename " << dump_filename_;
+    DLOG(INFO) << "Dump format " << dump_format_;
 }
 
 
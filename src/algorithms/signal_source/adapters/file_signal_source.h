@@ -105,14 +105,17 @@ private:
     std::string filename_;
     std::string item_type_;
     bool repeat_;
+    bool mmap_;
+    std::string playlist_;
     bool dump_;
     std::string dump_filename_;
+    std::string dump_format_;
     std::string role_;
     unsigned int in_streams_;
     unsigned int out_streams_;
-    gr::blocks::file_source::sptr file_source_;
+    gr::block_sptr file_source_;  // gr::blocks::file_source, or mmap_file_source if mmap_
     boost::shared_ptr<gr::block> valve_;
-    gr::blocks::file_sink::sptr sink_;
+    gr::block_sptr sink_;  // gr::blocks::file_sink, or capture_container_sink if dump_format_ is "container"
     gr::blocks::throttle::sptr  throttle_;
     boost::shared_ptr<gr::msg_queue> queue_;
     size_t item_size_;
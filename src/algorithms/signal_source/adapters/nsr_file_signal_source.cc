@@ -39,6 +39,7 @@
 #include <gflags/gflags.h>
 #include <glog/logging.h>
 #include "gnss_sdr_valve.h"
+#include "mmap_file_source.h"
 #include "configuration_interface.h"
 
 
@@ -69,6 +70,10 @@ NsrFileSignalSource::NsrFileSignalSource(ConfigurationInterface* configuration,
     dump_ = configuration->property(role + ".dump", false);
     dump_filename_ = configuration->property(role + ".dump_filename", default_dump_filename);
     enable_throttle_control_ = configuration->property(role + ".enable_throttle_control", false);
+    playlist_ = configuration->property(role + ".playlist", std::string(""));
+    mmap_ = configuration->property(role + ".mmap", false) or !playlist_.empty();
+    size_t read_ahead_mb = configuration->property(role + ".read_ahead_mb", 32);
+    unsigned long long mmap_items = 0;
 
     if (item_type_.compare("byte") == 0)
         {
@@ -81,7 +86,17 @@ NsrFileSignalSource::NsrFileSignalSource(ConfigurationInterface* configuration,
         }
     try
     {
-            file_source_ = gr::blocks::file_source::make(item_size_, filename_.c_str(), repeat_);
+            if (mmap_)
+                {
+                    mmap_file_source_sptr mmap_source = make_mmap_file_source(item_size_,
+                            mmap_playlist::load(playlist_, filename_, 0), repeat_, read_ahead_mb << 20);
+                    mmap_items = mmap_source->items();
+                    file_source_ = mmap_source;
+                }
+            else
+                {
+                    file_source_ = gr::blocks::file_source::make(item_size_, filename_.c_str(), repeat_);
+                }
             unpack_byte_ = make_unpack_byte_2bit_samples();
 
     }
@@ -120,7 +135,11 @@ NsrFileSignalSource::NsrFileSignalSource(ConfigurationInterface* configuration,
             std::ifstream file (filename_.c_str(), std::ios::in | std::ios::binary | std::ios::ate);
             std::ifstream::pos_type size;
 
-            if (file.is_open())
+            if (mmap_)
+                {
+                    size = mmap_items * item_size_;  // bytes of the mapped segments
+                }
+            else if (file.is_open())
                 {
                     size = file.tellg();
                     LOG(INFO) << "Total samples in the file= " << floor((double)size / (double)item_size());
@@ -167,6 +186,7 @@ NsrFileSignalSource::NsrFileSignalSource(ConfigurationInterface* configuration,
     DLOG(INFO) << "Item type " << item_type_;
     DLOG(INFO) << "Item size " << item_size_;
     DLOG(INFO) << "Repeat " << repeat_;
+    DLOG(INFO) << "Memory-mapped " << mmap_;
     DLOG(INFO) << "Dump " << dump_;
     DLOG(INFO) << "Dump filename " << dump_filename_;
 }
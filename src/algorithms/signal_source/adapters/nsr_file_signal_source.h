@@ -106,12 +106,14 @@ private:
     std::string filename_;
     std::string item_type_;
     bool repeat_;
+    bool mmap_;
+    std::string playlist_;
     bool dump_;
     std::string dump_filename_;
     std::string role_;
     unsigned int in_streams_;
     unsigned int out_streams_;
-    gr::blocks::file_source::sptr file_source_;
+    gr::block_sptr file_source_;  // gr::blocks::file_source, or mmap_file_source if mmap_
     unpack_byte_2bit_samples_sptr unpack_byte_;
     boost::shared_ptr<gr::block> valve_;
     gr::blocks::file_sink::sptr sink_;
@@ -39,6 +39,7 @@
 #include <gflags/gflags.h>
 #include <glog/logging.h>
 #include "gnss_sdr_valve.h"
+#include "mmap_file_source.h"
 #include "configuration_interface.h"
 #include <gnuradio/blocks/char_to_float.h>
 
@@ -75,6 +76,10 @@ TwoBitPackedFileSignalSource::TwoBitPackedFileSignalSource(ConfigurationInterfac
     dump_ = configuration->property(role + ".dump", false);
     dump_filename_ = configuration->property(role + ".dump_filename", default_dump_filename);
     enable_throttle_control_ = configuration->property(role + ".enable_throttle_control", false);
+    playlist_ = configuration->property(role + ".playlist", std::string(""));
+    mmap_ = configuration->property(role + ".mmap", false) or !playlist_.empty();
+    size_t read_ahead_mb = configuration->property(role + ".read_ahead_mb", 32);
+    unsigned long long mmap_items = 0;
     double seconds_to_skip = configuration->property(role + ".seconds_to_skip", default_seconds_to_skip );
     long bytes_to_skip = 0;
 
@@ -122,9 +127,7 @@ TwoBitPackedFileSignalSource::TwoBitPackedFileSignalSource(ConfigurationInterfac
     }
     try
     {
-            file_source_ = gr::blocks::file_source::make(item_size_, filename_.c_str(), repeat_);
-
-            if( seconds_to_skip > 0 )
+            if( seconds_to_skip > 0 && playlist_.empty() )
             {
                 bytes_to_skip = static_cast< long >(
                         seconds_to_skip * sampling_frequency_ / 4 );
@@ -132,9 +135,26 @@ TwoBitPackedFileSignalSource::TwoBitPackedFileSignalSource(ConfigurationInterfac
                 {
                     bytes_to_skip <<= 1;
                 }
-                file_source_->seek( bytes_to_skip, SEEK_SET );
             }
 
+            if (mmap_)
+                {
+                    // the skipped items are left out of the mapped segment, a playlist gives its own
+                    mmap_file_source_sptr mmap_source = make_mmap_file_source(item_size_,
+                            mmap_playlist::load(playlist_, filename_, bytes_to_skip), repeat_, read_ahead_mb << 20);
+                    mmap_items = mmap_source->items();
+                    file_source_ = mmap_source;
+                }
+            else
+                {
+                    gr::blocks::file_source::sptr file_source = gr::blocks::file_source::make(item_size_, filename_.c_str(), repeat_);
+                    if( bytes_to_skip > 0 )
+                    {
+                        file_source->seek( bytes_to_skip, SEEK_SET );
+                    }
+                    file_source_ = file_source;
+                }
+
             unpack_samples_ = make_unpack_2bit_samples( big_endian_bytes_,
                     item_size_, big_endian_items_, reverse_interleaving_);
             if( is_complex_ )
@@ -184,7 +204,14 @@ TwoBitPackedFileSignalSource::TwoBitPackedFileSignalSource(ConfigurationInterfac
             std::ifstream file (filename_.c_str(), std::ios::in | std::ios::binary | std::ios::ate);
             std::ifstream::pos_type size;
 
-            if (file.is_open())
+            if (mmap_)
+                {
+                    size = (mmap_items + bytes_to_skip) * item_size_;  // as if the file were read up to the end
+                    samples_ = floor((double)size * ( is_complex_ ? 2.0 : 4.0 ) );
+                    samples_ -= bytes_to_skip;
+                    samples_ -= ceil( 0.002 * sampling_frequency_ / (is_complex_ ? 2.0 : 4.0 ) );
+                }
+            else if (file.is_open())
                 {
                     size = file.tellg();
                     samples_ = floor((double)size * ( is_complex_ ? 2.0 : 4.0 ) );
@@ -230,6 +257,7 @@ TwoBitPackedFileSignalSource::TwoBitPackedFileSignalSource(ConfigurationInterfac
     DLOG(INFO) << "Item type " << item_type_;
     DLOG(INFO) << "Item size " << item_size_;
     DLOG(INFO) << "Repeat " << repeat_;
+    DLOG(INFO) << "Memory-mapped " << mmap_;
     DLOG(INFO) << "Dump " << dump_;
     DLOG(INFO) << "Dump filename " << dump_filename_;
 }
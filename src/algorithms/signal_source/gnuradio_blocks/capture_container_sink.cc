@@ -0,0 +1,125 @@
+/*!
+ * \file capture_container_sink.cc
+ * \brief Sink block that records gr_complex or cshort samples in a
+ * compressed capture container.
+ *
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+
+#include "capture_container_sink.h"
+#include <stdexcept>
+#include <gnuradio/io_signature.h>
+#include <glog/logging.h>
+
+using google::LogMessage;
+
+
+capture_container_sink_sptr make_capture_container_sink(const std::string& filename, size_t item_size,
+        unsigned int bits, unsigned int block_samples, double sampling_frequency,
+        double intermediate_frequency, const std::map<std::string, std::string>& tags)
+{
+    return capture_container_sink_sptr(new capture_container_sink(filename, item_size, bits, block_samples,
+            sampling_frequency, intermediate_frequency, tags));
+}
+
+
+capture_container_sink::capture_container_sink(const std::string& filename, size_t item_size,
+        unsigned int bits, unsigned int block_samples, double sampling_frequency,
+        double intermediate_frequency, const std::map<std::string, std::string>& tags) :
+                gr::sync_block("capture_container_sink",
+                gr::io_signature::make(1, 1, item_size),
+                gr::io_signature::make(0, 0, 0)),
+                d_writer(filename, bits, block_samples, sampling_frequency, intermediate_frequency)
+{
+    if (item_size != sizeof(std::complex<float>) and item_size != sizeof(std::complex<int16_t>))
+        {
+            throw std::runtime_error("The capture container records gr_complex or cshort samples only");
+        }
+    for (std::map<std::string, std::string>::const_iterator it = tags.begin(); it != tags.end(); ++it)
+        {
+            d_writer.set_tag(it->first, it->second);
+        }
+    d_filename = filename;
+    d_cshort = (item_size == sizeof(std::complex<int16_t>));
+    d_failed = false;
+    LOG(INFO) << "Recording " << bits << "-bit samples in " << filename;
+}
+
+
+capture_container_sink::~capture_container_sink()
+{}
+
+
+unsigned long long capture_container_sink::samples() const
+{
+    return d_writer.samples();
+}
+
+
+bool capture_container_sink::stop()
+{
+    try
+    {
+            d_writer.close();
+            LOG(INFO) << "Recorded " << d_writer.samples() << " samples in " << d_filename;
+    }
+    catch (const std::runtime_error& e)
+    {
+            LOG(ERROR) << e.what() << " " << d_filename;
+    }
+    return true;
+}
+
+
+int capture_container_sink::work(int noutput_items,
+        gr_vector_const_void_star &input_items,
+        gr_vector_void_star &output_items __attribute__((unused)))
+{
+    if (d_failed) return noutput_items;
+    try
+    {
+            if (d_cshort)
+                {
+                    const std::complex<int16_t>* in = static_cast<const std::complex<int16_t>*>(input_items[0]);
+                    d_buffer.resize(noutput_items);
+                    for (int k = 0; k < noutput_items; k++)
+                        {
+                            d_buffer[k] = std::complex<float>(in[k].real(), in[k].imag());
+                        }
+                    d_writer.write(&d_buffer[0], noutput_items);
+                }
+            else
+                {
+                    d_writer.write(static_cast<const std::complex<float>*>(input_items[0]), noutput_items);
+                }
+    }
+    catch (const std::runtime_error& e)
+    {
+            // keep the receiver running, without the recording
+            LOG(ERROR) << e.what() << " " << d_filename << ", recording stopped";
+            d_failed = true;
+    }
+    return noutput_items;
+}
@@ -0,0 +1,82 @@
+/*!
+ * \file capture_container_sink.h
+ * \brief Sink block that records gr_complex or cshort samples in a
+ * compressed capture container.
+ *
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+
+#ifndef GNSS_SDR_CAPTURE_CONTAINER_SINK_H
+#define GNSS_SDR_CAPTURE_CONTAINER_SINK_H
+
+#include <complex>
+#include <map>
+#include <string>
+#include <vector>
+#include <gnuradio/sync_block.h>
+#include "capture_container.h"
+
+class capture_container_sink;
+
+typedef boost::shared_ptr<capture_container_sink> capture_container_sink_sptr;
+
+capture_container_sink_sptr make_capture_container_sink(const std::string& filename, size_t item_size,
+        unsigned int bits, unsigned int block_samples, double sampling_frequency,
+        double intermediate_frequency, const std::map<std::string, std::string>& tags);
+
+/*!
+ * \brief Records items of \a item_size bytes, gr_complex or cshort. The
+ * container is closed, with its tags, when the flow graph stops.
+ */
+class capture_container_sink: public gr::sync_block
+{
+private:
+    friend capture_container_sink_sptr
+    make_capture_container_sink(const std::string& filename, size_t item_size,
+            unsigned int bits, unsigned int block_samples, double sampling_frequency,
+            double intermediate_frequency, const std::map<std::string, std::string>& tags);
+
+    capture_container_writer d_writer;
+    std::string d_filename;
+    bool d_cshort;
+    bool d_failed;
+    std::vector<std::complex<float> > d_buffer;
+
+    capture_container_sink(const std::string& filename, size_t item_size,
+            unsigned int bits, unsigned int block_samples, double sampling_frequency,
+            double intermediate_frequency, const std::map<std::string, std::string>& tags);
+
+public:
+    ~capture_container_sink();
+
+    unsigned long long samples() const;
+    bool stop();
+
+    int work(int noutput_items,
+             gr_vector_const_void_star &input_items,
+             gr_vector_void_star &output_items);
+};
+
+#endif
@@ -0,0 +1,117 @@
+/*!
+ * \file capture_container_source.cc
+ * \brief Source block that decodes a compressed capture container into
+ * gr_complex or cshort samples.
+ *
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+
+#include "capture_container_source.h"
+#include <complex>
+#include <stdexcept>
+#include <gnuradio/io_signature.h>
+#include <glog/logging.h>
+
+using google::LogMessage;
+
+
+capture_container_source_sptr make_capture_container_source(const std::string& filename,
+        bool cshort, unsigned long long first_sample, bool repeat)
+{
+    return capture_container_source_sptr(new capture_container_source(filename, cshort, first_sample, repeat));
+}
+
+
+capture_container_source::capture_container_source(const std::string& filename, bool cshort,
+        unsigned long long first_sample, bool repeat) : gr::sync_block("capture_container_source",
+                gr::io_signature::make(0, 0, 0),
+                gr::io_signature::make(1, 1, cshort ? sizeof(std::complex<int16_t>) : sizeof(std::complex<float>))),
+                d_reader(filename)
+{
+    d_cshort = cshort;
+    d_repeat = repeat;
+    d_reader.seek(first_sample);
+    LOG(INFO) << "Playing " << filename << " (" << d_reader.header().bits << " bits, "
+              << d_reader.samples() << " samples) from sample " << first_sample;
+}
+
+
+capture_container_source::~capture_container_source()
+{}
+
+
+const capture_container_header& capture_container_source::header() const
+{
+    return d_reader.header();
+}
+
+
+const std::map<std::string, std::string>& capture_container_source::tags() const
+{
+    return d_reader.tags();
+}
+
+
+unsigned long long capture_container_source::position() const
+{
+    return d_reader.position();
+}
+
+
+int capture_container_source::work(int noutput_items,
+        gr_vector_const_void_star &input_items __attribute__((unused)),
+        gr_vector_void_star &output_items)
+{
+    size_t n = 0;
+    try
+    {
+            for (int pass = 0; pass < 2 and n == 0; pass++)
+                {
+                    if (d_cshort)
+                        {
+                            n = d_reader.read(static_cast<std::complex<int16_t>*>(output_items[0]), noutput_items);
+                        }
+                    else
+                        {
+                            n = d_reader.read(static_cast<std::complex<float>*>(output_items[0]), noutput_items);
+                        }
+                    if (n == 0 and d_repeat)
+                        {
+                            d_reader.seek(0);
+                        }
+                }
+    }
+    catch (const std::runtime_error& e)
+    {
+            LOG(ERROR) << e.what();
+            return WORK_DONE;
+    }
+    if (n == 0)
+        {
+            LOG(INFO) << "End of the capture container after sample " << d_reader.position();
+            return WORK_DONE;
+        }
+    return n;
+}
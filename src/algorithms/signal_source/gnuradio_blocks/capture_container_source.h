@@ -0,0 +1,78 @@
+/*!
+ * \file capture_container_source.h
+ * \brief Source block that decodes a compressed capture container into
+ * gr_complex or cshort samples.
+ *
+ * The blocks are decoded through per-block level tables straight into the
+ * output buffer type, and the stream can start at any sample: the reader
+ * seeks to the block that holds it.
+ *
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+
+#ifndef GNSS_SDR_CAPTURE_CONTAINER_SOURCE_H
+#define GNSS_SDR_CAPTURE_CONTAINER_SOURCE_H
+
+#include <string>
+#include <gnuradio/sync_block.h>
+#include "capture_container.h"
+
+class capture_container_source;
+
+typedef boost::shared_ptr<capture_container_source> capture_container_source_sptr;
+
+capture_container_source_sptr make_capture_container_source(const std::string& filename,
+        bool cshort, unsigned long long first_sample, bool repeat);
+
+/*!
+ * \brief Plays the container from \a first_sample, as cshort if \a cshort
+ * or else as gr_complex. With \a repeat it starts again from the first
+ * sample of the recording at the end.
+ */
+class capture_container_source: public gr::sync_block
+{
+private:
+    friend capture_container_source_sptr
+    make_capture_container_source(const std::string& filename, bool cshort, unsigned long long first_sample, bool repeat);
+
+    capture_container_reader d_reader;
+    bool d_cshort;
+    bool d_repeat;
+
+    capture_container_source(const std::string& filename, bool cshort, unsigned long long first_sample, bool repeat);
+
+public:
+    ~capture_container_source();
+
+    const capture_container_header& header() const;
+    const std::map<std::string, std::string>& tags() const;
+    unsigned long long position() const;  //!< Sample of the recording to be played next
+
+    int work(int noutput_items,
+             gr_vector_const_void_star &input_items,
+             gr_vector_void_star &output_items);
+};
+
+#endif
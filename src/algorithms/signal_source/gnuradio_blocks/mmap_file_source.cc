@@ -0,0 +1,93 @@
+/*!
+ * \file mmap_file_source.cc
+ * \brief Source block that plays memory-mapped captures, or an ordered list
+ * of capture segments, as one continuous stream.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "mmap_file_source.h"
+#include <gnuradio/io_signature.h>
+#include <glog/logging.h>
+
+using google::LogMessage;
+
+
+mmap_file_source_sptr make_mmap_file_source(size_t item_size,
+        const std::vector<mmap_segment>& segments, bool repeat, size_t read_ahead_bytes)
+{
+    return mmap_file_source_sptr(new mmap_file_source(item_size, segments, repeat, read_ahead_bytes));
+}
+
+
+mmap_file_source::mmap_file_source(size_t item_size, const std::vector<mmap_segment>& segments,
+        bool repeat, size_t read_ahead_bytes) : gr::sync_block("mmap_file_source",
+                gr::io_signature::make(0, 0, 0),
+                gr::io_signature::make(1, 1, item_size)),
+                d_playlist(item_size, repeat, read_ahead_bytes)
+{
+    for (std::vector<mmap_segment>::const_iterator it = segments.begin(); it != segments.end(); ++it)
+        {
+            d_playlist.add(*it);
+            LOG(INFO) << "Mapped " << it->filename << " from item " << it->first_item;
+        }
+    d_segment = 0;
+    LOG(INFO) << "Playing " << d_playlist.segments() << " segments of " << d_playlist.items() << " items in total";
+}
+
+
+mmap_file_source::~mmap_file_source()
+{}
+
+
+unsigned long long mmap_file_source::items() const
+{
+    return d_playlist.items();
+}
+
+
+unsigned long long mmap_file_source::position() const
+{
+    return d_playlist.position();
+}
+
+
+int mmap_file_source::work(int noutput_items,
+        gr_vector_const_void_star &input_items __attribute__((unused)),
+        gr_vector_void_star &output_items)
+{
+    size_t n = d_playlist.read(output_items[0], noutput_items);
+    if (d_playlist.segment() != d_segment)
+        {
+            d_segment = d_playlist.segment();
+            LOG(INFO) << "Playing segment " << d_segment << " of the playlist";
+        }
+    if (n == 0)
+        {
+            LOG(INFO) << "End of the playlist after " << d_playlist.position() << " items";
+            return WORK_DONE;
+        }
+    return n;
+}
@@ -0,0 +1,76 @@
+/*!
+ * \file mmap_file_source.h
+ * \brief Source block that plays memory-mapped captures, or an ordered list
+ * of capture segments, as one continuous stream.
+ *
+ * It replaces gr::blocks::file_source in the file signal source adapters
+ * when <role>.mmap=true or a <role>.playlist is given: no read calls, no
+ * intermediate buffer (the items are copied once, from the mapped pages to the
+ * output buffer), read-ahead requested with madvise, and the stream ends
+ * exactly after the last item of the list.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_MMAP_FILE_SOURCE_H
+#define GNSS_SDR_MMAP_FILE_SOURCE_H
+
+#include <vector>
+#include <gnuradio/sync_block.h>
+#include "mmap_playlist.h"
+
+class mmap_file_source;
+
+typedef boost::shared_ptr<mmap_file_source> mmap_file_source_sptr;
+
+mmap_file_source_sptr make_mmap_file_source(size_t item_size,
+        const std::vector<mmap_segment>& segments, bool repeat, size_t read_ahead_bytes);
+
+/*!
+ * \brief Plays the segments in order, items of \a item_size bytes
+ */
+class mmap_file_source: public gr::sync_block
+{
+private:
+    friend mmap_file_source_sptr
+    make_mmap_file_source(size_t item_size, const std::vector<mmap_segment>& segments, bool repeat, size_t read_ahead_bytes);
+
+    mmap_playlist d_playlist;
+    unsigned int d_segment;
+
+    mmap_file_source(size_t item_size, const std::vector<mmap_segment>& segments, bool repeat, size_t read_ahead_bytes);
+
+public:
+    ~mmap_file_source();
+
+    unsigned long long items() const;     //!< Items of one pass over the segments
+    unsigned long long position() const;  //!< Items played so far
+
+    int work(int noutput_items,
+             gr_vector_const_void_star &input_items,
+             gr_vector_void_star &output_items);
+};
+
+#endif
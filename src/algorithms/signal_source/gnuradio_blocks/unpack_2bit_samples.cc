@@ -31,6 +31,7 @@
 
 #include "unpack_2bit_samples.h"
 #include <gnuradio/io_signature.h>
+#include <volk_gnsssdr/volk_gnsssdr.h>
 
 struct byte_2bit_struct
 {
@@ -65,25 +66,6 @@ bool systemBytesAreBigEndian()
     return b.samples.sample_0 == 0x3;
 }
 
-void swapEndianness( int8_t const *in, std::vector< int8_t > &out, size_t item_size, unsigned int ninput_items )
-{
-    unsigned int i;
-    unsigned int j = 0;
-    int k = 0;
-    int l = 0;
-    size_t skip = item_size - 1;
-
-    for( i = 0; i < ninput_items; ++i )
-    {
-        k = j + skip;
-        l = j;
-        while( k >= l )
-        {
-            out[j++] = in[k--];
-        }
-    }
-}
-
 unpack_2bit_samples_sptr make_unpack_2bit_samples( bool big_endian_bytes,
                                                    size_t item_size,
                                                    bool big_endian_items,
@@ -123,6 +105,21 @@ unpack_2bit_samples::unpack_2bit_samples( bool big_endian_bytes,
 
     swap_endian_bytes_ = ( big_endian_bytes_system != big_endian_bytes_ );
 
+    // The samples of a byte in output order, as bit pairs: sample_0 is the
+    // least significant pair. The item byte swap is done by the kernel.
+    static const unsigned char orders[2][2][4] = {
+            { {0, 1, 2, 3}, {1, 0, 3, 2} },   // in order, reverse interleaving
+            { {3, 2, 1, 0}, {2, 3, 0, 1} } }; // swapped bytes
+    for( int i = 0; i < 4; ++i )
+    {
+        order_[i] = orders[swap_endian_bytes_][reverse_interleaving_][i];
+    }
+    // 2-bit two's complement codes 0, 1, -2, -1
+    levels_[0] = 1;
+    levels_[1] = 3;
+    levels_[2] = -3;
+    levels_[3] = -1;
+
 }
 
 unpack_2bit_samples::~unpack_2bit_samples()
@@ -132,93 +129,13 @@ int unpack_2bit_samples::work(int noutput_items,
                                    gr_vector_const_void_star &input_items,
                                    gr_vector_void_star &output_items)
 {
-    signed char const *in = (signed char const *)input_items[0];
+    unsigned char const *in = (unsigned char const *)input_items[0];
     int8_t *out = (int8_t*)output_items[0];
 
-    size_t ninput_bytes = noutput_items/4;
-    size_t ninput_items = ninput_bytes/item_size_;
-    
-    // Handle endian swap if needed
-    if( swap_endian_items_ )
-    {
-        work_buffer_.reserve( ninput_bytes );
-        swapEndianness( in, work_buffer_, item_size_, ninput_items );
-
-        in = const_cast< signed char const *> ( &work_buffer_[0] );
-    }
-
-    // Here the in pointer can be interpreted as a stream of bytes to be
-    // converted. But we now have two possibilities:
-    // 1) The samples in a byte are in big endian order
-    // 2) The samples in a byte are in little endian order
-
-    byte_and_samples raw_byte;
-    int n = 0;
-
-    if( !reverse_interleaving_ )
-    {
-        if( swap_endian_bytes_ )
-        {
-            for(unsigned int i = 0; i < ninput_bytes; ++i)
-            {
-                // Read packed input sample (1 byte = 4 samples)
-                raw_byte.byte = in[i];
-
-                out[n++] = (int8_t)( 2*raw_byte.samples.sample_3 + 1 );
-                out[n++] = (int8_t)( 2*raw_byte.samples.sample_2 + 1 );
-                out[n++] = (int8_t)( 2*raw_byte.samples.sample_1 + 1 );
-                out[n++] = (int8_t)( 2*raw_byte.samples.sample_0 + 1 );
-
-            }
-        }
-        else
-        {
-            for(unsigned int i = 0; i < ninput_bytes; ++i )
-            {
-
-                // Read packed input sample (1 byte = 4 samples)
-                raw_byte.byte = in[i];
-
-                out[n++] = (int8_t)( 2*raw_byte.samples.sample_0 + 1 );
-                out[n++] = (int8_t)( 2*raw_byte.samples.sample_1 + 1 );
-                out[n++] = (int8_t)( 2*raw_byte.samples.sample_2 + 1 );
-                out[n++] = (int8_t)( 2*raw_byte.samples.sample_3 + 1 );
-            }
-        }
-    }
-    else
-    {
-
-        if( swap_endian_bytes_ )
-        {
-            for(unsigned int i = 0; i < ninput_bytes; ++i)
-            {
-                // Read packed input sample (1 byte = 4 samples)
-                raw_byte.byte = in[i];
-
-                out[n++] = (int8_t)( 2*raw_byte.samples.sample_2 + 1 );
-                out[n++] = (int8_t)( 2*raw_byte.samples.sample_3 + 1 );
-                out[n++] = (int8_t)( 2*raw_byte.samples.sample_0 + 1 );
-                out[n++] = (int8_t)( 2*raw_byte.samples.sample_1 + 1 );
-
-            }
-        }
-        else
-        {
-            for(unsigned int i = 0; i < ninput_bytes; ++i )
-            {
-
-                // Read packed input sample (1 byte = 4 samples)
-                raw_byte.byte = in[i];
-
-                out[n++] = (int8_t)( 2*raw_byte.samples.sample_1 + 1 );
-                out[n++] = (int8_t)( 2*raw_byte.samples.sample_0 + 1 );
-                out[n++] = (int8_t)( 2*raw_byte.samples.sample_3 + 1 );
-                out[n++] = (int8_t)( 2*raw_byte.samples.sample_2 + 1 );
-            }
-        }
-    }
+    // 1 byte = 4 samples, with the item endian swap fused in the unpacking
+    volk_gnsssdr_8u_unpack2bit_8i( (char*)out, in, levels_, order_,
+                                   swap_endian_items_ ? item_size_ : 1,
+                                   noutput_items );
 
     return noutput_items;
 }
-
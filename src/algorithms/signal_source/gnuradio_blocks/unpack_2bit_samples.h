@@ -100,7 +100,8 @@ private:
     bool swap_endian_items_;
     bool swap_endian_bytes_;
     bool reverse_interleaving_;
-    std::vector< int8_t > work_buffer_;
+    char levels_[4];               // output of each 2-bit code: 2*x + 1
+    unsigned char order_[4];       // bit pair of each of the four outputs of a byte
 
 public:
     unpack_2bit_samples( bool big_endianBytes,
@@ -35,11 +35,18 @@
 
 #include "unpack_byte_2bit_cpx_samples.h"
 #include <gnuradio/io_signature.h>
+#include <volk_gnsssdr/volk_gnsssdr.h>
 
-struct byte_2bit_struct
+namespace
 {
-    signed two_bit_sample:2;  // <- 2 bits wide only
-};
+/*
+ * 1 byte = 2 complex samples. Packing order: most significant nibble,
+ * sample n; least significant nibble, sample n+1; within a nibble Q1 Q0 I1 I0.
+ * Output in I/Q swapped order, I[n] Q[n] I[n+1] Q[n+1], as 2*x + 1.
+ */
+const char levels[4] = {1, 3, -3, -1};
+const unsigned char order[4] = {2, 3, 0, 1};
+}
 
 
 unpack_byte_2bit_cpx_samples_sptr make_unpack_byte_2bit_cpx_samples()
@@ -60,47 +67,14 @@ int unpack_byte_2bit_cpx_samples::work(int noutput_items,
         gr_vector_const_void_star &input_items,
         gr_vector_void_star &output_items)
 {
-    const signed char *in = (const signed char *)input_items[0];
+    const unsigned char *in = (const unsigned char *)input_items[0];
     short *out = (short*)output_items[0];
 
-    byte_2bit_struct sample;
-    int n = 0;
-    for(int i = 0; i < noutput_items/4; i++)
+    d_buffer.resize(noutput_items);
+    volk_gnsssdr_8u_unpack2bit_8i(&d_buffer[0], in, levels, order, 1, noutput_items);
+    for(int n = 0; n < noutput_items; n++)
         {
-            // Read packed input sample (1 byte = 2 complex samples)
-            //*     Packing Order
-            //*     Most Significant Nibble  - Sample n
-            //*     Least Significant Nibble - Sample n+1
-            //*     Packing order in Nibble Q1 Q0 I1 I0
-            //normal
-            //  signed char c = in[i];
-            //  //Q[n]
-            //  sample.two_bit_sample = (c>>6) & 3;
-            //  out[n++] = (2*(short)sample.two_bit_sample+1);
-            //  //I[n]
-            //  sample.two_bit_sample = (c>>4) & 3;
-            //  out[n++] = (2*(short)sample.two_bit_sample+1);
-            //  //Q[n+1]
-            //  sample.two_bit_sample = (c>>2) & 3;
-            //  out[n++] = (2*(short)sample.two_bit_sample+1);
-            //  //I[n+1]
-            //  sample.two_bit_sample = c & 3;
-            //  out[n++] = (2*(short)sample.two_bit_sample+1);
-
-            //I/Q swap
-            signed char c = in[i];
-            //I[n]
-            sample.two_bit_sample = (c >> 4) & 3;
-            out[n++] = (2*(short)sample.two_bit_sample + 1);
-            //Q[n]
-            sample.two_bit_sample = (c >> 6) & 3;
-            out[n++] = (2*(short)sample.two_bit_sample + 1);
-            //I[n+1]
-            sample.two_bit_sample = c & 3;
-            out[n++] = (2*(short)sample.two_bit_sample + 1);
-            //Q[n+1]
-            sample.two_bit_sample = (c >> 2) & 3;
-            out[n++] = (2*(short)sample.two_bit_sample + 1);
+            out[n] = d_buffer[n];
         }
     return noutput_items;
 }
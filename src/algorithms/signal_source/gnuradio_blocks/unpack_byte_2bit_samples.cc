@@ -31,11 +31,15 @@
 
 #include "unpack_byte_2bit_samples.h"
 #include <gnuradio/io_signature.h>
+#include <volk/volk.h>
+#include <volk_gnsssdr/volk_gnsssdr.h>
 
-struct byte_2bit_struct
+namespace
 {
-    signed two_bit_sample:2;  // <- 2 bits wide only
-};
+// two's complement 2-bit codes, least significant pair first
+const char levels[4] = {0, 1, -2, -1};
+const unsigned char order[4] = {0, 1, 2, 3};
+}
 
 
 unpack_byte_2bit_samples_sptr make_unpack_byte_2bit_samples()
@@ -59,26 +63,12 @@ int unpack_byte_2bit_samples::work(int noutput_items,
         gr_vector_const_void_star &input_items,
         gr_vector_void_star &output_items)
 {
-    const signed char *in = (const signed char *)input_items[0];
+    const unsigned char *in = (const unsigned char *)input_items[0];
     float *out = (float*)output_items[0];
 
-    byte_2bit_struct sample;
-    int n = 0;
-    for(int i = 0; i < noutput_items/4; i++)
-        {
-            // Read packed input sample (1 byte = 4 samples)
-            signed char c = in[i];
-            sample.two_bit_sample = c & 3;
-            out[n++] = (float)sample.two_bit_sample;
-
-            sample.two_bit_sample = (c>>2) & 3;
-            out[n++] = (float)sample.two_bit_sample;
-
-            sample.two_bit_sample = (c>>4) & 3;
-            out[n++] = (float)sample.two_bit_sample;
-
-            sample.two_bit_sample = (c>>6) & 3;
-            out[n++] = (float)sample.two_bit_sample;
-        }
+    // 1 byte = 4 samples
+    d_buffer.resize(noutput_items);
+    volk_gnsssdr_8u_unpack2bit_8i(&d_buffer[0], in, levels, order, 1, noutput_items);
+    volk_8i_s32f_convert_32f(out, reinterpret_cast<const int8_t*>(&d_buffer[0]), 1.0, noutput_items);
     return noutput_items;
 }
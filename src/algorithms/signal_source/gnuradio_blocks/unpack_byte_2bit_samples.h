@@ -31,6 +31,7 @@
 #ifndef GNSS_SDR_UNPACK_BYTE_2BIT_SAMPLES_H
 #define GNSS_SDR_UNPACK_BYTE_2BIT_SAMPLES_H
 
+#include <vector>
 #include <gnuradio/sync_interpolator.h>
 
 class unpack_byte_2bit_samples;
@@ -49,6 +50,8 @@ private:
     friend unpack_byte_2bit_samples_sptr
     make_unpack_byte_2bit_samples_sptr();
 
+    std::vector<char> d_buffer;  // unpacked samples before the conversion to the output type
+
 public:
     unpack_byte_2bit_samples();
     ~unpack_byte_2bit_samples();
@@ -31,6 +31,8 @@
 
 #include "unpack_intspir_1bit_samples.h"
 #include <gnuradio/io_signature.h>
+#include <volk/volk.h>
+#include <volk_gnsssdr/volk_gnsssdr.h>
 
 
 
@@ -55,32 +57,14 @@ int unpack_intspir_1bit_samples::work(int noutput_items,
         gr_vector_const_void_star &input_items,
         gr_vector_void_star &output_items)
 {
-    const signed int *in = (const signed int *)input_items[0];
+    const unsigned int *in = (const unsigned int *)input_items[0];
     float *out = (float*)output_items[0];
-
-    int n = 0;
     int channel = 1;
-    for(int i = 0; i < noutput_items/2; i++)
-        {
-            // Read packed input sample (1 byte = 1 complex sample)
-            // For historical reasons, values are float versions of short int limits (32767)
-            signed int val = in[i];
-            if(((val >> ((channel - 1)*2)) & 1) == 1)
-                {
-                    out[n++] = static_cast<float>(32767.0);
-                }
-            else
-                {
-                    out[n++] = static_cast<float>(-32767.0);
-                }
-            if(((val >> (2*channel - 1)) & 1) == 1)
-                {
-                    out[n++] = static_cast<float>(32767.0);
-                }
-            else
-                {
-                    out[n++] = static_cast<float>(-32767.0);
-                }
-        }
+
+    // 1 int = 1 complex sample: bits 2*(channel - 1) and 2*channel - 1 to +/-1
+    d_buffer.resize(noutput_items / 2);
+    volk_gnsssdr_32u_unpack1bit_8ic(&d_buffer[0], in, 2 * (channel - 1), noutput_items / 2);
+    // For historical reasons, values are float versions of short int limits (32767)
+    volk_8i_s32f_convert_32f(out, reinterpret_cast<const int8_t*>(&d_buffer[0]), 1.0f / 32767.0f, noutput_items);
     return noutput_items;
 }
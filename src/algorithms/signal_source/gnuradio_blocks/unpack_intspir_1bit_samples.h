@@ -31,6 +31,8 @@
 #ifndef GNSS_SDR_UNPACK_INTSPIR_1BIT_SAMPLES_H
 #define GNSS_SDR_UNPACK_INTSPIR_1BIT_SAMPLES_H
 
+#include <vector>
+#include <volk_gnsssdr/volk_gnsssdr_complex.h>
 #include <gnuradio/sync_interpolator.h>
 
 class unpack_intspir_1bit_samples;
@@ -49,6 +51,8 @@ private:
     friend unpack_intspir_1bit_samples_sptr
     make_unpack_intspir_1bit_samples_sptr();
 
+    std::vector<lv_8sc_t> d_buffer;  // unpacked samples before the conversion to the output type
+
 public:
     unpack_intspir_1bit_samples();
     ~unpack_intspir_1bit_samples();
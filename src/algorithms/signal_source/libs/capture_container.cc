@@ -0,0 +1,602 @@
+/*!
+ * \file capture_container.cc
+ * \brief Compressed capture container: I/Q samples quantized to 2, 4 or 8
+ * bits with a scale factor per block, plus the sampling rate, IF and
+ * free-form tags of the recording.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+#include "capture_container.h"
+#include <sys/types.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace
+{
+const char container_magic[4] = {'G', 'C', 'A', 'P'};
+const unsigned int container_version = 1;
+
+void put_u16(unsigned char* p, uint16_t v)
+{
+    p[0] = v & 0xFF;
+    p[1] = v >> 8;
+}
+
+void put_u32(unsigned char* p, uint32_t v)
+{
+    for (int i = 0; i < 4; i++) p[i] = (v >> (8 * i)) & 0xFF;
+}
+
+void put_u64(unsigned char* p, uint64_t v)
+{
+    for (int i = 0; i < 8; i++) p[i] = (v >> (8 * i)) & 0xFF;
+}
+
+void put_f32(unsigned char* p, float v)
+{
+    uint32_t u;
+    std::memcpy(&u, &v, sizeof(u));
+    put_u32(p, u);
+}
+
+void put_f64(unsigned char* p, double v)
+{
+    uint64_t u;
+    std::memcpy(&u, &v, sizeof(u));
+    put_u64(p, u);
+}
+
+uint32_t get_u32(const unsigned char* p)
+{
+    uint32_t v = 0;
+    for (int i = 3; i >= 0; i--) v = (v << 8) | p[i];
+    return v;
+}
+
+uint64_t get_u64(const unsigned char* p)
+{
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; i--) v = (v << 8) | p[i];
+    return v;
+}
+
+float get_f32(const unsigned char* p)
+{
+    uint32_t u = get_u32(p);
+    float v;
+    std::memcpy(&v, &u, sizeof(v));
+    return v;
+}
+
+double get_f64(const unsigned char* p)
+{
+    uint64_t u = get_u64(p);
+    double v;
+    std::memcpy(&v, &u, sizeof(v));
+    return v;
+}
+
+bool valid_format(unsigned int bits, unsigned int block_samples)
+{
+    return (bits == 2 or bits == 4 or bits == 8) and block_samples > 0 and block_samples % 4 == 0;
+}
+
+/*
+ * The payload is decoded through a table indexed by the payload byte: at 2
+ * bits an entry holds the two samples of the byte, at 4 bits one sample, so
+ * that the inner loops do one load and one copy per byte instead of
+ * extracting and scaling each code.
+ */
+template <typename T>
+void decode_codes(const unsigned char* payload, size_t n, unsigned int bits, const T* level, std::complex<T>* out)
+{
+    switch (bits)
+    {
+    case 2:
+        {
+            std::complex<T> table[256][2];
+            for (unsigned int b = 0; b < 256; b++)
+                {
+                    table[b][0] = std::complex<T>(level[b & 3], level[(b >> 2) & 3]);
+                    table[b][1] = std::complex<T>(level[(b >> 4) & 3], level[b >> 6]);
+                }
+            for (size_t k = 0; k < n / 2; k++)
+                {
+                    out[2 * k] = table[payload[k]][0];
+                    out[2 * k + 1] = table[payload[k]][1];
+                }
+            break;
+        }
+    case 4:
+        {
+            std::complex<T> table[256];
+            for (unsigned int b = 0; b < 256; b++)
+                {
+                    table[b] = std::complex<T>(level[b & 15], level[b >> 4]);
+                }
+            for (size_t k = 0; k < n; k++)
+                {
+                    out[k] = table[payload[k]];
+                }
+            break;
+        }
+    default:
+        {
+            for (size_t k = 0; k < n; k++)
+                {
+                    out[k] = std::complex<T>(level[payload[2 * k]], level[payload[2 * k + 1]]);
+                }
+        }
+    }
+}
+}
+
+
+size_t capture_container_header::payload_bytes() const
+{
+    return static_cast<size_t>(block_samples) * 2 * bits / 8;
+}
+
+
+size_t capture_container_header::block_bytes() const
+{
+    return sizeof(float) + payload_bytes();
+}
+
+
+float capture_container_codec::level(unsigned int code, unsigned int bits)
+{
+    // mid-rise levels, at the centre of 2^bits equal steps over [-1, 1]
+    float steps = static_cast<float>(1 << bits);
+    return (2.0f * static_cast<float>(code) + 1.0f - steps) / steps;
+}
+
+
+float capture_container_codec::block_scale(const std::complex<float>* in, size_t n, unsigned int bits)
+{
+    if (n == 0) return 0.0f;
+    float max_abs = 0.0f;
+    double power = 0.0;
+    for (size_t k = 0; k < n; k++)
+        {
+            max_abs = std::max(max_abs, std::max(std::fabs(in[k].real()), std::fabs(in[k].imag())));
+            power += static_cast<double>(in[k].real()) * in[k].real() + static_cast<double>(in[k].imag()) * in[k].imag();
+        }
+    // clipping level in rms units: near the optimum for gaussian noise at 2
+    // and 4 bits, and large enough at 8 bits to pass interference unclipped
+    float clip = (bits == 2) ? 2.0f : ((bits == 4) ? 2.7f : 4.0f);
+    float rms = static_cast<float>(std::sqrt(power / (2.0 * n)));
+    return std::min(max_abs, clip * rms);
+}
+
+
+void capture_container_codec::encode(const std::complex<float>* in, size_t n, unsigned int bits, float scale, unsigned char* payload)
+{
+    const int steps = 1 << bits;
+    const float gain = (scale > 0.0f) ? 0.5f * steps / scale : 0.0f;
+    const float offset = 0.5f * steps;
+    unsigned char codes[4];
+    for (size_t k = 0; k < n; k++)
+        {
+            float component[2] = {in[k].real(), in[k].imag()};
+            for (int j = 0; j < 2; j++)
+                {
+                    int code = static_cast<int>(std::floor(component[j] * gain + offset));
+                    codes[2 * (k & 1) + j] = static_cast<unsigned char>(std::min(std::max(code, 0), steps - 1));
+                }
+            switch (bits)
+            {
+            case 2:
+                if (k & 1)
+                    {
+                        payload[k / 2] = codes[0] | (codes[1] << 2) | (codes[2] << 4) | (codes[3] << 6);
+                    }
+                break;
+            case 4:
+                payload[k] = codes[2 * (k & 1)] | (codes[2 * (k & 1) + 1] << 4);
+                break;
+            default:
+                payload[2 * k] = codes[2 * (k & 1)];
+                payload[2 * k + 1] = codes[2 * (k & 1) + 1];
+            }
+        }
+}
+
+
+void capture_container_codec::decode(const unsigned char* payload, size_t n, unsigned int bits, float scale, std::complex<float>* out)
+{
+    float level[256];
+    for (unsigned int c = 0; c < (1u << bits); c++)
+        {
+            level[c] = capture_container_codec::level(c, bits) * scale;
+        }
+    decode_codes(payload, n, bits, level, out);
+}
+
+
+void capture_container_codec::decode(const unsigned char* payload, size_t n, unsigned int bits, float scale, float gain, std::complex<int16_t>* out)
+{
+    int16_t level[256];
+    for (unsigned int c = 0; c < (1u << bits); c++)
+        {
+            float v = std::floor(capture_container_codec::level(c, bits) * scale * gain + 0.5f);
+            level[c] = static_cast<int16_t>(std::min(std::max(v, -32767.0f), 32767.0f));
+        }
+    decode_codes(payload, n, bits, level, out);
+}
+
+
+capture_container_writer::capture_container_writer(const std::string& filename, unsigned int bits,
+        unsigned int block_samples, double sampling_frequency, double intermediate_frequency)
+{
+    if (!valid_format(bits, block_samples))
+        {
+            throw std::runtime_error("Capture container: bits must be 2, 4 or 8 and the block size a multiple of 4 samples");
+        }
+    header_.bits = bits;
+    header_.block_samples = block_samples;
+    header_.sampling_frequency = sampling_frequency;
+    header_.intermediate_frequency = intermediate_frequency;
+    header_.samples = 0;
+    header_.tags_offset = 0;
+    header_.max_scale = 0.0f;
+    block_.resize(block_samples);
+    buffer_.resize(header_.block_bytes());
+    fill_ = 0;
+
+    file_ = std::fopen(filename.c_str(), "wb");
+    if (file_ == 0)
+        {
+            throw std::runtime_error("Unable to create the capture container " + filename);
+        }
+    unsigned char header[capture_container_header::size] = {};
+    std::memcpy(header, container_magic, 4);
+    put_u16(header + 4, container_version);
+    header[6] = bits;
+    put_u32(header + 8, block_samples);
+    put_f64(header + 16, sampling_frequency);
+    put_f64(header + 24, intermediate_frequency);
+    if (std::fwrite(header, 1, sizeof(header), file_) != sizeof(header))
+        {
+            std::fclose(file_);
+            file_ = 0;
+            throw std::runtime_error("Unable to write the capture container " + filename);
+        }
+}
+
+
+capture_container_writer::~capture_container_writer()
+{
+    try
+    {
+            close();
+    }
+    catch (const std::exception&)
+    {
+            // nothing left to do: the blocks already written remain readable
+    }
+}
+
+
+void capture_container_writer::set_tag(const std::string& key, const std::string& value)
+{
+    if (key.empty() or key.find_first_of("=\n") != std::string::npos or value.find('\n') != std::string::npos)
+        {
+            throw std::runtime_error("Capture container: invalid tag " + key);
+        }
+    tags_[key] = value;
+}
+
+
+void capture_container_writer::write(const std::complex<float>* in, size_t n)
+{
+    while (n > 0)
+        {
+            size_t chunk = std::min(n, block_.size() - fill_);
+            std::copy(in, in + chunk, block_.begin() + fill_);
+            fill_ += chunk;
+            in += chunk;
+            n -= chunk;
+            if (fill_ == block_.size())
+                {
+                    flush_block();
+                }
+        }
+}
+
+
+void capture_container_writer::flush_block()
+{
+    if (fill_ == 0 or file_ == 0) return;
+    std::fill(block_.begin() + fill_, block_.end(), std::complex<float>(0.0f, 0.0f));
+    float scale = capture_container_codec::block_scale(&block_[0], fill_, header_.bits);
+    put_f32(&buffer_[0], scale);
+    capture_container_codec::encode(&block_[0], block_.size(), header_.bits, scale, &buffer_[sizeof(float)]);
+    if (std::fwrite(&buffer_[0], 1, buffer_.size(), file_) != buffer_.size())
+        {
+            throw std::runtime_error("Unable to write the capture container");
+        }
+    header_.samples += fill_;
+    header_.max_scale = std::max(header_.max_scale, scale);
+    fill_ = 0;
+}
+
+
+void capture_container_writer::close()
+{
+    if (file_ == 0) return;
+    FILE* file = file_;
+    try
+    {
+            flush_block();
+    }
+    catch (const std::exception&)
+    {
+            file_ = 0;
+            std::fclose(file);
+            throw;
+    }
+    file_ = 0;
+    bool ok = true;
+    header_.tags_offset = capture_container_header::size
+            + (header_.samples + header_.block_samples - 1) / header_.block_samples * header_.block_bytes();
+    std::ostringstream tags;
+    for (std::map<std::string, std::string>::const_iterator it = tags_.begin(); it != tags_.end(); ++it)
+        {
+            tags << it->first << "=" << it->second << "\n";
+        }
+    std::string text = tags.str();
+    ok = ok and (text.empty() or std::fwrite(text.data(), 1, text.size(), file) == text.size());
+
+    unsigned char counts[20];
+    put_u64(counts, header_.samples);
+    put_u64(counts + 8, header_.tags_offset);
+    put_f32(counts + 16, header_.max_scale);
+    ok = ok and std::fseek(file, 32, SEEK_SET) == 0 and std::fwrite(counts, 1, sizeof(counts), file) == sizeof(counts);
+    ok = (std::fclose(file) == 0) and ok;
+    if (!ok)
+        {
+            throw std::runtime_error("Unable to close the capture container");
+        }
+}
+
+
+unsigned long long capture_container_writer::samples() const
+{
+    return header_.samples + fill_;
+}
+
+
+capture_container_reader::capture_container_reader(const std::string& filename)
+{
+    file_ = std::fopen(filename.c_str(), "rb");
+    if (file_ == 0)
+        {
+            throw std::runtime_error("Unable to open the capture container " + filename);
+        }
+    try
+    {
+            unsigned char header[capture_container_header::size];
+            if (std::fread(header, 1, sizeof(header), file_) != sizeof(header)
+                    or std::memcmp(header, container_magic, 4) != 0)
+                {
+                    throw std::runtime_error(filename + " is not a capture container");
+                }
+            if ((header[4] | (header[5] << 8)) != container_version)
+                {
+                    throw std::runtime_error("Unsupported version of the capture container " + filename);
+                }
+            header_.bits = header[6];
+            header_.block_samples = get_u32(header + 8);
+            if (!valid_format(header_.bits, header_.block_samples))
+                {
+                    throw std::runtime_error("Invalid format in the capture container " + filename);
+                }
+            header_.sampling_frequency = get_f64(header + 16);
+            header_.intermediate_frequency = get_f64(header + 24);
+            header_.samples = get_u64(header + 32);
+            header_.tags_offset = get_u64(header + 40);
+            header_.max_scale = get_f32(header + 48);
+
+            if (fseeko(file_, 0, SEEK_END) != 0)
+                {
+                    throw std::runtime_error("Unable to read the size of " + filename);
+                }
+            unsigned long long size = ftello(file_);
+            unsigned long long block_bytes = header_.block_bytes();
+            unsigned long long data_end = (header_.tags_offset != 0) ? header_.tags_offset : size;
+            if (data_end > size or data_end < capture_container_header::size)
+                {
+                    throw std::runtime_error("Truncated capture container " + filename);
+                }
+            unsigned long long blocks = (data_end - capture_container_header::size) / block_bytes;
+            if (header_.tags_offset == 0)
+                {
+                    // not closed: everything up to the last complete block, largest scale from the blocks
+                    header_.samples = blocks * header_.block_samples;
+                    for (unsigned long long b = 0; b < blocks; b++)
+                        {
+                            unsigned char scale[sizeof(float)];
+                            if (fseeko(file_, capture_container_header::size + b * block_bytes, SEEK_SET) != 0
+                                    or std::fread(scale, 1, sizeof(scale), file_) != sizeof(scale))
+                                {
+                                    throw std::runtime_error("Unable to read " + filename);
+                                }
+                            header_.max_scale = std::max(header_.max_scale, get_f32(scale));
+                        }
+                }
+            else if (header_.samples > blocks * header_.block_samples)
+                {
+                    throw std::runtime_error("Truncated capture container " + filename);
+                }
+            else
+                {
+                    std::string text(size - data_end, '\0');
+                    if (fseeko(file_, data_end, SEEK_SET) != 0
+                            or (!text.empty() and std::fread(&text[0], 1, text.size(), file_) != text.size()))
+                        {
+                            throw std::runtime_error("Unable to read the tags of " + filename);
+                        }
+                    std::istringstream lines(text);
+                    std::string line;
+                    while (std::getline(lines, line))
+                        {
+                            size_t eq = line.find('=');
+                            if (eq != std::string::npos and eq > 0)
+                                {
+                                    tags_[line.substr(0, eq)] = line.substr(eq + 1);
+                                }
+                        }
+                }
+    }
+    catch (const std::exception&)
+    {
+            std::fclose(file_);
+            throw;
+    }
+    buffer_.resize(header_.block_bytes());
+    block_ = -1;
+    short_block_ = false;
+    position_ = 0;
+}
+
+
+capture_container_reader::~capture_container_reader()
+{
+    std::fclose(file_);
+}
+
+
+const capture_container_header& capture_container_reader::header() const
+{
+    return header_;
+}
+
+
+const std::map<std::string, std::string>& capture_container_reader::tags() const
+{
+    return tags_;
+}
+
+
+unsigned long long capture_container_reader::samples() const
+{
+    return header_.samples;
+}
+
+
+unsigned long long capture_container_reader::position() const
+{
+    return position_;
+}
+
+
+float capture_container_reader::cshort_gain() const
+{
+    return (header_.max_scale > 0.0f) ? 16384.0f / header_.max_scale : 1.0f;
+}
+
+
+void capture_container_reader::seek(unsigned long long sample)
+{
+    if (sample > header_.samples)
+        {
+            throw std::runtime_error("Seek beyond the end of the capture container");
+        }
+    position_ = sample;
+}
+
+
+void capture_container_reader::load_block(unsigned long long block, bool as_short)
+{
+    if (block_ == static_cast<long long>(block) and short_block_ == as_short) return;
+    off_t offset = capture_container_header::size + block * header_.block_bytes();
+    if (fseeko(file_, offset, SEEK_SET) != 0
+            or std::fread(&buffer_[0], 1, buffer_.size(), file_) != buffer_.size())
+        {
+            block_ = -1;
+            throw std::runtime_error("Unable to read the capture container");
+        }
+    float scale = get_f32(&buffer_[0]);
+    if (as_short)
+        {
+            decoded_short_.resize(header_.block_samples);
+            capture_container_codec::decode(&buffer_[sizeof(float)], header_.block_samples, header_.bits,
+                    scale, cshort_gain(), &decoded_short_[0]);
+        }
+    else
+        {
+            decoded_.resize(header_.block_samples);
+            capture_container_codec::decode(&buffer_[sizeof(float)], header_.block_samples, header_.bits,
+                    scale, &decoded_[0]);
+        }
+    block_ = block;
+    short_block_ = as_short;
+}
+
+
+size_t capture_container_reader::next_run(size_t max, bool as_short, size_t& offset)
+{
+    if (max == 0 or position_ >= header_.samples) return 0;
+    unsigned long long block = position_ / header_.block_samples;
+    offset = position_ % header_.block_samples;
+    load_block(block, as_short);
+    size_t n = std::min<unsigned long long>(std::min<unsigned long long>(max, header_.block_samples - offset),
+            header_.samples - position_);
+    position_ += n;
+    return n;
+}
+
+
+size_t capture_container_reader::read(std::complex<float>* out, size_t max)
+{
+    size_t done = 0;
+    size_t offset = 0;
+    size_t n;
+    while ((n = next_run(max - done, false, offset)) > 0)
+        {
+            std::copy(decoded_.begin() + offset, decoded_.begin() + offset + n, out + done);
+            done += n;
+        }
+    return done;
+}
+
+
+size_t capture_container_reader::read(std::complex<int16_t>* out, size_t max)
+{
+    size_t done = 0;
+    size_t offset = 0;
+    size_t n;
+    while ((n = next_run(max - done, true, offset)) > 0)
+        {
+            std::copy(decoded_short_.begin() + offset, decoded_short_.begin() + offset + n, out + done);
+            done += n;
+        }
+    return done;
+}
@@ -0,0 +1,198 @@
+/*!
+ * \file capture_container.h
+ * \brief Compressed capture container: I/Q samples quantized to 2, 4 or 8
+ * bits with a scale factor per block, plus the sampling rate, IF and
+ * free-form tags of the recording.
+ *
+ * Layout (little-endian):
+ *   header (64 bytes): "GCAP", version, bits, block_samples, sampling
+ *       frequency, IF, samples, offset of the tags, largest block scale;
+ *   blocks: float scale, then block_samples I/Q codes packed in bytes;
+ *   tags: "key=value" lines up to the end of the file.
+ *
+ * Every block has the same size, so the seek index is the block number:
+ * sample n is in the block n / block_samples, at a known offset. A recording
+ * that was not closed (no samples or tags in the header) is still readable
+ * up to its last complete block.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_CAPTURE_CONTAINER_H
+#define GNSS_SDR_CAPTURE_CONTAINER_H
+
+#include <complex>
+#include <cstddef>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+/*!
+ * \brief Fixed part of the container
+ */
+struct capture_container_header
+{
+    unsigned int bits;             // 2, 4 or 8 per I and per Q component
+    unsigned int block_samples;    // complex samples per block, multiple of 4
+    double sampling_frequency;     // [Hz]
+    double intermediate_frequency; // [Hz]
+    unsigned long long samples;
+    unsigned long long tags_offset;
+    float max_scale;               // largest block scale, sets the cshort gain
+
+    static const size_t size = 64;
+
+    size_t payload_bytes() const;  //!< Bytes of the codes of one block
+    size_t block_bytes() const;    //!< Bytes of one block, scale included
+};
+
+
+/*!
+ * \brief Quantization and packing of one block
+ */
+class capture_container_codec
+{
+public:
+    /*!
+     * \brief Scale of the block: the largest magnitude of I and Q, clipped
+     * to a multiple of their rms value that depends on \a bits.
+     */
+    static float block_scale(const std::complex<float>* in, size_t n, unsigned int bits);
+
+    /*!
+     * \brief Packs the codes of \a n samples (n multiple of 4) in \a payload
+     */
+    static void encode(const std::complex<float>* in, size_t n, unsigned int bits, float scale, unsigned char* payload);
+
+    /*!
+     * \brief Decodes \a n samples through the level table of the block:
+     * one table entry, of two complex samples at 2 bits, per payload byte.
+     */
+    static void decode(const unsigned char* payload, size_t n, unsigned int bits, float scale, std::complex<float>* out);
+    static void decode(const unsigned char* payload, size_t n, unsigned int bits, float scale, float gain, std::complex<int16_t>* out);
+
+    /*!
+     * \brief Reconstruction level of \a code, in units of the block scale
+     */
+    static float level(unsigned int code, unsigned int bits);
+};
+
+
+/*!
+ * \brief Records samples in a new container. Throws std::runtime_error if
+ * the file cannot be written or the parameters are not valid.
+ */
+class capture_container_writer
+{
+public:
+    capture_container_writer(const std::string& filename, unsigned int bits, unsigned int block_samples,
+            double sampling_frequency, double intermediate_frequency);
+    ~capture_container_writer();
+
+    void set_tag(const std::string& key, const std::string& value);
+    void write(const std::complex<float>* in, size_t n);
+
+    /*!
+     * \brief Writes the last, zero padded, block, the tags and the final
+     * header. Called by the destructor if needed.
+     */
+    void close();
+
+    unsigned long long samples() const;
+
+private:
+    FILE* file_;
+    capture_container_header header_;
+    std::map<std::string, std::string> tags_;
+    std::vector<std::complex<float> > block_;
+    std::vector<unsigned char> buffer_;
+    size_t fill_;
+
+    void flush_block();
+
+    capture_container_writer(const capture_container_writer&);
+    capture_container_writer& operator=(const capture_container_writer&);
+};
+
+
+/*!
+ * \brief Random access reader. Throws std::runtime_error if the file is not
+ * a container or cannot be read.
+ */
+class capture_container_reader
+{
+public:
+    explicit capture_container_reader(const std::string& filename);
+    ~capture_container_reader();
+
+    const capture_container_header& header() const;
+    const std::map<std::string, std::string>& tags() const;
+    unsigned long long samples() const;
+    unsigned long long position() const;
+
+    /*!
+     * \brief Moves to \a sample (at most samples()). Only the block that
+     * holds it is read.
+     */
+    void seek(unsigned long long sample);
+
+    /*!
+     * \brief Decodes the next samples, up to \a max, to \a out. Returns the
+     * number of samples decoded, 0 at the end of the recording.
+     */
+    size_t read(std::complex<float>* out, size_t max);
+
+    /*!
+     * \brief As above, in cshort scaled by cshort_gain()
+     */
+    size_t read(std::complex<int16_t>* out, size_t max);
+
+    /*!
+     * \brief Gain from the decoded float samples to cshort, with 6 dB of
+     * headroom over the largest block scale.
+     */
+    float cshort_gain() const;
+
+private:
+    FILE* file_;
+    capture_container_header header_;
+    std::map<std::string, std::string> tags_;
+    std::vector<unsigned char> buffer_;
+    std::vector<std::complex<float> > decoded_;
+    std::vector<std::complex<int16_t> > decoded_short_;
+    long long block_;              // block in decoded_ or decoded_short_, -1: none
+    bool short_block_;             // the decoded block is in decoded_short_
+    unsigned long long position_;
+
+    void load_block(unsigned long long block, bool as_short);
+    size_t next_run(size_t max, bool as_short, size_t& offset);
+
+    capture_container_reader(const capture_container_reader&);
+    capture_container_reader& operator=(const capture_container_reader&);
+};
+
+#endif
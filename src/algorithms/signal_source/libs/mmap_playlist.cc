@@ -0,0 +1,262 @@
+/*!
+ * \file mmap_playlist.cc
+ * \brief Plays an ordered list of memory-mapped capture segments as one
+ * continuous stream of items.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+#include "mmap_playlist.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <boost/lexical_cast.hpp>
+
+
+mmap_playlist::mmap_playlist(size_t item_size, bool repeat, size_t read_ahead_bytes)
+    : item_size_(item_size), repeat_(repeat), read_ahead_(read_ahead_bytes),
+      items_(0), position_(0), current_(0), offset_(0), advised_(0), released_(0)
+{
+    page_ = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+
+mmap_playlist::~mmap_playlist()
+{
+    for (std::vector<mapping>::iterator it = mappings_.begin(); it != mappings_.end(); ++it)
+        {
+            munmap(it->base, it->length);
+        }
+}
+
+
+void mmap_playlist::add(const mmap_segment& segment)
+{
+    int fd = open(segment.filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        {
+            throw std::runtime_error("Unable to open the samples file " + segment.filename);
+        }
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+        {
+            close(fd);
+            throw std::runtime_error("Unable to read the size of the samples file " + segment.filename);
+        }
+    unsigned long long file_items = static_cast<unsigned long long>(st.st_size) / item_size_;
+    unsigned long long items = segment.items;
+    if (items == 0 && segment.first_item < file_items)
+        {
+            items = file_items - segment.first_item;
+        }
+    if (items == 0 || segment.first_item + items > file_items)
+        {
+            close(fd);
+            throw std::runtime_error("The segment of " + segment.filename + " from item "
+                    + boost::lexical_cast<std::string>(segment.first_item) + " is empty or beyond the end of the file");
+        }
+
+    mapping m;
+    m.filename = segment.filename;
+    m.length = static_cast<size_t>(st.st_size);
+    m.begin = static_cast<size_t>(segment.first_item * item_size_);
+    m.items = items;
+    void* base = mmap(0, m.length, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);  // the mapping keeps the file open
+    if (base == MAP_FAILED)
+        {
+            throw std::runtime_error("Unable to map the samples file " + segment.filename);
+        }
+    m.base = static_cast<char*>(base);
+    madvise(m.base, m.length, MADV_SEQUENTIAL);
+    mappings_.push_back(m);
+    items_ += items;
+}
+
+
+void mmap_playlist::advise(mapping& m, size_t end)
+{
+    // keep the read-ahead window requested ahead of the read position
+    if (read_ahead_ == 0 || end + read_ahead_ / 2 < advised_) return;
+    size_t from = std::max(advised_, end) - std::max(advised_, end) % page_;
+    size_t to = std::min(m.length, end + read_ahead_);
+    if (to > from)
+        {
+            madvise(m.base + from, to - from, MADV_WILLNEED);
+        }
+    advised_ = to;
+}
+
+
+void mmap_playlist::release(mapping& m, size_t end)
+{
+    // drop the pages already read, whole pages only
+    if (read_ahead_ == 0) return;
+    size_t to = end - end % page_;
+    if (to > released_ + read_ahead_ || (to > released_ && end >= m.begin + m.items * item_size_))
+        {
+            madvise(m.base + released_, to - released_, MADV_DONTNEED);
+            released_ = to;
+        }
+}
+
+
+size_t mmap_playlist::read(void* out, size_t max_items)
+{
+    char* dst = static_cast<char*>(out);
+    size_t done = 0;
+    unsigned int current = current_.load(std::memory_order_relaxed);
+    while (done < max_items && !mappings_.empty())
+        {
+            if (current == mappings_.size())
+                {
+                    if (!repeat_) break;
+                    current = 0;
+                }
+            mapping& m = mappings_.at(current);
+            if (offset_ == 0)
+                {
+                    advised_ = m.begin;
+                    released_ = m.begin - m.begin % page_;
+                }
+            size_t n = static_cast<size_t>(std::min(m.items - offset_, static_cast<unsigned long long>(max_items - done)));
+            size_t from = m.begin + static_cast<size_t>(offset_) * item_size_;
+            size_t to = from + n * item_size_;
+            advise(m, to);
+            std::memcpy(dst + done * item_size_, m.base + from, n * item_size_);
+            release(m, to);
+            offset_ += n;
+            done += n;
+            if (offset_ == m.items)
+                {
+                    offset_ = 0;
+                    current++;
+                }
+        }
+    current_.store(current, std::memory_order_relaxed);
+    position_.fetch_add(done, std::memory_order_relaxed);
+    return done;
+}
+
+
+unsigned long long mmap_playlist::items() const
+{
+    return items_;
+}
+
+
+unsigned long long mmap_playlist::position() const
+{
+    return position_.load(std::memory_order_relaxed);
+}
+
+
+unsigned int mmap_playlist::segment() const
+{
+    return current_.load(std::memory_order_relaxed);
+}
+
+
+unsigned int mmap_playlist::segments() const
+{
+    return mappings_.size();
+}
+
+
+bool mmap_playlist::parse(std::istream& list, std::vector<mmap_segment>& segments, std::string& error)
+{
+    std::string line;
+    while (std::getline(list, line))
+        {
+            std::istringstream fields(line);
+            mmap_segment segment;
+            segment.first_item = 0;
+            segment.items = 0;
+            if (!(fields >> segment.filename) || segment.filename.at(0) == '#')
+                {
+                    continue;
+                }
+            std::string first;
+            std::string items;
+            std::string extra;
+            fields >> first >> items >> extra;
+            try
+            {
+                    if ((!first.empty() && first.at(0) == '-') || (!items.empty() && items.at(0) == '-'))
+                        {
+                            throw boost::bad_lexical_cast();
+                        }
+                    if (!first.empty()) segment.first_item = boost::lexical_cast<unsigned long long>(first);
+                    if (!items.empty()) segment.items = boost::lexical_cast<unsigned long long>(items);
+            }
+            catch (const boost::bad_lexical_cast&)
+            {
+                    error = line;
+                    return false;
+            }
+            if (!extra.empty())
+                {
+                    error = line;
+                    return false;
+                }
+            segments.push_back(segment);
+        }
+    return true;
+}
+
+
+std::vector<mmap_segment> mmap_playlist::load(const std::string& playlist, const std::string& filename, unsigned long long first_item)
+{
+    std::vector<mmap_segment> segments;
+    if (playlist.empty())
+        {
+            mmap_segment segment;
+            segment.filename = filename;
+            segment.first_item = first_item;
+            segment.items = 0;
+            segments.push_back(segment);
+            return segments;
+        }
+    std::ifstream list(playlist.c_str());
+    std::string error;
+    if (!list.is_open())
+        {
+            throw std::runtime_error("Unable to open the playlist " + playlist);
+        }
+    if (!parse(list, segments, error))
+        {
+            throw std::runtime_error("Malformed line in the playlist " + playlist + ": " + error);
+        }
+    if (segments.empty())
+        {
+            throw std::runtime_error("The playlist " + playlist + " names no capture");
+        }
+    return segments;
+}
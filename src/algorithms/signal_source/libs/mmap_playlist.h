@@ -0,0 +1,133 @@
+/*!
+ * \file mmap_playlist.h
+ * \brief Plays an ordered list of memory-mapped capture segments as one
+ * continuous stream of items.
+ *
+ * Each capture is mapped read-only once. The pages ahead of the read position
+ * are requested with madvise (sequential access, and WILLNEED over a
+ * read-ahead window), and those already played are released, so that the
+ * resident memory stays bounded for captures of any length.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_MMAP_PLAYLIST_H
+#define GNSS_SDR_MMAP_PLAYLIST_H
+
+#include <atomic>
+#include <cstddef>
+#include <istream>
+#include <string>
+#include <vector>
+
+/*!
+ * \brief A capture, or the part of it from \a first_item on
+ */
+struct mmap_segment
+{
+    std::string filename;
+    unsigned long long first_item;  // items of the file skipped before the segment
+    unsigned long long items;       // 0: up to the end of the file
+};
+
+
+/*!
+ * \brief Ordered list of mapped segments read as a single stream.
+ *
+ * The counters are exact: items() is the number of items of one pass over
+ * the list and position() the number of items read so far, over all passes.
+ */
+class mmap_playlist
+{
+public:
+    /*!
+     * \brief Items are \a item_size bytes long. With \a repeat the list is
+     * played again from its first segment after the last one.
+     */
+    mmap_playlist(size_t item_size, bool repeat, size_t read_ahead_bytes);
+    ~mmap_playlist();
+
+    /*!
+     * \brief Maps the segment. Throws std::runtime_error if the file cannot be
+     * mapped or the segment is empty or goes beyond the end of the file.
+     */
+    void add(const mmap_segment& segment);
+
+    /*!
+     * \brief Copies the next items, up to \a max_items, to \a out. Returns the
+     * number of items copied, 0 at the end of the list.
+     */
+    size_t read(void* out, size_t max_items);
+
+    unsigned long long items() const;
+    unsigned long long position() const;
+    unsigned int segment() const;   //!< Index of the segment being read
+    unsigned int segments() const;
+
+    /*!
+     * \brief Reads one segment per line, "<file> [first_item] [items]", in
+     * items of the capture. Blank lines and lines starting with # are
+     * skipped. Returns false and the offending line in \a error on a
+     * malformed line.
+     */
+    static bool parse(std::istream& list, std::vector<mmap_segment>& segments, std::string& error);
+
+    /*!
+     * \brief Segments of the playlist file \a playlist if not empty, or else
+     * \a filename from \a first_item on. Throws std::runtime_error if the
+     * playlist cannot be read.
+     */
+    static std::vector<mmap_segment> load(const std::string& playlist, const std::string& filename, unsigned long long first_item);
+
+private:
+    struct mapping
+    {
+        std::string filename;
+        char* base;                // start of the mapping (page aligned)
+        size_t length;             // bytes mapped
+        size_t begin;              // offset of the first item of the segment
+        unsigned long long items;
+    };
+
+    std::vector<mapping> mappings_;
+    size_t item_size_;
+    bool repeat_;
+    size_t read_ahead_;
+    size_t page_;
+    unsigned long long items_;
+    std::atomic<unsigned long long> position_;
+    std::atomic<unsigned int> current_;
+    unsigned long long offset_;    // items read from the current segment
+    size_t advised_;               // end of the WILLNEED window in the current mapping
+    size_t released_;              // end of the released pages of the current mapping
+
+    void advise(mapping& m, size_t end);
+    void release(mapping& m, size_t end);
+
+    mmap_playlist(const mmap_playlist&);
+    mmap_playlist& operator=(const mmap_playlist&);
+};
+
+#endif
@@ -127,6 +127,7 @@ gps_l1_ca_sd_telemetry_decoder_cc::gps_l1_ca_sd_telemetry_decoder_cc(
     d_word_number = 0;
     d_decimation_output_factor = 1;
     d_channel = 0;
+    d_perf = Gnss_Sdr_Perf::instance().add("telemetry", 1.0 / GPS_L1_CA_CODE_PERIOD);
     Prn_timestamp_at_preamble_ms = 0.0;
     flag_PLL_180_deg_phase_locked = false;
 
@@ -166,9 +167,11 @@ bool gps_l1_ca_sd_telemetry_decoder_cc::gps_word_parityCheck(unsigned int gpswor
 }
 
 
-int gps_l1_ca_sd_telemetry_decoder_cc::general_work (int noutput_items __attribute__((unused)), gr_vector_int &ninput_items __attribute__((unused)),
+int gps_l1_ca_sd_telemetry_decoder_cc::general_work (int noutput_items __attribute__((unused)), gr_vector_int &ninput_items,
         gr_vector_const_void_star &input_items, gr_vector_void_star &output_items)
 {
+    Gnss_Sdr_Perf_Scope perf_scope(d_perf.get(), this, ninput_items[0]);
+    d_spoofing_detector.update_parameters(); // thresholds changed at run time
 
     int corr_value = 0;
     int preamble_diff_ms = 0;
@@ -326,6 +329,7 @@ int gps_l1_ca_sd_telemetry_decoder_cc::general_work (int noutput_items __attribu
 
                              memcpy(&d_GPS_FSM.d_GPS_frame_4bytes, &d_GPS_frame_4bytes, sizeof(char)*4);
                              d_GPS_FSM.d_preamble_time_ms = d_preamble_time_seconds * 1000.0;
+                             d_GPS_FSM.d_receiver_time_ms = in[0][0].Tracking_timestamp_secs * 1000.0;
                              d_GPS_FSM.Event_gps_word_valid();
                              // send TLM data to PVT using asynchronous message queues
                              if (d_GPS_FSM.d_flag_new_subframe == true)
@@ -485,6 +489,7 @@ int gps_l1_ca_sd_telemetry_decoder_cc::general_work (int noutput_items __attribu
  void gps_l1_ca_sd_telemetry_decoder_cc::set_channel(int channel)
  {
      d_channel = channel;
+     d_perf->set_channel(channel);
      d_GPS_FSM.i_channel_ID = channel;
      DLOG(INFO) << "Navigation channel set to " << channel;
      // ############# ENABLE DATA FILE LOG #################
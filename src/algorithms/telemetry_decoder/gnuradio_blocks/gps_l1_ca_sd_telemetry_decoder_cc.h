@@ -35,6 +35,7 @@
 #define GNSS_SDR_GPS_L1_CA_SD_TELEMETRY_DECODER_CC_H
 
 #include <fstream>
+#include <memory>
 #include <string>
 #include <gnuradio/block.h>
 #include <deque>
@@ -42,6 +43,7 @@
 #include "gps_l1_ca_sd_subframe_fsm.h"
 #include "concurrent_queue.h"
 #include "gnss_satellite.h"
+#include "gnss_sdr_perf.h"
 
 class gps_l1_ca_sd_telemetry_decoder_cc;
 
@@ -135,6 +137,7 @@ private:
     bool d_dump;
     Gnss_Satellite d_satellite;
     int d_channel;
+    std::shared_ptr<Gnss_Sdr_Block_Perf> d_perf;
 
     double d_preamble_time_seconds;
 
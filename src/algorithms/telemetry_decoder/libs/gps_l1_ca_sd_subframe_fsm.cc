@@ -38,7 +38,12 @@
 #include <boost/statechart/transition.hpp>
 #include <boost/statechart/custom_reaction.hpp>
 #include <boost/mpl/list.hpp>
+#include <glog/logging.h>
 #include "gnss_satellite.h"
+#include "concurrent_ring.h"
+#include "spoofing_capture.h"
+
+extern concurrent_ring<Capture_Subframe> global_capture_subframe_queue;
 
 //************ GPS WORD TO SUBFRAME DECODER STATE MACHINE **********
 
@@ -241,6 +246,7 @@ GpsL1CaSdSubframeFsm::GpsL1CaSdSubframeFsm()
     i_channel_ID = 0;
     i_satellite_PRN = 0;
     d_preamble_time_ms = 0;
+    d_receiver_time_ms = -1;
     d_subframe_ID=0;
     d_flag_new_subframe=false;
     initiate(); //start the FSM
@@ -274,6 +280,23 @@ void GpsL1CaSdSubframeFsm::gps_sd_subframe_to_nav_msg()
 
     d_nav.i_peak = i_peak; 
     d_nav.uid = uid; 
+
+    if(!spoofing_detector.get_capture_filename().empty())
+        {
+            // written to the capture file by the PVT block
+            Capture_Subframe capture;
+            capture.channel = i_channel_ID;
+            capture.PRN = i_satellite_PRN;
+            capture.peak = i_peak;
+            capture.uid = uid;
+            capture.timestamp_ms = this->d_preamble_time_ms;
+            capture.receiver_time_ms = this->d_receiver_time_ms;
+            std::memcpy(capture.subframe, d_subframe, GPS_SUBFRAME_LENGTH);
+            if (!global_capture_subframe_queue.push(capture))
+                {
+                    LOG(WARNING) << "Capture subframe queue full, subframe " << d_subframe_ID << " of PRN " << i_satellite_PRN << " not recorded";
+                }
+        }
     std::cout << "NAV Message: received subframe "
         << d_subframe_ID << " from satellite "
         << Gnss_Satellite(std::string("GPS"), i_satellite_PRN) 
@@ -282,19 +305,19 @@ void GpsL1CaSdSubframeFsm::gps_sd_subframe_to_nav_msg()
         << " in channel: " << i_channel_ID 
         << " id: "  << d_nav.uid << std::endl << std::endl; 
         //<<  "subframe: " << d_nav.get_subframe(d_subframe_ID) << std::endl << std::endl;
-    spoofing_detector.New_subframe(d_subframe_ID, i_satellite_PRN, d_nav, this->d_preamble_time_ms);
+    spoofing_detector.New_subframe(d_subframe_ID, i_satellite_PRN, d_nav, this->d_preamble_time_ms, this->d_receiver_time_ms);
 
     if(  d_subframe_ID == 4 )
     {
         if (d_nav.flag_iono_valid == true)
             {
                 Gps_Iono iono = d_nav.get_iono(); //notice that the read operation will clear the valid flag
-                spoofing_detector.check_external_iono(iono, this->d_preamble_time_ms); 
+                spoofing_detector.check_external_iono(iono, this->d_preamble_time_ms, this->d_receiver_time_ms);
             }
         if (d_nav.flag_utc_model_valid == true)
             {
                 Gps_Utc_Model utc_model = d_nav.get_utc_model(); //notice that the read operation will clear the valid flag
-                spoofing_detector.check_external_utc(utc_model, this->d_preamble_time_ms); 
+                spoofing_detector.check_external_utc(utc_model, this->d_preamble_time_ms, this->d_receiver_time_ms);
             }
     }
     d_flag_new_subframe=true;
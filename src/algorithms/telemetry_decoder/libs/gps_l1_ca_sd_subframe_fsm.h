@@ -85,6 +85,7 @@ public:
     bool d_flag_new_subframe;
     char d_GPS_frame_4bytes[GPS_WORD_LENGTH];
     double d_preamble_time_ms;
+    double d_receiver_time_ms; //!< Receiver time at which the current word was completed [ms]
 
     void gps_word_to_subframe(int position); //!< inserts the word in the correct position of the subframe
 
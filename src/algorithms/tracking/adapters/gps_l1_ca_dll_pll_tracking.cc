@@ -110,12 +110,20 @@ void GpsL1CaDllPllTracking::start_tracking()
 }
 
 
+bool GpsL1CaDllPllTracking::skip_samples(unsigned long int samples)
+{
+    tracking_->skip_samples(samples);
+    return true;
+}
+
+
 /*
  * Set tracking channel unique ID
  */
 void GpsL1CaDllPllTracking::set_channel(unsigned int channel)
 {
     channel_ = channel;
+    tracking_->set_role(role_);
     tracking_->set_channel(channel);
 }
 
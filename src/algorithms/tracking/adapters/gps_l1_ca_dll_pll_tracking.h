@@ -93,6 +93,11 @@ public:
     void start_tracking();
     void stop_tracking();
 
+    /*!
+     * \brief Advances the sample counter over samples dropped while the channel was parked
+     */
+    bool skip_samples(unsigned long int samples);
+
 private:
     gps_l1_ca_dll_pll_tracking_cc_sptr tracking_;
     size_t item_size_;
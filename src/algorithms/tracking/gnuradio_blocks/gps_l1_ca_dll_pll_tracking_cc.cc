@@ -171,6 +171,7 @@ Gps_L1_Ca_Dll_Pll_Tracking_cc::Gps_L1_Ca_Dll_Pll_Tracking_cc(
 
     d_acquisition_gnss_synchro = 0;
     d_channel = 0;
+    d_perf = Gnss_Sdr_Perf::instance().add("tracking", static_cast<double>(d_fs_in));
     d_acq_code_phase_samples = 0.0;
     d_acq_carrier_doppler_hz = 0.0;
     d_carrier_doppler_hz = 0.0;
@@ -294,9 +295,18 @@ Gps_L1_Ca_Dll_Pll_Tracking_cc::~Gps_L1_Ca_Dll_Pll_Tracking_cc()
 
 
 
-int Gps_L1_Ca_Dll_Pll_Tracking_cc::general_work (int noutput_items __attribute__((unused)), gr_vector_int &ninput_items __attribute__((unused)),
+int Gps_L1_Ca_Dll_Pll_Tracking_cc::general_work (int noutput_items __attribute__((unused)), gr_vector_int &ninput_items,
         gr_vector_const_void_star &input_items, gr_vector_void_star &output_items)
 {
+    Gnss_Sdr_Perf_Scope perf_scope(d_perf.get(), this, ninput_items[0]);
+    if (d_params.changed())
+        {
+            // only the coefficients change, the loop filter states are kept
+            double bw_hz;
+            if (d_params.get("pll_bw_hz", bw_hz)) d_carrier_loop_filter.set_PLL_BW(bw_hz);
+            if (d_params.get("dll_bw_hz", bw_hz)) d_code_loop_filter.set_DLL_BW(bw_hz);
+        }
+
     // process vars
     double carr_error_hz = 0.0;
     double carr_error_filt_hz = 0.0;
@@ -552,9 +562,17 @@ int Gps_L1_Ca_Dll_Pll_Tracking_cc::general_work (int noutput_items __attribute__
 
 
 
+void Gps_L1_Ca_Dll_Pll_Tracking_cc::set_role(const std::string& role)
+{
+    d_params.set_role(role);
+}
+
+
 void Gps_L1_Ca_Dll_Pll_Tracking_cc::set_channel(unsigned int channel)
 {
     d_channel = channel;
+    d_perf->set_channel(channel);
+    d_params.set_channel(channel);
     LOG(INFO) << "Tracking Channel set to " << d_channel;
     std::string d_dump_signal_filename = "input_signal_";
     std::string d_dump_signal_filename_wo = "carrier_wipeoff_";
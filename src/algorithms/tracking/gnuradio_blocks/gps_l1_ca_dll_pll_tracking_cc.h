@@ -39,9 +39,12 @@
 
 #include <fstream>
 #include <map>
+#include <memory>
 #include <string>
 #include <gnuradio/block.h>
 #include "gnss_synchro.h"
+#include "gnss_sdr_perf.h"
+#include "gnss_sdr_runtime_params.h"
 #include "tracking_2nd_DLL_filter.h"
 #include "tracking_2nd_PLL_filter.h"
 #include "cpu_multicorrelator.h"
@@ -72,10 +75,17 @@ public:
     ~Gps_L1_Ca_Dll_Pll_Tracking_cc();
 
     void set_channel(unsigned int channel);
+    void set_role(const std::string& role); //!< Configuration role, for the parameters changed at run time
     void set_gnss_synchro(Gnss_Synchro* p_gnss_synchro);
     void start_tracking();
     void stop_tracking();
 
+    //! Advances the sample counter over samples the block never received because its channel was parked
+    void skip_samples(unsigned long int samples)
+    {
+        d_sample_counter += samples;
+    }
+
     int general_work (int noutput_items, gr_vector_int &ninput_items,
             gr_vector_const_void_star &input_items, gr_vector_void_star &output_items);
 
@@ -107,6 +117,8 @@ private:
 
     Gnss_Synchro* d_acquisition_gnss_synchro;
     unsigned int d_channel;
+    std::shared_ptr<Gnss_Sdr_Block_Perf> d_perf;
+    Gnss_Sdr_Runtime_Params_Watch d_params; // <role>[channel].pll_bw_hz and dll_bw_hz changed at run time
 
     long d_if_freq;
     long d_fs_in;
@@ -66,6 +66,16 @@ public:
     virtual void set_local_code() = 0;
     virtual signed int mag() = 0;
     virtual void reset() = 0;
+
+    /*!
+     * \brief Accounts for samples that a parked channel never passed to the block,
+     * so that its sample stamps stay aligned with the other channels.
+     * Returns false if the implementation cannot do it; skip_samples(0) only asks.
+     */
+    virtual bool skip_samples(unsigned long int samples __attribute__((unused)))
+    {
+        return false;
+    }
 };
 
 #endif /* GNSS_SDR_ACQUISITION_INTERFACE */
@@ -62,6 +62,9 @@ public:
     virtual void set_state(unsigned int) = 0;
     virtual unsigned int get_state() = 0;
     virtual unsigned int get_uid() = 0;
+    virtual bool park() = 0;       //!< Stops feeding samples to the channel; false if it cannot be parked
+    virtual void activate() = 0;   //!< Feeds the channel again after park()
+    virtual bool parked() = 0;
 };
 
 #endif /* GNSS_SDR_CHANNEL_INTERFACE_H_ */
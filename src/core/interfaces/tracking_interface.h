@@ -61,6 +61,16 @@ public:
     virtual void stop_tracking() = 0;
     virtual void set_gnss_synchro(Gnss_Synchro* gnss_synchro) = 0;
     virtual void set_channel(unsigned int channel) = 0;
+
+    /*!
+     * \brief Accounts for samples that a parked channel never passed to the block,
+     * so that its sample stamps stay aligned with the other channels.
+     * Returns false if the implementation cannot do it; skip_samples(0) only asks.
+     */
+    virtual bool skip_samples(unsigned long int samples __attribute__((unused)))
+    {
+        return false;
+    }
 };
 
 #endif /* GNSS_SDR_TRACKING_INTERFACE_H_ */
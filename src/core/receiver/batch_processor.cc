@@ -0,0 +1,608 @@
+/*!
+ * \file batch_processor.cc
+ * \brief Implementation of the batch mode of gnss-sdr
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "batch_processor.h"
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <boost/filesystem.hpp>
+#include <boost/lexical_cast.hpp>
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include "configuration_interface.h"
+#include "control_thread.h"
+#include "file_configuration.h"
+#include "gnss_sdr_perf.h"
+#include "spoofing_stats.h"
+
+using google::LogMessage;
+
+DEFINE_string(batch_list, "", "File listing the captures to process as fast as possible, one \"<file> [seconds_to_skip] [samples]\" per line");
+DEFINE_int32(batch_jobs, 1, "Number of captures of --batch_list processed in parallel");
+DEFINE_string(batch_summary, "", "JSON file with the summary of --batch_list (standard output if empty)");
+DEFINE_string(batch_output_dir, ".", "Directory of the outputs of --batch_list, those of the capture of line n (from 0) going to batch_<n>");
+
+DECLARE_string(signal_source);
+DECLARE_string(log_dir);
+
+
+namespace
+{
+std::string json_string(const std::string& value)
+{
+    std::stringstream s;
+    s << "\"";
+    for (std::string::const_iterator c = value.begin(); c != value.end(); ++c)
+        {
+            switch (*c)
+            {
+            case '"': s << "\\\""; break;
+            case '\\': s << "\\\\"; break;
+            case '\n': s << "\\n"; break;
+            case '\t': s << "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(*c) < 0x20)
+                    {
+                        s << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(*c) << std::dec << std::setfill(' ');
+                    }
+                else
+                    {
+                        s << *c;
+                    }
+            }
+        }
+    s << "\"";
+    return s.str();
+}
+
+
+// Documents of the result file are kept on one line
+std::string single_line(const std::string& json)
+{
+    std::string line = json;
+    line.erase(std::remove(line.begin(), line.end(), '\n'), line.end());
+    return line;
+}
+
+
+// Output file of the receiver moved into the directory of a capture, with the same name
+void rebase_output(ConfigurationInterface* configuration, const std::string& key, const std::string& default_filename, const boost::filesystem::path& dir)
+{
+    std::string filename = configuration->property(key, default_filename);
+    if (filename.empty())
+        {
+            return;  // disabled, or not set for a block with no default
+        }
+    configuration->set_property(key, (dir / boost::filesystem::path(filename).filename()).string());
+}
+
+
+double ratio(double num, double den)
+{
+    return den > 0.0 ? num / den : 0.0;
+}
+
+
+void print_result(const BatchResult& result)
+{
+    std::stringstream s;
+    s << std::fixed << std::setprecision(2) << result.job.filename;
+    if (result.job.seconds_to_skip > 0.0) s << " from " << result.job.seconds_to_skip << " [s]";
+    if (result.status != 0)
+        {
+            s << ": failed (status " << result.status << ")";
+        }
+    else
+        {
+            s << ": " << result.signal_s << " [s] of signal in " << result.wall_s << " [s] ("
+              << result.rt_factor() << "x real time), " << result.fixes << " fixes, "
+              << result.alarms << " spoofing alarms";
+        }
+    std::cout << s.str() << std::endl;
+}
+}
+
+
+double BatchResult::rt_factor() const
+{
+    return ratio(signal_s, wall_s);
+}
+
+
+double BatchResult::rt_factor(const BatchStage& stage) const
+{
+    return ratio(signal_s, stage.busy_s);
+}
+
+
+BatchProcessor::BatchProcessor(const std::string& config_file, unsigned int max_parallel, const std::string& output_dir)
+{
+    config_file_ = config_file;
+    max_parallel_ = std::max(max_parallel, 1u);
+    output_dir_ = output_dir;
+}
+
+
+std::string BatchProcessor::job_output_dir(unsigned int index) const
+{
+    return (boost::filesystem::path(output_dir_) / ("batch_" + boost::lexical_cast<std::string>(index))).string();
+}
+
+
+void BatchProcessor::set_job_outputs(ConfigurationInterface* configuration, const std::string& output_dir)
+{
+    boost::filesystem::path dir(output_dir);
+    const std::string conditioning[] = { "SignalSource", "SignalConditioner", "DataTypeAdapter", "InputFilter", "Resampler" };
+    for (unsigned int i = 0; i < 5; i++)
+        {
+            rebase_output(configuration, conditioning[i] + ".dump_filename", "", dir);
+        }
+
+    // channel blocks: the role of each signal, and the roles of single channels (e.g. Tracking_1C3)
+    const std::string signals[] = { "1C", "2S", "1B", "5X" };
+    const std::string channel_blocks[][2] = { { "Acquisition_", "./data/acquisition.dat" },
+                                              { "Tracking_", "./track_ch" },
+                                              { "TelemetryDecoder_", "./navigation.dat" } };
+    unsigned int channels = 0;
+    for (unsigned int s = 0; s < 4; s++)
+        {
+            channels += configuration->property("Channels_" + signals[s] + ".count", 0);
+        }
+    for (unsigned int s = 0; s < 4; s++)
+        {
+            for (unsigned int b = 0; b < 3; b++)
+                {
+                    std::string role = channel_blocks[b][0] + signals[s];
+                    rebase_output(configuration, role + ".dump_filename", channel_blocks[b][1], dir);
+                    for (unsigned int channel = 0; channel < channels; channel++)
+                        {
+                            rebase_output(configuration, role + boost::lexical_cast<std::string>(channel) + ".dump_filename", "", dir);
+                        }
+                }
+        }
+
+    rebase_output(configuration, "Observables.dump_filename", "./observables.dat", dir);
+    rebase_output(configuration, "PVT.dump_filename", "./pvt.dat", dir);  // also the base of the KML, GeoJSON and RTCM files
+    rebase_output(configuration, "PVT.nmea_dump_filename", "./nmea_pvt.nmea", dir);
+    rebase_output(configuration, "Spoofing.capture_filename", "", dir);
+    rebase_output(configuration, "Spoofing.stats_filename", "", dir);
+    configuration->set_property("Spoofing.stats_socket", "");
+    configuration->set_property("Spoofing.stats_http_port", "0");
+
+    // the spoofing event log and report of the PVT are written to the log directory
+    FLAGS_log_dir = output_dir;
+    if (FLAGS_log_dir.empty() || FLAGS_log_dir.at(FLAGS_log_dir.size() - 1) != '/')
+        {
+            FLAGS_log_dir += "/";
+        }
+}
+
+
+bool BatchProcessor::parse_list(std::istream& list, std::vector<BatchJob>& jobs, std::string& error)
+{
+    std::string line;
+    while (std::getline(list, line))
+        {
+            std::istringstream fields(line);
+            BatchJob job;
+            job.seconds_to_skip = 0.0;
+            job.samples = 0;
+            if (!(fields >> job.filename) || job.filename.at(0) == '#')
+                {
+                    continue;
+                }
+            std::string skip;
+            std::string samples;
+            std::string extra;
+            fields >> skip >> samples >> extra;
+            try
+            {
+                    if (!skip.empty()) job.seconds_to_skip = boost::lexical_cast<double>(skip);
+                    if (!samples.empty() && samples.at(0) == '-') throw boost::bad_lexical_cast();
+                    if (!samples.empty()) job.samples = boost::lexical_cast<unsigned long long>(samples);
+            }
+            catch (const boost::bad_lexical_cast&)
+            {
+                    error = line;
+                    return false;
+            }
+            if (!extra.empty() || job.seconds_to_skip < 0.0)
+                {
+                    error = line;
+                    return false;
+                }
+            jobs.push_back(job);
+        }
+    return true;
+}
+
+
+void BatchProcessor::write_result(const BatchResult& result, std::ostream& out)
+{
+    out << std::setprecision(12);
+    out << "filename " << result.job.filename << std::endl;
+    out << "seconds_to_skip " << result.job.seconds_to_skip << std::endl;
+    out << "samples " << result.job.samples << std::endl;
+    out << "output_dir " << result.output_dir << std::endl;
+    out << "status " << result.status << std::endl;
+    out << "wall_s " << result.wall_s << std::endl;
+    out << "signal_s " << result.signal_s << std::endl;
+    out << "fixes " << result.fixes << std::endl;
+    out << "alarms " << result.alarms << std::endl;
+    for (std::vector<BatchStage>::const_iterator it = result.stages.begin(); it != result.stages.end(); ++it)
+        {
+            out << "stage " << it->name << " " << it->blocks << " " << it->busy_s << std::endl;
+        }
+    if (!result.perf_json.empty()) out << "perf " << single_line(result.perf_json) << std::endl;
+    if (!result.spoofing_json.empty()) out << "spoofing " << single_line(result.spoofing_json) << std::endl;
+}
+
+
+bool BatchProcessor::read_result(std::istream& in, BatchResult& result)
+{
+    std::string line;
+    bool complete = false;
+    result.stages.clear();
+    while (std::getline(in, line))
+        {
+            std::istringstream fields(line);
+            std::string key;
+            fields >> key;
+            if (key.empty()) continue;
+            if (key == "filename") fields >> result.job.filename;
+            else if (key == "seconds_to_skip") fields >> result.job.seconds_to_skip;
+            else if (key == "samples") fields >> result.job.samples;
+            else if (key == "output_dir" && line.size() > key.size()) result.output_dir = line.substr(key.size() + 1);
+            else if (key == "status") fields >> result.status;
+            else if (key == "wall_s") fields >> result.wall_s;
+            else if (key == "signal_s") fields >> result.signal_s;
+            else if (key == "fixes") fields >> result.fixes;
+            else if (key == "alarms") { fields >> result.alarms; complete = !fields.fail(); }
+            else if (key == "stage")
+                {
+                    BatchStage stage;
+                    fields >> stage.name >> stage.blocks >> stage.busy_s;
+                    if (fields.fail()) return false;
+                    result.stages.push_back(stage);
+                }
+            else if (key == "perf" && line.size() > key.size()) result.perf_json = line.substr(key.size() + 1);
+            else if (key == "spoofing" && line.size() > key.size()) result.spoofing_json = line.substr(key.size() + 1);
+            if (fields.fail()) return false;
+        }
+    return complete;
+}
+
+
+std::string BatchProcessor::result_json(const BatchResult& result)
+{
+    std::stringstream s;
+    s << "{\"file\":" << json_string(result.job.filename)
+      << ",\"seconds_to_skip\":" << result.job.seconds_to_skip
+      << ",\"samples\":" << result.job.samples
+      << ",\"output_dir\":" << json_string(result.output_dir)
+      << ",\"status\":" << (result.status == 0 ? "\"ok\"" : "\"failed\"")
+      << ",\"exit_status\":" << result.status
+      << ",\"wall_s\":" << result.wall_s
+      << ",\"signal_s\":" << result.signal_s
+      << ",\"rt_factor\":" << result.rt_factor()
+      << ",\"fixes\":" << result.fixes
+      << ",\"spoofing_alarms\":" << result.alarms
+      << ",\"stages\":[";
+    for (std::vector<BatchStage>::const_iterator it = result.stages.begin(); it != result.stages.end(); ++it)
+        {
+            s << (it == result.stages.begin() ? "" : ",")
+              << "{\"name\":" << json_string(it->name)
+              << ",\"blocks\":" << it->blocks
+              << ",\"busy_s\":" << it->busy_s
+              << ",\"rt_factor\":" << result.rt_factor(*it) << "}";
+        }
+    s << "],\"perf\":" << (result.perf_json.empty() ? "null" : single_line(result.perf_json))
+      << ",\"spoofing\":" << (result.spoofing_json.empty() ? "null" : single_line(result.spoofing_json)) << "}";
+    return s.str();
+}
+
+
+std::string BatchProcessor::summary_json(const std::vector<BatchResult>& results, double wall_s) const
+{
+    unsigned int failed = 0;
+    double signal_s = 0.0;
+    unsigned long long fixes = 0;
+    unsigned long long alarms = 0;
+    // per stage: signal time of the captures it processed, and its work time over them
+    std::map<std::string, std::pair<double, double>> stages;
+    for (std::vector<BatchResult>::const_iterator it = results.begin(); it != results.end(); ++it)
+        {
+            if (it->status != 0) failed++;
+            signal_s += it->signal_s;
+            fixes += it->fixes;
+            alarms += it->alarms;
+            for (std::vector<BatchStage>::const_iterator st = it->stages.begin(); st != it->stages.end(); ++st)
+                {
+                    stages[st->name].first += it->signal_s;
+                    stages[st->name].second += st->busy_s;
+                }
+        }
+
+    std::stringstream s;
+    s << "{\"config_file\":" << json_string(config_file_)
+      << ",\"parallel\":" << max_parallel_
+      << ",\"captures\":" << results.size()
+      << ",\"failed\":" << failed
+      << ",\"wall_s\":" << wall_s
+      << ",\"signal_s\":" << signal_s
+      << ",\"rt_factor\":" << ratio(signal_s, wall_s)
+      << ",\"fixes\":" << fixes
+      << ",\"spoofing_alarms\":" << alarms
+      << ",\"stages\":[";
+    for (std::map<std::string, std::pair<double, double>>::const_iterator it = stages.begin(); it != stages.end(); ++it)
+        {
+            s << (it == stages.begin() ? "" : ",")
+              << "{\"name\":" << json_string(it->first)
+              << ",\"busy_s\":" << it->second.second
+              << ",\"rt_factor\":" << ratio(it->second.first, it->second.second) << "}";
+        }
+    s << "],\"files\":[";
+    for (std::vector<BatchResult>::const_iterator it = results.begin(); it != results.end(); ++it)
+        {
+            s << (it == results.begin() ? "" : ",") << result_json(*it);
+        }
+    s << "]}\n";
+    return s.str();
+}
+
+
+int BatchProcessor::run(const std::string& list_filename, const std::string& summary_filename)
+{
+    std::ifstream list(list_filename.c_str());
+    std::vector<BatchJob> jobs;
+    std::string error;
+    if (!list.is_open())
+        {
+            std::cerr << "Unable to open the batch list " << list_filename << std::endl;
+            LOG(ERROR) << "Unable to open the batch list " << list_filename;
+            return 1;
+        }
+    if (!parse_list(list, jobs, error))
+        {
+            std::cerr << "Malformed line in the batch list " << list_filename << ": " << error << std::endl;
+            LOG(ERROR) << "Malformed line in the batch list " << list_filename << ": " << error;
+            return 1;
+        }
+    if (jobs.empty())
+        {
+            std::cerr << "The batch list " << list_filename << " names no capture" << std::endl;
+            return 1;
+        }
+    if (summary_filename.empty())
+        {
+            return run(jobs, std::cout);
+        }
+    std::ofstream summary(summary_filename.c_str(), std::ios::out | std::ios::trunc);
+    if (!summary.is_open())
+        {
+            std::cerr << "Unable to write the batch summary " << summary_filename << std::endl;
+            LOG(ERROR) << "Unable to write the batch summary " << summary_filename;
+            return 1;
+        }
+    int status = run(jobs, summary);
+    std::cout << "Batch summary written to " << summary_filename << std::endl;
+    return status;
+}
+
+
+int BatchProcessor::run(const std::vector<BatchJob>& jobs, std::ostream& summary)
+{
+    boost::filesystem::path results_dir = boost::filesystem::temp_directory_path()
+            / boost::filesystem::unique_path("gnss-sdr-batch-%%%%-%%%%");
+    boost::filesystem::create_directories(results_dir);
+
+    std::vector<BatchResult> results(jobs.size());
+    std::map<pid_t, unsigned int> running;
+    unsigned int next = 0;
+    unsigned int failed = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::cout << "Processing " << jobs.size() << " captures, " << max_parallel_ << " at a time" << std::endl;
+
+    while (next < jobs.size() || !running.empty())
+        {
+            while (next < jobs.size() && running.size() < max_parallel_)
+                {
+                    results.at(next).job = jobs.at(next);
+                    results.at(next).output_dir = job_output_dir(next);
+                    results.at(next).status = -1;
+                    std::string result_filename = (results_dir / boost::lexical_cast<std::string>(next)).string();
+                    boost::system::error_code dir_error;
+                    boost::filesystem::create_directories(results.at(next).output_dir, dir_error);
+                    if (dir_error)
+                        {
+                            LOG(ERROR) << "Unable to create the output directory " << results.at(next).output_dir
+                                       << " of " << jobs.at(next).filename << ": " << dir_error.message();
+                            failed++;
+                            print_result(results.at(next));
+                            next++;
+                            continue;
+                        }
+                    std::cout.flush();
+                    pid_t pid = fork();
+                    if (pid == 0)
+                        {
+                            BatchResult result = process(jobs.at(next), results.at(next).output_dir);
+                            {
+                                std::ofstream out(result_filename.c_str());
+                                write_result(result, out);
+                            }
+                            std::cout.flush();
+                            google::FlushLogFiles(google::INFO);
+                            _exit(result.status);
+                        }
+                    if (pid < 0)
+                        {
+                            LOG(ERROR) << "Unable to start the process of " << jobs.at(next).filename;
+                            failed++;
+                            print_result(results.at(next));
+                        }
+                    else
+                        {
+                            running[pid] = next;
+                        }
+                    next++;
+                }
+            if (running.empty())
+                {
+                    continue;
+                }
+
+            int wait_status = 0;
+            pid_t pid = waitpid(-1, &wait_status, 0);
+            std::map<pid_t, unsigned int>::iterator child = running.find(pid);
+            if (child == running.end())
+                {
+                    continue;
+                }
+            unsigned int index = child->second;
+            running.erase(child);
+
+            BatchResult& result = results.at(index);
+            std::string result_filename = (results_dir / boost::lexical_cast<std::string>(index)).string();
+            std::ifstream in(result_filename.c_str());
+            bool complete = in.is_open() && read_result(in, result);
+            if (WIFEXITED(wait_status))
+                {
+                    result.status = WEXITSTATUS(wait_status);
+                }
+            else if (WIFSIGNALED(wait_status))
+                {
+                    result.status = 128 + WTERMSIG(wait_status);
+                }
+            if (!complete && result.status == 0)
+                {
+                    result.status = 1;  // exited without reporting
+                }
+            result.job = jobs.at(index);
+            result.output_dir = job_output_dir(index);
+            if (result.status != 0) failed++;
+            print_result(result);
+        }
+
+    double wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Batch of " << results.size() << " captures processed in " << wall_s << " [s], "
+              << failed << " failed" << std::endl;
+
+    boost::system::error_code ec;
+    boost::filesystem::remove_all(results_dir, ec);
+    summary << summary_json(results, wall_s);
+    return failed == 0 ? 0 : 1;
+}
+
+
+BatchResult BatchProcessor::process(const BatchJob& job, const std::string& output_dir)
+{
+    BatchResult result;
+    result.job = job;
+    result.output_dir = output_dir;
+    result.status = 1;
+    result.wall_s = 0.0;
+    result.signal_s = 0.0;
+    result.fixes = 0;
+    result.alarms = 0;
+
+    std::shared_ptr<FileConfiguration> configuration = std::make_shared<FileConfiguration>(config_file_);
+    FLAGS_signal_source = "-";  // the list names the captures
+    configuration->set_property("SignalSource.filename", job.filename);
+    configuration->set_property("SignalSource.repeat", "false");
+    configuration->set_property("SignalSource.enable_throttle_control", "false");
+    configuration->set_property("SignalSource.seconds_to_skip", boost::lexical_cast<std::string>(job.seconds_to_skip));
+    if (job.samples > 0)
+        {
+            configuration->set_property("SignalSource.samples", boost::lexical_cast<std::string>(job.samples));
+        }
+    configuration->set_property("Perf.enable", "true");
+    // unattended, and several captures at a time: no listeners, and outputs kept apart
+    configuration->set_property("Perf.filename", "");
+    configuration->set_property("Perf.socket", "");
+    configuration->set_property("Reconfigure.filename", "");
+    configuration->set_property("Reconfigure.socket", "");
+    configuration->set_property("PVT.flag_rtcm_server", "false");
+    set_job_outputs(configuration.get(), output_dir);
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    try
+    {
+            std::unique_ptr<ControlThread> control_thread(new ControlThread(configuration));
+            control_thread->run();
+            result.status = 0;
+    }
+    catch (const std::exception& ex)
+    {
+            LOG(ERROR) << "Processing of " << job.filename << " failed: " << ex.what();
+    }
+    catch (...)
+    {
+            LOG(ERROR) << "Processing of " << job.filename << " failed";
+    }
+    result.wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::map<std::string, unsigned int> stage_index;
+    std::vector<std::shared_ptr<Gnss_Sdr_Block_Perf>> blocks = Gnss_Sdr_Perf::instance().blocks();
+    for (std::vector<std::shared_ptr<Gnss_Sdr_Block_Perf>>::const_iterator it = blocks.begin(); it != blocks.end(); ++it)
+        {
+            const Gnss_Sdr_Block_Perf& block = **it;
+            if (block.get_calls() == 0) continue;
+            result.signal_s = std::max(result.signal_s, block.stream_s());
+            if (block.get_name() == "pvt") result.fixes += block.get_produced();
+            if (stage_index.find(block.get_name()) == stage_index.end())
+                {
+                    stage_index[block.get_name()] = result.stages.size();
+                    BatchStage stage;
+                    stage.name = block.get_name();
+                    stage.blocks = 0;
+                    stage.busy_s = 0.0;
+                    result.stages.push_back(stage);
+                }
+            BatchStage& stage = result.stages.at(stage_index[block.get_name()]);
+            stage.blocks++;
+            stage.busy_s += static_cast<double>(block.get_busy_ns()) * 1e-9;
+        }
+    for (int check = 0; check < SPOOFING_CHECKS; check++)
+        {
+            result.alarms += Spoofing_Stats::instance().get_alarms(static_cast<Spoofing_Check>(check));
+        }
+    result.perf_json = Gnss_Sdr_Perf::instance().to_json();
+    result.spoofing_json = Spoofing_Stats::instance().to_json();
+    return result;
+}
@@ -0,0 +1,159 @@
+/*!
+ * \file batch_processor.h
+ * \brief Processes a list of capture files faster than real time and reports
+ * the throughput, the fixes and the spoofing alarms of each one.
+ *
+ * gnss-sdr --batch_list=<file> runs the receiver of --config_file over every
+ * capture (or segment of a capture) of the list, in up to --batch_jobs
+ * processes at a time, with no throttle and no repetition. Each capture is
+ * processed in its own child process, so that the process-wide queues and maps
+ * of the receiver start empty for every file, and writes its dumps, logs and
+ * spoofing reports to a directory of its own under --batch_output_dir. The
+ * summary is written as JSON to --batch_summary (standard output if empty),
+ * and gnss-sdr exits with a non-zero status if any capture failed.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_BATCH_PROCESSOR_H_
+#define GNSS_SDR_BATCH_PROCESSOR_H_
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class ConfigurationInterface;
+
+/*!
+ * \brief One line of the batch list: a capture, or a segment of it
+ */
+struct BatchJob
+{
+    std::string filename;
+    double seconds_to_skip;       //!< SignalSource.seconds_to_skip
+    unsigned long long samples;   //!< SignalSource.samples, 0 to process up to the end of the file
+};
+
+
+/*!
+ * \brief Work of the blocks of one kind (e.g. all the tracking channels) over a capture
+ */
+struct BatchStage
+{
+    std::string name;
+    unsigned int blocks;   //!< Instances, e.g. one per channel
+    double busy_s;         //!< Time spent in their work calls
+};
+
+
+/*!
+ * \brief Outcome of one capture.
+ *
+ * The real-time factor of the capture is the signal time over the wall-clock
+ * time of the run, and that of a stage the signal time over the time spent in
+ * its work calls: above 1 they are faster than real time.
+ */
+struct BatchResult
+{
+    BatchJob job;
+    std::string output_dir;  //!< Directory of the dumps, logs and spoofing reports of the capture
+    int status;              //!< Exit status of the child process, 0 on success
+    double wall_s;
+    double signal_s;         //!< Stream time of the most advanced block
+    unsigned long long fixes;
+    unsigned long long alarms;
+    std::vector<BatchStage> stages;
+    std::string perf_json;       //!< Gnss_Sdr_Perf::to_json() at the end of the run
+    std::string spoofing_json;   //!< Spoofing_Stats::to_json() at the end of the run
+
+    double rt_factor() const;
+    double rt_factor(const BatchStage& stage) const;
+};
+
+
+/*!
+ * \brief Runs the receiver over a list of captures in child processes
+ */
+class BatchProcessor
+{
+public:
+    /*!
+     * \brief Processes \a max_parallel captures at a time (at least one)
+     * with the configuration of \a config_file, writing the outputs of each
+     * one to a directory of its own under \a output_dir
+     */
+    BatchProcessor(const std::string& config_file, unsigned int max_parallel, const std::string& output_dir = ".");
+    virtual ~BatchProcessor() {}
+
+    /*!
+     * \brief Runs the captures of \a list_filename and writes the summary.
+     * Returns the exit status of gnss-sdr: 0 if every capture succeeded.
+     */
+    int run(const std::string& list_filename, const std::string& summary_filename);
+
+    int run(const std::vector<BatchJob>& jobs, std::ostream& summary);
+
+    /*!
+     * \brief Reads one job per line, "<file> [seconds_to_skip] [samples]".
+     * Blank lines and lines starting with # are skipped. Returns false and
+     * the offending line in \a error on a malformed line.
+     */
+    static bool parse_list(std::istream& list, std::vector<BatchJob>& jobs, std::string& error);
+
+    /*!
+     * \brief Result file exchanged between a child and the parent: one
+     * "key value" line per field, the JSON documents on a single line each
+     */
+    static void write_result(const BatchResult& result, std::ostream& out);
+    static bool read_result(std::istream& in, BatchResult& result);
+
+    /*!
+     * \brief Directory of the outputs of the capture \a index of the list
+     */
+    std::string job_output_dir(unsigned int index) const;
+
+    /*!
+     * \brief Moves every output file of the receiver (PVT, NMEA, observables,
+     * acquisition, tracking and telemetry dumps, spoofing capture and
+     * statistics) and the log directory of the process (--log_dir, where the
+     * spoofing event log and report go) into \a output_dir, keeping their
+     * names, and disables the spoofing statistics listeners
+     */
+    static void set_job_outputs(ConfigurationInterface* configuration, const std::string& output_dir);
+
+    static std::string result_json(const BatchResult& result);
+    std::string summary_json(const std::vector<BatchResult>& results, double wall_s) const;
+
+protected:
+    virtual BatchResult process(const BatchJob& job, const std::string& output_dir);  // runs in the child
+
+private:
+    std::string config_file_;
+    unsigned int max_parallel_;
+    std::string output_dir_;
+};
+
+#endif /*GNSS_SDR_BATCH_PROCESSOR_H_*/
@@ -0,0 +1,262 @@
+/*!
+ * \file block_layout.cc
+ * \brief Placement of the receiver GNU Radio blocks on CPU cores, with
+ * thread priorities and output buffer limits.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "block_layout.h"
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <boost/tokenizer.hpp>
+#include <gnuradio/block.h>
+#include <gnuradio/realtime.h>
+#include <glog/logging.h>
+#include "configuration_interface.h"
+#include "gnss_block_interface.h"
+
+using google::LogMessage;
+
+
+BlockLayout::BlockLayout(std::shared_ptr<ConfigurationInterface> configuration)
+{
+    realtime_ = configuration->property("Layout.realtime", false);
+    enabled_ = realtime_;
+
+    const std::string names[] = { "source", "acquisition", "tracking", "pvt" };
+    for (unsigned int i = 0; i < 4; i++)
+        {
+            std::string prefix = "Layout." + names[i];
+            Group group;
+            group.cpus = parse_cpu_list(configuration->property(prefix + ".cpus", std::string("")));
+            int node = configuration->property(prefix + ".numa_node", -1);
+            if (group.cpus.empty() && node >= 0)
+                {
+                    group.cpus = numa_node_cpus(node);
+                    if (group.cpus.empty())
+                        {
+                            LOG(WARNING) << prefix << ".numa_node=" << node << " not found, layout of the group not changed";
+                        }
+                }
+            group.priority = configuration->property(prefix + ".priority", -1);
+            group.max_output_buffer = configuration->property(prefix + ".max_output_buffer", 0L);
+            group.channels_per_cpu = configuration->property(prefix + ".channels_per_cpu", 0U);
+            if (!group.cpus.empty() || group.priority >= 0 || group.max_output_buffer > 0)
+                {
+                    enabled_ = true;
+                }
+            groups_[names[i]] = group;
+        }
+}
+
+
+BlockLayout::~BlockLayout()
+{}
+
+
+bool BlockLayout::enabled() const
+{
+    return enabled_;
+}
+
+
+bool BlockLayout::realtime() const
+{
+    return realtime_;
+}
+
+
+bool BlockLayout::enable_realtime()
+{
+    if (!realtime_)
+        {
+            return false;
+        }
+    gr::rt_status_t status = gr::enable_realtime_scheduling();
+    if (status != gr::RT_OK)
+        {
+            LOG(WARNING) << "Layout.realtime: failed to enable real-time scheduling (status " << status << ")";
+            return false;
+        }
+    LOG(INFO) << "Real-time scheduling enabled";
+    return true;
+}
+
+
+std::vector<int> BlockLayout::cpus(const std::string& group, unsigned int channel) const
+{
+    std::map<std::string, Group>::const_iterator it = groups_.find(group);
+    if (it == groups_.end() || it->second.cpus.empty())
+        {
+            return std::vector<int>();
+        }
+    if (it->second.channels_per_cpu == 0)
+        {
+            return it->second.cpus;
+        }
+    // channels in blocks of channels_per_cpu, one core per block, wrapping around
+    unsigned int index = (channel / it->second.channels_per_cpu) % it->second.cpus.size();
+    return std::vector<int>(1, it->second.cpus.at(index));
+}
+
+
+int BlockLayout::priority(const std::string& group) const
+{
+    std::map<std::string, Group>::const_iterator it = groups_.find(group);
+    if (it == groups_.end())
+        {
+            return -1;
+        }
+    return it->second.priority;
+}
+
+
+long BlockLayout::max_output_buffer(const std::string& group) const
+{
+    std::map<std::string, Group>::const_iterator it = groups_.find(group);
+    if (it == groups_.end())
+        {
+            return 0;
+        }
+    return it->second.max_output_buffer;
+}
+
+
+void BlockLayout::apply(const std::string& group, gr::basic_block_sptr block, const std::string& name, unsigned int channel)
+{
+    gr::block_sptr gr_block = boost::dynamic_pointer_cast<gr::block>(block);
+    if (!gr_block || placed_.count(gr_block.get()) > 0)
+        {
+            return;
+        }
+    placed_.insert(gr_block.get());
+
+    std::vector<int> group_cpus = cpus(group, channel);
+    int group_priority = priority(group);
+    long group_buffer = max_output_buffer(group);
+    if (!group_cpus.empty())
+        {
+            gr_block->set_processor_affinity(group_cpus);
+        }
+    if (group_buffer > 0)
+        {
+            gr_block->set_max_output_buffer(group_buffer);
+        }
+#if MODERN_GNURADIO
+    if (group_priority >= 0)
+        {
+            gr_block->set_thread_priority(group_priority);
+        }
+#endif
+
+    std::stringstream line;
+    line << group << ": " << name << " [" << gr_block->name() << "] cpus "
+         << (group_cpus.empty() ? std::string("any") : cpu_list_str(group_cpus));
+    if (group_priority >= 0) line << ", priority " << group_priority;
+    if (group_buffer > 0) line << ", max output buffer " << group_buffer;
+    applied_.push_back(line.str());
+}
+
+
+void BlockLayout::apply(const std::string& group, std::shared_ptr<GNSSBlockInterface> block, const std::string& name, unsigned int channel)
+{
+    if (!block)
+        {
+            return;
+        }
+    apply(group, block->get_left_block(), name, channel);
+    apply(group, block->get_right_block(), name, channel);
+}
+
+
+const std::vector<std::string>& BlockLayout::applied() const
+{
+    return applied_;
+}
+
+
+std::vector<int> BlockLayout::parse_cpu_list(const std::string& list)
+{
+    std::vector<int> cpus;
+    boost::char_separator<char> sep(", \t\n");
+    boost::tokenizer<boost::char_separator<char>> tokens(list, sep);
+    for (boost::tokenizer<boost::char_separator<char>>::iterator it = tokens.begin(); it != tokens.end(); ++it)
+        {
+            const char* str = it->c_str();
+            char* end = 0;
+            long first = std::strtol(str, &end, 10);
+            if (end == str || first < 0)
+                {
+                    continue;
+                }
+            long last = first;
+            if (*end == '-')
+                {
+                    const char* second = end + 1;
+                    last = std::strtol(second, &end, 10);
+                    if (end == second || last < first)
+                        {
+                            continue;
+                        }
+                }
+            if (*end != '\0')
+                {
+                    continue;
+                }
+            for (long cpu = first; cpu <= last; cpu++)
+                {
+                    cpus.push_back(static_cast<int>(cpu));
+                }
+        }
+    return cpus;
+}
+
+
+std::vector<int> BlockLayout::numa_node_cpus(int node)
+{
+    std::stringstream path;
+    path << "/sys/devices/system/node/node" << node << "/cpulist";
+    std::ifstream file(path.str().c_str());
+    std::string list;
+    if (!file.is_open() || !std::getline(file, list))
+        {
+            return std::vector<int>();
+        }
+    return parse_cpu_list(list);
+}
+
+
+std::string BlockLayout::cpu_list_str(const std::vector<int>& cpus)
+{
+    std::stringstream ss;
+    for (unsigned int i = 0; i < cpus.size(); i++)
+        {
+            if (i > 0) ss << ",";
+            ss << cpus.at(i);
+        }
+    return ss.str();
+}
@@ -0,0 +1,116 @@
+/*!
+ * \file block_layout.h
+ * \brief Placement of the receiver GNU Radio blocks on CPU cores, with
+ * thread priorities and output buffer limits, read from the Layout.*
+ * section of the configuration.
+ *
+ * Blocks are grouped as source (signal sources and conditioners),
+ * acquisition, tracking (channel input and tracking loops) and pvt
+ * (telemetry decoders with the spoofing detector, observables and PVT).
+ * For each group:
+ *
+ * Layout.<group>.cpus=0-3,8          cores the group may run on
+ * Layout.<group>.numa_node=1         all cores of a NUMA node, if cpus is not given
+ * Layout.<group>.channels_per_cpu=4  acquisition and tracking only: pins channels
+ *                                    to single cores, N channels per core
+ * Layout.<group>.priority=80         thread priority (needs Layout.realtime=true)
+ * Layout.<group>.max_output_buffer=16384  items per output buffer
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_BLOCK_LAYOUT_H_
+#define GNSS_SDR_BLOCK_LAYOUT_H_
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+#include <gnuradio/basic_block.h>
+
+class ConfigurationInterface;
+class GNSSBlockInterface;
+
+/*!
+ * \brief Reads the block layout from the configuration and applies it to the
+ * blocks of the flowgraph before it starts.
+ *
+ * Only gr::block instances can be placed: for hierarchical adapters the
+ * left and right blocks are placed, inner blocks keep the default layout.
+ */
+class BlockLayout
+{
+public:
+    BlockLayout(std::shared_ptr<ConfigurationInterface> configuration);
+    virtual ~BlockLayout();
+
+    bool enabled() const;  //!< True if any Layout.* option is set
+    bool realtime() const; //!< Layout.realtime
+
+    /*!
+     * \brief Switches the process to real-time scheduling. Must be called
+     * before the flowgraph threads are created.
+     */
+    bool enable_realtime();
+
+    //! Cores for a block of the group; for acquisition and tracking, of the given channel
+    std::vector<int> cpus(const std::string& group, unsigned int channel = 0) const;
+    int priority(const std::string& group) const;          //!< -1 if not set
+    long max_output_buffer(const std::string& group) const; //!< 0 if not set
+
+    //! Places a block of the group
+    void apply(const std::string& group, gr::basic_block_sptr block, const std::string& name, unsigned int channel = 0);
+
+    //! Places the left and right blocks of an adapter
+    void apply(const std::string& group, std::shared_ptr<GNSSBlockInterface> block, const std::string& name, unsigned int channel = 0);
+
+    const std::vector<std::string>& applied() const; //!< One line per placed block
+
+    //! Parses "0-3,8,10-11"; invalid entries are skipped
+    static std::vector<int> parse_cpu_list(const std::string& list);
+
+    //! Cores of a NUMA node as listed by the kernel, empty if unknown
+    static std::vector<int> numa_node_cpus(int node);
+
+    static std::string cpu_list_str(const std::vector<int>& cpus);
+
+private:
+    struct Group
+    {
+        std::vector<int> cpus;
+        int priority;
+        long max_output_buffer;
+        unsigned int channels_per_cpu;
+    };
+
+    std::map<std::string, Group> groups_;
+    std::set<gr::basic_block*> placed_;
+    std::vector<std::string> applied_;
+    bool realtime_;
+    bool enabled_;
+};
+
+#endif /*GNSS_SDR_BLOCK_LAYOUT_H_*/
@@ -0,0 +1,335 @@
+/*!
+ * \file channel_scheduler.cc
+ * \brief Assignment of pending GNSS signals and APT peaks to receiver channels.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "channel_scheduler.h"
+#include <algorithm>
+#include <sstream>
+
+
+ChannelScheduler::ChannelScheduler()
+{
+    pending_total_ = 0;
+    acquiring_channels_ = 0;
+    peaks_per_satellite_ = 0;
+    max_peak_ = 5;
+}
+
+
+ChannelScheduler::~ChannelScheduler()
+{}
+
+
+std::string ChannelScheduler::key(const Gnss_Signal& signal)
+{
+    std::stringstream ss;
+    ss << signal.get_satellite().get_system() << "/" << signal.get_signal_str() << "/" << signal.get_satellite().get_PRN();
+    return ss.str();
+}
+
+
+void ChannelScheduler::set_channels(const std::vector<std::string>& signal_types, unsigned int max_acq_channels)
+{
+    channel_signal_ = signal_types;
+    states_.assign(signal_types.size(), 0);
+    standby_.clear();
+    acquiring_channels_ = 0;
+    for (unsigned int i = 0; i < signal_types.size(); i++)
+        {
+            if (i < max_acq_channels)
+                {
+                    states_[i] = 1;
+                    acquiring_channels_++;
+                }
+            else
+                {
+                    standby_[signal_types.at(i)].insert(i);
+                }
+        }
+}
+
+
+unsigned int ChannelScheduler::get_state(unsigned int channel) const
+{
+    return states_.at(channel);
+}
+
+
+void ChannelScheduler::set_state(unsigned int channel, unsigned int state)
+{
+    unsigned int old_state = states_.at(channel);
+    if (old_state == state)
+        {
+            return;
+        }
+    if (old_state == 0)
+        {
+            standby_[channel_signal_.at(channel)].erase(channel);
+        }
+    if (old_state == 1)
+        {
+            acquiring_channels_--;
+        }
+    if (state == 0)
+        {
+            standby_[channel_signal_.at(channel)].insert(channel);
+        }
+    if (state == 1)
+        {
+            acquiring_channels_++;
+        }
+    states_.at(channel) = state;
+}
+
+
+unsigned int ChannelScheduler::acquiring_channels() const
+{
+    return acquiring_channels_;
+}
+
+
+bool ChannelScheduler::take_standby(unsigned int& channel)
+{
+    bool found = false;
+    for (std::map<std::string, std::set<unsigned int>>::const_iterator it = standby_.begin(); it != standby_.end(); ++it)
+        {
+            if (it->second.empty())
+                {
+                    continue;
+                }
+            std::map<std::string, std::deque<Gnss_Signal>>::const_iterator pool = pools_.find(it->first);
+            if (pool == pools_.end() || pool->second.empty())
+                {
+                    continue;
+                }
+            if (!found || *it->second.begin() < channel)
+                {
+                    channel = *it->second.begin();
+                    found = true;
+                }
+        }
+    if (found)
+        {
+            set_state(channel, 1);
+        }
+    return found;
+}
+
+
+void ChannelScheduler::push_back(const Gnss_Signal& signal)
+{
+    pools_[signal.get_signal_str()].push_back(signal);
+    pending_count_[key(signal)]++;
+    pending_total_++;
+}
+
+
+void ChannelScheduler::remove(const Gnss_Signal& signal)
+{
+    std::map<std::string, std::deque<Gnss_Signal>>::iterator pool = pools_.find(signal.get_signal_str());
+    if (pool == pools_.end())
+        {
+            return;
+        }
+    std::deque<Gnss_Signal>::iterator end = std::remove(pool->second.begin(), pool->second.end(), signal);
+    pending_total_ -= std::distance(end, pool->second.end());
+    pool->second.erase(end, pool->second.end());
+    pending_count_.erase(key(signal));
+}
+
+
+void ChannelScheduler::preassign(unsigned int channel, const Gnss_Signal& signal)
+{
+    remove(signal);
+    preassigned_[channel] = signal;
+}
+
+
+bool ChannelScheduler::next(unsigned int channel, const std::string& signal_type, Gnss_Signal& signal)
+{
+    std::map<unsigned int, Gnss_Signal>::iterator pre = preassigned_.find(channel);
+    if (pre != preassigned_.end())
+        {
+            signal = pre->second;
+            preassigned_.erase(pre);
+            return true;
+        }
+    std::map<std::string, std::deque<Gnss_Signal>>::iterator pool = pools_.find(signal_type);
+    if (pool == pools_.end() || pool->second.empty())
+        {
+            return false;
+        }
+    signal = pool->second.front();
+    pool->second.pop_front();
+    pending_total_--;
+    std::map<std::string, unsigned int>::iterator count = pending_count_.find(key(signal));
+    if (count != pending_count_.end() && --(count->second) == 0)
+        {
+            pending_count_.erase(count);
+        }
+    return true;
+}
+
+
+unsigned int ChannelScheduler::pending(const Gnss_Signal& signal) const
+{
+    std::map<std::string, unsigned int>::const_iterator count = pending_count_.find(key(signal));
+    if (count == pending_count_.end())
+        {
+            return 0;
+        }
+    return count->second;
+}
+
+
+unsigned int ChannelScheduler::pending() const
+{
+    return pending_total_;
+}
+
+
+bool ChannelScheduler::empty() const
+{
+    return pending_total_ == 0;
+}
+
+
+void ChannelScheduler::set_peaks(int peaks_per_satellite, int max_peak)
+{
+    peaks_per_satellite_ = peaks_per_satellite;
+    max_peak_ = max_peak;
+}
+
+
+void ChannelScheduler::add_satellite(int PRN)
+{
+    Peak_State state;
+    state.acquiring = 0;
+    state.next_peak = 1;
+    peaks_[PRN] = state;
+}
+
+
+int ChannelScheduler::assign_peak(int PRN, unsigned int channel)
+{
+    std::map<int, Peak_State>::iterator sat = peaks_.find(PRN);
+    if (sat == peaks_.end())
+        {
+            return 0;
+        }
+    std::map<unsigned int, std::pair<int, int>>::iterator held = channel_peak_.find(channel);
+    if (held != channel_peak_.end() && held->second.first != PRN)
+        {
+            // the channel moves to another satellite: release its old slot first
+            peak_lost(channel, false);
+            held = channel_peak_.end();
+        }
+    if (held == channel_peak_.end())
+        {
+            if (sat->second.acquiring >= peaks_per_satellite_)
+                {
+                    return 0;
+                }
+            sat->second.acquiring++;
+        }
+    int peak = sat->second.next_peak;
+    if (peak > max_peak_)
+        {
+            peak = 1;
+        }
+    sat->second.next_peak = peak + 1;
+    channel_peak_[channel] = std::make_pair(PRN, peak);
+    return peak;
+}
+
+
+int ChannelScheduler::get_peak(unsigned int channel) const
+{
+    std::map<unsigned int, std::pair<int, int>>::const_iterator held = channel_peak_.find(channel);
+    if (held == channel_peak_.end())
+        {
+            return 0;
+        }
+    return held->second.second;
+}
+
+
+void ChannelScheduler::peak_acquired(unsigned int channel)
+{
+    std::map<unsigned int, std::pair<int, int>>::const_iterator held = channel_peak_.find(channel);
+    if (held == channel_peak_.end())
+        {
+            return;
+        }
+    peaks_[held->second.first].next_peak = held->second.second + 1;
+}
+
+
+void ChannelScheduler::peak_lost(unsigned int channel, bool restart)
+{
+    std::map<unsigned int, std::pair<int, int>>::iterator held = channel_peak_.find(channel);
+    if (held == channel_peak_.end())
+        {
+            return;
+        }
+    std::map<int, Peak_State>::iterator sat = peaks_.find(held->second.first);
+    if (sat != peaks_.end())
+        {
+            if (sat->second.acquiring > 0)
+                {
+                    sat->second.acquiring--;
+                }
+            if (restart)
+                {
+                    sat->second.next_peak = 1;
+                }
+        }
+    channel_peak_.erase(held);
+}
+
+
+int ChannelScheduler::acquiring(int PRN) const
+{
+    std::map<int, Peak_State>::const_iterator sat = peaks_.find(PRN);
+    if (sat == peaks_.end())
+        {
+            return 0;
+        }
+    return sat->second.acquiring;
+}
+
+
+bool ChannelScheduler::wants_more_peaks(const Gnss_Signal& signal) const
+{
+    int PRN = signal.get_satellite().get_PRN();
+    if (peaks_.find(PRN) == peaks_.end())
+        {
+            return false;
+        }
+    return acquiring(PRN) + static_cast<int>(pending(signal)) < peaks_per_satellite_;
+}
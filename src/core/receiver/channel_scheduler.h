@@ -0,0 +1,170 @@
+/*!
+ * \file channel_scheduler.h
+ * \brief Assignment of pending GNSS signals and APT peaks to receiver channels.
+ *
+ * Pending signals are kept in one FIFO pool per signal type ("1C", "2S",
+ * "1B", "5X"), with a per-signal instance count, so handing the next signal
+ * to a channel, counting how many instances of a satellite are still waiting
+ * and finding the lowest standby channel that has work are all O(1) or
+ * O(log n), instead of rotating a single list until the signal type matches.
+ *
+ * The same structure tracks the Auxiliary Peak Tracking (APT) state: how
+ * many channels currently hold each satellite, which correlation peak each
+ * of those channels is working on and which peak comes next.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_CHANNEL_SCHEDULER_H_
+#define GNSS_SDR_CHANNEL_SCHEDULER_H_
+
+#include <deque>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include "gnss_signal.h"
+
+
+/*!
+ * \brief Indexed pools of pending signals, channel states and APT peak
+ * bookkeeping of the receiver flowgraph.
+ *
+ * Channel states follow the flowgraph convention: 0 standby, 1 acquisition,
+ * 2 tracking. The class does not touch the channels themselves; the
+ * flowgraph applies the returned signal and peak to the channel blocks.
+ */
+class ChannelScheduler
+{
+public:
+    //! Constructor
+    ChannelScheduler();
+
+    //! Virtual destructor
+    virtual ~ChannelScheduler();
+
+    /*!
+     * \brief Sets the number of channels and their signal types.
+     *
+     * The first max_acq_channels channels start in acquisition, the rest in standby.
+     */
+    void set_channels(const std::vector<std::string>& signal_types, unsigned int max_acq_channels);
+
+    unsigned int get_state(unsigned int channel) const;
+    void set_state(unsigned int channel, unsigned int state);
+    unsigned int acquiring_channels() const; //!< Channels in state 1
+
+    /*!
+     * \brief Takes the lowest numbered standby channel whose signal type has
+     * pending signals and puts it in acquisition. Returns false if there is none.
+     */
+    bool take_standby(unsigned int& channel);
+
+    //! Appends a signal to the pool of its signal type
+    void push_back(const Gnss_Signal& signal);
+
+    //! Removes every pending instance of the signal
+    void remove(const Gnss_Signal& signal);
+
+    /*!
+     * \brief Reserves a signal for a channel, ahead of the pools
+     * (ChannelN.satellite in the configuration).
+     */
+    void preassign(unsigned int channel, const Gnss_Signal& signal);
+
+    /*!
+     * \brief Gets the next signal for a channel: its preassigned signal if
+     * any, else the oldest pending signal of the given type.
+     * Returns false if there is nothing of that type to acquire.
+     */
+    bool next(unsigned int channel, const std::string& signal_type, Gnss_Signal& signal);
+
+    unsigned int pending(const Gnss_Signal& signal) const; //!< Pending instances of a signal
+    unsigned int pending() const;                          //!< All pending signals
+    bool empty() const;
+
+    /*!
+     * \brief APT: number of channels allowed per satellite and highest peak
+     * tried before wrapping around to the strongest one again.
+     */
+    void set_peaks(int peaks_per_satellite, int max_peak = 5);
+
+    //! APT: enables peak bookkeeping for a satellite
+    void add_satellite(int PRN);
+
+    /*!
+     * \brief APT: gives the channel the next peak of the satellite.
+     *
+     * A channel already working on that satellite moves on to the next peak
+     * without taking a new slot. Returns the peak, or 0 if the satellite is
+     * already held by peaks_per_satellite channels (or is not under APT).
+     */
+    int assign_peak(int PRN, unsigned int channel);
+
+    int get_peak(unsigned int channel) const; //!< APT: peak of the channel, 0 if none
+
+    //! APT: the channel acquired its peak, the following one comes next
+    void peak_acquired(unsigned int channel);
+
+    /*!
+     * \brief APT: the channel lost its satellite and releases its slot.
+     * If restart is set the satellite starts again from the strongest peak.
+     */
+    void peak_lost(unsigned int channel, bool restart);
+
+    int acquiring(int PRN) const; //!< APT: channels currently holding the satellite
+
+    /*!
+     * \brief APT: true if the satellite is held by (and pending for) fewer
+     * channels than peaks_per_satellite, i.e. it should be queued again.
+     */
+    bool wants_more_peaks(const Gnss_Signal& signal) const;
+
+private:
+    struct Peak_State
+    {
+        int acquiring;
+        int next_peak;
+    };
+
+    static std::string key(const Gnss_Signal& signal);
+
+    std::map<std::string, std::deque<Gnss_Signal>> pools_;        // pending signals per signal type
+    std::map<std::string, unsigned int> pending_count_;           // pending instances per signal
+    std::map<unsigned int, Gnss_Signal> preassigned_;
+    unsigned int pending_total_;
+
+    std::vector<unsigned int> states_;
+    std::vector<std::string> channel_signal_;
+    std::map<std::string, std::set<unsigned int>> standby_;       // standby channels per signal type
+    unsigned int acquiring_channels_;
+
+    int peaks_per_satellite_;
+    int max_peak_;
+    std::map<int, Peak_State> peaks_;                             // per PRN
+    std::map<unsigned int, std::pair<int, int>> channel_peak_;    // channel -> (PRN, peak)
+};
+
+#endif /*GNSS_SDR_CHANNEL_SCHEDULER_H_*/
@@ -0,0 +1,280 @@
+/*!
+ * \file concurrent_ring.h
+ * \brief Bounded lock-free queue for messages passed between receiver threads
+ *
+ * Fixed-capacity ring in which every slot carries a sequence number
+ * (D. Vyukov's bounded MPMC queue): producers and the consumer claim slots
+ * with a compare-and-swap on their own position counter, so push() and
+ * try_pop() never take a lock and never allocate. Any number of producers
+ * may push; pops are meant for a single consumer thread.
+ *
+ * When the ring is full, push() either drops the new message (and counts
+ * it) or waits for the consumer, depending on the policy given at
+ * construction. The occupancy, its high-water mark and the number of
+ * dropped messages are kept for monitoring.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_CONCURRENT_RING_H
+#define GNSS_SDR_CONCURRENT_RING_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <boost/thread.hpp>
+
+
+/*!
+ * \brief What push() does when the ring is full
+ */
+enum Concurrent_Ring_Overflow
+{
+    RING_DROP_NEWEST, //!< Discard the message being pushed, never blocks the producer
+    RING_BLOCK        //!< Wait until the consumer frees a slot
+};
+
+
+template<typename Data>
+
+/*!
+ * \brief Bounded multi-producer, single-consumer lock-free queue
+ *
+ * Drop-in replacement for concurrent_queue on the paths where producers run
+ * in signal processing threads.
+ */
+class concurrent_ring
+{
+private:
+    struct Slot
+    {
+        std::atomic<size_t> sequence;
+        Data data;
+    };
+
+    std::unique_ptr<Slot[]> the_slots;
+    size_t the_mask;
+    Concurrent_Ring_Overflow the_policy;
+    std::atomic<size_t> the_enqueue_pos;
+    std::atomic<size_t> the_dequeue_pos;
+    std::atomic<size_t> the_high_water;
+    std::atomic<unsigned long int> the_pushed;
+    std::atomic<unsigned long int> the_dropped;
+
+    static size_t round_up_pow2(size_t n)
+    {
+        size_t p = 2;
+        while (p < n) p <<= 1;
+        return p;
+    }
+
+    // A short spin, then yield, then sleep: waits without a lock or a condition variable
+    static void backoff(unsigned int& round)
+    {
+        if (round < 16)
+            {
+                round++;
+            }
+        else if (round < 64)
+            {
+                round++;
+                boost::this_thread::yield();
+            }
+        else
+            {
+                boost::this_thread::sleep_for(boost::chrono::milliseconds(1));
+            }
+    }
+
+    bool try_push(Data const& data)
+    {
+        size_t pos = the_enqueue_pos.load(std::memory_order_relaxed);
+        for (;;)
+            {
+                Slot& slot = the_slots[pos & the_mask];
+                size_t seq = slot.sequence.load(std::memory_order_acquire);
+                std::ptrdiff_t dif = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+                if (dif == 0)
+                    {
+                        if (the_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                            {
+                                slot.data = data;
+                                slot.sequence.store(pos + 1, std::memory_order_release);
+                                // the dequeue position read here may lag behind the consumers, or be past
+                                // this push when they already took it: keep the occupancy within the ring
+                                size_t dequeued = the_dequeue_pos.load(std::memory_order_relaxed);
+                                update_high_water(pos + 1 > dequeued ? std::min(pos + 1 - dequeued, the_mask + 1) : 0);
+                                return true;
+                            }
+                    }
+                else if (dif < 0)
+                    {
+                        return false; // full
+                    }
+                else
+                    {
+                        pos = the_enqueue_pos.load(std::memory_order_relaxed);
+                    }
+            }
+    }
+
+    void update_high_water(size_t occupancy)
+    {
+        size_t high = the_high_water.load(std::memory_order_relaxed);
+        while (occupancy > high && !the_high_water.compare_exchange_weak(high, occupancy, std::memory_order_relaxed))
+            {
+            }
+    }
+
+public:
+    /*!
+     * \brief Ring of at least \p capacity messages (rounded up to a power of two)
+     */
+    concurrent_ring(size_t capacity = 1024, Concurrent_Ring_Overflow policy = RING_DROP_NEWEST)
+    {
+        size_t size = round_up_pow2(capacity);
+        the_slots = std::unique_ptr<Slot[]>(new Slot[size]);
+        for (size_t i = 0; i < size; i++)
+            {
+                the_slots[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        the_mask = size - 1;
+        the_policy = policy;
+        the_enqueue_pos = 0;
+        the_dequeue_pos = 0;
+        the_high_water = 0;
+        the_pushed = 0;
+        the_dropped = 0;
+    }
+
+    /*!
+     * \brief Queues a copy of \p data. Returns false if it was dropped
+     * because the ring is full and the policy is RING_DROP_NEWEST.
+     */
+    bool push(Data const& data)
+    {
+        unsigned int round = 0;
+        while (!try_push(data))
+            {
+                if (the_policy == RING_DROP_NEWEST)
+                    {
+                        the_dropped.fetch_add(1, std::memory_order_relaxed);
+                        return false;
+                    }
+                backoff(round);
+            }
+        the_pushed.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+    bool try_pop(Data& popped_value)
+    {
+        size_t pos = the_dequeue_pos.load(std::memory_order_relaxed);
+        for (;;)
+            {
+                Slot& slot = the_slots[pos & the_mask];
+                size_t seq = slot.sequence.load(std::memory_order_acquire);
+                std::ptrdiff_t dif = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+                if (dif == 0)
+                    {
+                        if (the_dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                            {
+                                popped_value = slot.data;
+                                slot.sequence.store(pos + the_mask + 1, std::memory_order_release);
+                                return true;
+                            }
+                    }
+                else if (dif < 0)
+                    {
+                        return false; // empty
+                    }
+                else
+                    {
+                        pos = the_dequeue_pos.load(std::memory_order_relaxed);
+                    }
+            }
+    }
+
+    /*!
+     * \brief Appends up to \p max_items queued messages to \p items and
+     * returns how many were appended
+     */
+    size_t pop_batch(std::vector<Data>& items, size_t max_items)
+    {
+        size_t n = 0;
+        Data value;
+        while (n < max_items && try_pop(value))
+            {
+                items.push_back(value);
+                n++;
+            }
+        return n;
+    }
+
+    void wait_and_pop(Data& popped_value)
+    {
+        unsigned int round = 0;
+        while (!try_pop(popped_value))
+            {
+                backoff(round);
+            }
+    }
+
+    size_t capacity() const
+    {
+        return the_mask + 1;
+    }
+
+    //! Messages waiting, exact when no push or pop is in progress
+    size_t size() const
+    {
+        size_t enqueued = the_enqueue_pos.load(std::memory_order_acquire);
+        size_t dequeued = the_dequeue_pos.load(std::memory_order_acquire);
+        return enqueued > dequeued ? enqueued - dequeued : 0;
+    }
+
+    size_t high_water() const
+    {
+        return the_high_water.load(std::memory_order_relaxed);
+    }
+
+    unsigned long int pushed() const
+    {
+        return the_pushed.load(std::memory_order_relaxed);
+    }
+
+    unsigned long int dropped() const
+    {
+        return the_dropped.load(std::memory_order_relaxed);
+    }
+};
+#endif
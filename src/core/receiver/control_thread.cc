@@ -38,6 +38,7 @@
 #include <map>
 #include <string>
 #include <boost/lexical_cast.hpp>
+#include <boost/tokenizer.hpp>
 #include <boost/chrono.hpp>
 #include <gnuradio/message.h>
 #include <gflags/gflags.h>
@@ -50,19 +51,35 @@
 #include "galileo_iono.h"
 #include "galileo_utc_model.h"
 #include "galileo_almanac.h"
-#include "concurrent_queue.h"
+#include "concurrent_ring.h"
 #include "concurrent_map.h"
 #include "gnss_flowgraph.h"
 #include "file_configuration.h"
+#include "receiver_configuration.h"
 #include "control_message_factory.h"
+#include "gnss_sdr_perf.h"
+#include "spoofing_stats.h"
+#include "gnss_sdr_runtime_params.h"
 
 extern concurrent_map<Gps_Acq_Assist> global_gps_acq_assist_map;
-extern concurrent_queue<Gps_Acq_Assist> global_gps_acq_assist_queue;
+extern concurrent_ring<Gps_Acq_Assist> global_gps_acq_assist_queue;
 
 using google::LogMessage;
 
 DEFINE_string(config_file, std::string(GNSSSDR_INSTALL_DIR "/share/gnss-sdr/conf/default.conf"),
         "File containing the configuration parameters");
+DEFINE_bool(perf, false, "Measure the work calls of the receiver blocks and print a summary at exit");
+
+namespace
+{
+// The spoofing detection blocks and APT keep their state in process-wide maps
+bool uses_spoofing_state(std::shared_ptr<ConfigurationInterface> configuration)
+{
+    return configuration->property("Spoofing.APT", false)
+            || configuration->property("TelemetryDecoder_1C.implementation", std::string("")).compare("GPS_L1_CA_SD_Telemetry_Decoder") == 0
+            || configuration->property("PVT.implementation", std::string("")).compare("GPS_L1_CA_SD_PVT") == 0;
+}
+}
 
 ControlThread::ControlThread()
 {
@@ -110,6 +127,16 @@ void ControlThread::run()
             LOG(ERROR) << "Unable to connect flowgraph";
             return;
         }
+    for (unsigned int r = 0; r < receivers_.size(); r++)
+        {
+            receivers_.at(r)->connect();
+            if (!receivers_.at(r)->connected())
+                {
+                    LOG(ERROR) << "Unable to connect receiver " << receiver_names_.at(r);
+                    return;
+                }
+            LOG(INFO) << "Receiver " << receiver_names_.at(r) << " connected";
+        }
     // Start the flowgraph
     flowgraph_->start();
     if (flowgraph_->running())
@@ -121,6 +148,39 @@ void ControlThread::run()
             LOG(ERROR) << "Unable to start flowgraph";
             return;
         }
+    for (unsigned int r = 0; r < receivers_.size(); r++)
+        {
+            receivers_.at(r)->start();
+            receiver_threads_.create_thread([this, r]() { receiver_control_loop(r); });
+        }
+
+    // Publish the block performance counters while running
+    std::string perf_filename = configuration_->property("Perf.filename", std::string(""));
+    std::string perf_socket = configuration_->property("Perf.socket", std::string(""));
+    if (Gnss_Sdr_Perf::instance().enabled() && (!perf_filename.empty() || !perf_socket.empty()))
+        {
+            int period_ms = configuration_->property("Perf.period_ms", 1000);
+            Gnss_Sdr_Perf::instance().set_period_ms(period_ms);
+            perf_server_ = std::unique_ptr<Spoofing_Stats_Server>(new Spoofing_Stats_Server(
+                    []() { return Gnss_Sdr_Perf::instance().to_json(); }, "Perf"));
+            perf_server_->start(perf_filename, period_ms, perf_socket, 0);
+        }
+
+    // Accept parameter changes while running, applied by action RECONFIGURE
+    std::string reconfigure_filename = configuration_->property("Reconfigure.filename", std::string(""));
+    std::string reconfigure_socket = configuration_->property("Reconfigure.socket", std::string(""));
+    if (!reconfigure_filename.empty() || !reconfigure_socket.empty())
+        {
+            int period_ms = configuration_->property("Reconfigure.period_ms", 1000);
+            reconfigure_listener_ = std::unique_ptr<Gnss_Sdr_Reconfigure_Listener>(new Gnss_Sdr_Reconfigure_Listener());
+            reconfigure_listener_->start(reconfigure_filename, period_ms, reconfigure_socket,
+                    [this](const std::map<std::string, std::string>& values)
+                    {
+                        reconfigure_queue_.push(values);
+                        std::unique_ptr<ControlMessageFactory> cmf(new ControlMessageFactory());
+                        control_queue_->handle(cmf->GetQueueMessage(200, 1));
+                    });
+        }
 
     //launch GNSS assistance process AFTER the flowgraph is running because the GNURadio asynchronous queues must be already running to transport msgs
     assist_GNSS();
@@ -138,6 +198,14 @@ void ControlThread::run()
     flowgraph_->stop();
     stop_ = true;
 
+    // wake up the control loops of the hosted receivers so that they see stop_
+    for (unsigned int r = 0; r < receivers_.size(); r++)
+        {
+            receivers_.at(r)->stop();
+            receiver_queues_.at(r)->handle(control_message_factory_->GetQueueMessage(200, 0));
+        }
+    receiver_threads_.join_all();
+
     //Join keyboard thread
 #ifdef OLD_BOOST
     keyboard_thread_.timed_join(boost::posix_time::seconds(1));
@@ -146,6 +214,18 @@ void ControlThread::run()
     keyboard_thread_.try_join_until(boost::chrono::steady_clock::now() + boost::chrono::milliseconds(1000));
 #endif
 
+    if (reconfigure_listener_)
+        {
+            reconfigure_listener_->stop();
+        }
+    if (perf_server_)
+        {
+            perf_server_->stop();
+        }
+    if (FLAGS_perf)
+        {
+            std::cout << Gnss_Sdr_Perf::instance().summary();
+        }
     LOG(INFO) << "Flowgraph stopped";
 }
 
@@ -412,10 +492,18 @@ void ControlThread::assist_GNSS()
 
 void ControlThread::init()
 {
+    // Per-block performance counters: measured with --perf, Perf.enable=true or a Perf output
+    bool perf = FLAGS_perf || configuration_->property("Perf.enable", false)
+            || !configuration_->property("Perf.filename", std::string("")).empty()
+            || !configuration_->property("Perf.socket", std::string("")).empty();
+    Gnss_Sdr_Perf::instance().set_enabled(perf);
+    Gnss_Sdr_Perf::instance().set_max_backlog_ms(configuration_->property("Perf.max_backlog_ms", 0.0));
+
     // Instantiates a control queue, a GNSS flowgraph, and a control message factory
     control_queue_ = gr::msg_queue::make(0);
     flowgraph_ = std::make_shared<GNSSFlowgraph>(configuration_, control_queue_);
     control_message_factory_ = std::make_shared<ControlMessageFactory>();
+    init_receivers();
     stop_ = false;
     processed_control_messages_ = 0;
     applied_actions_ = 0;
@@ -426,6 +514,77 @@ void ControlThread::init()
 }
 
 
+/*
+ * Builds the receivers listed in Receivers.names. Receiver <name> reads its
+ * configuration from Receivers.<name>.config_file (GNSS-SDR.* parameters come
+ * from the main configuration) and is fed by the signal conditioners of the
+ * main flowgraph, in the same top block, so all the receivers see the same
+ * samples. At most one receiver may run the spoofing detection.
+ */
+void ControlThread::init_receivers()
+{
+    std::string names = configuration_->property("Receivers.names", std::string(""));
+    boost::char_separator<char> separator(", ");
+    boost::tokenizer<boost::char_separator<char>> tokens(names, separator);
+    bool spoofing_state = uses_spoofing_state(configuration_);
+    for (boost::tokenizer<boost::char_separator<char>>::iterator it = tokens.begin(); it != tokens.end(); ++it)
+        {
+            std::string name = *it;
+            std::string filename = configuration_->property("Receivers." + name + ".config_file", std::string(""));
+            if (filename.empty())
+                {
+                    LOG(ERROR) << "Receivers." << name << ".config_file is not set, receiver " << name << " not created";
+                    continue;
+                }
+            std::shared_ptr<ConfigurationInterface> configuration = std::make_shared<ReceiverConfiguration>(
+                    configuration_, std::make_shared<FileConfiguration>(filename));
+            if (uses_spoofing_state(configuration))
+                {
+                    if (spoofing_state)
+                        {
+                            LOG(ERROR) << "Receiver " << name << " not created: another receiver already runs the spoofing detection";
+                            std::cout << "Receiver " << name << " not created: only one receiver may run the spoofing detection" << std::endl;
+                            continue;
+                        }
+                    spoofing_state = true;
+                }
+            boost::shared_ptr<gr::msg_queue> queue = gr::msg_queue::make(0);
+            receivers_.push_back(std::make_shared<GNSSFlowgraph>(configuration, queue, flowgraph_));
+            receiver_queues_.push_back(queue);
+            receiver_names_.push_back(name);
+            LOG(INFO) << "Receiver " << name << " created from " << filename;
+            std::cout << "Receiver " << name << " created from " << filename << std::endl;
+        }
+}
+
+
+/*
+ * Control messages of a hosted receiver, processed in their own thread so
+ * that the receivers do not wait for each other
+ */
+void ControlThread::receiver_control_loop(unsigned int r)
+{
+    std::unique_ptr<ControlMessageFactory> cmf(new ControlMessageFactory());
+    while (!stop_)
+        {
+            boost::shared_ptr<gr::message> queue_message = receiver_queues_.at(r)->delete_head();
+            if (queue_message == 0)
+                {
+                    continue;
+                }
+            std::shared_ptr<std::vector<std::shared_ptr<ControlMessage>>> messages = cmf->GetControlMessages(queue_message);
+            for (unsigned int i = 0; i < messages->size() && !stop_; i++)
+                {
+                    // who=200 only wakes the loop up at exit
+                    if (messages->at(i)->who != 200)
+                        {
+                            receivers_.at(r)->apply_action(messages->at(i)->who, messages->at(i)->what);
+                        }
+                }
+        }
+}
+
+
 void ControlThread::read_control_messages()
 {
     DLOG(INFO) << "Reading control messages from queue";
@@ -472,6 +631,11 @@ void ControlThread::apply_action(unsigned int what)
         stop_ = true;
         applied_actions_++;
         break;
+    case 1:
+        DLOG(INFO) << "Received action RECONFIGURE";
+        apply_reconfiguration();
+        applied_actions_++;
+        break;
     default:
         DLOG(INFO) << "Unrecognized action.";
         break;
@@ -479,6 +643,34 @@ void ControlThread::apply_action(unsigned int what)
 }
 
 
+/*
+ * Publishes the pending parameter batches. Each batch is validated as a whole
+ * and either fully applied or rejected; the blocks pick the new values up on
+ * their next work call.
+ */
+void ControlThread::apply_reconfiguration()
+{
+    std::map<std::string, std::string> values;
+    while (reconfigure_queue_.try_pop(values))
+        {
+            std::string error;
+            if (Gnss_Sdr_Runtime_Params::instance().update(values, error))
+                {
+                    for (std::map<std::string, std::string>::const_iterator it = values.begin(); it != values.end(); ++it)
+                        {
+                            LOG(INFO) << "Reconfigure: " << it->first << "=" << it->second;
+                        }
+                    std::cout << "Reconfigured " << values.size() << " parameter(s)" << std::endl;
+                }
+            else
+                {
+                    LOG(WARNING) << "Reconfigure: rejected, " << error;
+                    std::cout << "Reconfiguration rejected: " << error << std::endl;
+                }
+        }
+}
+
+
 void ControlThread::gps_acq_assist_data_collector()
 {
     // ############ 1.bis READ EPHEMERIS/UTC_MODE/IONO QUEUE ####################
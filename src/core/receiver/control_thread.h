@@ -35,15 +35,20 @@
 #ifndef GNSS_SDR_CONTROL_THREAD_H_
 #define GNSS_SDR_CONTROL_THREAD_H_
 
+#include <map>
 #include <memory>
+#include <string>
 #include <vector>
 #include <boost/thread.hpp>
 #include <gnuradio/msg_queue.h>
 #include "control_message_factory.h"
 #include "gnss_sdr_supl_client.h"
+#include "concurrent_queue.h"
 
 class GNSSFlowgraph;
 class ConfigurationInterface;
+class Spoofing_Stats_Server;
+class Gnss_Sdr_Reconfigure_Listener;
 
 
 /*!
@@ -112,6 +117,15 @@ public:
         return flowgraph_;
     }
 
+    /*!
+     * \brief Receivers hosted by the main flowgraph (Receivers.names), in
+     * the order of the configuration
+     */
+    const std::vector<std::shared_ptr<GNSSFlowgraph>>& receivers()
+    {
+        return receivers_;
+    }
+
 private:
     //SUPL assistance classes
     gnss_sdr_supl_client supl_client_acquisition_;
@@ -125,6 +139,7 @@ private:
     bool detect_spoofing;
 
     void init();
+    void init_receivers();
 
     // Read {ephemeris, iono, utc, ref loc, ref time} assistance from a local XML file previously recorded
     bool read_assistance_from_XML();
@@ -148,6 +163,7 @@ private:
     
     
     void apply_action(unsigned int what);
+    void apply_reconfiguration();
     std::shared_ptr<GNSSFlowgraph> flowgraph_;
     std::shared_ptr<ConfigurationInterface> configuration_;
     boost::shared_ptr<gr::msg_queue> control_queue_;
@@ -159,9 +175,20 @@ private:
     unsigned int applied_actions_;
     boost::thread keyboard_thread_;
     boost::thread gps_acq_assist_data_collector_thread_;
+    std::unique_ptr<Spoofing_Stats_Server> perf_server_;  // publishes Gnss_Sdr_Perf
+    std::unique_ptr<Gnss_Sdr_Reconfigure_Listener> reconfigure_listener_;
+    concurrent_queue<std::map<std::string, std::string>> reconfigure_queue_;  // batches waiting for action RECONFIGURE
     
     void keyboard_listener();
 
+    // Receivers sharing the signal sources and conditioners of flowgraph_, each
+    // with its own control queue served by its own thread
+    std::vector<std::string> receiver_names_;
+    std::vector<std::shared_ptr<GNSSFlowgraph>> receivers_;
+    std::vector<boost::shared_ptr<gr::msg_queue>> receiver_queues_;
+    boost::thread_group receiver_threads_;
+    void receiver_control_loop(unsigned int r);
+
     // default filename for assistance data
     const std::string eph_default_xml_filename = "./gps_ephemeris.xml";
     const std::string utc_default_xml_filename = "./gps_utc_model.xml";
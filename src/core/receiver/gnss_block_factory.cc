@@ -46,6 +46,7 @@
 #include <glog/logging.h>
 #include "configuration_interface.h"
 #include "gnss_block_interface.h"
+#include "gnss_block_registry.h"
 #include "pass_through.h"
 #include "file_signal_source.h"
 #include "nsr_file_signal_source.h"
@@ -53,10 +54,12 @@
 #include "spir_file_signal_source.h"
 #include "rtl_tcp_signal_source.h"
 #include "two_bit_packed_file_signal_source.h"
+#include "capture_container_signal_source.h"
 #include "channel.h"
 
 #include "signal_conditioner.h"
 #include "array_signal_conditioner.h"
+#include "fused_signal_conditioner.h"
 #include "byte_to_short.h"
 #include "ibyte_to_cbyte.h"
 #include "ibyte_to_cshort.h"
@@ -64,9 +67,11 @@
 #include "ishort_to_cshort.h"
 #include "ishort_to_complex.h"
 #include "direct_resampler_conditioner.h"
+#include "polyphase_resampler_conditioner.h"
 #include "fir_filter.h"
 #include "freq_xlating_fir_filter.h"
 #include "beamformer_filter.h"
+#include "adaptive_beamformer_filter.h"
 #include "gps_l1_ca_pcps_acquisition.h"
 #include "gps_l2_m_pcps_acquisition.h"
 #include "gps_l1_ca_pcps_sd_acquisition.h"
@@ -134,6 +139,167 @@
 using google::LogMessage;
 
 
+namespace
+{
+/*
+ * Block constructors by implementation name. Acquisition, tracking,
+ * telemetry decoder and PVT adapters are registered once with their own
+ * interface; GetBlock() also finds them there.
+ *
+ * PLEASE ADD YOUR NEW BLOCK HERE!!
+ */
+struct GNSSBlockRegistries
+{
+    GNSSBlockRegistry<GNSSBlockInterface> blocks;
+    GNSSBlockRegistry<AcquisitionInterface> acquisition;
+    GNSSBlockRegistry<TrackingInterface> tracking;
+    GNSSBlockRegistry<TelemetryDecoderInterface> telemetry;
+    GNSSBlockRegistry<PvtInterface> pvt;
+
+    GNSSBlockRegistries()
+    {
+        //PASS THROUGH ----------------------------------------------------------------
+        blocks.add("Pass_Through", make_gnss_block<Pass_Through, GNSSBlockInterface>);
+
+        // SIGNAL SOURCES -------------------------------------------------------------
+        blocks.add("File_Signal_Source", make_gnss_file_source<FileSignalSource, GNSSBlockInterface>);
+        blocks.add("Nsr_File_Signal_Source", make_gnss_file_source<NsrFileSignalSource, GNSSBlockInterface>);
+#if MODERN_GNURADIO
+        blocks.add("Two_Bit_Cpx_File_Signal_Source", make_gnss_file_source<TwoBitCpxFileSignalSource, GNSSBlockInterface>);
+        blocks.add("Two_Bit_Packed_File_Signal_Source", make_gnss_file_source<TwoBitPackedFileSignalSource, GNSSBlockInterface>);
+#endif
+        blocks.add("Spir_File_Signal_Source", make_gnss_file_source<SpirFileSignalSource, GNSSBlockInterface>);
+        blocks.add("Capture_Container_Signal_Source", make_gnss_file_source<CaptureContainerSignalSource, GNSSBlockInterface>);
+        blocks.add("RtlTcp_Signal_Source", make_gnss_file_source<RtlTcpSignalSource, GNSSBlockInterface>);
+#if UHD_DRIVER
+        blocks.add("UHD_Signal_Source", make_gnss_source<UhdSignalSource, GNSSBlockInterface>);
+#endif
+#if GN3S_DRIVER
+        blocks.add("GN3S_Signal_Source", make_gnss_source<Gn3sSignalSource, GNSSBlockInterface>);
+#endif
+#if RAW_ARRAY_DRIVER
+        blocks.add("Raw_Array_Signal_Source", make_gnss_source<RawArraySignalSource, GNSSBlockInterface>);
+#endif
+#if OSMOSDR_DRIVER
+        blocks.add("Osmosdr_Signal_Source", make_gnss_source<OsmosdrSignalSource, GNSSBlockInterface>);
+#endif
+#if FLEXIBAND_DRIVER
+        blocks.add("Flexiband_Signal_Source", make_gnss_source<FlexibandSignalSource, GNSSBlockInterface>);
+#endif
+
+        // DATA TYPE ADAPTER -----------------------------------------------------------
+        blocks.add("Byte_To_Short", make_gnss_block<ByteToShort, GNSSBlockInterface>);
+        blocks.add("Ibyte_To_Cbyte", make_gnss_block<IbyteToCbyte, GNSSBlockInterface>);
+        blocks.add("Ibyte_To_Cshort", make_gnss_block<IbyteToCshort, GNSSBlockInterface>);
+        blocks.add("Ibyte_To_Complex", make_gnss_block<IbyteToComplex, GNSSBlockInterface>);
+        blocks.add("Ishort_To_Cshort", make_gnss_block<IshortToCshort, GNSSBlockInterface>);
+        blocks.add("Ishort_To_Complex", make_gnss_block<IshortToComplex, GNSSBlockInterface>);
+
+        // INPUT FILTER ----------------------------------------------------------------
+        blocks.add("Fir_Filter", make_gnss_block<FirFilter, GNSSBlockInterface>);
+        blocks.add("Freq_Xlating_Fir_Filter", make_gnss_block<FreqXlatingFirFilter, GNSSBlockInterface>);
+        blocks.add("Beamformer_Filter", make_gnss_block<BeamformerFilter, GNSSBlockInterface>);
+        blocks.add("Adaptive_Beamformer_Filter", make_gnss_block<AdaptiveBeamformerFilter, GNSSBlockInterface>);
+
+        // RESAMPLER -------------------------------------------------------------------
+        blocks.add("Direct_Resampler", make_gnss_block<DirectResamplerConditioner, GNSSBlockInterface>);
+        blocks.add("Polyphase_Resampler", make_gnss_block<PolyphaseResamplerConditioner, GNSSBlockInterface>);
+
+        // OBSERVABLES -----------------------------------------------------------------
+        blocks.add("GPS_L1_CA_Observables", make_gnss_block<GpsL1CaObservables, GNSSBlockInterface>);
+        blocks.add("Galileo_E1B_Observables", make_gnss_block<GalileoE1Observables, GNSSBlockInterface>);
+        blocks.add("Hybrid_Observables", make_gnss_block<HybridObservables, GNSSBlockInterface>);
+
+        // ACQUISITION BLOCKS ---------------------------------------------------------
+        acquisition.add("GPS_L1_CA_PCPS_Acquisition", make_gnss_block<GpsL1CaPcpsAcquisition, AcquisitionInterface>);
+        acquisition.add("GPS_L1_CA_PCPS_SD_Acquisition", make_gnss_block<GpsL1CaPcpsSdAcquisition, AcquisitionInterface>);
+        acquisition.add("GPS_L1_CA_PCPS_Assisted_Acquisition", make_gnss_block<GpsL1CaPcpsAssistedAcquisition, AcquisitionInterface>);
+        acquisition.add("GPS_L1_CA_PCPS_Tong_Acquisition", make_gnss_block<GpsL1CaPcpsTongAcquisition, AcquisitionInterface>);
+        acquisition.add("GPS_L1_CA_PCPS_Multithread_Acquisition", make_gnss_block<GpsL1CaPcpsMultithreadAcquisition, AcquisitionInterface>);
+#if OPENCL_BLOCKS
+        acquisition.add("GPS_L1_CA_PCPS_OpenCl_Acquisition", make_gnss_block<GpsL1CaPcpsOpenClAcquisition, AcquisitionInterface>);
+#endif
+        acquisition.add("GPS_L1_CA_PCPS_Acquisition_Fine_Doppler", make_gnss_block<GpsL1CaPcpsAcquisitionFineDoppler, AcquisitionInterface>);
+        acquisition.add("GPS_L1_CA_PCPS_QuickSync_Acquisition", make_gnss_block<GpsL1CaPcpsQuickSyncAcquisition, AcquisitionInterface>);
+        acquisition.add("GPS_L2_M_PCPS_Acquisition", make_gnss_block<GpsL2MPcpsAcquisition, AcquisitionInterface>);
+        acquisition.add("Galileo_E1_PCPS_Ambiguous_Acquisition", make_gnss_block<GalileoE1PcpsAmbiguousAcquisition, AcquisitionInterface>);
+        acquisition.add("Galileo_E1_PCPS_8ms_Ambiguous_Acquisition", make_gnss_block<GalileoE1Pcps8msAmbiguousAcquisition, AcquisitionInterface>);
+        acquisition.add("Galileo_E1_PCPS_Tong_Ambiguous_Acquisition", make_gnss_block<GalileoE1PcpsTongAmbiguousAcquisition, AcquisitionInterface>);
+        acquisition.add("Galileo_E1_PCPS_CCCWSR_Ambiguous_Acquisition", make_gnss_block<GalileoE1PcpsCccwsrAmbiguousAcquisition, AcquisitionInterface>);
+        acquisition.add("Galileo_E1_PCPS_QuickSync_Ambiguous_Acquisition", make_gnss_block<GalileoE1PcpsQuickSyncAmbiguousAcquisition, AcquisitionInterface>);
+        acquisition.add("Galileo_E5a_Noncoherent_IQ_Acquisition_CAF", make_gnss_block<GalileoE5aNoncoherentIQAcquisitionCaf, AcquisitionInterface>);
+
+        // TRACKING BLOCKS -------------------------------------------------------------
+        tracking.add("GPS_L1_CA_DLL_PLL_Tracking", make_gnss_block<GpsL1CaDllPllTracking, TrackingInterface>);
+        tracking.add("GPS_L1_CA_DLL_PLL_C_Aid_Tracking", make_gnss_block<GpsL1CaDllPllCAidTracking, TrackingInterface>);
+        tracking.add("GPS_L1_CA_TCP_CONNECTOR_Tracking", make_gnss_block<GpsL1CaTcpConnectorTracking, TrackingInterface>);
+        tracking.add("Galileo_E1_DLL_PLL_VEML_Tracking", make_gnss_block<GalileoE1DllPllVemlTracking, TrackingInterface>);
+        tracking.add("Galileo_E1_TCP_CONNECTOR_Tracking", make_gnss_block<GalileoE1TcpConnectorTracking, TrackingInterface>);
+        tracking.add("Galileo_E5a_DLL_PLL_Tracking", make_gnss_block<GalileoE5aDllPllTracking, TrackingInterface>);
+        tracking.add("GPS_L2_M_DLL_PLL_Tracking", make_gnss_block<GpsL2MDllPllTracking, TrackingInterface>);
+#if CUDA_GPU_ACCEL
+        tracking.add("GPS_L1_CA_DLL_PLL_Tracking_GPU", make_gnss_block<GpsL1CaDllPllTrackingGPU, TrackingInterface>);
+#endif
+
+        // TELEMETRY DECODERS ----------------------------------------------------------
+        telemetry.add("GPS_L1_CA_Telemetry_Decoder", make_gnss_block<GpsL1CaTelemetryDecoder, TelemetryDecoderInterface>);
+        telemetry.add("GPS_L1_CA_SD_Telemetry_Decoder", make_gnss_block<GpsL1CaSdTelemetryDecoder, TelemetryDecoderInterface>);
+        telemetry.add("Galileo_E1B_Telemetry_Decoder", make_gnss_block<GalileoE1BTelemetryDecoder, TelemetryDecoderInterface>);
+        telemetry.add("SBAS_L1_Telemetry_Decoder", make_gnss_block<SbasL1TelemetryDecoder, TelemetryDecoderInterface>);
+        telemetry.add("Galileo_E5a_Telemetry_Decoder", make_gnss_block<GalileoE5aTelemetryDecoder, TelemetryDecoderInterface>);
+        telemetry.add("GPS_L2_M_Telemetry_Decoder", make_gnss_block<GpsL2MTelemetryDecoder, TelemetryDecoderInterface>);
+
+        // PVT -------------------------------------------------------------------------
+        pvt.add("GPS_L1_CA_PVT", make_gnss_block<GpsL1CaPvt, PvtInterface>);
+        pvt.add("GPS_L1_CA_SD_PVT", make_gnss_block<GpsL1CaSdPvt, PvtInterface>);
+        pvt.add("GALILEO_E1_PVT", make_gnss_block<GalileoE1Pvt, PvtInterface>);
+        pvt.add("Hybrid_PVT", make_gnss_block<HybridPvt, PvtInterface>);
+    }
+};
+
+
+const GNSSBlockRegistries& registries()
+{
+    // built once, thread-safe since C++11
+    static const GNSSBlockRegistries r;
+    return r;
+}
+
+
+template <class Interface>
+std::unique_ptr<Interface> make_from(const GNSSBlockRegistry<Interface>& registry,
+        std::shared_ptr<ConfigurationInterface> configuration, const std::string& role,
+        const std::string& implementation, unsigned int in_streams, unsigned int out_streams,
+        boost::shared_ptr<gr::msg_queue> queue)
+{
+    const typename GNSSBlockRegistry<Interface>::Maker* maker = registry.find(implementation);
+    if (maker == nullptr)
+        {
+            // Log fatal. This causes execution to stop.
+            LOG(ERROR) << role << "." << implementation << ": Undefined implementation for block";
+            return std::unique_ptr<Interface>();
+        }
+    return (*maker)(configuration.get(), role, in_streams, out_streams, queue);
+}
+
+
+/*
+ * Role of a channel block: "Acquisition_1C3" if the configuration has
+ * Acquisition_1C3.implementation, otherwise the one shared by all the
+ * channels of the signal, "Acquisition_1C"
+ */
+std::string channel_role(std::shared_ptr<ConfigurationInterface> configuration, const std::string& base, const std::string& id)
+{
+    std::string specific = base + id;
+    if (configuration->property(specific + ".implementation", std::string("W")).compare("W") != 0)
+        {
+            return specific;
+        }
+    return base;
+}
+}
+
+
 GNSSBlockFactory::GNSSBlockFactory()
 {}
 
@@ -209,16 +375,26 @@ std::unique_ptr<GNSSBlockInterface> GNSSBlockFactory::GetSignalConditioner(
                 role_conditioner, "Signal_Conditioner"));
             return conditioner_;
         }
-    else
-        {
-            //single-antenna version
-            std::unique_ptr<GNSSBlockInterface> conditioner_(new SignalConditioner(configuration.get(),
-                std::move(GetBlock(configuration, role_datatypeadapter, data_type_adapter, 1, 1)),
-                std::move(GetBlock(configuration, role_inputfilter, input_filter, 1, 1)),
-                std::move(GetBlock(configuration, role_resampler, resampler, 1, 1)),
-                role_conditioner, "Signal_Conditioner"));
-            return conditioner_;
-        }
+    if(signal_conditioner.compare("Fused_Signal_Conditioner") == 0)
+        {
+            if(FusedSignalConditioner::can_fuse(configuration.get(), role_datatypeadapter, role_inputfilter, role_resampler))
+                {
+                    //single-antenna version running the three stages in one block
+                    std::unique_ptr<GNSSBlockInterface> conditioner_(new FusedSignalConditioner(configuration.get(),
+                        role_conditioner, role_datatypeadapter, role_inputfilter, role_resampler));
+                    return conditioner_;
+                }
+            LOG(WARNING) << "The configured DataTypeAdapter, InputFilter and Resampler cannot be fused, "
+                    << "falling back to the chained Signal_Conditioner";
+        }
+
+    //single-antenna version
+    std::unique_ptr<GNSSBlockInterface> conditioner_(new SignalConditioner(configuration.get(),
+        std::move(GetBlock(configuration, role_datatypeadapter, data_type_adapter, 1, 1)),
+        std::move(GetBlock(configuration, role_inputfilter, input_filter, 1, 1)),
+        std::move(GetBlock(configuration, role_resampler, resampler, 1, 1)),
+        role_conditioner, "Signal_Conditioner"));
+    return conditioner_;
 }
 
 
@@ -252,225 +428,31 @@ std::unique_ptr<PvtInterface> GNSSBlockFactory::GetPVT(std::shared_ptr<Configura
 }
 
 
-//********* GPS L1 C/A CHANNEL *****************
-std::unique_ptr<GNSSBlockInterface> GNSSBlockFactory::GetChannel_1C(
-        std::shared_ptr<ConfigurationInterface> configuration,
+std::unique_ptr<GNSSBlockInterface> GNSSBlockFactory::GetChannel(
+        std::shared_ptr<ConfigurationInterface> configuration, const std::string& signal,
         std::string acq, std::string trk, std::string tlm, int channel,
         boost::shared_ptr<gr::msg_queue> queue)
 {
-    //"appendix" is added to the "role" with the aim of Acquisition, Tracking and Telemetry Decoder adapters
-    //can find their specific configurations when they read the config 
-    //TODO: REMOVE APPENDIX!! AND CHECK ALTERNATIVE MECHANISM TO GET PARTICULARIZED PARAMETERS
     LOG(INFO) << "Instantiating Channel " << channel << " with Acquisition Implementation: "
               << acq << ", Tracking Implementation: " << trk  << ", Telemetry Decoder implementation: " << tlm;
 
-    std::string aux = configuration->property("Acquisition_1C" + boost::lexical_cast<std::string>(channel) + ".implementation", std::string("W"));
-    std::string appendix1;
-    if(aux.compare("W") != 0)
-        {
-            appendix1 = boost::lexical_cast<std::string>(channel);
-        }
-    else
-        {
-            appendix1 = ""; 
-        }
-    aux = configuration->property("Tracking_1C" + boost::lexical_cast<std::string>(channel) + ".implementation", std::string("W"));
-    std::string appendix2;
-    if(aux.compare("W") != 0)
-        {
-            appendix2 = boost::lexical_cast<std::string>(channel);
-        }
-    else
-        {
-            appendix2 = ""; 
-        }
-    aux = configuration->property("TelemetryDecoder_1C" + boost::lexical_cast<std::string>(channel) + ".implementation", std::string("W"));
-    std::string appendix3;
-    if(aux.compare("W") != 0)
-        {
-            appendix3 = boost::lexical_cast<std::string>(channel);
-        }
-    else
-        {
-            appendix3 = ""; 
-        }
+    // Acquisition, Tracking and Telemetry Decoder adapters read their configuration
+    // from the channel-specific role if the configuration defines one
+    std::string id = boost::lexical_cast<std::string>(channel);
+    std::string acq_role = channel_role(configuration, "Acquisition_" + signal, id);
+    std::string trk_role = channel_role(configuration, "Tracking_" + signal, id);
+    std::string tlm_role = channel_role(configuration, "TelemetryDecoder_" + signal, id);
 
     std::unique_ptr<GNSSBlockInterface> pass_through_ = GetBlock(configuration, "Channel", "Pass_Through", 1, 1, queue);
-    std::unique_ptr<AcquisitionInterface> acq_ = GetAcqBlock(configuration, "Acquisition_1C" + appendix1, acq, 1, 0);
-    std::unique_ptr<TrackingInterface> trk_ = GetTrkBlock(configuration, "Tracking_1C"+ appendix2, trk, 1, 1);
-    std::unique_ptr<TelemetryDecoderInterface> tlm_ = GetTlmBlock(configuration, "TelemetryDecoder_1C" + appendix3, tlm, 1, 1);
+    std::unique_ptr<AcquisitionInterface> acq_ = GetAcqBlock(configuration, acq_role, acq, 1, 0);
+    std::unique_ptr<TrackingInterface> trk_ = GetTrkBlock(configuration, trk_role, trk, 1, 1);
+    std::unique_ptr<TelemetryDecoderInterface> tlm_ = GetTlmBlock(configuration, tlm_role, tlm, 1, 1);
 
     std::unique_ptr<GNSSBlockInterface> channel_(new Channel(configuration.get(), channel, std::move(pass_through_),
             std::move(acq_),
             std::move(trk_),
             std::move(tlm_),
-            "Channel", "1C", queue));
-
-    return channel_;
-}
-
-//********* GPS L2C (M) CHANNEL *****************
-std::unique_ptr<GNSSBlockInterface> GNSSBlockFactory::GetChannel_2S(
-        std::shared_ptr<ConfigurationInterface> configuration,
-        std::string acq, std::string trk, std::string tlm, int channel,
-        boost::shared_ptr<gr::msg_queue> queue)
-{
-
-    LOG(INFO) << "Instantiating Channel " << channel << " with Acquisition Implementation: "
-              << acq << ", Tracking Implementation: " << trk  << ", Telemetry Decoder implementation: " << tlm;
-    std::string aux = configuration->property("Acquisition_2S" + boost::lexical_cast<std::string>(channel) + ".implementation", std::string("W"));
-    std::string appendix1;
-    if(aux.compare("W") != 0)
-        {
-            appendix1 = boost::lexical_cast<std::string>(channel);
-        }
-    else
-        {
-            appendix1 = ""; 
-        }
-    aux = configuration->property("Tracking_2S" + boost::lexical_cast<std::string>(channel) + ".implementation", std::string("W"));
-    std::string appendix2;
-    if(aux.compare("W") != 0)
-        {
-            appendix2 = boost::lexical_cast<std::string>(channel);
-        }
-    else
-        {
-            appendix2 = ""; 
-        }
-    aux = configuration->property("TelemetryDecoder_2S" + boost::lexical_cast<std::string>(channel) + ".implementation", std::string("W"));
-    std::string appendix3;
-    if(aux.compare("W") != 0)
-        {
-            appendix3 = boost::lexical_cast<std::string>(channel);
-        }
-    else
-        {
-            appendix3 = ""; 
-        }
-
-    std::unique_ptr<GNSSBlockInterface> pass_through_ = GetBlock(configuration, "Channel", "Pass_Through", 1, 1, queue);
-    std::unique_ptr<AcquisitionInterface> acq_ = GetAcqBlock(configuration, "Acquisition_2S" + appendix1 , acq, 1, 0);
-    std::unique_ptr<TrackingInterface> trk_ = GetTrkBlock(configuration, "Tracking_2S" + appendix2, trk, 1, 1);
-    std::unique_ptr<TelemetryDecoderInterface> tlm_ = GetTlmBlock(configuration, "TelemetryDecoder_2S" + appendix3, tlm, 1, 1);
-
-    std::unique_ptr<GNSSBlockInterface> channel_(new Channel(configuration.get(), channel, std::move(pass_through_),
-            std::move(acq_),
-            std::move(trk_),
-            std::move(tlm_),
-            "Channel", "2S", queue));
-
-    return channel_;
-}
-
-//********* GALILEO E1 B CHANNEL *****************
-std::unique_ptr<GNSSBlockInterface> GNSSBlockFactory::GetChannel_1B(
-        std::shared_ptr<ConfigurationInterface> configuration,
-        std::string acq, std::string trk, std::string tlm, int channel,
-        boost::shared_ptr<gr::msg_queue> queue)
-{
-    std::stringstream stream;
-    stream << channel;
-    std::string id = stream.str();
-    LOG(INFO) << "Instantiating Channel " << id << " with Acquisition Implementation: "
-              << acq << ", Tracking Implementation: " << trk  << ", Telemetry Decoder implementation: " << tlm;
-    std::string aux = configuration->property("Acquisition_1B" + boost::lexical_cast<std::string>(channel) + ".implementation", std::string("W"));
-    std::string appendix1;
-    if(aux.compare("W") != 0)
-        {
-            appendix1 = boost::lexical_cast<std::string>(channel);
-        }
-    else
-        {
-            appendix1 = ""; 
-        }
-    aux = configuration->property("Tracking_1B" + boost::lexical_cast<std::string>(channel) + ".implementation", std::string("W"));
-    std::string appendix2;
-    if(aux.compare("W") != 0)
-        {
-            appendix2 = boost::lexical_cast<std::string>(channel);
-        }
-    else
-        {
-            appendix2 = ""; 
-        }
-    aux = configuration->property("TelemetryDecoder_1B" + boost::lexical_cast<std::string>(channel) + ".implementation", std::string("W"));
-    std::string appendix3;
-    if(aux.compare("W") != 0)
-        {
-            appendix3 = boost::lexical_cast<std::string>(channel);
-        }
-    else
-        {
-            appendix3 = ""; 
-        }
-
-    std::unique_ptr<GNSSBlockInterface> pass_through_ = GetBlock(configuration, "Channel", "Pass_Through", 1, 1, queue);
-    std::unique_ptr<AcquisitionInterface> acq_ = GetAcqBlock(configuration, "Acquisition_1B" + appendix1, acq, 1, 0);
-    std::unique_ptr<TrackingInterface> trk_ = GetTrkBlock(configuration, "Tracking_1B" + appendix2, trk, 1, 1);
-    std::unique_ptr<TelemetryDecoderInterface> tlm_ = GetTlmBlock(configuration, "TelemetryDecoder_1B" + appendix3, tlm, 1, 1);
-
-    std::unique_ptr<GNSSBlockInterface> channel_(new Channel(configuration.get(), channel, std::move(pass_through_),
-            std::move(acq_),
-            std::move(trk_),
-            std::move(tlm_),
-            "Channel", "1B", queue));
-
-    return channel_;
-}
-
-//********* GALILEO E5a  CHANNEL *****************
-std::unique_ptr<GNSSBlockInterface> GNSSBlockFactory::GetChannel_5X(
-        std::shared_ptr<ConfigurationInterface> configuration,
-        std::string acq, std::string trk, std::string tlm, int channel,
-        boost::shared_ptr<gr::msg_queue> queue)
-{
-    std::stringstream stream;
-    stream << channel;
-    std::string id = stream.str();
-    LOG(INFO) << "Instantiating Channel " << id << " with Acquisition Implementation: "
-              << acq << ", Tracking Implementation: " << trk  << ", Telemetry Decoder implementation: " << tlm;
-    std::string aux = configuration->property("Acquisition_5X" + boost::lexical_cast<std::string>(channel) + ".implementation", std::string("W"));
-    std::string appendix1;
-    if(aux.compare("W") != 0)
-        {
-            appendix1 = boost::lexical_cast<std::string>(channel);
-        }
-    else
-        {
-            appendix1 = ""; 
-        }
-    aux = configuration->property("Tracking_5X" + boost::lexical_cast<std::string>(channel) + ".implementation", std::string("W"));
-    std::string appendix2;
-    if(aux.compare("W") != 0)
-        {
-            appendix2 = boost::lexical_cast<std::string>(channel);
-        }
-    else
-        {
-            appendix2 = ""; 
-        }
-    aux = configuration->property("TelemetryDecoder_5X" + boost::lexical_cast<std::string>(channel) + ".implementation", std::string("W"));
-    std::string appendix3;
-    if(aux.compare("W") != 0)
-        {
-            appendix3 = boost::lexical_cast<std::string>(channel);
-        }
-    else
-        {
-            appendix3 = ""; 
-        }
-
-    std::unique_ptr<GNSSBlockInterface> pass_through_ = GetBlock(configuration, "Channel", "Pass_Through", 1, 1, queue);
-    std::unique_ptr<AcquisitionInterface> acq_ = GetAcqBlock(configuration, "Acquisition_5X" + appendix1, acq, 1, 0);
-    std::unique_ptr<TrackingInterface> trk_ = GetTrkBlock(configuration, "Tracking_5X" + appendix2, trk, 1, 1);
-    std::unique_ptr<TelemetryDecoderInterface> tlm_ = GetTlmBlock(configuration, "TelemetryDecoder_5X" + appendix3, tlm, 1, 1);
-
-    std::unique_ptr<GNSSBlockInterface> channel_(new Channel(configuration.get(), channel, std::move(pass_through_),
-            std::move(acq_),
-            std::move(trk_),
-            std::move(tlm_),
-            "Channel", "5X", queue));
+            "Channel", signal, queue));
 
     return channel_;
 }
@@ -480,155 +462,65 @@ std::unique_ptr<std::vector<std::unique_ptr<GNSSBlockInterface>>> GNSSBlockFacto
         std::shared_ptr<ConfigurationInterface> configuration, boost::shared_ptr<gr::msg_queue> queue)
 {
     std::string default_implementation = "Pass_Through";
-    std::string tracking_implementation;
-    std::string telemetry_decoder_implementation;
-    std::string acquisition_implementation;
-
-    unsigned int channel_absolute_id = 0;
-
-    unsigned int Channels_1C_count = configuration->property("Channels_1C.count", 0);
-    unsigned int Channels_2S_count = configuration->property("Channels_2S.count", 0);
-    unsigned int Channels_1B_count = configuration->property("Channels_1B.count", 0);
-    unsigned int Channels_5X_count = configuration->property("Channels_5X.count", 0);
-
-    unsigned int total_channels = Channels_1C_count +
-            Channels_2S_count +
-            Channels_1B_count +
-            Channels_5X_count;
-    std::unique_ptr<std::vector<std::unique_ptr<GNSSBlockInterface>>> channels(new std::vector<std::unique_ptr<GNSSBlockInterface>>(total_channels));
 
-    //**************** GPS L1 C/A  CHANNELS **********************
+    // Channels are numbered consecutively across signals, in this order
+    const std::vector<std::pair<std::string, std::string>> signals = {
+            std::make_pair("1C", "GPS L1 C/A"),
+            std::make_pair("2S", "GPS L2C (M)"),
+            std::make_pair("1B", "GALILEO E1 B (I/NAV OS)"),
+            std::make_pair("5X", "GALILEO E5a I (F/NAV OS)") };
 
-    LOG(INFO) << "Getting " << Channels_1C_count << " GPS L1 C/A channels";
-    acquisition_implementation = configuration->property("Acquisition_1C.implementation", default_implementation);
-    tracking_implementation  = configuration->property("Tracking_1C.implementation", default_implementation);
-    telemetry_decoder_implementation = configuration->property("TelemetryDecoder_1C.implementation", default_implementation);
-    
-
-    for (unsigned int i = 0; i < Channels_1C_count; i++)
+    std::vector<unsigned int> counts;
+    unsigned int total_channels = 0;
+    for (unsigned int s = 0; s < signals.size(); s++)
         {
-            //(i.e. Acquisition_1C0.implementation=xxxx)
-            std::string acquisition_implementation_specific = configuration->property(
-                            "Acquisition_1C" + boost::lexical_cast<std::string>(channel_absolute_id) + ".implementation",
-                            acquisition_implementation);
-            //(i.e. Tracking_1C0.implementation=xxxx)
-            std::string tracking_implementation_specific  = configuration->property(
-                            "Tracking_1C" + boost::lexical_cast<std::string>(channel_absolute_id) + ".implementation",
-                            tracking_implementation);
-            std::string  telemetry_decoder_implementation_specific = configuration->property(
-                            "TelemetryDecoder_1C" + boost::lexical_cast<std::string>(channel_absolute_id) + ".implementation",
-                            telemetry_decoder_implementation);
-
-            // Push back the channel to the vector of channels
-             channels->at(channel_absolute_id) = std::move(GetChannel_1C(configuration,
-                     acquisition_implementation_specific,
-                     tracking_implementation_specific,
-                     telemetry_decoder_implementation_specific,
-                     channel_absolute_id,
-                     queue));
-             channel_absolute_id++;
+            counts.push_back(configuration->property("Channels_" + signals.at(s).first + ".count", 0));
+            total_channels += counts.back();
         }
+    std::unique_ptr<std::vector<std::unique_ptr<GNSSBlockInterface>>> channels(new std::vector<std::unique_ptr<GNSSBlockInterface>>(total_channels));
 
-    //**************** GPS L2C (M)  CHANNELS **********************
-    LOG(INFO)<< "Getting " << Channels_2S_count << " GPS L2C (M) channels";
-    tracking_implementation  = configuration->property("Tracking_2S.implementation", default_implementation);
-    telemetry_decoder_implementation = configuration->property("TelemetryDecoder_2S.implementation", default_implementation);
-    acquisition_implementation = configuration->property("Acquisition_2S.implementation", default_implementation);
-    for (unsigned int i = 0; i < Channels_2S_count; i++)
-        {
-            //(i.e. Acquisition_1C0.implementation=xxxx)
-            std::string acquisition_implementation_specific = configuration->property(
-                            "Acquisition_2S" + boost::lexical_cast<std::string>(channel_absolute_id) + ".implementation",
-                            acquisition_implementation);
-            //(i.e. Tracking_1C0.implementation=xxxx)
-            std::string tracking_implementation_specific  = configuration->property(
-                            "Tracking_2S" + boost::lexical_cast<std::string>(channel_absolute_id) + ".implementation",
-                            tracking_implementation);
-            std::string  telemetry_decoder_implementation_specific = configuration->property(
-                            "TelemetryDecoder_2S" + boost::lexical_cast<std::string>(channel_absolute_id) + ".implementation",
-                            telemetry_decoder_implementation);
-
-            // Push back the channel to the vector of channels
-             channels->at(channel_absolute_id) = std::move(GetChannel_2S(configuration,
-                     acquisition_implementation_specific,
-                     tracking_implementation_specific,
-                     telemetry_decoder_implementation_specific,
-                     channel_absolute_id,
-                     queue));
-             channel_absolute_id++;
+    unsigned int channel_absolute_id = 0;
+    for (unsigned int s = 0; s < signals.size(); s++)
+        {
+            const std::string& signal = signals.at(s).first;
+            LOG(INFO) << "Getting " << counts.at(s) << " " << signals.at(s).second << " channels";
+            std::string acq_prefix = "Acquisition_" + signal;
+            std::string trk_prefix = "Tracking_" + signal;
+            std::string tlm_prefix = "TelemetryDecoder_" + signal;
+            std::string acquisition_implementation = configuration->property(acq_prefix + ".implementation", default_implementation);
+            std::string tracking_implementation = configuration->property(trk_prefix + ".implementation", default_implementation);
+            std::string telemetry_decoder_implementation = configuration->property(tlm_prefix + ".implementation", default_implementation);
+
+            for (unsigned int i = 0; i < counts.at(s); i++)
+                {
+                    std::string id = boost::lexical_cast<std::string>(channel_absolute_id);
+                    //(i.e. Acquisition_1C0.implementation=xxxx)
+                    std::string acquisition_implementation_specific = configuration->property(
+                            acq_prefix + id + ".implementation", acquisition_implementation);
+                    //(i.e. Tracking_1C0.implementation=xxxx)
+                    std::string tracking_implementation_specific = configuration->property(
+                            trk_prefix + id + ".implementation", tracking_implementation);
+                    std::string telemetry_decoder_implementation_specific = configuration->property(
+                            tlm_prefix + id + ".implementation", telemetry_decoder_implementation);
+
+                    channels->at(channel_absolute_id) = std::move(GetChannel(configuration, signal,
+                            acquisition_implementation_specific,
+                            tracking_implementation_specific,
+                            telemetry_decoder_implementation_specific,
+                            channel_absolute_id,
+                            queue));
+                    channel_absolute_id++;
+                }
         }
 
-    //**************** GALILEO E1 B (I/NAV OS) CHANNELS **********************
-
-    LOG(INFO) << "Getting " << Channels_1B_count << " GALILEO E1 B (I/NAV OS) channels";
-       tracking_implementation  = configuration->property("Tracking_1B.implementation", default_implementation);
-       telemetry_decoder_implementation = configuration->property("TelemetryDecoder_1B.implementation", default_implementation);
-       acquisition_implementation = configuration->property("Acquisition_1B.implementation", default_implementation);
-       for (unsigned int i = 0; i < Channels_1B_count; i++)
-           {
-               //(i.e. Acquisition_1C0.implementation=xxxx)
-               std::string acquisition_implementation_specific = configuration->property(
-                               "Acquisition_1B" + boost::lexical_cast<std::string>(channel_absolute_id) + ".implementation",
-                               acquisition_implementation);
-               //(i.e. Tracking_1C0.implementation=xxxx)
-               std::string tracking_implementation_specific  = configuration->property(
-                               "Tracking_1B" + boost::lexical_cast<std::string>(channel_absolute_id) + ".implementation",
-                               tracking_implementation);
-               std::string  telemetry_decoder_implementation_specific = configuration->property(
-                               "TelemetryDecoder_1B" + boost::lexical_cast<std::string>(channel_absolute_id) + ".implementation",
-                               telemetry_decoder_implementation);
-
-               // Push back the channel to the vector of channels
-                channels->at(channel_absolute_id) = std::move(GetChannel_1B(configuration,
-                        acquisition_implementation_specific,
-                        tracking_implementation_specific,
-                        telemetry_decoder_implementation_specific,
-                        channel_absolute_id,
-                        queue));
-                channel_absolute_id++;
-           }
-
-
-    //**************** GALILEO E5a I (F/NAV OS)  CHANNELS **********************
-    LOG(INFO) << "Getting " << Channels_5X_count << " GALILEO E5a I (F/NAV OS) channels";
-       tracking_implementation  = configuration->property("Tracking_5X.implementation", default_implementation);
-       telemetry_decoder_implementation = configuration->property("TelemetryDecoder_5X.implementation", default_implementation);
-       acquisition_implementation = configuration->property("Acquisition_5X.implementation", default_implementation);
-       for (unsigned int i = 0; i < Channels_5X_count; i++)
-           {
-               //(i.e. Acquisition_1C0.implementation=xxxx)
-               std::string acquisition_implementation_specific = configuration->property(
-                               "Acquisition_5X" + boost::lexical_cast<std::string>(channel_absolute_id) + ".implementation",
-                               acquisition_implementation);
-               //(i.e. Tracking_1C0.implementation=xxxx)
-               std::string tracking_implementation_specific  = configuration->property(
-                               "Tracking_5X" + boost::lexical_cast<std::string>(channel_absolute_id) + ".implementation",
-                               tracking_implementation);
-               std::string  telemetry_decoder_implementation_specific = configuration->property(
-                               "TelemetryDecoder_5X" + boost::lexical_cast<std::string>(channel_absolute_id) + ".implementation",
-                               telemetry_decoder_implementation);
-
-               // Push back the channel to the vector of channels
-                channels->at(channel_absolute_id) = std::move(GetChannel_5X(configuration,
-                        acquisition_implementation_specific,
-                        tracking_implementation_specific,
-                        telemetry_decoder_implementation_specific,
-                        channel_absolute_id,
-                        queue));
-                channel_absolute_id++;
-           }
-
     return channels;
 }
 
+
 /*
- * Returns the block with the required configuration and implementation
- *
- * PLEASE ADD YOUR NEW BLOCK HERE!!
- *
- * IMPORTANT NOTE: Acquisition, Tracking and telemetry blocks are only included here for testing purposes.
- * To be included in a channel they must be also be included in GetAcqBlock(), GetTrkBlock() and GetTlmBlock()
- * (see below)
+ * Returns the block with the required configuration and implementation.
+ * New blocks are added to GNSSBlockRegistries above; acquisition, tracking,
+ * telemetry decoder and PVT blocks are found here too, for testing purposes.
  */
 std::unique_ptr<GNSSBlockInterface> GNSSBlockFactory::GetBlock(
         std::shared_ptr<ConfigurationInterface> configuration,
@@ -636,566 +528,34 @@ std::unique_ptr<GNSSBlockInterface> GNSSBlockFactory::GetBlock(
         std::string implementation, unsigned int in_streams,
         unsigned int out_streams, boost::shared_ptr<gr::msg_queue> queue)
 {
-    std::unique_ptr<GNSSBlockInterface> block;
-
-    //PASS THROUGH ----------------------------------------------------------------
-    if (implementation.compare("Pass_Through") == 0)
+    const GNSSBlockRegistries& r = registries();
+    if (r.blocks.find(implementation) != nullptr)
         {
-            std::unique_ptr<GNSSBlockInterface> block_(new Pass_Through(configuration.get(), role, in_streams, out_streams));
-            block = std::move(block_);
+            return make_from(r.blocks, configuration, role, implementation, in_streams, out_streams, queue);
         }
-
-    // SIGNAL SOURCES -------------------------------------------------------------
-    else if (implementation.compare("File_Signal_Source") == 0)
-        {
-            try
-            {
-                    std::unique_ptr<GNSSBlockInterface> block_(new FileSignalSource(configuration.get(), role, in_streams,
-                            out_streams, queue));
-                    block = std::move(block_);
-            }
-
-            catch (const std::exception &e)
-            {
-                    std::cout << "GNSS-SDR program ended." << std::endl;
-                    exit(1);
-            }
-        }
-    else if (implementation.compare("Nsr_File_Signal_Source") == 0)
+    if (r.acquisition.find(implementation) != nullptr)
         {
-            try
-            {
-                    std::unique_ptr<GNSSBlockInterface> block_(new NsrFileSignalSource(configuration.get(), role, in_streams,
-                            out_streams, queue));
-                    block = std::move(block_);
-
-            }
-            catch (const std::exception &e)
-            {
-                    std::cout << "GNSS-SDR program ended." << std::endl;
-                    exit(1);
-            }
+            return make_from(r.acquisition, configuration, role, implementation, in_streams, out_streams, queue);
         }
-#if MODERN_GNURADIO
-    else if (implementation.compare("Two_Bit_Cpx_File_Signal_Source") == 0)
+    if (r.tracking.find(implementation) != nullptr)
         {
-            try
-            {
-                    std::unique_ptr<GNSSBlockInterface> block_(new TwoBitCpxFileSignalSource(configuration.get(), role, in_streams,
-                            out_streams, queue));
-                    block = std::move(block_);
-
-            }
-            catch (const std::exception &e)
-            {
-                    std::cout << "GNSS-SDR program ended." << std::endl;
-                    exit(1);
-            }
+            return make_from(r.tracking, configuration, role, implementation, in_streams, out_streams, queue);
         }
-    else if(implementation.compare("Two_Bit_Packed_File_Signal_Source") == 0 )
+    if (r.telemetry.find(implementation) != nullptr)
         {
-            try
-            {
-                std::unique_ptr<GNSSBlockInterface> block_(new TwoBitPackedFileSignalSource(configuration.get(), role, in_streams,
-                            out_streams, queue));
-                block = std::move(block_);
-            }
-            catch(const std::exception &e)
-            {
-                std::cout << "GNSS-SDR program ended." << std::endl;
-                exit(1);
-            }
+            return make_from(r.telemetry, configuration, role, implementation, in_streams, out_streams, queue);
         }
-#endif
-    else if (implementation.compare("Spir_File_Signal_Source") == 0)
-        {
-            try
-            {
-                    std::unique_ptr<GNSSBlockInterface> block_(new SpirFileSignalSource(configuration.get(), role, in_streams,
-                            out_streams, queue));
-                    block = std::move(block_);
-
-            }
-            catch (const std::exception &e)
-            {
-                    std::cout << "GNSS-SDR program ended." << std::endl;
-                    exit(1);
-            }
-        }
-    else if (implementation.compare("RtlTcp_Signal_Source") == 0)
-        {
-            try
-            {
-                    std::unique_ptr<GNSSBlockInterface> block_(new RtlTcpSignalSource(configuration.get(), role, in_streams,
-                            out_streams, queue));
-                    block = std::move(block_);
-
-            }
-            catch (const std::exception &e)
-            {
-                    std::cout << "GNSS-SDR program ended." << std::endl;
-                    exit(1);
-            }
-        }
-#if UHD_DRIVER
-    else if (implementation.compare("UHD_Signal_Source") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new UhdSignalSource(configuration.get(), role, in_streams,
-                    out_streams, queue));
-            block = std::move(block_);
-        }
-#endif
-#if GN3S_DRIVER
-    else if (implementation.compare("GN3S_Signal_Source") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new Gn3sSignalSource(configuration.get(), role, in_streams,
-                    out_streams, queue));
-            block = std::move(block_);
-        }
-#endif
-
-#if RAW_ARRAY_DRIVER
-    else if (implementation.compare("Raw_Array_Signal_Source") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new RawArraySignalSource(configuration.get(), role, in_streams,
-                    out_streams, queue));
-            block = std::move(block_);
-        }
-#endif
-
-#if OSMOSDR_DRIVER
-    else if (implementation.compare("Osmosdr_Signal_Source") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new OsmosdrSignalSource(configuration.get(), role, in_streams,
-                    out_streams, queue));
-            block = std::move(block_);
-        }
-#endif
-
-#if FLEXIBAND_DRIVER
-    else if (implementation.compare("Flexiband_Signal_Source") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new FlexibandSignalSource(configuration.get(), role, in_streams,
-                    out_streams, queue));
-            block = std::move(block_);
-        }
-#endif
-
-    // DATA TYPE ADAPTER -----------------------------------------------------------
-    else if (implementation.compare("Byte_To_Short") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface>block_(new ByteToShort(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("Ibyte_To_Cbyte") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface>block_(new IbyteToCbyte(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("Ibyte_To_Cshort") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface>block_(new IbyteToCshort(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("Ibyte_To_Complex") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface>block_(new IbyteToComplex(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("Ishort_To_Cshort") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface>block_(new IshortToCshort(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("Ishort_To_Complex") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface>block_(new IshortToComplex(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-
-    // INPUT FILTER ----------------------------------------------------------------
-    else if (implementation.compare("Fir_Filter") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new FirFilter(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("Freq_Xlating_Fir_Filter") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new FreqXlatingFirFilter(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("Beamformer_Filter") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new BeamformerFilter(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-
-    // RESAMPLER -------------------------------------------------------------------
-    else if (implementation.compare("Direct_Resampler") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new DirectResamplerConditioner(configuration.get(), role,
-                    in_streams, out_streams));
-            block = std::move(block_);
-        }
-
-    // ACQUISITION BLOCKS ---------------------------------------------------------
-    else if (implementation.compare("GPS_L1_CA_PCPS_Acquisition") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new GpsL1CaPcpsAcquisition(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("GPS_L1_CA_PCPS_SD_Acquisition") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new GpsL1CaPcpsSdAcquisition(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("GPS_L1_CA_PCPS_Assisted_Acquisition") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new GpsL1CaPcpsAssistedAcquisition(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("GPS_L1_CA_PCPS_Tong_Acquisition") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new GpsL1CaPcpsTongAcquisition(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("GPS_L1_CA_PCPS_Multithread_Acquisition") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new GpsL1CaPcpsMultithreadAcquisition(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-
-#if OPENCL_BLOCKS
-    else if (implementation.compare("GPS_L1_CA_PCPS_OpenCl_Acquisition") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new GpsL1CaPcpsOpenClAcquisition(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-#endif
-
-    else if (implementation.compare("GPS_L1_CA_PCPS_Acquisition_Fine_Doppler") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new GpsL1CaPcpsAcquisitionFineDoppler(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("GPS_L1_CA_PCPS_QuickSync_Acquisition") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_( new GpsL1CaPcpsQuickSyncAcquisition(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("Galileo_E1_PCPS_Ambiguous_Acquisition") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new GalileoE1PcpsAmbiguousAcquisition(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("Galileo_E1_PCPS_8ms_Ambiguous_Acquisition") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new GalileoE1Pcps8msAmbiguousAcquisition(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("Galileo_E1_PCPS_Tong_Ambiguous_Acquisition") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new GalileoE1PcpsTongAmbiguousAcquisition(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("Galileo_E1_PCPS_CCCWSR_Ambiguous_Acquisition") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new GalileoE1PcpsCccwsrAmbiguousAcquisition(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("Galileo_E5a_Noncoherent_IQ_Acquisition_CAF") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new GalileoE5aNoncoherentIQAcquisitionCaf(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("Galileo_E1_PCPS_QuickSync_Ambiguous_Acquisition") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_( new GalileoE1PcpsQuickSyncAmbiguousAcquisition(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-
-
-
-
-    // TRACKING BLOCKS -------------------------------------------------------------
-    else if (implementation.compare("GPS_L1_CA_DLL_PLL_Tracking") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new GpsL1CaDllPllTracking(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("GPS_L1_CA_DLL_PLL_C_Aid_Tracking") == 0)
-        {
-            std::unique_ptr<TrackingInterface> block_(new GpsL1CaDllPllCAidTracking(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("GPS_L1_CA_TCP_CONNECTOR_Tracking") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new GpsL1CaTcpConnectorTracking(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("GPS_L2_M_DLL_PLL_Tracking") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new GpsL2MDllPllTracking(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-#if CUDA_GPU_ACCEL
-    else if (implementation.compare("GPS_L1_CA_DLL_PLL_Tracking_GPU") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new GpsL1CaDllPllTrackingGPU(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-#endif
-    else if (implementation.compare("Galileo_E1_DLL_PLL_VEML_Tracking") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new GalileoE1DllPllVemlTracking(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("Galileo_E1_TCP_CONNECTOR_Tracking") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new GalileoE1TcpConnectorTracking(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("Galileo_E5a_DLL_PLL_Tracking") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new GalileoE5aDllPllTracking(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-
-    // TELEMETRY DECODERS ----------------------------------------------------------
-    else if (implementation.compare("GPS_L1_CA_Telemetry_Decoder") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new GpsL1CaTelemetryDecoder(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("GPS_L1_CA_SD_Telemetry_Decoder") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new GpsL1CaSdTelemetryDecoder(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("Galileo_E1B_Telemetry_Decoder") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new GalileoE1BTelemetryDecoder(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("SBAS_L1_Telemetry_Decoder") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new SbasL1TelemetryDecoder(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("Galileo_E5a_Telemetry_Decoder") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new GalileoE5aTelemetryDecoder(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-
-    // OBSERVABLES -----------------------------------------------------------------
-    else if (implementation.compare("GPS_L1_CA_Observables") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new GpsL1CaObservables(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-
-    else if (implementation.compare("Galileo_E1B_Observables") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new GalileoE1Observables(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("Hybrid_Observables") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new HybridObservables(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    // PVT -------------------------------------------------------------------------
-    else if (implementation.compare("GPS_L1_CA_PVT") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new GpsL1CaPvt(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("GPS_L1_CA_SD_PVT") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new GpsL1CaSdPvt(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("GALILEO_E1_PVT") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new GalileoE1Pvt(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("Hybrid_PVT") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new HybridPvt(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else
-        {
-            // Log fatal. This causes execution to stop.
-            LOG(ERROR) << role << "." << implementation << ": Undefined implementation for block";
-        }
-    return std::move(block);
+    return make_from(r.pvt, configuration, role, implementation, in_streams, out_streams, queue);
 }
 
 
-
-/*
- *
- * PLEASE ADD YOUR NEW BLOCK HERE!!
- *
- * Not very elegant, Acq, Trk and Tlm blocks must be added here, too.
- * To be improved!
- */
-
 std::unique_ptr<AcquisitionInterface> GNSSBlockFactory::GetAcqBlock(
         std::shared_ptr<ConfigurationInterface> configuration,
         std::string role,
         std::string implementation, unsigned int in_streams,
         unsigned int out_streams)
 {
-    std::unique_ptr<AcquisitionInterface> block;
-    // ACQUISITION BLOCKS ---------------------------------------------------------
-    if (implementation.compare("GPS_L1_CA_PCPS_Acquisition") == 0)
-        {
-            std::unique_ptr<AcquisitionInterface> block_(new GpsL1CaPcpsAcquisition(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("GPS_L1_CA_PCPS_SD_Acquisition") == 0)
-        {
-            std::unique_ptr<AcquisitionInterface> block_(new GpsL1CaPcpsSdAcquisition(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("GPS_L1_CA_PCPS_Assisted_Acquisition") == 0)
-        {
-            std::unique_ptr<AcquisitionInterface> block_(new GpsL1CaPcpsAssistedAcquisition(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("GPS_L1_CA_PCPS_Tong_Acquisition") == 0)
-        {
-            std::unique_ptr<AcquisitionInterface> block_(new GpsL1CaPcpsTongAcquisition(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("GPS_L1_CA_PCPS_Multithread_Acquisition") == 0)
-        {
-            std::unique_ptr<AcquisitionInterface> block_(new GpsL1CaPcpsMultithreadAcquisition(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-
-#if OPENCL_BLOCKS
-    else if (implementation.compare("GPS_L1_CA_PCPS_OpenCl_Acquisition") == 0)
-        {
-            std::unique_ptr<AcquisitionInterface> block_(new GpsL1CaPcpsOpenClAcquisition(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-#endif
-
-    else if (implementation.compare("GPS_L1_CA_PCPS_Acquisition_Fine_Doppler") == 0)
-        {
-            std::unique_ptr<AcquisitionInterface> block_(new GpsL1CaPcpsAcquisitionFineDoppler(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("GPS_L1_CA_PCPS_QuickSync_Acquisition") == 0)
-        {
-            std::unique_ptr<AcquisitionInterface> block_( new GpsL1CaPcpsQuickSyncAcquisition(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("GPS_L2_M_PCPS_Acquisition") == 0)
-        {
-            std::unique_ptr<AcquisitionInterface> block_(new GpsL2MPcpsAcquisition(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("Galileo_E1_PCPS_Ambiguous_Acquisition") == 0)
-        {
-            std::unique_ptr<AcquisitionInterface> block_(new GalileoE1PcpsAmbiguousAcquisition(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("Galileo_E1_PCPS_8ms_Ambiguous_Acquisition") == 0)
-        {
-            std::unique_ptr<AcquisitionInterface> block_(new GalileoE1Pcps8msAmbiguousAcquisition(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("Galileo_E1_PCPS_Tong_Ambiguous_Acquisition") == 0)
-        {
-            std::unique_ptr<AcquisitionInterface> block_(new GalileoE1PcpsTongAmbiguousAcquisition(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("Galileo_E1_PCPS_CCCWSR_Ambiguous_Acquisition") == 0)
-        {
-            std::unique_ptr<AcquisitionInterface> block_(new GalileoE1PcpsCccwsrAmbiguousAcquisition(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-
-    else if (implementation.compare("Galileo_E1_PCPS_QuickSync_Ambiguous_Acquisition") == 0)
-        {
-            std::unique_ptr<AcquisitionInterface> block_( new GalileoE1PcpsQuickSyncAmbiguousAcquisition(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("Galileo_E5a_Noncoherent_IQ_Acquisition_CAF") == 0)
-        {
-            std::unique_ptr<AcquisitionInterface> block_(new GalileoE5aNoncoherentIQAcquisitionCaf(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else
-        {
-            // Log fatal. This causes execution to stop.
-            LOG(ERROR) << role << "." << implementation << ": Undefined implementation for block";
-        }
-    return std::move(block);
+    return make_from(registries().acquisition, configuration, role, implementation, in_streams, out_streams, nullptr);
 }
 
 
@@ -1205,65 +565,7 @@ std::unique_ptr<TrackingInterface> GNSSBlockFactory::GetTrkBlock(
         std::string implementation, unsigned int in_streams,
         unsigned int out_streams)
 {
-    std::unique_ptr<TrackingInterface> block;
-
-    // TRACKING BLOCKS -------------------------------------------------------------
-    if (implementation.compare("GPS_L1_CA_DLL_PLL_Tracking") == 0)
-        {
-            std::unique_ptr<TrackingInterface> block_(new GpsL1CaDllPllTracking(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("GPS_L1_CA_DLL_PLL_C_Aid_Tracking") == 0)
-        {
-            std::unique_ptr<TrackingInterface> block_(new GpsL1CaDllPllCAidTracking(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("GPS_L1_CA_TCP_CONNECTOR_Tracking") == 0)
-        {
-            std::unique_ptr<TrackingInterface> block_(new GpsL1CaTcpConnectorTracking(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("Galileo_E1_DLL_PLL_VEML_Tracking") == 0)
-        {
-            std::unique_ptr<TrackingInterface> block_(new GalileoE1DllPllVemlTracking(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("Galileo_E1_TCP_CONNECTOR_Tracking") == 0)
-        {
-            std::unique_ptr<TrackingInterface> block_(new GalileoE1TcpConnectorTracking(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("Galileo_E5a_DLL_PLL_Tracking") == 0)
-        {
-            std::unique_ptr<TrackingInterface> block_(new GalileoE5aDllPllTracking(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("GPS_L2_M_DLL_PLL_Tracking") == 0)
-        {
-            std::unique_ptr<TrackingInterface> block_(new GpsL2MDllPllTracking(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-#if CUDA_GPU_ACCEL
-    else if (implementation.compare("GPS_L1_CA_DLL_PLL_Tracking_GPU") == 0)
-        {
-            std::unique_ptr<TrackingInterface> block_(new GpsL1CaDllPllTrackingGPU(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-#endif
-    else
-        {
-            // Log fatal. This causes execution to stop.
-            LOG(ERROR) << role << "." << implementation << ": Undefined implementation for block";
-        }
-    return std::move(block);
+    return make_from(registries().tracking, configuration, role, implementation, in_streams, out_streams, nullptr);
 }
 
 
@@ -1273,89 +575,28 @@ std::unique_ptr<TelemetryDecoderInterface> GNSSBlockFactory::GetTlmBlock(
         std::string implementation, unsigned int in_streams,
         unsigned int out_streams)
 {
-    std::unique_ptr<TelemetryDecoderInterface> block;
-    
-    // TELEMETRY DECODERS ----------------------------------------------------------
-    if (implementation.compare("GPS_L1_CA_Telemetry_Decoder") == 0)
-        {
-            std::unique_ptr<TelemetryDecoderInterface> block_(new GpsL1CaTelemetryDecoder(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("GPS_L1_CA_SD_Telemetry_Decoder") == 0)
-        {
-            std::unique_ptr<TelemetryDecoderInterface> block_(new GpsL1CaSdTelemetryDecoder(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("Galileo_E1B_Telemetry_Decoder") == 0)
-        {
-            std::unique_ptr<TelemetryDecoderInterface> block_(new GalileoE1BTelemetryDecoder(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("SBAS_L1_Telemetry_Decoder") == 0)
-        {
-            std::unique_ptr<TelemetryDecoderInterface> block_(new SbasL1TelemetryDecoder(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("Galileo_E5a_Telemetry_Decoder") == 0)
-        {
-            std::unique_ptr<TelemetryDecoderInterface> block_(new GalileoE5aTelemetryDecoder(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("GPS_L2_M_Telemetry_Decoder") == 0)
-        {
-            std::unique_ptr<TelemetryDecoderInterface> block_(new GpsL2MTelemetryDecoder(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else
-        {
-            // Log fatal. This causes execution to stop.
-            LOG(ERROR) << role << "." << implementation << ": Undefined implementation for block";
-        }
-    return std::move(block);
+    return make_from(registries().telemetry, configuration, role, implementation, in_streams, out_streams, nullptr);
 }
 
+
 std::unique_ptr<PvtInterface> GNSSBlockFactory::GetPVTBlock(
         std::shared_ptr<ConfigurationInterface> configuration,
         std::string role,
         std::string implementation, unsigned int in_streams,
         unsigned int out_streams)
 {
-    std::unique_ptr<PvtInterface> block;
-    // PVT -------------------------------------------------------------------------
-    if (implementation.compare("GPS_L1_CA_PVT") == 0)
-        {
-            std::unique_ptr<PvtInterface> block_(new GpsL1CaPvt(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("GPS_L1_CA_SD_PVT") == 0)
-        {
-            std::unique_ptr<PvtInterface> block_(new GpsL1CaSdPvt(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("GALILEO_E1_PVT") == 0)
-        {
-            std::unique_ptr<PvtInterface> block_(new GalileoE1Pvt(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("Hybrid_PVT") == 0)
-        {
-            std::unique_ptr<PvtInterface> block_(new HybridPvt(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else
+    return make_from(registries().pvt, configuration, role, implementation, in_streams, out_streams, nullptr);
+}
+
+
+std::vector<std::string> GNSSBlockFactory::Implementations()
+{
+    const GNSSBlockRegistries& r = registries();
+    std::vector<std::string> names = r.blocks.names();
+    std::vector<std::string> more[] = { r.acquisition.names(), r.tracking.names(), r.telemetry.names(), r.pvt.names() };
+    for (unsigned int i = 0; i < 4; i++)
         {
-            // Log fatal. This causes execution to stop.
-            LOG(ERROR) << role << "." << implementation << ": Undefined implementation for block";
+            names.insert(names.end(), more[i].begin(), more[i].end());
         }
-    return std::move(block);
+    return names;
 }
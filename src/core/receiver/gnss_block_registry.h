@@ -0,0 +1,130 @@
+/*!
+ * \file gnss_block_registry.h
+ * \brief Table from implementation name to block constructor, used by
+ * GNSSBlockFactory instead of a chain of string comparisons.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_GNSS_BLOCK_REGISTRY_H_
+#define GNSS_SDR_GNSS_BLOCK_REGISTRY_H_
+
+#include <algorithm>
+#include <cstdlib>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <gnuradio/msg_queue.h>
+
+class ConfigurationInterface;
+
+/*!
+ * \brief Constructors of the blocks that implement one interface, by
+ * implementation name.
+ *
+ * Every maker has the same signature so that a single table can hold all
+ * adapters; the queue is only used by signal sources. The registries used by
+ * GNSSBlockFactory are filled once on first use and are read-only afterwards,
+ * so lookups need no locking.
+ */
+template <class Interface>
+class GNSSBlockRegistry
+{
+public:
+    typedef std::function<std::unique_ptr<Interface>(ConfigurationInterface* configuration,
+            const std::string& role, unsigned int in_streams, unsigned int out_streams,
+            boost::shared_ptr<gr::msg_queue> queue)> Maker;
+
+    void add(const std::string& implementation, Maker maker)
+    {
+        makers_[implementation] = maker;
+    }
+
+    //! Null if the implementation is not registered
+    const Maker* find(const std::string& implementation) const
+    {
+        typename std::unordered_map<std::string, Maker>::const_iterator it = makers_.find(implementation);
+        if (it == makers_.end())
+            {
+                return nullptr;
+            }
+        return &it->second;
+    }
+
+    std::vector<std::string> names() const
+    {
+        std::vector<std::string> names;
+        for (typename std::unordered_map<std::string, Maker>::const_iterator it = makers_.begin(); it != makers_.end(); ++it)
+            {
+                names.push_back(it->first);
+            }
+        std::sort(names.begin(), names.end());
+        return names;
+    }
+
+private:
+    std::unordered_map<std::string, Maker> makers_;
+};
+
+
+//! Maker of an adapter constructed as Block(configuration, role, in_streams, out_streams)
+template <class Block, class Interface>
+std::unique_ptr<Interface> make_gnss_block(ConfigurationInterface* configuration, const std::string& role,
+        unsigned int in_streams, unsigned int out_streams, boost::shared_ptr<gr::msg_queue> /*queue*/)
+{
+    return std::unique_ptr<Interface>(new Block(configuration, role, in_streams, out_streams));
+}
+
+
+//! Maker of a signal source, which also takes the control queue
+template <class Block, class Interface>
+std::unique_ptr<Interface> make_gnss_source(ConfigurationInterface* configuration, const std::string& role,
+        unsigned int in_streams, unsigned int out_streams, boost::shared_ptr<gr::msg_queue> queue)
+{
+    return std::unique_ptr<Interface>(new Block(configuration, role, in_streams, out_streams, queue));
+}
+
+
+//! Maker of a file signal source: the receiver cannot run if the file cannot be opened
+template <class Block, class Interface>
+std::unique_ptr<Interface> make_gnss_file_source(ConfigurationInterface* configuration, const std::string& role,
+        unsigned int in_streams, unsigned int out_streams, boost::shared_ptr<gr::msg_queue> queue)
+{
+    try
+    {
+            return std::unique_ptr<Interface>(new Block(configuration, role, in_streams, out_streams, queue));
+    }
+    catch (const std::exception &e)
+    {
+            std::cout << "GNSS-SDR program ended." << std::endl;
+            exit(1);
+    }
+}
+
+#endif
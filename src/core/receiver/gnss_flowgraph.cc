@@ -36,10 +36,10 @@
  */
 
 #include "gnss_flowgraph.h"
-#include "unistd.h"
 
 #include <memory>
 #include <algorithm>
+#include <chrono>
 #include <exception>
 #include <iostream>
 #include <set>
@@ -49,7 +49,11 @@
 #include "configuration_interface.h"
 #include "gnss_block_interface.h"
 #include "channel_interface.h"
+#include "channel.h"
+#include "gnss_sdr_channel_gate.h"
+#include "gps_l1_ca_observables_cc.h"
 #include "gnss_block_factory.h"
+#include "gnss_sdr_shared_tables.h"
 #include "concurrent_map.h"
 
 #define GNSS_SDR_ARRAY_SIGNAL_CONDITIONER_CHANNELS 8
@@ -76,12 +80,26 @@ GNSSFlowgraph::GNSSFlowgraph(std::shared_ptr<ConfigurationInterface> configurati
 {
     connected_ = false;
     running_ = false;
+    dynamic_channels_ = false;
     configuration_ = configuration;
     queue_ = queue;
     init();
 }
 
 
+GNSSFlowgraph::GNSSFlowgraph(std::shared_ptr<ConfigurationInterface> configuration,
+        boost::shared_ptr<gr::msg_queue> queue, std::shared_ptr<GNSSFlowgraph> host)
+{
+    connected_ = false;
+    running_ = false;
+    dynamic_channels_ = false;
+    configuration_ = configuration;
+    queue_ = queue;
+    host_ = host;
+    init();
+}
+
+
 GNSSFlowgraph::~GNSSFlowgraph()
 {}
 
@@ -96,7 +114,11 @@ void GNSSFlowgraph::start()
 
     try
     {
-            top_block_->start();
+            // a hosted receiver runs in the top block of its host
+            if (!host_)
+                {
+                    top_block_->start();
+                }
     }
     catch (std::exception& e)
     {
@@ -114,10 +136,13 @@ void GNSSFlowgraph::stop()
     //    for (unsigned int i = 0; i < channels_count_; i++)
     //        {
     //            channels_.at(i)->stop_channel();
-    //            LOG(INFO) << "Channel " << i << " in state " << channels_state_[i];
+    //            LOG(INFO) << "Channel " << i << " in state " << scheduler_.get_state(i);
     //        }
     //    LOG(INFO) << "Threads finished. Return to main program.";
-    top_block_->stop();
+    if (!host_)
+        {
+            top_block_->stop();
+        }
     running_ = false;
 }
 
@@ -151,7 +176,9 @@ void GNSSFlowgraph::connect()
         }
 
     // Signal Source > Signal conditioner >
-    for (unsigned int i = 0; i < sig_conditioner_.size(); i++)
+    // (the conditioners of a hosted receiver are connected by its host)
+    unsigned int own_conditioners = host_ ? 0 : sig_conditioner_.size();
+    for (unsigned int i = 0; i < own_conditioners; i++)
         {
             try
             {
@@ -171,7 +198,6 @@ void GNSSFlowgraph::connect()
             try
             {
                     channels_.at(i)->connect(top_block_);
-                    acquired_state[i] = 0;
             }
             catch (std::exception& e)
             {
@@ -222,7 +248,8 @@ void GNSSFlowgraph::connect()
                         {
                             //Multichannel Array
                             std::cout << "ARRAY MODE" << std::endl;
-                            for (int j = 0; j < GNSS_SDR_ARRAY_SIGNAL_CONDITIONER_CHANNELS; j++)
+                            int array_channels = configuration_->property(sig_source_.at(i)->role() + ".channels", GNSS_SDR_ARRAY_SIGNAL_CONDITIONER_CHANNELS);
+                            for (int j = 0; j < array_channels; j++)
                                 {
                                     std::cout << "connecting ch " << j << std::endl;
                                     top_block_->connect(sig_source_.at(i)->get_right_block(), j, sig_conditioner_.at(i)->get_left_block(), j);
@@ -313,27 +340,15 @@ void GNSSFlowgraph::connect()
                     return;
             }
 
-            std::string gnss_signal = channels_.at(i)->get_signal().get_signal_str(); // use channel's implicit signal!
-            while (gnss_signal.compare(available_GNSS_signals_.front().get_signal_str()) != 0 )
-                {
-                    available_GNSS_signals_.push_back(available_GNSS_signals_.front());
-                    available_GNSS_signals_.pop_front();
-                }
-            channels_.at(i)->set_signal(available_GNSS_signals_.front());
-
-            LOG(INFO) << "Channel " << i << " assigned to " << available_GNSS_signals_.front();
-            AssignACQState(available_GNSS_signals_.front().get_satellite().get_PRN(), i);
-            available_GNSS_signals_.pop_front();
-
-            if (channels_state_[i] == 1)
+            // standby channels keep their implicit signal until they are activated
+            if (scheduler_.get_state(i) == 1 && acquire_next_signal(i))
                 {
-                    channels_.at(i)->start_acquisition();
-                    available_GNSS_signals_.pop_front();
-                    LOG(INFO) << "Channel " << i << " assigned to " << available_GNSS_signals_.front();
                     LOG(INFO) << "Channel " << i << " connected to observables and ready for acquisition";
                 }
             else
                 {
+                    scheduler_.set_state(i, 0);
+                    park_channel(i);
                     LOG(INFO) << "Channel " << i << " connected to observables in standby mode";
                 }
         }
@@ -357,6 +372,8 @@ void GNSSFlowgraph::connect()
             return;
     }
 
+    apply_layout();
+
     connected_ = true;
     LOG(INFO) << "Flowgraph connected";
     top_block_->dump();
@@ -370,7 +387,14 @@ void GNSSFlowgraph::wait()
             LOG(WARNING) << "Can't apply wait. Flowgraph is not running";
             return;
         }
-    top_block_->wait();
+    if (host_)
+        {
+            host_->wait();
+        }
+    else
+        {
+            top_block_->wait();
+        }
     DLOG(INFO) << "Flowgraph finished calculations";
     running_ = false;
 }
@@ -384,27 +408,99 @@ bool GNSSFlowgraph::send_telemetry_msg(pmt::pmt_t msg)
     return true;
 } 
 
+/*
+ * Pins the blocks to the cores given in the Layout.* section, sets their
+ * priorities and output buffer sizes, and logs the result. Must run before
+ * the flowgraph starts.
+ */
+void GNSSFlowgraph::apply_layout()
+{
+    if (!layout_->enabled())
+        {
+            return;
+        }
+    for (unsigned int i = 0; i < sig_source_.size(); i++)
+        {
+            layout_->apply("source", sig_source_.at(i), "SignalSource" + boost::lexical_cast<std::string>(i));
+        }
+    for (unsigned int i = 0; i < sig_conditioner_.size() && !host_; i++)
+        {
+            layout_->apply("source", sig_conditioner_.at(i), "SignalConditioner" + boost::lexical_cast<std::string>(i));
+        }
+    for (unsigned int i = 0; i < channels_count_; i++)
+        {
+            std::string name = "Channel" + boost::lexical_cast<std::string>(i);
+            std::shared_ptr<Channel> channel = std::dynamic_pointer_cast<Channel>(channels_.at(i));
+            if (!channel)
+                {
+                    layout_->apply("tracking", channels_.at(i), name, i);
+                    continue;
+                }
+            layout_->apply("tracking", channel->get_left_block(), name + " input", i);
+            layout_->apply("acquisition", channel->acquisition(), name + " acquisition", i);
+            layout_->apply("tracking", channel->tracking(), name + " tracking", i);
+            layout_->apply("pvt", channel->telemetry(), name + " telemetry", i);
+        }
+    layout_->apply("pvt", observables_, "Observables");
+    layout_->apply("pvt", pvt_, "PVT");
+
+    std::cout << "Receiver layout:" << std::endl;
+    for (unsigned int i = 0; i < layout_->applied().size(); i++)
+        {
+            LOG(INFO) << "Layout " << layout_->applied().at(i);
+            std::cout << "  " << layout_->applied().at(i) << std::endl;
+        }
+}
+
+
 // Assigns which peak a channel should acquire
 void GNSSFlowgraph::AssignACQState(int PRN, unsigned int who)
 {
-    DLOG(INFO) << "assign peak ";
-    DLOG(INFO) << "nr acq peak " << nr_acquired_peaks.at(PRN);
-    if(nr_acquired_peaks.at(PRN) < nr_acq )
-        {
-            //find highest peak that is not being tracked.
-            nr_acquired_peaks.at(PRN) += 1;
-            int peak = next_peak.at(PRN);
-            if(peak > 5)
-                peak = 1;
-            next_peak.at(PRN) = peak+1;
+    int peak = scheduler_.assign_peak(PRN, who);
+    DLOG(INFO) << "nr acq peak " << scheduler_.acquiring(PRN);
+    if (peak > 0)
+        {
             channels_.at(who)->set_peak(peak);
-            channel_to_peak[who] = peak;
         }
     else
         {
             DLOG(INFO) <<  "Satellite "<< PRN << " should not be acquired again";
-            DLOG(INFO) << nr_acquired_peaks.at(PRN); 
+        }
+}
 
+
+/*
+ * Gives the channel the next pending signal of its type (and, under APT, the
+ * next peak of that satellite) and restarts its acquisition
+ */
+bool GNSSFlowgraph::acquire_next_signal(unsigned int who)
+{
+    Gnss_Signal signal;
+    if (!scheduler_.next(who, channels_.at(who)->get_signal().get_signal_str(), signal))
+        {
+            LOG(INFO) << "No pending signals of type " << channels_.at(who)->get_signal().get_signal_str() << " for channel " << who;
+            return false;
+        }
+    channels_.at(who)->set_signal(signal);
+    LOG(INFO) << "Channel " << who << " assigned to " << signal;
+    if (spoofing_detection)
+        {
+            AssignACQState(signal.get_satellite().get_PRN(), who);
+        }
+    channels_.at(who)->start_acquisition();
+    return true;
+}
+
+
+/*
+ * In a dynamic channel pool, a standby channel stops receiving samples until
+ * it is given work again
+ */
+void GNSSFlowgraph::park_channel(unsigned int who)
+{
+    if (dynamic_channels_ && channels_.at(who)->park())
+        {
+            LOG(INFO) << "Channel " << who << " parked";
         }
 }
 
@@ -418,29 +514,20 @@ void GNSSFlowgraph::apply_action(unsigned int who, unsigned int what)
 {
     DLOG(INFO) << "received " << what << " from " << who;
 
-    int PRN, lost_PRN, acq_PRN, nr_acq_peaks, peak;
-    int inactive;
-    bool acquire_sat_again = false;
-    PRN =  channels_.at(who)->get_signal().get_satellite().get_PRN();
+    int PRN =  channels_.at(who)->get_signal().get_satellite().get_PRN();
     unsigned int uid;
-    
-    if(spoofing_detection)
-    {
-        peak = channel_to_peak.find(who)->second;
-        std::deque<int> acq_peaks; 
-    }
+    unsigned int standby;
 
     switch (what)
     {
     case 0:
         LOG(INFO) << "Channel " << who << " ACQ FAILED satellite " << channels_.at(who)->get_signal().get_satellite() << ", Signal " << channels_.at(who)->get_signal().get_signal_str();
-        lost_PRN =  channels_.at(who)->get_signal().get_satellite().get_PRN();
         channels_.at(who)->set_state(2);
-      
+
         if(spoofing_detection)
             {
-                next_peak.at(PRN) = 1; 
-                nr_acquired_peaks.at(lost_PRN) -= 1;
+                // the satellite starts again from its strongest peak
+                scheduler_.peak_lost(who, true);
                 channels_.at(who)->set_peak(0);
 
                 //remove cannel from spoofing detection queues
@@ -450,157 +537,91 @@ void GNSSFlowgraph::apply_action(unsigned int who, unsigned int what)
                 global_gps_time.remove(uid);
             }
 
-        available_GNSS_signals_.push_back(channels_.at(who)->get_signal());
-        //TODO: Optimize the channel and signal matching!
-        while ( channels_.at(who)->get_signal().get_signal_str().compare(available_GNSS_signals_.front().get_signal_str()) != 0 )
-            {
-                available_GNSS_signals_.push_back(available_GNSS_signals_.front());
-                available_GNSS_signals_.pop_front();
-            }
-
-        PRN = available_GNSS_signals_.front().get_satellite().get_PRN();
-        if(spoofing_detection)
+        scheduler_.push_back(channels_.at(who)->get_signal());
+        if (!acquire_next_signal(who))
             {
-                AssignACQState(PRN, who);
+                scheduler_.set_state(who, 0);
+                park_channel(who);
             }
-
-        channels_.at(who)->set_signal(available_GNSS_signals_.front());
-        available_GNSS_signals_.pop_front();
-        usleep(100);
-        channels_.at(who)->start_acquisition();
         break;
     case 1:
         LOG(INFO) << "Channel " << who << " ACQ SUCCESS satellite " << channels_.at(who)->get_signal().get_satellite();
-        acq_PRN =  channels_.at(who)->get_signal().get_satellite().get_PRN();
 
         channels_.at(who)->set_state(0);
-        channels_state_[who] = 2;
-        acq_channels_count_--;
-
-        DLOG(INFO) << "peak " << channel_to_peak.at(who);
+        scheduler_.set_state(who, 2);
 
-        if(spoofing_detection){
-            next_peak.at(PRN) = peak+1; 
-            nr_acq_peaks = nr_acquired_peaks.at(acq_PRN);
-            acquire_sat_again = false;
-            inactive = std::count(available_GNSS_signals_.begin(), available_GNSS_signals_.end(), channels_.at(who)->get_signal());  //number of availble instances of the sat
-            if(nr_acq_peaks+inactive < nr_acq )
+        if(spoofing_detection)
             {
-                DLOG(INFO) << "pushing back sat " << acq_PRN << " ch " << who << " nr acq peaks " << nr_acq_peaks;  
-                available_GNSS_signals_.push_back(channels_.at(who)->get_signal());
-                acquire_sat_again = true;
-            }   
-        }
-
-
+                DLOG(INFO) << "peak " << scheduler_.get_peak(who);
+                scheduler_.peak_acquired(who);
+                // queue the satellite again while it has unexamined peaks and free slots
+                if (scheduler_.wants_more_peaks(channels_.at(who)->get_signal()))
+                    {
+                        DLOG(INFO) << "pushing back sat " << PRN << " ch " << who << " nr acq peaks " << scheduler_.acquiring(PRN);
+                        scheduler_.push_back(channels_.at(who)->get_signal());
+                    }
+            }
 
-        if (!available_GNSS_signals_.empty() && acq_channels_count_ < max_acq_channels_)
-        {
-            for (unsigned int i = 0; i < channels_count_; i++)
+        if (scheduler_.acquiring_channels() < max_acq_channels_ && scheduler_.take_standby(standby))
             {
-                if (channels_state_[i] == 0)
-                {
-                    channels_state_[i] = 1;
-                    while (channels_.at(i)->get_signal().get_signal_str().compare(available_GNSS_signals_.front().get_signal_str()) != 0 )
+                if (channels_.at(standby)->parked())
                     {
-                        available_GNSS_signals_.push_back(available_GNSS_signals_.front());
-                        available_GNSS_signals_.pop_front();
+                        channels_.at(standby)->activate();
+                        LOG(INFO) << "Channel " << standby << " activated";
                     }
-                    channels_.at(i)->set_signal(available_GNSS_signals_.front());
-                    available_GNSS_signals_.pop_front();
-                    acq_channels_count_++;
-
-                    if(spoofing_detection){
-                        //unnecessary just so acq of lower peaks happens faster
-                        DLOG(INFO) << "assign same satellite again? " << acquire_sat_again << " " << i;
-                        /*
-                           if(acquire_sat_again)
-                           {
-                           acquire_sat_again = false;
-                           DLOG(INFO) << "assign same satellite again?";
-                           PRN = channels_.at(i)->get_signal().get_satellite().get_PRN(); 
-                           nr_acquired_peaks.at(PRN) -= 1;
-                           acquired_peaks.at(PRN).push_front(channel_to_peak.at(i));
-                           channels_.at(i)->set_signal(channels_.at(who)->get_signal());
-                           DLOG(INFO) << "PRN " << PRN << " channel: " << channels_.at(i);
-                           AssignACQState(PRN, i);
-                           }
-                         */
+                if (!acquire_next_signal(standby))
+                    {
+                        scheduler_.set_state(standby, 0);
+                        park_channel(standby);
                     }
-                    channels_.at(i)->start_acquisition();
-                    break;
-                }
-                DLOG(INFO) << "Channel " << i << " in state " << channels_state_[i];
             }
-        }
 
         for (unsigned int i = 0; i < channels_count_; i++)
-        {
-            DLOG(INFO) << "Channel " << i << " in state " << channels_state_[i] << std::endl;
-        }
+            {
+                DLOG(INFO) << "Channel " << i << " in state " << scheduler_.get_state(i);
+            }
         break;
 
     case 2:
         LOG(INFO) << "Channel " << who << " TRK FAILED satellite " << channels_.at(who)->get_signal().get_satellite();
         //channel should not be used for spoofing or pvt calculation
         channels_.at(who)->set_state(2);
-        PRN = channels_.at(who)->get_signal().get_satellite().get_PRN(); 
 
         //remove cannel from spoofing detection queues
         if(spoofing_detection)
-        {
-            uid = channels_.at(who)->get_uid();
-            global_subframe_map.remove(uid);
-            global_gps_time.remove(uid);
-            global_subframe_check.remove(uid);
-
-            nr_acquired_peaks.at(PRN) -= 1;
-            channels_.at(who)->set_peak(0);
-
-            //remove cannel from spoofing detection queues
-            uid = channels_.at(who)->get_uid();
-            global_subframe_map.remove(uid);
-            global_gps_time.remove(uid);
-        }
-
-        DLOG(INFO) << "pushing back " << PRN << " acq_nr " << nr_acquired_peaks.at(PRN);
-        available_GNSS_signals_.push_back(channels_.at(who)->get_signal());
-
-        while (channels_.at(who)->get_signal().get_satellite().get_system() != available_GNSS_signals_.front().get_satellite().get_system())
-        {
-            available_GNSS_signals_.push_back(available_GNSS_signals_.front());
-            available_GNSS_signals_.pop_front();
-        }
-
-        PRN = available_GNSS_signals_.front().get_satellite().get_PRN();
-        if(spoofing_detection)
-        {
-            AssignACQState(PRN, who);
-        }
+            {
+                uid = channels_.at(who)->get_uid();
+                global_subframe_map.remove(uid);
+                global_gps_time.remove(uid);
+                global_subframe_check.remove(uid);
 
-        channels_.at(who)->set_signal(available_GNSS_signals_.front());
-        available_GNSS_signals_.pop_front();
-        usleep(100);
-        channels_.at(who)->start_acquisition();
+                scheduler_.peak_lost(who, false);
+                channels_.at(who)->set_peak(0);
+            }
 
+        DLOG(INFO) << "pushing back " << PRN << " acq_nr " << scheduler_.acquiring(PRN);
+        scheduler_.push_back(channels_.at(who)->get_signal());
+        scheduler_.set_state(who, 1);
+        if (!acquire_next_signal(who))
+            {
+                scheduler_.set_state(who, 0);
+                park_channel(who);
+            }
         break;
     case 4:
         LOG(INFO) << "No spoofing detected, restart acqusition on auxiliary channel: " << who << "  sat " << channels_.at(who)->get_signal().get_satellite().get_PRN(); 
         //only do it for channels that have received ephemeris
-        if(channels_state_[who] != 2)
-            break;       
-        /*    std::cout << "No spoofing detected, restart acqusition on auxiliary channel: " << who << "  sat " << channels_.at(who)->get_signal().get_satellite().get_PRN()
-              << " acquired peak " << peak << std::endl; 
-         */
-        PRN = channels_.at(who)->get_signal().get_satellite().get_PRN(); 
+        if(scheduler_.get_state(who) != 2)
+            break;
+        // same channel, next peak of the same satellite
         AssignACQState(PRN, who);
-        channels_.at(who)->stop_tracking();        
+        channels_.at(who)->stop_tracking();
 
         break;
     default:
         break;
     }
-    DLOG(INFO) << "Number of available signals: " << available_GNSS_signals_.size();
+    DLOG(INFO) << "Number of available signals: " << scheduler_.pending();
 }
 
 
@@ -628,14 +649,32 @@ void GNSSFlowgraph::init()
      * Instantiates the receiver blocks
      */
     std::unique_ptr<GNSSBlockFactory> block_factory_(new GNSSBlockFactory());
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+
+    // FFT plans of the acquisition blocks are looked up in the wisdom cache
+    std::string wisdom_file = configuration_->property("GNSS-SDR.fftw_wisdom_file", std::string(""));
+    if (!wisdom_file.empty() && Gnss_Sdr_Fft_Wisdom::load(wisdom_file))
+        {
+            LOG(INFO) << "FFTW wisdom loaded from " << wisdom_file;
+        }
+
+    // real-time scheduling is inherited by the block threads created later
+    layout_ = std::make_shared<BlockLayout>(configuration_);
+    layout_->enable_realtime();
 
     // 1. read the number of RF front-ends available (one file_source per RF front-end)
-    sources_count_ = configuration_->property("Receiver.sources_count", 1);
+    sources_count_ = host_ ? 0 : configuration_->property("Receiver.sources_count", 1);
 
     int RF_Channels = 0;
     int signal_conditioner_ID = 0;
 
-    if (sources_count_ > 1)
+    if (host_)
+    {
+        // fed by the signal conditioners of the host: GNU Radio shares their
+        // output buffers among all the downstream channels, without copies
+        sig_conditioner_ = host_->sig_conditioner_;
+    }
+    else if (sources_count_ > 1)
     {
         for (int i = 0; i < sources_count_; i++)
         {
@@ -676,10 +715,20 @@ void GNSSFlowgraph::init()
         }
     }
 
+    std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
     observables_ = block_factory_->GetObservables(configuration_);
     pvt_ = block_factory_->GetPVT(configuration_);
 
+    std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
     std::shared_ptr<std::vector<std::unique_ptr<GNSSBlockInterface>>> channels = block_factory_->GetChannels(configuration_, queue_);
+    std::chrono::steady_clock::time_point t3 = std::chrono::steady_clock::now();
+
+    // keep the plans measured for new FFT sizes for the next start
+    if (!wisdom_file.empty() && Gnss_Sdr_Fft_Wisdom::save(wisdom_file))
+        {
+            LOG(INFO) << "FFTW wisdom saved to " << wisdom_file;
+        }
+    std::chrono::steady_clock::time_point t4 = std::chrono::steady_clock::now();
 
     //todo:check smart pointer coherence...
     channels_count_ = channels->size();
@@ -691,19 +740,31 @@ void GNSSFlowgraph::init()
             chan->set_peak(0); 
         }
 
-    top_block_ = gr::make_top_block("GNSSFlowgraph");
+    top_block_ = host_ ? host_->top_block_ : gr::make_top_block("GNSSFlowgraph");
 
     pvt_->set_channels(channels_);
 
     spoofing_detection = configuration_->property("Spoofing.APT", false);
     nr_acq = configuration_->property("Spoofing.APT_ch_per_sat", 2);
+    scheduler_.set_peaks(nr_acq);
 
-    // fill the available_GNSS_signals_ queue with the satellites ID's to be searched by the acquisition
+    // fill the scheduler pools with the satellites ID's to be searched by the acquisition
     set_signals_list();
     set_channels_state();
     applied_actions_ = 0;
 
     DLOG(INFO) << "Blocks instantiated. " << channels_count_ << " channels.";
+
+    typedef std::chrono::duration<double, std::milli> ms;
+    Gnss_Sdr_Shared_Tables& tables = Gnss_Sdr_Shared_Tables::instance();
+    LOG(INFO) << "Startup: sources and conditioners " << ms(t1 - t0).count()
+              << " ms, observables and PVT " << ms(t2 - t1).count()
+              << " ms, channels " << ms(t3 - t2).count()
+              << " ms, FFTW wisdom " << ms(t4 - t3).count()
+              << " ms. Shared tables: " << tables.builds() << " built, "
+              << tables.hits() << " reused.";
+    std::cout << "Receiver blocks built in " << ms(std::chrono::steady_clock::now() - t0).count()
+              << " ms (" << channels_count_ << " channels in " << ms(t3 - t2).count() << " ms)" << std::endl;
 }
 
 
@@ -805,11 +866,10 @@ void GNSSFlowgraph::set_signals_list()
                     available_gnss_prn_iter != available_gps_prn.end();
                     available_gnss_prn_iter++)
                 {
-                    available_GNSS_signals_.push_back(Gnss_Signal(Gnss_Satellite(std::string("GPS"),
+                    scheduler_.push_back(Gnss_Signal(Gnss_Satellite(std::string("GPS"),
                                     *available_gnss_prn_iter), std::string("1C")));
 
-                    next_peak[*available_gnss_prn_iter] = 1;
-                    nr_acquired_peaks[*available_gnss_prn_iter] = 0;
+                    scheduler_.add_satellite(*available_gnss_prn_iter);
                 }
 
             if(spoofing_detection)
@@ -821,7 +881,7 @@ void GNSSFlowgraph::set_signals_list()
                                 available_gnss_prn_iter != available_gps_prn.end();
                                 available_gnss_prn_iter++)
                             {
-                                available_GNSS_signals_.push_back(Gnss_Signal(Gnss_Satellite(std::string("GPS"),
+                                scheduler_.push_back(Gnss_Signal(Gnss_Satellite(std::string("GPS"),
                                         *available_gnss_prn_iter), std::string("1C")));
                             }
                     }
@@ -837,7 +897,7 @@ void GNSSFlowgraph::set_signals_list()
                     available_gnss_prn_iter != available_gps_prn.end();
                     available_gnss_prn_iter++)
                 {
-                    available_GNSS_signals_.push_back(Gnss_Signal(Gnss_Satellite(std::string("GPS"),
+                    scheduler_.push_back(Gnss_Signal(Gnss_Satellite(std::string("GPS"),
                             *available_gnss_prn_iter), std::string("2S")));
                 }
         }
@@ -851,7 +911,7 @@ void GNSSFlowgraph::set_signals_list()
                     available_gnss_prn_iter != available_sbas_prn.end();
                     available_gnss_prn_iter++)
                 {
-                    available_GNSS_signals_.push_back(Gnss_Signal(Gnss_Satellite(std::string("SBAS"),
+                    scheduler_.push_back(Gnss_Signal(Gnss_Satellite(std::string("SBAS"),
                             *available_gnss_prn_iter), std::string("1C")));
 
                 }
@@ -867,7 +927,7 @@ void GNSSFlowgraph::set_signals_list()
                     available_gnss_prn_iter != available_galileo_prn.end();
                     available_gnss_prn_iter++)
                 {
-                    available_GNSS_signals_.push_back(Gnss_Signal(Gnss_Satellite(std::string("Galileo"),
+                    scheduler_.push_back(Gnss_Signal(Gnss_Satellite(std::string("Galileo"),
                             *available_gnss_prn_iter), std::string("1B")));
                 }
         }
@@ -881,15 +941,13 @@ void GNSSFlowgraph::set_signals_list()
                     available_gnss_prn_iter != available_galileo_prn.end();
                     available_gnss_prn_iter++)
                 {
-                    available_GNSS_signals_.push_back(Gnss_Signal(Gnss_Satellite(std::string("Galileo"),
+                    scheduler_.push_back(Gnss_Signal(Gnss_Satellite(std::string("Galileo"),
                             *available_gnss_prn_iter), std::string("5X")));
                 }
         }
     /*
      * Ordering the list of signals from configuration file
      */
-    std::list<Gnss_Signal>::iterator gnss_it = available_GNSS_signals_.begin();
-
     // Pre-assignation if not defined at ChannelX.signal=1C ...? In what order?
 
     for (unsigned int i = 0; i < total_channels; i++)
@@ -900,26 +958,13 @@ void GNSSFlowgraph::set_signals_list()
             if((gnss_signal.compare("1B") == 0) or (gnss_signal.compare("5X") == 0) ) gnss_system = "Galileo";
             unsigned int sat = configuration_->property("Channel" + boost::lexical_cast<std::string>(i) + ".satellite", 0);
             LOG(INFO) << "Channel " << i <<  " system " << gnss_system << ", signal " << gnss_signal <<", sat "<<sat;
-            if (sat == 0) // 0 = not PRN in configuration file
+            if (sat != 0) // 0 = not PRN in configuration file
                 {
-                    gnss_it++;
-                }
-            else
-                {
-                    Gnss_Signal signal_value = Gnss_Signal(Gnss_Satellite(gnss_system, sat), gnss_signal);
-                    available_GNSS_signals_.remove(signal_value);
-                    available_GNSS_signals_.insert(gnss_it, signal_value);
-                    AssignACQState(gnss_it->get_satellite().get_PRN(), i);
+                    scheduler_.preassign(i, Gnss_Signal(Gnss_Satellite(gnss_system, sat), gnss_signal));
                 }
         }
 
-    //    **** FOR DEBUGGING THE LIST OF GNSS SIGNALS ****
-    //    std::list<Gnss_Signal>::iterator available_gnss_list_iter;
-    //    for (available_gnss_list_iter = available_GNSS_signals_.begin(); available_gnss_list_iter
-    //    != available_GNSS_signals_.end(); available_gnss_list_iter++)
-    //        {
-    //            std::cout << *available_gnss_list_iter << std::endl;
-    //        }
+    DLOG(INFO) << scheduler_.pending() << " signals pending for acquisition";
 }
 
 
@@ -929,22 +974,45 @@ void GNSSFlowgraph::set_channels_state()
     if (max_acq_channels_ > channels_count_)
         {
             max_acq_channels_ = channels_count_;
-            LOG(WARNING) << "Channels_in_acquisition is bigger than number of channels. Variable acq_channels_count_ is set to " << channels_count_;
+            LOG(WARNING) << "Channels_in_acquisition is bigger than number of channels. Channels in acquisition set to " << channels_count_;
         }
-    channels_state_.reserve(channels_count_);
+    std::vector<std::string> signal_types;
     for (unsigned int i = 0; i < channels_count_; i++)
         {
-            if (i < max_acq_channels_)
+            signal_types.push_back(channels_.at(i)->get_signal().get_signal_str());
+            channels_.at(i)->set_state(0);
+        }
+    scheduler_.set_channels(signal_types, max_acq_channels_);
+
+    // parked channels need an observables block that does not wait for them
+    dynamic_channels_ = configuration_->property("Channels.dynamic_pool", false);
+    if (dynamic_channels_ && observables_->implementation().compare("GPS_L1_CA_Observables") != 0)
+        {
+            LOG(WARNING) << "Channels.dynamic_pool is not supported by " << observables_->implementation() << ", standby channels will not be parked";
+            dynamic_channels_ = false;
+        }
+    if (dynamic_channels_ && max_acq_channels_ == 0)
+        {
+            LOG(WARNING) << "Channels.dynamic_pool needs at least one channel in acquisition, standby channels will not be parked";
+            dynamic_channels_ = false;
+        }
+    if (dynamic_channels_)
+        {
+            // the parked state is kept by the gates of this flowgraph only
+            std::vector<gnss_sdr_channel_gate_sptr> gates;
+            for (unsigned int i = 0; i < channels_count_; i++)
                 {
-                    channels_state_.push_back(1);
+                    gates.push_back(boost::dynamic_pointer_cast<gnss_sdr_channel_gate>(channels_.at(i)->get_left_block()));
                 }
-            else
+            gps_l1_ca_observables_cc_sptr observables = boost::dynamic_pointer_cast<gps_l1_ca_observables_cc>(observables_->get_left_block());
+            if (observables)
                 {
-                    channels_state_.push_back(0);
+                    observables->set_channel_gates(gates);
                 }
-            DLOG(INFO) << "Channel " << i << " in state " << channels_state_[i];
-            channels_.at(i)->set_state(0);
         }
-    acq_channels_count_ = max_acq_channels_;
-    DLOG(INFO) << acq_channels_count_ << " channels in acquisition state";
+    for (unsigned int i = 0; i < channels_count_; i++)
+        {
+            DLOG(INFO) << "Channel " << i << " in state " << scheduler_.get_state(i);
+        }
+    DLOG(INFO) << scheduler_.acquiring_channels() << " channels in acquisition state";
 }
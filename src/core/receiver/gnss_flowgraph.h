@@ -39,7 +39,6 @@
 #ifndef GNSS_SDR_GNSS_FLOWGRAPH_H_
 #define GNSS_SDR_GNSS_FLOWGRAPH_H_
 
-#include <list>
 #include <memory>
 #include <queue>
 #include <string>
@@ -47,6 +46,8 @@
 #include <gnuradio/top_block.h>
 #include <gnuradio/msg_queue.h>
 #include "GPS_L1_CA.h"
+#include "block_layout.h"
+#include "channel_scheduler.h"
 #include "gnss_signal.h"
 #include "pvt_interface.h"
 
@@ -70,6 +71,18 @@ public:
     GNSSFlowgraph(std::shared_ptr<ConfigurationInterface> configuration,
                   boost::shared_ptr<gr::msg_queue> queue);
 
+    /*!
+     * \brief Constructor of a receiver hosted by another flowgraph
+     *
+     * The receiver has its own channels, observables and PVT, fed by the
+     * signal conditioners of \p host, and runs in the top block of \p host.
+     * It must be connected before the host starts; start() and stop() only
+     * change its state.
+     */
+    GNSSFlowgraph(std::shared_ptr<ConfigurationInterface> configuration,
+                  boost::shared_ptr<gr::msg_queue> queue,
+                  std::shared_ptr<GNSSFlowgraph> host);
+
     /*!
      * \brief Virtual destructor
      */
@@ -112,6 +125,10 @@ public:
     {
         return running_;
     }
+    bool hosted()
+    {
+        return host_ != nullptr;
+    }
 
     /*!
      * \brief Sends a GNURadio asyncronous message from telemetry to PVT
@@ -130,16 +147,20 @@ private:
     void set_signals_list();
     void set_channels_state(); // Initializes the channels state (start acquisition or keep standby)
                                // using the configuration parameters (number of channels and max channels in acquisition)
+    bool acquire_next_signal(unsigned int who); // Gives the channel its next signal and restarts acquisition
+    void park_channel(unsigned int who);        // Stops feeding a standby channel (Channels.dynamic_pool)
+    void apply_layout();                        // Places the blocks as given in the Layout.* section
     bool connected_;
     bool running_;
+    bool dynamic_channels_;
     int sources_count_;
 
     unsigned int channels_count_;
-    unsigned int acq_channels_count_;
     unsigned int max_acq_channels_;
     unsigned int applied_actions_;
     std::string config_file_;
     std::shared_ptr<ConfigurationInterface> configuration_;
+    std::shared_ptr<GNSSFlowgraph> host_; // owner of the sources, conditioners and top block, if hosted
 
     std::vector<std::shared_ptr<GNSSBlockInterface>> sig_source_;
     std::vector<std::shared_ptr<GNSSBlockInterface>> sig_conditioner_;
@@ -151,13 +172,8 @@ private:
     std::vector<std::shared_ptr<ChannelInterface>> channels_;
     gr::top_block_sptr top_block_;
     boost::shared_ptr<gr::msg_queue> queue_;
-    std::list<Gnss_Signal> available_GNSS_signals_;
-    std::vector<unsigned int> channels_state_;
-    std::map<int, int> nr_acquired_peaks;                   // keeps track of how many channels are acquiring each satellite
-    std::map<int, int> next_peak;
-    std::map<int, int> channel_to_peak;                     // keeps track of which channel track which peak 
-    std::map<int, int> acquired_state;                  //keeps track of which channel is acq based on the 2nd highest 
-    std::map<int, unsigned int> PVT_to_channel;                 //which the channels signal is used in the PVT calculation 
+    ChannelScheduler scheduler_; // pending signals, channel states and APT peaks
+    std::shared_ptr<BlockLayout> layout_;
 };
 
 #endif /*GNSS_SDR_GNSS_FLOWGRAPH_H_*/
@@ -0,0 +1,113 @@
+/*!
+ * \file receiver_configuration.cc
+ * \brief Configuration of one receiver hosted next to others in the same
+ * process (see Receivers.* in ControlThread).
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "receiver_configuration.h"
+
+
+ReceiverConfiguration::ReceiverConfiguration(std::shared_ptr<ConfigurationInterface> shared,
+        std::shared_ptr<ConfigurationInterface> own)
+{
+    shared_ = shared;
+    own_ = own;
+}
+
+
+ReceiverConfiguration::~ReceiverConfiguration()
+{}
+
+
+bool ReceiverConfiguration::is_shared(const std::string& property_name)
+{
+    return property_name.compare(0, 9, "GNSS-SDR.") == 0;
+}
+
+
+ConfigurationInterface* ReceiverConfiguration::select(const std::string& property_name)
+{
+    return is_shared(property_name) ? shared_.get() : own_.get();
+}
+
+
+std::string ReceiverConfiguration::property(std::string property_name, std::string default_value)
+{
+    return select(property_name)->property(property_name, default_value);
+}
+
+
+bool ReceiverConfiguration::property(std::string property_name, bool default_value)
+{
+    return select(property_name)->property(property_name, default_value);
+}
+
+
+long ReceiverConfiguration::property(std::string property_name, long default_value)
+{
+    return select(property_name)->property(property_name, default_value);
+}
+
+
+int ReceiverConfiguration::property(std::string property_name, int default_value)
+{
+    return select(property_name)->property(property_name, default_value);
+}
+
+
+unsigned int ReceiverConfiguration::property(std::string property_name, unsigned int default_value)
+{
+    return select(property_name)->property(property_name, default_value);
+}
+
+
+unsigned short ReceiverConfiguration::property(std::string property_name, unsigned short default_value)
+{
+    return select(property_name)->property(property_name, default_value);
+}
+
+
+float ReceiverConfiguration::property(std::string property_name, float default_value)
+{
+    return select(property_name)->property(property_name, default_value);
+}
+
+
+double ReceiverConfiguration::property(std::string property_name, double default_value)
+{
+    return select(property_name)->property(property_name, default_value);
+}
+
+
+void ReceiverConfiguration::set_property(std::string property_name, std::string value)
+{
+    // the shared parameters are only changed through the main configuration
+    if (!is_shared(property_name))
+        {
+            own_->set_property(property_name, value);
+        }
+}
@@ -0,0 +1,72 @@
+/*!
+ * \file receiver_configuration.h
+ * \brief Configuration of one receiver hosted next to others in the same
+ * process (see Receivers.* in ControlThread).
+ *
+ * The GNSS-SDR.* parameters, which describe the sample stream the receivers
+ * share (e.g. GNSS-SDR.internal_fs_hz), are always read from the main
+ * configuration. Every other parameter is read from the receiver's own
+ * configuration only, so that for instance the Spoofing.* section of the
+ * main receiver does not leak into a plain one.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_RECEIVER_CONFIGURATION_H_
+#define GNSS_SDR_RECEIVER_CONFIGURATION_H_
+
+#include <memory>
+#include <string>
+#include "configuration_interface.h"
+
+/*!
+ * \brief Overlays the receiver configuration on the shared GNSS-SDR.* parameters
+ */
+class ReceiverConfiguration : public ConfigurationInterface
+{
+public:
+    ReceiverConfiguration(std::shared_ptr<ConfigurationInterface> shared,
+                          std::shared_ptr<ConfigurationInterface> own);
+    ~ReceiverConfiguration();
+    std::string property(std::string property_name, std::string default_value);
+    bool property(std::string property_name, bool default_value);
+    long property(std::string property_name, long default_value);
+    int property(std::string property_name, int default_value);
+    unsigned int property(std::string property_name, unsigned int default_value);
+    unsigned short property(std::string property_name, unsigned short default_value);
+    float property(std::string property_name, float default_value);
+    double property(std::string property_name, double default_value);
+    void set_property(std::string property_name, std::string value);
+
+    //! True if the parameter is common to all the receivers of the process
+    static bool is_shared(const std::string& property_name);
+
+private:
+    ConfigurationInterface* select(const std::string& property_name);
+    std::shared_ptr<ConfigurationInterface> shared_;
+    std::shared_ptr<ConfigurationInterface> own_;
+};
+
+#endif /*GNSS_SDR_RECEIVER_CONFIGURATION_H_*/
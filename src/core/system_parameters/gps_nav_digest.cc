@@ -0,0 +1,262 @@
+/*!
+ * \file gps_nav_digest.cc
+ * \brief  Implementation of a 128-bit digest of GPS NAV message contents
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gps_nav_digest.h"
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include "gps_ephemeris.h"
+#include "gps_almanac.h"
+#include "gps_iono.h"
+#include "gps_utc_model.h"
+
+namespace
+{
+const uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325ULL;
+const uint64_t FNV_PRIME = 0x100000001b3ULL;
+const uint64_t GOLDEN_GAMMA = 0x9e3779b97f4a7c15ULL;
+
+// splitmix64 finalizer
+uint64_t mix64(uint64_t z)
+{
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+}
+
+
+Gps_Nav_Digest::Gps_Nav_Digest()
+{
+    d_lo = FNV_OFFSET_BASIS;
+    d_hi = GOLDEN_GAMMA;
+    d_fields = 0;
+}
+
+
+void Gps_Nav_Digest::add_word(uint64_t word)
+{
+    // lane 1: FNV-1a over the eight bytes of the word
+    for (int i = 0; i < 8; i++)
+        {
+            d_lo ^= (word >> (8 * i)) & 0xff;
+            d_lo *= FNV_PRIME;
+        }
+    // lane 2: splitmix64 chaining, position dependent
+    d_hi = mix64(d_hi ^ mix64(word + GOLDEN_GAMMA * (d_fields + 1)));
+    d_fields++;
+}
+
+
+void Gps_Nav_Digest::add(double value)
+{
+    // +0.0 and -0.0 compare equal, so they must digest equally
+    if (value == 0.0) value = 0.0;
+    uint64_t word;
+    std::memcpy(&word, &value, sizeof(word));
+    add_word(word);
+}
+
+
+void Gps_Nav_Digest::add(int value)
+{
+    add_word(static_cast<uint64_t>(static_cast<int64_t>(value)));
+}
+
+
+void Gps_Nav_Digest::add(unsigned int value)
+{
+    add_word(static_cast<uint64_t>(value));
+}
+
+
+void Gps_Nav_Digest::add(bool value)
+{
+    add_word(value ? 1 : 0);
+}
+
+
+void Gps_Nav_Digest::add_field(const std::bitset<GPS_SUBFRAME_BITS>& bits, const std::vector<std::pair<int,int>>& field)
+{
+    uint64_t value = 0;
+    for (unsigned int i = 0; i < field.size(); i++)
+        {
+            for (int j = 0; j < field[i].second; j++)
+                {
+                    value <<= 1;
+                    if (bits[GPS_SUBFRAME_BITS - field[i].first - j] == 1)
+                        {
+                            value += 1;
+                        }
+                }
+        }
+    add_word(value);
+}
+
+
+bool Gps_Nav_Digest::empty() const
+{
+    return d_fields == 0;
+}
+
+
+uint64_t Gps_Nav_Digest::low() const
+{
+    return d_lo;
+}
+
+
+uint64_t Gps_Nav_Digest::high() const
+{
+    return d_hi;
+}
+
+
+std::string Gps_Nav_Digest::to_string() const
+{
+    std::stringstream s;
+    s << std::hex << std::setfill('0') << std::setw(16) << d_hi << std::setw(16) << d_lo;
+    return s.str();
+}
+
+
+bool Gps_Nav_Digest::operator==(const Gps_Nav_Digest& other) const
+{
+    return d_lo == other.d_lo && d_hi == other.d_hi && d_fields == other.d_fields;
+}
+
+
+bool Gps_Nav_Digest::operator!=(const Gps_Nav_Digest& other) const
+{
+    return !(*this == other);
+}
+
+
+/*
+ * Each digest below covers the fields compared one by one in its
+ * Spoofing_Detector counterpart (compare_ephemeris / compare_ephemeris_dTOW,
+ * compare_almanac, compare_iono and compare_utc), so equal digests imply that
+ * the field-level comparison would not find a difference.
+ */
+Gps_Nav_Digest gps_ephemeris_digest(const Gps_Ephemeris& eph, bool mask_TOW)
+{
+    Gps_Nav_Digest digest;
+    digest.add(eph.i_satellite_PRN);
+    digest.add(eph.i_peak);
+    if (!mask_TOW)
+        {
+            digest.add(eph.d_TOW);
+        }
+    digest.add(eph.d_Crs);
+    digest.add(eph.d_Delta_n);
+    digest.add(eph.d_M_0);
+    digest.add(eph.d_Cuc);
+    digest.add(eph.d_e_eccentricity);
+    digest.add(eph.d_Cus);
+    digest.add(eph.d_sqrt_A);
+    digest.add(eph.d_Toe);
+    digest.add(eph.d_Toc);
+    digest.add(eph.d_Cic);
+    digest.add(eph.d_OMEGA0);
+    digest.add(eph.d_Cis);
+    digest.add(eph.d_i_0);
+    digest.add(eph.d_Crc);
+    digest.add(eph.d_OMEGA);
+    digest.add(eph.d_OMEGA_DOT);
+    digest.add(eph.d_IDOT);
+    digest.add(eph.i_code_on_L2);
+    digest.add(eph.i_GPS_week);
+    digest.add(eph.b_L2_P_data_flag);
+    digest.add(eph.i_SV_accuracy);
+    digest.add(eph.i_SV_health);
+    digest.add(eph.d_TGD);
+    digest.add(eph.d_IODC);
+    digest.add(eph.i_AODO);
+    digest.add(eph.b_fit_interval_flag);
+    digest.add(eph.d_spare1);
+    digest.add(eph.d_spare2);
+    digest.add(eph.d_A_f0);
+    digest.add(eph.d_A_f1);
+    digest.add(eph.d_A_f2);
+    digest.add(eph.b_integrity_status_flag);
+    digest.add(eph.b_alert_flag);
+    digest.add(eph.b_antispoofing_flag);
+    return digest;
+}
+
+
+Gps_Nav_Digest gps_almanac_digest(const Gps_Almanac& almanac)
+{
+    Gps_Nav_Digest digest;
+    digest.add(almanac.i_satellite_PRN);
+    digest.add(almanac.d_Delta_i);
+    digest.add(almanac.d_Toa);
+    digest.add(almanac.d_M_0);
+    digest.add(almanac.d_e_eccentricity);
+    digest.add(almanac.d_sqrt_A);
+    digest.add(almanac.d_OMEGA0);
+    digest.add(almanac.d_OMEGA);
+    digest.add(almanac.d_OMEGA_DOT);
+    digest.add(almanac.i_SV_health);
+    digest.add(almanac.d_A_f0);
+    digest.add(almanac.d_A_f1);
+    return digest;
+}
+
+
+Gps_Nav_Digest gps_iono_digest(const Gps_Iono& iono)
+{
+    Gps_Nav_Digest digest;
+    digest.add(iono.d_alpha0);
+    digest.add(iono.d_alpha1);
+    digest.add(iono.d_alpha2);
+    digest.add(iono.d_alpha3);
+    digest.add(iono.d_beta0);
+    digest.add(iono.d_beta1);
+    digest.add(iono.d_beta2);
+    digest.add(iono.d_beta3);
+    digest.add(iono.valid);
+    return digest;
+}
+
+
+Gps_Nav_Digest gps_utc_model_digest(const Gps_Utc_Model& utc)
+{
+    Gps_Nav_Digest digest;
+    digest.add(utc.valid);
+    digest.add(utc.d_A1);
+    digest.add(utc.d_A0);
+    digest.add(utc.d_t_OT);
+    digest.add(utc.i_WN_T);
+    digest.add(utc.d_DeltaT_LS);
+    digest.add(utc.i_WN_LSF);
+    digest.add(utc.i_DN);
+    digest.add(utc.d_DeltaT_LSF);
+    return digest;
+}
@@ -0,0 +1,100 @@
+/*!
+ * \file gps_nav_digest.h
+ * \brief  Interface of a 128-bit digest of GPS NAV message contents, used to
+ * compare subframes and decoded navigation data in constant time.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+
+#ifndef GNSS_SDR_GPS_NAV_DIGEST_H_
+#define GNSS_SDR_GPS_NAV_DIGEST_H_
+
+#include <bitset>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "GPS_L1_CA.h"
+
+class Gps_Ephemeris;
+class Gps_Almanac;
+class Gps_Iono;
+class Gps_Utc_Model;
+
+
+/*!
+ * \brief Order dependent 128-bit digest of a sequence of navigation message fields.
+ *
+ * Two independent 64-bit lanes are kept, so two digests only compare equal
+ * (with overwhelming probability) when the same values were added in the same
+ * order. An empty digest (nothing added) is never equal to a non-empty one.
+ */
+class Gps_Nav_Digest
+{
+private:
+    uint64_t d_lo;
+    uint64_t d_hi;
+    unsigned int d_fields;
+
+    void add_word(uint64_t word);
+
+public:
+    void add(double value);
+    void add(int value);
+    void add(unsigned int value);
+    void add(bool value);
+
+    /*!
+     * \brief Adds the raw bits of a subframe field, as defined in GPS_L1_CA.h
+     */
+    void add_field(const std::bitset<GPS_SUBFRAME_BITS>& bits, const std::vector<std::pair<int,int>>& field);
+
+    bool empty() const;           //!< True if no field was added
+    uint64_t low() const;
+    uint64_t high() const;
+    std::string to_string() const; //!< 32 hex digits
+
+    bool operator==(const Gps_Nav_Digest& other) const;
+    bool operator!=(const Gps_Nav_Digest& other) const;
+
+    Gps_Nav_Digest();
+};
+
+
+/*!
+ * \brief Digest of the ephemeris fields checked by the spoofing detector.
+ * With mask_TOW the time of week is left out, so that the same ephemeris set
+ * received in different subframes gives the same digest.
+ */
+Gps_Nav_Digest gps_ephemeris_digest(const Gps_Ephemeris& eph, bool mask_TOW);
+
+Gps_Nav_Digest gps_almanac_digest(const Gps_Almanac& almanac);
+
+Gps_Nav_Digest gps_iono_digest(const Gps_Iono& iono);
+
+Gps_Nav_Digest gps_utc_model_digest(const Gps_Utc_Model& utc);
+
+#endif
@@ -104,6 +104,12 @@ void Gps_Navigation_Message::reset()
     d_subframe_timestamp_ms = 0;
     d_subframe = 0;
 
+    for (int i = 0; i < 5; i++)
+        {
+            d_subframe_digest[i] = Gps_Nav_Digest();
+            d_subframe_HOW[i] = 0;
+        }
+
     // flags
     b_alert_flag = false;
     b_integrity_status_flag = false;
@@ -439,6 +445,133 @@ std::string Gps_Navigation_Message::get_subframe(int subframe_ID)
     return 0;
 }
 
+
+Gps_Nav_Digest Gps_Navigation_Message::get_subframe_digest(int subframe_ID)
+{
+    if (subframe_ID < 1 || subframe_ID > 5)
+        {
+            return Gps_Nav_Digest();
+        }
+    return d_subframe_digest[subframe_ID - 1];
+}
+
+
+unsigned int Gps_Navigation_Message::get_subframe_HOW(int subframe_ID)
+{
+    if (subframe_ID < 1 || subframe_ID > 5)
+        {
+            return 0;
+        }
+    return d_subframe_HOW[subframe_ID - 1];
+}
+
+
+/*
+ * The field lists follow the content of the subframeX strings built in
+ * subframe_decoder, so that two subframes have the same digest exactly when
+ * their strings (without the leading TOW and flags) are the same.
+ */
+void Gps_Navigation_Message::compute_subframe_digest(const std::bitset<GPS_SUBFRAME_BITS>& bits, int subframe_ID)
+{
+    if (subframe_ID < 1 || subframe_ID > 5)
+        {
+            return;
+        }
+    Gps_Nav_Digest digest;
+    unsigned int how = static_cast<unsigned int>(read_navigation_unsigned(bits, TOW));
+    how = (how << 1) | static_cast<unsigned int>(read_navigation_bool(bits, INTEGRITY_STATUS_FLAG));
+    how = (how << 1) | static_cast<unsigned int>(read_navigation_bool(bits, ALERT_FLAG));
+    how = (how << 1) | static_cast<unsigned int>(read_navigation_bool(bits, ANTI_SPOOFING_FLAG));
+
+    int SV_page;
+    switch (subframe_ID)
+    {
+    case 1:
+        digest.add_field(bits, GPS_WEEK);
+        digest.add_field(bits, SV_ACCURACY);
+        digest.add_field(bits, SV_HEALTH);
+        digest.add_field(bits, L2_P_DATA_FLAG);
+        digest.add_field(bits, CA_OR_P_ON_L2);
+        digest.add_field(bits, T_GD);
+        digest.add_field(bits, IODC);
+        digest.add_field(bits, T_OC);
+        digest.add_field(bits, A_F0);
+        digest.add_field(bits, A_F1);
+        digest.add_field(bits, A_F2);
+        break;
+    case 2:
+        digest.add_field(bits, IODE_SF2);
+        digest.add_field(bits, C_RS);
+        digest.add_field(bits, DELTA_N);
+        digest.add_field(bits, M_0);
+        digest.add_field(bits, C_UC);
+        digest.add_field(bits, E);
+        digest.add_field(bits, C_US);
+        digest.add_field(bits, SQRT_A);
+        digest.add_field(bits, T_OE);
+        digest.add_field(bits, FIT_INTERVAL_FLAG);
+        digest.add_field(bits, AODO);
+        break;
+    case 3:
+        digest.add_field(bits, C_IC);
+        digest.add_field(bits, OMEGA_0);
+        digest.add_field(bits, C_IS);
+        digest.add_field(bits, I_0);
+        digest.add_field(bits, C_RC);
+        digest.add_field(bits, OMEGA);
+        digest.add_field(bits, OMEGA_DOT);
+        digest.add_field(bits, IODE_SF3);
+        digest.add_field(bits, I_DOT);
+        break;
+    case 4:
+    case 5:
+        digest.add_field(bits, SV_DATA_ID);
+        digest.add_field(bits, SV_PAGE);
+        SV_page = static_cast<int>(read_navigation_unsigned(bits, SV_PAGE));
+        if ((subframe_ID == 4 && almanac_page_to_PRN.count(SV_page)) || (subframe_ID == 5 && SV_page < 25 && SV_page != 0))
+            {
+                digest.add_field(bits, T_OA);
+                digest.add_field(bits, DELTA_I);
+                digest.add_field(bits, almanac_M_0);
+                digest.add_field(bits, almanac_E);
+                digest.add_field(bits, almanac_SQRT_A);
+                digest.add_field(bits, almanac_OMEGA0);
+                digest.add_field(bits, almanac_OMEGA);
+                digest.add_field(bits, almanac_OMEGA_DOT);
+                digest.add_field(bits, almanac_A_F0);
+                digest.add_field(bits, almanac_A_F1);
+            }
+        else if (subframe_ID == 4 && SV_page == 56)
+            {
+                digest.add_field(bits, ALPHA_0);
+                digest.add_field(bits, ALPHA_1);
+                digest.add_field(bits, ALPHA_2);
+                digest.add_field(bits, ALPHA_3);
+                digest.add_field(bits, BETA_0);
+                digest.add_field(bits, BETA_1);
+                digest.add_field(bits, BETA_2);
+                digest.add_field(bits, BETA_3);
+                digest.add_field(bits, A_1);
+                digest.add_field(bits, A_0);
+                digest.add_field(bits, T_OT);
+                digest.add_field(bits, WN_T);
+                digest.add_field(bits, DELTAT_LS);
+                digest.add_field(bits, WN_LSF);
+                digest.add_field(bits, DN);
+                digest.add_field(bits, DELTAT_LSF);
+            }
+        else if (subframe_ID == 5 && SV_page == 51)
+            {
+                digest.add_field(bits, T_OA);
+                digest.add_field(bits, WN_A);
+            }
+        break;
+    }
+    d_subframe_digest[subframe_ID - 1] = digest;
+    d_subframe_HOW[subframe_ID - 1] = how;
+}
+
+
 int Gps_Navigation_Message::subframe_decoder(char *subframe)
 {
     int subframe_ID = 0;
@@ -883,6 +1016,8 @@ int Gps_Navigation_Message::subframe_decoder(char *subframe)
         break;
     } // switch subframeID ...
 
+    compute_subframe_digest(subframe_bits, subframe_ID);
+
     return subframe_ID;
 }
 
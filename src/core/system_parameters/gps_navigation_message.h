@@ -46,6 +46,7 @@
 #include "gps_iono.h"
 #include "gps_almanac.h"
 #include "gps_utc_model.h"
+#include "gps_nav_digest.h"
 
 
 
@@ -70,6 +71,14 @@ private:
      */
     double check_t(double time);
 
+    /*
+     * Digest of the fields of the subframe that go into its comparison string,
+     * except the TOW and the HOW flags, which are kept apart in d_subframe_HOW
+     */
+    void compute_subframe_digest(const std::bitset<GPS_SUBFRAME_BITS>& bits, int subframe_ID);
+    Gps_Nav_Digest d_subframe_digest[5];
+    unsigned int d_subframe_HOW[5];
+
 public:
     bool b_valid_ephemeris_set_flag; // flag indicating that this ephemeris set have passed the validation check
     //broadcast orbit 1
@@ -233,6 +242,8 @@ public:
     
     //for spoofing
     std::string get_subframe(int subframe_ID);
+    Gps_Nav_Digest get_subframe_digest(int subframe_ID); //!< Digest of the subframe data words, TOW and HOW masked
+    unsigned int get_subframe_HOW(int subframe_ID);      //!< TOW count and HOW/TLM flags of the subframe
     double get_TOW();
     int get_week();
     unsigned int get_uid();
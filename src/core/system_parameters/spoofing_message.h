@@ -30,7 +30,8 @@
 #ifndef GNSS_SDR_SPOOFING_MESSAGE_H_
 #define GNSS_SDR_SPOOFING_MESSAGE_H_
 
-#include "spoofing_message.h"
+#include <set>
+#include <string>
 
 /*!
  * \brief This is the class that contains the information that is shared
@@ -43,6 +44,13 @@ public:
     std::set<unsigned int> satellites;
     std::string description;
     std::string spoofing_report;
+    double evidence_time_ms; //!< Receiver time of the evidence that triggered the alarm [ms], -1 if unknown
+    double alarm_time_ms;    //!< Receiver time at which the alarm was raised [ms], -1 if unknown
+    std::string metric;      //!< Name of the quantity that crossed its threshold, empty if none
+    double value;            //!< Value of \a metric
+    double threshold;        //!< Threshold of \a metric
+
+    Spoofing_Message() : spoofing_case(0), evidence_time_ms(-1.0), alarm_time_ms(-1.0), value(0.0), threshold(0.0) {}
 };
 
 #endif
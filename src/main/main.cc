@@ -50,7 +50,8 @@
 #include <glog/logging.h>
 #include <gnuradio/msg_queue.h>
 #include "control_thread.h"
-#include "concurrent_queue.h"
+#include "batch_processor.h"
+#include "concurrent_ring.h"
 #include "concurrent_map.h"
 #include "concurrent_map_str.h"
 #include "gps_ephemeris.h"
@@ -59,6 +60,7 @@
 #include "gps_iono.h"
 #include "gps_cnav_iono.h"
 #include "gps_utc_model.h"
+#include "gps_nav_digest.h"
 #include "galileo_ephemeris.h"
 #include "galileo_almanac.h"
 #include "galileo_iono.h"
@@ -69,6 +71,7 @@
 #include "sbas_ephemeris.h"
 #include "sbas_time.h"
 #include "spoofing_message.h"
+#include "spoofing_capture.h"
 
 #if CUDA_GPU_ACCEL
     // For the CUDA runtime routines (prefixed with "cuda_")
@@ -78,6 +81,11 @@
 using google::LogMessage;
 
 DECLARE_string(log_dir);
+DECLARE_string(config_file);
+DECLARE_string(batch_list);
+DECLARE_int32(batch_jobs);
+DECLARE_string(batch_summary);
+DECLARE_string(batch_output_dir);
 
 /*
 * Concurrent queues that communicates the Telemetry Decoder
@@ -85,7 +93,7 @@ DECLARE_string(log_dir);
 */
 
 // For GPS NAVIGATION (L1)
-concurrent_queue<Gps_Acq_Assist> global_gps_acq_assist_queue;
+concurrent_ring<Gps_Acq_Assist> global_gps_acq_assist_queue(256, RING_BLOCK);
 concurrent_map<Gps_Acq_Assist> global_gps_acq_assist_map;
 //For spoofing detection
 struct GPS_time_t{
@@ -97,6 +105,7 @@ struct GPS_time_t{
 
 struct sEph{
     Gps_Ephemeris ephemeris;
+    Gps_Nav_Digest digest; // ephemeris digest without TOW
     double time;
     bool changed;
 };
@@ -113,11 +122,14 @@ struct Subframe{
     double timestamp;
     unsigned int toa;
     unsigned int uid;
+    Gps_Nav_Digest digest; // subframe digest without TOW and HOW flags
+    unsigned int HOW;
 };
 
 concurrent_map<Subframe> global_subframe_map;
 concurrent_map<std::map<unsigned int, unsigned int>> global_subframe_check;
-concurrent_queue<Spoofing_Message> global_spoofing_queue;
+concurrent_ring<Spoofing_Message> global_spoofing_queue(1024, RING_DROP_NEWEST);
+concurrent_ring<Capture_Subframe> global_capture_subframe_queue(1024, RING_DROP_NEWEST);
 
 int main(int argc, char** argv)
 {
@@ -180,6 +192,17 @@ int main(int argc, char** argv)
                     std::cout << "Logging with be done at " << FLAGS_log_dir << std::endl;
                 }
         }
+
+    // Batch mode: the captures of the list, each in a child process
+    if (!FLAGS_batch_list.empty())
+        {
+            BatchProcessor batch(FLAGS_config_file, FLAGS_batch_jobs > 0 ? FLAGS_batch_jobs : 1, FLAGS_batch_output_dir);
+            int status = batch.run(FLAGS_batch_list, FLAGS_batch_summary);
+            google::ShutDownCommandLineFlags();
+            std::cout << "GNSS-SDR program ended." << std::endl;
+            return status;
+        }
+
     std::unique_ptr<ControlThread> control_thread(new ControlThread());
 
     // record startup time
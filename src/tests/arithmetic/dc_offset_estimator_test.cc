@@ -0,0 +1,77 @@
+/*!
+ * \file dc_offset_estimator_test.cc
+ * \brief  This file implements tests for the DC offset estimator of the
+ * interleaved data type adapters
+ *
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include <gtest/gtest.h>
+#include "dc_offset_estimator.h"
+
+
+TEST(DcOffsetEstimatorTest, FirstBufferSetsEstimate)
+{
+    std::vector<int8_t> in;
+    for (int n = 0; n < 1000; n++)
+        {
+            in.push_back(static_cast<int8_t>(3 + (n % 2 == 0 ? 5 : -5)));
+            in.push_back(static_cast<int8_t>(-2 + (n % 4 < 2 ? 7 : -7)));
+        }
+    dc_offset_estimator dc(1e6);
+    dc.update(in.data(), 1000);
+    EXPECT_NEAR(3.0, dc.in_phase(), 1e-12);
+    EXPECT_NEAR(-2.0, dc.quadrature(), 1e-12);
+}
+
+
+TEST(DcOffsetEstimatorTest, TimeConstantDoesNotDependOnBufferSplit)
+{
+    std::vector<int16_t> zeros(2 * 4096, 0);
+    std::vector<int16_t> step(2 * 4096);
+    for (unsigned int n = 0; n < step.size(); n += 2)
+        {
+            step.at(n) = 1000;
+            step.at(n + 1) = -1000;
+        }
+    dc_offset_estimator whole(4096.0);
+    dc_offset_estimator split(4096.0);
+    whole.update(zeros.data(), 4096);
+    split.update(zeros.data(), 4096);
+
+    whole.update(step.data(), 4096);
+    for (int k = 0; k < 64; k++)
+        {
+            split.update(step.data() + 2 * 64 * k, 64);
+        }
+    // one time constant after the step the estimate is 1 - 1/e of the way there
+    EXPECT_NEAR(1000.0 * (1.0 - std::exp(-1.0)), whole.in_phase(), 1e-9);
+    EXPECT_NEAR(whole.in_phase(), split.in_phase(), 1e-9);
+    EXPECT_NEAR(whole.quadrature(), split.quadrature(), 1e-9);
+}
@@ -0,0 +1,113 @@
+/*!
+ * \file gnss_sdr_perf_test.cc
+ * \brief  This file implements tests for the per-block performance counters
+ *
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <gtest/gtest.h>
+#include "gnss_sdr_perf.h"
+
+
+TEST(GnssSdrPerfTest, BlockCountersAndLoad)
+{
+    Gnss_Sdr_Perf::instance().clear();
+    std::shared_ptr<Gnss_Sdr_Block_Perf> perf = Gnss_Sdr_Perf::instance().add("tracking", 4e6);
+    EXPECT_EQ("tracking", perf->label());
+    perf->set_channel(3);
+    EXPECT_EQ("tracking[3]", perf->label());
+
+    // 100 work calls of 4000 samples (1 ms of signal) taking 250 us each
+    for (unsigned int i = 0; i < 100; i++)
+        {
+            perf->add_work(250000, 4000, 8000);
+        }
+    perf->set_produced(100);
+    EXPECT_EQ(100, perf->get_calls());
+    EXPECT_EQ(400000, perf->get_consumed());
+    EXPECT_EQ(100, perf->get_produced());
+    EXPECT_EQ(25000000, perf->get_busy_ns());
+    EXPECT_NEAR(0.1, perf->stream_s(), 1e-12);
+    EXPECT_NEAR(0.25, perf->rt_load(), 1e-9);
+    EXPECT_NEAR(0.002, perf->backlog_s(), 1e-12);
+    EXPECT_EQ(8000, perf->get_backlog_items().max());
+
+    Gnss_Sdr_Block_Perf unknown_rate("pvt", 0.0);
+    unknown_rate.add_work(1000, 1, 0);
+    EXPECT_EQ(0.0, unknown_rate.stream_s());
+    EXPECT_EQ(0.0, unknown_rate.rt_load());
+
+    perf->clear();
+    EXPECT_EQ(0, perf->get_calls());
+    EXPECT_EQ(0, perf->get_consumed());
+    Gnss_Sdr_Perf::instance().clear();
+}
+
+
+TEST(GnssSdrPerfTest, OverrunsAndPublishing)
+{
+    Gnss_Sdr_Perf& registry = Gnss_Sdr_Perf::instance();
+    registry.clear();
+    registry.set_period_ms(1);
+    registry.set_max_backlog_ms(0.0);
+    std::shared_ptr<Gnss_Sdr_Block_Perf> fast = registry.add("tracking", 1e6, 0);
+    std::shared_ptr<Gnss_Sdr_Block_Perf> slow = registry.add("tracking", 1e6, 1);
+    std::shared_ptr<Gnss_Sdr_Block_Perf> idle = registry.add("telemetry", 1e3, 1);
+    EXPECT_EQ(3, registry.blocks().size());
+
+    // 1 ms of signal processed in 0.5 ms and in 2 ms
+    fast->add_work(500000, 1000, 0);
+    slow->add_work(2000000, 1000, 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    std::string json = registry.to_json();
+    EXPECT_EQ(0, registry.get_overruns(fast.get()));
+    EXPECT_EQ(1, registry.get_overruns(slow.get()));
+    EXPECT_EQ(0, registry.get_overruns(idle.get()));
+    EXPECT_NE(std::string::npos, json.find("\"name\":\"telemetry\""));
+    EXPECT_NE(std::string::npos, json.find("\"rt_load\":2"));
+
+    // a backlog above the limit is an overrun even if the block keeps up
+    registry.set_max_backlog_ms(10.0);
+    fast->add_work(500000, 1000, 20000);
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    registry.to_json();
+    EXPECT_EQ(1, registry.get_overruns(fast.get()));
+    // no work in the last interval: not an overrun
+    EXPECT_EQ(1, registry.get_overruns(slow.get()));
+
+    // blocks that never ran are left out of the summary
+    std::string summary = registry.summary();
+    EXPECT_NE(std::string::npos, summary.find("tracking[1]"));
+    EXPECT_EQ(std::string::npos, summary.find("telemetry[1]"));
+
+    registry.set_max_backlog_ms(0.0);
+    registry.set_period_ms(1000);
+    registry.clear();
+}
@@ -0,0 +1,134 @@
+/*!
+ * \file gnss_sdr_runtime_params_test.cc
+ * \brief  This file implements tests for the parameters changed at run time
+ *
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <map>
+#include <string>
+#include <gtest/gtest.h>
+#include "gnss_sdr_runtime_params.h"
+
+
+TEST(GnssSdrRuntimeParamsTest, Validate)
+{
+    std::string error;
+    EXPECT_TRUE(Gnss_Sdr_Runtime_Params::validate("Spoofing.CN0_threshold", "12.5", error));
+    EXPECT_FALSE(Gnss_Sdr_Runtime_Params::validate("Spoofing.CN0_threshold", "-1", error));
+    EXPECT_FALSE(Gnss_Sdr_Runtime_Params::validate("Spoofing.CN0_threshold", "12.5dB", error));
+    EXPECT_TRUE(Gnss_Sdr_Runtime_Params::validate("Spoofing.NAVI_alt", "false", error));
+    EXPECT_FALSE(Gnss_Sdr_Runtime_Params::validate("Spoofing.NAVI_alt", "maybe", error));
+    EXPECT_TRUE(Gnss_Sdr_Runtime_Params::validate("Acquisition_1C.threshold", "0.01", error));
+    EXPECT_TRUE(Gnss_Sdr_Runtime_Params::validate("Tracking_1C3.pll_bw_hz", "15", error));
+    EXPECT_FALSE(Gnss_Sdr_Runtime_Params::validate("Tracking_1C.dll_bw_hz", "0", error));
+    EXPECT_FALSE(Gnss_Sdr_Runtime_Params::validate("Tracking_1C.dll_bw_hz", "300", error));
+    EXPECT_FALSE(Gnss_Sdr_Runtime_Params::validate("Tracking_1C.order", "3", error));
+    EXPECT_FALSE(Gnss_Sdr_Runtime_Params::validate("GNSS-SDR.internal_fs_hz", "4000000", error));
+    EXPECT_NE(std::string::npos, error.find("GNSS-SDR.internal_fs_hz"));
+}
+
+
+TEST(GnssSdrRuntimeParamsTest, UpdateIsAllOrNothing)
+{
+    Gnss_Sdr_Runtime_Params& params = Gnss_Sdr_Runtime_Params::instance();
+    params.clear();
+    unsigned long int version = params.version();
+
+    std::map<std::string, std::string> batch;
+    batch["Spoofing.RT_threshold"] = "0.2";
+    batch["Tracking_1C.pll_bw_hz"] = "-5";
+    std::string error;
+    EXPECT_FALSE(params.update(batch, error));
+    EXPECT_EQ(version, params.version());
+
+    batch["Tracking_1C.pll_bw_hz"] = "20";
+    EXPECT_TRUE(params.update(batch, error));
+    EXPECT_EQ(version + 1, params.version());
+    unsigned long int read_version;
+    std::map<std::string, std::string> values = params.values(read_version);
+    EXPECT_EQ(version + 1, read_version);
+    EXPECT_EQ("0.2", values["Spoofing.RT_threshold"]);
+    EXPECT_EQ("20", values["Tracking_1C.pll_bw_hz"]);
+    params.clear();
+}
+
+
+TEST(GnssSdrRuntimeParamsTest, WatchPrefersChannelRole)
+{
+    Gnss_Sdr_Runtime_Params& params = Gnss_Sdr_Runtime_Params::instance();
+    params.clear();
+    Gnss_Sdr_Runtime_Params_Watch watch0("Tracking_1C");
+    watch0.set_channel(0);
+    Gnss_Sdr_Runtime_Params_Watch watch3("Tracking_1C");
+    watch3.set_channel(3);
+    watch0.changed();
+    watch3.changed();
+    EXPECT_FALSE(watch0.changed());
+
+    std::map<std::string, std::string> batch;
+    batch["Tracking_1C.pll_bw_hz"] = "20";
+    batch["Tracking_1C3.pll_bw_hz"] = "10";
+    std::string error;
+    ASSERT_TRUE(params.update(batch, error));
+
+    double bw = 0.0;
+    EXPECT_TRUE(watch0.changed());
+    EXPECT_TRUE(watch0.get("pll_bw_hz", bw));
+    EXPECT_DOUBLE_EQ(20.0, bw);
+    EXPECT_FALSE(watch0.get("dll_bw_hz", bw));
+    EXPECT_FALSE(watch0.changed());
+    EXPECT_TRUE(watch3.changed());
+    EXPECT_TRUE(watch3.get("pll_bw_hz", bw));
+    EXPECT_DOUBLE_EQ(10.0, bw);
+
+    Gnss_Sdr_Runtime_Params_Watch spoofing("Spoofing");
+    batch.clear();
+    batch["Spoofing.PPE"] = "true";
+    ASSERT_TRUE(params.update(batch, error));
+    bool flag = false;
+    EXPECT_TRUE(spoofing.changed());
+    EXPECT_TRUE(spoofing.get("PPE", flag));
+    EXPECT_TRUE(flag);
+    params.clear();
+}
+
+
+TEST(GnssSdrRuntimeParamsTest, Parse)
+{
+    std::map<std::string, std::string> values;
+    std::string error;
+    EXPECT_TRUE(Gnss_Sdr_Reconfigure_Listener::parse(
+            "[GNSS-SDR]\n; comment\n# comment\n\nSpoofing.CN0_threshold = 12 ; dB-Hz\nTracking_1C.pll_bw_hz=15;\n", values, error));
+    EXPECT_EQ(2, values.size());
+    EXPECT_EQ("12", values["Spoofing.CN0_threshold"]);
+    EXPECT_EQ("15", values["Tracking_1C.pll_bw_hz"]);
+
+    values.clear();
+    EXPECT_FALSE(Gnss_Sdr_Reconfigure_Listener::parse("Spoofing.PPE=true\nnot a parameter\n", values, error));
+    EXPECT_EQ("true", values["Spoofing.PPE"]);
+    EXPECT_NE(std::string::npos, error.find("not a parameter"));
+}
@@ -0,0 +1,96 @@
+/*!
+ * \file gnss_sdr_shared_tables_test.cc
+ * \brief  This file implements tests for the process-wide shared sample tables
+ *
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "gnss_sdr_shared_tables.h"
+
+
+TEST(GnssSdrSharedTablesTest, BuildsOncePerKey)
+{
+    Gnss_Sdr_Shared_Tables& tables = Gnss_Sdr_Shared_Tables::instance();
+    tables.clear();
+    unsigned long int builds = tables.builds();
+    unsigned int calls = 0;
+    std::function<void(gr_complex*)> build = [&calls](gr_complex* t)
+        {
+            calls++;
+            for (unsigned int i = 0; i < 16; i++) t[i] = gr_complex(i, -static_cast<float>(i));
+        };
+
+    std::shared_ptr<gr_complex> a = tables.get("test/a", 16, build);
+    std::shared_ptr<gr_complex> b = tables.get("test/a", 16, build);
+    std::shared_ptr<gr_complex> c = tables.get("test/c", 16, build);
+
+    EXPECT_EQ(2, calls);
+    EXPECT_EQ(builds + 2, tables.builds());
+    EXPECT_EQ(a.get(), b.get());
+    EXPECT_NE(a.get(), c.get());
+    EXPECT_EQ(gr_complex(5, -5), b.get()[5]);
+    EXPECT_TRUE(tables.contains("test/a"));
+    EXPECT_EQ(2, tables.tables());
+
+    // the callers keep their tables after clear()
+    tables.clear();
+    EXPECT_FALSE(tables.contains("test/a"));
+    EXPECT_EQ(0, tables.tables());
+    EXPECT_EQ(gr_complex(15, -15), a.get()[15]);
+}
+
+
+TEST(GnssSdrSharedTablesTest, ConcurrentRequests)
+{
+    Gnss_Sdr_Shared_Tables& tables = Gnss_Sdr_Shared_Tables::instance();
+    tables.clear();
+    unsigned long int builds = tables.builds();
+    std::vector<std::shared_ptr<gr_complex>> got(8);
+    std::vector<std::thread> threads;
+    for (unsigned int i = 0; i < got.size(); i++)
+        {
+            threads.push_back(std::thread([&tables, &got, i]()
+                {
+                    got.at(i) = tables.get("test/concurrent", 1024, [](gr_complex* t)
+                        {
+                            for (unsigned int k = 0; k < 1024; k++) t[k] = gr_complex(1, 0);
+                        });
+                }));
+        }
+    for (unsigned int i = 0; i < threads.size(); i++) threads.at(i).join();
+
+    EXPECT_EQ(builds + 1, tables.builds());
+    for (unsigned int i = 0; i < got.size(); i++)
+        {
+            EXPECT_EQ(got.at(0).get(), got.at(i).get());
+        }
+    tables.clear();
+}
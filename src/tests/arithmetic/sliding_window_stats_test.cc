@@ -0,0 +1,104 @@
+/*!
+ * \file sliding_window_stats_test.cc
+ * \brief  This file implements tests for the streaming sliding-window statistics
+ *
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cmath>
+#include <vector>
+#include <gtest/gtest.h>
+#include "sliding_window_stats.h"
+
+
+TEST(SlidingWindowStatsTest, MatchesTwoPassOverWindow)
+{
+    std::vector<unsigned int> lengths = { 5, 50 };
+    Sliding_Window_Stats stats(lengths);
+    std::vector<double> samples;
+
+    for (unsigned int i = 0; i < 1000; i++)
+        {
+            double x = 45.0 + 3.0 * std::sin(0.1 * i) + 0.01 * (i % 7);
+            samples.push_back(x);
+            stats.push_back(x);
+
+            for (unsigned int w = 0; w < lengths.size(); w++)
+                {
+                    unsigned int n = std::min<unsigned int>(lengths.at(w), samples.size());
+                    double mean = 0.0;
+                    for (unsigned int k = samples.size() - n; k < samples.size(); k++) mean += samples.at(k);
+                    mean /= n;
+                    double var = 0.0;
+                    for (unsigned int k = samples.size() - n; k < samples.size(); k++) var += (samples.at(k) - mean) * (samples.at(k) - mean);
+                    var /= n;
+
+                    EXPECT_EQ(n, stats.size(w));
+                    EXPECT_NEAR(mean, stats.mean(w), 1e-9);
+                    EXPECT_NEAR(var, stats.var(w), 1e-9);
+                }
+        }
+    EXPECT_EQ(1000, stats.count());
+    EXPECT_TRUE(stats.full(0));
+    EXPECT_TRUE(stats.full(1));
+}
+
+
+TEST(SlidingWindowStatsTest, CovarianceAndCorrelation)
+{
+    Sliding_Window_Stats stats(100);
+    for (unsigned int i = 0; i < 300; i++)
+        {
+            double x = std::cos(0.05 * i);
+            stats.push_back(x, -2.0 * x + 1.0);
+        }
+    EXPECT_NEAR(-1.0, stats.corr(), 1e-9);
+    EXPECT_NEAR(-2.0 * stats.var(), stats.cov(), 1e-9);
+
+    Sliding_Window_Stats constant(10);
+    for (unsigned int i = 0; i < 20; i++)
+        {
+            constant.push_back(1.0, static_cast<double>(i));
+        }
+    EXPECT_EQ(0.0, constant.var());
+    EXPECT_EQ(0.0, constant.corr());
+}
+
+
+TEST(SlidingWindowStatsTest, Clear)
+{
+    Sliding_Window_Stats stats(4);
+    stats.push_back(1.0);
+    stats.push_back(3.0);
+    EXPECT_DOUBLE_EQ(2.0, stats.mean());
+    EXPECT_DOUBLE_EQ(1.0, stats.var());
+    stats.clear();
+    EXPECT_EQ(0, stats.size());
+    EXPECT_EQ(0, stats.count());
+    stats.push_back(7.0);
+    EXPECT_DOUBLE_EQ(7.0, stats.mean());
+    EXPECT_DOUBLE_EQ(0.0, stats.var());
+}
@@ -0,0 +1,198 @@
+/*!
+ * \file spoofing_check_test.cc
+ * \brief  This file implements tests for the scheduling of the spoofing checks
+ *
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+#include <gtest/gtest.h>
+#include "concurrent_ring.h"
+#include "gnss_sdr_runtime_params.h"
+#include "in_memory_configuration.h"
+#include "spoofing_check.h"
+#include "spoofing_detector.h"
+#include "spoofing_message.h"
+
+extern concurrent_ring<Spoofing_Message> global_spoofing_queue;
+
+
+class Fake_Spoofing_Check : public Spoofing_Check_Interface
+{
+public:
+    Fake_Spoofing_Check(unsigned int inputs, double period_ms, double budget_us, Spoofing_Check_Priority priority, double cost_us = 0.0)
+    {
+        d_inputs = inputs;
+        d_period_ms = period_ms;
+        d_budget_us = budget_us;
+        d_priority = priority;
+        d_cost_us = cost_us;
+        runs = 0;
+    }
+    std::string name() const { return "fake"; }
+    unsigned int inputs() const { return d_inputs; }
+    double period_ms() const { return d_period_ms; }
+    double budget_us() const { return d_budget_us; }
+    Spoofing_Check_Priority priority() const { return d_priority; }
+    void run(const Spoofing_Input& input)
+    {
+        runs++;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        while (std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() < d_cost_us) {}
+    }
+    unsigned int runs;
+
+private:
+    unsigned int d_inputs;
+    double d_period_ms;
+    double d_budget_us;
+    Spoofing_Check_Priority d_priority;
+    double d_cost_us;
+};
+
+
+TEST(SpoofingCheckTest, DispatchByInputAndPeriod)
+{
+    Spoofing_Check_Scheduler scheduler;
+    std::shared_ptr<Fake_Spoofing_Check> subframe3(new Fake_Spoofing_Check(SPOOFING_INPUT_SUBFRAME_3, 0, 1e6, SPOOFING_CHECK_ESSENTIAL));
+    std::shared_ptr<Fake_Spoofing_Check> epoch(new Fake_Spoofing_Check(SPOOFING_INPUT_EPOCH, 100, 1e6, SPOOFING_CHECK_SHEDDABLE));
+    scheduler.add(subframe3);
+    scheduler.add(epoch);
+    scheduler.configure(1.0, 6000, 64, 1000);
+    EXPECT_EQ(2, scheduler.size());
+
+    EXPECT_EQ(SPOOFING_INPUT_SUBFRAME_3, Spoofing_Input::subframe(3));
+    for (int id = 1; id <= 5; id++)
+        {
+            scheduler.dispatch(Spoofing_Input(Spoofing_Input::subframe(id), id * 6000.0));
+        }
+    EXPECT_EQ(1, subframe3->runs);
+    EXPECT_EQ(0, epoch->runs);
+
+    // one epoch per ms, at most one run per 100 ms
+    for (int t = 0; t < 1000; t++)
+        {
+            scheduler.dispatch(Spoofing_Input(SPOOFING_INPUT_EPOCH, 40000.0 + t));
+        }
+    EXPECT_EQ(10, epoch->runs);
+    std::vector<Spoofing_Check_Scheduler::Status> status = scheduler.get_status();
+    EXPECT_EQ(10, status.at(1).runs);
+    EXPECT_EQ(990, status.at(1).skipped);
+    EXPECT_EQ(1, status.at(1).backoff);
+}
+
+
+TEST(SpoofingCheckTest, OverBudgetCheckBacksOff)
+{
+    Spoofing_Check_Scheduler scheduler;
+    std::shared_ptr<Fake_Spoofing_Check> slow(new Fake_Spoofing_Check(SPOOFING_INPUT_EPOCH, 0, 10, SPOOFING_CHECK_SHEDDABLE, 200));
+    std::shared_ptr<Fake_Spoofing_Check> essential(new Fake_Spoofing_Check(SPOOFING_INPUT_EPOCH, 0, 10, SPOOFING_CHECK_ESSENTIAL, 200));
+    scheduler.add(slow);
+    scheduler.add(essential);
+    scheduler.configure(1.0, 100, 8, 1000);
+
+    for (int t = 0; t < 2000; t++)
+        {
+            scheduler.dispatch(Spoofing_Input(SPOOFING_INPUT_EPOCH, t));
+        }
+    // essential checks are never shed, whatever their cost
+    EXPECT_EQ(2000, essential->runs);
+    std::vector<Spoofing_Check_Scheduler::Status> status = scheduler.get_status();
+    EXPECT_EQ(8, status.at(0).backoff);
+    EXPECT_LT(slow->runs, 20);
+    EXPECT_GT(status.at(0).cost_us, 10);
+}
+
+
+TEST(SpoofingCheckTest, CpuShareShedsCheapChecks)
+{
+    Spoofing_Check_Scheduler scheduler;
+    std::shared_ptr<Fake_Spoofing_Check> cheap(new Fake_Spoofing_Check(SPOOFING_INPUT_EPOCH, 0, 1e6, SPOOFING_CHECK_SHEDDABLE));
+    std::shared_ptr<Fake_Spoofing_Check> busy(new Fake_Spoofing_Check(SPOOFING_INPUT_EPOCH, 0, 1e6, SPOOFING_CHECK_ESSENTIAL, 200));
+    scheduler.add(cheap);
+    scheduler.add(busy);
+    // 200 us of every ms is well above a 5 % share
+    scheduler.configure(0.05, 10, 4, 100);
+
+    for (int t = 0; t < 500; t++)
+        {
+            scheduler.dispatch(Spoofing_Input(SPOOFING_INPUT_EPOCH, t));
+        }
+    EXPECT_TRUE(scheduler.is_overloaded());
+    EXPECT_EQ(4, scheduler.get_status().at(0).backoff);
+    EXPECT_LT(cheap->runs, 500);
+}
+
+
+TEST(SpoofingCheckTest, Registry)
+{
+    Spoofing_Check_Registry::instance().add("fake_test_check", [](ConfigurationInterface*)
+            {
+                return std::shared_ptr<Spoofing_Check_Interface>(new Fake_Spoofing_Check(SPOOFING_INPUT_POSITION, 0, 1, SPOOFING_CHECK_ESSENTIAL));
+            });
+    std::shared_ptr<Spoofing_Check_Interface> check = Spoofing_Check_Registry::instance().create("fake_test_check", nullptr);
+    ASSERT_TRUE(static_cast<bool>(check));
+    EXPECT_EQ(SPOOFING_INPUT_POSITION, check->inputs());
+    EXPECT_FALSE(static_cast<bool>(Spoofing_Check_Registry::instance().create("no_such_check", nullptr)));
+    std::vector<std::string> names = Spoofing_Check_Registry::instance().names();
+    EXPECT_NE(names.end(), std::find(names.begin(), names.end(), "fake_test_check"));
+}
+
+
+TEST(SpoofingCheckTest, RuntimeSwitchesTakeEffect)
+{
+    Gnss_Sdr_Runtime_Params& params = Gnss_Sdr_Runtime_Params::instance();
+    params.clear();
+    std::shared_ptr<InMemoryConfiguration> config = std::make_shared<InMemoryConfiguration>();
+    Spoofing_Detector detector(config.get());
+    Spoofing_Message msg;
+    while (global_spoofing_queue.try_pop(msg)) {}
+
+    // NAVI_alt is off in the configuration
+    detector.check_position(0.0, 0.0, -5.0, 1000.0);
+    EXPECT_FALSE(global_spoofing_queue.try_pop(msg));
+
+    std::map<std::string, std::string> batch;
+    batch["Spoofing.NAVI_alt"] = "true";
+    std::string error;
+    ASSERT_TRUE(params.update(batch, error));
+    EXPECT_TRUE(detector.update_parameters());
+    detector.check_position(0.0, 0.0, -5.0, 2000.0);
+    ASSERT_TRUE(global_spoofing_queue.try_pop(msg));
+    EXPECT_EQ(4, msg.spoofing_case);
+    EXPECT_EQ("height", msg.metric);
+
+    batch["Spoofing.NAVI_alt"] = "false";
+    ASSERT_TRUE(params.update(batch, error));
+    EXPECT_TRUE(detector.update_parameters());
+    detector.check_position(0.0, 0.0, -5.0, 3000.0);
+    EXPECT_FALSE(global_spoofing_queue.try_pop(msg));
+    params.clear();
+}
@@ -0,0 +1,115 @@
+/*!
+ * \file spoofing_stats_test.cc
+ * \brief  This file implements tests for the spoofing detector statistics
+ *
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <string>
+#include <gtest/gtest.h>
+#include "spoofing_stats.h"
+
+
+TEST(SpoofingStatsTest, HistogramBucketsAndQuantiles)
+{
+    EXPECT_EQ(0, Spoofing_Histogram::bucket_of(0));
+    EXPECT_EQ(1, Spoofing_Histogram::bucket_of(1));
+    EXPECT_EQ(2, Spoofing_Histogram::bucket_of(3));
+    EXPECT_EQ(3, Spoofing_Histogram::bucket_of(4));
+    EXPECT_EQ(Spoofing_Histogram::BUCKETS - 1, Spoofing_Histogram::bucket_of(~0ULL));
+
+    Spoofing_Histogram h;
+    for (unsigned int i = 1; i <= 100; i++)
+        {
+            h.add(i);
+        }
+    EXPECT_EQ(100, h.count());
+    EXPECT_EQ(5050, h.sum());
+    EXPECT_EQ(100, h.max());
+    EXPECT_DOUBLE_EQ(50.5, h.mean());
+    // the 50th value is 50, in bucket [32, 63]
+    EXPECT_EQ(63, h.quantile(0.5));
+    // the top bucket is bounded by the largest value
+    EXPECT_EQ(100, h.quantile(0.99));
+    h.clear();
+    EXPECT_EQ(0, h.count());
+    EXPECT_EQ(0, h.quantile(0.5));
+}
+
+
+TEST(SpoofingStatsTest, ScopesAttributeAlarmsAndLatency)
+{
+    Spoofing_Stats& stats = Spoofing_Stats::instance();
+    stats.reset();
+    {
+        Spoofing_Check_Scope entry(SPOOFING_CHECK_NEW_SUBFRAME, 7000.0);
+        {
+            Spoofing_Check_Scope check(SPOOFING_CHECK_NEW_TOW);
+            Spoofing_Message msg;
+            msg.spoofing_case = 3;
+            msg.evidence_time_ms = 1000.0;
+            Spoofing_Check_Scope::alarm(msg);
+            EXPECT_DOUBLE_EQ(1000.0, msg.evidence_time_ms);
+            EXPECT_DOUBLE_EQ(7000.0, msg.alarm_time_ms);
+
+            // the check did not say which sample raised it: latency unknown
+            Spoofing_Message unstamped;
+            unstamped.spoofing_case = 3;
+            Spoofing_Check_Scope::alarm(unstamped);
+            EXPECT_DOUBLE_EQ(-1.0, unstamped.evidence_time_ms);
+            EXPECT_DOUBLE_EQ(7000.0, unstamped.alarm_time_ms);
+        }
+        Spoofing_Message msg;
+        msg.spoofing_case = 3;
+        msg.evidence_time_ms = 6500.0;
+        Spoofing_Check_Scope::alarm(msg);
+    }
+    Spoofing_Message unscoped;
+    unscoped.spoofing_case = 3;
+    Spoofing_Check_Scope::alarm(unscoped);
+    EXPECT_DOUBLE_EQ(-1.0, unscoped.alarm_time_ms);
+
+    EXPECT_EQ(1, stats.get_calls(SPOOFING_CHECK_NEW_SUBFRAME));
+    EXPECT_EQ(1, stats.get_calls(SPOOFING_CHECK_NEW_TOW));
+    EXPECT_EQ(1, stats.get_alarms(SPOOFING_CHECK_NEW_SUBFRAME));
+    EXPECT_EQ(2, stats.get_alarms(SPOOFING_CHECK_NEW_TOW));
+    EXPECT_EQ(0, stats.get_calls(SPOOFING_CHECK_UNSCOPED));
+    EXPECT_EQ(1, stats.get_alarms(SPOOFING_CHECK_UNSCOPED));
+    EXPECT_LE(stats.get_self_ns(SPOOFING_CHECK_NEW_SUBFRAME), stats.get_time_ns(SPOOFING_CHECK_NEW_SUBFRAME).sum());
+
+    const Spoofing_Histogram& latency = stats.get_latency_ms(3);
+    EXPECT_EQ(2, latency.count());
+    EXPECT_EQ(6000 + 500, latency.sum());
+    EXPECT_EQ(6000, latency.max());
+    EXPECT_EQ(3, stats.get_processing_ns(3).count());
+
+    std::string json = stats.to_json();
+    EXPECT_NE(std::string::npos, json.find("\"new_subframe\":{\"calls\":1,\"alarms\":1"));
+    EXPECT_NE(std::string::npos, json.find("\"unscoped\":{\"calls\":0,\"alarms\":1"));
+    EXPECT_NE(std::string::npos, json.find("\"3\":{\"count\":3"));
+    EXPECT_EQ(std::string::npos, json.find("\"position\""));
+    stats.reset();
+}
@@ -0,0 +1,59 @@
+/*!
+ * \file receiver_configuration_test.cc
+ * \brief  This file implements tests for the configuration of hosted receivers
+ *
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <memory>
+#include <string>
+#include "configuration_interface.h"
+#include "in_memory_configuration.h"
+#include "receiver_configuration.h"
+
+TEST(ReceiverConfiguration, SharedAndOwnParameters)
+{
+    std::shared_ptr<ConfigurationInterface> main_config = std::make_shared<InMemoryConfiguration>();
+    main_config->set_property("GNSS-SDR.internal_fs_hz", "4000000");
+    main_config->set_property("Spoofing.APT", "true");
+    main_config->set_property("Channels_1C.count", "8");
+
+    std::shared_ptr<ConfigurationInterface> own = std::make_shared<InMemoryConfiguration>();
+    own->set_property("GNSS-SDR.internal_fs_hz", "2000000");
+    own->set_property("Channels_1C.count", "4");
+
+    ReceiverConfiguration configuration(main_config, own);
+    EXPECT_EQ(4000000, configuration.property("GNSS-SDR.internal_fs_hz", 0));
+    EXPECT_EQ(4, configuration.property("Channels_1C.count", 0));
+    EXPECT_FALSE(configuration.property("Spoofing.APT", false));
+    EXPECT_EQ("default", configuration.property("PVT.implementation", std::string("default")));
+
+    configuration.set_property("Channels_2S.count", "2");
+    configuration.set_property("GNSS-SDR.internal_fs_hz", "1000000");
+    EXPECT_EQ(2, configuration.property("Channels_2S.count", 0));
+    EXPECT_EQ(0, main_config->property("Channels_2S.count", 0));
+    EXPECT_EQ(4000000, configuration.property("GNSS-SDR.internal_fs_hz", 0));
+}
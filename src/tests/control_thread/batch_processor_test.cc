@@ -0,0 +1,262 @@
+/*!
+ * \file batch_processor_test.cc
+ * \brief  This file implements tests for the batch list, result files and summary
+ *
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+#include "batch_processor.h"
+#include "file_configuration.h"
+
+
+/*
+ * Batch whose captures only leave a file in their output directory, and
+ * succeed once they have seen that of the other capture: both have to run
+ * at the same time.
+ */
+class RendezvousBatch : public BatchProcessor
+{
+public:
+    RendezvousBatch(const std::string& output_dir) : BatchProcessor("receiver.conf", 2, output_dir) {}
+
+protected:
+    BatchResult process(const BatchJob& job, const std::string& output_dir)
+    {
+        BatchResult result;
+        result.job = job;
+        result.output_dir = output_dir;
+        result.status = 1;
+        result.wall_s = 1.0;
+        result.signal_s = 1.0;
+        result.fixes = 0;
+        result.alarms = 0;
+        std::ofstream((boost::filesystem::path(output_dir) / job.filename).string().c_str()) << job.filename;
+        std::string other = job_output_dir(job.filename == "a.dat" ? 1 : 0);
+        std::string other_filename = job.filename == "a.dat" ? "b.dat" : "a.dat";
+        for (int i = 0; i < 1000 && result.status != 0; i++)
+            {
+                if (boost::filesystem::exists(boost::filesystem::path(other) / other_filename))
+                    {
+                        result.status = 0;
+                    }
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+        return result;
+    }
+};
+
+
+TEST(BatchProcessorTest, ParseList)
+{
+    std::stringstream list;
+    list << "# captures of the campaign\n"
+         << "\n"
+         << "/data/static.dat\n"
+         << "  /data/ds3.dat 120.5   40000000\n"
+         << "/data/ds3.dat 60\n";
+    std::vector<BatchJob> jobs;
+    std::string error;
+    ASSERT_TRUE(BatchProcessor::parse_list(list, jobs, error));
+    ASSERT_EQ(3, jobs.size());
+    EXPECT_EQ("/data/static.dat", jobs.at(0).filename);
+    EXPECT_DOUBLE_EQ(0.0, jobs.at(0).seconds_to_skip);
+    EXPECT_EQ(0, jobs.at(0).samples);
+    EXPECT_EQ("/data/ds3.dat", jobs.at(1).filename);
+    EXPECT_DOUBLE_EQ(120.5, jobs.at(1).seconds_to_skip);
+    EXPECT_EQ(40000000, jobs.at(1).samples);
+    EXPECT_DOUBLE_EQ(60.0, jobs.at(2).seconds_to_skip);
+}
+
+
+TEST(BatchProcessorTest, ParseListRejectsMalformedLines)
+{
+    const char* malformed[] = { "a.dat ten", "a.dat -1", "a.dat 0 -5", "a.dat 0 5 extra" };
+    for (unsigned int i = 0; i < 4; i++)
+        {
+            std::stringstream list;
+            list << "ok.dat\n" << malformed[i] << "\n";
+            std::vector<BatchJob> jobs;
+            std::string error;
+            EXPECT_FALSE(BatchProcessor::parse_list(list, jobs, error)) << malformed[i];
+            EXPECT_EQ(malformed[i], error);
+        }
+}
+
+
+TEST(BatchProcessorTest, ResultRoundTrip)
+{
+    BatchResult result;
+    result.job.filename = "/data/ds3.dat";
+    result.job.seconds_to_skip = 30.0;
+    result.job.samples = 1000;
+    result.status = 0;
+    result.wall_s = 12.5;
+    result.signal_s = 50.0;
+    result.fixes = 97;
+    result.alarms = 3;
+    BatchStage stage;
+    stage.name = "tracking";
+    stage.blocks = 8;
+    stage.busy_s = 25.0;
+    result.stages.push_back(stage);
+    result.perf_json = "{\"blocks\":[]}\n";
+    result.spoofing_json = "{\"checks\":{}}\n";
+
+    std::stringstream file;
+    BatchProcessor::write_result(result, file);
+    BatchResult read;
+    ASSERT_TRUE(BatchProcessor::read_result(file, read));
+    EXPECT_EQ(result.job.filename, read.job.filename);
+    EXPECT_DOUBLE_EQ(30.0, read.job.seconds_to_skip);
+    EXPECT_EQ(1000, read.job.samples);
+    EXPECT_EQ(0, read.status);
+    EXPECT_DOUBLE_EQ(4.0, read.rt_factor());
+    EXPECT_EQ(97, read.fixes);
+    EXPECT_EQ(3, read.alarms);
+    ASSERT_EQ(1, read.stages.size());
+    EXPECT_EQ(8, read.stages.at(0).blocks);
+    EXPECT_DOUBLE_EQ(2.0, read.rt_factor(read.stages.at(0)));
+    EXPECT_EQ("{\"blocks\":[]}", read.perf_json);
+    EXPECT_EQ("{\"checks\":{}}", read.spoofing_json);
+
+    // a child that died before reporting leaves an incomplete file
+    std::stringstream truncated("filename /data/ds3.dat\nstatus 0\n");
+    EXPECT_FALSE(BatchProcessor::read_result(truncated, read));
+}
+
+
+TEST(BatchProcessorTest, SummaryAggregatesCaptures)
+{
+    std::vector<BatchResult> results(2);
+    for (unsigned int i = 0; i < 2; i++)
+        {
+            BatchResult& result = results.at(i);
+            result.job.filename = i == 0 ? "a.dat" : "b \"quoted\".dat";
+            result.job.seconds_to_skip = 0.0;
+            result.job.samples = 0;
+            result.status = 0;
+            result.wall_s = 10.0;
+            result.signal_s = 30.0;
+            result.fixes = 10;
+            result.alarms = i;
+            BatchStage stage;
+            stage.name = "acquisition";
+            stage.blocks = 4;
+            stage.busy_s = 5.0;
+            result.stages.push_back(stage);
+        }
+    results.at(1).status = 134;
+
+    BatchProcessor batch("receiver.conf", 2);
+    std::string json = batch.summary_json(results, 20.0);
+    EXPECT_NE(std::string::npos, json.find("\"captures\":2,\"failed\":1"));
+    EXPECT_NE(std::string::npos, json.find("\"signal_s\":60,\"rt_factor\":3,\"fixes\":20,\"spoofing_alarms\":1"));
+    EXPECT_NE(std::string::npos, json.find("{\"name\":\"acquisition\",\"busy_s\":10,\"rt_factor\":6}"));
+    EXPECT_NE(std::string::npos, json.find("\"file\":\"b \\\"quoted\\\".dat\""));
+    EXPECT_NE(std::string::npos, json.find("\"status\":\"failed\",\"exit_status\":134"));
+    EXPECT_NE(std::string::npos, json.find("\"perf\":null"));
+}
+
+
+TEST(BatchProcessorTest, JobOutputsGoToTheirDirectory)
+{
+    boost::filesystem::path config_file = boost::filesystem::temp_directory_path()
+            / boost::filesystem::unique_path("gnss-sdr-batch-test-%%%%-%%%%.conf");
+    {
+        std::ofstream config(config_file.string().c_str());
+        config << "[GNSS-SDR]\n"
+               << "Channels_1C.count=4\n"
+               << "Tracking_1C2.implementation=GPS_L1_CA_DLL_PLL_Tracking\n"
+               << "Tracking_1C2.dump_filename=/data/track_ch2_\n"
+               << "Spoofing.capture_filename=./capture.dat\n"
+               << "Spoofing.stats_socket=/tmp/stats.sock\n"
+               << "Spoofing.stats_http_port=8080\n";
+    }
+    std::string log_dir = FLAGS_log_dir;
+    std::string outputs[2];
+    for (unsigned int i = 0; i < 2; i++)
+        {
+            std::shared_ptr<FileConfiguration> configuration = std::make_shared<FileConfiguration>(config_file.string());
+            BatchProcessor batch(config_file.string(), 2, "/out");
+            std::string dir = batch.job_output_dir(i);
+            BatchProcessor::set_job_outputs(configuration.get(), dir);
+
+            EXPECT_EQ(dir + "/pvt.dat", configuration->property("PVT.dump_filename", std::string()));
+            EXPECT_EQ(dir + "/nmea_pvt.nmea", configuration->property("PVT.nmea_dump_filename", std::string()));
+            EXPECT_EQ(dir + "/observables.dat", configuration->property("Observables.dump_filename", std::string()));
+            EXPECT_EQ(dir + "/acquisition.dat", configuration->property("Acquisition_1C.dump_filename", std::string()));
+            EXPECT_EQ(dir + "/track_ch", configuration->property("Tracking_1C.dump_filename", std::string()));
+            EXPECT_EQ(dir + "/track_ch2_", configuration->property("Tracking_1C2.dump_filename", std::string()));
+            EXPECT_EQ(dir + "/navigation.dat", configuration->property("TelemetryDecoder_1C.dump_filename", std::string()));
+            EXPECT_EQ(dir + "/capture.dat", configuration->property("Spoofing.capture_filename", std::string()));
+            EXPECT_EQ("", configuration->property("Spoofing.stats_filename", std::string()));  // stays disabled
+            EXPECT_EQ("", configuration->property("Spoofing.stats_socket", std::string("unset")));
+            EXPECT_EQ(0, configuration->property("Spoofing.stats_http_port", 1));
+            EXPECT_EQ(dir + "/", FLAGS_log_dir);
+            outputs[i] = configuration->property("PVT.nmea_dump_filename", std::string());
+        }
+    EXPECT_EQ("/out/batch_1/nmea_pvt.nmea", outputs[1]);
+    EXPECT_NE(outputs[0], outputs[1]);
+    FLAGS_log_dir = log_dir;
+    boost::filesystem::remove(config_file);
+}
+
+
+TEST(BatchProcessorTest, RunsJobsInParallelInTheirOwnDirectories)
+{
+    boost::filesystem::path base = boost::filesystem::temp_directory_path()
+            / boost::filesystem::unique_path("gnss-sdr-batch-test-%%%%-%%%%");
+    std::vector<BatchJob> jobs(2);
+    jobs.at(0).filename = "a.dat";
+    jobs.at(1).filename = "b.dat";
+    for (unsigned int i = 0; i < 2; i++)
+        {
+            jobs.at(i).seconds_to_skip = 0.0;
+            jobs.at(i).samples = 0;
+        }
+
+    RendezvousBatch batch(base.string());
+    std::stringstream summary;
+    EXPECT_EQ(0, batch.run(jobs, summary));
+    EXPECT_NE(std::string::npos, summary.str().find("\"captures\":2,\"failed\":0"));
+    EXPECT_TRUE(boost::filesystem::exists(base / "batch_0" / "a.dat"));
+    EXPECT_TRUE(boost::filesystem::exists(base / "batch_1" / "b.dat"));
+    EXPECT_FALSE(boost::filesystem::exists(base / "batch_0" / "b.dat"));
+    EXPECT_NE(std::string::npos, summary.str().find("\"output_dir\":\"" + (base / "batch_1").string() + "\""));
+
+    boost::system::error_code ec;
+    boost::filesystem::remove_all(base, ec);
+}
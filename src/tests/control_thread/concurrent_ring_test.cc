@@ -0,0 +1,112 @@
+/*!
+ * \file concurrent_ring_test.cc
+ * \brief  This file implements tests for the bounded lock-free message queue
+ *
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <set>
+#include <string>
+#include <vector>
+#include <boost/thread.hpp>
+#include <gtest/gtest.h>
+#include "concurrent_ring.h"
+
+
+TEST(ConcurrentRingTest, FifoAndDropNewest)
+{
+    concurrent_ring<int> ring(5, RING_DROP_NEWEST);
+    EXPECT_EQ(8, ring.capacity());
+    EXPECT_TRUE(ring.empty());
+    for (int i = 0; i < 10; i++)
+        {
+            EXPECT_EQ(i < 8, ring.push(i));
+        }
+    EXPECT_EQ(8, ring.size());
+    EXPECT_EQ(8, ring.high_water());
+    EXPECT_EQ(8, ring.pushed());
+    EXPECT_EQ(2, ring.dropped());
+
+    int value = -1;
+    ASSERT_TRUE(ring.try_pop(value));
+    EXPECT_EQ(0, value);
+    std::vector<int> batch;
+    EXPECT_EQ(3, ring.pop_batch(batch, 3));
+    EXPECT_EQ(std::vector<int>({ 1, 2, 3 }), batch);
+    EXPECT_EQ(4, ring.pop_batch(batch, 100));
+    EXPECT_EQ(7, batch.back());
+    EXPECT_FALSE(ring.try_pop(value));
+    EXPECT_TRUE(ring.empty());
+
+    // wraps around with messages that own memory
+    concurrent_ring<std::string> strings(2);
+    for (int i = 0; i < 20; i++)
+        {
+            std::string s(100, 'a' + i % 26);
+            ASSERT_TRUE(strings.push(s));
+            std::string out;
+            ASSERT_TRUE(strings.try_pop(out));
+            EXPECT_EQ(s, out);
+        }
+}
+
+
+TEST(ConcurrentRingTest, MultipleProducersBlocking)
+{
+    const int producers = 4;
+    const int per_producer = 20000;
+    concurrent_ring<int> ring(64, RING_BLOCK);
+
+    boost::thread_group threads;
+    for (int p = 0; p < producers; p++)
+        {
+            threads.create_thread([&ring, p, per_producer]()
+                    {
+                        for (int i = 0; i < per_producer; i++)
+                            {
+                                ring.push(p * per_producer + i);
+                            }
+                    });
+        }
+
+    std::vector<int> last(producers, -1);
+    std::set<int> seen;
+    for (int n = 0; n < producers * per_producer; n++)
+        {
+            int value;
+            ring.wait_and_pop(value);
+            int p = value / per_producer;
+            EXPECT_LT(last.at(p), value); // each producer's messages stay in order
+            last.at(p) = value;
+            seen.insert(value);
+        }
+    threads.join_all();
+
+    EXPECT_EQ(static_cast<size_t>(producers * per_producer), seen.size());
+    EXPECT_EQ(0, ring.dropped());
+    EXPECT_LE(ring.high_water(), ring.capacity());
+    EXPECT_TRUE(ring.empty());
+}
@@ -0,0 +1,77 @@
+/*!
+ * \file block_layout_test.cc
+ * \brief  This file implements tests for the receiver block layout
+ *
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "block_layout.h"
+#include "in_memory_configuration.h"
+
+
+TEST(BlockLayoutTest, ParseCpuList)
+{
+    std::vector<int> expected = { 0, 1, 2, 3, 8, 10, 11 };
+    EXPECT_EQ(expected, BlockLayout::parse_cpu_list("0-3,8, 10-11"));
+    EXPECT_EQ(std::vector<int>(1, 5), BlockLayout::parse_cpu_list("x,5,3-1,-2,7a"));
+    EXPECT_TRUE(BlockLayout::parse_cpu_list("").empty());
+    EXPECT_EQ(std::string("4,5,6"), BlockLayout::cpu_list_str(BlockLayout::parse_cpu_list("4-6")));
+}
+
+
+TEST(BlockLayoutTest, ChannelGroups)
+{
+    std::shared_ptr<InMemoryConfiguration> configuration = std::make_shared<InMemoryConfiguration>();
+    BlockLayout unset(configuration);
+    EXPECT_FALSE(unset.enabled());
+    EXPECT_TRUE(unset.cpus("tracking", 3).empty());
+    EXPECT_EQ(-1, unset.priority("tracking"));
+
+    configuration->set_property("Layout.source.cpus", "0-1");
+    configuration->set_property("Layout.tracking.cpus", "4-7");
+    configuration->set_property("Layout.tracking.channels_per_cpu", "3");
+    configuration->set_property("Layout.tracking.priority", "70");
+    configuration->set_property("Layout.pvt.max_output_buffer", "4096");
+    BlockLayout layout(configuration);
+    EXPECT_TRUE(layout.enabled());
+    EXPECT_FALSE(layout.realtime());
+
+    std::vector<int> source = { 0, 1 };
+    EXPECT_EQ(source, layout.cpus("source", 9));
+    EXPECT_EQ(std::vector<int>(1, 4), layout.cpus("tracking", 0));
+    EXPECT_EQ(std::vector<int>(1, 4), layout.cpus("tracking", 2));
+    EXPECT_EQ(std::vector<int>(1, 5), layout.cpus("tracking", 3));
+    EXPECT_EQ(std::vector<int>(1, 7), layout.cpus("tracking", 11));
+    EXPECT_EQ(std::vector<int>(1, 4), layout.cpus("tracking", 12));
+    EXPECT_TRUE(layout.cpus("acquisition", 0).empty());
+    EXPECT_EQ(70, layout.priority("tracking"));
+    EXPECT_EQ(4096, layout.max_output_buffer("pvt"));
+    EXPECT_EQ(0, layout.max_output_buffer("tracking"));
+}
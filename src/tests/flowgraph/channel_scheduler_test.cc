@@ -0,0 +1,134 @@
+/*!
+ * \file channel_scheduler_test.cc
+ * \brief  This file implements tests for the channel assignment scheduler
+ *
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "channel_scheduler.h"
+
+
+TEST(ChannelSchedulerTest, PoolsPerSignalType)
+{
+    ChannelScheduler scheduler;
+    for (unsigned int prn = 1; prn <= 4; prn++)
+        {
+            scheduler.push_back(Gnss_Signal(Gnss_Satellite(std::string("GPS"), prn), std::string("1C")));
+            scheduler.push_back(Gnss_Signal(Gnss_Satellite(std::string("Galileo"), prn), std::string("1B")));
+        }
+    Gnss_Signal gps3 = Gnss_Signal(Gnss_Satellite(std::string("GPS"), 3), std::string("1C"));
+    scheduler.push_back(gps3);
+    EXPECT_EQ(9, scheduler.pending());
+    EXPECT_EQ(2, scheduler.pending(gps3));
+
+    Gnss_Signal signal;
+    EXPECT_TRUE(scheduler.next(0, "1B", signal));
+    EXPECT_EQ(std::string("Galileo"), signal.get_satellite().get_system());
+    EXPECT_EQ(1, signal.get_satellite().get_PRN());
+    EXPECT_TRUE(scheduler.next(0, "1C", signal));
+    EXPECT_EQ(std::string("GPS"), signal.get_satellite().get_system());
+    EXPECT_EQ(1, signal.get_satellite().get_PRN());
+    EXPECT_FALSE(scheduler.next(0, "5X", signal));
+
+    scheduler.remove(gps3);
+    EXPECT_EQ(0, scheduler.pending(gps3));
+    EXPECT_EQ(5, scheduler.pending());
+
+    scheduler.preassign(7, gps3);
+    EXPECT_TRUE(scheduler.next(7, "1C", signal));
+    EXPECT_TRUE(signal == gps3);
+    EXPECT_TRUE(scheduler.next(7, "1C", signal));
+    EXPECT_EQ(2, signal.get_satellite().get_PRN());
+}
+
+
+TEST(ChannelSchedulerTest, StandbyChannels)
+{
+    ChannelScheduler scheduler;
+    std::vector<std::string> types = { "1C", "1C", "1B", "1C", "1B" };
+    scheduler.set_channels(types, 2);
+    EXPECT_EQ(2, scheduler.acquiring_channels());
+    EXPECT_EQ(1, scheduler.get_state(1));
+    EXPECT_EQ(0, scheduler.get_state(2));
+
+    unsigned int channel = 0;
+    EXPECT_FALSE(scheduler.take_standby(channel));
+
+    scheduler.push_back(Gnss_Signal(Gnss_Satellite(std::string("GPS"), 5), std::string("1C")));
+    EXPECT_TRUE(scheduler.take_standby(channel));
+    EXPECT_EQ(3, channel);
+    EXPECT_EQ(3, scheduler.acquiring_channels());
+
+    scheduler.push_back(Gnss_Signal(Gnss_Satellite(std::string("Galileo"), 5), std::string("1B")));
+    scheduler.set_state(0, 2);
+    scheduler.set_state(0, 0);
+    EXPECT_EQ(2, scheduler.acquiring_channels());
+    EXPECT_TRUE(scheduler.take_standby(channel));
+    EXPECT_EQ(0, channel);
+    EXPECT_TRUE(scheduler.take_standby(channel));
+    EXPECT_EQ(2, channel);
+}
+
+
+TEST(ChannelSchedulerTest, AuxiliaryPeaks)
+{
+    ChannelScheduler scheduler;
+    scheduler.set_peaks(2, 3);
+    scheduler.add_satellite(7);
+    Gnss_Signal sat7 = Gnss_Signal(Gnss_Satellite(std::string("GPS"), 7), std::string("1C"));
+
+    EXPECT_EQ(1, scheduler.assign_peak(7, 0));
+    EXPECT_EQ(2, scheduler.assign_peak(7, 1));
+    EXPECT_EQ(0, scheduler.assign_peak(7, 2));
+    EXPECT_EQ(0, scheduler.get_peak(2));
+    EXPECT_EQ(2, scheduler.acquiring(7));
+    EXPECT_FALSE(scheduler.wants_more_peaks(sat7));
+
+    // a channel moving on to the next peak keeps its slot, and peaks wrap around
+    EXPECT_EQ(3, scheduler.assign_peak(7, 1));
+    EXPECT_EQ(1, scheduler.assign_peak(7, 1));
+    EXPECT_EQ(2, scheduler.acquiring(7));
+
+    scheduler.peak_lost(1, false);
+    EXPECT_EQ(1, scheduler.acquiring(7));
+    EXPECT_TRUE(scheduler.wants_more_peaks(sat7));
+    scheduler.push_back(sat7);
+    EXPECT_FALSE(scheduler.wants_more_peaks(sat7));
+
+    scheduler.peak_acquired(0);
+    EXPECT_EQ(2, scheduler.assign_peak(7, 3));
+
+    scheduler.peak_lost(3, true);
+    scheduler.peak_lost(3, true);
+    EXPECT_EQ(1, scheduler.acquiring(7));
+    EXPECT_EQ(1, scheduler.assign_peak(7, 4));
+
+    // satellites not under APT are never given a peak
+    EXPECT_EQ(0, scheduler.assign_peak(8, 5));
+}
@@ -30,12 +30,15 @@
  * -------------------------------------------------------------------------
  */
 
+#include <chrono>
+#include <iostream>
 #include <gnuradio/msg_queue.h>
 #include <gtest/gtest.h>
 #include "gnss_flowgraph.h"
 #include "gnss_block_interface.h"
 #include "in_memory_configuration.h"
 #include "file_configuration.h"
+#include "receiver_configuration.h"
 #include "channel.h"
 #include "acquisition_interface.h"
 #include "tracking_interface.h"
@@ -279,3 +282,101 @@ TEST(GNSSFlowgraph, InstantiateConnectStartStopHybrid)
     EXPECT_FALSE(flowgraph->running());
 }
 
+
+
+TEST(GNSSFlowgraph, ConstructionTime)
+{
+    std::shared_ptr<ConfigurationInterface> config = std::make_shared<InMemoryConfiguration>();
+
+    config->set_property("GNSS-SDR.SUPL_gps_enabled", "false");
+    config->set_property("SignalSource.sampling_frequency", "4000000");
+    config->set_property("SignalSource.implementation", "File_Signal_Source");
+    config->set_property("SignalSource.item_type", "gr_complex");
+    config->set_property("SignalSource.repeat", "true");
+    std::string path = std::string(TEST_PATH);
+    std::string filename = path + "signal_samples/Galileo_E1_ID_1_Fs_4Msps_8ms.dat";
+    config->set_property("SignalSource.filename", filename);
+    config->set_property("SignalConditioner.implementation", "Pass_Through");
+    config->set_property("Channels_1C.count", "12");
+    config->set_property("Channels.in_acquisition", "1");
+    config->set_property("Acquisition_1C.implementation", "GPS_L1_CA_PCPS_Acquisition");
+    config->set_property("Acquisition_1C.threshold", "1");
+    config->set_property("Acquisition_1C.doppler_max", "5000");
+    config->set_property("Tracking_1C.implementation", "GPS_L1_CA_DLL_PLL_Tracking");
+    config->set_property("TelemetryDecoder_1C.implementation", "GPS_L1_CA_Telemetry_Decoder");
+    config->set_property("Observables.implementation", "GPS_L1_CA_Observables");
+    config->set_property("PVT.implementation", "GPS_L1_CA_PVT");
+
+    // a rebuild at run time (reconfiguration, channel pool changes) costs what the later runs take
+    for (unsigned int run = 0; run < 3; run++)
+        {
+            std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+            std::shared_ptr<GNSSFlowgraph> flowgraph = std::make_shared<GNSSFlowgraph>(config, gr::msg_queue::make(0));
+            std::chrono::steady_clock::time_point built = std::chrono::steady_clock::now();
+            EXPECT_NO_THROW(flowgraph->connect());
+            std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+            EXPECT_TRUE(flowgraph->connected());
+            std::cout << "Flowgraph with 12 channels (run " << run << ") built in "
+                      << std::chrono::duration_cast<std::chrono::microseconds>(built - begin).count()
+                      << " microseconds and connected in "
+                      << std::chrono::duration_cast<std::chrono::microseconds>(end - built).count()
+                      << " microseconds" << std::endl;
+        }
+}
+
+
+TEST(GNSSFlowgraph, HostedReceiverSharesSource)
+{
+    std::shared_ptr<ConfigurationInterface> config = std::make_shared<InMemoryConfiguration>();
+
+    config->set_property("GNSS-SDR.internal_fs_hz", "4000000");
+    config->set_property("SignalSource.sampling_frequency", "4000000");
+    config->set_property("SignalSource.implementation", "File_Signal_Source");
+    config->set_property("SignalSource.item_type", "gr_complex");
+    config->set_property("SignalSource.repeat", "true");
+    std::string path = std::string(TEST_PATH);
+    std::string filename = path + "signal_samples/Galileo_E1_ID_1_Fs_4Msps_8ms.dat";
+    config->set_property("SignalSource.filename", filename);
+    config->set_property("SignalConditioner.implementation", "Pass_Through");
+    config->set_property("Channels_1C.count", "4");
+    config->set_property("Channels.in_acquisition", "1");
+    config->set_property("Acquisition_1C.implementation", "GPS_L1_CA_PCPS_Acquisition");
+    config->set_property("Acquisition_1C.threshold", "1");
+    config->set_property("Acquisition_1C.doppler_max", "5000");
+    config->set_property("Tracking_1C.implementation", "GPS_L1_CA_DLL_PLL_Tracking");
+    config->set_property("TelemetryDecoder_1C.implementation", "GPS_L1_CA_Telemetry_Decoder");
+    config->set_property("Observables.implementation", "GPS_L1_CA_Observables");
+    config->set_property("PVT.implementation", "GPS_L1_CA_PVT");
+
+    // a second receiver with other channels, no signal source of its own
+    std::shared_ptr<ConfigurationInterface> own = std::make_shared<InMemoryConfiguration>();
+    own->set_property("Channels_1C.count", "2");
+    own->set_property("Channels.in_acquisition", "1");
+    own->set_property("Acquisition_1C.implementation", "GPS_L1_CA_PCPS_Acquisition");
+    own->set_property("Acquisition_1C.threshold", "1");
+    own->set_property("Acquisition_1C.doppler_max", "5000");
+    own->set_property("Tracking_1C.implementation", "GPS_L1_CA_DLL_PLL_Tracking");
+    own->set_property("TelemetryDecoder_1C.implementation", "GPS_L1_CA_Telemetry_Decoder");
+    own->set_property("Observables.implementation", "GPS_L1_CA_Observables");
+    own->set_property("PVT.implementation", "GPS_L1_CA_PVT");
+    std::shared_ptr<ConfigurationInterface> receiver_config = std::make_shared<ReceiverConfiguration>(config, own);
+
+    std::shared_ptr<GNSSFlowgraph> flowgraph = std::make_shared<GNSSFlowgraph>(config, gr::msg_queue::make(0));
+    std::shared_ptr<GNSSFlowgraph> receiver = std::make_shared<GNSSFlowgraph>(receiver_config, gr::msg_queue::make(0), flowgraph);
+    EXPECT_FALSE(flowgraph->hosted());
+    EXPECT_TRUE(receiver->hosted());
+
+    EXPECT_NO_THROW(flowgraph->connect());
+    EXPECT_TRUE(flowgraph->connected());
+    EXPECT_NO_THROW(receiver->connect());
+    EXPECT_TRUE(receiver->connected());
+
+    EXPECT_NO_THROW(flowgraph->start());
+    EXPECT_TRUE(flowgraph->running());
+    EXPECT_NO_THROW(receiver->start());
+    EXPECT_TRUE(receiver->running());
+    receiver->stop();
+    EXPECT_FALSE(receiver->running());
+    flowgraph->stop();
+    EXPECT_FALSE(flowgraph->running());
+}
@@ -0,0 +1,101 @@
+/*!
+ * \file gps_nav_digest_test.cc
+ * \brief  This file implements tests for the GPS NAV message digests
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <gtest/gtest.h>
+#include "gps_nav_digest.h"
+#include "gps_ephemeris.h"
+#include "gps_almanac.h"
+#include "gps_iono.h"
+
+
+TEST(GpsNavDigestTest, EmptyAndOrder)
+{
+    Gps_Nav_Digest empty;
+    EXPECT_TRUE(empty.empty());
+
+    Gps_Nav_Digest a, b;
+    a.add(1.0);
+    a.add(2);
+    b.add(2);
+    b.add(1.0);
+    EXPECT_FALSE(a.empty());
+    EXPECT_TRUE(a != b);
+    EXPECT_TRUE(a != empty);
+
+    Gps_Nav_Digest c;
+    c.add(1.0);
+    c.add(2);
+    EXPECT_TRUE(a == c);
+    EXPECT_EQ(a.to_string(), c.to_string());
+    EXPECT_EQ(32, a.to_string().size());
+
+    Gps_Nav_Digest zero, negative_zero;
+    zero.add(0.0);
+    negative_zero.add(-0.0);
+    EXPECT_TRUE(zero == negative_zero);
+}
+
+
+TEST(GpsNavDigestTest, EphemerisMaskedTOW)
+{
+    Gps_Ephemeris eph_a;
+    eph_a.i_satellite_PRN = 12;
+    eph_a.d_TOW = 345600.0;
+    eph_a.d_sqrt_A = 5153.6;
+    eph_a.d_e_eccentricity = 0.0123;
+    Gps_Ephemeris eph_b = eph_a;
+    eph_b.d_TOW = 345630.0;
+
+    EXPECT_TRUE(gps_ephemeris_digest(eph_a, true) == gps_ephemeris_digest(eph_b, true));
+    EXPECT_TRUE(gps_ephemeris_digest(eph_a, false) != gps_ephemeris_digest(eph_b, false));
+
+    eph_b.d_e_eccentricity = 0.0124;
+    EXPECT_TRUE(gps_ephemeris_digest(eph_a, true) != gps_ephemeris_digest(eph_b, true));
+}
+
+
+TEST(GpsNavDigestTest, AlmanacAndIono)
+{
+    Gps_Almanac alm_a;
+    alm_a.i_satellite_PRN = 3;
+    alm_a.d_Toa = 61440.0;
+    Gps_Almanac alm_b = alm_a;
+    EXPECT_TRUE(gps_almanac_digest(alm_a) == gps_almanac_digest(alm_b));
+    alm_b.d_OMEGA = 0.5;
+    EXPECT_TRUE(gps_almanac_digest(alm_a) != gps_almanac_digest(alm_b));
+    alm_b = alm_a;
+    alm_b.i_SV_health = 1;
+    EXPECT_TRUE(gps_almanac_digest(alm_a) != gps_almanac_digest(alm_b));
+
+    Gps_Iono iono_a;
+    Gps_Iono iono_b;
+    EXPECT_TRUE(gps_iono_digest(iono_a) == gps_iono_digest(iono_b));
+    iono_b.valid = true;
+    EXPECT_TRUE(gps_iono_digest(iono_a) != gps_iono_digest(iono_b));
+}
@@ -0,0 +1,200 @@
+/*!
+ * \file spoofing_capture_test.cc
+ * \brief Writes a spoofing capture and reads it back record by record
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "spoofing_capture.h"
+
+
+namespace
+{
+Capture_Synchro make_capture_synchro(unsigned int channel, unsigned int k)
+{
+    Capture_Synchro s;
+    s.channel = channel;
+    s.PRN = 3 + channel;
+    s.peak = channel % 2;
+    s.uid = 100 + channel;
+    s.state = 2;
+    s.Flag_valid_pseudorange = (channel != 1);
+    s.CN0_dB_hz = 40.0 + 0.25 * channel + k;
+    s.Carrier_Doppler_hz = -1234.5 + channel;
+    s.Prompt_I = 1e4 + k;
+    s.Prompt_Q = -3.5 * channel;
+    s.Tracking_timestamp_secs = 0.001 * k;
+    s.d_TOW_at_current_symbol = 345600.0 + 0.001 * k;
+    s.Pseudorange_m = 2.1e7 + 17.0 * channel;
+    for (unsigned int i = 0; i < 2; i++)
+        {
+            s.Early[i] = 0.5f * k + i;
+            s.Prompt[i] = 1.5f * k - i;
+            s.Late[i] = 2.5f * channel + i;
+        }
+    return s;
+}
+
+void expect_equal(const Capture_Synchro& a, const Capture_Synchro& b)
+{
+    EXPECT_EQ(a.channel, b.channel);
+    EXPECT_EQ(a.PRN, b.PRN);
+    EXPECT_EQ(a.peak, b.peak);
+    EXPECT_EQ(a.uid, b.uid);
+    EXPECT_EQ(a.state, b.state);
+    EXPECT_EQ(a.Flag_valid_pseudorange, b.Flag_valid_pseudorange);
+    EXPECT_EQ(a.CN0_dB_hz, b.CN0_dB_hz);
+    EXPECT_EQ(a.Carrier_Doppler_hz, b.Carrier_Doppler_hz);
+    EXPECT_EQ(a.Prompt_I, b.Prompt_I);
+    EXPECT_EQ(a.Prompt_Q, b.Prompt_Q);
+    EXPECT_EQ(a.Tracking_timestamp_secs, b.Tracking_timestamp_secs);
+    EXPECT_EQ(a.d_TOW_at_current_symbol, b.d_TOW_at_current_symbol);
+    EXPECT_EQ(a.Pseudorange_m, b.Pseudorange_m);
+    for (unsigned int i = 0; i < 2; i++)
+        {
+            EXPECT_EQ(a.Early[i], b.Early[i]);
+            EXPECT_EQ(a.Prompt[i], b.Prompt[i]);
+            EXPECT_EQ(a.Late[i], b.Late[i]);
+        }
+}
+}
+
+
+TEST(SpoofingCaptureTest, RecordsRoundTrip)
+{
+    std::string filename = "./spoofing_capture_test.dat";
+    const unsigned int nchannels = 3;
+
+    std::vector<std::vector<Capture_Synchro> > epochs(3);
+    for (unsigned int k = 0; k < epochs.size(); k++)
+        {
+            for (unsigned int ch = 0; ch < nchannels; ch++)
+                {
+                    epochs[k].push_back(make_capture_synchro(ch, k));
+                }
+        }
+    Capture_Subframe subframe;
+    std::memset(&subframe, 0, sizeof(subframe));
+    subframe.channel = 2;
+    subframe.PRN = 5;
+    subframe.peak = 1;
+    subframe.uid = 102;
+    subframe.timestamp_ms = 123456.25;
+    subframe.receiver_time_ms = 129456.5;
+    for (unsigned int i = 0; i < GPS_SUBFRAME_LENGTH; i++)
+        {
+            subframe.subframe[i] = (i % 3 == 0) ? '1' : '0';
+        }
+    Gps_Ephemeris eph;
+    eph.i_satellite_PRN = 5;
+    eph.i_peak = 1;
+    eph.uid = 102;
+    eph.d_TOW = 345606.0;
+    eph.d_sqrt_A = 5153.6;
+    eph.d_e_eccentricity = 0.0123;
+    eph.i_GPS_week = 1890;
+    eph.d_A_f0 = -1.5e-5;
+    eph.b_antispoofing_flag = true;
+
+    Spoofing_Capture_Writer writer;
+    ASSERT_TRUE(writer.open(filename, nchannels));
+    writer.write_epoch(1000, epochs[0]);
+    writer.write_subframe(subframe);
+    writer.write_epoch(1001, epochs[1]);
+    writer.write_ephemeris(102, eph);
+    writer.write_epoch(1002, epochs[2]);
+    EXPECT_EQ(5, writer.get_records());
+    writer.close();
+
+    // cut the last epoch record short, as after a crash of the receiver
+    std::string contents;
+    {
+        std::ifstream in(filename.c_str(), std::ios::binary);
+        contents.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    ASSERT_GT(contents.size(), 10u);
+    {
+        std::ofstream out(filename.c_str(), std::ios::binary | std::ios::trunc);
+        out.write(contents.data(), contents.size() - 10);
+    }
+
+    Spoofing_Capture_Reader reader;
+    ASSERT_TRUE(reader.open(filename));
+    EXPECT_EQ(nchannels, reader.get_nchannels());
+
+    ASSERT_EQ(CAPTURE_EPOCH, reader.next());
+    EXPECT_EQ(1000, reader.get_sample_counter());
+    ASSERT_EQ(nchannels, reader.get_epoch().size());
+    for (unsigned int ch = 0; ch < nchannels; ch++)
+        {
+            expect_equal(epochs[0][ch], reader.get_epoch()[ch]);
+        }
+
+    ASSERT_EQ(CAPTURE_SUBFRAME, reader.next());
+    const Capture_Subframe& read_subframe = reader.get_subframe();
+    EXPECT_EQ(subframe.channel, read_subframe.channel);
+    EXPECT_EQ(subframe.PRN, read_subframe.PRN);
+    EXPECT_EQ(subframe.peak, read_subframe.peak);
+    EXPECT_EQ(subframe.uid, read_subframe.uid);
+    EXPECT_EQ(subframe.timestamp_ms, read_subframe.timestamp_ms);
+    EXPECT_EQ(subframe.receiver_time_ms, read_subframe.receiver_time_ms);
+    EXPECT_EQ(0, std::memcmp(subframe.subframe, read_subframe.subframe, GPS_SUBFRAME_LENGTH));
+
+    ASSERT_EQ(CAPTURE_EPOCH, reader.next());
+    EXPECT_EQ(1001, reader.get_sample_counter());
+    ASSERT_EQ(nchannels, reader.get_epoch().size());
+    for (unsigned int ch = 0; ch < nchannels; ch++)
+        {
+            expect_equal(epochs[1][ch], reader.get_epoch()[ch]);
+        }
+
+    ASSERT_EQ(CAPTURE_EPHEMERIS, reader.next());
+    EXPECT_EQ(102, reader.get_ephemeris_key());
+    const Gps_Ephemeris& read_eph = reader.get_ephemeris();
+    EXPECT_EQ(eph.i_satellite_PRN, read_eph.i_satellite_PRN);
+    EXPECT_EQ(eph.i_peak, read_eph.i_peak);
+    EXPECT_EQ(eph.uid, read_eph.uid);
+    EXPECT_EQ(eph.d_TOW, read_eph.d_TOW);
+    EXPECT_EQ(eph.d_sqrt_A, read_eph.d_sqrt_A);
+    EXPECT_EQ(eph.d_e_eccentricity, read_eph.d_e_eccentricity);
+    EXPECT_EQ(eph.i_GPS_week, read_eph.i_GPS_week);
+    EXPECT_EQ(eph.d_A_f0, read_eph.d_A_f0);
+    EXPECT_EQ(eph.b_antispoofing_flag, read_eph.b_antispoofing_flag);
+
+    // the truncated record ends the capture
+    EXPECT_EQ(CAPTURE_END, reader.next());
+    EXPECT_EQ(CAPTURE_END, reader.next());
+
+    std::remove(filename.c_str());
+}
@@ -0,0 +1,141 @@
+/*!
+ * \file spoofing_event_log_test.cc
+ * \brief  This file implements tests for the spoofing event log
+ *
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <boost/thread.hpp>
+#include <gtest/gtest.h>
+#include "spoofing_event_log.h"
+
+
+TEST(SpoofingEventLogTest, FoldsRepeatedAlarms)
+{
+    std::string filename = "./spoofing_event_log_test.dat";
+    std::string report_filename = "./spoofing_event_log_test.txt";
+    Spoofing_Event_Log log;
+    ASSERT_TRUE(log.open(filename, report_filename, 1000.0, 10));
+
+    // an alarm every 100 ms for 2.5 s, and one alarm of another satellite
+    for (unsigned int t = 0; t < 2500; t += 100)
+        {
+            Spoofing_Message msg;
+            msg.spoofing_case = 1;
+            msg.satellites.insert(5);
+            msg.metric = "peak_separation_ms";
+            msg.value = 0.001 * t;
+            msg.alarm_time_ms = t;
+            msg.spoofing_report = "alarm\n";
+            log.push(msg, t);
+        }
+    Spoofing_Message other;
+    other.spoofing_case = 1;
+    other.satellites.insert(7);
+    other.spoofing_report = "other\n";
+    log.push(other, 150);
+    log.close();
+
+    EXPECT_EQ(26, log.get_alarms());
+    // logged at 0, 1000 and 2000 ms, the satellite 7 alarm, and at close the 4 alarms folded after 2000 ms
+    EXPECT_EQ(5, log.get_records());
+    EXPECT_EQ(22, log.get_suppressed());
+
+    Spoofing_Event_Reader reader;
+    ASSERT_TRUE(reader.open(filename));
+    std::vector<Spoofing_Event> events;
+    Spoofing_Event event;
+    while (reader.next(event))
+        {
+            events.push_back(event);
+        }
+    ASSERT_EQ(5, events.size());
+    EXPECT_EQ(1, events.at(0).repeats);
+    EXPECT_EQ(10, events.at(1).repeats);
+    EXPECT_DOUBLE_EQ(100.0, events.at(1).first_alarm_time_ms);
+    EXPECT_DOUBLE_EQ(1000.0, events.at(1).alarm_time_ms);
+    EXPECT_EQ("peak_separation_ms", events.at(1).metric);
+    EXPECT_DOUBLE_EQ(1.0, events.at(1).value);
+    EXPECT_EQ(10, events.at(2).repeats);
+    EXPECT_EQ(7, events.at(3).satellites.at(0));
+    EXPECT_EQ(150, events.at(3).sample_counter);
+    EXPECT_EQ(4, events.at(4).repeats);
+    EXPECT_DOUBLE_EQ(2400.0, events.at(4).alarm_time_ms);
+
+    unsigned long int alarms = 0;
+    for (unsigned int i = 0; i < events.size(); i++) alarms += events.at(i).repeats;
+    EXPECT_EQ(26, alarms);
+    EXPECT_EQ("alarm\nThe same alarm was raised 4 times between 2.1 s and 2.4 s.\n", spoofing_event_report(events.at(4)));
+
+    std::remove(filename.c_str());
+    std::remove(report_filename.c_str());
+}
+
+
+TEST(SpoofingEventLogTest, LogsFoldedAlarmsThatStopRepeating)
+{
+    std::string filename = "./spoofing_event_log_stale_test.dat";
+    Spoofing_Event_Log log;
+    ASSERT_TRUE(log.open(filename, "", 50.0, 5));
+
+    // three alarms in a row, then none: the last two are folded
+    for (unsigned int t = 0; t < 30; t += 10)
+        {
+            Spoofing_Message msg;
+            msg.spoofing_case = 3;
+            msg.alarm_time_ms = t;
+            log.push(msg, t);
+        }
+    EXPECT_EQ(1, log.get_records());
+    EXPECT_EQ(2, log.get_suppressed());
+
+    // the writer logs them once the interval has passed, not at close()
+    std::vector<Spoofing_Event> events;
+    for (int i = 0; i < 200 && events.size() < 2; i++)
+        {
+            boost::this_thread::sleep_for(boost::chrono::milliseconds(10));
+            events.clear();
+            Spoofing_Event_Reader reader;
+            ASSERT_TRUE(reader.open(filename));
+            Spoofing_Event event;
+            while (reader.next(event))
+                {
+                    events.push_back(event);
+                }
+        }
+    EXPECT_EQ(2, log.get_records());
+    ASSERT_EQ(2, events.size());
+    EXPECT_EQ(2, events.at(1).repeats);
+    EXPECT_DOUBLE_EQ(10.0, events.at(1).first_alarm_time_ms);
+    EXPECT_DOUBLE_EQ(20.0, events.at(1).alarm_time_ms);
+
+    log.close();
+    EXPECT_EQ(2, log.get_records());
+    std::remove(filename.c_str());
+}
@@ -0,0 +1,293 @@
+/*!
+ * \file spoofing_external_nav_test.cc
+ * \brief  This file implements tests for the cached external navigation data
+ *
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <boost/thread.hpp>
+#include <gtest/gtest.h>
+#include "concurrent_ring.h"
+#include "gps_navigation_message.h"
+#include "in_memory_configuration.h"
+#include "spoofing_detector.h"
+#include "spoofing_external_nav.h"
+#include "spoofing_message.h"
+
+extern concurrent_ring<Spoofing_Message> global_spoofing_queue;
+
+
+class Fake_External_Source : public Spoofing_External_Source
+{
+public:
+    Fake_External_Source() : fail(false), fetches(0) {}
+    std::string name() const { return "fake"; }
+    bool fetch(Spoofing_External_Kind kind, Spoofing_External_Nav_Data& data)
+    {
+        fetches++;
+        if (fail || kind != SPOOFING_EXTERNAL_IONO) return false;
+        data.iono.valid = true;
+        data.iono.d_alpha0 = 1e-8;
+        data.set(kind);
+        return true;
+    }
+    std::atomic<bool> fail;
+    std::atomic<int> fetches;
+};
+
+
+/*
+ * Answers nothing until released
+ */
+class Gated_External_Source : public Fake_External_Source
+{
+public:
+    Gated_External_Source() : released(false) {}
+    bool fetch(Spoofing_External_Kind kind, Spoofing_External_Nav_Data& data)
+    {
+        while (!released)
+            {
+                boost::this_thread::sleep_for(boost::chrono::milliseconds(1));
+            }
+        return Fake_External_Source::fetch(kind, data);
+    }
+    std::atomic<bool> released;
+};
+
+
+/*
+ * Answers the almanac it holds
+ */
+class Almanac_External_Source : public Spoofing_External_Source
+{
+public:
+    std::string name() const { return "almanac"; }
+    bool fetch(Spoofing_External_Kind kind, Spoofing_External_Nav_Data& data)
+    {
+        if (kind != SPOOFING_EXTERNAL_ALMANAC) return false;
+        data.almanac = almanac;
+        data.set(kind);
+        return true;
+    }
+    std::map<int, Gps_Almanac> almanac;
+};
+
+
+TEST(SpoofingExternalNavTest, ReadsRinex2)
+{
+    std::string filename = "spoofing_external_nav_test.nav";
+    std::ofstream file(filename.c_str());
+    file << "     2.11           N: GPS NAV DATA                         RINEX VERSION / TYPE\n"
+         << "    0.1118D-07  0.7451D-08 -0.5960D-07 -0.5960D-07          ION ALPHA\n"
+         << "    0.9011D+05  0.4915D+05 -0.1966D+06 -0.3277D+06          ION BETA\n"
+         << "    0.133179128170D-06 0.107469588780D-12   552960     1025 DELTA-UTC: A0,A1,T,W\n"
+         << "    13                                                      LEAP SECONDS\n"
+         << "                                                            END OF HEADER\n"
+         << " 6 99  9  2 17 51 44.0 -.839701388031D-03 -.165982783074D-10  .000000000000D+00\n"
+         << "     .910000000000D+02  .934062500000D+02  .116040547840D-08  .162092304801D+00\n"
+         << "     .484101474285D-05  .626740418375D-02  .652112066746D-05  .515365489006D+04\n"
+         << "     .409904000000D+06 -.242143869400D-07  .329237003460D+00 -.596046447754D-07\n"
+         << "     .111541663136D+01  .326593750000D+03  .206958726335D+01 -.638312302555D-08\n"
+         << "     .307155651409D-09  .000000000000D+00  .102500000000D+04  .000000000000D+00\n"
+         << "     .000000000000D+00  .000000000000D+00  .910000000000D+02  .910000000000D+03\n"
+         << "     .406800000000D+06  .000000000000D+00\n";
+    file.close();
+
+    Spoofing_External_Nav_Data data;
+    ASSERT_TRUE(Spoofing_Rinex_Source::read(filename, data));
+    std::remove(filename.c_str());
+
+    EXPECT_TRUE(data.valid[SPOOFING_EXTERNAL_EPHEMERIS]);
+    EXPECT_TRUE(data.valid[SPOOFING_EXTERNAL_IONO]);
+    EXPECT_TRUE(data.valid[SPOOFING_EXTERNAL_UTC]);
+    EXPECT_FALSE(data.valid[SPOOFING_EXTERNAL_ALMANAC]);
+
+    EXPECT_DOUBLE_EQ(0.1118e-07, data.iono.d_alpha0);
+    EXPECT_DOUBLE_EQ(-0.3277e+06, data.iono.d_beta3);
+    EXPECT_DOUBLE_EQ(0.133179128170e-06, data.utc.d_A0);
+    EXPECT_EQ(1025, data.utc.i_WN_T);
+    EXPECT_EQ(13, data.utc.d_DeltaT_LS);
+
+    ASSERT_EQ(1, data.ephemeris.count(6));
+    const Gps_Ephemeris& eph = data.ephemeris.at(6);
+    EXPECT_DOUBLE_EQ(-.839701388031e-03, eph.d_A_f0);
+    EXPECT_DOUBLE_EQ(.515365489006e+04, eph.d_sqrt_A);
+    EXPECT_DOUBLE_EQ(409904.0, eph.d_Toe);
+    // 1999-09-02 was a Thursday
+    EXPECT_DOUBLE_EQ(409904.0, eph.d_Toc);
+    EXPECT_EQ(1025, eph.i_GPS_week);
+    EXPECT_DOUBLE_EQ(-.638312302555e-08, eph.d_OMEGA_DOT);
+    EXPECT_DOUBLE_EQ(406800.0, eph.d_TOW);
+}
+
+
+TEST(SpoofingExternalNavTest, CachesAndCounts)
+{
+    std::shared_ptr<Fake_External_Source> source = std::make_shared<Fake_External_Source>();
+    Spoofing_External_Nav service;
+    EXPECT_FALSE(service.lookup(SPOOFING_EXTERNAL_IONO));
+    EXPECT_EQ(1, service.get_misses(SPOOFING_EXTERNAL_IONO));
+
+    ASSERT_TRUE(service.start(source, 3600, 7200, 3600));
+    ASSERT_TRUE(service.wait_for(SPOOFING_EXTERNAL_IONO, 5000));
+    for (int i = 0; i < 100; i++)
+        {
+            std::shared_ptr<const Spoofing_External_Nav_Data> data = service.lookup(SPOOFING_EXTERNAL_IONO);
+            ASSERT_TRUE(static_cast<bool>(data));
+            EXPECT_DOUBLE_EQ(1e-8, data->iono.d_alpha0);
+        }
+    EXPECT_EQ(100, service.get_hits(SPOOFING_EXTERNAL_IONO));
+    EXPECT_EQ(0, service.get_stale(SPOOFING_EXTERNAL_IONO));
+
+    // the other kinds were prefetched once, failed and wait for the retry period
+    EXPECT_FALSE(service.wait_for(SPOOFING_EXTERNAL_EPHEMERIS, 100));
+    EXPECT_EQ(SPOOFING_EXTERNAL_KINDS, source->fetches);
+    EXPECT_EQ(SPOOFING_EXTERNAL_KINDS - 1, service.get_fetch_failures());
+    service.stop();
+    EXPECT_FALSE(service.is_running());
+}
+
+
+TEST(SpoofingExternalNavTest, DeferredCallbacks)
+{
+    std::shared_ptr<Fake_External_Source> source = std::make_shared<Fake_External_Source>();
+    Spoofing_External_Nav service;
+    Spoofing_External_Requests requests(&service, 2);
+
+    int calls = 0;
+    Spoofing_External_Requests::Callback callback = [&calls](const Spoofing_External_Nav_Data& data)
+        {
+            EXPECT_TRUE(data.iono.valid);
+            calls++;
+        };
+    for (int i = 0; i < 3; i++)
+        {
+            requests.request(SPOOFING_EXTERNAL_IONO, callback);
+        }
+    EXPECT_EQ(0, calls);
+    EXPECT_EQ(2, requests.pending());
+    EXPECT_EQ(1, requests.get_dropped());
+
+    // copies share the service, not the callbacks
+    Spoofing_External_Requests copy(requests);
+    EXPECT_EQ(0, copy.pending());
+
+    EXPECT_EQ(0, requests.deliver());
+    ASSERT_TRUE(service.start(source, 3600, 7200, 3600));
+    ASSERT_TRUE(service.wait_for(SPOOFING_EXTERNAL_IONO, 5000));
+    EXPECT_EQ(2, requests.deliver());
+    EXPECT_EQ(2, calls);
+    EXPECT_EQ(0, requests.pending());
+
+    // answered at once from the cache
+    requests.request(SPOOFING_EXTERNAL_IONO, callback);
+    EXPECT_EQ(3, calls);
+    service.stop();
+}
+
+
+TEST(SpoofingExternalNavTest, DetectorComparesDeferredReference)
+{
+    // the detectors share the running service instead of starting their own source
+    std::shared_ptr<Gated_External_Source> source = std::make_shared<Gated_External_Source>();
+    Spoofing_External_Nav& service = Spoofing_External_Nav::instance();
+    ASSERT_TRUE(service.start(source, 3600, 7200, 3600));
+
+    std::shared_ptr<InMemoryConfiguration> config = std::make_shared<InMemoryConfiguration>();
+    config->set_property("Spoofing.NAVI_external", "true");
+    Spoofing_Detector detector(config.get());
+    Spoofing_Message msg;
+    while (global_spoofing_queue.try_pop(msg)) {}
+
+    // the reference is not there yet: the comparison waits for it
+    Gps_Iono iono;
+    iono.valid = true;
+    iono.d_alpha0 = 2e-8;
+    detector.check_external_iono(iono, 1000.0, 7000.0);
+    EXPECT_FALSE(global_spoofing_queue.try_pop(msg));
+
+    source->released = true;
+    ASSERT_TRUE(service.wait_for(SPOOFING_EXTERNAL_IONO, 5000));
+
+    // delivered at the start of the next external check
+    Gps_Utc_Model utc;
+    detector.check_external_utc(utc, 7000.0, 13000.0);
+    ASSERT_TRUE(global_spoofing_queue.try_pop(msg));
+    EXPECT_EQ(6, msg.spoofing_case);
+    EXPECT_DOUBLE_EQ(1000.0, msg.evidence_time_ms);
+    EXPECT_DOUBLE_EQ(13000.0, msg.alarm_time_ms);
+    EXPECT_FALSE(global_spoofing_queue.try_pop(msg));
+
+    // the same model as the reference, answered at once from the cache
+    iono.d_alpha0 = 1e-8;
+    detector.check_external_iono(iono, 13000.0, 19000.0);
+    EXPECT_FALSE(global_spoofing_queue.try_pop(msg));
+    service.stop();
+}
+
+
+TEST(SpoofingExternalNavTest, DetectorReportsAlmanacHealth)
+{
+    Gps_Almanac almanac;
+    almanac.i_satellite_PRN = 5;
+    almanac.d_Toa = 61440.0;
+    almanac.d_sqrt_A = 5153.6;
+    almanac.i_SV_health = 0;
+    std::shared_ptr<Almanac_External_Source> source = std::make_shared<Almanac_External_Source>();
+    source->almanac[5] = almanac;
+    Spoofing_External_Nav& service = Spoofing_External_Nav::instance();
+    ASSERT_TRUE(service.start(source, 3600, 7200, 3600));
+
+    std::shared_ptr<InMemoryConfiguration> config = std::make_shared<InMemoryConfiguration>();
+    config->set_property("Spoofing.NAVI_external", "true");
+    Spoofing_Detector detector(config.get());
+    Spoofing_Message msg;
+    while (global_spoofing_queue.try_pop(msg)) {}
+
+    // almanac page of the satellite, checked on subframes 4 and 5
+    Gps_Navigation_Message nav;
+    nav.almanac_map[5] = almanac;
+    detector.New_subframe(4, 5, nav, 1000.0);
+    ASSERT_TRUE(service.wait_for(SPOOFING_EXTERNAL_ALMANAC, 5000));
+    detector.New_subframe(5, 5, nav, 7000.0);
+    EXPECT_FALSE(global_spoofing_queue.try_pop(msg));
+
+    // only the health of the satellite differs
+    nav.almanac_map[5].i_SV_health = 1;
+    detector.New_subframe(4, 5, nav, 13000.0);
+    ASSERT_TRUE(global_spoofing_queue.try_pop(msg));
+    EXPECT_EQ(1, msg.satellites.size());
+    EXPECT_EQ(1, msg.satellites.count(5));
+    EXPECT_DOUBLE_EQ(13000.0, msg.evidence_time_ms);
+    EXPECT_FALSE(global_spoofing_queue.try_pop(msg));
+    service.stop();
+}
@@ -0,0 +1,180 @@
+/*!
+ * \file capture_container_test.cc
+ * \brief  This file implements tests for the compressed capture container
+ *
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <gtest/gtest.h>
+#include "capture_container.h"
+
+
+class CaptureContainerTest: public ::testing::Test
+{
+protected:
+    CaptureContainerTest()
+    {
+        filename = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("capture_container_%%%%%%.gcap")).string();
+        std::mt19937 generator(1);
+        std::normal_distribution<float> noise(0.0, 100.0);
+        samples.resize(10001);  // not a whole number of blocks
+        for (unsigned int k = 0; k < samples.size(); k++)
+            {
+                samples[k] = std::complex<float>(noise(generator), noise(generator));
+            }
+    }
+
+    ~CaptureContainerTest()
+    {
+        boost::filesystem::remove(filename);
+    }
+
+    void record(unsigned int bits)
+    {
+        capture_container_writer writer(filename, bits, 1024, 16e6, 4.092e6);
+        writer.set_tag("scenario", "meaconing");
+        writer.write(&samples[0], samples.size());
+    }
+
+    double snr_db(const std::vector<std::complex<float> >& decoded)
+    {
+        double signal = 0.0;
+        double error = 0.0;
+        for (unsigned int k = 0; k < samples.size(); k++)
+            {
+                signal += std::norm(samples[k]);
+                error += std::norm(samples[k] - decoded[k]);
+            }
+        return 10.0 * std::log10(signal / error);
+    }
+
+    std::string filename;
+    std::vector<std::complex<float> > samples;
+};
+
+
+TEST_F(CaptureContainerTest, RoundTrip)
+{
+    // close to the quantization limit for gaussian noise at each width
+    unsigned int bits[3] = {2, 4, 8};
+    double min_snr_db[3] = {8.5, 19.0, 40.0};
+    for (int i = 0; i < 3; i++)
+        {
+            record(bits[i]);
+            capture_container_reader reader(filename);
+            EXPECT_EQ(bits[i], reader.header().bits);
+            ASSERT_EQ(samples.size(), reader.samples());
+            std::vector<std::complex<float> > decoded(samples.size() + 100);
+            EXPECT_EQ(samples.size(), reader.read(&decoded[0], decoded.size()));
+            EXPECT_EQ(0u, reader.read(&decoded[0], decoded.size()));
+            EXPECT_GT(snr_db(decoded), min_snr_db[i]) << bits[i] << " bits";
+        }
+}
+
+
+TEST_F(CaptureContainerTest, Metadata)
+{
+    record(4);
+    capture_container_reader reader(filename);
+    EXPECT_DOUBLE_EQ(16e6, reader.header().sampling_frequency);
+    EXPECT_DOUBLE_EQ(4.092e6, reader.header().intermediate_frequency);
+    ASSERT_EQ(1u, reader.tags().count("scenario"));
+    EXPECT_EQ("meaconing", reader.tags().find("scenario")->second);
+}
+
+
+TEST_F(CaptureContainerTest, Seek)
+{
+    record(2);
+    capture_container_reader reader(filename);
+    std::vector<std::complex<float> > all(samples.size());
+    reader.read(&all[0], all.size());
+
+    unsigned long long positions[4] = {0, 1023, 1024, 10000};
+    for (int i = 0; i < 4; i++)
+        {
+            std::complex<float> sample;
+            reader.seek(positions[i]);
+            EXPECT_EQ(1u, reader.read(&sample, 1));
+            EXPECT_EQ(all[positions[i]], sample);
+            EXPECT_EQ(positions[i] + 1, reader.position());
+        }
+    EXPECT_THROW(reader.seek(samples.size() + 1), std::runtime_error);
+}
+
+
+TEST_F(CaptureContainerTest, Cshort)
+{
+    record(8);
+    capture_container_reader reader(filename);
+    std::vector<std::complex<float> > decoded(samples.size());
+    std::vector<std::complex<int16_t> > decoded_short(samples.size());
+    reader.read(&decoded[0], decoded.size());
+    reader.seek(0);
+    EXPECT_EQ(samples.size(), reader.read(&decoded_short[0], decoded_short.size()));
+    float gain = reader.cshort_gain();
+    for (unsigned int k = 0; k < samples.size(); k++)
+        {
+            ASSERT_NEAR(decoded[k].real() * gain, decoded_short[k].real(), 0.5);
+            ASSERT_NEAR(decoded[k].imag() * gain, decoded_short[k].imag(), 0.5);
+        }
+}
+
+
+TEST_F(CaptureContainerTest, UnclosedRecording)
+{
+    record(4);
+    // drop the tags and the final counts, as after a crash, and cut the last block
+    unsigned long long size = boost::filesystem::file_size(filename);
+    {
+        std::fstream file(filename.c_str(), std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(32);
+        const char zeros[16] = {};
+        file.write(zeros, sizeof(zeros));
+    }
+    boost::filesystem::resize_file(filename, size - 100);
+    capture_container_reader reader(filename);
+    EXPECT_EQ(9u * 1024u, reader.samples());
+    EXPECT_TRUE(reader.tags().empty());
+    EXPECT_GT(reader.cshort_gain(), 0.0f);
+}
+
+
+TEST_F(CaptureContainerTest, NotAContainer)
+{
+    std::ofstream(filename.c_str()) << "raw samples";
+    EXPECT_THROW(capture_container_reader reader(filename), std::runtime_error);
+    EXPECT_THROW(capture_container_writer writer(filename, 3, 1024, 16e6, 0.0), std::runtime_error);
+}
@@ -29,6 +29,7 @@
  */
 
 #include <complex>
+#include <cstdlib>
 #include <ctime>
 #include <iostream>
 #include <stdint.h>
@@ -38,6 +39,8 @@
 #include <gnuradio/analog/sig_source_c.h>
 #include <gnuradio/msg_queue.h>
 #include <gnuradio/blocks/null_sink.h>
+#include <gnuradio/blocks/vector_source_c.h>
+#include <gnuradio/blocks/vector_sink_c.h>
 #include <gtest/gtest.h>
 #include "gnss_block_factory.h"
 #include "gnss_block_interface.h"
@@ -378,3 +381,42 @@ TEST_F(Fir_Filter_Test, ConnectAndRunCbyteGrcomplex)
     }) << "Failure running the top_block." << std::endl;
     std::cout <<  "Filtered " << nsamples << " samples in " << (end-begin) << " microseconds" << std::endl;
 }
+
+
+TEST_F(Fir_Filter_Test, FftConvolutionMatchesDirectForm)
+{
+    init();
+    configure_gr_complex_gr_complex();
+    config->set_property("InputFilter.number_of_taps", "101");
+
+    std::vector<gr_complex> input(20000);
+    for (unsigned int i = 0; i < input.size(); i++)
+        {
+            input[i] = gr_complex(std::rand() % 256 - 128, std::rand() % 256 - 128);
+        }
+
+    std::vector<gr_complex> output[2];
+    for (int k = 0; k < 2; k++)
+        {
+            // k = 0 runs the direct form, k = 1 the FFT convolution
+            config->set_property("InputFilter.fft_crossover_taps", k == 0 ? "0" : "64");
+            top_block = gr::make_top_block("Fir filter test");
+            std::shared_ptr<FirFilter> filter = std::make_shared<FirFilter>(config.get(), "InputFilter", 1, 1);
+            gr::blocks::vector_source_c::sptr source = gr::blocks::vector_source_c::make(input);
+            gr::blocks::vector_sink_c::sptr sink = gr::blocks::vector_sink_c::make();
+            filter->connect(top_block);
+            top_block->connect(source, 0, filter->get_left_block(), 0);
+            top_block->connect(filter->get_right_block(), 0, sink, 0);
+            top_block->run();
+            output[k] = sink->data();
+        }
+
+    // The FFT filter only produces whole blocks, so the tail may be shorter
+    ASSERT_LE(output[1].size(), output[0].size());
+    ASSERT_GT(output[1].size(), 0);
+    for (unsigned int i = 0; i < output[1].size(); i++)
+        {
+            ASSERT_NEAR(output[0][i].real(), output[1][i].real(), 1e-2) << "at sample " << i;
+            ASSERT_NEAR(output[0][i].imag(), output[1][i].imag(), 1e-2) << "at sample " << i;
+        }
+}
@@ -33,6 +33,9 @@
  * -------------------------------------------------------------------------
  */
 
+#include <algorithm>
+#include <chrono>
+#include <iostream>
 #include <vector>
 #include <gnuradio/msg_queue.h>
 #include <gtest/gtest.h>
@@ -165,6 +168,16 @@ TEST(GNSS_Block_Factory_Test, InstantiateDirectResampler)
     EXPECT_STREQ("Direct_Resampler", resampler->implementation().c_str());
 }
 
+TEST(GNSS_Block_Factory_Test, InstantiatePolyphaseResampler)
+{
+    std::shared_ptr<InMemoryConfiguration> configuration = std::make_shared<InMemoryConfiguration>();
+    configuration->set_property("Resampler.implementation", "Polyphase_Resampler");
+    std::unique_ptr<GNSSBlockFactory> factory;
+    std::unique_ptr<GNSSBlockInterface> resampler = factory->GetBlock(configuration, "Resampler", "Polyphase_Resampler", 1, 1);
+    EXPECT_STREQ("Resampler", resampler->role().c_str());
+    EXPECT_STREQ("Polyphase_Resampler", resampler->implementation().c_str());
+}
+
 TEST(GNSS_Block_Factory_Test, InstantiateGpsL1CaPcpsAcquisition)
 {
     std::shared_ptr<InMemoryConfiguration> configuration = std::make_shared<InMemoryConfiguration>();
@@ -347,3 +360,44 @@ TEST(GNSS_Block_Factory_Test, InstantiateWrongPvt)
     EXPECT_EQ(nullptr, pvt);
 }
 
+
+
+TEST(GNSS_Block_Factory_Test, ListImplementations)
+{
+    std::vector<std::string> names = GNSSBlockFactory::Implementations();
+    EXPECT_NE(names.end(), std::find(names.begin(), names.end(), "Pass_Through"));
+    EXPECT_NE(names.end(), std::find(names.begin(), names.end(), "GPS_L1_CA_PCPS_SD_Acquisition"));
+    EXPECT_NE(names.end(), std::find(names.begin(), names.end(), "GPS_L1_CA_SD_Telemetry_Decoder"));
+    EXPECT_NE(names.end(), std::find(names.begin(), names.end(), "Hybrid_PVT"));
+    EXPECT_EQ(names.end(), std::find(names.begin(), names.end(), "Pepito"));
+}
+
+
+TEST(GNSS_Block_Factory_Test, ChannelConstructionTime)
+{
+    std::shared_ptr<InMemoryConfiguration> configuration = std::make_shared<InMemoryConfiguration>();
+    unsigned int count = 12;
+    configuration->set_property("Channels_1C.count", std::to_string(count));
+    configuration->set_property("Channels.in_acquisition", "1");
+    configuration->set_property("Acquisition_1C.implementation", "GPS_L1_CA_PCPS_Acquisition");
+    configuration->set_property("Tracking_1C.implementation", "GPS_L1_CA_DLL_PLL_Tracking");
+    configuration->set_property("TelemetryDecoder_1C.implementation", "GPS_L1_CA_Telemetry_Decoder");
+    gr::msg_queue::sptr queue = gr::msg_queue::make(0);
+    std::unique_ptr<GNSSBlockFactory> factory;
+
+    // the first build includes the one-time costs (code tables, FFT plans)
+    for (unsigned int run = 0; run < 3; run++)
+        {
+            std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+            std::unique_ptr<std::vector<std::unique_ptr<GNSSBlockInterface>>> channels = factory->GetChannels(configuration, queue);
+            std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+            std::cout << "Construction of " << count << " GPS L1 C/A channels (run " << run << ") finished in "
+                      << std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count()
+                      << " microseconds" << std::endl;
+            ASSERT_EQ(count, channels->size());
+            for (unsigned int i = 0; i < count; i++)
+                {
+                    EXPECT_NE(nullptr, channels->at(i));
+                }
+        }
+}
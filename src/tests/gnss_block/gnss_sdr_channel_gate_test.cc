@@ -0,0 +1,83 @@
+/*!
+ * \file gnss_sdr_channel_gate_test.cc
+ * \brief  This file implements tests for the channel gate block
+ *
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <vector>
+#include <gtest/gtest.h>
+#include <gnuradio/top_block.h>
+#include <gnuradio/blocks/vector_source_c.h>
+#include <gnuradio/blocks/vector_sink_c.h>
+#include "gnss_sdr_channel_gate.h"
+
+
+TEST(ChannelGateTest, PassesSamples)
+{
+    std::vector<gr_complex> samples(1000, gr_complex(1.0, -1.0));
+    gr::top_block_sptr top_block = gr::make_top_block("Channel gate test");
+    gr::blocks::vector_source_c::sptr source = gr::blocks::vector_source_c::make(samples);
+    gnss_sdr_channel_gate_sptr gate = gnss_sdr_make_channel_gate(sizeof(gr_complex), 40);
+    gr::blocks::vector_sink_c::sptr sink = gr::blocks::vector_sink_c::make();
+
+    top_block->connect(source, 0, gate, 0);
+    top_block->connect(gate, 0, sink, 0);
+    top_block->run();
+
+    EXPECT_EQ(1000, sink->data().size());
+    EXPECT_FALSE(gate->parked());
+    EXPECT_EQ(0, gate->skipped());
+}
+
+
+TEST(ChannelGateTest, ParkedChannelDropsAndAccounts)
+{
+    std::vector<gr_complex> samples(1000, gr_complex(1.0, -1.0));
+    gr::top_block_sptr top_block = gr::make_top_block("Channel gate test");
+    gr::blocks::vector_source_c::sptr source = gr::blocks::vector_source_c::make(samples);
+    gnss_sdr_channel_gate_sptr gate = gnss_sdr_make_channel_gate(sizeof(gr_complex), 41);
+    gnss_sdr_channel_gate_sptr other = gnss_sdr_make_channel_gate(sizeof(gr_complex), 41);
+    gr::blocks::vector_sink_c::sptr sink = gr::blocks::vector_sink_c::make();
+
+    // the same channel number in another receiver is not affected
+    gate->park();
+    EXPECT_TRUE(gate->output_parked());
+    EXPECT_FALSE(other->output_parked());
+
+    top_block->connect(source, 0, gate, 0);
+    top_block->connect(gate, 0, sink, 0);
+    top_block->run();
+
+    EXPECT_EQ(0, sink->data().size());
+    EXPECT_EQ(1000, gate->skipped());
+
+    unsigned long long accounted = 0;
+    gate->resume([&accounted](unsigned long long skipped) { accounted = skipped; });
+    EXPECT_EQ(1000, accounted);
+    EXPECT_FALSE(gate->parked());
+    EXPECT_FALSE(gate->output_parked());
+}
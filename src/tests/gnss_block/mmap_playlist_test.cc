@@ -0,0 +1,158 @@
+/*!
+ * \file mmap_playlist_test.cc
+ * \brief  This file implements tests for the memory-mapped capture playlist
+ *
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <gtest/gtest.h>
+#include "mmap_playlist.h"
+
+
+class MmapPlaylistTest: public ::testing::Test
+{
+protected:
+    MmapPlaylistTest()
+    {
+        // 100 shorts numbered from 0
+        filename = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("mmap_playlist_%%%%%%.dat")).string();
+        std::ofstream file(filename.c_str(), std::ios::binary);
+        for (int16_t i = 0; i < 100; i++)
+            {
+                file.write(reinterpret_cast<const char*>(&i), sizeof(i));
+            }
+    }
+
+    ~MmapPlaylistTest()
+    {
+        boost::filesystem::remove(filename);
+    }
+
+    mmap_segment segment(unsigned long long first_item, unsigned long long items)
+    {
+        mmap_segment s;
+        s.filename = filename;
+        s.first_item = first_item;
+        s.items = items;
+        return s;
+    }
+
+    std::string filename;
+};
+
+
+TEST_F(MmapPlaylistTest, PlaysSegmentsAsOneStream)
+{
+    // a one-page read-ahead, so that pages are advised and released on the way
+    mmap_playlist playlist(sizeof(int16_t), false, 4096);
+    playlist.add(segment(10, 10));
+    playlist.add(segment(95, 0));
+    EXPECT_EQ(2, playlist.segments());
+    EXPECT_EQ(15, playlist.items());
+
+    std::vector<int16_t> out;
+    int16_t buffer[4];
+    size_t n;
+    while ((n = playlist.read(buffer, 4)) > 0)
+        {
+            out.insert(out.end(), buffer, buffer + n);
+        }
+    ASSERT_EQ(15, out.size());
+    for (int i = 0; i < 10; i++)
+        {
+            EXPECT_EQ(10 + i, out.at(i));
+        }
+    for (int i = 0; i < 5; i++)
+        {
+            EXPECT_EQ(95 + i, out.at(10 + i));
+        }
+    EXPECT_EQ(15, playlist.position());
+    EXPECT_EQ(2, playlist.segment());
+    EXPECT_EQ(0, playlist.read(buffer, 4));
+}
+
+
+TEST_F(MmapPlaylistTest, RepeatsFromTheFirstSegment)
+{
+    mmap_playlist playlist(sizeof(int16_t), true, 0);
+    playlist.add(segment(0, 3));
+    int16_t buffer[8];
+    ASSERT_EQ(8, playlist.read(buffer, 8));
+    const int16_t expected[8] = { 0, 1, 2, 0, 1, 2, 0, 1 };
+    for (int i = 0; i < 8; i++)
+        {
+            EXPECT_EQ(expected[i], buffer[i]);
+        }
+    EXPECT_EQ(8, playlist.position());
+    EXPECT_EQ(0, playlist.segment());
+}
+
+
+TEST_F(MmapPlaylistTest, RejectsSegmentsOutsideTheFile)
+{
+    mmap_playlist playlist(sizeof(int16_t), false, 0);
+    EXPECT_THROW(playlist.add(segment(90, 20)), std::runtime_error);
+    EXPECT_THROW(playlist.add(segment(100, 0)), std::runtime_error);
+    mmap_segment missing = segment(0, 0);
+    missing.filename = filename + ".missing";
+    EXPECT_THROW(playlist.add(missing), std::runtime_error);
+    EXPECT_EQ(0, playlist.items());
+}
+
+
+TEST(MmapPlaylistParseTest, ParsesPlaylists)
+{
+    std::stringstream list;
+    list << "# day 1\n"
+         << "/data/a.dat\n"
+         << "\n"
+         << "/data/b.dat 4000 16000000\n";
+    std::vector<mmap_segment> segments;
+    std::string error;
+    ASSERT_TRUE(mmap_playlist::parse(list, segments, error));
+    ASSERT_EQ(2, segments.size());
+    EXPECT_EQ("/data/a.dat", segments.at(0).filename);
+    EXPECT_EQ(0, segments.at(0).first_item);
+    EXPECT_EQ(0, segments.at(0).items);
+    EXPECT_EQ(4000, segments.at(1).first_item);
+    EXPECT_EQ(16000000, segments.at(1).items);
+
+    std::stringstream malformed("/data/a.dat -1\n");
+    EXPECT_FALSE(mmap_playlist::parse(malformed, segments, error));
+    EXPECT_EQ("/data/a.dat -1", error);
+
+    std::vector<mmap_segment> single = mmap_playlist::load("", "/data/c.dat", 12);
+    ASSERT_EQ(1, single.size());
+    EXPECT_EQ(12, single.at(0).first_item);
+    EXPECT_THROW(mmap_playlist::load("/nonexistent/playlist.txt", "", 0), std::runtime_error);
+}
@@ -0,0 +1,213 @@
+/*!
+ * \file adaptive_beamformer_test.cc
+ * \brief Checks the weights and the signal path of the adaptive beamformer
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+
+
+
+#include <complex>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include <gnuradio/top_block.h>
+#include <gnuradio/blocks/vector_source_c.h>
+#include <gnuradio/blocks/vector_sink_c.h>
+#include <gnuradio/math.h>
+#include "adaptive_beamformer.h"
+
+
+namespace
+{
+// Steering vector of a uniform linear array for an inter-element phase step
+std::vector<std::complex<double> > ula_steering(unsigned int elements, double phase_step)
+{
+    std::vector<std::complex<double> > a(elements);
+    for (unsigned int i = 0; i < elements; i++)
+        {
+            a[i] = std::polar(1.0, phase_step * i);
+        }
+    return a;
+}
+
+// Upper triangle of noise_power I + sum_k power_k a_k a_k^H
+std::vector<std::complex<double> > covariance(unsigned int elements, double noise_power,
+        const std::vector<std::vector<std::complex<double> > >& sources, const std::vector<double>& powers)
+{
+    std::vector<std::complex<double> > R(elements * elements, std::complex<double>(0.0, 0.0));
+    for (unsigned int i = 0; i < elements; i++)
+        {
+            R[i * elements + i] = noise_power;
+            for (unsigned int j = i; j < elements; j++)
+                {
+                    for (unsigned int k = 0; k < sources.size(); k++)
+                        {
+                            R[i * elements + j] += powers[k] * sources[k][i] * std::conj(sources[k][j]);
+                        }
+                }
+        }
+    return R;
+}
+
+// Amplitude of the complex tone at the normalized frequency freq in samples [begin, end)
+double tone_amplitude(const std::vector<gr_complex>& samples, double freq, unsigned int begin, unsigned int end)
+{
+    std::complex<double> acc(0.0, 0.0);
+    for (unsigned int k = begin; k < end; k++)
+        {
+            acc += std::complex<double>(samples[k]) * std::polar(1.0, -2.0 * GR_M_PI * freq * k);
+        }
+    return std::abs(acc) / (end - begin);
+}
+
+std::complex<double> response(const std::vector<std::complex<double> >& w, const std::vector<std::complex<double> >& a)
+{
+    std::complex<double> y(0.0, 0.0);
+    for (unsigned int i = 0; i < w.size(); i++)
+        {
+            y += std::conj(w[i]) * a[i];
+        }
+    return y;
+}
+}
+
+
+TEST(Adaptive_Beamformer_Test, WeightsNullTheJammers)
+{
+    const unsigned int elements = 6;
+    std::vector<std::vector<std::complex<double> > > jammers;
+    jammers.push_back(ula_steering(elements, 1.1));
+    jammers.push_back(ula_steering(elements, -2.3));
+    std::vector<double> powers(2, 1e5);
+    std::vector<std::complex<double> > R = covariance(elements, 1.0, jammers, powers);
+
+    // power inversion: unit gain on the reference element, jammers 50 dB down
+    std::vector<std::complex<double> > reference(elements, std::complex<double>(0.0, 0.0));
+    reference[2] = 1.0;
+    std::vector<std::complex<double> > w;
+    ASSERT_TRUE(adaptive_beamformer_weights(R, reference, 0.0, w));
+    EXPECT_NEAR(1.0, w[2].real(), 1e-9);
+    EXPECT_NEAR(0.0, w[2].imag(), 1e-9);
+    for (unsigned int k = 0; k < jammers.size(); k++)
+        {
+            EXPECT_LT(std::norm(response(w, jammers[k])), 1e-5);
+        }
+
+    // mvdr: distortionless towards the look direction
+    std::vector<std::complex<double> > look = ula_steering(elements, 0.4);
+    ASSERT_TRUE(adaptive_beamformer_weights(R, look, 1e-3, w));
+    EXPECT_NEAR(1.0, response(w, look).real(), 1e-9);
+    EXPECT_NEAR(0.0, response(w, look).imag(), 1e-9);
+    for (unsigned int k = 0; k < jammers.size(); k++)
+        {
+            EXPECT_LT(std::norm(response(w, jammers[k])), 1e-5);
+        }
+
+    // an empty estimate is rejected unless it is loaded
+    std::vector<std::complex<double> > empty(elements * elements, std::complex<double>(0.0, 0.0));
+    EXPECT_FALSE(adaptive_beamformer_weights(empty, reference, 0.0, w));
+    EXPECT_TRUE(adaptive_beamformer_weights(empty, reference, 1.0, w));
+}
+
+
+TEST(Adaptive_Beamformer_Test, PassesReferenceElementBeforeFirstUpdate)
+{
+    const unsigned int elements = 3;
+    const int nsamples = 20000;
+
+    gr::top_block_sptr top_block = gr::make_top_block("adaptive_beamformer_test");
+    // more snapshots than samples, so the initial weights are kept for the whole run
+    adaptive_beamformer_sptr beamformer = make_adaptive_beamformer(elements, "power_inversion",
+            1, nsamples + 1, 1e-3, 1, std::vector<gr_complex>());
+    gr::blocks::vector_sink_c::sptr sink = gr::blocks::vector_sink_c::make();
+
+    std::vector<std::vector<gr_complex> > inputs(elements, std::vector<gr_complex>(nsamples));
+    for (unsigned int i = 0; i < elements; i++)
+        {
+            for (int n = 0; n < nsamples; n++)
+                {
+                    inputs[i][n] = gr_complex(static_cast<float>(n % 1000), static_cast<float>(i));
+                }
+            top_block->connect(gr::blocks::vector_source_c::make(inputs[i]), 0, beamformer, i);
+        }
+    top_block->connect(beamformer, 0, sink, 0);
+    top_block->run();
+    top_block->stop();
+
+    EXPECT_EQ(0u, beamformer->updates());
+    std::vector<gr_complex> output = sink->data();
+    ASSERT_EQ(static_cast<unsigned int>(nsamples), output.size());
+    for (int n = 0; n < nsamples; n++)
+        {
+            ASSERT_EQ(inputs[1][n], output[n]);
+        }
+}
+
+
+TEST(Adaptive_Beamformer_Test, AppliesUpdatedWeightsAgainstJammer)
+{
+    const unsigned int elements = 4;
+    const int nsamples = 400000;
+    const double jammer_freq = 0.0123;  // cycles per sample
+    const double jammer_amplitude = 100.0;  // 40 dB above the noise of each element
+    std::vector<std::complex<double> > jammer = ula_steering(elements, 1.1);
+
+    gr::top_block_sptr top_block = gr::make_top_block("adaptive_beamformer_test");
+    adaptive_beamformer_sptr beamformer = make_adaptive_beamformer(elements, "power_inversion",
+            1, 256, 1e-3, 1, std::vector<gr_complex>());
+    gr::blocks::vector_sink_c::sptr sink = gr::blocks::vector_sink_c::make();
+
+    std::mt19937 generator(1234);
+    std::normal_distribution<float> noise(0.0f, static_cast<float>(std::sqrt(0.5)));
+    std::vector<std::vector<gr_complex> > inputs(elements, std::vector<gr_complex>(nsamples));
+    for (int n = 0; n < nsamples; n++)
+        {
+            const std::complex<double> tone = std::polar(jammer_amplitude, 2.0 * GR_M_PI * jammer_freq * n);
+            for (unsigned int i = 0; i < elements; i++)
+                {
+                    inputs[i][n] = gr_complex(tone * jammer[i]) + gr_complex(noise(generator), noise(generator));
+                }
+        }
+    for (unsigned int i = 0; i < elements; i++)
+        {
+            top_block->connect(gr::blocks::vector_source_c::make(inputs[i]), 0, beamformer, i);
+        }
+    top_block->connect(beamformer, 0, sink, 0);
+    top_block->run();
+    top_block->stop();
+
+    EXPECT_GT(beamformer->updates(), 0u);
+    std::vector<gr_complex> output = sink->data();
+    ASSERT_EQ(static_cast<unsigned int>(nsamples), output.size());
+
+    // the reference element goes through until the first estimate, then the jammer is nulled
+    EXPECT_NEAR(jammer_amplitude, tone_amplitude(output, jammer_freq, 0, 200), 1.0);
+    EXPECT_LT(tone_amplitude(output, jammer_freq, nsamples - 100000, nsamples), 1e-2 * jammer_amplitude);
+    std::vector<gr_complex> w = beamformer->weights();
+    EXPECT_NEAR(1.0, w[1].real(), 1e-3);
+    EXPECT_NEAR(0.0, w[1].imag(), 1e-3);
+}
@@ -0,0 +1,80 @@
+/*!
+ * \file fft_freq_xlating_fir_filter_ccf_test.cc
+ * \brief Checks the FFT frequency translating filter against GNU Radio's
+ * direct-form freq_xlating_fir_filter_ccf
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+
+
+#include <cstdlib>
+#include <vector>
+#include <gtest/gtest.h>
+#include <gnuradio/top_block.h>
+#include <gnuradio/blocks/vector_source_c.h>
+#include <gnuradio/blocks/vector_sink_c.h>
+#include <gnuradio/filter/firdes.h>
+#include <gnuradio/filter/freq_xlating_fir_filter_ccf.h>
+#include "fft_freq_xlating_fir_filter_ccf.h"
+
+
+TEST(Fft_Freq_Xlating_Fir_Filter_Ccf_Test, MatchesDirectForm)
+{
+    const double fs = 4000000.0;
+    const double intermediate_freq = 1250000.0;
+    const unsigned int decimation = 2;
+    std::vector<float> taps = gr::filter::firdes::low_pass(1.0, fs, 800000.0, 200000.0);
+
+    std::vector<gr_complex> input(40000);
+    for (unsigned int i = 0; i < input.size(); i++)
+        {
+            input[i] = gr_complex(std::rand() % 256 - 128, std::rand() % 256 - 128);
+        }
+
+    gr::top_block_sptr top_block = gr::make_top_block("fft_freq_xlating_fir_filter_ccf_test");
+    gr::blocks::vector_source_c::sptr source = gr::blocks::vector_source_c::make(input);
+    gr::filter::freq_xlating_fir_filter_ccf::sptr direct = gr::filter::freq_xlating_fir_filter_ccf::make(decimation, taps, intermediate_freq, fs);
+    fft_freq_xlating_fir_filter_ccf_sptr fft = make_fft_freq_xlating_fir_filter_ccf(decimation, taps, intermediate_freq, fs);
+    gr::blocks::vector_sink_c::sptr direct_sink = gr::blocks::vector_sink_c::make();
+    gr::blocks::vector_sink_c::sptr fft_sink = gr::blocks::vector_sink_c::make();
+
+    top_block->connect(source, 0, direct, 0);
+    top_block->connect(source, 0, fft, 0);
+    top_block->connect(direct, 0, direct_sink, 0);
+    top_block->connect(fft, 0, fft_sink, 0);
+    top_block->run();
+    top_block->stop();
+
+    std::vector<gr_complex> expected = direct_sink->data();
+    std::vector<gr_complex> output = fft_sink->data();
+    ASSERT_GT(output.size(), 0);
+    ASSERT_LE(output.size(), expected.size());
+    for (unsigned int i = 0; i < output.size(); i++)
+        {
+            ASSERT_NEAR(expected[i].real(), output[i].real(), 1e-2) << "at sample " << i;
+            ASSERT_NEAR(expected[i].imag(), output[i].imag(), 1e-2) << "at sample " << i;
+        }
+}
@@ -0,0 +1,130 @@
+/*!
+ * \file fused_conditioner_test.cc
+ * \brief Checks the fused conditioner against a straightforward reference
+ * implementation of the conversion, filter and decimation stages
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+
+
+#include <complex>
+#include <cstdlib>
+#include <vector>
+#include <gtest/gtest.h>
+#include <gnuradio/top_block.h>
+#include <gnuradio/blocks/vector_source_s.h>
+#include <gnuradio/blocks/vector_sink_c.h>
+#include "fused_conditioner.h"
+
+
+TEST(Fused_Conditioner_Test, ConvertFilterAndDecimate)
+{
+    const int nsamples = 20000;
+    const float scale = 0.5;
+    const unsigned int decimation = 3;
+    std::vector<float> taps = { 0.1, 0.2, 0.4, 0.2, 0.1 };
+
+    std::vector<short> raw_data(2 * nsamples);
+    for (unsigned int i = 0; i < raw_data.size(); i++)
+        {
+            raw_data[i] = static_cast<short>(std::rand() % 4096 - 2048);
+        }
+
+    gr::top_block_sptr top_block = gr::make_top_block("fused_conditioner_test");
+    gr::blocks::vector_source_s::sptr source = gr::blocks::vector_source_s::make(raw_data);
+    fused_conditioner_sptr conditioner = make_fused_conditioner("ishort", scale, false, 1.0,
+            taps, 0.0, 4000000.0, decimation, false, 4000000.0, 4000000.0);
+    gr::blocks::vector_sink_c::sptr sink = gr::blocks::vector_sink_c::make();
+
+    top_block->connect(source, 0, conditioner, 0);
+    top_block->connect(conditioner, 0, sink, 0);
+    top_block->run();
+    top_block->stop();
+
+    std::vector<gr_complex> output = sink->data();
+    ASSERT_EQ(static_cast<unsigned int>((nsamples + decimation - 1) / decimation), output.size());
+
+    // Reference: y[m] = sum_k taps[k] x[m D - k], with zeros before the first sample
+    for (unsigned int m = 0; m < output.size(); m++)
+        {
+            gr_complex expected(0.0, 0.0);
+            for (unsigned int k = 0; k < taps.size(); k++)
+                {
+                    int n = static_cast<int>(m * decimation) - static_cast<int>(k);
+                    if (n >= 0)
+                        {
+                            expected += taps[k] * scale * gr_complex(raw_data[2 * n], raw_data[2 * n + 1]);
+                        }
+                }
+            ASSERT_NEAR(expected.real(), output[m].real(), 1e-3) << "at output " << m;
+            ASSERT_NEAR(expected.imag(), output[m].imag(), 1e-3) << "at output " << m;
+        }
+}
+
+
+TEST(Fused_Conditioner_Test, DirectResamplerDecisions)
+{
+    const int nsamples = 100000;
+    const double fs_in = 4000000.0;
+    const double fs_out = 2048000.0;
+
+    std::vector<short> raw_data(2 * nsamples);
+    for (int i = 0; i < nsamples; i++)
+        {
+            raw_data[2 * i] = static_cast<short>(i % 30000);
+            raw_data[2 * i + 1] = 0;
+        }
+
+    gr::top_block_sptr top_block = gr::make_top_block("fused_conditioner_test");
+    gr::blocks::vector_source_s::sptr source = gr::blocks::vector_source_s::make(raw_data);
+    fused_conditioner_sptr conditioner = make_fused_conditioner("ishort", 1.0, false, 1.0,
+            std::vector<float>(), 0.0, fs_in, 1, true, fs_in, fs_out);
+    gr::blocks::vector_sink_c::sptr sink = gr::blocks::vector_sink_c::make();
+
+    top_block->connect(source, 0, conditioner, 0);
+    top_block->connect(conditioner, 0, sink, 0);
+    top_block->run();
+    top_block->stop();
+
+    // Same phase accumulator as direct_resampler_conditioner_cc
+    std::vector<gr_complex> output = sink->data();
+    uint32_t phase_step = static_cast<uint32_t>(std::floor(4294967296.0 * fs_out / fs_in));
+    uint32_t phase = 0;
+    uint32_t lphase = 0;
+    unsigned int m = 0;
+    for (int n = 0; n < nsamples; n++)
+        {
+            if (phase <= lphase)
+                {
+                    ASSERT_LT(m, output.size());
+                    EXPECT_EQ(static_cast<float>(n % 30000), output[m].real()) << "at output " << m;
+                    m++;
+                }
+            lphase = phase;
+            phase += phase_step;
+        }
+    EXPECT_EQ(m, output.size());
+}
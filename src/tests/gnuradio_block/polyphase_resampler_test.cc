@@ -0,0 +1,125 @@
+/*!
+ * \file polyphase_resampler_test.cc
+ * \brief Checks the output rate, the passband gain and the alias rejection of
+ * the polyphase resampler
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+
+
+#include <complex>
+#include <vector>
+#include <gtest/gtest.h>
+#include <gnuradio/top_block.h>
+#include <gnuradio/blocks/vector_source_c.h>
+#include <gnuradio/blocks/vector_sink_c.h>
+#include <gnuradio/blocks/vector_source_s.h>
+#include <gnuradio/blocks/vector_sink_s.h>
+#include <gnuradio/math.h>
+#include "polyphase_resampler.h"
+
+
+namespace
+{
+// Amplitude of the complex tone at freq in the samples after skip
+double tone_amplitude(const std::vector<gr_complex>& samples, double freq, double fs, unsigned int skip)
+{
+    std::complex<double> acc(0.0, 0.0);
+    for (unsigned int k = skip; k < samples.size(); k++)
+        {
+            acc += std::complex<double>(samples[k]) * std::polar(1.0, -2.0 * GR_M_PI * freq / fs * k);
+        }
+    return std::abs(acc) / (samples.size() - skip);
+}
+}
+
+
+TEST(Polyphase_Resampler_Test, FractionalDecimationRejectsAliases)
+{
+    const double fs_in = 25000000.0;
+    const double fs_out = 6138000.0;
+    const double f_signal = 1000000.0;               // in the output band
+    const double f_interference = fs_out + 900000.0; // the direct resampler folds it to 900 kHz
+    const int nsamples = 250000;
+
+    std::vector<gr_complex> input(nsamples);
+    for (int n = 0; n < nsamples; n++)
+        {
+            input[n] = std::polar(1.0f, static_cast<float>(2.0 * GR_M_PI * f_signal / fs_in * n))
+                     + std::polar(1.0f, static_cast<float>(2.0 * GR_M_PI * f_interference / fs_in * n));
+        }
+
+    gr::top_block_sptr top_block = gr::make_top_block("polyphase_resampler_test");
+    gr::blocks::vector_source_c::sptr source = gr::blocks::vector_source_c::make(input);
+    polyphase_resampler_sptr resampler = make_polyphase_resampler("gr_complex", fs_in, fs_out);
+    gr::blocks::vector_sink_c::sptr sink = gr::blocks::vector_sink_c::make();
+
+    top_block->connect(source, 0, resampler, 0);
+    top_block->connect(resampler, 0, sink, 0);
+    top_block->run();
+    top_block->stop();
+
+    std::vector<gr_complex> output = sink->data();
+    EXPECT_NEAR(nsamples * fs_out / fs_in, output.size(), 2.0);
+    EXPECT_NEAR(1.0, tone_amplitude(output, f_signal, fs_out, 100), 1e-2);
+    EXPECT_LT(tone_amplitude(output, f_interference - fs_out, fs_out, 100), 1e-3);
+}
+
+
+TEST(Polyphase_Resampler_Test, IntegerDecimationOfComplexShorts)
+{
+    const double fs_in = 25000000.0;
+    const double fs_out = 5000000.0;
+    const int nsamples = 100000;
+
+    polyphase_resampler_sptr resampler = make_polyphase_resampler("cshort", fs_in, fs_out);
+    EXPECT_EQ(1u, resampler->phases());
+
+    // A constant input goes through with unit gain once the filter is full
+    std::vector<short> input(2 * nsamples);
+    for (int n = 0; n < nsamples; n++)
+        {
+            input[2 * n] = 1000;
+            input[2 * n + 1] = -500;
+        }
+
+    gr::top_block_sptr top_block = gr::make_top_block("polyphase_resampler_test");
+    boost::shared_ptr<gr::block> source = gr::blocks::vector_source_s::make(input, false, 2);
+    gr::blocks::vector_sink_s::sptr sink = gr::blocks::vector_sink_s::make(2);
+
+    top_block->connect(source, 0, resampler, 0);
+    top_block->connect(resampler, 0, sink, 0);
+    top_block->run();
+    top_block->stop();
+
+    std::vector<short> output = sink->data();
+    ASSERT_EQ(2u * nsamples / 5, output.size());
+    for (unsigned int k = 2 * resampler->taps_per_phase(); k < output.size(); k += 2)
+        {
+            ASSERT_EQ(1000, output[k]);
+            ASSERT_EQ(-500, output[k + 1]);
+        }
+}
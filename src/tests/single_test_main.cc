@@ -38,7 +38,7 @@
 #include <glog/logging.h>
 #include <gtest/gtest.h>
 #include <gnuradio/msg_queue.h>
-#include "concurrent_queue.h"
+#include "concurrent_ring.h"
 #include "concurrent_map.h"
 #include "gps_navigation_message.h"
 #include "gps_ephemeris.h"
@@ -53,7 +53,7 @@
 #include "sbas_ephemeris.h"
 #include "sbas_satellite_correction.h"
 
-concurrent_queue<Gps_Acq_Assist> global_gps_acq_assist_queue;
+concurrent_ring<Gps_Acq_Assist> global_gps_acq_assist_queue(256, RING_BLOCK);
 
 concurrent_map<Gps_Acq_Assist> global_gps_acq_assist_map;
 
@@ -41,6 +41,7 @@
 #include <gnuradio/msg_queue.h>
 #include <gtest/gtest.h>
 #include "concurrent_queue.h"
+#include "concurrent_ring.h"
 #include "concurrent_map.h"
 #include "concurrent_map_str.h"
 #include "control_thread.h"
@@ -52,6 +53,7 @@
 #include "gps_iono.h"
 #include "gps_cnav_iono.h"
 #include "gps_utc_model.h"
+#include "gps_nav_digest.h"
 
 #include "galileo_ephemeris.h"
 #include "galileo_almanac.h"
@@ -64,6 +66,7 @@
 #include "sbas_satellite_correction.h"
 #include "sbas_time.h"
 #include "spoofing_message.h"
+#include "spoofing_capture.h"
 
 
 
@@ -78,18 +81,37 @@ DECLARE_string(log_dir);
 #include "arithmetic/code_generation_test.cc"
 #include "arithmetic/tracking_loop_filter_test.cc"
 #include "arithmetic/fft_length_test.cc"
+#include "arithmetic/sliding_window_stats_test.cc"
+#include "arithmetic/dc_offset_estimator_test.cc"
+#include "arithmetic/spoofing_stats_test.cc"
+#include "arithmetic/gnss_sdr_perf_test.cc"
+#include "arithmetic/gnss_sdr_shared_tables_test.cc"
+#include "arithmetic/gnss_sdr_runtime_params_test.cc"
+#include "arithmetic/spoofing_check_test.cc"
 #include "configuration/file_configuration_test.cc"
 #include "configuration/in_memory_configuration_test.cc"
+#include "configuration/receiver_configuration_test.cc"
 #include "control_thread/control_message_factory_test.cc"
 #include "control_thread/control_thread_test.cc"
+#include "control_thread/concurrent_ring_test.cc"
+#include "control_thread/batch_processor_test.cc"
 #include "flowgraph/pass_through_test.cc"
 #include "flowgraph/gnss_flowgraph_test.cc"
+#include "flowgraph/channel_scheduler_test.cc"
+#include "flowgraph/block_layout_test.cc"
 #include "formats/string_converter_test.cc"
 #include "formats/rtcm_test.cc"
+#include "formats/gps_nav_digest_test.cc"
+#include "formats/spoofing_event_log_test.cc"
+#include "formats/spoofing_capture_test.cc"
+#include "formats/spoofing_external_nav_test.cc"
 #include "gnss_block/gnss_block_factory_test.cc"
 #include "gnss_block/rtcm_printer_test.cc"
 #include "gnss_block/file_signal_source_test.cc"
+#include "gnss_block/mmap_playlist_test.cc"
+#include "gnss_block/capture_container_test.cc"
 #include "gnss_block/fir_filter_test.cc"
+#include "gnss_block/gnss_sdr_channel_gate_test.cc"
 #include "gnss_block/gps_l1_ca_pcps_acquisition_test.cc"
 #include "gnss_block/gps_l2_m_pcps_acquisition_test.cc"
 #include "gnss_block/gps_l1_ca_pcps_acquisition_gsoc2013_test.cc"
@@ -109,6 +131,10 @@ DECLARE_string(log_dir);
 #include "gnss_block/galileo_e1_dll_pll_veml_tracking_test.cc"
 #include "gnuradio_block/gnss_sdr_valve_test.cc"
 #include "gnuradio_block/direct_resampler_conditioner_cc_test.cc"
+#include "gnuradio_block/fused_conditioner_test.cc"
+#include "gnuradio_block/fft_freq_xlating_fir_filter_ccf_test.cc"
+#include "gnuradio_block/polyphase_resampler_test.cc"
+#include "gnuradio_block/adaptive_beamformer_test.cc"
 #include "gnss_block/galileo_e5a_pcps_acquisition_gsoc2014_gensource_test.cc"
 #include "gnss_block/galileo_e5a_tracking_test.cc"
 #include "gnss_block/gps_l2_m_dll_pll_tracking_test.cc"
@@ -116,7 +142,7 @@ DECLARE_string(log_dir);
 
 // For GPS NAVIGATION (L1)
 
-concurrent_queue<Gps_Acq_Assist> global_gps_acq_assist_queue;
+concurrent_ring<Gps_Acq_Assist> global_gps_acq_assist_queue(256, RING_BLOCK);
 concurrent_map<Gps_Acq_Assist> global_gps_acq_assist_map;
 
 //For spoofing detection
@@ -129,6 +155,7 @@ struct GPS_time_t{
 
 struct sEph{
     Gps_Ephemeris ephemeris;
+    Gps_Nav_Digest digest; // ephemeris digest without TOW
     double time;
     bool changed;
 };
@@ -145,11 +172,14 @@ struct Subframe{
     double timestamp;
     unsigned int toa;
     unsigned int uid;
+    Gps_Nav_Digest digest; // subframe digest without TOW and HOW flags
+    unsigned int HOW;
 };
 
 concurrent_map<Subframe> global_subframe_map;
 concurrent_map<std::map<unsigned int, unsigned int>> global_subframe_check;
-concurrent_queue<Spoofing_Message> global_spoofing_queue;
+concurrent_ring<Spoofing_Message> global_spoofing_queue(1024, RING_DROP_NEWEST);
+concurrent_ring<Capture_Subframe> global_capture_subframe_queue(1024, RING_DROP_NEWEST);
 
 
 int main(int argc, char **argv)
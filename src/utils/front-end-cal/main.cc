@@ -51,6 +51,7 @@
 #include <gnuradio/blocks/file_source.h>
 #include <gnuradio/blocks/file_sink.h>
 #include "concurrent_map.h"
+#include "concurrent_ring.h"
 #include "file_configuration.h"
 #include "gps_l1_ca_pcps_acquisition_fine_doppler.h"
 #include "gnss_signal.h"
@@ -63,6 +64,7 @@
 #include "gps_iono.h"
 #include "gps_cnav_iono.h"
 #include "gps_utc_model.h"
+#include "gps_nav_digest.h"
 #include "galileo_ephemeris.h"
 #include "galileo_almanac.h"
 #include "galileo_iono.h"
@@ -74,6 +76,7 @@
 #include "sbas_time.h"
 #include "gnss_sdr_supl_client.h"
 #include "spoofing_message.h"
+#include "spoofing_capture.h"
 
 
 #include "front_end_cal.h"
@@ -167,6 +170,7 @@ struct GPS_time_t{
 
 struct sEph{
     Gps_Ephemeris ephemeris;
+    Gps_Nav_Digest digest; // ephemeris digest without TOW
     double time;
     bool changed;
 };
@@ -183,11 +187,14 @@ struct Subframe{
     double timestamp;
     unsigned int toa;
     unsigned int uid;
+    Gps_Nav_Digest digest; // subframe digest without TOW and HOW flags
+    unsigned int HOW;
 };
 
 concurrent_map<Subframe> global_subframe_map;
 concurrent_map<std::map<unsigned int, unsigned int>> global_subframe_check;
-concurrent_queue<Spoofing_Message> global_spoofing_queue;
+concurrent_ring<Spoofing_Message> global_spoofing_queue(1024, RING_DROP_NEWEST);
+concurrent_ring<Capture_Subframe> global_capture_subframe_queue(1024, RING_DROP_NEWEST);
 
 void wait_message()
 {
@@ -0,0 +1,111 @@
+/*!
+ * \file main.cc
+ * \brief Main file of the spoofing event log reader. Renders the records of a
+ * spoofing event log as the text spoofing report, or summarizes them per case.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <string>
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include "spoofing_event_log.h"
+
+using google::LogMessage;
+
+DEFINE_string(events, "spoofing_events.dat", "Spoofing event log to read");
+DEFINE_int32(spoofing_case, -1, "Only show events of this spoofing case (-1: all cases)");
+DEFINE_bool(summary, false, "Print the number of records and alarms of each case instead of the report");
+
+
+struct Case_Summary
+{
+    unsigned long int records;
+    unsigned long int alarms;
+    double first_ms;
+    double last_ms;
+};
+
+
+int main(int argc, char** argv)
+{
+    const std::string intro_help(
+            std::string("\n Renders a spoofing event log as a human-readable spoofing report\n")
+    +
+    "Copyright (C) 2010-2015 (see AUTHORS file for a list of contributors)\n"
+    +
+    "This program comes with ABSOLUTELY NO WARRANTY;\n"
+    +
+    "See COPYING file to see a copy of the General Public License\n \n");
+
+    google::SetUsageMessage(intro_help);
+    google::ParseCommandLineFlags(&argc, &argv, true);
+    google::InitGoogleLogging(argv[0]);
+
+    Spoofing_Event_Reader reader;
+    if (!reader.open(FLAGS_events))
+        {
+            std::cout << "Unable to read spoofing event log " << FLAGS_events << std::endl;
+            return EXIT_FAILURE;
+        }
+
+    std::map<int, Case_Summary> summary;
+    Spoofing_Event event;
+    while (reader.next(event))
+        {
+            if (FLAGS_spoofing_case >= 0 && event.spoofing_case != FLAGS_spoofing_case)
+                {
+                    continue;
+                }
+            if (!FLAGS_summary)
+                {
+                    std::cout << spoofing_event_report(event);
+                    continue;
+                }
+            std::map<int, Case_Summary>::iterator it = summary.find(event.spoofing_case);
+            if (it == summary.end())
+                {
+                    Case_Summary c = {0, 0, event.first_alarm_time_ms, event.alarm_time_ms};
+                    it = summary.insert(std::make_pair(event.spoofing_case, c)).first;
+                }
+            it->second.records++;
+            it->second.alarms += event.repeats;
+            it->second.last_ms = event.alarm_time_ms;
+        }
+    reader.close();
+
+    for (std::map<int, Case_Summary>::iterator it = summary.begin(); it != summary.end(); ++it)
+        {
+            std::cout << "case " << it->first << ": " << it->second.alarms << " alarms in "
+                      << it->second.records << " records, from " << it->second.first_ms / 1e3
+                      << " s to " << it->second.last_ms / 1e3 << " s" << std::endl;
+        }
+
+    google::ShutDownCommandLineFlags();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,203 @@
+/*!
+ * \file main.cc
+ * \brief Main file of the spoofing capture replay program. Runs one capture
+ * through the spoofing detector once per configuration file, with the
+ * configurations spread over parallel worker processes.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <boost/algorithm/string.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/thread.hpp>
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include "concurrent_map.h"
+#include "concurrent_ring.h"
+#include "file_configuration.h"
+#include "gps_ephemeris.h"
+#include "gps_almanac.h"
+#include "gps_iono.h"
+#include "gps_utc_model.h"
+#include "gps_acq_assist.h"
+#include "spoofing_message.h"
+#include "spoofing_capture.h"
+#include "spoofing_replay.h"
+#include "spoofing_stats.h"
+
+using google::LogMessage;
+
+DECLARE_string(log_dir);
+
+DEFINE_string(capture, "", "Spoofing capture recorded with Spoofing.capture_filename");
+DEFINE_string(config_files, "", "Comma-separated list of configuration files to replay the capture with");
+DEFINE_int32(jobs, 0, "Number of configurations replayed in parallel (0: one per CPU core)");
+DEFINE_string(report_dir, ".", "Directory where the spoofing report of each configuration is written");
+
+concurrent_map<Gps_Ephemeris> global_gps_ephemeris_map;
+concurrent_map<Gps_Iono> global_gps_iono_map;
+concurrent_map<Gps_Utc_Model> global_gps_utc_model_map;
+concurrent_map<Gps_Almanac> global_gps_almanac_map;
+concurrent_map<Gps_Acq_Assist> global_gps_acq_assist_map;
+
+// ###########################################################
+//For spoofing detection (sEph and Subframe come with spoofing_detector.h)
+struct GPS_time_t{
+    int week;
+    double TOW;
+    double timestamp;
+    int subframe_id;
+};
+
+concurrent_map<GPS_time_t> global_gps_time;
+concurrent_map<sEph> global_sEph_map;
+concurrent_map<double> global_last_gps_time;
+concurrent_map<bool> global_spoofing_status;  //spoofing has been detected for the satellite
+
+concurrent_map<Subframe> global_subframe_map;
+concurrent_map<std::map<unsigned int, unsigned int>> global_subframe_check;
+concurrent_ring<Spoofing_Message> global_spoofing_queue(1024, RING_DROP_NEWEST);
+concurrent_ring<Capture_Subframe> global_capture_subframe_queue(1024, RING_DROP_NEWEST);
+
+
+/*
+ * Runs in a forked worker: the detector state above is fresh for every configuration.
+ */
+int replay(const std::string& config_file)
+{
+    std::string stem = boost::filesystem::path(config_file).stem().string();
+    std::string report = (boost::filesystem::path(FLAGS_report_dir) / (stem + ".spoofing_report.txt")).string();
+
+    FileConfiguration configuration(config_file);
+    Spoofing_Replay spoofing_replay(&configuration, FLAGS_capture, report);
+    if (!spoofing_replay.run())
+        {
+            std::cout << stem << ": unable to read " << FLAGS_capture << std::endl;
+            return EXIT_FAILURE;
+        }
+
+    std::ostringstream summary;
+    summary << stem << ": " << spoofing_replay.get_epochs() << " epochs, "
+            << spoofing_replay.get_subframes() << " subframes, "
+            << spoofing_replay.get_positions() << " positions, "
+            << spoofing_replay.get_alarms() << " spoofing alarms";
+    std::map<unsigned int, unsigned int> cases = spoofing_replay.get_alarms_per_case();
+    for (std::map<unsigned int, unsigned int>::iterator it = cases.begin(); it != cases.end(); ++it)
+        {
+            summary << " [case " << it->first << ": " << it->second << "]";
+        }
+    summary << " -> " << report;
+
+    // cost of each check and alarm latencies of this configuration
+    std::string stats = (boost::filesystem::path(FLAGS_report_dir) / (stem + ".spoofing_stats.json")).string();
+    if (Spoofing_Stats_Server::dump(stats))
+        {
+            summary << ", " << stats;
+        }
+    std::cout << summary.str() << std::endl;
+    return EXIT_SUCCESS;
+}
+
+
+int main(int argc, char** argv)
+{
+    const std::string intro_help(
+            std::string("\n Replays a spoofing capture through the spoofing detector with one or more configurations\n")
+    +
+    "Copyright (C) 2010-2015 (see AUTHORS file for a list of contributors)\n"
+    +
+    "This program comes with ABSOLUTELY NO WARRANTY;\n"
+    +
+    "See COPYING file to see a copy of the General Public License\n \n");
+
+    google::SetUsageMessage(intro_help);
+    google::ParseCommandLineFlags(&argc, &argv, true);
+    google::InitGoogleLogging(argv[0]);
+
+    std::vector<std::string> config_files;
+    boost::split(config_files, FLAGS_config_files, boost::is_any_of(","), boost::token_compress_on);
+    config_files.erase(std::remove(config_files.begin(), config_files.end(), std::string("")), config_files.end());
+    if (FLAGS_capture.empty() || config_files.empty())
+        {
+            std::cout << "Usage: spree-replay --capture=<capture file> --config_files=<a.conf,b.conf,...>" << std::endl;
+            return EXIT_FAILURE;
+        }
+    if (!boost::filesystem::exists(FLAGS_report_dir))
+        {
+            boost::filesystem::create_directories(FLAGS_report_dir);
+        }
+
+    unsigned int jobs = FLAGS_jobs > 0 ? FLAGS_jobs : std::max(boost::thread::hardware_concurrency(), 1u);
+    unsigned int running = 0;
+    int failures = 0;
+    std::cout << "Replaying " << FLAGS_capture << " with " << config_files.size()
+              << " configurations, " << jobs << " at a time" << std::endl;
+
+    for (unsigned int i = 0; i < config_files.size(); i++)
+        {
+            if (running == jobs)
+                {
+                    int status;
+                    if (wait(&status) > 0)
+                        {
+                            running--;
+                            if (!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS) failures++;
+                        }
+                }
+            pid_t pid = fork();
+            if (pid == 0)
+                {
+                    std::exit(replay(config_files.at(i)));
+                }
+            if (pid < 0)
+                {
+                    LOG(WARNING) << "fork failed, replaying " << config_files.at(i) << " in the main process";
+                    if (replay(config_files.at(i)) != EXIT_SUCCESS) failures++;
+                    // the detector state of this process is no longer fresh
+                    break;
+                }
+            running++;
+        }
+
+    int status;
+    while (running > 0 && wait(&status) > 0)
+        {
+            running--;
+            if (!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS) failures++;
+        }
+
+    google::ShutDownCommandLineFlags();
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,297 @@
+/*!
+ * \file spoofing_replay.cc
+ * \brief Replays a spoofing capture through the spoofing detector and the
+ * least squares PVT, without acquisition or tracking.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "spoofing_replay.h"
+#include <cstring>
+#include <list>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <glog/logging.h>
+#include "concurrent_ring.h"
+#include "gnss_synchro.h"
+#include "gps_l1_ca_ls_pvt.h"
+#include "spoofing_message.h"
+
+using google::LogMessage;
+
+extern concurrent_ring<Spoofing_Message> global_spoofing_queue;
+
+
+Spoofing_Replay::Spoofing_Replay(ConfigurationInterface* configuration, std::string capture_filename, std::string report_filename)
+{
+    d_configuration = configuration;
+    d_capture_filename = capture_filename;
+    d_report_filename = report_filename;
+    d_epochs = 0;
+    d_subframes = 0;
+    d_ephemerides = 0;
+    d_positions = 0;
+    d_sample_counter = 0;
+}
+
+
+Spoofing_Replay::~Spoofing_Replay()
+{
+    d_event_log.close();
+}
+
+
+bool Spoofing_Replay::run()
+{
+    Spoofing_Capture_Reader reader;
+    if (!reader.open(d_capture_filename))
+        {
+            return false;
+        }
+
+    unsigned int nchannels = reader.get_nchannels();
+    Spoofing_Detector detector(d_configuration);
+    if (!d_report_filename.empty())
+        {
+            std::string events_filename = boost::filesystem::path(d_report_filename).replace_extension(".dat").string();
+            d_event_log.open(events_filename, d_report_filename, detector.get_event_min_interval_ms(), detector.get_event_flush_period_ms());
+        }
+    bool APT = detector.get_APT();
+    int PPE_sampling = detector.get_PPE_sampling();
+    if (PPE_sampling < 1) PPE_sampling = 1;
+
+    // same PVT settings as the PVT block
+    int averaging_depth = d_configuration->property("PVT.averaging_depth", 10);
+    bool flag_averaging = d_configuration->property("PVT.flag_averaging", false);
+    int output_rate_ms = d_configuration->property("PVT.output_rate_ms", 500);
+    if (output_rate_ms < 1) output_rate_ms = 1;
+    gps_l1_ca_ls_pvt ls_pvt(nchannels, "", false);
+    ls_pvt.set_averaging_depth(averaging_depth);
+
+    std::vector<Gnss_Synchro> synchro(nchannels);
+    std::vector<Gnss_Synchro*> in(nchannels);
+    std::vector<gr_complex> correlators(3 * nchannels);
+    for (unsigned int i = 0; i < nchannels; i++)
+        {
+            std::memset(&synchro.at(i), 0, sizeof(Gnss_Synchro));
+            synchro.at(i).Early = &correlators.at(3 * i);
+            synchro.at(i).Prompt = &correlators.at(3 * i + 1);
+            synchro.at(i).Late = &correlators.at(3 * i + 2);
+            in.at(i) = &synchro.at(i);
+        }
+
+    Capture_Record_Type type;
+    while ((type = reader.next()) != CAPTURE_END)
+        {
+            if (type == CAPTURE_SUBFRAME)
+                {
+                    replay_subframe(detector, reader.get_subframe());
+                    d_subframes++;
+                    continue;
+                }
+            if (type == CAPTURE_EPHEMERIS)
+                {
+                    ls_pvt.gps_ephemeris_map[reader.get_ephemeris_key()] = reader.get_ephemeris();
+                    d_ephemerides++;
+                    continue;
+                }
+
+            // CAPTURE_EPOCH: what gps_l1_ca_sd_pvt_cc::general_work does with one input sample
+            d_epochs++;
+            unsigned long int sample_counter = reader.get_sample_counter();
+            d_sample_counter = sample_counter;
+            const std::vector<Capture_Synchro>& epoch = reader.get_epoch();
+            std::list<unsigned int> channels_used;
+            std::map<unsigned int, unsigned int> PRN_to_peak;
+            std::map<unsigned int, unsigned int> channel_uid;
+            for (unsigned int k = 0; k < epoch.size() && k < nchannels; k++)
+                {
+                    const Capture_Synchro& c = epoch.at(k);
+                    Gnss_Synchro& s = synchro.at(k);
+                    s.PRN = c.PRN;
+                    s.Channel_ID = c.channel;
+                    s.peak = c.peak;
+                    s.uid = c.uid;
+                    s.Flag_valid_pseudorange = c.Flag_valid_pseudorange;
+                    s.CN0_dB_hz = c.CN0_dB_hz;
+                    s.Carrier_Doppler_hz = c.Carrier_Doppler_hz;
+                    s.Prompt_I = c.Prompt_I;
+                    s.Prompt_Q = c.Prompt_Q;
+                    s.Tracking_timestamp_secs = c.Tracking_timestamp_secs;
+                    s.d_TOW_at_current_symbol = c.d_TOW_at_current_symbol;
+                    s.Pseudorange_m = c.Pseudorange_m;
+                    *s.Early = gr_complex(c.Early[0], c.Early[1]);
+                    *s.Prompt = gr_complex(c.Prompt[0], c.Prompt[1]);
+                    *s.Late = gr_complex(c.Late[0], c.Late[1]);
+                    channel_uid[k] = c.uid;
+
+                    if (c.Flag_valid_pseudorange && c.state != 2)
+                        {
+                            //use the channel that is tracking the highest peak
+                            if (PRN_to_peak.count(c.PRN))
+                                {
+                                    if (c.peak < PRN_to_peak.at(c.PRN))
+                                        {
+                                            channels_used.remove(PRN_to_peak.at(c.PRN));
+                                            channels_used.push_back(k);
+                                            PRN_to_peak[c.PRN] = c.peak;
+                                        }
+                                }
+                            else
+                                {
+                                    channels_used.push_back(k);
+                                    PRN_to_peak[c.PRN] = c.peak;
+                                }
+                        }
+                }
+
+            if ((sample_counter % PPE_sampling) == 0)
+                {
+                    detector.PPE_moving_var(channels_used, in.data(), sample_counter);
+                }
+
+            std::map<int, Gnss_Synchro> gnss_pseudoranges_map;
+            double rx_time = 0;
+            for (std::list<unsigned int>::iterator it = channels_used.begin(); it != channels_used.end(); ++it)
+                {
+                    int key = APT ? channel_uid.at(*it) : synchro.at(*it).PRN;
+                    gnss_pseudoranges_map.insert(std::pair<int, Gnss_Synchro>(key, synchro.at(*it)));
+                    rx_time = synchro.at(*it).d_TOW_at_current_symbol;
+                }
+
+            drain_alarms();
+
+            if (gnss_pseudoranges_map.size() > 0 && ls_pvt.gps_ephemeris_map.size() > 0)
+                {
+                    if ((sample_counter % output_rate_ms) == 0)
+                        {
+                            if (ls_pvt.get_PVT(gnss_pseudoranges_map, rx_time, flag_averaging))
+                                {
+                                    d_positions++;
+                                }
+                            if (ls_pvt.b_valid_position == true)
+                                {
+                                    detector.check_position(ls_pvt.d_latitude_d, ls_pvt.d_longitude_d, ls_pvt.d_height_m, sample_counter);
+                                }
+                        }
+                }
+        }
+    drain_alarms();
+    d_event_log.close();
+
+    LOG(INFO) << "Replayed " << d_epochs << " epochs, " << d_subframes << " subframes and "
+              << d_ephemerides << " ephemerides from " << d_capture_filename << ": "
+              << get_alarms() << " spoofing alarms";
+    return true;
+}
+
+
+/*
+ * Same steps as GpsL1CaSdSubframeFsm::gps_sd_subframe_to_nav_msg
+ */
+void Spoofing_Replay::replay_subframe(Spoofing_Detector& detector, const Capture_Subframe& capture)
+{
+    Gps_Navigation_Message& nav = d_nav[capture.uid];
+    char subframe[GPS_SUBFRAME_LENGTH];
+    std::memcpy(subframe, capture.subframe, GPS_SUBFRAME_LENGTH);
+
+    int subframe_ID = nav.subframe_decoder(subframe);
+    nav.i_satellite_PRN = capture.PRN;
+    nav.i_channel_ID = capture.channel;
+    nav.d_subframe_timestamp_ms = capture.timestamp_ms;
+    if (subframe_ID < 1 || subframe_ID > 5)
+        {
+            return;
+        }
+    nav.i_peak = capture.peak;
+    nav.uid = capture.uid;
+    detector.New_subframe(subframe_ID, capture.PRN, nav, capture.timestamp_ms, capture.receiver_time_ms);
+
+    if (subframe_ID == 4)
+        {
+            if (nav.flag_iono_valid == true)
+                {
+                    Gps_Iono iono = nav.get_iono();
+                    detector.check_external_iono(iono, capture.timestamp_ms, capture.receiver_time_ms);
+                }
+            if (nav.flag_utc_model_valid == true)
+                {
+                    Gps_Utc_Model utc_model = nav.get_utc_model();
+                    detector.check_external_utc(utc_model, capture.timestamp_ms, capture.receiver_time_ms);
+                }
+        }
+}
+
+
+void Spoofing_Replay::drain_alarms()
+{
+    Spoofing_Message msg;
+    while (global_spoofing_queue.try_pop(msg))
+        {
+            d_alarms[msg.spoofing_case]++;
+            d_event_log.push(msg, d_sample_counter);
+        }
+}
+
+
+unsigned long int Spoofing_Replay::get_epochs() const
+{
+    return d_epochs;
+}
+
+
+unsigned long int Spoofing_Replay::get_subframes() const
+{
+    return d_subframes;
+}
+
+
+unsigned long int Spoofing_Replay::get_ephemerides() const
+{
+    return d_ephemerides;
+}
+
+
+unsigned long int Spoofing_Replay::get_positions() const
+{
+    return d_positions;
+}
+
+
+unsigned int Spoofing_Replay::get_alarms() const
+{
+    unsigned int total = 0;
+    for (std::map<unsigned int, unsigned int>::const_iterator it = d_alarms.begin(); it != d_alarms.end(); ++it)
+        {
+            total += it->second;
+        }
+    return total;
+}
+
+
+std::map<unsigned int, unsigned int> Spoofing_Replay::get_alarms_per_case() const
+{
+    return d_alarms;
+}
@@ -0,0 +1,88 @@
+/*!
+ * \file spoofing_replay.h
+ * \brief Replays a spoofing capture through the spoofing detector and the
+ * least squares PVT, without acquisition or tracking.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_SPOOFING_REPLAY_H_
+#define GNSS_SDR_SPOOFING_REPLAY_H_
+
+#include <map>
+#include <string>
+#include "configuration_interface.h"
+#include "gps_navigation_message.h"
+#include "spoofing_capture.h"
+#include "spoofing_detector.h"
+#include "spoofing_event_log.h"
+
+
+/*!
+ * \brief Feeds the records of a spoofing capture to a Spoofing_Detector and a
+ * gps_l1_ca_ls_pvt configured from \a configuration, the same way the telemetry
+ * decoders and the PVT block do during a live run, as fast as the records can be read.
+ *
+ * The detector keeps its state in process-wide maps, so a process runs one
+ * replay at a time; configurations are run in parallel as separate processes.
+ */
+class Spoofing_Replay
+{
+private:
+    ConfigurationInterface* d_configuration;
+    std::string d_capture_filename;
+    std::string d_report_filename;
+    Spoofing_Event_Log d_event_log;  // event log next to the report, the report is rendered from it
+    unsigned long int d_sample_counter;
+
+    unsigned long int d_epochs;
+    unsigned long int d_subframes;
+    unsigned long int d_ephemerides;
+    unsigned long int d_positions;
+    std::map<unsigned int, unsigned int> d_alarms; // spoofing case -> number of alarms
+
+    std::map<unsigned int, Gps_Navigation_Message> d_nav; // one decoder per tracked peak (uid)
+
+    void replay_subframe(Spoofing_Detector& detector, const Capture_Subframe& capture);
+    void drain_alarms();
+
+public:
+    /*!
+     * \brief Runs the whole capture. Returns false if it can not be read.
+     */
+    bool run();
+
+    unsigned long int get_epochs() const;
+    unsigned long int get_subframes() const;
+    unsigned long int get_ephemerides() const;
+    unsigned long int get_positions() const;  //!< Valid PVT solutions
+    unsigned int get_alarms() const;          //!< Total number of spoofing alarms
+    std::map<unsigned int, unsigned int> get_alarms_per_case() const;
+
+    Spoofing_Replay(ConfigurationInterface* configuration, std::string capture_filename, std::string report_filename);
+    ~Spoofing_Replay();
+};
+
+#endif